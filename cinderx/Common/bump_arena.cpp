@@ -16,15 +16,32 @@ constexpr size_t kMaxBlockSize = size_t{kMiB};
 
 } // namespace
 
+BumpArena::BumpArena(std::shared_ptr<HugePageArena> backing)
+    : backing_{std::move(backing)} {}
+
 BumpArena::~BumpArena() {
   for (auto it = destructors_.rbegin(); it != destructors_.rend(); ++it) {
     it->destroy(it->obj);
   }
 }
 
+size_t BumpArena::allocatedBytes() const {
+  std::lock_guard<std::mutex> guard{mutex_};
+  size_t bytes = backed_bytes_;
+  for (const Block& block : blocks_) {
+    bytes += block.size;
+  }
+  return bytes;
+}
+
 void* BumpArena::allocateBytes(size_t size, size_t alignment) {
   JIT_DCHECK(isPowerOfTwo(alignment), "Alignment must be a power of 2");
 
+  if (backing_ != nullptr) {
+    backed_bytes_ += size;
+    return backing_->allocate(size, alignment);
+  }
+
   Block* block;
   size_t offset;
 
@@ -3,6 +3,7 @@
 #pragma once
 
 #include "cinderx/Common/aligned_memory.h"
+#include "cinderx/Common/hugepages.h"
 #include "cinderx/Common/slab_arena.h"
 
 #include <cstddef>
@@ -16,9 +17,14 @@ namespace cinderx {
 
 // A mixed-type bump allocator that keeps allocated addresses stable and
 // destroys non-trivially-destructible objects when the arena is destroyed.
+//
+// An arena can instead carve its objects straight out of a HugePageArena,
+// packing them together with those of other arenas sharing it.  Their memory
+// is then only reclaimed with the HugePageArena.
 class BumpArena {
  public:
   BumpArena() = default;
+  explicit BumpArena(std::shared_ptr<HugePageArena> backing);
   ~BumpArena();
 
   BumpArena(const BumpArena&) = delete;
@@ -51,6 +57,9 @@ class BumpArena {
     return obj;
   }
 
+  // Total size of the blocks allocated by the arena.
+  size_t allocatedBytes() const;
+
  private:
   struct Block {
     AlignedMemory<char> base;
@@ -69,7 +78,10 @@ class BumpArena {
   std::vector<Block> blocks_;
   std::vector<Destructor> destructors_;
   size_t next_block_size_{size_t{kPageSize}};
-  std::mutex mutex_;
+  std::shared_ptr<HugePageArena> backing_;
+  // Bytes allocated from backing_.
+  size_t backed_bytes_{0};
+  mutable std::mutex mutex_;
 };
 
 } // namespace cinderx
@@ -16,18 +16,54 @@ typedef struct CodeExtra {
     // Used for unallocated free list code extras
     struct CodeExtra* next;
   };
+  // Table of Static Python opcode caches, see Interpreter/static_cache.h.
+  // Owned by the code object, published once with a release store.
+  void* static_cache;
 } CodeExtra;
 
 // Thread-safe accessors for CodeExtra::calls.
 // Under FT-Python, these use atomics to avoid data races.
 #ifdef Py_GIL_DISABLED
 
+// Incrementing a shared counter on every call makes its cache line bounce
+// between the cores calling the function, so past the first
+// CI_CODE_EXTRA_EXACT_CALLS calls, each call is counted with probability
+// 1/CI_CODE_EXTRA_CALL_SAMPLE_RATE, as CI_CODE_EXTRA_CALL_SAMPLE_RATE calls.
+// That keeps the count unbiased while only writing the counter on a small
+// fraction of calls.  Below the limit, where call-count thresholds like
+// compile_after_n_calls are usually set, counts stay exact.
+#define CI_CODE_EXTRA_EXACT_CALLS 4096
+#define CI_CODE_EXTRA_CALL_SAMPLE_RATE 64
+
+// Per-thread xorshift32 generator used to pick which calls are counted.
+static inline uint32_t Ci_code_extra_call_sample_bits(void) {
+  static _Py_thread_local uint32_t state;
+  uint32_t x = state;
+  if (x == 0) {
+    // Seed from the address of the thread-local, which is different in every
+    // thread.
+    x = (uint32_t)(uintptr_t)&state | 1;
+  }
+  x ^= x << 13;
+  x ^= x >> 17;
+  x ^= x << 5;
+  state = x;
+  return x;
+}
+
 // Note: _Py_atomic_add_uint64 uses seq_cst ordering, which might be stronger
 // than needed for the calls counter. On x86-64, this is the same cost as
 // relaxed (both emit lock xaddq). On ARM, a relaxed variant would be cheaper
 // but there is no _Py_atomic_add_uint64_relaxed.
 static inline void Ci_code_extra_incr_calls(CodeExtra* extra) {
-  _Py_atomic_add_uint64(&extra->calls, 1);
+  if (_Py_atomic_load_uint64_relaxed(&extra->calls) <
+      CI_CODE_EXTRA_EXACT_CALLS) {
+    _Py_atomic_add_uint64(&extra->calls, 1);
+  } else if (
+      (Ci_code_extra_call_sample_bits() &
+       (CI_CODE_EXTRA_CALL_SAMPLE_RATE - 1)) == 0) {
+    _Py_atomic_add_uint64(&extra->calls, CI_CODE_EXTRA_CALL_SAMPLE_RATE);
+  }
 }
 
 static inline uint64_t Ci_code_extra_get_calls(const CodeExtra* extra) {
@@ -37,13 +37,21 @@ HugePageArena::HugePageArena(HugePageArena&& other) noexcept {
   std::lock_guard<std::mutex> lock{other.mutex_};
   fill_ = other.fill_;
   end_ = other.end_;
+  allocated_ = other.allocated_;
   chunks_ = std::move(other.chunks_);
   other.fill_ = nullptr;
   other.end_ = nullptr;
+  other.allocated_ = 0;
 }
 
 HugePageArena::~HugePageArena() {
   for (const Chunk& chunk : chunks_) {
+#ifndef WIN32
+    // The allocator may write to memory as it frees it.
+    if (chunk.read_only) {
+      mprotect(chunk.ptr, chunk.size, PROT_READ | PROT_WRITE);
+    }
+#endif
     free_aligned(chunk.ptr);
   }
 }
@@ -63,9 +71,44 @@ void* HugePageArena::allocate(size_t size, size_t alignment) {
         roundUp(reinterpret_cast<uintptr_t>(fill_), alignment));
   }
   fill_ = candidate + size;
+  allocated_ += size;
   return candidate;
 }
 
+size_t HugePageArena::allocatedBytes() const {
+  std::lock_guard<std::mutex> lock{mutex_};
+  return allocated_;
+}
+
+size_t HugePageArena::reservedBytes() const {
+  std::lock_guard<std::mutex> lock{mutex_};
+  size_t bytes = 0;
+  for (const Chunk& chunk : chunks_) {
+    bytes += chunk.size;
+  }
+  return bytes;
+}
+
+void HugePageArena::protect() {
+  std::lock_guard<std::mutex> lock{mutex_};
+#ifndef WIN32
+  for (Chunk& chunk : chunks_) {
+    if (chunk.read_only) {
+      continue;
+    }
+    JIT_CHECK(
+        mprotect(chunk.ptr, chunk.size, PROT_READ) == 0,
+        "Failed to make {} bytes at {} read-only: {}",
+        chunk.size,
+        chunk.ptr,
+        strerror(errno));
+    chunk.read_only = true;
+  }
+#endif
+  fill_ = nullptr;
+  end_ = nullptr;
+}
+
 void HugePageArena::allocateChunk(size_t size, size_t alignment) {
   size_t chunk_alignment = std::max(alignment, kHugePageSize);
   size_t chunk_size = roundUp(size, kHugePageSize);
@@ -75,7 +118,7 @@ void HugePageArena::allocateChunk(size_t size, size_t alignment) {
   // Advise the kernel to back the chunk with transparent huge pages.
   madvise(chunk, chunk_size, MADV_HUGEPAGE);
 #endif
-  chunks_.emplace_back(chunk, chunk_size);
+  chunks_.push_back(Chunk{chunk, chunk_size});
   fill_ = static_cast<char*>(chunk);
   end_ = fill_ + chunk_size;
 }
@@ -86,6 +129,11 @@ void HugePageArena::afterForkChild() {
   size_t tmp_size = 0;
   std::lock_guard<std::mutex> lock{mutex_};
   for (const Chunk& chunk : chunks_) {
+    // Read-only chunks can't be written to, and are meant to stay shared with
+    // the parent anyway.
+    if (chunk.read_only) {
+      continue;
+    }
     // we can theoretically have chunks that are larger than 2MB but don't
     // really
     if (tmp == nullptr || tmp_size < chunk.size) {
@@ -3,8 +3,11 @@
 #pragma once
 
 #include <cstddef>
+#include <cstring>
 #include <memory>
 #include <mutex>
+#include <span>
+#include <type_traits>
 #include <vector>
 
 namespace cinderx {
@@ -32,6 +35,28 @@ class HugePageArena {
   // the arena and must not be freed by the caller.
   void* allocate(size_t size, size_t alignment);
 
+  // Copy `data` into the arena and return the copy.
+  template <typename T>
+  std::span<const T> copy(std::span<const T> data) {
+    static_assert(std::is_trivially_copyable_v<T>);
+    if (data.empty()) {
+      return {};
+    }
+    void* mem = allocate(data.size_bytes(), alignof(T));
+    std::memcpy(mem, data.data(), data.size_bytes());
+    return {static_cast<const T*>(mem), data.size()};
+  }
+
+  // Bytes handed out by allocate().
+  size_t allocatedBytes() const;
+
+  // Total size of the chunks backing the arena.
+  size_t reservedBytes() const;
+
+  // Make every chunk allocated so far read-only.  Later allocations start a
+  // fresh chunk.  Does nothing on Windows.
+  void protect();
+
   // Re-establish huge page backing for every chunk after a fork().
   void afterForkChild();
 
@@ -43,13 +68,15 @@ class HugePageArena {
   struct Chunk {
     void* ptr;
     size_t size;
+    bool read_only{false};
   };
 
   void allocateChunk(size_t size, size_t alignment);
 
-  std::mutex mutex_;
+  mutable std::mutex mutex_;
   char* fill_{nullptr};
   char* end_{nullptr};
+  size_t allocated_{0};
   std::vector<Chunk> chunks_;
 };
 
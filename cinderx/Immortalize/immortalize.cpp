@@ -3,15 +3,27 @@
 #include "cinderx/Immortalize/immortalize.h"
 
 #include "cinderx/Common/code.h"
+#include "cinderx/Common/containers.h"
 #include "cinderx/Common/py-portability.h"
 #include "cinderx/Common/ref.h"
 #include "cinderx/Common/util.h"
 #include "cinderx/UpstreamBorrow/borrowed.h" // @donotremove
 
+#include <array>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
 namespace cinderx {
 
 namespace {
 
+// Set once immortalize_heap() completes.  Only touched with the GIL held.
+bool s_heap_immortalized = false;
+
 #define FROM_GC(g) ((PyObject*)(((PyGC_Head*)g) + 1))
 #define GEN_HEAD(state, n) (&(state)->generations[n].head)
 
@@ -19,102 +31,373 @@ struct _gc_runtime_state* get_gc_state() {
   return &PyInterpreterState_Get()->gc;
 }
 
-void immortalize_exact_dict_entries(PyObject* obj) {
-  PyObject* key;
-  PyObject* value;
-  Py_ssize_t pos = 0;
-  // PyDict_Next() can resolve lazy imports when values are requested. When
-  // lazy imports are enabled, heap immortalization must preserve them during
-  // prepare-for-fork.
+// Rough size of an object, not counting anything it owns through pointers.
+size_t shallow_size(PyObject* obj) {
+  PyTypeObject* tp = Py_TYPE(obj);
+  size_t size = tp->tp_basicsize;
+  // Ints don't keep their digit count in ob_size from 3.12 onward.
+  if (tp->tp_itemsize != 0 && !PyLong_Check(obj)) {
+    Py_ssize_t items = Py_SIZE(obj);
+    size += tp->tp_itemsize * static_cast<size_t>(items < 0 ? -items : items);
+  }
+  if (PyObject_IS_GC(obj)) {
+    size += sizeof(PyGC_Head);
+  }
+  return size;
+}
+
+// Call `func` with each object that `obj` references, as reported by its
+// tp_traverse slot.
+template <typename F>
+void for_each_referent(PyObject* obj, F&& func) {
+  using Func = std::remove_reference_t<F>;
+  auto visitor = [](PyObject* referent, void* arg) {
+    (*static_cast<Func*>(arg))(referent);
+    return 0;
+  };
+  Py_TYPE(obj)->tp_traverse(obj, visitor, &func);
+}
+
+/*
+ * Immortalizes an object along with the objects that it keeps alive but that
+ * the GC doesn't traverse (dict entries, code object fields).
+ *
+ * In concurrent mode several Immortalizers run on worker threads at the same
+ * time while the calling thread holds the GIL.  Objects reachable from more
+ * than one partition of the heap are claimed under a striped lock so that
+ * each one is counted once, and the follow-up work that calls into the
+ * runtime is deferred until finish() runs back on the calling thread.
+ */
+class Immortalizer {
+ public:
+  Immortalizer() = default;
+  Immortalizer(const UnorderedSet<PyObject*>* excluded, bool concurrent)
+      : excluded_{excluded}, concurrent_{concurrent} {}
+
+  bool immortalize(PyObject* obj) {
+    if (excluded_ != nullptr && excluded_->contains(obj)) {
+      return false;
+    }
+    if (!claim(obj)) {
+      return false;
+    }
+
+    objects_++;
+    bytes_ += shallow_size(obj);
+
+    if (PyDict_CheckExact(obj)) {
+      immortalizeExactDictEntries(obj);
+    }
+
+    if (PyCode_Check(obj)) {
+      BorrowedRef<PyCodeObject> code{obj};
+      IMMORTALIZE(code->co_localspluskinds);
+      IMMORTALIZE(code->co_linetable);
+      IMMORTALIZE(code->co_exceptiontable);
+
+      immortalizeCodeTupleField(code->co_localsplusnames);
+      immortalizeCodeTupleField(code->co_consts);
+      immortalizeCodeTupleField(code->co_names);
+
+      // These are strings and we need to check if this is safe.
+      immortalize(code->co_filename);
+      immortalize(code->co_name);
+      immortalize(code->co_qualname);
+    }
+
+    if (PyCode_Check(obj) || PyUnicode_CheckExact(obj) || PyType_Check(obj)) {
+      if (concurrent_) {
+        deferred_.push_back(obj);
+      } else {
+        finishObject(obj);
+      }
+    }
+
+    return true;
+  }
+
+  // Immortalize a tracked object and everything that it references.
+  void immortalizeTracked(PyObject* obj) {
+    immortalize(obj);
+
+    auto visitor = [](PyObject* referent, void* arg) {
+      static_cast<Immortalizer*>(arg)->immortalize(referent);
+      return 0;
+    };
+    Py_TYPE(obj)->tp_traverse(obj, visitor, this);
+  }
+
+  // Run the deferred follow-up work.  Must be called on a thread holding the
+  // GIL.
+  void finish() {
+    for (PyObject* obj : deferred_) {
+      finishObject(obj);
+    }
+    deferred_.clear();
+  }
+
+  size_t objects() const {
+    return objects_;
+  }
+
+  size_t bytes() const {
+    return bytes_;
+  }
+
+ private:
+  bool claim(PyObject* obj) {
+    if (!concurrent_) {
+      if (!can_immortalize(obj)) {
+        return false;
+      }
+      IMMORTALIZE(obj);
+      return true;
+    }
+
+    auto addr = reinterpret_cast<uintptr_t>(obj);
+    std::lock_guard<std::mutex> guard{
+        claimLocks()[(addr / alignof(std::max_align_t)) % kNumClaimLocks]};
+    if (!can_immortalize(obj)) {
+      return false;
+    }
+    IMMORTALIZE(obj);
+    return true;
+  }
+
+  void immortalizeExactDictEntries(PyObject* obj) {
+    PyObject* key;
+    PyObject* value;
+    Py_ssize_t pos = 0;
+    // PyDict_Next() can resolve lazy imports when values are requested. When
+    // lazy imports are enabled, heap immortalization must preserve them during
+    // prepare-for-fork.
 #ifdef ENABLE_LAZY_IMPORTS
-  while (_PyDict_NextKeepLazy(obj, &pos, &key, &value)) {
+    while (_PyDict_NextKeepLazy(obj, &pos, &key, &value)) {
 #else
-  while (PyDict_Next(obj, &pos, &key, &value)) {
+    while (PyDict_Next(obj, &pos, &key, &value)) {
 #endif
-    immortalize(key);
-    immortalize(value);
+      immortalize(key);
+      immortalize(value);
+    }
   }
-}
 
-// Code objects are not GC-traversed in 3.12, so their tuple fields can be
-// immortal leaves with mortal entries. Keep this scoped to direct code tuple
-// entries rather than changing global tuple semantics.
-void immortalize_code_tuple_field(BorrowedRef<> obj) {
-  PyObject* tuple = obj.get();
-  if (tuple == nullptr) {
-    return;
+  // Code objects are not GC-traversed in 3.12, so their tuple fields can be
+  // immortal leaves with mortal entries. Keep this scoped to direct code tuple
+  // entries rather than changing global tuple semantics.
+  void immortalizeCodeTupleField(BorrowedRef<> obj) {
+    PyObject* tuple = obj.get();
+    if (tuple == nullptr) {
+      return;
+    }
+
+    immortalize(tuple);
+
+    if (!PyTuple_CheckExact(tuple)) {
+      return;
+    }
+
+    Py_ssize_t size = PyTuple_GET_SIZE(tuple);
+    for (Py_ssize_t i = 0; i < size; i++) {
+      immortalize(PyTuple_GET_ITEM(tuple, i));
+    }
   }
 
-  immortalize(tuple);
+  // Follow-up work that may allocate or touch interpreter state.
+  static void finishObject(PyObject* obj) {
+    if (PyCode_Check(obj)) {
+      codeExtra(reinterpret_cast<PyCodeObject*>(obj));
+    }
+
+    /* Cache the hash value of unicode object to reduce Copy-on-writes */
+    if (PyUnicode_CheckExact(obj)) {
+      PyObject_Hash(obj);
+    }
 
-  if (!PyTuple_CheckExact(tuple)) {
-    return;
+    if (PyType_Check(obj)) {
+      PyUnstable_Type_AssignVersionTag(reinterpret_cast<PyTypeObject*>(obj));
+    }
   }
 
-  Py_ssize_t size = PyTuple_GET_SIZE(tuple);
-  for (Py_ssize_t i = 0; i < size; i++) {
-    immortalize(PyTuple_GET_ITEM(tuple, i));
+  static constexpr size_t kNumClaimLocks = 256;
+
+  static std::array<std::mutex, kNumClaimLocks>& claimLocks() {
+    static std::array<std::mutex, kNumClaimLocks> locks;
+    return locks;
   }
+
+  const UnorderedSet<PyObject*>* excluded_{nullptr};
+  bool concurrent_{false};
+  size_t objects_{0};
+  size_t bytes_{0};
+  std::vector<PyObject*> deferred_;
+};
+
+bool module_name_matches(
+    std::string_view name,
+    const std::vector<std::string>& prefixes) {
+  for (const std::string& prefix : prefixes) {
+    if (name.starts_with(prefix) &&
+        (name.size() == prefix.size() || name[prefix.size()] == '.')) {
+      return true;
+    }
+  }
+  return false;
 }
 
-} // namespace
+/*
+ * Decides which tracked objects immortalize_heap() should leave alone.
+ */
+class HeapFilter {
+ public:
+  explicit HeapFilter(const ImmortalizeHeapOptions& options)
+      : exclude_types_{options.exclude_types},
+        predicate_{options.predicate} {}
 
-bool can_immortalize(PyObject* obj) {
-  if (obj == nullptr || _Py_IsImmortal(obj)) {
-    return false;
+  // Returns false with a Python exception set on failure.
+  bool init(BorrowedRef<> exclude_modules) {
+    if (exclude_types_ != nullptr && !PyTuple_Check(exclude_types_)) {
+      PyErr_SetString(PyExc_TypeError, "exclude_types must be a tuple");
+      return false;
+    }
+    if (exclude_modules == nullptr) {
+      return true;
+    }
+    Ref<> iter = Ref<>::steal(PyObject_GetIter(exclude_modules));
+    if (iter == nullptr) {
+      return false;
+    }
+    while (Ref<> item = Ref<>::steal(PyIter_Next(iter))) {
+      if (!PyUnicode_Check(item)) {
+        PyErr_SetString(
+            PyExc_TypeError, "exclude_modules must contain only strings");
+        return false;
+      }
+      Py_ssize_t size;
+      const char* name = PyUnicode_AsUTF8AndSize(item, &size);
+      if (name == nullptr) {
+        return false;
+      }
+      exclude_modules_.emplace_back(name, size);
+    }
+    return !PyErr_Occurred();
   }
 
-  // Python 3.12 will assert that strings that are immortalized are also
-  // interned in debug builds.  This is purely a debug check, it's fine to do in
-  // optimized builds.
-  if constexpr (kPyDebug) {
-    return !PyUnicode_Check(obj);
+  bool active() const {
+    return exclude_types_ != nullptr || !exclude_modules_.empty() ||
+        predicate_ != nullptr;
   }
 
-  return true;
-}
+  // Returns 1 if obj should be left mortal, 0 if not, and -1 with a Python
+  // exception set on failure.
+  int excludes(PyObject* obj) {
+    if (exclude_types_ != nullptr) {
+      int result = PyObject_IsInstance(obj, exclude_types_);
+      if (result != 0) {
+        return result;
+      }
+    }
 
-bool immortalize(PyObject* obj) {
-  if (!can_immortalize(obj)) {
-    return false;
-  }
+    if (!exclude_modules_.empty()) {
+      int result = excludedByModule(obj);
+      if (result != 0) {
+        return result;
+      }
+    }
 
-  IMMORTALIZE(obj);
+    if (predicate_ != nullptr) {
+      Ref<> keep = Ref<>::steal(PyObject_CallOneArg(predicate_, obj));
+      if (keep == nullptr) {
+        return -1;
+      }
+      int truthy = PyObject_IsTrue(keep);
+      return truthy < 0 ? -1 : !truthy;
+    }
 
-  if (PyDict_CheckExact(obj)) {
-    immortalize_exact_dict_entries(obj);
+    return 0;
   }
 
-  if (PyCode_Check(obj)) {
-    BorrowedRef<PyCodeObject> code{obj};
-    codeExtra(code);
-    IMMORTALIZE(code->co_localspluskinds);
-    IMMORTALIZE(code->co_linetable);
-    IMMORTALIZE(code->co_exceptiontable);
+ private:
+  int excludedByModule(PyObject* obj) {
+    if (PyModule_Check(obj)) {
+      const char* name = PyModule_GetName(obj);
+      if (name == nullptr) {
+        PyErr_Clear();
+        return 0;
+      }
+      return module_name_matches(name, exclude_modules_);
+    }
+    if (PyFunction_Check(obj)) {
+      return moduleNameMatches(reinterpret_cast<PyFunctionObject*>(obj)
+                                   ->func_module);
+    }
+    PyTypeObject* type =
+        PyType_Check(obj) ? reinterpret_cast<PyTypeObject*>(obj) : Py_TYPE(obj);
+    return typeExcluded(type);
+  }
 
-    immortalize_code_tuple_field(code->co_localsplusnames);
-    immortalize_code_tuple_field(code->co_consts);
-    immortalize_code_tuple_field(code->co_names);
+  int typeExcluded(PyTypeObject* type) {
+    auto it = type_results_.find(type);
+    if (it != type_results_.end()) {
+      return it->second;
+    }
+    Ref<> module_name =
+        Ref<>::steal(PyObject_GetAttrString(
+            reinterpret_cast<PyObject*>(type), "__module__"));
+    if (module_name == nullptr) {
+      PyErr_Clear();
+    }
+    bool result = moduleNameMatches(module_name);
+    type_results_.emplace(type, result);
+    return result;
+  }
 
-    // These are strings and we need to check if this is safe.
-    immortalize(code->co_filename);
-    immortalize(code->co_name);
-    immortalize(code->co_qualname);
+  bool moduleNameMatches(BorrowedRef<> name) {
+    if (name == nullptr || !PyUnicode_Check(name)) {
+      return false;
+    }
+    Py_ssize_t size;
+    const char* data = PyUnicode_AsUTF8AndSize(name, &size);
+    if (data == nullptr) {
+      PyErr_Clear();
+      return false;
+    }
+    return module_name_matches(
+        std::string_view{data, static_cast<size_t>(size)}, exclude_modules_);
   }
 
-  /* Cache the hash value of unicode object to reduce Copy-on-writes */
-  if (PyUnicode_CheckExact(obj)) {
-    PyObject_Hash(obj);
+  BorrowedRef<> exclude_types_;
+  BorrowedRef<> predicate_;
+  std::vector<std::string> exclude_modules_;
+  UnorderedMap<PyTypeObject*, bool> type_results_;
+};
+
+} // namespace
+
+bool can_immortalize(PyObject* obj) {
+  if (obj == nullptr || _Py_IsImmortal(obj)) {
+    return false;
   }
 
-  if (PyType_Check(obj)) {
-    PyUnstable_Type_AssignVersionTag(reinterpret_cast<PyTypeObject*>(obj));
+  // Python 3.12 will assert that strings that are immortalized are also
+  // interned in debug builds.  This is purely a debug check, it's fine to do in
+  // optimized builds.
+  if constexpr (kPyDebug) {
+    return !PyUnicode_Check(obj);
   }
 
   return true;
 }
 
-PyObject* immortalize_heap([[maybe_unused]] PyObject* mod) {
+bool immortalize(PyObject* obj) {
+  Immortalizer immortalizer;
+  return immortalizer.immortalize(obj);
+}
+
+bool heap_immortalized() {
+  return s_heap_immortalized;
+}
+
+PyObject* immortalize_heap(const ImmortalizeHeapOptions& options) {
   if constexpr (kFreeThreadedBuild) {
     PyErr_SetString(
         PyExc_RuntimeError,
@@ -122,6 +405,11 @@ PyObject* immortalize_heap([[maybe_unused]] PyObject* mod) {
     return nullptr;
   }
 
+  HeapFilter filter{options};
+  if (!filter.init(options.exclude_modules)) {
+    return nullptr;
+  }
+
   // TODO(T251571267): Low priority for now.
   /* Remove any dead objects to avoid immortalizing them */
   PyGC_Collect();
@@ -137,22 +425,143 @@ PyObject* immortalize_heap([[maybe_unused]] PyObject* mod) {
     return nullptr;
   }
 
-  /* Immortalize all instances in the permanent generation */
+  /*
+   * Snapshot the permanent generation.  The filter can run arbitrary Python
+   * code, so hold references to keep the objects alive until we're done.
+   * Objects that get immortalized aren't affected by the decrefs when the
+   * snapshot is dropped.
+   */
   struct _gc_runtime_state* gcstate = get_gc_state();
   PyGC_Head* list = &gcstate->permanent_generation.head;
+  std::vector<Ref<>> snapshot;
   for (PyGC_Head* gc = _PyGCHead_NEXT(list); gc != list;
        gc = _PyGCHead_NEXT(gc)) {
-    immortalize(FROM_GC(gc));
+    snapshot.emplace_back(Ref<>::create(FROM_GC(gc)));
+  }
 
-    auto immortalize_visitor = [](PyObject* obj, void*) {
-      immortalize(obj);
-      return 0;
+  UnorderedSet<PyObject*> excluded;
+  for (const Ref<>& obj : snapshot) {
+    int result = filter.active() ? filter.excludes(obj) : 0;
+    if (result < 0) {
+      return nullptr;
+    }
+    if (result) {
+      excluded.insert(obj.get());
+    }
+  }
+
+  /*
+   * Every tracked object is in the permanent generation and is normally a root
+   * of its own, so leaving only the excluded objects out would still
+   * immortalize everything they hold.  Also leave out the objects that can
+   * only be reached through an excluded object: first find everything
+   * reachable from the excluded objects, then take back what is also
+   * reachable from the rest of the permanent generation.
+   */
+  if (!excluded.empty()) {
+    UnorderedSet<PyObject*> permanent;
+    permanent.reserve(snapshot.size());
+    for (const Ref<>& obj : snapshot) {
+      permanent.insert(obj.get());
+    }
+
+    UnorderedSet<PyObject*> shadowed;
+    std::vector<PyObject*> worklist{excluded.begin(), excluded.end()};
+    while (!worklist.empty()) {
+      PyObject* obj = worklist.back();
+      worklist.pop_back();
+      for_each_referent(obj, [&](PyObject* referent) {
+        if (permanent.contains(referent) && !excluded.contains(referent) &&
+            shadowed.insert(referent).second) {
+          worklist.push_back(referent);
+        }
+      });
+    }
+
+    auto rescue = [&](PyObject* referent) {
+      if (shadowed.erase(referent) != 0) {
+        worklist.push_back(referent);
+      }
     };
-    Py_TYPE(FROM_GC(gc))
-        ->tp_traverse(FROM_GC(gc), immortalize_visitor, nullptr);
+    for (const Ref<>& obj : snapshot) {
+      if (!excluded.contains(obj.get()) && !shadowed.contains(obj.get())) {
+        for_each_referent(obj.get(), rescue);
+      }
+    }
+    while (!worklist.empty()) {
+      PyObject* obj = worklist.back();
+      worklist.pop_back();
+      for_each_referent(obj, rescue);
+    }
+
+    excluded.insert(shadowed.begin(), shadowed.end());
+  }
+
+  std::vector<PyObject*> roots;
+  roots.reserve(snapshot.size() - excluded.size());
+  for (const Ref<>& obj : snapshot) {
+    if (!excluded.contains(obj.get())) {
+      roots.push_back(obj.get());
+    }
+  }
+
+  /* Immortalize all instances in the permanent generation */
+  size_t num_threads = std::max<size_t>(
+      std::min(options.num_threads, roots.size()), 1);
+  std::vector<Immortalizer> immortalizers;
+  immortalizers.reserve(num_threads);
+  for (size_t i = 0; i < num_threads; i++) {
+    immortalizers.emplace_back(&excluded, num_threads > 1);
+  }
+
+  if (num_threads == 1) {
+    for (PyObject* obj : roots) {
+      immortalizers[0].immortalizeTracked(obj);
+    }
+  } else {
+    // The workers never call back into Python, and this thread keeps holding
+    // the GIL so nothing can mutate the heap underneath them.
+    size_t chunk = (roots.size() + num_threads - 1) / num_threads;
+    std::vector<std::thread> workers;
+    workers.reserve(num_threads);
+    for (size_t i = 0; i < num_threads; i++) {
+      size_t begin = std::min(i * chunk, roots.size());
+      size_t end = std::min(begin + chunk, roots.size());
+      workers.emplace_back([&immortalizer = immortalizers[i], &roots, begin, end] {
+        for (size_t j = begin; j < end; j++) {
+          immortalizer.immortalizeTracked(roots[j]);
+        }
+      });
+    }
+    for (std::thread& worker : workers) {
+      worker.join();
+    }
+  }
+
+  size_t objects = 0;
+  size_t bytes = 0;
+  for (Immortalizer& immortalizer : immortalizers) {
+    immortalizer.finish();
+    objects += immortalizer.objects();
+    bytes += immortalizer.bytes();
   }
+  s_heap_immortalized = true;
 
-  Py_RETURN_NONE;
+  Ref<> stats = Ref<>::steal(PyDict_New());
+  if (stats == nullptr) {
+    return nullptr;
+  }
+  Ref<> num_objects = Ref<>::steal(PyLong_FromSize_t(objects));
+  if (num_objects == nullptr ||
+      PyDict_SetItemString(stats, "objects", num_objects) < 0) {
+    return nullptr;
+  }
+  Ref<> num_bytes = Ref<>::steal(PyLong_FromSize_t(bytes));
+  if (num_bytes == nullptr ||
+      PyDict_SetItemString(stats, "bytes", num_bytes) < 0) {
+    return nullptr;
+  }
+  return stats.release();
 }
 
 } // namespace cinderx
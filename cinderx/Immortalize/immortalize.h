@@ -4,8 +4,12 @@
 
 #include "cinderx/python.h"
 
+#include "cinderx/Common/ref.h"
+
 #include <stdbool.h>
 
+#include <cstddef>
+
 namespace cinderx {
 
 /*
@@ -31,9 +35,46 @@ bool can_immortalize(PyObject* obj);
  */
 bool immortalize(PyObject* obj);
 
+/*
+ * Options for immortalize_heap().
+ *
+ * The filters only apply to objects tracked by the GC.  An excluded object is
+ * left mortal, and so are the tracked objects that can only be reached through
+ * excluded objects.  Anything that is also reachable from an object that isn't
+ * excluded is immortalized, as are untracked objects (strings, ints, ...) that
+ * an excluded object shares with an immortalized one.
+ */
+struct ImmortalizeHeapOptions {
+  // Number of threads used to walk the permanent generation.  1 walks it on
+  // the calling thread.
+  size_t num_threads{1};
+
+  // Tuple of types whose instances (including instances of subclasses) are
+  // left mortal, or nullptr.
+  BorrowedRef<> exclude_types;
+
+  // Iterable of module names.  Modules with these names or nested under them,
+  // along with the functions, classes, and instances of classes that they
+  // define, are left mortal.  May be nullptr.
+  BorrowedRef<> exclude_modules;
+
+  // Callable invoked with each remaining tracked object, returning a false
+  // value to leave that object mortal.  May be nullptr.
+  BorrowedRef<> predicate;
+};
+
 /*
  * Immortalize the Python objects currently on the heap.
+ *
+ * Returns a dict with the number of objects that were immortalized under
+ * "objects" and an estimate of the memory they occupy under "bytes", or
+ * nullptr with a Python exception set on failure.
+ */
+PyObject* immortalize_heap(const ImmortalizeHeapOptions& options);
+
+/*
+ * Check if immortalize_heap() has completed in this process.
  */
-PyObject* immortalize_heap(PyObject* mod);
+bool heap_immortalized();
 
 } // namespace cinderx
@@ -714,7 +714,7 @@ dummy_func(
                 if (item == NULL) {
                     goto error;
                 }
-            } else if (oparg == SEQ_ARRAY_INT64) {
+            } else if (SEQ_IS_ARRAY(oparg)) {
                 item = _Ci_StaticArray_Get(sequence, val);
                 if (item == NULL) {
                     goto error;
@@ -767,7 +767,7 @@ dummy_func(
                         goto error;
                     }
                 }
-            } else if (oparg == SEQ_ARRAY_INT64) {
+            } else if (SEQ_IS_ARRAY(oparg)) {
                 err = _Ci_StaticArray_Set(sequence, idx, v);
 
                 if (err != 0) {
@@ -806,7 +806,7 @@ dummy_func(
                     (oparg == FAST_LEN_SET && PyAnySet_CheckExact(collection)) ||
                     (oparg == FAST_LEN_TUPLE && PyTuple_CheckExact(collection)) ||
                     (oparg == FAST_LEN_ARRAY &&
-                    PyStaticArray_CheckExact(collection)) ||
+                    PyStaticArray_Check(collection)) ||
                     (oparg == FAST_LEN_STR && PyUnicode_CheckExact(collection))) {
                     inexact = 0;
                 }
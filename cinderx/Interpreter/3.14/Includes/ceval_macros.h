@@ -73,11 +73,11 @@
 #endif
 
 #ifdef Py_STATS
-#   define TAIL_CALL_PARAMS _PyInterpreterFrame *frame, _PyStackRef *stack_pointer, PyThreadState *tstate, _Py_CODEUNIT *next_instr, int oparg, int lastopcode, bool adaptive_enabled
-#   define TAIL_CALL_ARGS frame, stack_pointer, tstate, next_instr, oparg, lastopcode, adaptive_enabled
+#   define TAIL_CALL_PARAMS _PyInterpreterFrame *frame, _PyStackRef *stack_pointer, PyThreadState *tstate, _Py_CODEUNIT *next_instr, int oparg, int lastopcode, CodeExtra *adaptive_extra
+#   define TAIL_CALL_ARGS frame, stack_pointer, tstate, next_instr, oparg, lastopcode, adaptive_extra
 #else
-#   define TAIL_CALL_PARAMS _PyInterpreterFrame *frame, _PyStackRef *stack_pointer, PyThreadState *tstate, _Py_CODEUNIT *next_instr, int oparg, bool adaptive_enabled
-#   define TAIL_CALL_ARGS frame, stack_pointer, tstate, next_instr, oparg, adaptive_enabled
+#   define TAIL_CALL_PARAMS _PyInterpreterFrame *frame, _PyStackRef *stack_pointer, PyThreadState *tstate, _Py_CODEUNIT *next_instr, int oparg, CodeExtra *adaptive_extra
+#   define TAIL_CALL_ARGS frame, stack_pointer, tstate, next_instr, oparg, adaptive_extra
 #endif
 
 #if Py_TAIL_CALL_INTERP
@@ -98,12 +98,12 @@
 #   ifdef Py_STATS
 #       define JUMP_TO_PREDICTED(name) \
             do { \
-                Py_MUSTTAIL return (_TAIL_CALL_##name)(frame, stack_pointer, tstate, this_instr, oparg, lastopcode, adaptive_enabled); \
+                Py_MUSTTAIL return (_TAIL_CALL_##name)(frame, stack_pointer, tstate, this_instr, oparg, lastopcode, adaptive_extra); \
             } while (0)
 #   else
 #       define JUMP_TO_PREDICTED(name) \
             do { \
-                Py_MUSTTAIL return (_TAIL_CALL_##name)(frame, stack_pointer, tstate, this_instr, oparg, adaptive_enabled); \
+                Py_MUSTTAIL return (_TAIL_CALL_##name)(frame, stack_pointer, tstate, this_instr, oparg, adaptive_extra); \
             } while (0)
 #   endif
 #    define LABEL(name) TARGET(name)
@@ -281,7 +281,7 @@ GETITEM(PyObject *v, Py_ssize_t i) {
     backoff_counter_triggers(forge_backoff_counter((COUNTER)))
 
 #define ADVANCE_ADAPTIVE_COUNTER(COUNTER) \
-    if (adaptive_enabled) { \
+    if (adaptive_extra) { \
         (COUNTER) = advance_backoff_counter((COUNTER)); \
     }
 
@@ -434,11 +434,14 @@ do { \
 #define CI_SET_ADAPTIVE_INTERPRETER_ENABLED_STATE \
     do { \
         PyObject *executable = PyStackRef_AsPyObjectBorrow(frame->f_executable); \
+        adaptive_extra = NULL; \
         if (PyCode_Check(executable)) { \
             PyCodeObject* code = (PyCodeObject*)executable; \
             if (!(code->co_flags & CO_NO_MONITORING_EVENTS)) { \
                 CodeExtra *extra = codeExtra(code); \
-                adaptive_enabled = extra != NULL && is_adaptive_enabled(extra); \
+                if (extra != NULL && is_adaptive_enabled(extra)) { \
+                    adaptive_extra = extra; \
+                } \
             } \
         } \
     } while (0);
@@ -446,15 +449,16 @@ do { \
 #define CI_UPDATE_CALL_COUNT \
     do { \
         PyObject *executable = PyStackRef_AsPyObjectBorrow(frame->f_executable); \
+        adaptive_extra = NULL; \
         if (PyCode_Check(executable)) { \
             PyCodeObject* code = (PyCodeObject*)executable; \
             if (!(code->co_flags & CO_NO_MONITORING_EVENTS)) { \
                 CodeExtra *extra = codeExtra(code); \
-                if (extra == NULL) { \
-                    adaptive_enabled = false; \
-                } else { \
+                if (extra != NULL) { \
                     Ci_code_extra_incr_calls(extra); \
-                    adaptive_enabled = is_adaptive_enabled(extra); \
+                    if (is_adaptive_enabled(extra)) { \
+                        adaptive_extra = extra; \
+                    } \
                 } \
             } \
         } \
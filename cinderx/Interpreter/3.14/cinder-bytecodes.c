@@ -603,7 +603,7 @@ dummy_func(
                 PyObject* local = GETITEM(FRAME_CO_CONSTS, extoparg);
                 int index = PyLong_AsInt(PyTuple_GET_ITEM(local, 0));
                 int type =
-                    _PyClassLoader_ResolvePrimitiveType(PyTuple_GET_ITEM(local, 1));
+                    Ci_StaticCache_ResolvePrimitiveType(STATIC_CACHE_SLOT(), PyTuple_GET_ITEM(local, 1));
 
                 if (type < 0) {
                     DECREF_INPUTS();
@@ -620,15 +620,6 @@ dummy_func(
 
                 PyStackRef_XCLOSE(tmp);
 
-#if ENABLE_SPECIALIZATION && defined(ENABLE_ADAPTIVE_STATIC_PYTHON)
-                if (adaptive_enabled) {
-                    if (index < INT8_MAX && type < INT8_MAX) {
-                        int16_t *cache = (int16_t*)next_instr;
-                        *cache = (index << 8) | type;
-                        _Ci_specialize(next_instr, STORE_LOCAL_CACHED);
-                    }
-                }
-#endif
                 DECREF_INPUTS();
             } else if (extop == LOAD_LOCAL) {
                 int index = PyLong_AsInt(PyTuple_GET_ITEM(GETITEM(FRAME_CO_CONSTS, extoparg), 0));
@@ -707,7 +698,7 @@ dummy_func(
                         DECREF_INPUTS();
                         ERROR_IF(true);
                     }
-                } else if (extoparg == SEQ_ARRAY_INT64) {
+                } else if (SEQ_IS_ARRAY(extoparg)) {
                     item = _Ci_StaticArray_Get(sequence, val);
                     if (item == NULL) {
                         DECREF_INPUTS();
@@ -768,7 +759,7 @@ dummy_func(
                             ERROR_IF(true);
                         }
                     }
-                } else if (extoparg == SEQ_ARRAY_INT64) {
+                } else if (SEQ_IS_ARRAY(extoparg)) {
                     err = _Ci_StaticArray_Set(sequence, idx, v);
 
                     if (err != 0) {
@@ -796,7 +787,7 @@ dummy_func(
                         (extoparg == FAST_LEN_SET && PyAnySet_CheckExact(collection)) ||
                         (extoparg == FAST_LEN_TUPLE && PyTuple_CheckExact(collection)) ||
                         (extoparg == FAST_LEN_ARRAY &&
-                        PyStaticArray_CheckExact(collection)) ||
+                        PyStaticArray_Check(collection)) ||
                         (extoparg == FAST_LEN_STR && PyUnicode_CheckExact(collection))) {
                         inexact = 0;
                     }
@@ -817,7 +808,7 @@ dummy_func(
                 } else {
                     // lists, tuples, arrays are all PyVarObject and use ob_size
                     assert(PyTuple_Check(collection) || PyList_Check(collection) ||
-                           PyStaticArray_CheckExact(collection) || PyUnicode_Check(collection) ||
+                           PyStaticArray_Check(collection) || PyUnicode_Check(collection) ||
                            Ci_CheckedList_Check(collection));
                     length = PyLong_FromLong(Py_SIZE(collection));
                 }
@@ -865,14 +856,9 @@ dummy_func(
                 int optional;
                 int exact;
                 PyTypeObject* type =
-                    _PyClassLoader_ResolveType(list_type, &optional, &exact);
+                    Ci_StaticCache_ResolveType(STATIC_CACHE_SLOT(), list_type, &optional, &exact);
                 assert(!optional);
 
-#if ENABLE_SPECIALIZATION && defined(ENABLE_ADAPTIVE_STATIC_PYTHON)
-                if (adaptive_enabled) {
-                    specialize_with_value(next_instr, (PyObject *)type, BUILD_CHECKED_LIST_CACHED, 0, 0);
-                }
-#endif
 
                 list = Ci_CheckedList_New(type, list_size);
                 Py_DECREF(type);
@@ -895,18 +881,13 @@ dummy_func(
                 int optional;
                 int exact;
                 PyTypeObject* type =
-                    _PyClassLoader_ResolveType(map_type, &optional, &exact);
+                    Ci_StaticCache_ResolveType(STATIC_CACHE_SLOT(), map_type, &optional, &exact);
                 if (type == NULL) {
                     DECREF_INPUTS();
                     ERROR_IF(true);
                 }
                 assert(!optional);
 
-#if ENABLE_SPECIALIZATION && defined(ENABLE_ADAPTIVE_STATIC_PYTHON)
-                if (adaptive_enabled) {
-                    specialize_with_value(next_instr, (PyObject *)type, BUILD_CHECKED_MAP_CACHED, 0, 0);
-                }
-#endif
 
                 PyObject *map = Ci_CheckedDict_NewPresized(type, map_size);
                 Py_DECREF(type);
@@ -928,27 +909,12 @@ dummy_func(
                 PyObject* target = PyTuple_GET_ITEM(value, 0);
                 int is_classmethod = _PyClassLoader_IsClassMethodDescr(value);
 
-                Py_ssize_t slot = _PyClassLoader_ResolveMethod(target);
+                Py_ssize_t slot = Ci_StaticCache_ResolveMethod(STATIC_CACHE_SLOT(), target);
                 if (slot == -1) {
                     DECREF_INPUTS();
                     ERROR_IF(true);
                 }
 
-#if ENABLE_SPECIALIZATION && defined(ENABLE_ADAPTIVE_STATIC_PYTHON)
-            if (adaptive_enabled) {
-                // We encode class method as the low bit hence the >> 1.
-                if (slot < (INT32_MAX >> 1)) {
-                    /* We smuggle in the information about whether the invocation was a
-                    * classmethod in the low bit of the oparg. This is necessary, as
-                    * without, the runtime won't be able to get the correct vtable from
-                    * self when the type is passed in.
-                    */
-                    int32_t *cache = (int32_t*)next_instr;
-                    *cache = load_method_static_cached_oparg(slot, is_classmethod);
-                    _Ci_specialize(next_instr, LOAD_METHOD_STATIC_CACHED);
-                }
-            }
-#endif
 
                 _PyType_VTable* vtable;
                 if (is_classmethod) {
@@ -993,7 +959,7 @@ dummy_func(
                 int nargs = oparg >> 2;
                 PyObject* target = PyTuple_GET_ITEM(value, 0);
                 PyObject* container;
-                PyObject* func = _PyClassLoader_ResolveFunction(target, &container);
+                PyObject* func = Ci_StaticCache_ResolveFunction(STATIC_CACHE_SLOT(), target, &container);
                 if (func == NULL) {
                     DECREF_INPUTS();
                     ERROR_IF(true);
@@ -1006,23 +972,8 @@ dummy_func(
                 }
                 PyObject *res = _PyObject_Vectorcall(func, args_o, nargs, NULL);
                 STACKREFS_TO_PYOBJECTS_CLEANUP(args_o);
-#if ENABLE_SPECIALIZATION && defined(ENABLE_ADAPTIVE_STATIC_PYTHON)
-                if (adaptive_enabled) {
-                    if (_PyClassLoader_IsImmutable(container)) {
-                        /* frozen type, we don't need to worry about indirecting */
-                        specialize_with_value(next_instr, func, INVOKE_FUNCTION_CACHED, 0, 0);
-                    } else if (_Py_IsImmortal(container)) {
-                        // We can only grab a cached pointer if the container is immortal as we have no way
-                        // to invalidate if the container is freed.
-                        PyObject** funcptr = _PyClassLoader_ResolveIndirectPtr(target);
-                        PyObject ***cache = (PyObject ***)next_instr;
-                        *cache = funcptr;
-                        _Ci_specialize(next_instr, INVOKE_INDIRECT_CACHED);
-                    }
-                }
-#endif
                 Py_DECREF(func);
-                Py_DECREF(container);
+                Py_XDECREF(container);
                 DECREF_INPUTS();
                 ERROR_IF(res == NULL);
                 top[0] = PyStackRef_FromPyObjectSteal(res);
@@ -1051,7 +1002,7 @@ dummy_func(
             } else if (extop == TP_ALLOC) {
                 int optional;
                 int exact;
-                PyTypeObject *type = _PyClassLoader_ResolveType(
+                PyTypeObject *type = Ci_StaticCache_ResolveType(STATIC_CACHE_SLOT(),
                     GETITEM(FRAME_CO_CONSTS, extoparg), &optional, &exact);
                 assert(!optional);
                 if (type == NULL) {
@@ -1061,11 +1012,6 @@ dummy_func(
 
                 PyObject *inst = type->tp_alloc(type, 0);
 
-#if ENABLE_SPECIALIZATION && defined(ENABLE_ADAPTIVE_STATIC_PYTHON)
-                if (adaptive_enabled) {
-                    specialize_with_value(next_instr, func, TP_ALLOC_CACHED, 0, 0);
-                }
- #endif
                 Py_DECREF(type);
                 DECREF_INPUTS();
                 ERROR_IF(inst == NULL);
@@ -1074,17 +1020,12 @@ dummy_func(
                 PyObject *val = PyStackRef_AsPyObjectBorrow(args[0]);
                 int optional;
                 int exact;
-                PyTypeObject* type = _PyClassLoader_ResolveType(
+                PyTypeObject* type = Ci_StaticCache_ResolveType(STATIC_CACHE_SLOT(),
                     GETITEM(FRAME_CO_CONSTS, extoparg), &optional, &exact);
                 if (type == NULL) {
                     DECREF_INPUTS();
                     ERROR_IF(true);
                 }
-#if ENABLE_SPECIALIZATION && defined(ENABLE_ADAPTIVE_STATIC_PYTHON)
-                if (adaptive_enabled) {
-                    specialize_with_value(next_instr, (PyObject *)type, CAST_CACHED, 2, (exact << 1) | optional);
-                }
-#endif
                 _PyStackRef res;
                 if (!_PyObject_TypeCheckOptional(val, type, optional, exact)) {
                     if (type == &PyFloat_Type && PyObject_TypeCheck(val, &PyLong_Type)) {
@@ -1122,14 +1063,14 @@ dummy_func(
                 ERROR_IF(res == NULL);
                 top[0] = PyStackRef_FromPyObjectSteal(res);
             } else if (extop == PRIMITIVE_BINARY_OP) {
-                PyObject *res = primitive_binary_op(PyStackRef_AsPyObjectBorrow(args[0]),
-                                                    PyStackRef_AsPyObjectBorrow(args[1]), extoparg);
+                PyObject *res = Ci_PrimitiveBinaryOp(PyStackRef_AsPyObjectBorrow(args[0]),
+                                                     PyStackRef_AsPyObjectBorrow(args[1]), extoparg);
                 DECREF_INPUTS();
                 ERROR_IF(res == NULL);
                 top[0] = PyStackRef_FromPyObjectSteal(res);
             } else if (extop == PRIMITIVE_COMPARE_OP) {
-                PyObject *res = primitive_compare_op(PyStackRef_AsPyObjectBorrow(args[0]),
-                                                     PyStackRef_AsPyObjectBorrow(args[1]), extoparg);
+                PyObject *res = Ci_PrimitiveCompareOp(PyStackRef_AsPyObjectBorrow(args[0]),
+                                                      PyStackRef_AsPyObjectBorrow(args[1]), extoparg);
                 DECREF_INPUTS();
                 ERROR_IF(res == NULL);
                 top[0] = PyStackRef_FromPyObjectSteal(res);
@@ -1139,7 +1080,7 @@ dummy_func(
                 PyObject *value;
                 int field_type;
                 Py_ssize_t offset =
-                    _PyClassLoader_ResolveFieldOffset(field, &field_type);
+                    Ci_StaticCache_ResolveFieldOffset(STATIC_CACHE_SLOT(), field, &field_type);
                 if (offset == -1) {
                     DECREF_INPUTS();
                     ERROR_IF(true);
@@ -1147,15 +1088,6 @@ dummy_func(
 
                 if (field_type == TYPED_OBJECT) {
                     value = *FIELD_OFFSET(self, offset);
-#if ENABLE_SPECIALIZATION && defined(ENABLE_ADAPTIVE_STATIC_PYTHON)
-                    if (adaptive_enabled) {
-                        if (offset < INT32_MAX) {
-                            int32_t *cache = (int32_t*)next_instr;
-                            *cache = offset;
-                            _Ci_specialize(next_instr, LOAD_OBJ_FIELD);
-                        }
-                    }
-#endif
 
                     if (value == NULL) {
                         PyObject* name =
@@ -1170,16 +1102,6 @@ dummy_func(
                     }
                     Py_INCREF(value);
                 } else {
-#if ENABLE_SPECIALIZATION && defined(ENABLE_ADAPTIVE_STATIC_PYTHON)
-                    if (adaptive_enabled) {
-                        if (offset <= INT32_MAX >> 8) {
-                            assert(field_type < 0xff);
-                            int32_t *cache = (int32_t*)next_instr;
-                            *cache = offset << 8 | field_type;
-                            _Ci_specialize(next_instr, LOAD_PRIMITIVE_FIELD);
-                        }
-                    }
-#endif
 
                     value = load_field(field_type, (char*)FIELD_OFFSET(self, offset));
                     if (value == NULL) {
@@ -1195,7 +1117,7 @@ dummy_func(
                 PyObject* field = GETITEM(FRAME_CO_CONSTS, extoparg);
                 int field_type;
                 Py_ssize_t offset =
-                    _PyClassLoader_ResolveFieldOffset(field, &field_type);
+                    Ci_StaticCache_ResolveFieldOffset(STATIC_CACHE_SLOT(), field, &field_type);
                 if (offset == -1) {
                     DECREF_INPUTS();
                     ERROR_IF(true);
@@ -1207,26 +1129,7 @@ dummy_func(
                     Py_INCREF(value);
                     Py_XDECREF(*addr);
                     *addr = value;
-#if ENABLE_SPECIALIZATION && defined(ENABLE_ADAPTIVE_STATIC_PYTHON)
-                    if (adaptive_enabled) {
-                        if (offset <= INT32_MAX) {
-                            int32_t *cache = (int32_t*)next_instr;
-                            *cache = offset;
-                            _Ci_specialize(next_instr, STORE_OBJ_FIELD);
-                        }
-                    }
-#endif
                 } else {
-#if ENABLE_SPECIALIZATION && defined(ENABLE_ADAPTIVE_STATIC_PYTHON)
-                    if (adaptive_enabled) {
-                        if (offset <= INT32_MAX >> 8) {
-                            assert(field_type < 0xff);
-                            int32_t *cache = (int32_t*)next_instr;
-                            *cache = offset << 8 | field_type;
-                            _Ci_specialize(next_instr, STORE_PRIMITIVE_FIELD);
-                        }
-                    }
-#endif
                     store_field(field_type, (char*)addr, value);
                 }
                 DECREF_INPUTS();
@@ -6,6 +6,8 @@
 
 #include "cinderx/UpstreamBorrow/borrowed.h"
 #include "cinderx/Interpreter/cinder_opcode.h"
+#include "cinderx/Interpreter/primitive_ops.h"
+#include "cinderx/Interpreter/static_cache.h"
 
 #include "cinderx/module_c_state.h"
 
@@ -221,6 +223,16 @@ static void store_field(int field_type, void* addr, PyObject* value) {
 
 #define FIELD_OFFSET(self, offset) (PyObject**)(((char*)self) + offset)
 
+// The cache slot for the executing static opcode, or NULL to resolve its
+// descriptor without caching.
+#define STATIC_CACHE_SLOT()                                                  \
+    (adaptive_extra                                                          \
+         ? Ci_StaticCache_Slot(                                              \
+               adaptive_extra,                                               \
+               _PyFrame_GetCode(frame),                                      \
+               frame->instr_ptr - _PyFrame_GetBytecode(frame))               \
+         : NULL)
+
 static int ci_build_dict(_PyStackRef *map_items, Py_ssize_t map_size, PyObject *map)
 {
     for (Py_ssize_t i = 0; i < map_size; i++) {
@@ -233,19 +245,6 @@ static int ci_build_dict(_PyStackRef *map_items, Py_ssize_t map_size, PyObject *
     return 0;
 }
 
-#if ENABLE_SPECIALIZATION && defined(ENABLE_ADAPTIVE_STATIC_PYTHON)
-static void specialize_with_value(_Py_CODEUNIT next_instr, PyObject *value, int opcode,
-                                  int shift, int bits)
-{
-    int32_t index = _PyClassLoader_CacheValue(value);
-    if (index >= 0 && index <= (INT32_MAX >> 2)) {
-        int32_t *cache = (int32_t*)next_instr;
-        *cache = (int32_t)(index << shift) | bits;
-        _Ci_specialize(next_instr, opcode);
-    }
-}
-#endif
-
 #define INT_UNARY_OPCODE(opid, op)                                           \
     case opid:                                                               \
         res = PyLong_FromVoidPtr((void*)(op(size_t) PyLong_AsVoidPtr(val))); \
@@ -276,124 +275,6 @@ primitive_unary_op(PyObject *val, int oparg)
     return res;
 }
 
-#define INT_BIN_OPCODE_UNSIGNED(opid, op)                                 \
-    case opid:                                                            \
-        res = PyLong_FromVoidPtr((void*)(((size_t)PyLong_AsVoidPtr(l))op( \
-            (size_t)PyLong_AsVoidPtr(r))));                               \
-        break;
-
-#define INT_BIN_OPCODE_SIGNED(opid, op)                                       \
-    case opid:                                                                \
-        res = PyLong_FromVoidPtr((void*)(((Py_ssize_t)PyLong_AsVoidPtr(l))op( \
-            (Py_ssize_t)PyLong_AsVoidPtr(r))));                               \
-        break;
-
-#define DOUBLE_BIN_OPCODE(opid, op)                                                 \
-    case opid:                                                                      \
-        res = (PyFloat_FromDouble((PyFloat_AS_DOUBLE(l))op(PyFloat_AS_DOUBLE(r)))); \
-        break;
-
-static PyObject *
-primitive_binary_op(PyObject *l, PyObject *r, int oparg)
-{
-    PyObject *res;
-    switch (oparg) {
-        INT_BIN_OPCODE_UNSIGNED(PRIM_OP_ADD_INT, +)
-        INT_BIN_OPCODE_UNSIGNED(PRIM_OP_SUB_INT, -)
-        INT_BIN_OPCODE_UNSIGNED(PRIM_OP_MUL_INT, *)
-        INT_BIN_OPCODE_SIGNED(PRIM_OP_DIV_INT, /)
-        INT_BIN_OPCODE_SIGNED(PRIM_OP_MOD_INT, %)
-        case PRIM_OP_POW_INT: {
-            double power =
-                pow((Py_ssize_t)PyLong_AsVoidPtr(l),
-                    (Py_ssize_t)PyLong_AsVoidPtr(r));
-            res = PyFloat_FromDouble(power);
-            break;
-        }
-        case PRIM_OP_POW_UN_INT: {
-            double power =
-                pow((size_t)PyLong_AsVoidPtr(l), (size_t)PyLong_AsVoidPtr(r));
-            res = PyFloat_FromDouble(power);
-            break;
-        }
-
-        INT_BIN_OPCODE_SIGNED(PRIM_OP_LSHIFT_INT, <<)
-        INT_BIN_OPCODE_SIGNED(PRIM_OP_RSHIFT_INT, >>)
-        INT_BIN_OPCODE_UNSIGNED(PRIM_OP_XOR_INT, ^)
-        INT_BIN_OPCODE_UNSIGNED(PRIM_OP_OR_INT, |)
-        INT_BIN_OPCODE_UNSIGNED(PRIM_OP_AND_INT, &)
-        INT_BIN_OPCODE_UNSIGNED(PRIM_OP_MOD_UN_INT, %)
-        INT_BIN_OPCODE_UNSIGNED(PRIM_OP_DIV_UN_INT, /)
-        INT_BIN_OPCODE_UNSIGNED(PRIM_OP_RSHIFT_UN_INT, >>)
-        DOUBLE_BIN_OPCODE(PRIM_OP_ADD_DBL, +)
-        DOUBLE_BIN_OPCODE(PRIM_OP_SUB_DBL, -)
-        DOUBLE_BIN_OPCODE(PRIM_OP_MUL_DBL, *)
-        DOUBLE_BIN_OPCODE(PRIM_OP_DIV_DBL, /)
-        case PRIM_OP_POW_DBL: {
-            double power = pow(PyFloat_AsDouble(l), PyFloat_AsDouble(r));
-            res = PyFloat_FromDouble(power);
-            break;
-        }
-        default:
-            PyErr_SetString(PyExc_RuntimeError, "unknown op");
-            return NULL;
-    }
-    return res;
-}
-
-#define INT_CMP_OPCODE_UNSIGNED(opid, op)           \
-    case opid:                                      \
-        right = (size_t)PyLong_AsVoidPtr(r);        \
-        left = (size_t)PyLong_AsVoidPtr(l);         \
-        res = (left op right) ? Py_True : Py_False; \
-        Py_INCREF(res);                             \
-        break;
-
-#define INT_CMP_OPCODE_SIGNED(opid, op)               \
-    case opid:                                        \
-        sright = (Py_ssize_t)PyLong_AsVoidPtr(r);     \
-        sleft = (Py_ssize_t)PyLong_AsVoidPtr(l);      \
-        res = (sleft op sright) ? Py_True : Py_False; \
-        Py_INCREF(res);                               \
-        break;
-
-#define DBL_CMP_OPCODE(opid, op)                                                   \
-    case opid:                                                                     \
-        res =                                                                      \
-            ((PyFloat_AS_DOUBLE(l) op PyFloat_AS_DOUBLE(r)) ? Py_True : Py_False); \
-        Py_INCREF(res);                                                            \
-        break;
-
-static PyObject *
-primitive_compare_op(PyObject *l, PyObject *r, int oparg)
-{
-    PyObject *res;
-    Py_ssize_t sleft, sright;
-    size_t left, right;
-    switch (oparg) {
-        INT_CMP_OPCODE_SIGNED(PRIM_OP_EQ_INT, ==)
-        INT_CMP_OPCODE_SIGNED(PRIM_OP_NE_INT, !=)
-        INT_CMP_OPCODE_SIGNED(PRIM_OP_LT_INT, <)
-        INT_CMP_OPCODE_SIGNED(PRIM_OP_GT_INT, >)
-        INT_CMP_OPCODE_SIGNED(PRIM_OP_LE_INT, <=)
-        INT_CMP_OPCODE_SIGNED(PRIM_OP_GE_INT, >=)
-        INT_CMP_OPCODE_UNSIGNED(PRIM_OP_LT_UN_INT, <)
-        INT_CMP_OPCODE_UNSIGNED(PRIM_OP_GT_UN_INT, >)
-        INT_CMP_OPCODE_UNSIGNED(PRIM_OP_LE_UN_INT, <=)
-        INT_CMP_OPCODE_UNSIGNED(PRIM_OP_GE_UN_INT, >=)
-        DBL_CMP_OPCODE(PRIM_OP_EQ_DBL, ==)
-        DBL_CMP_OPCODE(PRIM_OP_NE_DBL, !=)
-        DBL_CMP_OPCODE(PRIM_OP_LT_DBL, <)
-        DBL_CMP_OPCODE(PRIM_OP_GT_DBL, >)
-        DBL_CMP_OPCODE(PRIM_OP_LE_DBL, <=)
-        DBL_CMP_OPCODE(PRIM_OP_GE_DBL, >=)
-        default:
-            PyErr_SetString(PyExc_RuntimeError, "unknown op");
-            return NULL;
-    }
-    return res;
-}
-
 #define INVOKE_FUNCTION_CACHE_SIZE 4
 #define TP_ALLOC_CACHE_SIZE 2
 #define STORE_LOCAL_CACHE_SIZE 1
@@ -414,6 +295,7 @@ Ci_EvalFrame(PyThreadState *tstate, _PyInterpreterFrame *frame, int throwflag);
 #endif
 
 void Ci_InitOpcodes() {
+    Ci_StaticCache_Init();
 #ifdef ENABLE_ADAPTIVE_STATIC_PYTHON
     // patch CPython's opcode data
     for (int i = 0; i < sizeof(_CiOpcode_Caches) / sizeof(_CiOpcode_Caches[0]); i++) {
@@ -425,12 +307,6 @@ void Ci_InitOpcodes() {
 #endif
 }
 
-static void
-_Ci_specialize(_Py_CODEUNIT *next_instr, int opcode)
-{
-    (next_instr - 1)->op.code = opcode;
-}
-
 int load_method_static_cached_oparg(Py_ssize_t slot, bool is_classmethod) {
     return (slot << 1) | (is_classmethod ? 1 : 0);
 }
@@ -515,7 +391,7 @@ Ci_EvalFrame(PyThreadState *tstate, _PyInterpreterFrame *frame, int throwflag)
 #endif
 
     /* support for generator.throw() */
-    bool adaptive_enabled = false;
+    CodeExtra *adaptive_extra = NULL;
     if (throwflag) {
         if (_Py_EnterRecursivePy(tstate)) {
             goto early_exit;
@@ -540,9 +416,9 @@ Ci_EvalFrame(PyThreadState *tstate, _PyInterpreterFrame *frame, int throwflag)
         stack_pointer = _PyFrame_GetStackPointer(frame);
 #if Py_TAIL_CALL_INTERP
 #   if Py_STATS
-        return _TAIL_CALL_error(frame, stack_pointer, tstate, next_instr, 0, lastopcode, adaptive_enabled);
+        return _TAIL_CALL_error(frame, stack_pointer, tstate, next_instr, 0, lastopcode, adaptive_extra);
 #   else
-        return _TAIL_CALL_error(frame, stack_pointer, tstate, next_instr, 0, adaptive_enabled);
+        return _TAIL_CALL_error(frame, stack_pointer, tstate, next_instr, 0, adaptive_extra);
 #   endif
 #else
         goto error;
@@ -556,9 +432,9 @@ Ci_EvalFrame(PyThreadState *tstate, _PyInterpreterFrame *frame, int throwflag)
 #endif
 #if Py_TAIL_CALL_INTERP
 #   if Py_STATS
-        return _TAIL_CALL_start_frame(frame, NULL, tstate, NULL, 0, lastopcode, adaptive_enabled);
+        return _TAIL_CALL_start_frame(frame, NULL, tstate, NULL, 0, lastopcode, adaptive_extra);
 #   else
-        return _TAIL_CALL_start_frame(frame, NULL, tstate, NULL, 0, adaptive_enabled);
+        return _TAIL_CALL_start_frame(frame, NULL, tstate, NULL, 0, adaptive_extra);
 #   endif
 #else
     goto start_frame;
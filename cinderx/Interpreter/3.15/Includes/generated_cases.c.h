@@ -6033,7 +6033,7 @@
                 _PyFrame_SetStackPointer(frame, stack_pointer);
                 int index = PyLong_AsInt(PyTuple_GET_ITEM(local, 0));
                 int type =
-                _PyClassLoader_ResolvePrimitiveType(PyTuple_GET_ITEM(local, 1));
+                Ci_StaticCache_ResolvePrimitiveType(STATIC_CACHE_SLOT(), PyTuple_GET_ITEM(local, 1));
                 stack_pointer = _PyFrame_GetStackPointer(frame);
                 if (type < 0) {
                     stack_pointer += -(oparg >> 2) + (oparg & 0x03);
@@ -6061,17 +6061,6 @@
                 _PyFrame_SetStackPointer(frame, stack_pointer);
                 PyStackRef_XCLOSE(tmp);
                 stack_pointer = _PyFrame_GetStackPointer(frame);
-                #if ENABLE_SPECIALIZATION && defined(ENABLE_ADAPTIVE_STATIC_PYTHON)
-                if (adaptive_enabled) {
-                    if (index < INT8_MAX && type < INT8_MAX) {
-                        int16_t* cache = (int16_t*)next_instr;
-                        *cache = (index << 8) | type;
-                        _PyFrame_SetStackPointer(frame, stack_pointer);
-                        _Ci_specialize(next_instr, STORE_LOCAL_CACHED);
-                        stack_pointer = _PyFrame_GetStackPointer(frame);
-                    }
-                }
-                #endif
                 stack_pointer += -(oparg >> 2) + (oparg & 0x03);
                 ASSERT_WITHIN_STACK_BOUNDS(__FILE__, __LINE__);
                 _PyFrame_SetStackPointer(frame, stack_pointer);
@@ -6218,7 +6207,7 @@
                         ASSERT_WITHIN_STACK_BOUNDS(__FILE__, __LINE__);
                         JUMP_TO_LABEL(error);
                     }
-                } else if (extoparg == SEQ_ARRAY_INT64) {
+                } else if (SEQ_IS_ARRAY(extoparg)) {
                     _PyFrame_SetStackPointer(frame, stack_pointer);
                     item = _Ci_StaticArray_Get(sequence, val);
                     stack_pointer = _PyFrame_GetStackPointer(frame);
@@ -6341,7 +6330,7 @@
                             JUMP_TO_LABEL(error);
                         }
                     }
-                } else if (extoparg == SEQ_ARRAY_INT64) {
+                } else if (SEQ_IS_ARRAY(extoparg)) {
                     _PyFrame_SetStackPointer(frame, stack_pointer);
                     err = _Ci_StaticArray_Set(sequence, idx, v);
                     stack_pointer = _PyFrame_GetStackPointer(frame);
@@ -6392,7 +6381,7 @@
                         (extoparg == FAST_LEN_SET && PyAnySet_CheckExact(collection)) ||
                         (extoparg == FAST_LEN_TUPLE && PyTuple_CheckExact(collection)) ||
                         (extoparg == FAST_LEN_ARRAY &&
-                            PyStaticArray_CheckExact(collection)) ||
+                            PyStaticArray_Check(collection)) ||
                         (extoparg == FAST_LEN_STR && PyUnicode_CheckExact(collection))) {
                         inexact = 0;
                     }
@@ -6417,7 +6406,7 @@
                 } else {
                     assert(
                         PyTuple_Check(collection) || PyList_Check(collection) ||
-                        PyStaticArray_CheckExact(collection) ||
+                        PyStaticArray_Check(collection) ||
                         PyUnicode_Check(collection) || Ci_CheckedList_Check(collection));
                     length = PyLong_FromLong(Py_SIZE(collection));
                 }
@@ -6509,17 +6498,9 @@
                 int exact;
                 _PyFrame_SetStackPointer(frame, stack_pointer);
                 PyTypeObject* type =
-                _PyClassLoader_ResolveType(list_type, &optional, &exact);
+                Ci_StaticCache_ResolveType(STATIC_CACHE_SLOT(), list_type, &optional, &exact);
                 stack_pointer = _PyFrame_GetStackPointer(frame);
                 assert(!optional);
-                #if ENABLE_SPECIALIZATION && defined(ENABLE_ADAPTIVE_STATIC_PYTHON)
-                if (adaptive_enabled) {
-                    _PyFrame_SetStackPointer(frame, stack_pointer);
-                    specialize_with_value(
-                                next_instr, (PyObject*)type, BUILD_CHECKED_LIST_CACHED, 0, 0);
-                    stack_pointer = _PyFrame_GetStackPointer(frame);
-                }
-                #endif
                 _PyFrame_SetStackPointer(frame, stack_pointer);
                 list = Ci_CheckedList_New(type, list_size);
                 Py_DECREF(type);
@@ -6558,7 +6539,7 @@
                 int exact;
                 _PyFrame_SetStackPointer(frame, stack_pointer);
                 PyTypeObject* type =
-                _PyClassLoader_ResolveType(map_type, &optional, &exact);
+                Ci_StaticCache_ResolveType(STATIC_CACHE_SLOT(), map_type, &optional, &exact);
                 stack_pointer = _PyFrame_GetStackPointer(frame);
                 if (type == NULL) {
                     stack_pointer += -(oparg >> 2) + (oparg & 0x03);
@@ -6573,14 +6554,6 @@
                     JUMP_TO_LABEL(error);
                 }
                 assert(!optional);
-                #if ENABLE_SPECIALIZATION && defined(ENABLE_ADAPTIVE_STATIC_PYTHON)
-                if (adaptive_enabled) {
-                    _PyFrame_SetStackPointer(frame, stack_pointer);
-                    specialize_with_value(
-                                next_instr, (PyObject*)type, BUILD_CHECKED_MAP_CACHED, 0, 0);
-                    stack_pointer = _PyFrame_GetStackPointer(frame);
-                }
-                #endif
                 _PyFrame_SetStackPointer(frame, stack_pointer);
                 PyObject* map = Ci_CheckedDict_NewPresized(type, map_size);
                 Py_DECREF(type);
@@ -6626,7 +6599,7 @@
                 PyObject* target = PyTuple_GET_ITEM(value, 0);
                 _PyFrame_SetStackPointer(frame, stack_pointer);
                 int is_classmethod = _PyClassLoader_IsClassMethodDescr(value);
-                Py_ssize_t slot = _PyClassLoader_ResolveMethod(target);
+                Py_ssize_t slot = Ci_StaticCache_ResolveMethod(STATIC_CACHE_SLOT(), target);
                 stack_pointer = _PyFrame_GetStackPointer(frame);
                 if (slot == -1) {
                     stack_pointer += -(oparg >> 2) + (oparg & 0x03);
@@ -6640,17 +6613,6 @@
                     ASSERT_WITHIN_STACK_BOUNDS(__FILE__, __LINE__);
                     JUMP_TO_LABEL(error);
                 }
-                #if ENABLE_SPECIALIZATION && defined(ENABLE_ADAPTIVE_STATIC_PYTHON)
-                if (adaptive_enabled) {
-                    if (slot < (INT32_MAX >> 1)) {
-                        int32_t* cache = (int32_t*)next_instr;
-                        _PyFrame_SetStackPointer(frame, stack_pointer);
-                        *cache = load_method_static_cached_oparg(slot, is_classmethod);
-                        _Ci_specialize(next_instr, LOAD_METHOD_STATIC_CACHED);
-                        stack_pointer = _PyFrame_GetStackPointer(frame);
-                    }
-                }
-                #endif
 
                 _PyType_VTable* vtable;
                 if (is_classmethod) {
@@ -6727,7 +6689,7 @@
                 PyObject* target = PyTuple_GET_ITEM(value, 0);
                 PyObject* container;
                 _PyFrame_SetStackPointer(frame, stack_pointer);
-                PyObject* func = _PyClassLoader_ResolveFunction(target, &container);
+                PyObject* func = Ci_StaticCache_ResolveFunction(STATIC_CACHE_SLOT(), target, &container);
                 stack_pointer = _PyFrame_GetStackPointer(frame);
                 if (func == NULL) {
                     stack_pointer += -(oparg >> 2) + (oparg & 0x03);
@@ -6758,28 +6720,9 @@
                 PyObject* res = _PyObject_Vectorcall(func, args_o, nargs, NULL);
                 stack_pointer = _PyFrame_GetStackPointer(frame);
                 STACKREFS_TO_PYOBJECTS_CLEANUP(args_o);
-                #if ENABLE_SPECIALIZATION && defined(ENABLE_ADAPTIVE_STATIC_PYTHON)
-                if (adaptive_enabled) {
-                    if (_PyClassLoader_IsImmutable(container)) {
-                        _PyFrame_SetStackPointer(frame, stack_pointer);
-                        specialize_with_value(
-                                  next_instr, func, INVOKE_FUNCTION_CACHED, 0, 0);
-                        stack_pointer = _PyFrame_GetStackPointer(frame);
-                    } else {
-                        _PyFrame_SetStackPointer(frame, stack_pointer);
-                        PyObject** funcptr = _PyClassLoader_ResolveIndirectPtr(target);
-                        stack_pointer = _PyFrame_GetStackPointer(frame);
-                        PyObject*** cache = (PyObject***)next_instr;
-                        *cache = funcptr;
-                        _PyFrame_SetStackPointer(frame, stack_pointer);
-                        _Ci_specialize(next_instr, INVOKE_INDIRECT_CACHED);
-                        stack_pointer = _PyFrame_GetStackPointer(frame);
-                    }
-                }
-                #endif
                 _PyFrame_SetStackPointer(frame, stack_pointer);
                 Py_DECREF(func);
-                Py_DECREF(container);
+                Py_XDECREF(container);
                 stack_pointer = _PyFrame_GetStackPointer(frame);
                 stack_pointer += -(oparg >> 2) + (oparg & 0x03);
                 ASSERT_WITHIN_STACK_BOUNDS(__FILE__, __LINE__);
@@ -6837,7 +6780,7 @@
                 int optional;
                 int exact;
                 _PyFrame_SetStackPointer(frame, stack_pointer);
-                PyTypeObject* type = _PyClassLoader_ResolveType(
+                PyTypeObject* type = Ci_StaticCache_ResolveType(STATIC_CACHE_SLOT(),
                     GETITEM(FRAME_CO_CONSTS, extoparg), &optional, &exact);
                 stack_pointer = _PyFrame_GetStackPointer(frame);
                 assert(!optional);
@@ -6856,13 +6799,6 @@
                 _PyFrame_SetStackPointer(frame, stack_pointer);
                 PyObject* inst = type->tp_alloc(type, 0);
                 stack_pointer = _PyFrame_GetStackPointer(frame);
-                #if ENABLE_SPECIALIZATION && defined(ENABLE_ADAPTIVE_STATIC_PYTHON)
-                if (adaptive_enabled) {
-                    _PyFrame_SetStackPointer(frame, stack_pointer);
-                    specialize_with_value(next_instr, func, TP_ALLOC_CACHED, 0, 0);
-                    stack_pointer = _PyFrame_GetStackPointer(frame);
-                }
-                #endif
                 _PyFrame_SetStackPointer(frame, stack_pointer);
                 Py_DECREF(type);
                 stack_pointer = _PyFrame_GetStackPointer(frame);
@@ -6884,7 +6820,7 @@
                 int optional;
                 int exact;
                 _PyFrame_SetStackPointer(frame, stack_pointer);
-                PyTypeObject* type = _PyClassLoader_ResolveType(
+                PyTypeObject* type = Ci_StaticCache_ResolveType(STATIC_CACHE_SLOT(),
                     GETITEM(FRAME_CO_CONSTS, extoparg), &optional, &exact);
                 stack_pointer = _PyFrame_GetStackPointer(frame);
                 if (type == NULL) {
@@ -6899,18 +6835,6 @@
                     ASSERT_WITHIN_STACK_BOUNDS(__FILE__, __LINE__);
                     JUMP_TO_LABEL(error);
                 }
-                #if ENABLE_SPECIALIZATION && defined(ENABLE_ADAPTIVE_STATIC_PYTHON)
-                if (adaptive_enabled) {
-                    _PyFrame_SetStackPointer(frame, stack_pointer);
-                    specialize_with_value(
-                                next_instr,
-                                (PyObject*)type,
-                                CAST_CACHED,
-                                2,
-                                (exact << 1) | optional);
-                    stack_pointer = _PyFrame_GetStackPointer(frame);
-                }
-                #endif
                 _PyStackRef res;
                 if (!_PyObject_TypeCheckOptional(val, type, optional, exact)) {
                     if (type == &PyFloat_Type && PyObject_TypeCheck(val, &PyLong_Type)) {
@@ -6998,7 +6922,7 @@
                 top[0] = PyStackRef_FromPyObjectSteal(res);
             } else if (extop == PRIMITIVE_BINARY_OP) {
                 _PyFrame_SetStackPointer(frame, stack_pointer);
-                PyObject* res = primitive_binary_op(
+                PyObject* res = Ci_PrimitiveBinaryOp(
                     PyStackRef_AsPyObjectBorrow(args[0]),
                     PyStackRef_AsPyObjectBorrow(args[1]),
                     extoparg);
@@ -7018,7 +6942,7 @@
                 top[0] = PyStackRef_FromPyObjectSteal(res);
             } else if (extop == PRIMITIVE_COMPARE_OP) {
                 _PyFrame_SetStackPointer(frame, stack_pointer);
-                PyObject* res = primitive_compare_op(
+                PyObject* res = Ci_PrimitiveCompareOp(
                     PyStackRef_AsPyObjectBorrow(args[0]),
                     PyStackRef_AsPyObjectBorrow(args[1]),
                     extoparg);
@@ -7043,7 +6967,7 @@
                 int field_type;
                 _PyFrame_SetStackPointer(frame, stack_pointer);
                 Py_ssize_t offset =
-                _PyClassLoader_ResolveFieldOffset(field, &field_type);
+                Ci_StaticCache_ResolveFieldOffset(STATIC_CACHE_SLOT(), field, &field_type);
                 stack_pointer = _PyFrame_GetStackPointer(frame);
                 if (offset == -1) {
                     stack_pointer += -(oparg >> 2) + (oparg & 0x03);
@@ -7059,17 +6983,6 @@
                 }
                 if (field_type == TYPED_OBJECT) {
                     value = *FIELD_OFFSET(self, offset);
-                    #if ENABLE_SPECIALIZATION && defined(ENABLE_ADAPTIVE_STATIC_PYTHON)
-                    if (adaptive_enabled) {
-                        if (offset < INT32_MAX) {
-                            int32_t* cache = (int32_t*)next_instr;
-                            *cache = offset;
-                            _PyFrame_SetStackPointer(frame, stack_pointer);
-                            _Ci_specialize(next_instr, LOAD_OBJ_FIELD);
-                            stack_pointer = _PyFrame_GetStackPointer(frame);
-                        }
-                    }
-                    #endif
 
                     if (value == NULL) {
                         PyObject* name =
@@ -7094,18 +7007,6 @@
                     }
                     Py_INCREF(value);
                 } else {
-                    #if ENABLE_SPECIALIZATION && defined(ENABLE_ADAPTIVE_STATIC_PYTHON)
-                    if (adaptive_enabled) {
-                        if (offset <= INT32_MAX >> 8) {
-                            assert(field_type < 0xff);
-                            int32_t* cache = (int32_t*)next_instr;
-                            *cache = offset << 8 | field_type;
-                            _PyFrame_SetStackPointer(frame, stack_pointer);
-                            _Ci_specialize(next_instr, LOAD_PRIMITIVE_FIELD);
-                            stack_pointer = _PyFrame_GetStackPointer(frame);
-                        }
-                    }
-                    #endif
                     _PyFrame_SetStackPointer(frame, stack_pointer);
                     value = load_field(field_type, (char*)FIELD_OFFSET(self, offset));
                     stack_pointer = _PyFrame_GetStackPointer(frame);
@@ -7137,7 +7038,7 @@
                 int field_type;
                 _PyFrame_SetStackPointer(frame, stack_pointer);
                 Py_ssize_t offset =
-                _PyClassLoader_ResolveFieldOffset(field, &field_type);
+                Ci_StaticCache_ResolveFieldOffset(STATIC_CACHE_SLOT(), field, &field_type);
                 stack_pointer = _PyFrame_GetStackPointer(frame);
                 if (offset == -1) {
                     stack_pointer += -(oparg >> 2) + (oparg & 0x03);
@@ -7158,30 +7059,7 @@
                     Py_XDECREF(*addr);
                     stack_pointer = _PyFrame_GetStackPointer(frame);
                     *addr = value;
-                    #if ENABLE_SPECIALIZATION && defined(ENABLE_ADAPTIVE_STATIC_PYTHON)
-                    if (adaptive_enabled) {
-                        if (offset <= INT32_MAX) {
-                            int32_t* cache = (int32_t*)next_instr;
-                            *cache = offset;
-                            _PyFrame_SetStackPointer(frame, stack_pointer);
-                            _Ci_specialize(next_instr, STORE_OBJ_FIELD);
-                            stack_pointer = _PyFrame_GetStackPointer(frame);
-                        }
-                    }
-                    #endif
                 } else {
-                    #if ENABLE_SPECIALIZATION && defined(ENABLE_ADAPTIVE_STATIC_PYTHON)
-                    if (adaptive_enabled) {
-                        if (offset <= INT32_MAX >> 8) {
-                            assert(field_type < 0xff);
-                            int32_t* cache = (int32_t*)next_instr;
-                            *cache = offset << 8 | field_type;
-                            _PyFrame_SetStackPointer(frame, stack_pointer);
-                            _Ci_specialize(next_instr, STORE_PRIMITIVE_FIELD);
-                            stack_pointer = _PyFrame_GetStackPointer(frame);
-                        }
-                    }
-                    #endif
                     _PyFrame_SetStackPointer(frame, stack_pointer);
                     store_field(field_type, (char*)addr, value);
                     stack_pointer = _PyFrame_GetStackPointer(frame);
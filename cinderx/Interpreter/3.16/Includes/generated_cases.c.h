@@ -6246,7 +6246,7 @@
                 assert(stack_pointer == _PyFrame_GetStackPointer(frame));
                 _PyFrame_StackPointerValidate(frame);
                 int type =
-                _PyClassLoader_ResolvePrimitiveType(PyTuple_GET_ITEM(local, 1));
+                Ci_StaticCache_ResolvePrimitiveType(STATIC_CACHE_SLOT(), PyTuple_GET_ITEM(local, 1));
                 _PyFrame_StackPointerInvalidate(frame);
                 if (type < 0) {
                     stack_pointer += -(oparg >> 2) + (oparg & 0x03);
@@ -6280,18 +6280,6 @@
                 _PyFrame_StackPointerValidate(frame);
                 PyStackRef_XCLOSE(tmp);
                 _PyFrame_StackPointerInvalidate(frame);
-                #if ENABLE_SPECIALIZATION && defined(ENABLE_ADAPTIVE_STATIC_PYTHON)
-                if (adaptive_enabled) {
-                    if (index < INT8_MAX && type < INT8_MAX) {
-                        int16_t* cache = (int16_t*)next_instr;
-                        *cache = (index << 8) | type;
-                        assert(stack_pointer == _PyFrame_GetStackPointer(frame));
-                        _PyFrame_StackPointerValidate(frame);
-                        _Ci_specialize(next_instr, STORE_LOCAL_CACHED);
-                        _PyFrame_StackPointerInvalidate(frame);
-                    }
-                }
-                #endif
                 stack_pointer += -(oparg >> 2) + (oparg & 0x03);
                 ASSERT_WITHIN_STACK_BOUNDS(__FILE__, __LINE__);
                 _PyFrame_SetStackPointer(frame, stack_pointer);
@@ -6455,7 +6443,7 @@
                         ASSERT_WITHIN_STACK_BOUNDS(__FILE__, __LINE__);
                         JUMP_TO_LABEL(error);
                     }
-                } else if (extoparg == SEQ_ARRAY_INT64) {
+                } else if (SEQ_IS_ARRAY(extoparg)) {
                     assert(stack_pointer == _PyFrame_GetStackPointer(frame));
                     _PyFrame_StackPointerValidate(frame);
                     item = _Ci_StaticArray_Get(sequence, val);
@@ -6593,7 +6581,7 @@
                             JUMP_TO_LABEL(error);
                         }
                     }
-                } else if (extoparg == SEQ_ARRAY_INT64) {
+                } else if (SEQ_IS_ARRAY(extoparg)) {
                     assert(stack_pointer == _PyFrame_GetStackPointer(frame));
                     _PyFrame_StackPointerValidate(frame);
                     err = _Ci_StaticArray_Set(sequence, idx, v);
@@ -6649,7 +6637,7 @@
                         (extoparg == FAST_LEN_SET && PyAnySet_CheckExact(collection)) ||
                         (extoparg == FAST_LEN_TUPLE && PyTuple_CheckExact(collection)) ||
                         (extoparg == FAST_LEN_ARRAY &&
-                            PyStaticArray_CheckExact(collection)) ||
+                            PyStaticArray_Check(collection)) ||
                         (extoparg == FAST_LEN_STR && PyUnicode_CheckExact(collection))) {
                         inexact = 0;
                     }
@@ -6676,7 +6664,7 @@
                 } else {
                     assert(
                         PyTuple_Check(collection) || PyList_Check(collection) ||
-                        PyStaticArray_CheckExact(collection) ||
+                        PyStaticArray_Check(collection) ||
                         PyUnicode_Check(collection) || Ci_CheckedList_Check(collection));
                     length = PyLong_FromLong(Py_SIZE(collection));
                 }
@@ -6776,18 +6764,9 @@
                 _PyFrame_SetStackPointer(frame, stack_pointer);
                 _PyFrame_StackPointerValidate(frame);
                 PyTypeObject* type =
-                _PyClassLoader_ResolveType(list_type, &optional, &exact);
+                Ci_StaticCache_ResolveType(STATIC_CACHE_SLOT(), list_type, &optional, &exact);
                 _PyFrame_StackPointerInvalidate(frame);
                 assert(!optional);
-                #if ENABLE_SPECIALIZATION && defined(ENABLE_ADAPTIVE_STATIC_PYTHON)
-                if (adaptive_enabled) {
-                    assert(stack_pointer == _PyFrame_GetStackPointer(frame));
-                    _PyFrame_StackPointerValidate(frame);
-                    specialize_with_value(
-                                next_instr, (PyObject*)type, BUILD_CHECKED_LIST_CACHED, 0, 0);
-                    _PyFrame_StackPointerInvalidate(frame);
-                }
-                #endif
                 assert(stack_pointer == _PyFrame_GetStackPointer(frame));
                 _PyFrame_StackPointerValidate(frame);
                 list = Ci_CheckedList_New(type, list_size);
@@ -6834,7 +6813,7 @@
                 _PyFrame_SetStackPointer(frame, stack_pointer);
                 _PyFrame_StackPointerValidate(frame);
                 PyTypeObject* type =
-                _PyClassLoader_ResolveType(map_type, &optional, &exact);
+                Ci_StaticCache_ResolveType(STATIC_CACHE_SLOT(), map_type, &optional, &exact);
                 _PyFrame_StackPointerInvalidate(frame);
                 if (type == NULL) {
                     stack_pointer += -(oparg >> 2) + (oparg & 0x03);
@@ -6850,15 +6829,6 @@
                     JUMP_TO_LABEL(error);
                 }
                 assert(!optional);
-                #if ENABLE_SPECIALIZATION && defined(ENABLE_ADAPTIVE_STATIC_PYTHON)
-                if (adaptive_enabled) {
-                    assert(stack_pointer == _PyFrame_GetStackPointer(frame));
-                    _PyFrame_StackPointerValidate(frame);
-                    specialize_with_value(
-                                next_instr, (PyObject*)type, BUILD_CHECKED_MAP_CACHED, 0, 0);
-                    _PyFrame_StackPointerInvalidate(frame);
-                }
-                #endif
                 assert(stack_pointer == _PyFrame_GetStackPointer(frame));
                 _PyFrame_StackPointerValidate(frame);
                 PyObject* map = Ci_CheckedDict_NewPresized(type, map_size);
@@ -6916,7 +6886,7 @@
                 _PyFrame_StackPointerInvalidate(frame);
                 assert(stack_pointer == _PyFrame_GetStackPointer(frame));
                 _PyFrame_StackPointerValidate(frame);
-                Py_ssize_t slot = _PyClassLoader_ResolveMethod(target);
+                Py_ssize_t slot = Ci_StaticCache_ResolveMethod(STATIC_CACHE_SLOT(), target);
                 _PyFrame_StackPointerInvalidate(frame);
                 if (slot == -1) {
                     stack_pointer += -(oparg >> 2) + (oparg & 0x03);
@@ -6931,21 +6901,6 @@
                     ASSERT_WITHIN_STACK_BOUNDS(__FILE__, __LINE__);
                     JUMP_TO_LABEL(error);
                 }
-                #if ENABLE_SPECIALIZATION && defined(ENABLE_ADAPTIVE_STATIC_PYTHON)
-                if (adaptive_enabled) {
-                    if (slot < (INT32_MAX >> 1)) {
-                        int32_t* cache = (int32_t*)next_instr;
-                        assert(stack_pointer == _PyFrame_GetStackPointer(frame));
-                        _PyFrame_StackPointerValidate(frame);
-                        *cache = load_method_static_cached_oparg(slot, is_classmethod);
-                        _PyFrame_StackPointerInvalidate(frame);
-                        assert(stack_pointer == _PyFrame_GetStackPointer(frame));
-                        _PyFrame_StackPointerValidate(frame);
-                        _Ci_specialize(next_instr, LOAD_METHOD_STATIC_CACHED);
-                        _PyFrame_StackPointerInvalidate(frame);
-                    }
-                }
-                #endif
 
                 _PyType_VTable* vtable;
                 if (is_classmethod) {
@@ -7033,7 +6988,7 @@
                 PyObject* container;
                 _PyFrame_SetStackPointer(frame, stack_pointer);
                 _PyFrame_StackPointerValidate(frame);
-                PyObject* func = _PyClassLoader_ResolveFunction(target, &container);
+                PyObject* func = Ci_StaticCache_ResolveFunction(STATIC_CACHE_SLOT(), target, &container);
                 _PyFrame_StackPointerInvalidate(frame);
                 if (func == NULL) {
                     stack_pointer += -(oparg >> 2) + (oparg & 0x03);
@@ -7067,35 +7022,13 @@
                 PyObject* res = _PyObject_Vectorcall(func, args_o, nargs, NULL);
                 _PyFrame_StackPointerInvalidate(frame);
                 STACKREFS_TO_PYOBJECTS_CLEANUP(args_o);
-                #if ENABLE_SPECIALIZATION && defined(ENABLE_ADAPTIVE_STATIC_PYTHON)
-                if (adaptive_enabled) {
-                    if (_PyClassLoader_IsImmutable(container)) {
-                        assert(stack_pointer == _PyFrame_GetStackPointer(frame));
-                        _PyFrame_StackPointerValidate(frame);
-                        specialize_with_value(
-                                  next_instr, func, INVOKE_FUNCTION_CACHED, 0, 0);
-                        _PyFrame_StackPointerInvalidate(frame);
-                    } else {
-                        assert(stack_pointer == _PyFrame_GetStackPointer(frame));
-                        _PyFrame_StackPointerValidate(frame);
-                        PyObject** funcptr = _PyClassLoader_ResolveIndirectPtr(target);
-                        _PyFrame_StackPointerInvalidate(frame);
-                        PyObject*** cache = (PyObject***)next_instr;
-                        *cache = funcptr;
-                        assert(stack_pointer == _PyFrame_GetStackPointer(frame));
-                        _PyFrame_StackPointerValidate(frame);
-                        _Ci_specialize(next_instr, INVOKE_INDIRECT_CACHED);
-                        _PyFrame_StackPointerInvalidate(frame);
-                    }
-                }
-                #endif
                 assert(stack_pointer == _PyFrame_GetStackPointer(frame));
                 _PyFrame_StackPointerValidate(frame);
                 Py_DECREF(func);
                 _PyFrame_StackPointerInvalidate(frame);
                 assert(stack_pointer == _PyFrame_GetStackPointer(frame));
                 _PyFrame_StackPointerValidate(frame);
-                Py_DECREF(container);
+                Py_XDECREF(container);
                 _PyFrame_StackPointerInvalidate(frame);
                 stack_pointer += -(oparg >> 2) + (oparg & 0x03);
                 ASSERT_WITHIN_STACK_BOUNDS(__FILE__, __LINE__);
@@ -7158,7 +7091,7 @@
                 int exact;
                 _PyFrame_SetStackPointer(frame, stack_pointer);
                 _PyFrame_StackPointerValidate(frame);
-                PyTypeObject* type = _PyClassLoader_ResolveType(
+                PyTypeObject* type = Ci_StaticCache_ResolveType(STATIC_CACHE_SLOT(),
                     GETITEM(FRAME_CO_CONSTS, extoparg), &optional, &exact);
                 _PyFrame_StackPointerInvalidate(frame);
                 assert(!optional);
@@ -7179,14 +7112,6 @@
                 _PyFrame_StackPointerValidate(frame);
                 PyObject* inst = type->tp_alloc(type, 0);
                 _PyFrame_StackPointerInvalidate(frame);
-                #if ENABLE_SPECIALIZATION && defined(ENABLE_ADAPTIVE_STATIC_PYTHON)
-                if (adaptive_enabled) {
-                    assert(stack_pointer == _PyFrame_GetStackPointer(frame));
-                    _PyFrame_StackPointerValidate(frame);
-                    specialize_with_value(next_instr, func, TP_ALLOC_CACHED, 0, 0);
-                    _PyFrame_StackPointerInvalidate(frame);
-                }
-                #endif
                 assert(stack_pointer == _PyFrame_GetStackPointer(frame));
                 _PyFrame_StackPointerValidate(frame);
                 Py_DECREF(type);
@@ -7211,7 +7136,7 @@
                 int exact;
                 _PyFrame_SetStackPointer(frame, stack_pointer);
                 _PyFrame_StackPointerValidate(frame);
-                PyTypeObject* type = _PyClassLoader_ResolveType(
+                PyTypeObject* type = Ci_StaticCache_ResolveType(STATIC_CACHE_SLOT(),
                     GETITEM(FRAME_CO_CONSTS, extoparg), &optional, &exact);
                 _PyFrame_StackPointerInvalidate(frame);
                 if (type == NULL) {
@@ -7227,19 +7152,6 @@
                     ASSERT_WITHIN_STACK_BOUNDS(__FILE__, __LINE__);
                     JUMP_TO_LABEL(error);
                 }
-                #if ENABLE_SPECIALIZATION && defined(ENABLE_ADAPTIVE_STATIC_PYTHON)
-                if (adaptive_enabled) {
-                    assert(stack_pointer == _PyFrame_GetStackPointer(frame));
-                    _PyFrame_StackPointerValidate(frame);
-                    specialize_with_value(
-                                next_instr,
-                                (PyObject*)type,
-                                CAST_CACHED,
-                                2,
-                                (exact << 1) | optional);
-                    _PyFrame_StackPointerInvalidate(frame);
-                }
-                #endif
                 _PyStackRef res;
                 if (!_PyObject_TypeCheckOptional(val, type, optional, exact)) {
                     if (type == &PyFloat_Type && PyObject_TypeCheck(val, &PyLong_Type)) {
@@ -7340,7 +7252,7 @@
             } else if (extop == PRIMITIVE_BINARY_OP) {
                 _PyFrame_SetStackPointer(frame, stack_pointer);
                 _PyFrame_StackPointerValidate(frame);
-                PyObject* res = primitive_binary_op(
+                PyObject* res = Ci_PrimitiveBinaryOp(
                     PyStackRef_AsPyObjectBorrow(args[0]),
                     PyStackRef_AsPyObjectBorrow(args[1]),
                     extoparg);
@@ -7362,7 +7274,7 @@
             } else if (extop == PRIMITIVE_COMPARE_OP) {
                 _PyFrame_SetStackPointer(frame, stack_pointer);
                 _PyFrame_StackPointerValidate(frame);
-                PyObject* res = primitive_compare_op(
+                PyObject* res = Ci_PrimitiveCompareOp(
                     PyStackRef_AsPyObjectBorrow(args[0]),
                     PyStackRef_AsPyObjectBorrow(args[1]),
                     extoparg);
@@ -7389,7 +7301,7 @@
                 _PyFrame_SetStackPointer(frame, stack_pointer);
                 _PyFrame_StackPointerValidate(frame);
                 Py_ssize_t offset =
-                _PyClassLoader_ResolveFieldOffset(field, &field_type);
+                Ci_StaticCache_ResolveFieldOffset(STATIC_CACHE_SLOT(), field, &field_type);
                 _PyFrame_StackPointerInvalidate(frame);
                 if (offset == -1) {
                     stack_pointer += -(oparg >> 2) + (oparg & 0x03);
@@ -7406,18 +7318,6 @@
                 }
                 if (field_type == TYPED_OBJECT) {
                     value = *FIELD_OFFSET(self, offset);
-                    #if ENABLE_SPECIALIZATION && defined(ENABLE_ADAPTIVE_STATIC_PYTHON)
-                    if (adaptive_enabled) {
-                        if (offset < INT32_MAX) {
-                            int32_t* cache = (int32_t*)next_instr;
-                            *cache = offset;
-                            assert(stack_pointer == _PyFrame_GetStackPointer(frame));
-                            _PyFrame_StackPointerValidate(frame);
-                            _Ci_specialize(next_instr, LOAD_OBJ_FIELD);
-                            _PyFrame_StackPointerInvalidate(frame);
-                        }
-                    }
-                    #endif
 
                     if (value == NULL) {
                         PyObject* name =
@@ -7444,19 +7344,6 @@
                     }
                     Py_INCREF(value);
                 } else {
-                    #if ENABLE_SPECIALIZATION && defined(ENABLE_ADAPTIVE_STATIC_PYTHON)
-                    if (adaptive_enabled) {
-                        if (offset <= INT32_MAX >> 8) {
-                            assert(field_type < 0xff);
-                            int32_t* cache = (int32_t*)next_instr;
-                            *cache = offset << 8 | field_type;
-                            assert(stack_pointer == _PyFrame_GetStackPointer(frame));
-                            _PyFrame_StackPointerValidate(frame);
-                            _Ci_specialize(next_instr, LOAD_PRIMITIVE_FIELD);
-                            _PyFrame_StackPointerInvalidate(frame);
-                        }
-                    }
-                    #endif
                     assert(stack_pointer == _PyFrame_GetStackPointer(frame));
                     _PyFrame_StackPointerValidate(frame);
                     value = load_field(field_type, (char*)FIELD_OFFSET(self, offset));
@@ -7492,7 +7379,7 @@
                 _PyFrame_SetStackPointer(frame, stack_pointer);
                 _PyFrame_StackPointerValidate(frame);
                 Py_ssize_t offset =
-                _PyClassLoader_ResolveFieldOffset(field, &field_type);
+                Ci_StaticCache_ResolveFieldOffset(STATIC_CACHE_SLOT(), field, &field_type);
                 _PyFrame_StackPointerInvalidate(frame);
                 if (offset == -1) {
                     stack_pointer += -(oparg >> 2) + (oparg & 0x03);
@@ -7515,32 +7402,7 @@
                     Py_XDECREF(*addr);
                     _PyFrame_StackPointerInvalidate(frame);
                     *addr = value;
-                    #if ENABLE_SPECIALIZATION && defined(ENABLE_ADAPTIVE_STATIC_PYTHON)
-                    if (adaptive_enabled) {
-                        if (offset <= INT32_MAX) {
-                            int32_t* cache = (int32_t*)next_instr;
-                            *cache = offset;
-                            assert(stack_pointer == _PyFrame_GetStackPointer(frame));
-                            _PyFrame_StackPointerValidate(frame);
-                            _Ci_specialize(next_instr, STORE_OBJ_FIELD);
-                            _PyFrame_StackPointerInvalidate(frame);
-                        }
-                    }
-                    #endif
                 } else {
-                    #if ENABLE_SPECIALIZATION && defined(ENABLE_ADAPTIVE_STATIC_PYTHON)
-                    if (adaptive_enabled) {
-                        if (offset <= INT32_MAX >> 8) {
-                            assert(field_type < 0xff);
-                            int32_t* cache = (int32_t*)next_instr;
-                            *cache = offset << 8 | field_type;
-                            assert(stack_pointer == _PyFrame_GetStackPointer(frame));
-                            _PyFrame_StackPointerValidate(frame);
-                            _Ci_specialize(next_instr, STORE_PRIMITIVE_FIELD);
-                            _PyFrame_StackPointerInvalidate(frame);
-                        }
-                    }
-                    #endif
                     assert(stack_pointer == _PyFrame_GetStackPointer(frame));
                     _PyFrame_StackPointerValidate(frame);
                     store_field(field_type, (char*)addr, value);
@@ -210,8 +210,8 @@ pop_1_error:
         _PyStackRef val = args[0];
         PyObject* local = GETITEM(FRAME_CO_CONSTS, extoparg);
         int index = PyLong_AsInt(PyTuple_GET_ITEM(local, 0));
-        int type =
-            _PyClassLoader_ResolvePrimitiveType(PyTuple_GET_ITEM(local, 1));
+        int type = Ci_StaticCache_ResolvePrimitiveType(
+            STATIC_CACHE_SLOT(), PyTuple_GET_ITEM(local, 1));
 
         if (type < 0) {
           DECREF_INPUTS();
@@ -230,15 +230,6 @@ pop_1_error:
 
         PyStackRef_XCLOSE(tmp);
 
-#if ENABLE_SPECIALIZATION && defined(ENABLE_ADAPTIVE_STATIC_PYTHON)
-        if (adaptive_enabled) {
-          if (index < INT8_MAX && type < INT8_MAX) {
-            int16_t* cache = (int16_t*)next_instr;
-            *cache = (index << 8) | type;
-            _Ci_specialize(next_instr, STORE_LOCAL_CACHED);
-          }
-        }
-#endif
         DECREF_INPUTS();
       } else if (extop == LOAD_LOCAL) {
         int index = PyLong_AsInt(
@@ -319,7 +310,7 @@ pop_1_error:
             DECREF_INPUTS();
             ERROR_IF(true);
           }
-        } else if (extoparg == SEQ_ARRAY_INT64) {
+        } else if (SEQ_IS_ARRAY(extoparg)) {
           item = _Ci_StaticArray_Get(sequence, val);
           if (item == NULL) {
             DECREF_INPUTS();
@@ -380,7 +371,7 @@ pop_1_error:
               ERROR_IF(true);
             }
           }
-        } else if (extoparg == SEQ_ARRAY_INT64) {
+        } else if (SEQ_IS_ARRAY(extoparg)) {
           err = _Ci_StaticArray_Set(sequence, idx, v);
 
           if (err != 0) {
@@ -408,7 +399,7 @@ pop_1_error:
               (extoparg == FAST_LEN_SET && PyAnySet_CheckExact(collection)) ||
               (extoparg == FAST_LEN_TUPLE && PyTuple_CheckExact(collection)) ||
               (extoparg == FAST_LEN_ARRAY &&
-               PyStaticArray_CheckExact(collection)) ||
+               PyStaticArray_Check(collection)) ||
               (extoparg == FAST_LEN_STR && PyUnicode_CheckExact(collection))) {
             inexact = 0;
           }
@@ -430,7 +421,7 @@ pop_1_error:
           // lists, tuples, arrays are all PyVarObject and use ob_size
           assert(
               PyTuple_Check(collection) || PyList_Check(collection) ||
-              PyStaticArray_CheckExact(collection) ||
+              PyStaticArray_Check(collection) ||
               PyUnicode_Check(collection) || Ci_CheckedList_Check(collection));
           length = PyLong_FromLong(Py_SIZE(collection));
         }
@@ -477,16 +468,10 @@ pop_1_error:
 
         int optional;
         int exact;
-        PyTypeObject* type =
-            _PyClassLoader_ResolveType(list_type, &optional, &exact);
+        PyTypeObject* type = Ci_StaticCache_ResolveType(
+            STATIC_CACHE_SLOT(), list_type, &optional, &exact);
         assert(!optional);
 
-#if ENABLE_SPECIALIZATION && defined(ENABLE_ADAPTIVE_STATIC_PYTHON)
-        if (adaptive_enabled) {
-          specialize_with_value(
-              next_instr, (PyObject*)type, BUILD_CHECKED_LIST_CACHED, 0, 0);
-        }
-#endif
 
         list = Ci_CheckedList_New(type, list_size);
         Py_DECREF(type);
@@ -509,20 +494,14 @@ pop_1_error:
 
         int optional;
         int exact;
-        PyTypeObject* type =
-            _PyClassLoader_ResolveType(map_type, &optional, &exact);
+        PyTypeObject* type = Ci_StaticCache_ResolveType(
+            STATIC_CACHE_SLOT(), map_type, &optional, &exact);
         if (type == NULL) {
           DECREF_INPUTS();
           ERROR_IF(true);
         }
         assert(!optional);
 
-#if ENABLE_SPECIALIZATION && defined(ENABLE_ADAPTIVE_STATIC_PYTHON)
-        if (adaptive_enabled) {
-          specialize_with_value(
-              next_instr, (PyObject*)type, BUILD_CHECKED_MAP_CACHED, 0, 0);
-        }
-#endif
 
         PyObject* map = Ci_CheckedDict_NewPresized(type, map_size);
         Py_DECREF(type);
@@ -544,27 +523,13 @@ pop_1_error:
         PyObject* target = PyTuple_GET_ITEM(value, 0);
         int is_classmethod = _PyClassLoader_IsClassMethodDescr(value);
 
-        Py_ssize_t slot = _PyClassLoader_ResolveMethod(target);
+        Py_ssize_t slot =
+            Ci_StaticCache_ResolveMethod(STATIC_CACHE_SLOT(), target);
         if (slot == -1) {
           DECREF_INPUTS();
           ERROR_IF(true);
         }
 
-#if ENABLE_SPECIALIZATION && defined(ENABLE_ADAPTIVE_STATIC_PYTHON)
-        if (adaptive_enabled) {
-          // We encode class method as the low bit hence the >> 1.
-          if (slot < (INT32_MAX >> 1)) {
-            /* We smuggle in the information about whether the invocation was a
-             * classmethod in the low bit of the oparg. This is necessary, as
-             * without, the runtime won't be able to get the correct vtable from
-             * self when the type is passed in.
-             */
-            int32_t* cache = (int32_t*)next_instr;
-            *cache = load_method_static_cached_oparg(slot, is_classmethod);
-            _Ci_specialize(next_instr, LOAD_METHOD_STATIC_CACHED);
-          }
-        }
-#endif
 
         _PyType_VTable* vtable;
         if (is_classmethod) {
@@ -609,7 +574,8 @@ pop_1_error:
         int nargs = oparg >> 2;
         PyObject* target = PyTuple_GET_ITEM(value, 0);
         PyObject* container;
-        PyObject* func = _PyClassLoader_ResolveFunction(target, &container);
+        PyObject* func = Ci_StaticCache_ResolveFunction(
+            STATIC_CACHE_SLOT(), target, &container);
         if (func == NULL) {
           DECREF_INPUTS();
           ERROR_IF(true);
@@ -622,22 +588,8 @@ pop_1_error:
         }
         PyObject* res = _PyObject_Vectorcall(func, args_o, nargs, NULL);
         STACKREFS_TO_PYOBJECTS_CLEANUP(args_o);
-#if ENABLE_SPECIALIZATION && defined(ENABLE_ADAPTIVE_STATIC_PYTHON)
-        if (adaptive_enabled) {
-          if (_PyClassLoader_IsImmutable(container)) {
-            /* frozen type, we don't need to worry about indirecting */
-            specialize_with_value(
-                next_instr, func, INVOKE_FUNCTION_CACHED, 0, 0);
-          } else {
-            PyObject** funcptr = _PyClassLoader_ResolveIndirectPtr(target);
-            PyObject*** cache = (PyObject***)next_instr;
-            *cache = funcptr;
-            _Ci_specialize(next_instr, INVOKE_INDIRECT_CACHED);
-          }
-        }
-#endif
         Py_DECREF(func);
-        Py_DECREF(container);
+        Py_XDECREF(container);
         DECREF_INPUTS();
         ERROR_IF(res == NULL);
         top[0] = PyStackRef_FromPyObjectSteal(res);
@@ -666,8 +618,11 @@ pop_1_error:
       } else if (extop == TP_ALLOC) {
         int optional;
         int exact;
-        PyTypeObject* type = _PyClassLoader_ResolveType(
-            GETITEM(FRAME_CO_CONSTS, extoparg), &optional, &exact);
+        PyTypeObject* type = Ci_StaticCache_ResolveType(
+            STATIC_CACHE_SLOT(),
+            GETITEM(FRAME_CO_CONSTS, extoparg),
+            &optional,
+            &exact);
         assert(!optional);
         if (type == NULL) {
           DECREF_INPUTS();
@@ -676,11 +631,6 @@ pop_1_error:
 
         PyObject* inst = type->tp_alloc(type, 0);
 
-#if ENABLE_SPECIALIZATION && defined(ENABLE_ADAPTIVE_STATIC_PYTHON)
-        if (adaptive_enabled) {
-          specialize_with_value(next_instr, func, TP_ALLOC_CACHED, 0, 0);
-        }
-#endif
         Py_DECREF(type);
         DECREF_INPUTS();
         ERROR_IF(inst == NULL);
@@ -689,22 +639,15 @@ pop_1_error:
         PyObject* val = PyStackRef_AsPyObjectBorrow(args[0]);
         int optional;
         int exact;
-        PyTypeObject* type = _PyClassLoader_ResolveType(
-            GETITEM(FRAME_CO_CONSTS, extoparg), &optional, &exact);
+        PyTypeObject* type = Ci_StaticCache_ResolveType(
+            STATIC_CACHE_SLOT(),
+            GETITEM(FRAME_CO_CONSTS, extoparg),
+            &optional,
+            &exact);
         if (type == NULL) {
           DECREF_INPUTS();
           ERROR_IF(true);
         }
-#if ENABLE_SPECIALIZATION && defined(ENABLE_ADAPTIVE_STATIC_PYTHON)
-        if (adaptive_enabled) {
-          specialize_with_value(
-              next_instr,
-              (PyObject*)type,
-              CAST_CACHED,
-              2,
-              (exact << 1) | optional);
-        }
-#endif
         _PyStackRef res;
         if (!_PyObject_TypeCheckOptional(val, type, optional, exact)) {
           if (type == &PyFloat_Type && PyObject_TypeCheck(val, &PyLong_Type)) {
@@ -744,7 +687,7 @@ pop_1_error:
         ERROR_IF(res == NULL);
         top[0] = PyStackRef_FromPyObjectSteal(res);
       } else if (extop == PRIMITIVE_BINARY_OP) {
-        PyObject* res = primitive_binary_op(
+        PyObject* res = Ci_PrimitiveBinaryOp(
             PyStackRef_AsPyObjectBorrow(args[0]),
             PyStackRef_AsPyObjectBorrow(args[1]),
             extoparg);
@@ -752,7 +695,7 @@ pop_1_error:
         ERROR_IF(res == NULL);
         top[0] = PyStackRef_FromPyObjectSteal(res);
       } else if (extop == PRIMITIVE_COMPARE_OP) {
-        PyObject* res = primitive_compare_op(
+        PyObject* res = Ci_PrimitiveCompareOp(
             PyStackRef_AsPyObjectBorrow(args[0]),
             PyStackRef_AsPyObjectBorrow(args[1]),
             extoparg);
@@ -764,8 +707,8 @@ pop_1_error:
         PyObject* field = GETITEM(FRAME_CO_CONSTS, extoparg);
         PyObject* value;
         int field_type;
-        Py_ssize_t offset =
-            _PyClassLoader_ResolveFieldOffset(field, &field_type);
+        Py_ssize_t offset = Ci_StaticCache_ResolveFieldOffset(
+            STATIC_CACHE_SLOT(), field, &field_type);
         if (offset == -1) {
           DECREF_INPUTS();
           ERROR_IF(true);
@@ -773,15 +716,6 @@ pop_1_error:
 
         if (field_type == TYPED_OBJECT) {
           value = *FIELD_OFFSET(self, offset);
-#if ENABLE_SPECIALIZATION && defined(ENABLE_ADAPTIVE_STATIC_PYTHON)
-          if (adaptive_enabled) {
-            if (offset < INT32_MAX) {
-              int32_t* cache = (int32_t*)next_instr;
-              *cache = offset;
-              _Ci_specialize(next_instr, LOAD_OBJ_FIELD);
-            }
-          }
-#endif
 
           if (value == NULL) {
             PyObject* name =
@@ -796,16 +730,6 @@ pop_1_error:
           }
           Py_INCREF(value);
         } else {
-#if ENABLE_SPECIALIZATION && defined(ENABLE_ADAPTIVE_STATIC_PYTHON)
-          if (adaptive_enabled) {
-            if (offset <= INT32_MAX >> 8) {
-              assert(field_type < 0xff);
-              int32_t* cache = (int32_t*)next_instr;
-              *cache = offset << 8 | field_type;
-              _Ci_specialize(next_instr, LOAD_PRIMITIVE_FIELD);
-            }
-          }
-#endif
 
           value = load_field(field_type, (char*)FIELD_OFFSET(self, offset));
           if (value == NULL) {
@@ -820,8 +744,8 @@ pop_1_error:
         PyObject* self = PyStackRef_AsPyObjectBorrow(args[1]);
         PyObject* field = GETITEM(FRAME_CO_CONSTS, extoparg);
         int field_type;
-        Py_ssize_t offset =
-            _PyClassLoader_ResolveFieldOffset(field, &field_type);
+        Py_ssize_t offset = Ci_StaticCache_ResolveFieldOffset(
+            STATIC_CACHE_SLOT(), field, &field_type);
         if (offset == -1) {
           DECREF_INPUTS();
           ERROR_IF(true);
@@ -833,26 +757,7 @@ pop_1_error:
           Py_INCREF(value);
           Py_XDECREF(*addr);
           *addr = value;
-#if ENABLE_SPECIALIZATION && defined(ENABLE_ADAPTIVE_STATIC_PYTHON)
-          if (adaptive_enabled) {
-            if (offset <= INT32_MAX) {
-              int32_t* cache = (int32_t*)next_instr;
-              *cache = offset;
-              _Ci_specialize(next_instr, STORE_OBJ_FIELD);
-            }
-          }
-#endif
         } else {
-#if ENABLE_SPECIALIZATION && defined(ENABLE_ADAPTIVE_STATIC_PYTHON)
-          if (adaptive_enabled) {
-            if (offset <= INT32_MAX >> 8) {
-              assert(field_type < 0xff);
-              int32_t* cache = (int32_t*)next_instr;
-              *cache = offset << 8 | field_type;
-              _Ci_specialize(next_instr, STORE_PRIMITIVE_FIELD);
-            }
-          }
-#endif
           store_field(field_type, (char*)addr, value);
         }
         DECREF_INPUTS();
@@ -0,0 +1,157 @@
+// Copyright (c) Meta Platforms, Inc. and affiliates.
+
+#include "cinderx/Interpreter/primitive_ops.h"
+
+#include <math.h>
+
+// Boxed primitive ints are almost always small enough to be compact, so read
+// them directly and only go through PyLong_AsVoidPtr for the rest.
+static inline size_t unbox_int(PyObject* val) {
+#if PY_VERSION_HEX >= 0x030C0000
+  if (PyLong_CheckExact(val) && _PyLong_IsCompact((PyLongObject*)val)) {
+    return (size_t)_PyLong_CompactValue((PyLongObject*)val);
+  }
+#endif
+  return (size_t)PyLong_AsVoidPtr(val);
+}
+
+static inline PyObject* box_int(size_t val) {
+  return PyLong_FromVoidPtr((void*)val);
+}
+
+PyObject* Ci_PrimitiveUnknownOp(
+    PyObject* Py_UNUSED(l),
+    PyObject* Py_UNUSED(r)) {
+  PyErr_SetString(PyExc_RuntimeError, "unknown op");
+  return NULL;
+}
+
+#define INT_BIN_OP_UNSIGNED(name, op)               \
+  static PyObject* name(PyObject* l, PyObject* r) { \
+    return box_int(unbox_int(l) op unbox_int(r));   \
+  }
+
+#define INT_BIN_OP_SIGNED(name, op)                 \
+  static PyObject* name(PyObject* l, PyObject* r) { \
+    Py_ssize_t left = (Py_ssize_t)unbox_int(l);     \
+    Py_ssize_t right = (Py_ssize_t)unbox_int(r);    \
+    return box_int((size_t)(left op right));        \
+  }
+
+#define DBL_BIN_OP(name, op)                                   \
+  static PyObject* name(PyObject* l, PyObject* r) {            \
+    double res = PyFloat_AS_DOUBLE(l) op PyFloat_AS_DOUBLE(r); \
+    return PyFloat_FromDouble(res);                            \
+  }
+
+INT_BIN_OP_UNSIGNED(add_int, +)
+INT_BIN_OP_UNSIGNED(sub_int, -)
+INT_BIN_OP_UNSIGNED(mul_int, *)
+INT_BIN_OP_SIGNED(div_int, /)
+INT_BIN_OP_UNSIGNED(div_un_int, /)
+INT_BIN_OP_SIGNED(mod_int, %)
+INT_BIN_OP_UNSIGNED(mod_un_int, %)
+INT_BIN_OP_SIGNED(lshift_int, <<)
+INT_BIN_OP_SIGNED(rshift_int, >>)
+INT_BIN_OP_UNSIGNED(rshift_un_int, >>)
+INT_BIN_OP_UNSIGNED(xor_int, ^)
+INT_BIN_OP_UNSIGNED(or_int, |)
+INT_BIN_OP_UNSIGNED(and_int, &)
+DBL_BIN_OP(add_dbl, +)
+DBL_BIN_OP(sub_dbl, -)
+DBL_BIN_OP(mul_dbl, *)
+DBL_BIN_OP(div_dbl, /)
+
+static PyObject* pow_int(PyObject* l, PyObject* r) {
+  return PyFloat_FromDouble(
+      pow((Py_ssize_t)unbox_int(l), (Py_ssize_t)unbox_int(r)));
+}
+
+static PyObject* pow_un_int(PyObject* l, PyObject* r) {
+  return PyFloat_FromDouble(pow(unbox_int(l), unbox_int(r)));
+}
+
+static PyObject* pow_dbl(PyObject* l, PyObject* r) {
+  return PyFloat_FromDouble(pow(PyFloat_AsDouble(l), PyFloat_AsDouble(r)));
+}
+
+const Ci_PrimitiveBinaryFunc Ci_PrimitiveBinaryOps[PRIM_OP_POW_UN_INT + 1] = {
+    [PRIM_OP_ADD_INT] = add_int,
+    [PRIM_OP_SUB_INT] = sub_int,
+    [PRIM_OP_MUL_INT] = mul_int,
+    [PRIM_OP_DIV_INT] = div_int,
+    [PRIM_OP_DIV_UN_INT] = div_un_int,
+    [PRIM_OP_MOD_INT] = mod_int,
+    [PRIM_OP_MOD_UN_INT] = mod_un_int,
+    [PRIM_OP_POW_INT] = pow_int,
+    [PRIM_OP_LSHIFT_INT] = lshift_int,
+    [PRIM_OP_RSHIFT_INT] = rshift_int,
+    [PRIM_OP_RSHIFT_UN_INT] = rshift_un_int,
+    [PRIM_OP_XOR_INT] = xor_int,
+    [PRIM_OP_OR_INT] = or_int,
+    [PRIM_OP_AND_INT] = and_int,
+    [PRIM_OP_ADD_DBL] = add_dbl,
+    [PRIM_OP_SUB_DBL] = sub_dbl,
+    [PRIM_OP_MUL_DBL] = mul_dbl,
+    [PRIM_OP_DIV_DBL] = div_dbl,
+    // The compiler never emits a primitive double modulo.
+    [PRIM_OP_MOD_DBL] = Ci_PrimitiveUnknownOp,
+    [PRIM_OP_POW_DBL] = pow_dbl,
+    [PRIM_OP_POW_UN_INT] = pow_un_int,
+};
+
+#define INT_CMP_OP_UNSIGNED(name, op)                       \
+  static PyObject* name(PyObject* l, PyObject* r) {         \
+    size_t right = unbox_int(r);                            \
+    size_t left = unbox_int(l);                             \
+    return Py_NewRef((left op right) ? Py_True : Py_False); \
+  }
+
+#define INT_CMP_OP_SIGNED(name, op)                         \
+  static PyObject* name(PyObject* l, PyObject* r) {         \
+    Py_ssize_t right = (Py_ssize_t)unbox_int(r);            \
+    Py_ssize_t left = (Py_ssize_t)unbox_int(l);             \
+    return Py_NewRef((left op right) ? Py_True : Py_False); \
+  }
+
+#define DBL_CMP_OP(name, op)                                \
+  static PyObject* name(PyObject* l, PyObject* r) {         \
+    int res = PyFloat_AS_DOUBLE(l) op PyFloat_AS_DOUBLE(r); \
+    return Py_NewRef(res ? Py_True : Py_False);             \
+  }
+
+INT_CMP_OP_SIGNED(eq_int, ==)
+INT_CMP_OP_SIGNED(ne_int, !=)
+INT_CMP_OP_SIGNED(lt_int, <)
+INT_CMP_OP_SIGNED(le_int, <=)
+INT_CMP_OP_SIGNED(gt_int, >)
+INT_CMP_OP_SIGNED(ge_int, >=)
+INT_CMP_OP_UNSIGNED(lt_un_int, <)
+INT_CMP_OP_UNSIGNED(le_un_int, <=)
+INT_CMP_OP_UNSIGNED(gt_un_int, >)
+INT_CMP_OP_UNSIGNED(ge_un_int, >=)
+DBL_CMP_OP(eq_dbl, ==)
+DBL_CMP_OP(ne_dbl, !=)
+DBL_CMP_OP(lt_dbl, <)
+DBL_CMP_OP(le_dbl, <=)
+DBL_CMP_OP(gt_dbl, >)
+DBL_CMP_OP(ge_dbl, >=)
+
+const Ci_PrimitiveBinaryFunc Ci_PrimitiveCompareOps[PRIM_OP_GE_DBL + 1] = {
+    [PRIM_OP_EQ_INT] = eq_int,
+    [PRIM_OP_NE_INT] = ne_int,
+    [PRIM_OP_LT_INT] = lt_int,
+    [PRIM_OP_LE_INT] = le_int,
+    [PRIM_OP_GT_INT] = gt_int,
+    [PRIM_OP_GE_INT] = ge_int,
+    [PRIM_OP_LT_UN_INT] = lt_un_int,
+    [PRIM_OP_LE_UN_INT] = le_un_int,
+    [PRIM_OP_GT_UN_INT] = gt_un_int,
+    [PRIM_OP_GE_UN_INT] = ge_un_int,
+    [PRIM_OP_EQ_DBL] = eq_dbl,
+    [PRIM_OP_NE_DBL] = ne_dbl,
+    [PRIM_OP_LT_DBL] = lt_dbl,
+    [PRIM_OP_LE_DBL] = le_dbl,
+    [PRIM_OP_GT_DBL] = gt_dbl,
+    [PRIM_OP_GE_DBL] = ge_dbl,
+};
@@ -0,0 +1,46 @@
+// Copyright (c) Meta Platforms, Inc. and affiliates.
+
+#pragma once
+
+#include "cinderx/python.h"
+
+#include "cinderx/StaticPython/classloader.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef PyObject* (*Ci_PrimitiveBinaryFunc)(PyObject* l, PyObject* r);
+
+/*
+ * Implementations of PRIMITIVE_BINARY_OP and PRIMITIVE_COMPARE_OP, indexed by
+ * their PRIM_OP_* oparg.  Each entry handles a single operation and operand
+ * type, reading small ints directly out of compact longs, so the interpreter
+ * dispatches straight to the operation instead of through a switch.
+ */
+extern const Ci_PrimitiveBinaryFunc
+    Ci_PrimitiveBinaryOps[PRIM_OP_POW_UN_INT + 1];
+extern const Ci_PrimitiveBinaryFunc Ci_PrimitiveCompareOps[PRIM_OP_GE_DBL + 1];
+
+/* Raises RuntimeError for an oparg with no implementation. */
+PyObject* Ci_PrimitiveUnknownOp(PyObject* l, PyObject* r);
+
+static inline PyObject*
+Ci_PrimitiveBinaryOp(PyObject* l, PyObject* r, int op) {
+  if ((unsigned)op > PRIM_OP_POW_UN_INT) {
+    return Ci_PrimitiveUnknownOp(l, r);
+  }
+  return Ci_PrimitiveBinaryOps[op](l, r);
+}
+
+static inline PyObject*
+Ci_PrimitiveCompareOp(PyObject* l, PyObject* r, int op) {
+  if ((unsigned)op > PRIM_OP_GE_DBL) {
+    return Ci_PrimitiveUnknownOp(l, r);
+  }
+  return Ci_PrimitiveCompareOps[op](l, r);
+}
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,308 @@
+// Copyright (c) Meta Platforms, Inc. and affiliates.
+
+#include "cinderx/Interpreter/static_cache.h"
+
+#if PY_VERSION_HEX >= 0x030E0000
+
+#include "cinderx/StaticPython/classloader.h"
+#include "cinderx/StaticPython/strictmoduleobject.h"
+#include "cinderx/StaticPython/type.h"
+
+typedef enum {
+  CACHE_UNCACHEABLE,
+  CACHE_PRIMITIVE_TYPE,
+  CACHE_TYPE,
+  CACHE_METHOD,
+  CACHE_FIELD,
+  CACHE_FUNCTION,
+  CACHE_INDIRECT,
+} StaticCacheKind;
+
+struct Ci_StaticCacheEntry {
+  uint8_t kind;
+  // CACHE_TYPE: optional in bit 0, exact in bit 1.  CACHE_FIELD: field type.
+  uint8_t flags;
+  union {
+    // Primitive type, vtable slot, field offset, or an index into the
+    // classloader's value cache for CACHE_TYPE and CACHE_FUNCTION.
+    Py_ssize_t value;
+    // CACHE_INDIRECT: the thunk or dict slot holding the current function.
+    PyObject** indirect;
+  };
+};
+
+typedef struct {
+  Py_ssize_t size;
+  Ci_StaticCacheEntry* entries[1];
+} StaticCacheTable;
+
+// Published for opcodes whose result we can't cache, so that they don't try
+// again on every execution.
+static Ci_StaticCacheEntry uncacheable = {.kind = CACHE_UNCACHEABLE};
+
+static Py_ssize_t cache_index = -1;
+
+static void free_table(void* data) {
+  StaticCacheTable* table = (StaticCacheTable*)data;
+  for (Py_ssize_t i = 0; i < table->size; i++) {
+    Ci_StaticCacheEntry* entry = table->entries[i];
+    if (entry != NULL && entry != &uncacheable) {
+      PyMem_Free(entry);
+    }
+  }
+  PyMem_Free(table);
+}
+
+void Ci_StaticCache_Init(void) {
+  // Code extra indices can't be released, so keep the one we got across
+  // reloads of the module.
+  if (cache_index == -1) {
+    cache_index = PyUnstable_Eval_RequestCodeExtraIndex(free_table);
+  }
+}
+
+static StaticCacheTable* get_or_create_table(PyCodeObject* code) {
+  StaticCacheTable* table = NULL;
+  void* data = NULL;
+  if (PyUnstable_Code_GetExtra((PyObject*)code, cache_index, &data) < 0) {
+    PyErr_Clear();
+    return NULL;
+  }
+  if (data != NULL) {
+    return (StaticCacheTable*)data;
+  }
+
+  Py_ssize_t size = Py_SIZE(code);
+  table = (StaticCacheTable*)PyMem_Calloc(
+      1, sizeof(StaticCacheTable) + size * sizeof(Ci_StaticCacheEntry*));
+  if (table == NULL) {
+    return NULL;
+  }
+  table->size = size;
+  if (PyUnstable_Code_SetExtra((PyObject*)code, cache_index, table) < 0) {
+    PyErr_Clear();
+    PyMem_Free(table);
+    return NULL;
+  }
+  return table;
+}
+
+Ci_StaticCacheEntry** Ci_StaticCache_Slot(
+    CodeExtra* extra,
+    PyCodeObject* code,
+    Py_ssize_t index) {
+  if (cache_index == -1 || (code->co_flags & CO_NO_MONITORING_EVENTS)) {
+    return NULL;
+  }
+
+  StaticCacheTable* table =
+      (StaticCacheTable*)_Py_atomic_load_ptr_acquire(&extra->static_cache);
+  if (table == NULL) {
+    // co_extra isn't safe to read while another thread is growing it, so the
+    // table is looked up under the same lock as codeExtra(), and only once.
+    // Threads racing to get here all find the same table, so it doesn't
+    // matter which store wins.
+    Py_BEGIN_CRITICAL_SECTION(code);
+    table = get_or_create_table(code);
+    Py_END_CRITICAL_SECTION();
+    if (table == NULL) {
+      return NULL;
+    }
+    _Py_atomic_store_ptr_release(&extra->static_cache, table);
+  }
+
+  if (index < 0 || index >= table->size) {
+    return NULL;
+  }
+  return &table->entries[index];
+}
+
+static Ci_StaticCacheEntry* load_entry(Ci_StaticCacheEntry** slot) {
+  return slot == NULL
+      ? NULL
+      : (Ci_StaticCacheEntry*)_Py_atomic_load_ptr_acquire(slot);
+}
+
+// Publishes an entry into an empty slot.  Allocation failures and losing a
+// race with another thread are both harmless, the opcode just resolves its
+// descriptor again next time.
+static void publish(
+    Ci_StaticCacheEntry** slot,
+    uint8_t kind,
+    uint8_t flags,
+    Py_ssize_t value) {
+  if (slot == NULL) {
+    return;
+  }
+  Ci_StaticCacheEntry* entry =
+      (Ci_StaticCacheEntry*)PyMem_Malloc(sizeof(Ci_StaticCacheEntry));
+  if (entry == NULL) {
+    return;
+  }
+  entry->kind = kind;
+  entry->flags = flags;
+  entry->value = value;
+
+  void* expected = NULL;
+  if (!_Py_atomic_compare_exchange_ptr(slot, &expected, entry)) {
+    PyMem_Free(entry);
+  }
+}
+
+static void publish_uncacheable(Ci_StaticCacheEntry** slot) {
+  if (slot == NULL) {
+    return;
+  }
+  void* expected = NULL;
+  _Py_atomic_compare_exchange_ptr(slot, &expected, &uncacheable);
+}
+
+// Returns a new reference to a value previously stored with
+// _PyClassLoader_CacheValue, or NULL if the value cache has been cleared
+// since.  Entries which refer to a cleared value stay in place and fall back
+// to resolving the descriptor.
+static PyObject* cached_value(Py_ssize_t index) {
+  PyObject* value = _PyClassLoader_GetCachedValue((int32_t)index);
+  if (value == NULL && PyErr_Occurred()) {
+    PyErr_Clear();
+  }
+  return value;
+}
+
+static int cache_value(PyObject* value) {
+  int32_t index = _PyClassLoader_CacheValue(value);
+  if (index < 0) {
+    PyErr_Clear();
+  }
+  return index;
+}
+
+int Ci_StaticCache_ResolvePrimitiveType(
+    Ci_StaticCacheEntry** slot,
+    PyObject* descr) {
+  Ci_StaticCacheEntry* entry = load_entry(slot);
+  if (entry != NULL && entry->kind == CACHE_PRIMITIVE_TYPE) {
+    return (int)entry->value;
+  }
+
+  int type = _PyClassLoader_ResolvePrimitiveType(descr);
+  if (type >= 0 && entry == NULL) {
+    publish(slot, CACHE_PRIMITIVE_TYPE, 0, type);
+  }
+  return type;
+}
+
+PyTypeObject* Ci_StaticCache_ResolveType(
+    Ci_StaticCacheEntry** slot,
+    PyObject* descr,
+    int* optional,
+    int* exact) {
+  Ci_StaticCacheEntry* entry = load_entry(slot);
+  if (entry != NULL && entry->kind == CACHE_TYPE) {
+    PyObject* type = cached_value(entry->value);
+    if (type != NULL) {
+      *optional = entry->flags & 1;
+      *exact = (entry->flags >> 1) & 1;
+      return (PyTypeObject*)type;
+    }
+  }
+
+  PyTypeObject* type = _PyClassLoader_ResolveType(descr, optional, exact);
+  if (type != NULL && entry == NULL) {
+    int index = cache_value((PyObject*)type);
+    if (index >= 0) {
+      publish(slot, CACHE_TYPE, (*exact << 1) | *optional, index);
+    } else {
+      publish_uncacheable(slot);
+    }
+  }
+  return type;
+}
+
+Py_ssize_t Ci_StaticCache_ResolveMethod(
+    Ci_StaticCacheEntry** slot,
+    PyObject* path) {
+  Ci_StaticCacheEntry* entry = load_entry(slot);
+  if (entry != NULL && entry->kind == CACHE_METHOD) {
+    return entry->value;
+  }
+
+  Py_ssize_t method = _PyClassLoader_ResolveMethod(path);
+  if (method != -1 && entry == NULL) {
+    publish(slot, CACHE_METHOD, 0, method);
+  }
+  return method;
+}
+
+Py_ssize_t Ci_StaticCache_ResolveFieldOffset(
+    Ci_StaticCacheEntry** slot,
+    PyObject* path,
+    int* field_type) {
+  Ci_StaticCacheEntry* entry = load_entry(slot);
+  if (entry != NULL && entry->kind == CACHE_FIELD) {
+    *field_type = entry->flags;
+    return entry->value;
+  }
+
+  Py_ssize_t offset = _PyClassLoader_ResolveFieldOffset(path, field_type);
+  if (offset != -1 && entry == NULL) {
+    if (*field_type >= 0 && *field_type <= UINT8_MAX) {
+      publish(slot, CACHE_FIELD, (uint8_t)*field_type, offset);
+    } else {
+      publish_uncacheable(slot);
+    }
+  }
+  return offset;
+}
+
+PyObject* Ci_StaticCache_ResolveFunction(
+    Ci_StaticCacheEntry** slot,
+    PyObject* path,
+    PyObject** container) {
+  Ci_StaticCacheEntry* entry = load_entry(slot);
+  if (entry != NULL) {
+    PyObject* func = NULL;
+    if (entry->kind == CACHE_FUNCTION) {
+      func = cached_value(entry->value);
+    } else if (entry->kind == CACHE_INDIRECT) {
+      func = Py_XNewRef(*entry->indirect);
+    }
+    if (func != NULL) {
+      *container = NULL;
+      return func;
+    }
+  }
+
+  PyObject* func = _PyClassLoader_ResolveFunction(path, container);
+  if (func == NULL || entry != NULL) {
+    return func;
+  }
+
+  if (_PyClassLoader_IsImmutable(*container)) {
+    // Frozen type or module, the function can't be replaced.
+    int index = cache_value(func);
+    if (index >= 0) {
+      publish(slot, CACHE_FUNCTION, 0, index);
+      return func;
+    }
+  }
+#ifndef Py_GIL_DISABLED
+  else if (_Py_IsImmortal(*container)) {
+    // We can only hold onto the indirect pointer if the container is immortal
+    // as we have no way to invalidate it if the container is freed.  Without
+    // the GIL the current function could be freed out from under the read, so
+    // this is limited to GIL builds.
+    PyObject** funcptr = _PyClassLoader_ResolveIndirectPtr(path);
+    if (funcptr != NULL) {
+      publish(slot, CACHE_INDIRECT, 0, (Py_ssize_t)funcptr);
+      return func;
+    }
+    PyErr_Clear();
+  }
+#endif
+
+  publish_uncacheable(slot);
+  return func;
+}
+
+#endif
@@ -0,0 +1,74 @@
+// Copyright (c) Meta Platforms, Inc. and affiliates.
+
+#pragma once
+
+#include "cinderx/python.h"
+
+#include "cinderx/Common/code_extra.h"
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Out of line caches for the Static Python opcodes on 3.14+.
+ *
+ * Stock CPython doesn't let us give our extended opcodes inline cache entries
+ * or rewrite them into specialized forms, so the results of resolving a
+ * static opcode's descriptor are instead kept in a per-code object table
+ * indexed by the offset of the opcode.  The table and its entries are
+ * immutable once published, which keeps them safe to read without a lock on
+ * free-threaded builds.
+ *
+ * Every Ci_StaticCache_Resolve* function takes the slot returned by
+ * Ci_StaticCache_Slot(), or NULL to skip the cache, and behaves exactly like
+ * the _PyClassLoader_Resolve* function it wraps.
+ */
+typedef struct Ci_StaticCacheEntry Ci_StaticCacheEntry;
+
+/* Requests the code object extra index used to hold the caches.  If no index
+ * is left the caches are disabled: Ci_StaticCache_Slot() returns NULL and
+ * every opcode resolves its descriptor on each execution, as it would without
+ * the cache. */
+void Ci_StaticCache_Init(void);
+
+/* Returns the cache slot for the static opcode at the given code unit index,
+ * creating the code object's table on first use.  extra must be code's
+ * CodeExtra, which remembers the table so that only its creation takes a
+ * lock.  Returns NULL if code can't hold a table. */
+Ci_StaticCacheEntry** Ci_StaticCache_Slot(
+    CodeExtra* extra,
+    PyCodeObject* code,
+    Py_ssize_t index);
+
+int Ci_StaticCache_ResolvePrimitiveType(
+    Ci_StaticCacheEntry** slot,
+    PyObject* descr);
+
+PyTypeObject* Ci_StaticCache_ResolveType(
+    Ci_StaticCacheEntry** slot,
+    PyObject* descr,
+    int* optional,
+    int* exact);
+
+Py_ssize_t Ci_StaticCache_ResolveMethod(
+    Ci_StaticCacheEntry** slot,
+    PyObject* path);
+
+Py_ssize_t Ci_StaticCache_ResolveFieldOffset(
+    Ci_StaticCacheEntry** slot,
+    PyObject* path,
+    int* field_type);
+
+/* Unlike _PyClassLoader_ResolveFunction, *container is set to NULL when the
+ * function comes from the cache. */
+PyObject* Ci_StaticCache_ResolveFunction(
+    Ci_StaticCacheEntry** slot,
+    PyObject* path,
+    PyObject** container);
+
+#ifdef __cplusplus
+}
+#endif
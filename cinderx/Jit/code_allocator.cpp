@@ -3,6 +3,7 @@
 #include "cinderx/Jit/code_allocator.h"
 
 #include "cinderx/Common/log.h"
+#include "cinderx/Common/util.h"
 #include "cinderx/Jit/codegen/code_section.h"
 #include "cinderx/Jit/config.h"
 #include "cinderx/Jit/jit_rt.h"
@@ -22,8 +23,10 @@
 #endif
 #endif
 
+#include <algorithm>
 #include <cstring>
 #include <new>
+#include <tuple>
 
 namespace cinderx::jit {
 
@@ -40,6 +43,33 @@ namespace {
 // 2MiB to match Linux's huge-page size.
 constexpr size_t kAllocSize = 1024 * 1024 * 2;
 
+// Allocations are rounded up to a multiple of this, which keeps free extents
+// from being split into slivers too small to ever be reused.
+constexpr size_t kExtentAlign = 16;
+
+// Set once any code has been write-protected, so that code patches don't have
+// to look up their address until then.
+std::atomic<bool> s_code_write_protected{false};
+
+// Serializes changes to the protection of write-protected code.
+std::mutex s_code_write_mutex;
+
+size_t extentSize(size_t size) {
+  return std::max(roundUp(size, kExtentAlign), kExtentAlign);
+}
+
+// Find the chunk containing ptr in a map of chunks keyed by start address.
+template <typename ChunkMap>
+auto findContaining(ChunkMap& chunks, const void* ptr) {
+  auto addr = const_cast<uint8_t*>(static_cast<const uint8_t*>(ptr));
+  auto it = chunks.upper_bound(addr);
+  if (it == chunks.begin()) {
+    return chunks.end();
+  }
+  --it;
+  return addr < it->first + it->second.size ? it : chunks.end();
+}
+
 // On macOS ARM64, MAP_JIT memory requires toggling between writable and
 // executable states per-thread via pthread_jit_write_protect_np.
 void jitEnableWriting() {
@@ -59,6 +89,15 @@ void jitEnableExecuting(
   if (cold_size > 0) {
     sys_icache_invalidate(cold_addr, cold_size);
   }
+#elif defined(__aarch64__)
+  // Memory can be reused for new code after old code is released, so stale
+  // instructions have to be flushed out of the instruction cache.
+  auto begin = static_cast<char*>(addr);
+  __builtin___clear_cache(begin, begin + size);
+  if (cold_size > 0) {
+    auto cold_begin = static_cast<char*>(cold_addr);
+    __builtin___clear_cache(cold_begin, cold_begin + cold_size);
+  }
 #endif
 }
 
@@ -287,80 +326,208 @@ void CodeAllocator::atForkChild() {
 }
 
 CodeAllocatorCinder::~CodeAllocatorCinder() {
-  for (std::span<uint8_t> alloc : allocations_) {
+  for (auto& [start, chunk] : chunks_) {
 #ifndef WIN32
-    JIT_CHECK(
-        munmap(alloc.data(), alloc.size()) == 0, "Freeing code memory failed");
+    JIT_CHECK(munmap(start, chunk.size) == 0, "Freeing code memory failed");
 #else
-    VirtualFree(alloc.data(), 0, MEM_RELEASE);
+    VirtualFree(start, 0, MEM_RELEASE);
 #endif
   }
 }
 
-void CodeAllocatorCinder::ensureSpace(
-    uint8_t*& alloc,
-    size_t& alloc_free,
-    size_t size,
-    bool use_huge_pages) {
-  if (alloc_free >= size) {
-    return;
-  }
+CodeAllocatorCinder::Stats CodeAllocatorCinder::stats() const {
+  std::lock_guard lock{allocator_mutex_};
 
-  lost_bytes_.fetch_add(alloc_free, std::memory_order_relaxed);
+  Stats stats;
+  stats.chunks = chunks_.size();
+  for (auto& [start, chunk] : chunks_) {
+    stats.reserved_bytes += chunk.size;
+    stats.evacuating_chunks += chunk.evacuating;
+  }
+  for (const FreeList& list : free_) {
+    for (auto& [start, size] : list.by_addr) {
+      stats.free_bytes += size;
+    }
+    stats.free_extents += list.by_addr.size();
+    if (!list.by_size.empty()) {
+      stats.largest_free_extent =
+          std::max(stats.largest_free_extent, list.by_size.rbegin()->first);
+    }
+  }
+  stats.released_bytes = released_bytes_;
+  return stats;
+}
 
-  size_t chunk_size = ((size / kAllocSize) + 1) * kAllocSize;
-  uint8_t* res = allocPages(chunk_size);
-  if (use_huge_pages && setHugePages(res, chunk_size)) {
+uint8_t* CodeAllocatorCinder::newChunk(size_t size, bool use_huge_pages) {
+  uint8_t* res = allocPages(size);
+  if (use_huge_pages && setHugePages(res, size)) {
     huge_allocs_.fetch_add(1, std::memory_order_relaxed);
   } else {
     fragmented_allocs_.fetch_add(1, std::memory_order_relaxed);
   }
-  alloc = res;
-  allocations_.emplace_back(res, chunk_size);
-  alloc_free = chunk_size;
+  chunks_.emplace(res, Chunk{size});
+  return res;
+}
+
+CodeAllocatorCinder::Chunk& CodeAllocatorCinder::chunkFor(const void* ptr) {
+  auto it = findContaining(chunks_, ptr);
+  JIT_CHECK(it != chunks_.end(), "{} is not in a code chunk", ptr);
+  return it->second;
+}
+
+uint8_t* CodeAllocatorCinder::findFree(
+    Pool pool,
+    size_t size,
+    const uint8_t* chunk) const {
+  const FreeList& list = free_[static_cast<size_t>(pool)];
+  for (auto it = list.by_size.lower_bound({size, nullptr});
+       it != list.by_size.end();
+       ++it) {
+    auto chunk_it = findContaining(chunks_, it->second);
+    if (chunk_it->second.evacuating || chunk_it->second.write_protected ||
+        (chunk != nullptr && chunk_it->first != chunk)) {
+      continue;
+    }
+    return it->second;
+  }
+  return nullptr;
+}
+
+void CodeAllocatorCinder::commit(Pool pool, uint8_t* start, size_t size) {
+  FreeList& list = free_[static_cast<size_t>(pool)];
+  auto it = list.by_addr.find(start);
+  JIT_CHECK(
+      it != list.by_addr.end() && it->second >= size,
+      "No free extent of {} bytes at {}",
+      size,
+      static_cast<void*>(start));
+
+  size_t extent_size = it->second;
+  list.by_size.erase({extent_size, start});
+  list.by_addr.erase(it);
+  if (extent_size > size) {
+    list.by_addr.emplace(start + size, extent_size - size);
+    list.by_size.emplace(extent_size - size, start + size);
+  }
+
+  auto chunk_it = findContaining(chunks_, start);
+  chunk_it->second.live_bytes += size;
+  (pool == Pool::kHot ? hot_chunk_ : cold_chunk_) = chunk_it->first;
+  used_bytes_.fetch_add(size, std::memory_order_relaxed);
 }
 
-void CodeAllocatorCinder::ensureSplitSpace(
+void CodeAllocatorCinder::addFree(Pool pool, uint8_t* start, size_t size) {
+  FreeList& list = free_[static_cast<size_t>(pool)];
+  auto chunk_it = findContaining(chunks_, start);
+  JIT_CHECK(
+      chunk_it != chunks_.end(),
+      "{} is not in a code chunk",
+      static_cast<void*>(start));
+  uint8_t* chunk_start = chunk_it->first;
+  uint8_t* chunk_end = chunk_start + chunk_it->second.size;
+
+  // Chunks can be adjacent in memory, but extents are never merged across
+  // them so that each chunk's space can be accounted for separately.
+  auto next = list.by_addr.lower_bound(start);
+  if (next != list.by_addr.end() && next->first == start + size &&
+      next->first < chunk_end) {
+    size += next->second;
+    list.by_size.erase({next->second, next->first});
+    next = list.by_addr.erase(next);
+  }
+  if (next != list.by_addr.begin()) {
+    auto prev = std::prev(next);
+    if (prev->first + prev->second == start && prev->first >= chunk_start) {
+      start = prev->first;
+      size += prev->second;
+      list.by_size.erase({prev->second, prev->first});
+      list.by_addr.erase(prev);
+    }
+  }
+  list.by_addr.emplace(start, size);
+  list.by_size.emplace(size, start);
+}
+
+void CodeAllocatorCinder::release(Pool pool, uint8_t* start, size_t size) {
+  Chunk& chunk = chunkFor(start);
+
+  // Zero freed code in debug builds so anything still running it fails fast.
+  if (kDebug && !chunk.write_protected) {
+    jitEnableWriting();
+    std::memset(start, 0, size);
+    jitEnableExecuting(start, size);
+  }
+
+  JIT_CHECK(chunk.live_bytes >= size, "Releasing more code than was added");
+  chunk.live_bytes -= size;
+  released_bytes_ += size;
+  used_bytes_.fetch_sub(size, std::memory_order_relaxed);
+  addFree(pool, start, size);
+}
+
+uint8_t*
+CodeAllocatorCinder::reserve(Pool pool, size_t size, bool use_huge_pages) {
+  bool relink = relinking_ && pool == Pool::kHot;
+  if (!relink || relink_chunk_ != nullptr) {
+    uint8_t* start = findFree(pool, size, relink ? relink_chunk_ : nullptr);
+    if (start != nullptr) {
+      return start;
+    }
+  }
+
+  size_t chunk_size = ((size / kAllocSize) + 1) * kAllocSize;
+  uint8_t* start = newChunk(chunk_size, use_huge_pages);
+  addFree(pool, start, chunk_size);
+  if (relink) {
+    relink_chunk_ = start;
+  }
+  return start;
+}
+
+std::pair<uint8_t*, uint8_t*> CodeAllocatorCinder::reserveSplit(
     size_t hot_needed,
     size_t cold_needed) {
-  if (hot_alloc_free_ >= hot_needed && cold_alloc_free_ >= cold_needed) {
-    return;
+  if (cold_needed == 0) {
+    return {reserve(Pool::kHot, hot_needed, true), nullptr};
   }
 
-  // When either side needs a new allocation, allocate a single contiguous
-  // region and split it. This guarantees hot and cold code are always within
-  // the same mmap region, so cross-section jumps stay within ARM64's relative
-  // branch range (±128MB for B/BL, ±1MB for B.cond). Without this,
+  if (!relinking_ || relink_chunk_ != nullptr) {
+    uint8_t* hot = findFree(Pool::kHot, hot_needed, relink_chunk_);
+    if (hot != nullptr) {
+      uint8_t* chunk = findContaining(chunks_, hot)->first;
+      if (uint8_t* cold = findFree(Pool::kCold, cold_needed, chunk);
+          cold != nullptr) {
+        return {hot, cold};
+      }
+    }
+  }
+
+  // Otherwise map a single contiguous region and split it. Without this,
   // independent mmap() calls could place hot and cold regions too far apart,
   // causing asmjit's relocateToBase()/resolveUnresolvedLinks() to fail with
   // kErrorInvalidDisplacement.
-  lost_bytes_.fetch_add(
-      hot_alloc_free_ + cold_alloc_free_, std::memory_order_relaxed);
-
   size_t total_needed = hot_needed + cold_needed;
   size_t chunk_size = ((total_needed / kAllocSize) + 1) * kAllocSize;
-  uint8_t* res = allocPages(chunk_size);
-  if (setHugePages(res, chunk_size)) {
-    huge_allocs_.fetch_add(1, std::memory_order_relaxed);
-  } else {
-    fragmented_allocs_.fetch_add(1, std::memory_order_relaxed);
-  }
-  allocations_.emplace_back(res, chunk_size);
+  uint8_t* res = newChunk(chunk_size, true);
 
   // Hot code grows forward from the start, cold code grows forward from a
   // split point. Split proportionally so each side gets at least what it
   // requested, distributing any surplus evenly.
   size_t surplus = chunk_size - total_needed;
-  size_t hot_share = hot_needed + surplus / 2;
-  hot_alloc_ = res;
-  hot_alloc_free_ = hot_share;
-  cold_alloc_ = res + hot_share;
-  cold_alloc_free_ = chunk_size - hot_share;
+  size_t hot_share = roundUp(hot_needed + surplus / 2, kExtentAlign);
+  addFree(Pool::kHot, res, hot_share);
+  addFree(Pool::kCold, res + hot_share, chunk_size - hot_share);
+  if (relinking_) {
+    relink_chunk_ = res;
+  }
+  return {res, res + hot_share};
 }
 
 AllocateResult CodeAllocatorCinder::addSplitCode(asmjit::CodeHolder* code) {
   size_t hot_size = 0;
   size_t cold_size = 0;
+  uint8_t* hot_addr = nullptr;
+  uint8_t* cold_addr = nullptr;
 
   for (;;) {
     // Compute how much space each section type needs.
@@ -375,28 +542,31 @@ AllocateResult CodeAllocatorCinder::addSplitCode(asmjit::CodeHolder* code) {
       }
     }
 
-    // Ensure we have enough space for both hot and cold code.
+    // Find space for both hot and cold code.
+    size_t hot_needed = extentSize(hot_size);
+    size_t cold_needed = cold_size == 0 ? 0 : extentSize(cold_size);
 #if defined(__aarch64__)
     // On ARM64, branch displacements are limited (±128MB for B/BL, ±1MB for
-    // B.cond). Allocate hot and cold from a single contiguous region so
-    // cross-section jumps are always in range.
-    ensureSplitSpace(hot_size, cold_size);
+    // B.cond). Allocate hot and cold from a single chunk so cross-section
+    // jumps are always in range.
+    std::tie(hot_addr, cold_addr) = reserveSplit(hot_needed, cold_needed);
 #else
     // On x86-64, RIP-relative addressing has a ±2GB range which is large enough
     // that independent allocations are unlikely to exceed it in practice.
-    ensureSpace(hot_alloc_, hot_alloc_free_, hot_size, true);
-    ensureSpace(
-        cold_alloc_,
-        cold_alloc_free_,
-        cold_size,
-        getConfig().cold_code_huge_pages);
+    hot_addr = reserve(Pool::kHot, hot_needed, true);
+    cold_addr = cold_needed == 0
+        ? nullptr
+        : reserve(Pool::kCold, cold_needed, getConfig().cold_code_huge_pages);
 #endif
 
     // Fix up offsets for each code section before resolving links.
     // All offsets are relative to the hot allocation base so that asmjit can
-    // resolve cross-section jumps correctly.
+    // resolve cross-section jumps correctly.  An empty cold section just needs
+    // an address that doesn't overlap the hot code.
     size_t hot_offset = 0;
-    size_t cold_offset = static_cast<size_t>(cold_alloc_ - hot_alloc_);
+    size_t cold_offset = cold_addr == nullptr
+        ? hot_size
+        : static_cast<size_t>(cold_addr - hot_addr);
     for (asmjit::Section* section : code->sections()) {
       CodeSection cs = codeSectionFromName(section->name());
       if (cs == CodeSection::kCold) {
@@ -416,13 +586,11 @@ AllocateResult CodeAllocatorCinder::addSplitCode(asmjit::CodeHolder* code) {
   }
 
   PROPAGATE_ERROR(code->resolveUnresolvedLinks());
-  PROPAGATE_ERROR(code->relocateToBase(uintptr_t(hot_alloc_)));
-
-  void* addr = hot_alloc_;
-  void* cold_addr = cold_alloc_;
+  PROPAGATE_ERROR(code->relocateToBase(uintptr_t(hot_addr)));
 
   // Copy each section's data to the appropriate allocation.
-  size_t total_size = 0;
+  uint8_t* hot_cursor = hot_addr;
+  uint8_t* cold_cursor = cold_addr;
   jitEnableWriting();
   for (asmjit::Section* section : code->_sections) {
     size_t buffer_size = section->bufferSize();
@@ -431,20 +599,29 @@ AllocateResult CodeAllocatorCinder::addSplitCode(asmjit::CodeHolder* code) {
     }
     CodeSection cs = codeSectionFromName(section->name());
     if (cs == CodeSection::kCold) {
-      std::memcpy(cold_alloc_, section->data(), buffer_size);
-      cold_alloc_ += buffer_size;
-      cold_alloc_free_ -= buffer_size;
+      std::memcpy(cold_cursor, section->data(), buffer_size);
+      cold_cursor += buffer_size;
     } else {
-      std::memcpy(hot_alloc_, section->data(), buffer_size);
-      hot_alloc_ += buffer_size;
-      hot_alloc_free_ -= buffer_size;
+      std::memcpy(hot_cursor, section->data(), buffer_size);
+      hot_cursor += buffer_size;
     }
-    total_size += buffer_size;
   }
-  jitEnableExecuting(addr, hot_size, cold_addr, cold_size);
+  jitEnableExecuting(hot_addr, hot_size, cold_addr, cold_size);
 
-  used_bytes_.fetch_add(total_size, std::memory_order_relaxed);
-  return AllocateResult{addr, asmjit::kErrorOk};
+  size_t hot_used = static_cast<size_t>(hot_cursor - hot_addr);
+  size_t cold_used = static_cast<size_t>(cold_cursor - cold_addr);
+  JIT_CHECK(
+      hot_used <= hot_size && cold_used <= cold_size,
+      "Code grew during relocation");
+
+  Allocation alloc{extentSize(hot_used), cold_addr, 0};
+  commit(Pool::kHot, hot_addr, alloc.hot_size);
+  if (cold_addr != nullptr) {
+    alloc.cold_size = extentSize(cold_used);
+    commit(Pool::kCold, cold_addr, alloc.cold_size);
+  }
+  allocations_.emplace(hot_addr, alloc);
+  return AllocateResult{hot_addr, asmjit::kErrorOk};
 }
 
 AllocateResult CodeAllocatorCinder::addCode(asmjit::CodeHolder* code) {
@@ -458,9 +635,9 @@ AllocateResult CodeAllocatorCinder::addCode(asmjit::CodeHolder* code) {
   PROPAGATE_ERROR(code->resolveUnresolvedLinks());
 
   size_t max_code_size = code->codeSize();
-  ensureSpace(hot_alloc_, hot_alloc_free_, max_code_size, true);
+  uint8_t* addr = reserve(Pool::kHot, extentSize(max_code_size), true);
 
-  PROPAGATE_ERROR(code->relocateToBase(uintptr_t(hot_alloc_)));
+  PROPAGATE_ERROR(code->relocateToBase(uintptr_t(addr)));
 
   size_t actual_code_size = code->codeSize();
   JIT_CHECK(actual_code_size <= max_code_size, "Code grew during relocation");
@@ -473,39 +650,185 @@ AllocateResult CodeAllocatorCinder::addCode(asmjit::CodeHolder* code) {
 
     JIT_CHECK(
         offset + buffer_size <= actual_code_size, "Inconsistent code size");
-    std::memcpy(hot_alloc_ + offset, section->data(), buffer_size);
+    std::memcpy(addr + offset, section->data(), buffer_size);
 
     if (virtual_size > buffer_size) {
       JIT_CHECK(
           offset + virtual_size <= actual_code_size, "Inconsistent code size");
-      std::memset(
-          hot_alloc_ + offset + buffer_size, 0, virtual_size - buffer_size);
+      std::memset(addr + offset + buffer_size, 0, virtual_size - buffer_size);
     }
   }
-
-  void* addr = hot_alloc_;
   jitEnableExecuting(addr, actual_code_size);
 
-  hot_alloc_ += actual_code_size;
-  hot_alloc_free_ -= actual_code_size;
-  used_bytes_.fetch_add(actual_code_size, std::memory_order_relaxed);
+  // Only take what the code ended up needing, anything that relocation
+  // shaved off stays free.
+  Allocation alloc{extentSize(actual_code_size)};
+  commit(Pool::kHot, addr, alloc.hot_size);
+  allocations_.emplace(addr, alloc);
 
   return AllocateResult{addr, asmjit::kErrorOk};
 }
 
-asmjit::Error CodeAllocatorCinder::releaseCode([[maybe_unused]] void* code) {
-  // TODO(T233607793): Actually implement deallocating memory.
+asmjit::Error CodeAllocatorCinder::releaseCode(void* code) {
+  std::lock_guard lock{allocator_mutex_};
+
+  auto it = allocations_.find(code);
+  if (it == allocations_.end()) {
+    return asmjit::kErrorInvalidArgument;
+  }
+  Allocation alloc = it->second;
+  allocations_.erase(it);
+
+  release(Pool::kHot, static_cast<uint8_t*>(code), alloc.hot_size);
+  if (alloc.cold_size > 0) {
+    release(Pool::kCold, alloc.cold, alloc.cold_size);
+  }
   return asmjit::kErrorOk;
 }
 
 bool CodeAllocatorCinder::contains(const void* ptr) const {
   std::lock_guard lock{allocator_mutex_};
-  for (std::span<uint8_t> alloc : allocations_) {
-    if (alloc.data() <= ptr && ptr < alloc.data() + alloc.size()) {
-      return true;
+  return findContaining(chunks_, ptr) != chunks_.end();
+}
+
+size_t CodeAllocatorCinder::beginCompaction(double max_occupancy) {
+  std::lock_guard lock{allocator_mutex_};
+
+  size_t marked = 0;
+  for (auto& [start, chunk] : chunks_) {
+    if (start == hot_chunk_ || start == cold_chunk_ || chunk.live_bytes == 0) {
+      continue;
+    }
+    if (static_cast<double>(chunk.live_bytes) <=
+        max_occupancy * static_cast<double>(chunk.size)) {
+      chunk.evacuating = true;
+      marked++;
     }
   }
-  return false;
+  return marked;
+}
+
+bool CodeAllocatorCinder::isEvacuating(const void* ptr) const {
+  std::lock_guard lock{allocator_mutex_};
+  auto it = findContaining(chunks_, ptr);
+  return it != chunks_.end() && it->second.evacuating;
+}
+
+void CodeAllocatorCinder::endCompaction() {
+  std::lock_guard lock{allocator_mutex_};
+  for (auto& [start, chunk] : chunks_) {
+    chunk.evacuating = false;
+  }
+}
+
+void CodeAllocatorCinder::beginRelink() {
+  std::lock_guard lock{allocator_mutex_};
+  relinking_ = true;
+  relink_chunk_ = nullptr;
+}
+
+void CodeAllocatorCinder::endRelink() {
+  std::lock_guard lock{allocator_mutex_};
+  relinking_ = false;
+  relink_chunk_ = nullptr;
+}
+
+size_t CodeAllocatorCinder::writeProtect() {
+  std::lock_guard lock{allocator_mutex_};
+
+  size_t marked = 0;
+#ifndef WIN32
+  for (auto& [start, chunk] : chunks_) {
+    if (chunk.write_protected || chunk.live_bytes == 0) {
+      continue;
+    }
+    if (mprotect(start, chunk.size, PROT_READ | PROT_EXEC) != 0) {
+      JIT_LOG(
+          "Failed to write-protect code chunk at {}, errno={}",
+          static_cast<void*>(start),
+          errno);
+      continue;
+    }
+    chunk.write_protected = true;
+    marked++;
+  }
+  if (marked > 0) {
+    s_code_write_protected.store(true, std::memory_order_release);
+  }
+#endif
+  return marked;
+}
+
+bool CodeAllocatorCinder::isWriteProtected(const void* ptr) const {
+  std::lock_guard lock{allocator_mutex_};
+  auto it = findContaining(chunks_, ptr);
+  return it != chunks_.end() && it->second.write_protected;
+}
+
+size_t CodeAllocatorCinder::codePages() const {
+  std::lock_guard lock{allocator_mutex_};
+
+  std::set<uintptr_t> pages;
+  auto add = [&](const void* start, size_t size) {
+    auto addr = reinterpret_cast<uintptr_t>(start);
+    for (uintptr_t page = roundDown(addr, kPageSize); page < addr + size;
+         page += kPageSize) {
+      pages.insert(page);
+    }
+  };
+  for (auto& [start, alloc] : allocations_) {
+    add(start, alloc.hot_size);
+    if (alloc.cold_size > 0) {
+      add(alloc.cold, alloc.cold_size);
+    }
+  }
+  return pages.size();
+}
+
+ScopedCodeWrite::ScopedCodeWrite(
+    [[maybe_unused]] void* start,
+    [[maybe_unused]] size_t size) {
+#ifndef WIN32
+  if (!s_code_write_protected.load(std::memory_order_acquire)) {
+    return;
+  }
+  ModuleState* state = cinderx::getModuleState();
+  auto allocator = state != nullptr
+      ? dynamic_cast<CodeAllocatorCinder*>(state->code_allocator.get())
+      : nullptr;
+  if (allocator == nullptr || !allocator->isWriteProtected(start)) {
+    return;
+  }
+
+  auto addr = reinterpret_cast<uintptr_t>(start);
+  uintptr_t page_start = roundDown(addr, kPageSize);
+  page_start_ = reinterpret_cast<uint8_t*>(page_start);
+  page_size_ = roundUp(addr + size, kPageSize) - page_start;
+
+  // Patches to the same page from different threads must not restore its
+  // protection out from under each other.
+  s_code_write_mutex.lock();
+  JIT_CHECK(
+      mprotect(page_start_, page_size_, PROT_READ | PROT_WRITE | PROT_EXEC) ==
+          0,
+      "Failed to make code at {} writable, errno={}",
+      start,
+      errno);
+#endif
+}
+
+ScopedCodeWrite::~ScopedCodeWrite() {
+#ifndef WIN32
+  if (page_start_ == nullptr) {
+    return;
+  }
+  JIT_CHECK(
+      mprotect(page_start_, page_size_, PROT_READ | PROT_EXEC) == 0,
+      "Failed to write-protect code at {}, errno={}",
+      static_cast<void*>(page_start_),
+      errno);
+  s_code_write_mutex.unlock();
+#endif
 }
 
 void CodeAllocatorCinder::atForkPrepare() {
@@ -532,9 +855,11 @@ void codeAllocatorAtForkPrepare() {
   // Innermost: ensureSpace() reaches this while holding allocator_mutex_.
   cinder_jit_region_mutex_.lock();
 #endif
+  s_code_write_mutex.lock();
 }
 
 void codeAllocatorAtForkParent() {
+  s_code_write_mutex.unlock();
 #if defined(__linux__)
   cinder_jit_region_mutex_.unlock();
 #endif
@@ -545,6 +870,7 @@ void codeAllocatorAtForkParent() {
 }
 
 void codeAllocatorAtForkChild() {
+  new (&s_code_write_mutex) std::mutex{};
 #if defined(__linux__)
   new (&cinder_jit_region_mutex_) std::mutex{};
 #endif
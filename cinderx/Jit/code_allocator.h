@@ -2,13 +2,18 @@
 
 #pragma once
 
+#include "cinderx/Common/containers.h"
 #include "cinderx/Jit/code_allocator_iface.h"
 
 #include <asmjit/asmjit.h>
 
+#include <array>
 #include <atomic>
+#include <map>
 #include <mutex>
+#include <set>
 #include <span>
+#include <utility>
 #include <vector>
 
 namespace cinderx::jit {
@@ -62,13 +67,31 @@ class CodeAllocator : public ICodeAllocator {
 // When multiple code sections are enabled, hot code is allocated on huge pages
 // and cold code is allocated on separate pages (optionally huge pages as well,
 // controlled by the cold_code_huge_pages config).
+//
+// Memory is mapped in chunks of at least 2MiB and never unmapped until the
+// allocator is destroyed.  The unused parts of every chunk are tracked as free
+// extents, so code released by releaseCode() is reused by later compilations.
+// Adjacent free extents in the same chunk are merged, and allocations are
+// placed in the smallest extent that fits.
 class CodeAllocatorCinder : public CodeAllocator {
  public:
-  ~CodeAllocatorCinder() override;
+  // How the allocator's chunks are being used.
+  struct Stats {
+    // Number of chunks mapped, and their total size.
+    size_t chunks{0};
+    size_t reserved_bytes{0};
+    // Bytes in free extents, the number of free extents, and the size of the
+    // largest one.
+    size_t free_bytes{0};
+    size_t free_extents{0};
+    size_t largest_free_extent{0};
+    // Total bytes handed back by releaseCode().
+    size_t released_bytes{0};
+    // Number of chunks currently being evacuated by a compaction.
+    size_t evacuating_chunks{0};
+  };
 
-  size_t lostBytes() const {
-    return lost_bytes_.load(std::memory_order_relaxed);
-  }
+  ~CodeAllocatorCinder() override;
 
   size_t fragmentedAllocs() const {
     return fragmented_allocs_.load(std::memory_order_relaxed);
@@ -78,57 +101,152 @@ class CodeAllocatorCinder : public CodeAllocator {
     return huge_allocs_.load(std::memory_order_relaxed);
   }
 
+  Stats stats() const;
+
   AllocateResult addCode(asmjit::CodeHolder* code) override;
   asmjit::Error releaseCode(void* code) override;
   bool contains(const void* ptr) const override;
 
+  // Start evacuating every chunk whose live code takes up no more than
+  // max_occupancy (a fraction between 0 and 1) of it.  New code is not placed
+  // in an evacuating chunk, so recompiling the functions that live in one
+  // moves them into denser chunks.  The chunks new code is currently being
+  // placed in are never evacuated.  Return the number of chunks marked.
+  size_t beginCompaction(double max_occupancy);
+
+  // Check if a pointer is in a chunk that is being evacuated.
+  bool isEvacuating(const void* ptr) const;
+
+  // Make evacuating chunks available to new code again.
+  void endCompaction();
+
+  // Until endRelink(), place new hot code back to back in freshly mapped
+  // chunks rather than in existing free space.  Recompiling functions in order
+  // of hotness while this is active packs the hottest code onto as few huge
+  // pages as possible.
+  void beginRelink();
+  void endRelink();
+
+  // Map every chunk holding code read-only and executable, so that pages
+  // shared with forked children are never dirtied by accident.  New code goes
+  // into fresh chunks, and code patches go through ScopedCodeWrite.  Return
+  // the number of chunks protected.  Does nothing on Windows.
+  size_t writeProtect();
+
+  // Check if a pointer is in a chunk mapped by writeProtect().
+  bool isWriteProtected(const void* ptr) const;
+
+  // Number of distinct pages touched by live code.
+  size_t codePages() const;
+
   void atForkPrepare() override;
   void atForkParent() override;
   void atForkChild() override;
 
  private:
+  // Free space for hot code and cold code is kept apart, so that the two
+  // never end up sharing pages.
+  enum class Pool : uint8_t { kHot, kCold };
+
+  struct Chunk {
+    size_t size{0};
+    // Bytes currently allocated to code.
+    size_t live_bytes{0};
+    bool evacuating{false};
+    bool write_protected{false};
+  };
+
+  // Free extents indexed both by address, for merging, and by size, for best
+  // fit.
+  struct FreeList {
+    std::map<uint8_t*, size_t> by_addr;
+    std::set<std::pair<size_t, uint8_t*>> by_size;
+  };
+
+  // The extents backing one call to addCode(), keyed by the hot address.
+  struct Allocation {
+    size_t hot_size{0};
+    uint8_t* cold{nullptr};
+    size_t cold_size{0};
+  };
+
   // Add code with hot/cold section splitting. Called by addCode() when
   // multiple_code_sections is enabled. Caller must hold allocator_mutex_.
   AllocateResult addSplitCode(asmjit::CodeHolder* code);
 
-  // Ensure the given bump allocator has at least `size` bytes free, allocating
-  // a new chunk if necessary.
-  void ensureSpace(
-      uint8_t*& alloc,
-      size_t& alloc_free,
-      size_t size,
-      bool use_huge_pages);
-
-  // Ensure both hot and cold bump allocators have enough space for the given
-  // sizes. If either needs a new allocation, a single contiguous region is
-  // allocated and split between hot (first half) and cold (second half). This
-  // guarantees cross-section jumps are within ARM64's relative branch range
-  // (±128MB for B/BL, ±1MB for B.cond). Used only on aarch64.
-  void ensureSplitSpace(size_t hot_needed, size_t cold_needed);
+  // Find room for `size` bytes in the given pool, mapping a new chunk if no
+  // free extent is big enough.  During a relink, hot code only goes in the
+  // relink chunk.  The space is not taken until commit().
+  uint8_t* reserve(Pool pool, size_t size, bool use_huge_pages);
+
+  // Find room for hot and cold code in the same chunk, mapping a new chunk
+  // split between the two pools if necessary.  This guarantees cross-section
+  // jumps are within ARM64's relative branch range (±128MB for B/BL, ±1MB for
+  // B.cond, with branch stub islands covering the rest).  Used only on
+  // aarch64.
+  std::pair<uint8_t*, uint8_t*> reserveSplit(
+      size_t hot_needed,
+      size_t cold_needed);
+
+  // Map a new chunk and return its start.  The chunk's space is not added to
+  // any pool.
+  uint8_t* newChunk(size_t size, bool use_huge_pages);
+
+  // Smallest free extent in the pool holding at least `size` bytes, skipping
+  // evacuating chunks.  If `chunk` is set, only extents in that chunk count.
+  uint8_t* findFree(Pool pool, size_t size, const uint8_t* chunk = nullptr)
+      const;
+
+  // Take `size` bytes from the front of the free extent starting at `start`.
+  void commit(Pool pool, uint8_t* start, size_t size);
+
+  // Return an extent to the pool, merging it with its free neighbours.
+  void addFree(Pool pool, uint8_t* start, size_t size);
+
+  void release(Pool pool, uint8_t* start, size_t size);
+
+  Chunk& chunkFor(const void* ptr);
 
   // Protects all allocator-owned state used by addCode()/contains().
   mutable std::mutex allocator_mutex_;
 
-  // List of all chunks allocated, for use in deallocation and contains().
-  std::vector<std::span<uint8_t>> allocations_;
+  // Every chunk mapped, keyed by start address.
+  std::map<uint8_t*, Chunk> chunks_;
+
+  std::array<FreeList, 2> free_;
 
-  // Hot code allocation state.
-  uint8_t* hot_alloc_{nullptr};
-  size_t hot_alloc_free_{0};
+  UnorderedMap<const void*, Allocation> allocations_;
 
-  // Cold code allocation state (used when multiple code sections are enabled).
-  uint8_t* cold_alloc_{nullptr};
-  size_t cold_alloc_free_{0};
+  // Start of the chunks that most recently received new hot and cold code.
+  uint8_t* hot_chunk_{nullptr};
+  uint8_t* cold_chunk_{nullptr};
 
-  // Number of bytes in total lost when allocations didn't fit neatly into
-  // the bytes remaining in a chunk so a new one was allocated.
-  std::atomic<size_t> lost_bytes_{0};
+  // Whether a relink is in progress, and the chunk it is placing code in.
+  bool relinking_{false};
+  uint8_t* relink_chunk_{nullptr};
+
+  size_t released_bytes_{0};
   // Number of chunks allocated which successfully used huge pages.
   std::atomic<size_t> huge_allocs_{0};
   // Number of chunks allocated which did not use huge pages.
   std::atomic<size_t> fragmented_allocs_{0};
 };
 
+// Temporarily make a range of code writable, if it was write-protected by
+// CodeAllocatorCinder::writeProtect().  Otherwise a no-op.
+class ScopedCodeWrite {
+ public:
+  ScopedCodeWrite(void* start, size_t size);
+  ~ScopedCodeWrite();
+
+  ScopedCodeWrite(const ScopedCodeWrite&) = delete;
+  ScopedCodeWrite& operator=(const ScopedCodeWrite&) = delete;
+
+ private:
+  uint8_t* page_start_{nullptr};
+  size_t page_size_{0};
+};
+
 // pthread_atfork() handlers covering both the process-global code-allocation
 // state and the current ICodeAllocator, if one exists.
 void codeAllocatorAtForkPrepare();
@@ -5,6 +5,7 @@
 #include "cinderx/Common/define.h"
 #include "cinderx/Common/log.h"
 #include "cinderx/Common/util.h"
+#include "cinderx/Jit/code_allocator.h"
 
 #include <algorithm>
 #include <array>
@@ -120,6 +121,7 @@ std::span<const uint8_t> CodePatcher::storedBytes() const {
 
 void CodePatcher::swap() {
   SwapLockGuard lock{*this};
+  ScopedCodeWrite writable{patchpoint_, flags_.data_len};
 
   // On x86 the patchpoint is up to 7 bytes (aligned to 8 bytes by the code
   // generator). However, we work with 8 bytes here as that should be an
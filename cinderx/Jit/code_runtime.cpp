@@ -5,6 +5,9 @@
 #include "cinderx/Common/util.h"
 #include "cinderx/Jit/threaded_compile.h"
 
+#include <new>
+#include <utility>
+
 namespace cinderx::jit {
 
 GenYieldPoint::GenYieldPoint(std::size_t deopt_idx, ptrdiff_t yield_from_offset)
@@ -34,6 +37,14 @@ bool CodeRuntime::isGen() const {
   return code()->co_flags & kCoFlagsAnyGenerator;
 }
 
+bool CodeRuntime::isFrameless() const {
+  return frameless_;
+}
+
+void CodeRuntime::setFrameless(bool frameless) {
+  frameless_ = frameless;
+}
+
 BorrowedRef<PyCodeObject> CodeRuntime::code() const {
   return code_;
 }
@@ -102,16 +113,57 @@ std::size_t CodeRuntime::addRawDeoptMetadata(DeoptMetadata&& deopt_meta) {
   return deopt_metadatas_.size() - 1;
 }
 
-DeoptMetadata& CodeRuntime::getDeoptMetadata(std::size_t id) {
+DeoptMetadata& CodeRuntime::mutableDeoptMetadata(std::size_t id) {
+  JIT_CHECK(
+      compact_deopt_metadatas_ == nullptr,
+      "Deopt metadata can't be modified after it has been compacted");
   return deopt_metadatas_[id];
 }
 
 const DeoptMetadata& CodeRuntime::getDeoptMetadata(std::size_t id) const {
+  if (compact_deopt_metadatas_ != nullptr) {
+    return compact_deopt_metadatas_->get(id);
+  }
   return deopt_metadatas_[id];
 }
 
-const std::vector<DeoptMetadata>& CodeRuntime::deoptMetadatas() const {
-  return deopt_metadatas_;
+std::size_t CodeRuntime::numDeoptMetadatas() const {
+  if (compact_deopt_metadatas_ != nullptr) {
+    return compact_deopt_metadatas_->size();
+  }
+  return deopt_metadatas_.size();
+}
+
+void CodeRuntime::compactDeoptMetadata() {
+  JIT_CHECK(
+      compact_deopt_metadatas_ == nullptr,
+      "Deopt metadata has already been compacted");
+  compact_deopt_metadatas_ =
+      std::make_unique<DeoptMetadataTable>(deopt_metadatas_);
+  std::vector<DeoptMetadata>{}.swap(deopt_metadatas_);
+}
+
+std::size_t CodeRuntime::deoptMetadataBytes() const {
+  if (compact_deopt_metadatas_ != nullptr) {
+    return compact_deopt_metadatas_->encodedBytes() +
+        compact_deopt_metadatas_->decodedBytes();
+  }
+  std::size_t bytes = 0;
+  for (const DeoptMetadata& meta : deopt_metadatas_) {
+    bytes += jit::deoptMetadataBytes(meta);
+  }
+  return bytes;
+}
+
+void CodeRuntime::moveMetadataTo(std::shared_ptr<HugePageArena> arena) {
+  if (metadata_arena_ != nullptr) {
+    return;
+  }
+  if (compact_deopt_metadatas_ != nullptr) {
+    compact_deopt_metadatas_->moveTo(*arena);
+  }
+  debug_info_.moveTo(*arena);
+  metadata_arena_ = std::move(arena);
 }
 
 int CodeRuntime::frameSize() const {
@@ -142,6 +194,19 @@ DebugInfo* CodeRuntime::debugInfo() {
   return &debug_info_;
 }
 
+ExecutionCounters& CodeRuntime::executionCounters() {
+  return placed_execution_counters_ != nullptr ? *placed_execution_counters_
+                                               : execution_counters_;
+}
+
+void CodeRuntime::placeExecutionCounters(
+    std::shared_ptr<HugePageArena> arena) {
+  void* mem =
+      arena->allocate(sizeof(ExecutionCounters), alignof(ExecutionCounters));
+  placed_execution_counters_ = new (mem) ExecutionCounters{execution_counters_};
+  counters_arena_ = std::move(arena);
+}
+
 void** CodeRuntime::allocateTypeCheckJumpTable(size_t num_entries) {
   type_check_jump_table_ = std::make_unique<void*[]>(num_entries);
   return type_check_jump_table_.get();
@@ -6,10 +6,12 @@
 #include "cinderx/Common/util.h"
 #include "cinderx/Jit/debug_info.h"
 #include "cinderx/Jit/deopt.h"
+#include "cinderx/Jit/deopt_encoding.h"
 #include "cinderx/Jit/threaded_compile.h"
 
 #include <deque>
 #include <limits>
+#include <memory>
 #include <optional>
 #include <unordered_map>
 #include <unordered_set>
@@ -44,6 +46,17 @@ class GenYieldPoint {
   const ptrdiff_t yield_from_offset_;
 };
 
+// Counts of how often a compiled function ran, incremented directly by its
+// compiled code when Config::execution_counters is set.  The increments aren't
+// atomic, so in free-threaded builds the counts are approximate.
+struct ExecutionCounters {
+  // Number of times the function was entered.
+  uint64_t calls{0};
+  // Number of times a loop header was executed.  Only counted when
+  // Config::loop_counters is also set.
+  uint64_t loop_iterations{0};
+};
+
 // Runtime data for a PyCodeObject object, containing caches and any other data
 // associated with a JIT-compiled function.
 class alignas(16) CodeRuntime {
@@ -73,16 +86,37 @@ class alignas(16) CodeRuntime {
   // instruction-based dedup cache.
   std::size_t addRawDeoptMetadata(DeoptMetadata&& deopt_meta);
 
-  // Get a reference to the DeoptMetadata with the given ID.
-  DeoptMetadata& getDeoptMetadata(std::size_t id);
+  // Get a mutable reference to the DeoptMetadata with the given ID, for filling
+  // it in during code generation.  Not available once the metadata has been
+  // compacted.
+  DeoptMetadata& mutableDeoptMetadata(std::size_t id);
+
+  // Get a reference to the DeoptMetadata with the given ID.  After compaction
+  // this decodes the entry the first time it is asked for.
   const DeoptMetadata& getDeoptMetadata(std::size_t id) const;
 
-  // Get all deopt metadatas for the given CodeRuntime.
-  const std::vector<DeoptMetadata>& deoptMetadatas() const;
+  // Number of deopt metadatas for this CodeRuntime.
+  std::size_t numDeoptMetadatas() const;
+
+  // Replace the deopt metadata with its compact encoding.  Called once code
+  // generation has finished filling it in.
+  void compactDeoptMetadata();
+
+  // Bytes used to hold deopt metadata, including any decoded entries.
+  std::size_t deoptMetadataBytes() const;
+
+  // Move the compacted deopt metadata and the debug info, which are only read
+  // once code generation is done, into `arena`.
+  void moveMetadataTo(std::shared_ptr<HugePageArena> arena);
 
   // Check if this is a generator/coroutine/async generator.
   bool isGen() const;
 
+  // Whether the compiled code runs without linking its interpreter frame, in
+  // which case the frame has to be linked before it can be deopted.
+  bool isFrameless() const;
+  void setFrameless(bool frameless);
+
   BorrowedRef<PyCodeObject> code() const;
   BorrowedRef<PyDictObject> builtins() const;
   BorrowedRef<PyDictObject> globals() const;
@@ -103,6 +137,14 @@ class alignas(16) CodeRuntime {
 
   DebugInfo* debugInfo();
 
+  // Counters updated by the compiled code.  Lives as long as the CodeRuntime,
+  // so the code can embed its address.
+  ExecutionCounters& executionCounters();
+
+  // Keep the execution counters in `arena` rather than in the CodeRuntime
+  // itself.  Must be called before any code using them is generated.
+  void placeExecutionCounters(std::shared_ptr<HugePageArena> arena);
+
   // Allocate a jump table for static type check dispatch.
   // Returns a pointer to the table data (valid for the lifetime of this
   // CodeRuntime).
@@ -138,9 +180,12 @@ class alignas(16) CodeRuntime {
   std::deque<GenYieldPoint> gen_yield_points_;
 
   // Metadata about deopt points.  Safe to use a vector as these are always
-  // accessed by index.
+  // accessed by index.  Emptied by compactDeoptMetadata().
   std::vector<DeoptMetadata> deopt_metadatas_;
 
+  // Compact form of deopt_metadatas_, set once code generation is done.
+  std::unique_ptr<DeoptMetadataTable> compact_deopt_metadatas_;
+
 #if PY_VERSION_HEX >= 0x030E0000 && defined(ENABLE_LIGHTWEIGHT_FRAMES)
   Ref<> reifier_;
 #endif
@@ -161,7 +206,15 @@ class alignas(16) CodeRuntime {
 
   int frame_size_{-1};
   uint32_t spill_words_{0};
+  bool frameless_{false};
   DebugInfo debug_info_;
+  ExecutionCounters execution_counters_;
+  // Set when the counters live in an arena instead of execution_counters_.
+  ExecutionCounters* placed_execution_counters_{nullptr};
+
+  // Arenas holding parts of this CodeRuntime, kept alive for as long as it is.
+  std::shared_ptr<HugePageArena> metadata_arena_;
+  std::shared_ptr<HugePageArena> counters_arena_;
 };
 
 } // namespace cinderx::jit
@@ -9,6 +9,7 @@
 #include "cinderx/Jit/codegen/arch.h"
 #include "cinderx/Jit/codegen/gen_asm_utils.h"
 #include "cinderx/Jit/codegen/tsan.h"
+#include "cinderx/Jit/direct_call_patcher.h"
 #include "cinderx/Jit/frame.h"
 #include "cinderx/Jit/generators_rt.h"
 #include "cinderx/Jit/hir/hir.h"
@@ -251,7 +252,7 @@ void fillLiveValueLocations(
     const Instruction* instr,
     size_t begin_input,
     size_t end_input) {
-  DeoptMetadata& deopt_meta = code_runtime->getDeoptMetadata(deopt_idx);
+  DeoptMetadata& deopt_meta = code_runtime->mutableDeoptMetadata(deopt_idx);
   for (size_t i = begin_input; i < end_input; i++) {
     auto loc = instr->getInput(i)->getPhyRegOrStackSlot();
     JIT_THROW_IF(
@@ -288,7 +289,7 @@ void fillCallSiteLiveValueLocations(Environ* env, const Instruction* instr) {
       metadata.live_values_instr != nullptr,
       "Missing callsite live-value instruction");
   DeoptMetadata& deopt_meta =
-      env->code_rt->getDeoptMetadata(metadata.deopt_meta_index);
+      env->code_rt->mutableDeoptMetadata(metadata.deopt_meta_index);
   JIT_CHECK(
       deopt_meta.live_values.size() ==
           metadata.live_values_instr->getNumInputs(),
@@ -524,6 +525,72 @@ void TranslateDeoptPatchpoint(Environ* env, const Instruction* instr) {
       patcher, patchpoint_label, deopt_label);
 }
 
+#if defined(CINDER_X86_64)
+// Emit the patchable call for a DirectVectorCall or DirectStaticCall.  The call
+// starts out going to fallback, and is retargeted at the callee's compiled code
+// by the runtime.
+void emitDirectCall(
+    Environ* env,
+    const Instruction* instr,
+    DirectCallPatcher* patcher,
+    asmjit::Label fallback) {
+  auto as = env->as;
+
+  // Like deopt patchpoints, the call is aligned so the rel32 can be swapped
+  // atomically.
+  if constexpr (kFreeThreadedBuild) {
+    as->align(AlignMode::kCode, 8);
+  }
+  auto patchpoint_label = as->newLabel();
+  as->bind(patchpoint_label);
+  as->call(fallback);
+
+  asmjit::Label label = as->newLabel();
+  as->bind(label);
+  if (instr->origin()) {
+    env->pending_debug_locs.emplace_back(label, instr->origin());
+  }
+  fillCallSiteLiveValueLocations(env, instr);
+
+  env->pending_direct_calls.emplace_back(patcher, patchpoint_label);
+}
+#endif
+
+void TranslateDirectVectorCall(Environ* env, const Instruction* instr) {
+#if defined(CINDER_X86_64)
+  auto patcher =
+      reinterpret_cast<DirectCallPatcher*>(instr->getInput(0)->getConstant());
+
+  // All DirectVectorCalls share one fallback stub.
+  if (!env->direct_call_fallback.isValid()) {
+    env->direct_call_fallback = env->as->newLabel();
+  }
+  emitDirectCall(env, instr, patcher, env->direct_call_fallback);
+#else
+  JIT_ABORT("DirectVectorCall is only supported on x86-64");
+#endif
+}
+
+void TranslateDirectStaticCall(Environ* env, const Instruction* instr) {
+#if defined(CINDER_X86_64)
+  auto patcher =
+      reinterpret_cast<DirectCallPatcher*>(instr->getInput(0)->getConstant());
+
+  // Each callee has its own fallback stub, jumping through its entry cache.
+  auto it = env->static_call_fallbacks.find(patcher->callee());
+  JIT_CHECK(
+      it != env->static_call_fallbacks.end(),
+      "DirectStaticCall to a function without an entry cache");
+  asmjit::Label& stub = it->second.stub;
+  if (!stub.isValid()) {
+    stub = env->as->newLabel();
+  }
+  emitDirectCall(env, instr, patcher, stub);
+#else
+  JIT_ABORT("DirectStaticCall is only supported on x86-64");
+#endif
+}
+
 void TranslateCompare(Environ* env, const Instruction* instr) {
 #if defined(CINDER_X86_64)
   auto as = env->as;
@@ -2835,6 +2902,12 @@ void AutoTranslator::translateInstr(Environ* env, const Instruction* instr)
     case Opcode::kDeoptPatchpoint:
       TranslateDeoptPatchpoint(env, instr);
       return;
+    case Opcode::kDirectStaticCall:
+      TranslateDirectStaticCall(env, instr);
+      return;
+    case Opcode::kDirectVectorCall:
+      TranslateDirectVectorCall(env, instr);
+      return;
     case Opcode::kLoadThreadState:
       translateLoadThreadState(env, instr);
       return;
@@ -3264,6 +3337,12 @@ void AutoTranslator::translateInstr(Environ* env, const Instruction* instr)
     case Opcode::kDeoptPatchpoint:
       TranslateDeoptPatchpoint(env, instr);
       return;
+    case Opcode::kDirectStaticCall:
+      TranslateDirectStaticCall(env, instr);
+      return;
+    case Opcode::kDirectVectorCall:
+      TranslateDirectVectorCall(env, instr);
+      return;
     case Opcode::kLoadThreadState:
       translateLoadThreadState(env, instr);
       return;
@@ -94,6 +94,32 @@ struct Environ {
   };
   std::vector<PendingDeoptPatcher> pending_deopt_patchers;
 
+  struct PendingDirectCall {
+    PendingDirectCall(DirectCallPatcher* p, asmjit::Label pp)
+        : patcher(p), patchpoint(pp) {}
+    DirectCallPatcher* patcher;
+
+    // Location of the call instruction
+    asmjit::Label patchpoint;
+  };
+  std::vector<PendingDirectCall> pending_direct_calls;
+
+  // Out-of-line stub that DirectVectorCall sites call until they are patched.
+  // Only bound if the function has any of them.
+  asmjit::Label direct_call_fallback;
+
+  // Out-of-line stubs that DirectStaticCall sites call until they are patched,
+  // one per callee.  Each jumps through the callee's function entry cache.
+  struct StaticCallFallback {
+    explicit StaticCallFallback(void** cache) : entry_cache(cache) {}
+
+    void** entry_cache;
+
+    // Only bound if a call site was emitted for the callee.
+    asmjit::Label stub;
+  };
+  UnorderedMap<PyFunctionObject*, StaticCallFallback> static_call_fallbacks;
+
   std::vector<PendingDebugLoc> pending_debug_locs;
 
   // Call return-address -> post-call guard deopt-exit pairings, resolved to
@@ -260,6 +286,10 @@ struct Environ {
   // cheaper inline frame unlink at exit.
   bool can_deopt{true};
 
+  // True if the function doesn't link an interpreter frame on entry.  Its
+  // frame is only filled in and linked when it deopts.
+  bool frameless{false};
+
   // True if the function being compiled is a generator or coroutine.
   bool is_generator{false};
 
@@ -24,12 +24,14 @@
 #include "cinderx/Jit/generators_rt.h"
 #include "cinderx/Jit/hir/analysis.h"
 #include "cinderx/Jit/hir/hir.h"
+#include "cinderx/Jit/hir/instr_effects.h"
 #include "cinderx/Jit/hir/printer.h"
 #include "cinderx/Jit/jit_gdb_support.h"
 #include "cinderx/Jit/jit_rt.h"
 #include "cinderx/Jit/lir/dce.h"
 #include "cinderx/Jit/lir/generator.h"
 #include "cinderx/Jit/lir/linear_scan.h"
+#include "cinderx/Jit/lir/load_elim.h"
 #include "cinderx/Jit/lir/postalloc.h"
 #include "cinderx/Jit/lir/postgen.h"
 #include "cinderx/Jit/lir/printer.h"
@@ -38,6 +40,7 @@
 #include "cinderx/Jit/lir/target_select.h"
 #include "cinderx/Jit/lir/verify.h"
 #include "cinderx/Jit/perf_jitdump.h"
+#include "cinderx/Jit/pyjit.h"
 #include "cinderx/UpstreamBorrow/borrowed.h"
 
 #include <fmt/format.h>
@@ -146,6 +149,66 @@ void raiseAttributeError(BorrowedRef<> receiver, BorrowedRef<> name) {
       name);
 }
 
+// Whether a function can run without linking its interpreter frame.  Nothing
+// may look at the frame while the function runs, so it can't call anything that
+// might walk the stack, and it can't have inlined functions or cells, whose
+// frames and storage hang off of its own.  Deopting and raising are fine, as
+// the deopt path links the frame first.
+//
+// Free-threaded builds always link the frame, as that's how the GC finds the
+// deferred references held by the function.
+bool canRunFrameless([[maybe_unused]] const hir::Function* func) {
+#if defined(ENABLE_LIGHTWEIGHT_FRAMES) && !defined(Py_GIL_DISABLED)
+  if (!getConfig().frameless_leaf_functions) {
+    return false;
+  }
+  BorrowedRef<PyCodeObject> code = func->code;
+  if ((code->co_flags & kCoFlagsAnyGenerator) || code->co_ncellvars > 0 ||
+      code->co_nfreevars > 0) {
+    return false;
+  }
+  for (const hir::BasicBlock& block : func->cfg.blocks) {
+    for (const hir::Instr& instr : block) {
+      if (hir::hasArbitraryExecution(instr) ||
+          instr.isBeginInlinedFunction() || instr.isUpdatePrevInstr()) {
+        return false;
+      }
+    }
+  }
+  return true;
+#else
+  return false;
+#endif
+}
+
+// Fill in and link the interpreter frame of a function that's running without
+// one, so it can be deopted like any other.  Its space is reserved on the
+// stack like it always is, and the prologue stashes the function in it.
+void linkFramelessFrame(
+    PyThreadState* tstate,
+    const uint64_t* regs,
+    CodeRuntime* code_runtime) {
+  BorrowedRef<PyCodeObject> code = code_runtime->code();
+  uint64_t frame_pointer = regs[arch::reg_frame_pointer_loc.loc];
+  auto frame = reinterpret_cast<_PyInterpreterFrame*>(
+      frame_pointer - frameHeaderSize(code) + kFrameHeaderOverhead);
+  auto func = *reinterpret_cast<PyFunctionObject**>(&frame->f_funcobj);
+  jitFrameInit(
+      tstate,
+      frame,
+      func,
+      code,
+      0,
+      FRAME_OWNED_BY_THREAD,
+      currentFrame(tstate),
+      code_runtime->reifier());
+  // jitFrameInit() takes a reference to the function for generator frames.
+  // Other frames borrow it, and get their own reference when they're copied
+  // off of the stack.
+  Py_DECREF(func);
+  setCurrentFrame(tstate, frame);
+}
+
 // Helper to recursively reify the lightweight frames. We need to reify the
 // outermost lightweight frame first and work inwards to have the frames
 // allocated correctly on the slab. We then need to update the inner functions
@@ -185,6 +248,9 @@ uintptr_t prepareForDeopt(
   const DeoptMetadata& deopt_meta = code_runtime->getDeoptMetadata(deopt_idx);
   PyThreadState* tstate = _PyThreadState_UncheckedGet();
   bool is_instrumentation_deopt = false;
+  if (code_runtime->isFrameless()) {
+    linkFramelessFrame(tstate, regs, code_runtime);
+  }
   _PyInterpreterFrame* frame = interpFrameFromThreadState(tstate);
 
   // Check JIT_FRAME_DEOPT_PATCHED on the outermost frame's header before
@@ -271,6 +337,17 @@ uintptr_t prepareForDeopt(
     switch (reason) {
       case DeoptReason::kGuardFailure: {
         ctx->guardFailed(deopt_meta);
+        if (deopt_meta.descr != nullptr &&
+            deopt_meta.descr == kPinnedAttrGuardDescr) {
+          const DeoptFrameMetadata& pin_frame = deopt_meta.innermostFrame();
+          ctx->recordFailedPin(pin_frame.code, pin_frame.cause_instr_idx);
+          _PyInterpreterFrame* outer = frame;
+          for (size_t i = 0; i < deopt_meta.inline_depth(); i++) {
+            outer = outer->previous;
+          }
+          pinnedAttrRebound(
+              reinterpret_cast<PyFunctionObject*>(frameFunction(outer)));
+        }
         break;
       }
       case DeoptReason::kRaise:
@@ -793,6 +870,20 @@ void* NativeGenerator::getVectorcallEntry() {
     env_.addReference(ref);
   }
 
+  env_.frameless = canRunFrameless(func);
+  env_.code_rt->setFrameless(env_.frameless);
+
+  // During a prefork freeze, keep the state that compiled code writes to
+  // packed together, away from the pages shared with forked children.
+  if (std::shared_ptr<HugePageArena> arena =
+          cinderx::getModuleState()->preforkStateArena()) {
+    env_.code_rt->placeExecutionCounters(arena);
+#ifndef ENABLE_PREFORK_MODEL
+    env_.inline_cache_storage_ =
+        std::make_unique<PerCompilationInlineCacheStorage>(std::move(arena));
+#endif
+  }
+
   lir::LIRGenerator lirgen(getFunction(), &env_);
   std::unique_ptr<lir::Function> lir_func;
 
@@ -832,6 +923,13 @@ void* NativeGenerator::getVectorcallEntry() {
       "DeadCodeElimination",
       eliminateDeadCode(lir_func.get()))
 
+  if (getConfig().lir_opts.redundant_load_elim) {
+    COMPILE_TIMER(
+        getFunction()->compilation_phase_timer,
+        "Redundant Load Elimination",
+        eliminateRedundantLoads(lir_func.get()))
+  }
+
   COMPILE_TIMER(
       getFunction()->compilation_phase_timer,
       "Target Selection and Legalization",
@@ -870,6 +968,7 @@ void* NativeGenerator::getVectorcallEntry() {
 
   env_.shadow_frames_and_spill_size = allocator->getFrameSize();
   env_.changed_regs = allocator->getChangedRegs();
+  spill_counts_ = allocator->getSpillCounts();
   env_.exit_label = as_->newLabel();
   env_.can_deopt = getFunction()->canDeopt();
 
@@ -965,6 +1064,10 @@ int NativeGenerator::getCompiledFunctionSpillStackSize() const {
   return spill_stack_size_;
 }
 
+lir::SpillCounts NativeGenerator::getCompiledFunctionSpillCounts() const {
+  return spill_counts_;
+}
+
 void NativeGenerator::generateFunctionEntry() {
 #if defined(CINDER_X86_64)
   as_->push(x86::rbp);
@@ -1066,9 +1169,19 @@ void NativeGenerator::linkDeoptPatchers(const asmjit::CodeHolder& code) {
     // Register patcher with the runtime if it is type-based.
     if (auto typed_patcher = dynamic_cast<TypeDeoptPatcher*>(udp.patcher)) {
       env_.ctx->watchType(typed_patcher->type(), typed_patcher);
+    } else if (
+        auto override_patcher =
+            dynamic_cast<MethodOverrideDeoptPatcher*>(udp.patcher)) {
+      env_.ctx->watchMethodOverride(override_patcher);
     }
   }
 
+  for (const auto& pending : env_.pending_direct_calls) {
+    uint64_t patchpoint = base + code.labelOffsetFromBase(pending.patchpoint);
+    pending.patcher->linkCall(patchpoint);
+    env_.ctx->watchDirectCall(pending.patcher);
+  }
+
   // Any patchers that aren't linked at this point are pointing to patch points
   // that were optimized out.  It's safe to delete them.
   std::erase_if(
@@ -1384,6 +1497,34 @@ void NativeGenerator::generateCode(
     generateFunctionExit();
   }
 
+#if defined(CINDER_X86_64)
+  // Fallback for direct calls that aren't currently patched to call the
+  // callee's compiled code.  The arguments are all in place for a vectorcall,
+  // so tail call through the callee's vectorcall pointer.
+  if (env_.direct_call_fallback.isValid()) {
+    auto fallback_cursor = as_->cursor();
+    as_->bind(env_.direct_call_fallback);
+    as_->jmp(
+        x86::qword_ptr(
+            get_arg_location(0), offsetof(PyFunctionObject, vectorcall)));
+    env_.addAnnotation("Direct call fallback stub", fallback_cursor);
+  }
+
+  // Same for direct static calls, whose arguments are in place for the static
+  // entry.  Tail call through the callee's function entry cache.  rax isn't
+  // used to pass arguments so it's free to hold the cache's address.
+  for (auto& [callee, fallback] : env_.static_call_fallbacks) {
+    if (!fallback.stub.isValid()) {
+      continue;
+    }
+    auto fallback_cursor = as_->cursor();
+    as_->bind(fallback.stub);
+    as_->mov(x86::rax, reinterpret_cast<uint64_t>(fallback.entry_cache));
+    as_->jmp(x86::qword_ptr(x86::rax));
+    env_.addAnnotation("Direct static call fallback stub", fallback_cursor);
+  }
+#endif
+
 #if defined(CINDER_AARCH64)
   // Emit constant pool data for MovConstPool instructions. Each entry is an
   // 8-byte value loaded via PC-relative ldr.
@@ -1476,9 +1617,19 @@ void NativeGenerator::generateCode(
       getFunction()->fullname,
       env_.annotations.disassemble(code_start_, codeholder));
   {
+    JITCompilationLock lock;
     for (auto& x : env_.function_indirections) {
       *x.second.indirect = factory_.failedDeferredCompileTrampoline();
     }
+    // Direct static call sites go through their callee's entry cache until
+    // they're patched.  Point it at the static entry of callees that are
+    // already compiled; the rest fill it in when they're finalized.
+    for (auto& [callee, fallback] : env_.static_call_fallbacks) {
+      if (isJitCompiled(callee)) {
+        *fallback.entry_cache = reinterpret_cast<void*>(
+            JITRT_GET_STATIC_ENTRY(callee->vectorcall));
+      }
+    }
   }
 
   const hir::Function* func = getFunction();
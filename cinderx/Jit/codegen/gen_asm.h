@@ -12,6 +12,7 @@
 #include "cinderx/Jit/codegen/environ.h"
 #include "cinderx/Jit/hir/hir.h"
 #include "cinderx/Jit/lir/function.h"
+#include "cinderx/Jit/lir/regalloc.h"
 
 #include <asmjit/asmjit.h>
 
@@ -66,6 +67,7 @@ class NativeGenerator {
 
   int getCompiledFunctionStackSize() const;
   int getCompiledFunctionSpillStackSize() const;
+  lir::SpillCounts getCompiledFunctionSpillCounts() const;
   const hir::Function* getFunction() const {
     return func_;
   }
@@ -100,6 +102,7 @@ class NativeGenerator {
 
   size_t compiled_size_{0};
   int spill_stack_size_{-1};
+  lir::SpillCounts spill_counts_;
   int inline_stack_size_;
 
   bool hasStaticEntry() const;
@@ -252,6 +252,36 @@ int CompiledFunction::spillStackSize() const {
   return data_->spill_stack_size;
 }
 
+lir::SpillCounts CompiledFunction::spillCounts() const {
+  return data_->spill_counts;
+}
+
+DirectCallCounts CompiledFunction::directCallCounts() const {
+  DirectCallCounts counts;
+  for (const auto& patcher : data_->code_patchers) {
+    if (dynamic_cast<const DirectCallPatcher*>(patcher.get()) != nullptr) {
+      counts.sites++;
+      counts.patched += patcher->isPatched();
+    }
+  }
+  return counts;
+}
+
+CompiledFunctionMemoryStats CompiledFunction::memoryStats() const {
+  CompiledFunctionMemoryStats stats;
+  stats.code = codeSize();
+  if (CodeRuntime* code_runtime = data_->runtime; code_runtime != nullptr) {
+    stats.deopt_metadata = code_runtime->deoptMetadataBytes();
+    stats.debug_info = code_runtime->debugInfo()->memoryBytes();
+  }
+#ifndef ENABLE_PREFORK_MODEL
+  if (data_->inline_cache_storage != nullptr) {
+    stats.inline_caches = data_->inline_cache_storage->allocatedBytes();
+  }
+#endif
+  return stats;
+}
+
 const hir::Function::InlineFunctionStats&
 CompiledFunction::inlinedFunctionsStats() const {
   return data_->inline_function_stats;
@@ -563,6 +593,14 @@ void CompiledFunction::clear(bool context_finalizing) {
         if (auto typed_patcher =
                 dynamic_cast<TypeDeoptPatcher*>(patcher.get())) {
           owner_->unwatch(typed_patcher);
+        } else if (
+            auto override_patcher =
+                dynamic_cast<MethodOverrideDeoptPatcher*>(patcher.get())) {
+          owner_->unwatch(override_patcher);
+        } else if (
+            auto call_patcher =
+                dynamic_cast<DirectCallPatcher*>(patcher.get())) {
+          owner_->unwatch(call_patcher);
         }
       }
     }
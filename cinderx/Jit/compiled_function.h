@@ -71,8 +71,10 @@ bool isJitCompiled(const PyFunctionObject* func);
 #include "cinderx/Common/util.h"
 #include "cinderx/Jit/code_patcher.h"
 #include "cinderx/Jit/code_runtime.h"
+#include "cinderx/Jit/direct_call_patcher.h"
 #include "cinderx/Jit/hir/function.h"
 #include "cinderx/Jit/inline_cache_storage.h"
+#include "cinderx/Jit/lir/regalloc.h"
 
 #include <chrono>
 #include <cstddef>
@@ -104,6 +106,8 @@ struct CompiledFunctionData {
   int stack_size{0};
   // The amount of stack used for spilled values.
   int spill_stack_size{0};
+  // Spill code inserted by the register allocator.
+  lir::SpillCounts spill_counts;
   // Time taken to compile this code object.  Doesn't include preloading time.
   std::chrono::nanoseconds compile_time{};
   // Stats about the functions inlined into this code object.
@@ -127,6 +131,29 @@ struct CompiledFunctionData {
   CompiledFunctionData() = default;
 };
 
+// Bytes of memory held on behalf of a single compiled function, by kind.
+struct CompiledFunctionMemoryStats {
+  // Generated machine code.
+  size_t code{0};
+  // Deopt metadata, both the compact encoding and any entries decoded from it.
+  size_t deopt_metadata{0};
+  // Inline caches owned by the function.  Always 0 in the prefork model, where
+  // inline caches are shared across functions.
+  size_t inline_caches{0};
+  // Location information mapping machine code back to bytecode.
+  size_t debug_info{0};
+};
+
+// Call sites in a single compiled function that call a known function
+// directly.
+struct DirectCallCounts {
+  // Call sites emitted as direct calls.
+  size_t sites{0};
+  // Call sites currently calling their callee's compiled code, rather than
+  // their fallback.
+  size_t patched{0};
+};
+
 // The key used to store the CompiledFunction in a function's __dict__.
 extern PyObject* kCompiledFunctionKey;
 // The key used to store nested compiled functions in a function's __dict__.
@@ -151,6 +178,12 @@ class CompiledFunctionOwner {
   // Python type itself is left watched for any other patchers.
   virtual void unwatch(TypeDeoptPatcher* patcher) = 0;
 
+  // Unwatch a single MethodOverrideDeoptPatcher from a CompiledFunction.
+  virtual void unwatch(MethodOverrideDeoptPatcher* patcher) = 0;
+
+  // Unwatch a single DirectCallPatcher from a CompiledFunction.
+  virtual void unwatch(DirectCallPatcher* patcher) = 0;
+
   // Hand off a CompiledFunctionData for deferred destruction instead of freeing
   // it inline, since the machine code may still be executing on some thread's
   // stack.  The (code, builtins, globals) triple keys the deferred entry and
@@ -209,6 +242,14 @@ class CompiledFunction {
   // Stack size used for spilled values.
   int spillStackSize() const;
 
+  // Spills, reloads, and rematerializations inserted by register allocation.
+  lir::SpillCounts spillCounts() const;
+
+  // Breakdown of the memory used by this function.
+  CompiledFunctionMemoryStats memoryStats() const;
+
+  DirectCallCounts directCallCounts() const;
+
   std::chrono::nanoseconds compileTime() const;
   void setCompileTime(std::chrono::nanoseconds time);
 
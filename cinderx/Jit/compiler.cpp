@@ -222,6 +222,7 @@ std::optional<CompiledFunctionData> Compiler::compile(
     return std::nullopt;
   }
   JIT_DLOG("Compiling {}", fullname);
+  CompileTraceScope compile_trace{"Compile", fullname};
 
   std::unique_ptr<CompilationPhaseTimer> compilation_phase_timer{nullptr};
 
@@ -232,7 +233,11 @@ std::optional<CompiledFunctionData> Compiler::compile(
   }
 
   Timer timer;
-  std::unique_ptr<hir::Function> irfunc(hir::buildHIR(preloader));
+  std::unique_ptr<hir::Function> irfunc;
+  {
+    CompileTraceScope build_trace{"Lowering into HIR"};
+    irfunc = hir::buildHIR(preloader);
+  }
 
   if (nullptr != compilation_phase_timer) {
     compilation_phase_timer->end();
@@ -278,6 +283,10 @@ std::optional<CompiledFunctionData> Compiler::compile(
     code_runtime->transferReferences(irfunc->env.stealStrongReferences());
   }
 
+  // Code generation has filled in all the live value locations, so the deopt
+  // metadata won't change anymore.
+  ngen->codeRuntime()->compactDeoptMetadata();
+
   auto compile_time =
       std::chrono::duration_cast<std::chrono::microseconds>(timer.finish());
 
@@ -306,6 +315,7 @@ std::optional<CompiledFunctionData> Compiler::compile(
   compiled_data.vectorcall_entry = entry;
   compiled_data.stack_size = stack_size;
   compiled_data.spill_stack_size = spill_stack_size;
+  compiled_data.spill_counts = ngen->getCompiledFunctionSpillCounts();
   compiled_data.inline_function_stats = std::move(inline_stats);
   compiled_data.hir_opcode_counts = hir_opcode_counts;
   compiled_data.runtime = code_runtime;
@@ -321,4 +331,8 @@ std::optional<CompiledFunctionData> Compiler::compile(
   return compiled_data;
 }
 
+void* Compiler::failedDeferredCompileTrampoline() {
+  return ngen_factory_.failedDeferredCompileTrampoline();
+}
+
 } // namespace cinderx::jit
@@ -71,6 +71,9 @@ class Compiler {
       PassConfig config,
       PostPassFunction callback);
 
+  // What a function entry cache holds while its function isn't compiled.
+  void* failedDeferredCompileTrampoline();
+
  private:
   DISALLOW_COPY_AND_ASSIGN(Compiler);
   codegen::NativeGeneratorFactory ngen_factory_;
@@ -4,6 +4,7 @@
 
 #include "cinderx/Common/define.h"
 
+#include <array>
 #include <cstddef>
 #include <cstdint>
 #include <optional>
@@ -49,6 +50,7 @@ struct HIROptimizations {
 // List of LIR optimization passes to run.
 struct LIROptimizations {
   bool inliner{true};
+  bool redundant_load_elim{true};
 };
 
 struct SimplifierConfig {
@@ -128,6 +130,35 @@ enum class RegAllocKind : uint8_t {
   kSpill,
 };
 
+// A size class of the pools JIT generators are allocated from.
+struct GenPoolSizeClass {
+  // Size in bytes of each entry, including the GC pre-header if there is one.
+  size_t size;
+  // Number of entries in the shared pool used with the GIL.
+  size_t capacity;
+  // Maximum number of free entries cached by each thread in free-threaded
+  // builds.
+  size_t thread_capacity;
+};
+
+// These values were determined experimentally on IG's webservers. The number
+// of outstanding requests seems to burst up to ~60k on startup but then quickly
+// settles down to around 1-2k, so 2048 entries should be enough. The average
+// size seems to be ~400 bytes with the max being about 10x that. Performance
+// experiments showed a single 512 byte class was a greater improvement than
+// 1024, presumably because the extra fixed memory wasn't worth it, so the
+// larger classes only get a few entries each to catch the tail.
+//
+// Other workloads will want other classes, which is what
+// cinderx.jit.suggest_generator_pool_classes() is for.
+inline constexpr std::array<GenPoolSizeClass, 5> kDefaultGenPoolSizeClasses{{
+    {256, 2048, 256},
+    {512, 2048, 256},
+    {1024, 256, 64},
+    {2048, 64, 16},
+    {4096, 32, 8},
+}};
+
 // Collection of configuration values for the JIT.
 //
 // Note: It's fine to store non-trivially destructible objects like std::string
@@ -153,9 +184,7 @@ struct Config {
   // the kernel can't place the allocation near the hint.
   bool hinted_code_allocation{false};
   // Use inline caches for attribute accesses.
-  //
-  // TODO(T250369692): FT support for inline-caches.
-  bool attr_caches{!kFreeThreadedBuild};
+  bool attr_caches{true};
   // Collect stats information about attribute caches.
   bool collect_attr_cache_stats{false};
   // Use inline caches for binary operations (currently the add variant only),
@@ -179,6 +208,21 @@ struct Config {
   //
   // TASK(T195042385): Replace this with actual typing.
   bool refine_static_python{true};
+  // Call Static Python methods directly, instead of through the vtable, when
+  // the class hierarchy has no overrides of them.  Guarded by a patchpoint
+  // which deopts if an override shows up later.
+  bool devirtualize_static_methods{true};
+  // Don't link an interpreter frame for leaf functions that can't run code that
+  // would look at it.  The frame is only filled in and linked if the function
+  // deopts or raises.
+  bool frameless_leaf_functions{true};
+  // Have compiled code count how many times it's called, in its CodeRuntime's
+  // ExecutionCounters.  Only affects functions compiled while it's set.
+  bool execution_counters{false};
+  // With execution_counters, also count loop iterations.
+  bool loop_counters{false};
+  // File to write a Chrome trace of the compile pipeline to at shutdown.
+  std::string compile_trace_file;
   HIROptimizations hir_opts;
   LIROptimizations lir_opts;
   SimplifierConfig simplifier;
@@ -225,9 +269,16 @@ struct Config {
   // Size (in number of entries) of the LoadAttrCached and StoreAttrCached
   // inline caches used by the JIT.
   uint32_t attr_cache_size{4};
+  // Size classes of the pools JIT generators are allocated from, in increasing
+  // order of size.  Only read when the JIT is initialized.
+  std::vector<GenPoolSizeClass> gen_pool_classes{
+      kDefaultGenPoolSizeClasses.begin(),
+      kDefaultGenPoolSizeClasses.end()};
   std::optional<uint32_t> compile_after_n_calls;
   GdbOptions gdb;
   JitListOptions jit_list;
+  // Name of the hot-function manifest file loaded at startup, if any.
+  std::string hot_manifest_file;
   LogOptions log;
   bool compile_perf_trampoline_prefork{false};
   bool dump_hir_stats{false};
@@ -7,6 +7,7 @@
 #include "internal/pycore_pystate.h"
 
 #include "cinderx/Common/dict.h"
+#include "cinderx/Common/extra-py-flags.h"
 #include "cinderx/Common/log.h"
 #include "cinderx/Common/py-portability.h"
 #include "cinderx/Jit/compilation_lock.h"
@@ -77,6 +78,23 @@ void collectAndClearInlineCacheStats(
 }
 #endif
 
+// The entry point of compiled that patcher's call site should call, or nullptr
+// if there's no compiled code to call.
+const void* directCallEntry(
+    const DirectCallPatcher* patcher,
+    const CompiledFunction* compiled) {
+  if (compiled == nullptr) {
+    return nullptr;
+  }
+  switch (patcher->entry()) {
+    case DirectCallPatcher::Entry::kVectorcall:
+      return reinterpret_cast<const void*>(compiled->vectorcallEntry());
+    case DirectCallPatcher::Entry::kStatic:
+      return compiled->staticEntry();
+  }
+  JIT_ABORT("Unknown direct call entry");
+}
+
 } // namespace
 
 AotContext g_aot_ctx;
@@ -380,6 +398,24 @@ void Context::clearGuardFailureCallback() {
   guard_failure_callback_ = nullptr;
 }
 
+void Context::recordFailedPin(
+    BorrowedRef<PyCodeObject> code,
+    BCOffset bc_off) {
+  withLock(failed_pins_mutex_, [&]() { failed_pins_[code].insert(bc_off); });
+}
+
+bool Context::hasFailedPin(BorrowedRef<PyCodeObject> code, BCOffset bc_off)
+    const {
+  return withLock(failed_pins_mutex_, [&]() {
+    auto it = failed_pins_.find(code);
+    return it != failed_pins_.end() && it->second.contains(bc_off);
+  });
+}
+
+void Context::forgetFailedPins(BorrowedRef<PyCodeObject> code) {
+  withLock(failed_pins_mutex_, [&]() { failed_pins_.erase(code); });
+}
+
 void Context::releaseReferences() {
   for (auto& code_rt : code_runtimes_) {
     if (code_rt.isCleared()) {
@@ -388,6 +424,8 @@ void Context::releaseReferences() {
     code_rt.releaseReferences();
   }
   type_deopt_patchers_.clear();
+  method_override_patchers_.clear();
+  direct_call_patchers_.clear();
 }
 
 #ifdef ENABLE_PREFORK_MODEL
@@ -468,6 +506,135 @@ void Context::notifyTypeModified(
   }
 }
 
+void Context::watchMethodOverride(MethodOverrideDeoptPatcher* patcher) {
+  JITCompilationLock lock;
+  // Notifications are delivered under the compilation lock, so once we hold
+  // it a matching epoch means none arrived after the class hierarchy was
+  // checked.
+  if (patcher->epoch() != MethodOverrideDeoptPatcher::currentEpoch()) {
+    patcher->patch();
+    return;
+  }
+  method_override_patchers_[patcher->type()].emplace(patcher);
+}
+
+void Context::unwatch(MethodOverrideDeoptPatcher* patcher) {
+  JITCompilationLock lock;
+  auto it = method_override_patchers_.find(patcher->type());
+  if (it == method_override_patchers_.end()) {
+    return;
+  }
+  it->second.erase(patcher);
+  if (it->second.empty()) {
+    method_override_patchers_.erase(it);
+  }
+}
+
+void Context::watchDirectCall(DirectCallPatcher* patcher) {
+  JITCompilationLock lock;
+  BorrowedRef<PyFunctionObject> callee = patcher->callee();
+  direct_call_patchers_[callee].emplace(patcher);
+  auto it = compiled_funcs_.find(callee);
+  if (it != compiled_funcs_.end()) {
+    patcher->retarget(directCallEntry(patcher, it->second));
+  }
+}
+
+void Context::unwatch(DirectCallPatcher* patcher) {
+  JITCompilationLock lock;
+  auto it = direct_call_patchers_.find(patcher->callee());
+  if (it == direct_call_patchers_.end()) {
+    return;
+  }
+  it->second.erase(patcher);
+  if (it->second.empty()) {
+    direct_call_patchers_.erase(it);
+  }
+}
+
+void Context::retargetDirectCalls(
+    BorrowedRef<PyFunctionObject> func,
+    const CompiledFunction* compiled) {
+  auto it = direct_call_patchers_.find(func);
+  if (it == direct_call_patchers_.end()) {
+    return;
+  }
+  for (DirectCallPatcher* patcher : it->second) {
+    patcher->retarget(directCallEntry(patcher, compiled));
+  }
+}
+
+void Context::notifyMethodOverride(
+    BorrowedRef<PyTypeObject> type,
+    BorrowedRef<> name) {
+  JITCompilationLock lock;
+  MethodOverrideDeoptPatcher::bumpEpoch();
+  if (method_override_patchers_.empty()) {
+    return;
+  }
+
+  // The override is visible to instances of type and its subclasses, so it
+  // invalidates direct calls to methods declared on type or any of its bases.
+  BorrowedRef<PyTupleObject> mro{type->tp_mro};
+  if (mro == nullptr) {
+    return;
+  }
+  for (Py_ssize_t i = 0; i < PyTuple_GET_SIZE(mro); i++) {
+    BorrowedRef<PyTypeObject> base{PyTuple_GET_ITEM(mro, i)};
+    auto it = method_override_patchers_.find(base);
+    if (it == method_override_patchers_.end()) {
+      continue;
+    }
+    std::erase_if(it->second, [&](MethodOverrideDeoptPatcher* patcher) {
+      if (PyUnicode_Compare(patcher->name(), name) != 0) {
+        return false;
+      }
+      patcher->patch();
+      return true;
+    });
+    if (it->second.empty()) {
+      method_override_patchers_.erase(it);
+    }
+  }
+}
+
+void Context::notifySubclassAdded(BorrowedRef<PyTypeObject> type) {
+  JITCompilationLock lock;
+  MethodOverrideDeoptPatcher::bumpEpoch();
+  if (method_override_patchers_.empty()) {
+    return;
+  }
+
+  BorrowedRef<PyTupleObject> mro{type->tp_mro};
+  BorrowedRef<> dict{_PyType_GetDict(type)};
+  if (mro == nullptr || dict == nullptr) {
+    return;
+  }
+  // Instances of a type that isn't statically defined can shadow any method
+  // with an instance attribute.
+  bool overrides_all =
+      !PyType_HasFeature(type, Ci_Py_TPFLAGS_IS_STATICALLY_DEFINED);
+
+  // Skip type itself, nothing can be watching it yet.
+  for (Py_ssize_t i = 1; i < PyTuple_GET_SIZE(mro); i++) {
+    BorrowedRef<PyTypeObject> base{PyTuple_GET_ITEM(mro, i)};
+    auto it = method_override_patchers_.find(base);
+    if (it == method_override_patchers_.end()) {
+      continue;
+    }
+    std::erase_if(it->second, [&](MethodOverrideDeoptPatcher* patcher) {
+      if (!overrides_all && PyDict_GetItem(dict, patcher->name()) == nullptr) {
+        return false;
+      }
+      patcher->patch();
+      return true;
+    });
+    if (it->second.empty()) {
+      method_override_patchers_.erase(it);
+    }
+  }
+}
+
 bool Context::hasCompletedCompile(CompilationKey& key) {
   JITCompilationLock lock;
   return completed_compiles_.contains(key);
@@ -527,6 +694,7 @@ bool Context::finalizeFunc(
   removeDeoptedFunc(func);
 
   setVectorcall(func, compiled->vectorcallEntry());
+  retargetDirectCalls(func, compiled);
   if (hasFunctionEntryCache(func)) {
     void** indirect = findFunctionEntryCache(func);
     *indirect = compiled->staticEntry();
@@ -614,6 +782,7 @@ void Context::forgetCompiledFunction(CompiledFunction& function) {
   if (function.runtime() != nullptr) {
     for (auto pyfunc : function.functions()) {
       compiled_funcs_.erase(pyfunc);
+      retargetDirectCalls(pyfunc, nullptr);
     }
     compiled_codes_.erase(CompilationKey{function});
   }
@@ -698,12 +867,19 @@ void Context::clearForMultithreadedCompileTest() {
 }
 
 void Context::funcDestroyed(BorrowedRef<PyFunctionObject> func) {
+  JITCompilationLock lock;
+  forgetFunc(func);
+  direct_call_patchers_.erase(func);
+}
+
+void Context::forgetFunc(BorrowedRef<PyFunctionObject> func) {
   JITCompilationLock lock;
   auto it = compiled_funcs_.find(func);
   if (it != compiled_funcs_.end()) {
     it->second->removeFunction(func);
     compiled_funcs_.erase(func);
   }
+  retargetDirectCalls(func, nullptr);
   deopted_funcs_.erase(func);
   // This doesn't modify compiled_codes_, so if this is a nested function it can
   // easily be reopted later.
@@ -745,6 +921,7 @@ bool Context::removeCompiledFunc(BorrowedRef<PyFunctionObject> func) {
   if (in_compiled_funcs != compiled_funcs_.end()) {
     in_compiled_funcs->second->removeFunction(func);
     compiled_funcs_.erase(in_compiled_funcs);
+    retargetDirectCalls(func, nullptr);
     return true;
   }
   return false;
@@ -17,12 +17,15 @@
 #include "cinderx/Jit/elf/note.h"
 #include "cinderx/Jit/fixed_type_profiler.h"
 #include "cinderx/Jit/gen_data_footer.h"
+#include "cinderx/Jit/hot_manifest.h"
 #include "cinderx/Jit/hir/preload.h"
 #include "cinderx/Jit/inline_cache.h"
 #include "cinderx/Jit/inline_cache_storage.h"
 #include "cinderx/Jit/pyjit_result.h"
+#include "cinderx/Jit/sampling_profiler.h"
 #include "cinderx/Jit/type_deopt_patchers.h"
 
+#include <chrono>
 #include <condition_variable>
 #include <deque>
 #include <functional>
@@ -74,6 +77,9 @@ struct BackgroundCompileTask {
   Ref<PyFunctionObject> func;
   hir::PreloaderMap preloaders;
   Ref<PyCodeObject> code;
+  // When the task was queued, for tracing how long it waited for the worker.
+  std::chrono::steady_clock::time_point enqueued{
+      std::chrono::steady_clock::now()};
 };
 
 // Process-wide state for background compilation. A single long-lived worker
@@ -360,6 +366,11 @@ class Context : public IJitContext, public CompiledFunctionOwner {
    */
   void funcDestroyed(BorrowedRef<PyFunctionObject> func);
 
+  // Forget about a function that is still alive, as if it had never been
+  // compiled.  Call sites that call it directly go back to their fallbacks,
+  // but are kept so that compiling it again points them at the new code.
+  void forgetFunc(BorrowedRef<PyFunctionObject> func);
+
   // Methods moved from Runtime class
 
   template <typename... Args>
@@ -425,6 +436,14 @@ class Context : public IJitContext, public CompiledFunctionOwner {
   void guardFailed(const DeoptMetadata& deopt_meta);
   void clearGuardFailureCallback();
 
+  // Record that the GuardIs pinning the attribute loaded at `bc_off` in `code`
+  // has failed.  Later compiles leave that load to the runtime cache.
+  void recordFailedPin(BorrowedRef<PyCodeObject> code, BCOffset bc_off);
+  bool hasFailedPin(BorrowedRef<PyCodeObject> code, BCOffset bc_off) const;
+
+  // Forget the failed pins of a code object that's being destroyed.
+  void forgetFailedPins(BorrowedRef<PyCodeObject> code);
+
   // Release any references this Context holds to Python objects.
   void releaseReferences();
 
@@ -453,6 +472,33 @@ class Context : public IJitContext, public CompiledFunctionOwner {
   // Stops watching for a specific TypeDeoptPatcher.
   void unwatch(TypeDeoptPatcher* patcher) override;
 
+  // Patch patcher when its method is overridden on its declaring type or any
+  // subclass.  Patches immediately if an override notification may have been
+  // missed since the class hierarchy was checked.
+  void watchMethodOverride(MethodOverrideDeoptPatcher* patcher);
+
+  // Stops watching for a specific MethodOverrideDeoptPatcher.
+  void unwatch(MethodOverrideDeoptPatcher* patcher) override;
+
+  // Keep patcher's call site pointed at the compiled entry point of its
+  // callee for as long as the callee has one.
+  void watchDirectCall(DirectCallPatcher* patcher);
+
+  // Stops watching for a specific DirectCallPatcher.
+  void unwatch(DirectCallPatcher* patcher) override;
+
+  // Callback for when the Static Python attribute name is assigned to or
+  // deleted from type.  Patches every patcher watching name on type or one of
+  // its bases.
+  void notifyMethodOverride(
+      BorrowedRef<PyTypeObject> type,
+      BorrowedRef<> name);
+
+  // Callback for when type is created as a subclass of a Static Python type.
+  // Patches every patcher watching a base of type for a name that type defines
+  // itself.
+  void notifySubclassAdded(BorrowedRef<PyTypeObject> type);
+
   // Callback for when a type is modified or destroyed. lookup_type should be
   // the type that triggered the call (the type that's being
   // modified/deleted/otherwise messed with), and new_type should be the "new"
@@ -546,6 +592,19 @@ class Context : public IJitContext, public CompiledFunctionOwner {
     return background_compile_registry_;
   }
 
+  // The sampling profiler exposed through cinderjit.start_sampling_profiler().
+  // Stopped by jit::finalize() before the context goes away.
+  SamplingProfiler sampling_profiler_;
+
+  SamplingProfiler& samplingProfiler() {
+    return sampling_profiler_;
+  }
+
+  // Functions that were hot in an earlier run, from
+  // cinderjit.load_hot_manifest() or -X cinderx-jit-hot-manifest.  nullptr if
+  // no manifest has been loaded.
+  std::unique_ptr<HotManifest> hot_manifest_;
+
   template <typename F>
   decltype(auto) withLock(std::mutex& lock, F&& f) const {
     if constexpr (kFreeThreadedBuild) {
@@ -562,6 +621,10 @@ class Context : public IJitContext, public CompiledFunctionOwner {
   mutable std::mutex deopt_stats_mutex_;
   mutable std::mutex deferred_compile_data_mutex_;
 
+  // Attribute loads whose pinned value has been rebound, by code object.
+  UnorderedMap<BorrowedRef<PyCodeObject>, UnorderedSet<BCOffset>> failed_pins_;
+  mutable std::mutex failed_pins_mutex_;
+
   // Get the stat object for a given deopt. It will not exist if the deopt has
   // never been hit. Caller must hold deopt_stats_mutex_ in free-threaded
   // builds.
@@ -578,6 +641,18 @@ class Context : public IJitContext, public CompiledFunctionOwner {
       std::unordered_set<TypeDeoptPatcher*>>
       type_deopt_patchers_;
 
+  std::unordered_map<
+      BorrowedRef<PyTypeObject>,
+      std::unordered_set<MethodOverrideDeoptPatcher*>>
+      method_override_patchers_;
+
+  // Call sites that call directly into a function's compiled code, keyed by
+  // the function.
+  std::unordered_map<
+      BorrowedRef<PyFunctionObject>,
+      std::unordered_set<DirectCallPatcher*>>
+      direct_call_patchers_;
+
   Ref<> str_build_class_;
   std::unordered_set<BorrowedRef<PyTypeObject>> pending_watches_;
 
@@ -587,6 +662,13 @@ class Context : public IJitContext, public CompiledFunctionOwner {
   /* Deopts a function but doesn't touch deopted_funcs_. */
   bool deoptFuncImpl(BorrowedRef<PyFunctionObject> func);
 
+  // Point every call site that calls func directly at the matching entry point
+  // of compiled, or back at their fallbacks if compiled is nullptr.  Caller
+  // must hold the compilation lock.
+  void retargetDirectCalls(
+      BorrowedRef<PyFunctionObject> func,
+      const CompiledFunction* compiled);
+
 #ifndef ENABLE_PREFORK_MODEL
   InlineCacheStats getAndClearInlineCacheStats(InlineCacheSite::Kind kind);
 #endif
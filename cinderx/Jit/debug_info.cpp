@@ -11,19 +11,43 @@
 namespace cinderx::jit {
 
 CodeObjLoc DebugInfo::getCodeObjLoc(const LocNode& node) const {
+  if (in_arena_) {
+    JIT_CHECK(
+        node.code_obj_id < arena_code_objs_.size(),
+        "Invalid code object id {}",
+        node.code_obj_id);
+    return CodeObjLoc(arena_code_objs_[node.code_obj_id], node.bc_off);
+  }
   return CodeObjLoc(code_objs_.at(node.code_obj_id), node.bc_off);
 }
 
-std::optional<UnitCallStack> DebugInfo::getUnitCallStack(uintptr_t addr) const {
+const DebugInfo::LocNode* DebugInfo::findLoc(uintptr_t addr) const {
+  if (in_arena_) {
+    auto it = std::lower_bound(
+        arena_addr_locs_.begin(),
+        arena_addr_locs_.end(),
+        addr,
+        [](const AddrLoc& entry, uintptr_t key) { return entry.addr < key; });
+    if (it == arena_addr_locs_.end() || it->addr != addr) {
+      return nullptr;
+    }
+    return &it->loc;
+  }
   auto it = addr_locs_.find(addr);
-  if (it == addr_locs_.end()) {
+  return it == addr_locs_.end() ? nullptr : &it->second;
+}
+
+std::optional<UnitCallStack> DebugInfo::getUnitCallStack(uintptr_t addr) const {
+  const LocNode* loc = findLoc(addr);
+  if (loc == nullptr) {
     return std::nullopt;
   }
 
-  LocNode node = it->second;
+  LocNode node = *loc;
   UnitCallStack stack{getCodeObjLoc(node)};
   while (node.hasCaller()) {
-    node = inlined_calls_[node.caller_id];
+    node = in_arena_ ? arena_inlined_calls_[node.caller_id]
+                     : inlined_calls_[node.caller_id];
     stack.emplace_back(getCodeObjLoc(node));
   }
   std::reverse(stack.begin(), stack.end());
@@ -31,6 +55,39 @@ std::optional<UnitCallStack> DebugInfo::getUnitCallStack(uintptr_t addr) const {
   return stack;
 }
 
+size_t DebugInfo::memoryBytes() const {
+  using MapEntry = decltype(addr_locs_)::value_type;
+  return code_objs_.capacity() * sizeof(BorrowedRef<PyCodeObject>) +
+      inlined_calls_.capacity() * sizeof(LocNode) +
+      addr_locs_.bucket_count() * sizeof(MapEntry) +
+      arena_code_objs_.size_bytes() + arena_inlined_calls_.size_bytes() +
+      arena_addr_locs_.size_bytes();
+}
+
+void DebugInfo::moveTo(HugePageArena& arena) {
+  if (in_arena_) {
+    return;
+  }
+  std::vector<AddrLoc> addr_locs;
+  addr_locs.reserve(addr_locs_.size());
+  for (auto& [addr, loc] : addr_locs_) {
+    addr_locs.push_back(AddrLoc{addr, loc});
+  }
+  std::sort(
+      addr_locs.begin(), addr_locs.end(), [](const auto& a, const auto& b) {
+        return a.addr < b.addr;
+      });
+
+  arena_code_objs_ =
+      arena.copy(std::span<const BorrowedRef<PyCodeObject>>{code_objs_});
+  arena_inlined_calls_ = arena.copy(std::span<const LocNode>{inlined_calls_});
+  arena_addr_locs_ = arena.copy(std::span<const AddrLoc>{addr_locs});
+  code_objs_ = {};
+  inlined_calls_ = {};
+  addr_locs_ = {};
+  in_arena_ = true;
+}
+
 namespace {
 
 struct Activation {
@@ -112,6 +169,7 @@ void DebugInfo::resolvePending(
     const std::vector<PendingDebugLoc>& pending,
     const jit::hir::Function& func,
     const asmjit::CodeHolder& code) {
+  JIT_CHECK(!in_arena_, "Can't add locations once moved into an arena");
   ActivationMap amap = buildActivationMap(func);
   // Add an entry for each pending location by walking the stack of inlined
   // calls that end at its instruction.
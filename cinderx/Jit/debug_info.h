@@ -5,6 +5,7 @@
 #include "cinderx/python.h"
 
 #include "cinderx/Common/containers.h"
+#include "cinderx/Common/hugepages.h"
 #include "cinderx/Common/ref.h"
 #include "cinderx/Jit/bytecode_offsets.h"
 
@@ -12,6 +13,7 @@
 
 #include <cstdint>
 #include <optional>
+#include <span>
 #include <vector>
 
 namespace cinderx::jit {
@@ -65,6 +67,9 @@ class DebugInfo {
   // Returns std::nullopt if no location information was found.
   std::optional<UnitCallStack> getUnitCallStack(uintptr_t addr) const;
 
+  // Approximate number of heap bytes used by the location information.
+  size_t memoryBytes() const;
+
   // Add location information for pending by resolving labels to their
   // addresses in generated code.
   void resolvePending(
@@ -72,6 +77,11 @@ class DebugInfo {
       const jit::hir::Function& func,
       const asmjit::CodeHolder& code);
 
+  // Move the location information into `arena`, as an array sorted by address
+  // rather than a hash table.  No more can be added afterwards.  Not safe to do
+  // while other threads may be looking up locations.
+  void moveTo(HugePageArena& arena);
+
  private:
   // Location information consumes a very large amount of memory, typically as
   // much or more as the generated code itself. Naively storing the entire call
@@ -131,6 +141,14 @@ class DebugInfo {
   // Decompress a LocNode to a CodeObjLoc
   CodeObjLoc getCodeObjLoc(const LocNode& node) const;
 
+  struct AddrLoc {
+    uintptr_t addr;
+    LocNode loc;
+  };
+
+  // Find the LocNode for addr, in whichever form the index is in.
+  const LocNode* findLoc(uintptr_t addr) const;
+
   // All the code objects in the unit
   std::vector<BorrowedRef<PyCodeObject>> code_objs_;
 
@@ -141,6 +159,12 @@ class DebugInfo {
   //
   // Consider storing in a vector sorted by address instead.
   UnorderedMap<uintptr_t, LocNode> addr_locs_;
+
+  // The above, once moved into an arena by moveTo().
+  std::span<const BorrowedRef<PyCodeObject>> arena_code_objs_;
+  std::span<const LocNode> arena_inlined_calls_;
+  std::span<const AddrLoc> arena_addr_locs_;
+  bool in_arena_{false};
 };
 
 } // namespace cinderx::jit
@@ -15,6 +15,7 @@
 #include <fmt/ranges.h>
 
 #include <cstdint>
+#include <string_view>
 #include <unordered_set>
 
 namespace cinderx::jit {
@@ -107,6 +108,11 @@ enum class DeoptReason : char {
 
 const char* deoptReasonName(DeoptReason reason);
 
+// Description of the GuardIs instructions that pin the value of a module or
+// class attribute at compile time.  One of them failing means the attribute
+// was rebound, and the function gets compiled again without the pin.
+constexpr std::string_view kPinnedAttrGuardDescr{"pinned attribute"};
+
 // Deopt metadata that is specific to a particular frame whose code may have
 // been inlined.
 struct DeoptFrameMetadata {
@@ -0,0 +1,321 @@
+// Copyright (c) Meta Platforms, Inc. and affiliates.
+
+#include "cinderx/Jit/deopt_encoding.h"
+
+#include "cinderx/Common/containers.h"
+#include "cinderx/Common/log.h"
+
+#include <limits>
+#include <string>
+#include <unordered_map>
+
+namespace cinderx::jit {
+
+namespace {
+
+// Unsigned LEB128.
+template <typename Buffer>
+void writeUnsigned(Buffer& out, uint64_t value) {
+  while (value >= 0x80) {
+    out.push_back(static_cast<uint8_t>(value) | 0x80);
+    value >>= 7;
+  }
+  out.push_back(static_cast<uint8_t>(value));
+}
+
+// Zigzag-encoded so that small negative numbers (mostly -1) stay one byte.
+template <typename Buffer>
+void writeSigned(Buffer& out, int64_t value) {
+  writeUnsigned(
+      out,
+      (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63));
+}
+
+class Reader {
+ public:
+  explicit Reader(const uint8_t* pos) : pos_{pos} {}
+
+  uint64_t readUnsigned() {
+    uint64_t result = 0;
+    int shift = 0;
+    uint8_t byte;
+    do {
+      byte = *pos_++;
+      result |= static_cast<uint64_t>(byte & 0x7f) << shift;
+      shift += 7;
+    } while (byte & 0x80);
+    return result;
+  }
+
+  int64_t readSigned() {
+    uint64_t value = readUnsigned();
+    return static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1);
+  }
+
+ private:
+  const uint8_t* pos_;
+};
+
+// A live value's three enums share one byte: the ref kind in the low two
+// bits, then the source, then the value kind.
+constexpr int kSourceShift = 2;
+constexpr int kValueKindShift = 3;
+
+uint64_t packKinds(const LiveValue& value) {
+  auto ref_kind = static_cast<uint64_t>(value.ref_kind);
+  auto source = static_cast<uint64_t>(value.source);
+  auto value_kind = static_cast<uint64_t>(value.value_kind);
+  JIT_DCHECK(ref_kind < (1 << kSourceShift), "RefKind doesn't fit");
+  JIT_DCHECK(source < 2, "LiveValue::Source doesn't fit");
+  return ref_kind | (source << kSourceShift) | (value_kind << kValueKindShift);
+}
+
+class Encoder {
+ public:
+  Encoder(std::vector<uint8_t>& bytes, std::vector<uintptr_t>& pointers)
+      : bytes_{bytes}, pointers_{pointers} {
+    pointers_.push_back(0);
+    pointer_ids_.emplace(0, 0);
+  }
+
+  // Append the record for meta and return its offset.
+  uint32_t encode(const DeoptMetadata& meta) {
+    uint32_t live_values = encodeLiveValues(meta);
+    std::vector<uint32_t> shapes;
+    shapes.reserve(meta.frame_meta.size());
+    for (const DeoptFrameMetadata& frame : meta.frame_meta) {
+      shapes.push_back(encodeFrameShape(frame));
+    }
+
+    uint32_t offset = currentOffset();
+    writeUnsigned(bytes_, static_cast<uint64_t>(meta.reason));
+    writeSigned(bytes_, meta.nonce);
+    writeUnsigned(bytes_, static_cast<uint64_t>(meta.guilty_value + 1));
+    writeUnsigned(bytes_, pointerId(meta.descr));
+    writeUnsigned(bytes_, pointerId(meta.eh_name.get()));
+    writeUnsigned(bytes_, live_values);
+    writeUnsigned(bytes_, meta.frame_meta.size());
+    for (size_t i = 0; i < meta.frame_meta.size(); ++i) {
+      writeUnsigned(bytes_, shapes[i]);
+      writeSigned(bytes_, meta.frame_meta[i].cause_instr_idx.value());
+    }
+    return offset;
+  }
+
+ private:
+  uint32_t encodeLiveValues(const DeoptMetadata& meta) {
+    std::string blob;
+    writeUnsigned(blob, meta.live_values.size());
+    for (const LiveValue& value : meta.live_values) {
+      writeSigned(blob, value.location.loc);
+      writeUnsigned(blob, value.location.bitSize);
+      writeUnsigned(blob, packKinds(value));
+    }
+    return intern(std::move(blob));
+  }
+
+  uint32_t encodeFrameShape(const DeoptFrameMetadata& frame) {
+    std::string blob;
+    writeUnsigned(blob, pointerId(frame.code));
+
+    // Live value indices are mostly ascending, with -1 for dead locals, so
+    // store each one as the difference from the one before it.
+    int prev = -1;
+    auto write_indices = [&](const FrozenList<int>& indices) {
+      writeUnsigned(blob, indices.size());
+      for (int idx : indices) {
+        writeSigned(blob, static_cast<int64_t>(idx) - prev);
+        prev = idx;
+      }
+    };
+    write_indices(frame.localsplus);
+    write_indices(frame.stack);
+
+    writeUnsigned(blob, frame.block_stack.size());
+    for (const hir::ExecutionBlock& block : frame.block_stack) {
+      writeUnsigned(blob, block.opcode);
+      writeSigned(blob, block.handler_off.value());
+      writeSigned(blob, block.stack_level);
+    }
+    return intern(std::move(blob));
+  }
+
+  uint32_t intern(std::string blob) {
+    auto [it, inserted] = blobs_.emplace(std::move(blob), 0);
+    if (inserted) {
+      it->second = currentOffset();
+      bytes_.insert(bytes_.end(), it->first.begin(), it->first.end());
+    }
+    return it->second;
+  }
+
+  uint64_t pointerId(const void* ptr) {
+    auto [it, inserted] = pointer_ids_.emplace(
+        reinterpret_cast<uintptr_t>(ptr), pointers_.size());
+    if (inserted) {
+      pointers_.push_back(it->first);
+    }
+    return it->second;
+  }
+
+  uint32_t currentOffset() const {
+    JIT_CHECK(
+        bytes_.size() <= std::numeric_limits<uint32_t>::max(),
+        "Encoded deopt metadata is too large");
+    return static_cast<uint32_t>(bytes_.size());
+  }
+
+  std::vector<uint8_t>& bytes_;
+  std::vector<uintptr_t>& pointers_;
+  UnorderedMap<uintptr_t, uint64_t> pointer_ids_;
+  std::unordered_map<std::string, uint32_t> blobs_;
+};
+
+void decodeLiveValues(Reader reader, FrozenList<LiveValue>& live_values) {
+  live_values.initialize(reader.readUnsigned());
+  for (size_t i = 0; i < live_values.size(); ++i) {
+    auto loc = static_cast<int>(reader.readSigned());
+    auto bit_size = static_cast<size_t>(reader.readUnsigned());
+    uint64_t kinds = reader.readUnsigned();
+    live_values[i] = LiveValue{
+        codegen::PhyLocation{loc, bit_size},
+        static_cast<hir::RefKind>(kinds & ((1 << kSourceShift) - 1)),
+        static_cast<hir::ValueKind>(kinds >> kValueKindShift),
+        static_cast<LiveValue::Source>((kinds >> kSourceShift) & 1),
+    };
+  }
+}
+
+} // namespace
+
+size_t deoptMetadataBytes(const DeoptMetadata& meta) {
+  size_t bytes = sizeof(DeoptMetadata) +
+      meta.live_values.size() * sizeof(LiveValue) +
+      meta.frame_meta.size() * sizeof(DeoptFrameMetadata);
+  for (const DeoptFrameMetadata& frame : meta.frame_meta) {
+    bytes += (frame.localsplus.size() + frame.stack.size()) * sizeof(int) +
+        frame.block_stack.size() * sizeof(hir::ExecutionBlock);
+  }
+  return bytes;
+}
+
+DeoptMetadataTable::DeoptMetadataTable(const std::vector<DeoptMetadata>& metas)
+    : decoded_{std::make_unique<std::atomic<DeoptMetadata*>[]>(metas.size())} {
+  Encoder encoder{bytes_buf_, pointers_buf_};
+  records_buf_.reserve(metas.size());
+  for (const DeoptMetadata& meta : metas) {
+    records_buf_.push_back(encoder.encode(meta));
+  }
+  bytes_buf_.shrink_to_fit();
+  pointers_buf_.shrink_to_fit();
+  bytes_ = bytes_buf_;
+  records_ = records_buf_;
+  pointers_ = pointers_buf_;
+}
+
+DeoptMetadataTable::~DeoptMetadataTable() {
+  for (size_t i = 0; i < records_.size(); ++i) {
+    delete decoded_[i].load(std::memory_order_relaxed);
+  }
+}
+
+size_t DeoptMetadataTable::size() const {
+  return records_.size();
+}
+
+const DeoptMetadata& DeoptMetadataTable::get(size_t idx) const {
+  JIT_CHECK(idx < records_.size(), "Invalid deopt index {}", idx);
+  std::atomic<DeoptMetadata*>& slot = decoded_[idx];
+  DeoptMetadata* meta = slot.load(std::memory_order_acquire);
+  if (meta != nullptr) {
+    return *meta;
+  }
+
+  auto fresh = std::make_unique<DeoptMetadata>(decode(idx));
+  if (!slot.compare_exchange_strong(
+          meta,
+          fresh.get(),
+          std::memory_order_acq_rel,
+          std::memory_order_acquire)) {
+    // Another thread got there first, use its copy.
+    return *meta;
+  }
+  decoded_bytes_.fetch_add(
+      deoptMetadataBytes(*fresh), std::memory_order_relaxed);
+  return *fresh.release();
+}
+
+DeoptMetadata DeoptMetadataTable::decode(size_t idx) const {
+  JIT_CHECK(idx < records_.size(), "Invalid deopt index {}", idx);
+  Reader record{bytes_.data() + records_[idx]};
+
+  DeoptMetadata meta;
+  meta.reason = static_cast<DeoptReason>(record.readUnsigned());
+  meta.nonce = static_cast<int>(record.readSigned());
+  meta.guilty_value = static_cast<int>(record.readUnsigned()) - 1;
+  meta.descr = reinterpret_cast<const char*>(pointers_[record.readUnsigned()]);
+  meta.eh_name = reinterpret_cast<PyObject*>(pointers_[record.readUnsigned()]);
+  decodeLiveValues(
+      Reader{bytes_.data() + record.readUnsigned()}, meta.live_values);
+
+  meta.frame_meta.initialize(record.readUnsigned());
+  for (size_t i = 0; i < meta.frame_meta.size(); ++i) {
+    DeoptFrameMetadata& frame = meta.frame_meta[i];
+    Reader shape{bytes_.data() + record.readUnsigned()};
+    frame.cause_instr_idx = BCIndex{static_cast<int>(record.readSigned())};
+
+    frame.code =
+        reinterpret_cast<PyCodeObject*>(pointers_[shape.readUnsigned()]);
+    int prev = -1;
+    auto read_indices = [&](FrozenList<int>& indices) {
+      indices.initialize(shape.readUnsigned());
+      for (size_t j = 0; j < indices.size(); ++j) {
+        prev += static_cast<int>(shape.readSigned());
+        indices[j] = prev;
+      }
+    };
+    read_indices(frame.localsplus);
+    read_indices(frame.stack);
+
+    size_t num_blocks = shape.readUnsigned();
+    for (size_t j = 0; j < num_blocks; ++j) {
+      hir::ExecutionBlock block;
+      block.opcode = static_cast<int>(shape.readUnsigned());
+      block.handler_off = BCOffset{static_cast<int>(shape.readSigned())};
+      block.stack_level = static_cast<int>(shape.readSigned());
+      frame.block_stack.push(block);
+    }
+  }
+  return meta;
+}
+
+size_t DeoptMetadataTable::encodedBytes() const {
+  size_t bytes = sizeof(*this) + bytes_buf_.capacity() +
+      records_buf_.capacity() * sizeof(uint32_t) +
+      pointers_buf_.capacity() * sizeof(uintptr_t) +
+      records_.size() * sizeof(std::atomic<DeoptMetadata*>);
+  if (in_arena_) {
+    bytes += bytes_.size_bytes() + records_.size_bytes() +
+        pointers_.size_bytes();
+  }
+  return bytes;
+}
+
+size_t DeoptMetadataTable::decodedBytes() const {
+  return decoded_bytes_.load(std::memory_order_relaxed);
+}
+
+void DeoptMetadataTable::moveTo(HugePageArena& arena) {
+  if (in_arena_) {
+    return;
+  }
+  bytes_ = arena.copy(bytes_);
+  records_ = arena.copy(records_);
+  pointers_ = arena.copy(pointers_);
+  bytes_buf_ = {};
+  records_buf_ = {};
+  pointers_buf_ = {};
+  in_arena_ = true;
+}
+
+} // namespace cinderx::jit
@@ -0,0 +1,82 @@
+// Copyright (c) Meta Platforms, Inc. and affiliates.
+
+#pragma once
+
+#include "cinderx/Common/hugepages.h"
+#include "cinderx/Common/util.h"
+#include "cinderx/Jit/deopt.h"
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <vector>
+
+namespace cinderx::jit {
+
+// Approximate number of heap bytes used by an expanded DeoptMetadata.
+size_t deoptMetadataBytes(const DeoptMetadata& meta);
+
+// A read-only, compact encoding of the DeoptMetadata for one compiled function.
+//
+// Most deopt points are never hit, but every one of them needs enough
+// information to rebuild the interpreter frame(s), and in the expanded form
+// that is several separately allocated lists per point. Here each point is a
+// short record of varints in a single byte buffer. The parts of a point that
+// tend to repeat are stored once and shared: live value lists, and frame
+// shapes (code object, localsplus and stack indices, block stack), which are
+// identical across all the guards between two stores to a local.
+//
+// Entries are decoded the first time they're asked for and then kept, so a
+// reference returned by get() stays valid for the lifetime of the table.
+// Decoding is lock-free and safe to do concurrently; if two threads race on
+// the same entry, one of the decoded copies is discarded.
+class DeoptMetadataTable {
+ public:
+  explicit DeoptMetadataTable(const std::vector<DeoptMetadata>& metas);
+  ~DeoptMetadataTable();
+
+  // Number of deopt points in the table.
+  size_t size() const;
+
+  // Get the DeoptMetadata with the given index, decoding it if necessary.
+  const DeoptMetadata& get(size_t idx) const;
+
+  // Decode the DeoptMetadata with the given index into a fresh object.
+  DeoptMetadata decode(size_t idx) const;
+
+  // Bytes used by the encoding itself.
+  size_t encodedBytes() const;
+
+  // Bytes used by the entries that have been decoded so far.
+  size_t decodedBytes() const;
+
+  // Move the encoding into `arena`.  The decoded entries, which are the only
+  // part of the table written to once it's built, stay where they are.  Not
+  // safe to do while other threads may be decoding entries.
+  void moveTo(HugePageArena& arena);
+
+ private:
+  DISALLOW_COPY_AND_ASSIGN(DeoptMetadataTable);
+
+  // Records and the shared blobs they point to.
+  std::span<const uint8_t> bytes_;
+
+  // Offset into bytes_ of the record for each deopt point.
+  std::span<const uint32_t> records_;
+
+  // Pointers referenced by the records (code objects, names, descriptions).
+  // Index 0 is always nullptr.
+  std::span<const uintptr_t> pointers_;
+
+  // Storage for the above, until they're moved into an arena.
+  std::vector<uint8_t> bytes_buf_;
+  std::vector<uint32_t> records_buf_;
+  std::vector<uintptr_t> pointers_buf_;
+  bool in_arena_{false};
+
+  std::unique_ptr<std::atomic<DeoptMetadata*>[]> decoded_;
+  mutable std::atomic<size_t> decoded_bytes_{0};
+};
+
+} // namespace cinderx::jit
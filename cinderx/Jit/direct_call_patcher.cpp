@@ -0,0 +1,78 @@
+// Copyright (c) Meta Platforms, Inc. and affiliates.
+
+#include "cinderx/Jit/direct_call_patcher.h"
+
+#include "cinderx/Common/log.h"
+#include "cinderx/Common/util.h"
+
+#include <array>
+#include <cstring>
+
+namespace cinderx::jit {
+
+namespace {
+
+// call rel32 - https://www.felixcloutier.com/x86/call
+constexpr uint8_t kCallOpcode = 0xe8;
+constexpr size_t kCallSize = 5;
+
+} // namespace
+
+DirectCallPatcher::DirectCallPatcher(
+    BorrowedRef<PyFunctionObject> callee,
+    Entry entry)
+    : callee_{callee}, entry_{entry} {}
+
+BorrowedRef<PyFunctionObject> DirectCallPatcher::callee() const {
+  return callee_;
+}
+
+DirectCallPatcher::Entry DirectCallPatcher::entry() const {
+  return entry_;
+}
+
+void DirectCallPatcher::linkCall(uintptr_t patchpoint) {
+  std::array<uint8_t, kCallSize> fallback{};
+  std::memcpy(
+      fallback.data(), reinterpret_cast<const void*>(patchpoint), kCallSize);
+  JIT_CHECK(
+      fallback[0] == kCallOpcode,
+      "Expected a rel32 call at {:#x}, found opcode {:#x}",
+      patchpoint,
+      fallback[0]);
+  link(patchpoint, fallback);
+}
+
+bool DirectCallPatcher::retarget(const void* entry) {
+  JIT_CHECK(isLinked(), "Trying to retarget a patcher that isn't linked");
+  if (isPatched()) {
+    unpatch();
+  }
+  if (entry == nullptr) {
+    return false;
+  }
+
+  auto next_instr = reinterpret_cast<uintptr_t>(patchpoint_) + kCallSize;
+  auto disp = static_cast<intptr_t>(
+      reinterpret_cast<uintptr_t>(entry) - next_instr);
+  if (!fitsSignedInt<32>(disp)) {
+    return false;
+  }
+
+  // While unpatched, data_ holds whatever was patched in last, so it's free to
+  // be overwritten with the new call.
+  auto disp32 = static_cast<int32_t>(disp);
+  data_[0] = kCallOpcode;
+  std::memcpy(data_.data() + 1, &disp32, sizeof(disp32));
+  patch();
+  return true;
+}
+
+uint8_t* DirectCallPatcher::callTarget() const {
+  JIT_CHECK(isLinked(), "Can't compute call target before linking");
+  int32_t disp = 0;
+  std::memcpy(&disp, patchpoint_ + 1, sizeof(disp));
+  return patchpoint_ + kCallSize + disp;
+}
+
+} // namespace cinderx::jit
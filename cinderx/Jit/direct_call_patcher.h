@@ -0,0 +1,64 @@
+// Copyright (c) Meta Platforms, Inc. and affiliates.
+#pragma once
+
+#include "cinderx/python.h"
+
+#include "cinderx/Common/ref.h"
+#include "cinderx/Jit/code_patcher.h"
+
+#include <cstdint>
+
+namespace cinderx::jit {
+
+// Patch a call to a known Python function so that it goes straight to the
+// function's compiled entry point instead of through its vectorcall pointer or
+// its function entry cache.
+//
+// The code generator emits the call site as a rel32 call to a fallback stub,
+// which jumps through the callee's vectorcall pointer (or entry cache slot)
+// and so is correct no matter what state the callee is in.  While the callee
+// has compiled code, the runtime retargets the call at its entry point.  When
+// the callee is deopted, uncompiled, or recompiled, the call is pointed back
+// at the fallback stub (and then at the new entry point, if there is one).
+//
+// Only supported on x86-64.
+class DirectCallPatcher : public CodePatcher {
+ public:
+  // Which of the callee's compiled entry points the call site goes to.
+  enum class Entry {
+    // The vectorcall entry, for calls that pass a vectorcall argument array.
+    kVectorcall,
+    // The static entry, for Static Python calls that pass arguments (including
+    // unboxed primitives) in registers.
+    kStatic,
+  };
+
+  explicit DirectCallPatcher(
+      BorrowedRef<PyFunctionObject> callee,
+      Entry entry = Entry::kVectorcall);
+
+  // The function being called.  Kept alive by the CodeRuntime of the caller.
+  BorrowedRef<PyFunctionObject> callee() const;
+
+  // The entry point of the callee's compiled code that the call site uses.
+  Entry entry() const;
+
+  // Link the patcher to the call instruction that was emitted at `patchpoint`.
+  // That call becomes the fallback.
+  void linkCall(uintptr_t patchpoint);
+
+  // Make the call site call `entry` directly.  If `entry` is nullptr, or is out
+  // of range of a rel32 call, the call site goes back to the fallback.
+  //
+  // Returns true if the call site now calls `entry`.
+  bool retarget(const void* entry);
+
+  // Get the address the call site currently calls.
+  uint8_t* callTarget() const;
+
+ private:
+  BorrowedRef<PyFunctionObject> callee_;
+  Entry entry_;
+};
+
+} // namespace cinderx::jit
@@ -23,6 +23,8 @@
 #include "cinderx/UpstreamBorrow/borrowed.h"
 #include "cinderx/module_state.h"
 
+#include <algorithm>
+#include <array>
 #include <csignal>
 #include <cstring>
 #include <optional>
@@ -329,6 +331,39 @@ void updatePrevInstr(_PyInterpreterFrame* frame) {
 #endif
 }
 
+#ifdef ENABLE_LIGHTWEIGHT_FRAMES
+
+// Append the locations of the frames in the unit whose non-inlined frame is
+// `frame`, innermost first, as given by the unit's debug info at its current
+// IP.  Unlike getUnitState() this doesn't need the unit's inlined frames and
+// doesn't treat a missing location as an error.  Returns false, leaving
+// `stack` untouched, if the locations can't be determined.
+bool appendUnitLocs(
+    _PyInterpreterFrame* frame,
+    std::vector<CodeObjLoc>& stack) {
+  // The IP of a deopt-patched frame is a deopt exit, which has no debug info.
+  if (jitFrameGetHeader(frame)->frame_status & JIT_FRAME_DEOPT_PATCHED) {
+    return false;
+  }
+  CodeRuntime* code_rt = getCodeRuntime(frame);
+  if (code_rt == nullptr) {
+    return false;
+  }
+  uintptr_t ip = getIP(frame, code_rt->frameSize());
+  if (ip == 0) {
+    return false;
+  }
+  std::optional<UnitCallStack> locs =
+      code_rt->debugInfo()->getUnitCallStack(ip);
+  if (!locs.has_value()) {
+    return false;
+  }
+  stack.insert(stack.end(), locs->rbegin(), locs->rend());
+  return true;
+}
+
+#endif
+
 #if defined(META_PYTHON) && defined(Py_GIL_DISABLED)
 CodeRuntime* lookupCodeRuntimeForOwningFrame(_PyInterpreterFrame* frame) {
   JIT_CHECK(
@@ -353,7 +388,7 @@ std::optional<ActiveDeoptMetadata> getActiveDeoptMetadata(
   }
 
   std::size_t deopt_idx = jitFrameGetHeader(owning_frame)->deopt_idx;
-  if (deopt_idx >= code_rt->deoptMetadatas().size()) {
+  if (deopt_idx >= code_rt->numDeoptMetadatas()) {
     return std::nullopt;
   }
   uintptr_t frame_base;
@@ -801,6 +836,293 @@ BorrowedRef<PyFunctionObject> getFrameFunctionIfJitted(
 #endif
 }
 
+std::vector<CodeObjLoc> getThreadCallStack(PyThreadState* tstate) {
+  std::vector<CodeObjLoc> stack;
+  for (_PyInterpreterFrame* frame = currentFrame(tstate); frame != nullptr;
+       frame = frame->previous) {
+    // Skip incomplete frames, as retainActiveDeferredData() does.
+#if PY_VERSION_HEX >= 0x030E0000
+    if (frame->owner >= FRAME_OWNED_BY_INTERPRETER) {
+#else
+    if (frame->owner >= FRAME_OWNED_BY_CSTACK) {
+#endif
+      continue;
+    }
+#ifdef ENABLE_LIGHTWEIGHT_FRAMES
+    if (isJitFrame(frame)) {
+      // Inlined frames are reported along with the rest of their unit, when
+      // the walk reaches its non-inlined frame.
+      if (isInlined(frame) || appendUnitLocs(frame, stack)) {
+        continue;
+      }
+    }
+#endif
+    stack.emplace_back(
+        _PyFrame_GetCode(frame), BCIndex{_PyInterpreterFrame_LASTI(frame)});
+  }
+  std::reverse(stack.begin(), stack.end());
+  return stack;
+}
+
+namespace {
+
+#if defined(ENABLE_LIGHTWEIGHT_FRAMES) && \
+    (defined(__APPLE__) || defined(__linux__))
+
+// How many native frames captureCallStack() looks through for the addresses
+// JIT units are executing.
+constexpr size_t kMaxNativeFrames = 128;
+
+// Read the native frames of the thread interrupted by the signal whose handler
+// was given `ucontext`, innermost first, as StackWalk reports them: each frame
+// pointer paired with the address being executed in that frame.
+size_t captureNativeFrames(
+    const void* ucontext,
+    StackBounds bounds,
+    StackFrame* frames,
+    size_t max_frames) {
+  auto [fp, pc, sp] = StackWalk::interruptedContext(ucontext);
+  if (fp == nullptr || max_frames == 0) {
+    return 0;
+  }
+  size_t count = 0;
+  frames[count++] = {fp, pc};
+  StackWalk::Cursor cursor{fp, bounds.clampedToStackPointer(sp)};
+  while (count < max_frames) {
+    const void* return_address = cursor.returnAddress();
+    const StackFrame* caller = cursor.step();
+    if (caller == nullptr) {
+      break;
+    }
+    frames[count++] = {caller, return_address};
+  }
+  return count;
+}
+
+// Find the native frame of the JIT unit whose non-inlined frame is `frame`
+// among the native frames of its thread, returning its index, or
+// num_native_frames if it isn't there.  While the unit runs, the frame-pointer
+// register holds the base of the native frame its interpreter frame is
+// embedded in, or a resumed generator's heap data, so the unit's frame is the
+// one with that frame pointer.
+size_t findUnitFrame(
+    _PyInterpreterFrame* frame,
+    const StackFrame* native_frames,
+    size_t num_native_frames) {
+  const void* unit_fp;
+  if (isGeneratorFrame(frame)) {
+    unit_fp = jitGenDataFooter(_PyGen_GetGeneratorFromFrame(frame));
+  } else {
+    unit_fp =
+        reinterpret_cast<const void*>(getFrameBaseFromOnStackFrame(frame));
+  }
+  for (size_t i = 0; i < num_native_frames; i++) {
+    if (native_frames[i].frame_pointer == unit_fp) {
+      return i;
+    }
+  }
+  return num_native_frames;
+}
+
+#ifndef Py_GIL_DISABLED
+
+// Most native frames recorded for a JIT unit that may be running without
+// linking its interpreter frame.  The unit calls nothing but runtime helpers,
+// so it is one of the innermost few.
+constexpr size_t kMaxFramelessCandidates = 4;
+
+// Record up to `num_candidates` of the innermost native frames in front of the
+// `count` frames already captured, as frames that may belong to a frameless
+// JIT unit.  The outermost frames are dropped if they don't all fit.  Returns
+// the new number of frames.
+size_t prependFramelessCandidates(
+    RawFrame* frames,
+    size_t count,
+    size_t max_frames,
+    const StackFrame* native_frames,
+    size_t num_candidates) {
+  num_candidates =
+      std::min({num_candidates, kMaxFramelessCandidates, max_frames});
+  size_t kept = std::min(count, max_frames - num_candidates);
+  std::copy_backward(frames, frames + kept, frames + kept + num_candidates);
+  for (size_t i = 0; i < num_candidates; i++) {
+    frames[i] = RawFrame{
+        .code = nullptr,
+        .builtins = nullptr,
+        .globals = nullptr,
+        .ip = reinterpret_cast<uintptr_t>(native_frames[i].return_address),
+        .lasti = 0,
+        .inlined = false,
+    };
+  }
+  return kept + num_candidates;
+}
+
+#endif
+
+#endif
+
+#ifdef ENABLE_LIGHTWEIGHT_FRAMES
+
+// Append the locations of the frames in the JIT unit captured as `frame` to
+// `stack`, innermost first.  Returns false, leaving `stack` untouched, if they
+// can't be determined, as appendUnitLocs() does.
+bool appendRawUnitLocs(const RawFrame& frame, std::vector<CodeObjLoc>& stack) {
+  if (frame.ip == 0 || frame.builtins == nullptr) {
+    return false;
+  }
+  CompiledFunction* compiled =
+      getContext()->lookupCode(frame.code, frame.builtins, frame.globals);
+  if (compiled == nullptr) {
+    return false;
+  }
+  // The unit may have been recompiled since the frame was captured, in which
+  // case its address means nothing to the new debug info.
+  std::optional<UnitCallStack> locs =
+      compiled->runtime()->debugInfo()->getUnitCallStack(frame.ip);
+  if (!locs.has_value()) {
+    return false;
+  }
+  stack.insert(stack.end(), locs->rbegin(), locs->rend());
+  return true;
+}
+
+#endif
+
+} // namespace
+
+#if defined(__APPLE__) || defined(__linux__)
+size_t captureCallStack(
+    PyThreadState* tstate,
+    [[maybe_unused]] const void* ucontext,
+    [[maybe_unused]] StackBounds bounds,
+    RawFrame* frames,
+    size_t max_frames) {
+#ifdef ENABLE_LIGHTWEIGHT_FRAMES
+  // Only read if they're needed.
+  std::array<StackFrame, kMaxNativeFrames> native_frames;
+  size_t num_native_frames = 0;
+  bool have_native_frames = false;
+  auto read_native_frames = [&] {
+    if (!have_native_frames) {
+      num_native_frames = captureNativeFrames(
+          ucontext, bounds, native_frames.data(), native_frames.size());
+      have_native_frames = true;
+    }
+  };
+  // Number of native frames inside of the innermost JIT unit with a linked
+  // frame, when no interpreted frame is inside of it.  Only those can belong to
+  // a unit running without its frame.
+  [[maybe_unused]] size_t inner_native_frames = kMaxNativeFrames;
+  bool found_inner_frame = false;
+#endif
+
+  size_t count = 0;
+  for (_PyInterpreterFrame* frame = currentFrame(tstate);
+       frame != nullptr && count < max_frames;
+       frame = frame->previous) {
+#if PY_VERSION_HEX >= 0x030E0000
+    if (frame->owner >= FRAME_OWNED_BY_INTERPRETER) {
+#else
+    if (frame->owner >= FRAME_OWNED_BY_CSTACK) {
+#endif
+      continue;
+    }
+    RawFrame& raw = frames[count++];
+    raw.code = _PyFrame_GetCode(frame);
+    raw.builtins = nullptr;
+    raw.globals = nullptr;
+    raw.ip = 0;
+    raw.lasti = _PyInterpreterFrame_LASTI(frame);
+    raw.inlined = false;
+#ifdef ENABLE_LIGHTWEIGHT_FRAMES
+    if (!isJitFrame(frame)) {
+      found_inner_frame = true;
+      continue;
+    }
+    if (isInlined(frame)) {
+      raw.inlined = true;
+      continue;
+    }
+    // The IP of a deopt-patched frame is a deopt exit, which has no debug
+    // info.
+    if (jitFrameGetHeader(frame)->frame_status & JIT_FRAME_DEOPT_PATCHED) {
+      found_inner_frame = true;
+      continue;
+    }
+    read_native_frames();
+    BorrowedRef<PyFunctionObject> func = jitFrameGetFunction(frame);
+    raw.builtins = reinterpret_cast<PyDictObject*>(func->func_builtins);
+    raw.globals = reinterpret_cast<PyDictObject*>(func->func_globals);
+    size_t unit_frame =
+        findUnitFrame(frame, native_frames.data(), num_native_frames);
+    if (unit_frame < num_native_frames) {
+      raw.ip = reinterpret_cast<uintptr_t>(
+          native_frames[unit_frame].return_address);
+    }
+    if (!found_inner_frame) {
+      inner_native_frames = unit_frame;
+      found_inner_frame = true;
+    }
+#endif
+  }
+
+#if defined(ENABLE_LIGHTWEIGHT_FRAMES) && !defined(Py_GIL_DISABLED)
+  // A leaf function running without its frame is in none of the frames above,
+  // only in the native frames inside of them.
+  if (getConfig().frameless_leaf_functions) {
+    read_native_frames();
+    count = prependFramelessCandidates(
+        frames,
+        count,
+        max_frames,
+        native_frames.data(),
+        std::min(inner_native_frames, num_native_frames));
+  }
+#endif
+  return count;
+}
+#endif
+
+size_t numFramelessCandidates(const RawFrame* frames, size_t count) {
+  size_t num = 0;
+  while (num < count && frames[num].code == nullptr) {
+    num++;
+  }
+  return num;
+}
+
+std::vector<CodeObjLoc> resolveCallStack(const RawFrame* frames, size_t count) {
+  std::vector<CodeObjLoc> stack;
+  size_t begin = numFramelessCandidates(frames, count);
+  // Frames inlined into the unit that is next out, which are only used if the
+  // unit's debug info can't be.
+  size_t inlined_begin = begin;
+  for (size_t i = begin; i < count; i++) {
+    const RawFrame& frame = frames[i];
+    if (frame.inlined) {
+      continue;
+    }
+#ifdef ENABLE_LIGHTWEIGHT_FRAMES
+    if (appendRawUnitLocs(frame, stack)) {
+      inlined_begin = i + 1;
+      continue;
+    }
+#endif
+    for (; inlined_begin <= i; inlined_begin++) {
+      const RawFrame& loc = frames[inlined_begin];
+      stack.emplace_back(loc.code, BCIndex{loc.lasti});
+    }
+  }
+  // Inlined frames whose unit didn't fit in the capture.
+  for (; inlined_begin < count; inlined_begin++) {
+    const RawFrame& loc = frames[inlined_begin];
+    stack.emplace_back(loc.code, BCIndex{loc.lasti});
+  }
+  std::reverse(stack.begin(), stack.end());
+  return stack;
+}
+
 void retainActiveDeferredData(
     std::unordered_map<OwnedCompilationKey, Ref<CompiledFunctionData>>& pending,
     std::unordered_map<OwnedCompilationKey, Ref<CompiledFunctionData>>&
@@ -13,8 +13,11 @@
 #include "cinderx/Common/ref.h"
 #include "cinderx/Jit/code_runtime.h"
 #include "cinderx/Jit/frame_header.h"
+#include "cinderx/Jit/stack_walk.h"
 #include "cinderx/module_state.h"
 
+#include <vector>
+
 namespace cinderx::jit {
 
 // A singleton reifier object that was set _PyInterpreterFrame's f_funcobj
@@ -87,6 +90,64 @@ Ref<> makeFrameReifier(BorrowedRef<PyCodeObject> code);
 // are used.
 void deoptAllJitFramesOnStack();
 
+// Get the locations of all the Python frames active on `tstate`, outermost
+// first.  JIT-compiled units are expanded through their debug info, so frames
+// for inlined functions are reported at the point they are executing even
+// though their interpreter frames are never updated.  Nothing is modified,
+// which keeps this cheap enough to call from a sampling profiler.
+//
+// The caller must ensure that `tstate` can't run Python code for the duration,
+// e.g. by holding the GIL or stopping the world.
+std::vector<CodeObjLoc> getThreadCallStack(PyThreadState* tstate);
+
+// A Python frame as captured by captureCallStack(): only what can be read
+// without allocating, taking locks, or touching reference counts.
+//
+// A JIT unit that runs without linking its interpreter frame (see
+// CodeRuntime::isFrameless()) can't be found from the thread state.  The
+// innermost few native frames are recorded ahead of the Python frames in case
+// one of them belongs to such a unit, with a null `code` and the address they
+// are executing in `ip`.
+struct RawFrame {
+  PyCodeObject* code;
+  // For the non-inlined frame of a JIT unit, the key its compiled code is
+  // looked up with.  Null for every other frame.
+  PyDictObject* builtins;
+  PyDictObject* globals;
+  // The address the JIT unit is executing, or 0 if it couldn't be found.
+  uintptr_t ip;
+  int lasti;
+  // Whether this is the frame of a function inlined into a JIT unit, which is
+  // reported through the unit's debug info when that can be used.
+  bool inlined;
+};
+
+#if defined(__APPLE__) || defined(__linux__)
+// Capture up to `max_frames` frames of the Python call stack of `tstate`,
+// innermost first, returning how many were written to `frames`.
+//
+// Async-signal-safe.  Meant to be called from a signal handler that has
+// interrupted the thread running `tstate`: `ucontext` is the handler's context
+// and `bounds` the thread's stack, which are used to find the addresses JIT
+// units are executing.
+size_t captureCallStack(
+    PyThreadState* tstate,
+    const void* ucontext,
+    StackBounds bounds,
+    RawFrame* frames,
+    size_t max_frames);
+#endif
+
+// Number of native frames captureCallStack() recorded at the start of
+// `frames` for a unit that may be running without its frame.
+size_t numFramelessCandidates(const RawFrame* frames, size_t count);
+
+// Turn frames captured by captureCallStack() into locations, outermost first,
+// as getThreadCallStack() would have reported them.  The native frames
+// recorded for frameless units are skipped.  The code objects the frames refer
+// to must still be alive.
+std::vector<CodeObjLoc> resolveCallStack(const RawFrame* frames, size_t count);
+
 #if defined(META_PYTHON) && defined(Py_GIL_DISABLED)
 void registerJitGCDeferredRefVisitor(PyInterpreterState* interp);
 void clearJitGCDeferredRefVisitor(PyInterpreterState* interp);
@@ -13,6 +13,11 @@
 #include "internal/pycore_interpframe.h"
 #endif
 
+#include <atomic>
+#include <mutex>
+#include <new>
+#include <vector>
+
 namespace cinderx::jit {
 
 namespace {
@@ -44,33 +49,75 @@ std::pair<JitGenObject*, size_t> allocateNonFreeList(
 
 } // namespace
 
-JitGenFreeList:: // NOLINT(cppcoreguidelines-pro-type-member-init)
-    JitGenFreeList() {
-  Entry* next = nullptr;
-  for (size_t i = 0; i < kGenFreeListEntries; ++i) {
-    entries_[i].next = next;
-    next = &entries_[i];
+int genPoolSizeClass(
+    const std::vector<GenPoolSizeClass>& classes,
+    size_t size) {
+  for (size_t i = 0; i < classes.size(); ++i) {
+    if (size <= classes[i].size) {
+      return static_cast<int>(i);
+    }
   }
-  head_ = next;
+  return -1;
 }
 
-void* JitGenFreeList::rawAllocate() {
-  JIT_DCHECK(head_, "No free generator entries");
-  Entry* entry = head_;
-  head_ = entry->next;
+JitGenFreeList::JitGenFreeList(std::vector<GenPoolSizeClass> classes)
+    : classes_{std::move(classes)}, pools_(classes_.size()) {
+  size_t arena_size = 0;
+  for (const GenPoolSizeClass& cls : classes_) {
+    arena_size += cls.size * cls.capacity;
+  }
+  // Deliberately left uninitialized, so that pages are only touched once
+  // entries in them are handed out.
+  arena_.reset(new uint8_t[arena_size]);
+  uint8_t* next = arena_.get();
+  for (size_t i = 0; i < classes_.size(); ++i) {
+    Pool& pool = pools_[i];
+    pool.entry_size = classes_[i].size;
+    pool.begin = next;
+    pool.untouched = next;
+    next += pool.entry_size * classes_[i].capacity;
+    pool.end = next;
+  }
+  arena_end_ = next;
+}
+
+void* JitGenFreeList::rawAllocate(Pool& pool) {
+  void* raw;
+  if (pool.head != nullptr) {
+    raw = pool.head;
+    pool.head = pool.head->next;
+  } else {
+    JIT_DCHECK(pool.untouched < pool.end, "No free generator entries");
+    raw = pool.untouched;
+    pool.untouched += pool.entry_size;
+  }
+  pool.used++;
   // The memory for the free-list is backed by the module state, so bump the
   // reference count to prevent it being free'd before all free-listed
   // generators are.
   Py_INCREF(cinderx::getModuleState()->cinderx_module);
-  return entry->data;
+  return raw;
 }
 
-bool JitGenFreeList::fromThisArena(void* ptr) {
-  return ptr >= &entries_ && ptr < &entries_[kGenFreeListEntries - 1] + 1;
+bool JitGenFreeList::hasFree(const Pool& pool) {
+  return pool.head != nullptr || pool.untouched < pool.end;
 }
 
-void JitGenFreeList::free(PyObject* ptr) {
-  if (!fromThisArena(ptr)) {
+JitGenFreeList::Pool* JitGenFreeList::poolFor(void* ptr) {
+  if (ptr < arena_.get() || ptr >= arena_end_) {
+    return nullptr;
+  }
+  for (Pool& pool : pools_) {
+    if (ptr < pool.end) {
+      return &pool;
+    }
+  }
+  JIT_ABORT("Pointer {} is in the arena but not in any pool", ptr);
+}
+
+void JitGenFreeList::free(PyObject* ptr, bool /* was_jit_gen */) {
+  Pool* pool = poolFor(ptr);
+  if (pool == nullptr) {
     PyObject_GC_Del(ptr);
     return;
   }
@@ -80,16 +127,26 @@ void JitGenFreeList::free(PyObject* ptr) {
       reinterpret_cast<uintptr_t>(ptr) - sizeof(PyGC_Head));
   JIT_DCHECK(
       (reinterpret_cast<uintptr_t>(entry) -
-       reinterpret_cast<uintptr_t>(&entries_[0])) %
-              kGenFreeListEntrySize ==
+       reinterpret_cast<uintptr_t>(pool->begin)) %
+              pool->entry_size ==
           0,
       "Incorrect pointer calculation");
-  entry->next = head_;
-  head_ = entry;
+  entry->next = pool->head;
+  pool->head = entry;
+  pool->used--;
   // See comment in rawAllocate()
   Py_DECREF(cinderx::getModuleState()->cinderx_module);
 }
 
+size_t JitGenFreeList::entrySize(
+    BorrowedRef<PyCodeObject> code,
+    uint64_t jit_data_size) const {
+  BorrowedRef<PyTypeObject> gen_tp = cinderx::getModuleState()->gen_type;
+  // All the generator types should be the same size.
+  return sizeof(PyGC_Head) +
+      _PyObject_VAR_SIZE(gen_tp, computeSlots(code, jit_data_size));
+}
+
 std::pair<JitGenObject*, size_t> JitGenFreeList::allocate(
     BorrowedRef<PyCodeObject> code,
     uint64_t jit_data_size) {
@@ -104,14 +161,23 @@ std::pair<JitGenObject*, size_t> JitGenFreeList::allocate(
   // All the generator types should be the same size.
   size_t size = _PyObject_VAR_SIZE(gen_tp, slots);
   size_t total_size = sizeof(PyGC_Head) + size;
+  size_histogram_[genSizeHistogramBucket(total_size)]++;
 
   bool is_coro = !!(code->co_flags & CO_COROUTINE);
 
-  if (!head_ || total_size > kGenFreeListEntrySize) {
+  int cls = genPoolSizeClass(classes_, total_size);
+  if (cls < 0) {
+    oversized_++;
+    return allocateNonFreeList(slots, is_coro);
+  }
+  Pool& pool = pools_[cls];
+  if (!hasFree(pool)) {
+    pool.misses++;
     return allocateNonFreeList(slots, is_coro);
   }
+  pool.hits++;
 
-  void* raw = rawAllocate();
+  void* raw = rawAllocate(pool);
   // Zero the pre-header, which in this case is the GC header. The
   // The reference for this is gc_alloc() + _PyObject_GC_Link(). It
   // would be nice if the latter were public so we could custom
@@ -131,16 +197,397 @@ std::pair<JitGenObject*, size_t> JitGenFreeList::allocate(
   return {reinterpret_cast<JitGenObject*>(op), size};
 }
 
+GenPoolStats JitGenFreeList::stats() const {
+  GenPoolStats stats;
+  stats.misses = oversized_;
+  stats.size_histogram = size_histogram_;
+  for (size_t i = 0; i < pools_.size(); ++i) {
+    const Pool& pool = pools_[i];
+    size_t touched =
+        static_cast<size_t>(pool.untouched - pool.begin) / pool.entry_size;
+    GenPoolClassStats& cls = stats.classes.emplace_back();
+    cls.size = pool.entry_size;
+    cls.capacity = classes_[i].capacity;
+    cls.hits = pool.hits;
+    cls.misses = pool.misses;
+    cls.in_use = pool.used;
+    cls.free = touched - pool.used;
+    stats.hits += cls.hits;
+    stats.misses += cls.misses;
+    stats.bytes_held += cls.free * cls.size;
+  }
+  return stats;
+}
+
+namespace {
+
+// The last word of a pooled generator's `size` byte entry. It points to the
+// pool the generator belongs to while it's alive, and links it to the next
+// free generator while it's in a pool.
+void** entryTail(PyObject* op, size_t size) {
+  return reinterpret_cast<void**>( // NOLINT(performance-no-int-to-ptr)
+             reinterpret_cast<uintptr_t>(op) + size) -
+      1;
+}
+
+// Add to a counter that's only written by one thread but may be read by
+// others.
+void bump(std::atomic<size_t>& counter, size_t delta) {
+  counter.store(
+      counter.load(std::memory_order_relaxed) + delta,
+      std::memory_order_relaxed);
+}
+
+// Put the GC state of a freed generator back the way it is for a new
+// allocation. This notably clears the finalized flag.
+void resetGCState(PyObject* op) {
+#ifdef Py_GIL_DISABLED
+  op->ob_gc_bits = 0;
+#else
+  PyObject** pre_header = reinterpret_cast<PyObject**>(op) - 2;
+  pre_header[0] = nullptr;
+  pre_header[1] = nullptr;
+#endif
+}
+
+} // namespace
+
+// A thread's cache of freed generators, one list per size class.
+struct GenThreadPool {
+  struct SizeClass {
+    // Only accessed by the owning thread.
+    PyObject* head{nullptr};
+
+    // Generators freed by other threads.  Other threads push onto this list
+    // and the owning thread takes it whole.
+    std::atomic<PyObject*> returned{nullptr};
+    std::atomic<size_t> returned_count{0};
+
+    // Written by the owning thread.
+    std::atomic<size_t> count{0};
+    std::atomic<size_t> hits{0};
+    std::atomic<size_t> misses{0};
+    // Generators of this size freed by the owning thread, whichever pool they
+    // came from.
+    std::atomic<size_t> frees{0};
+  };
+
+  explicit GenThreadPool(const std::vector<GenPoolSizeClass>& classes)
+      : classes{classes},
+        size_classes{std::make_unique<SizeClass[]>(classes.size())} {}
+
+  // Take the most recently freed generator of size class `cls`, or return
+  // nullptr if there aren't any.  Only called by the owning thread.
+  PyObject* pop(size_t cls) {
+    SizeClass& sc = size_classes[cls];
+    if (sc.head == nullptr) {
+      takeReturned(cls);
+    }
+    PyObject* op = sc.head;
+    if (op == nullptr) {
+      return nullptr;
+    }
+    sc.head = static_cast<PyObject*>(*entryTail(op, classes[cls].size));
+    sc.count.store(
+        sc.count.load(std::memory_order_relaxed) - 1,
+        std::memory_order_relaxed);
+    return op;
+  }
+
+  // Cache a generator freed by the owning thread. Returns false if the cache
+  // for its size class is full.
+  bool push(PyObject* op, size_t cls) {
+    SizeClass& sc = size_classes[cls];
+    size_t count = sc.count.load(std::memory_order_relaxed);
+    if (count >= classes[cls].thread_capacity) {
+      return false;
+    }
+    *entryTail(op, classes[cls].size) = sc.head;
+    sc.head = op;
+    sc.count.store(count + 1, std::memory_order_relaxed);
+    return true;
+  }
+
+  // Hand back a generator freed by some other thread.
+  void pushReturned(PyObject* op, size_t cls) {
+    SizeClass& sc = size_classes[cls];
+    void** tail = entryTail(op, classes[cls].size);
+    PyObject* head = sc.returned.load(std::memory_order_relaxed);
+    do {
+      *tail = head;
+    } while (!sc.returned.compare_exchange_weak(
+        head, op, std::memory_order_release, std::memory_order_relaxed));
+    sc.returned_count.fetch_add(1, std::memory_order_relaxed);
+    remote_frees.fetch_add(1, std::memory_order_relaxed);
+  }
+
+  // Move the generators of size class `cls` handed back by other threads into
+  // this thread's cache, releasing any that don't fit.  The whole list is
+  // taken at once, so there's no ABA problem.
+  void takeReturned(size_t cls) {
+    SizeClass& sc = size_classes[cls];
+    PyObject* op = sc.returned.exchange(nullptr, std::memory_order_acquire);
+    size_t taken = 0;
+    while (op != nullptr) {
+      auto next = static_cast<PyObject*>(*entryTail(op, classes[cls].size));
+      if (!push(op, cls)) {
+        PyObject_GC_Del(op);
+      }
+      taken++;
+      op = next;
+    }
+    sc.returned_count.fetch_sub(taken, std::memory_order_relaxed);
+  }
+
+  // Release every cached generator.  Must only be called once no other thread
+  // can be using the pool.
+  void clear() {
+    for (size_t cls = 0; cls < classes.size(); ++cls) {
+      takeReturned(cls);
+      while (PyObject* op = pop(cls)) {
+        PyObject_GC_Del(op);
+      }
+    }
+  }
+
+  const std::vector<GenPoolSizeClass>& classes;
+  std::unique_ptr<SizeClass[]> size_classes;
+
+  // Written by other threads.
+  std::atomic<size_t> remote_frees{0};
+
+  // Written by the owning thread.
+  std::array<std::atomic<size_t>, kGenSizeHistogramBuckets> size_histogram{};
+  // Allocations too big for any size class.
+  std::atomic<size_t> oversized{0};
+};
+
+// All the per-thread pools of a JITGenFreeThreadedFreeList. Pools outlive
+// their threads, since other threads may still hand generators back to them,
+// and are reused by threads that start later.
+struct GenPoolRegistry {
+  explicit GenPoolRegistry(std::vector<GenPoolSizeClass> classes)
+      : classes{std::move(classes)} {}
+
+  // Distinguishes this registry from earlier ones, so that threads can tell
+  // when the pool they cached belongs to a registry that has gone.
+  const uint64_t id{next_id.fetch_add(1, std::memory_order_relaxed)};
+  const std::vector<GenPoolSizeClass> classes;
+
+  std::mutex mutex;
+  std::vector<std::unique_ptr<GenThreadPool>> pools;
+  // Pools whose thread has exited.
+  std::vector<GenThreadPool*> parked;
+
+  static inline std::atomic<uint64_t> next_id{1};
+
+  GenThreadPool* acquire() {
+    std::lock_guard<std::mutex> lock{mutex};
+    if (!parked.empty()) {
+      GenThreadPool* pool = parked.back();
+      parked.pop_back();
+      return pool;
+    }
+    return pools.emplace_back(std::make_unique<GenThreadPool>(classes)).get();
+  }
+
+  void park(GenThreadPool* pool) {
+    std::lock_guard<std::mutex> lock{mutex};
+    parked.push_back(pool);
+  }
+};
+
+namespace {
+
+// The calling thread's pool.  Parked again when the thread exits, which
+// doesn't need a Python thread state.
+struct GenPoolHandle {
+  ~GenPoolHandle() {
+    if (std::shared_ptr<GenPoolRegistry> reg = registry.lock()) {
+      reg->park(pool);
+    }
+  }
+
+  std::weak_ptr<GenPoolRegistry> registry;
+  uint64_t registry_id{0};
+  GenThreadPool* pool{nullptr};
+};
+
+thread_local GenPoolHandle t_gen_pool;
+
+GenThreadPool* currentPool(const std::shared_ptr<GenPoolRegistry>& registry) {
+  GenPoolHandle& handle = t_gen_pool;
+  if (handle.registry_id == registry->id) {
+    return handle.pool;
+  }
+  if (std::shared_ptr<GenPoolRegistry> old = handle.registry.lock()) {
+    old->park(handle.pool);
+  }
+  handle.pool = registry->acquire();
+  handle.registry = registry;
+  handle.registry_id = registry->id;
+  return handle.pool;
+}
+
+} // namespace
+
+JITGenFreeThreadedFreeList::JITGenFreeThreadedFreeList(
+    std::vector<GenPoolSizeClass> classes)
+    : registry_{std::make_shared<GenPoolRegistry>(std::move(classes))} {}
+
+JITGenFreeThreadedFreeList::~JITGenFreeThreadedFreeList() {
+  // Threads that exit later still park their pools, which only keeps the
+  // registry alive until they've done so; the generators are released here,
+  // where there's a thread state to do it with.
+  std::lock_guard<std::mutex> lock{registry_->mutex};
+  for (auto& pool : registry_->pools) {
+    pool->clear();
+  }
+}
+
+size_t JITGenFreeThreadedFreeList::entrySize(
+    BorrowedRef<PyCodeObject> code,
+    uint64_t jit_data_size) const {
+  BorrowedRef<PyTypeObject> gen_tp = cinderx::getModuleState()->gen_type;
+  // Pooled generators are allocated with the full size of their class, with
+  // room at the end for the entry tail.
+  return _PyObject_VAR_SIZE(gen_tp, computeSlots(code, jit_data_size)) +
+      sizeof(void*);
+}
+
 std::pair<JitGenObject*, size_t> JITGenFreeThreadedFreeList::allocate(
     BorrowedRef<PyCodeObject> code,
     uint64_t jit_data_size) {
+  BorrowedRef<PyTypeObject> gen_tp = cinderx::getModuleState()->gen_type;
   size_t slots = computeSlots(code, jit_data_size);
+  size_t size = _PyObject_VAR_SIZE(gen_tp, slots);
   bool is_coro = !!(code->co_flags & CO_COROUTINE);
-  return allocateNonFreeList(slots, is_coro);
+
+  GenThreadPool* pool = currentPool(registry_);
+  size_t entry_size = size + sizeof(void*);
+  bump(pool->size_histogram[genSizeHistogramBucket(entry_size)], 1);
+  int cls = genPoolSizeClass(registry_->classes, entry_size);
+  if (cls < 0) {
+    bump(pool->oversized, 1);
+    return allocateNonFreeList(slots, is_coro);
+  }
+
+  GenThreadPool::SizeClass& sc = pool->size_classes[cls];
+  size_t class_size = registry_->classes[cls].size;
+  PyObject* op = pool->pop(cls);
+  if (op != nullptr) {
+    bump(sc.hits, 1);
+    resetGCState(op);
+    PyTypeObject* tp = is_coro ? cinderx::getModuleState()->coro_type : gen_tp;
+    _PyObject_InitVar(reinterpret_cast<PyVarObject*>(op), tp, slots);
+  } else {
+    bump(sc.misses, 1);
+    size_t class_slots = (class_size - gen_tp->tp_basicsize) / sizeof(void*);
+    JIT_DCHECK(
+        _PyObject_VAR_SIZE(gen_tp, class_slots) == class_size,
+        "Generator entry of {} slots isn't {} bytes",
+        class_slots,
+        class_size);
+    op = reinterpret_cast<PyObject*>(
+        allocateNonFreeList(class_slots, is_coro).first);
+    Py_SET_SIZE(op, slots);
+  }
+  *entryTail(op, class_size) = pool;
+  return {reinterpret_cast<JitGenObject*>(op), size};
+}
+
+void JITGenFreeThreadedFreeList::free(PyObject* ptr, bool was_jit_gen) {
+  // Generators that were deopted before being deallocated may have been
+  // allocated by the interpreter, and then there's no entry tail to find the
+  // pool from.
+  int cls = -1;
+  if (was_jit_gen) {
+    BorrowedRef<PyTypeObject> gen_tp = cinderx::getModuleState()->gen_type;
+    cls = genPoolSizeClass(
+        registry_->classes,
+        _PyObject_VAR_SIZE(gen_tp, Py_SIZE(ptr)) + sizeof(void*));
+  }
+  if (cls < 0) {
+    PyObject_GC_Del(ptr);
+    return;
+  }
+
+  size_t class_size = registry_->classes[cls].size;
+  auto owner = static_cast<GenThreadPool*>(*entryTail(ptr, class_size));
+  GenThreadPool* pool = currentPool(registry_);
+  bump(pool->size_classes[cls].frees, 1);
+  if (owner != pool) {
+    owner->pushReturned(ptr, cls);
+  } else if (!pool->push(ptr, cls)) {
+    PyObject_GC_Del(ptr);
+  }
 }
 
-void JITGenFreeThreadedFreeList::free(PyObject* ptr) {
-  PyObject_GC_Del(ptr);
+GenPoolStats JITGenFreeThreadedFreeList::stats() const {
+  const std::vector<GenPoolSizeClass>& classes = registry_->classes;
+  GenPoolStats stats;
+  stats.classes.resize(classes.size());
+  for (size_t i = 0; i < classes.size(); ++i) {
+    stats.classes[i].size = classes[i].size;
+  }
+
+  std::lock_guard<std::mutex> lock{registry_->mutex};
+  // Sum allocations and frees separately, as a generator may be allocated on
+  // one thread and freed on another.
+  std::vector<size_t> frees(classes.size());
+  for (auto& pool : registry_->pools) {
+    stats.misses += pool->oversized.load(std::memory_order_relaxed);
+    stats.remote_frees += pool->remote_frees.load(std::memory_order_relaxed);
+    for (size_t i = 0; i < kGenSizeHistogramBuckets; ++i) {
+      stats.size_histogram[i] +=
+          pool->size_histogram[i].load(std::memory_order_relaxed);
+    }
+    for (size_t i = 0; i < classes.size(); ++i) {
+      GenThreadPool::SizeClass& sc = pool->size_classes[i];
+      GenPoolClassStats& cls = stats.classes[i];
+      cls.capacity += classes[i].thread_capacity;
+      cls.hits += sc.hits.load(std::memory_order_relaxed);
+      cls.misses += sc.misses.load(std::memory_order_relaxed);
+      cls.free += sc.count.load(std::memory_order_relaxed) +
+          sc.returned_count.load(std::memory_order_relaxed);
+      frees[i] += sc.frees.load(std::memory_order_relaxed);
+    }
+  }
+  for (size_t i = 0; i < classes.size(); ++i) {
+    GenPoolClassStats& cls = stats.classes[i];
+    size_t allocations = cls.hits + cls.misses;
+    // The counters are read without stopping other threads, so may be out of
+    // step with each other.
+    cls.in_use = allocations > frees[i] ? allocations - frees[i] : 0;
+    stats.hits += cls.hits;
+    stats.misses += cls.misses;
+    stats.bytes_held += cls.free * cls.size;
+  }
+  return stats;
+}
+
+void JITGenFreeThreadedFreeList::atForkPrepare() {
+  registry_->mutex.lock();
+}
+
+void JITGenFreeThreadedFreeList::atForkParent() {
+  registry_->mutex.unlock();
+}
+
+void JITGenFreeThreadedFreeList::atForkChild() {
+  // Only the forking thread exists in the child, so every other pool is up
+  // for reuse.  The inherited mutex is still locked by atForkPrepare(), so its
+  // storage is reused without running the destructor, as
+  // ModuleState::atForkChild() does.
+  new (&registry_->mutex) std::mutex{};
+  GenThreadPool* current =
+      t_gen_pool.registry_id == registry_->id ? t_gen_pool.pool : nullptr;
+  registry_->parked.clear();
+  for (auto& pool : registry_->pools) {
+    if (pool.get() != current) {
+      registry_->parked.push_back(pool.get());
+    }
+  }
 }
 
 } // namespace cinderx::jit
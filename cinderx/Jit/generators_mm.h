@@ -4,60 +4,97 @@
 #include "cinderx/python.h"
 
 #include "cinderx/Common/ref.h"
+#include "cinderx/Jit/config.h"
 #include "cinderx/Jit/generators_mm_iface.h"
 
-#include <array>
+#include <memory>
+#include <vector>
 
 namespace cinderx::jit {
 
 struct JitGenObject;
 
-// These values were determined experimentally on IG's webservers by utilizing
-// the stats above. The number of outstanding requests seems to burst up to ~60k
-// on startup but then quickly settles down to around 1-2k, so 2048 entries
-// should be enough. The average size seems to be ~400 bytes with the max being
-// about 10x that. Performance experiments showed a size of 512 was a greater
-// improvement compared to 1024. Presumably the trade off in extra fixed memory
-// allocation cost on workers isn't worth it for greater sizes.
-constexpr size_t kGenFreeListEntries = 2048;
-constexpr size_t kGenFreeListEntrySize = 512;
-
-// Basically a free-list but the backing memory is pre-allocated in a single
-// block. This makes it possible to determine if the storage is from this pool
-// even after deopt by just examining a generator's pointer value.
+// Index into `classes` of the smallest class with entries of at least `size`
+// bytes, or -1 if there isn't one.
+int genPoolSizeClass(const std::vector<GenPoolSizeClass>& classes, size_t size);
+
+// Basically a set of free-lists, one per size class, but the backing memory is
+// reserved up front in a single block. This makes it possible to determine if
+// the storage is from this pool even after deopt by just examining a
+// generator's pointer value. Entries are handed out in address order the
+// first time they're needed, so unused capacity isn't touched.
 class JitGenFreeList : public IJitGenFreeList {
  public:
-  JitGenFreeList();
+  explicit JitGenFreeList(std::vector<GenPoolSizeClass> classes);
   ~JitGenFreeList() override = default;
 
   std::pair<JitGenObject*, size_t> allocate(
       BorrowedRef<PyCodeObject> code,
       uint64_t jit_spill_words) override;
-  void free(PyObject* ptr) override;
+  void free(PyObject* ptr, bool was_jit_gen) override;
+  GenPoolStats stats() const override;
+  size_t entrySize(BorrowedRef<PyCodeObject> code, uint64_t jit_data_size)
+      const override;
 
  private:
-  void* rawAllocate();
-  bool fromThisArena(void* ptr);
-
   struct Entry {
-    union {
-      uint8_t data[kGenFreeListEntrySize];
-      Entry* next;
-    };
+    Entry* next;
   };
 
-  std::array<Entry, kGenFreeListEntries> entries_;
-  Entry* head_;
+  struct Pool {
+    size_t entry_size{0};
+    uint8_t* begin{nullptr};
+    uint8_t* end{nullptr};
+    // Start of the entries that have never been handed out.
+    uint8_t* untouched{nullptr};
+    // Entries that have been handed out and freed again.
+    Entry* head{nullptr};
+    // Number of entries backing live generators.
+    size_t used{0};
+    size_t hits{0};
+    size_t misses{0};
+  };
+
+  static bool hasFree(const Pool& pool);
+  void* rawAllocate(Pool& pool);
+  Pool* poolFor(void* ptr);
+
+  std::vector<GenPoolSizeClass> classes_;
+  std::unique_ptr<uint8_t[]> arena_;
+  uint8_t* arena_end_{nullptr};
+  std::vector<Pool> pools_;
+  // Allocations too big for any size class.
+  size_t oversized_{0};
+  GenSizeHistogram size_histogram_{};
 };
 
+struct GenPoolRegistry;
+
+// Free-threaded builds give each thread its own pools. Generator memory still
+// comes from the general allocator, since the GC finds objects by walking its
+// heaps, but freed generators are cached per thread by size class rather than
+// released. A generator freed on a thread other than the one whose pool it was
+// allocated from goes back to that pool through a lock-free return queue, which
+// the owning thread drains when its own cache runs dry.
 class JITGenFreeThreadedFreeList : public IJitGenFreeList {
  public:
-  ~JITGenFreeThreadedFreeList() override = default;
+  explicit JITGenFreeThreadedFreeList(std::vector<GenPoolSizeClass> classes);
+  ~JITGenFreeThreadedFreeList() override;
 
   std::pair<JitGenObject*, size_t> allocate(
       BorrowedRef<PyCodeObject> code,
       uint64_t jit_spill_words) override;
-  void free(PyObject* ptr) override;
+  void free(PyObject* ptr, bool was_jit_gen) override;
+  GenPoolStats stats() const override;
+  size_t entrySize(BorrowedRef<PyCodeObject> code, uint64_t jit_data_size)
+      const override;
+
+  void atForkPrepare() override;
+  void atForkParent() override;
+  void atForkChild() override;
+
+ private:
+  std::shared_ptr<GenPoolRegistry> registry_;
 };
 
 } // namespace cinderx::jit
@@ -4,10 +4,68 @@
 
 #include "cinderx/Common/ref.h"
 
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <vector>
+
 namespace cinderx::jit {
 
 struct JitGenObject;
 
+// Generator allocations are counted by size in buckets of this many bytes.
+constexpr size_t kGenSizeHistogramBucketSize = 64;
+// Number of buckets.  Sizes too big for the last one are counted in it anyway.
+constexpr size_t kGenSizeHistogramBuckets = 256;
+
+using GenSizeHistogram = std::array<size_t, kGenSizeHistogramBuckets>;
+
+// Index of the histogram bucket that counts `size`, which covers sizes greater
+// than its index times the bucket size, up to and including the next multiple.
+inline size_t genSizeHistogramBucket(size_t size) {
+  size_t bucket = size == 0 ? 0 : (size - 1) / kGenSizeHistogramBucketSize;
+  return std::min(bucket, kGenSizeHistogramBuckets - 1);
+}
+
+// Counters for one size class of the generator pools.
+struct GenPoolClassStats {
+  // Size in bytes of the entries.
+  size_t size{0};
+  // Number of entries the pools can hold.  In free-threaded builds that's the
+  // per-thread capacity times the number of threads with pools.
+  size_t capacity{0};
+  // Allocations served from a pool.
+  size_t hits{0};
+  // Allocations of this size that had to go to the general allocator because
+  // the pools were empty.
+  size_t misses{0};
+  // Entries backing live generators.  In free-threaded builds this is
+  // approximate: generators that are deopted before being freed are counted
+  // as live forever.
+  size_t in_use{0};
+  // Entries held by the pools that aren't backing a live generator.
+  size_t free{0};
+};
+
+// Counters for the pools generator memory is recycled through.
+struct GenPoolStats {
+  // Allocations served from a pool.
+  size_t hits{0};
+  // Allocations that had to go to the general allocator.
+  size_t misses{0};
+  // Pooled generators freed by a thread other than the one whose pool they
+  // came from, and handed back to it.  Always 0 with the GIL.
+  size_t remote_frees{0};
+  // Memory held by the pools that isn't backing a live generator.
+  size_t bytes_held{0};
+  // Breakdown by size class, in increasing order of size.
+  std::vector<GenPoolClassStats> classes;
+  // Number of JIT generators allocated at each size, meaning the size a pool
+  // entry needs to be to hold them.  Includes allocations too big for any
+  // size class.
+  GenSizeHistogram size_histogram{};
+};
+
 class IJitGenFreeList {
  public:
   IJitGenFreeList() = default;
@@ -16,7 +74,25 @@ class IJitGenFreeList {
   virtual std::pair<JitGenObject*, size_t> allocate(
       BorrowedRef<PyCodeObject> code,
       uint64_t jit_spill_words) = 0;
-  virtual void free(PyObject* ptr) = 0;
+
+  // Free the memory for a generator that has been untracked and cleared.
+  // `was_jit_gen` is whether it was still a JIT generator when deallocation
+  // started, as opposed to one created by the interpreter or deopted earlier.
+  virtual void free(PyObject* ptr, bool was_jit_gen) = 0;
+
+  virtual GenPoolStats stats() const = 0;
+
+  // Size a pool entry needs to be to hold a generator with `jit_data_size`
+  // bytes of JIT data for `code`, which is what the size classes and the size
+  // histogram measure.
+  virtual size_t entrySize(
+      BorrowedRef<PyCodeObject> code,
+      uint64_t jit_data_size) const = 0;
+
+  // pthread_atfork() handlers for any locks the pools use.
+  virtual void atForkPrepare() {}
+  virtual void atForkParent() {}
+  virtual void atForkChild() {}
 };
 
 } // namespace cinderx::jit
@@ -60,7 +60,9 @@ void untrack(T arg) {
 
 // Reimplementation of CPython's gen_dealloc that uses our custom free-list
 // (Ci_free_jit_list_gen) instead of PyObject_GC_Del for memory recycling.
-void gen_dealloc_with_custom_free(PyObject* self) {
+// `was_jit_gen` is whether the generator was still a JIT generator before
+// being deopted for deallocation.
+void gen_dealloc_with_custom_free(PyObject* self, bool was_jit_gen) {
   JIT_DCHECK(
       PyGen_Check(self) || PyCoro_CheckExact(self),
       "gen_dealloc_with_custom_free called on a non-generator object");
@@ -105,15 +107,16 @@ void gen_dealloc_with_custom_free(PyObject* self) {
   Py_CLEAR(gen->gi_ci_awaiter);
 #endif
 
-  cinderx::getModuleState()->jit_gen_free_list->free(self);
+  cinderx::getModuleState()->jit_gen_free_list->free(self, was_jit_gen);
 }
 
 void jitgen_dealloc(PyObject* self) {
+  bool was_jit_gen = JitGenObject::cast(self) != nullptr;
   if (!deopt_jit_gen(self)) {
     JIT_ABORT("Tried to dealloc a running JIT generator");
   }
 
-  gen_dealloc_with_custom_free(self);
+  gen_dealloc_with_custom_free(self, was_jit_gen);
 }
 
 int jitgen_traverse(PyObject* obj, visitproc visit, void* arg) {
@@ -971,11 +974,13 @@ void init_jit_genobject_type() {
   copy_methods(PyGen_Type.tp_methods, gen_type->tp_methods);
   copy_methods(PyCoro_Type.tp_methods, coro_type->tp_methods);
 
+  const std::vector<GenPoolSizeClass>& classes = getConfig().gen_pool_classes;
   if constexpr (kFreeThreadedBuild) {
     cinderx::getModuleState()->jit_gen_free_list.reset(
-        new JITGenFreeThreadedFreeList());
+        new JITGenFreeThreadedFreeList(classes));
   } else {
-    cinderx::getModuleState()->jit_gen_free_list.reset(new JitGenFreeList());
+    cinderx::getModuleState()->jit_gen_free_list.reset(
+        new JitGenFreeList(classes));
   }
 
   // Override dealloc so we can use a "free-list" for our objects.
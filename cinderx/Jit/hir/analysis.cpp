@@ -112,6 +112,24 @@ RegisterSet collectDataUses(const Function& func) {
   return uses;
 }
 
+std::unordered_set<const BasicBlock*> findLoopHeaders(const Function& func) {
+  std::vector<BasicBlock*> rpo = func.cfg.getRPOTraversal();
+  std::unordered_map<const BasicBlock*, size_t> rpo_index;
+  for (size_t i = 0; i < rpo.size(); ++i) {
+    rpo_index.emplace(rpo[i], i);
+  }
+
+  std::unordered_set<const BasicBlock*> headers;
+  for (const BasicBlock* block : rpo) {
+    for (const Edge* edge : block->outEdges()) {
+      if (rpo_index.at(edge->to()) <= rpo_index.at(block)) {
+        headers.insert(edge->to());
+      }
+    }
+  }
+  return headers;
+}
+
 bool funcTypeChecks(const Function& func, std::ostream& err) {
   for (auto& block : func.cfg.blocks) {
     for (const Instr& instr : block) {
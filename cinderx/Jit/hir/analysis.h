@@ -42,6 +42,11 @@ bool registerTypeMatches(Type op_type, OperandType expected_type);
 // boxed float with its unboxed source.
 RegisterSet collectDataUses(const Function& func);
 
+// Collect the blocks in `func` that are the target of a retreating edge.  For
+// reducible CFGs these are the headers of the natural loops, which run once per
+// loop iteration.
+std::unordered_set<const BasicBlock*> findLoopHeaders(const Function& func);
+
 // Base class for dataflow analyses that compute facts about registers in the
 // HIR.
 //
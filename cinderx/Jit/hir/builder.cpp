@@ -27,6 +27,7 @@ extern "C" {
 #include "cinderx/Jit/threaded_compile.h"
 #include "cinderx/StaticPython/checked_dict.h"
 #include "cinderx/StaticPython/checked_list.h"
+#include "cinderx/StaticPython/checked_prim_dict.h"
 #include "cinderx/StaticPython/classloader.h"
 #include "cinderx/StaticPython/static_array.h"
 #include "cinderx/StaticPython/typed_method_def.h"
@@ -667,6 +668,7 @@ void HIRBuilder::emitTypeAnnotationGuards(TranslationContext& tc) {
 BasicBlock* HIRBuilder::buildHIRImpl(
     Function* irfunc,
     FrameState* frame_state) {
+  irfunc_ = irfunc;
   env_ = &irfunc->env;
   block_canonicalizer_.emplace(&irfunc->env);
 
@@ -2378,6 +2380,127 @@ bool HIRBuilder::tryEmitStaticRandCall(
   return true;
 }
 
+bool HIRBuilder::isCheckedPrimDictCall(const InvokeTarget& target) {
+  return target.builtin_c_func == (void*)Ci_CheckedPrimDict_GetItem ||
+      target.builtin_c_func == (void*)Ci_CheckedPrimDict_SetItem ||
+      target.builtin_c_func == (void*)Ci_CheckedPrimDict_Contains;
+}
+
+Register* HIRBuilder::unboxedCheckedPrimDictArg(
+    TranslationContext& tc,
+    Register* reg,
+    int type_code) {
+  // The compiler boxes primitive keys and values right before invoking the
+  // method, so the primitive is available from the box.
+  Type type = prim_type_to_type(type_code);
+  Instr* def = reg->instr();
+  Register* value;
+  if (type <= TCBool) {
+    if (!def->isPrimitiveBoxBool()) {
+      return nullptr;
+    }
+    value = def->getOperand(0);
+  } else {
+    if (!def->isPrimitiveBox() ||
+        static_cast<PrimitiveBox*>(def)->type() != type) {
+      return nullptr;
+    }
+    value = static_cast<PrimitiveBox*>(def)->value();
+  }
+  if (type <= TCDouble || type <= TCInt64 || type <= TCUInt64) {
+    return value;
+  }
+  // The unboxed entry points take integers widened to 64 bits.
+  Register* wide = allocateTemp();
+  tc.emit<PrimitiveConvert>(
+      wide, value, type <= TCSigned ? TCInt64 : TCUInt64);
+  return wide;
+}
+
+bool HIRBuilder::tryEmitCheckedPrimDictCall(
+    const InvokeTarget& target,
+    TranslationContext& tc,
+    long nargs) {
+  // Subscripts and `in` tests on a chkprimdict call the unboxed entry points
+  // directly, rather than boxing the key and value just so that the method
+  // can unbox them again.
+  BorrowedRef<> callable = target.callable;
+  if (Py_TYPE(callable) != &PyMethodDescr_Type) {
+    return false;
+  }
+  PyTypeObject* type = reinterpret_cast<PyDescrObject*>(callable.get())->d_type;
+  int key_code = Ci_CheckedPrimDict_KeyType(type);
+  int value_code = Ci_CheckedPrimDict_ValueType(type);
+  if (key_code < 0 || value_code < 0) {
+    return false;
+  }
+  bool double_key = key_code == TYPED_DOUBLE;
+  bool double_value = value_code == TYPED_DOUBLE;
+
+  auto& stack = tc.frame.stack;
+  if (target.builtin_c_func == (void*)Ci_CheckedPrimDict_SetItem) {
+    if (nargs != 3) {
+      return false;
+    }
+    Register* key = unboxedCheckedPrimDictArg(tc, stack.top(1), key_code);
+    if (key == nullptr) {
+      return false;
+    }
+    Register* value = unboxedCheckedPrimDictArg(tc, stack.top(0), value_code);
+    if (value == nullptr) {
+      return false;
+    }
+    void* func = double_key
+        ? (double_value ? (void*)Ci_CheckedPrimDict_SetDoubleDouble
+                        : (void*)Ci_CheckedPrimDict_SetDoubleInt)
+        : (double_value ? (void*)Ci_CheckedPrimDict_SetIntDouble
+                        : (void*)Ci_CheckedPrimDict_SetIntInt);
+    stack.discard(2);
+    Register* self = stack.pop();
+    Register* err = allocateTemp();
+    tc.emit<CallStatic>(3, err, func, TCInt32, self, key, value);
+    tc.emit<CheckNeg>(err, err, tc.frame);
+    Register* none = allocateTemp();
+    tc.emit<LoadConst>(none, TNoneType);
+    stack.push(none);
+    return true;
+  }
+
+  if (nargs != 2) {
+    return false;
+  }
+  Register* key = unboxedCheckedPrimDictArg(tc, stack.top(0), key_code);
+  if (key == nullptr) {
+    return false;
+  }
+  stack.discard(1);
+  Register* self = stack.pop();
+  Register* out = allocateTemp();
+  if (target.builtin_c_func == (void*)Ci_CheckedPrimDict_Contains) {
+    Register* found = allocateTemp();
+    void* func = double_key ? (void*)Ci_CheckedPrimDict_ContainsDouble
+                            : (void*)Ci_CheckedPrimDict_ContainsInt;
+    tc.emit<CallStatic>(2, found, func, TCBool, self, key);
+    tc.emit<PrimitiveBoxBool>(out, found);
+    stack.push(out);
+    return true;
+  }
+
+  Register* index = allocateTemp();
+  void* lookup = double_key ? (void*)Ci_CheckedPrimDict_LookupDouble
+                            : (void*)Ci_CheckedPrimDict_LookupInt;
+  tc.emit<CallStatic>(2, index, lookup, TCInt64, self, key);
+  tc.emit<CheckNeg>(index, index, tc.frame);
+  Register* value = allocateTemp();
+  Type value_type = prim_type_to_type(value_code);
+  void* value_at = double_value ? (void*)Ci_CheckedPrimDict_DoubleValueAt
+                                : (void*)Ci_CheckedPrimDict_IntValueAt;
+  tc.emit<CallStatic>(2, value, value_at, value_type, self, index);
+  boxPrimitive(tc, out, value, value_type);
+  stack.push(out);
+  return true;
+}
+
 void HIRBuilder::emitInvokeFunction(
     TranslationContext& tc,
     const jit::BytecodeInstruction& bc_instr) {
@@ -2421,6 +2544,10 @@ void HIRBuilder::emitInvokeFunction(
       tc.frame.stack.push(out);
 
       return;
+    } else if (
+        isCheckedPrimDictCall(target) &&
+        tryEmitCheckedPrimDictCall(target, tc, nargs)) {
+      return;
     } else if (
         target.isBuiltin() && tryEmitDirectMethodCall(target, tc, nargs)) {
       return;
@@ -2504,6 +2631,29 @@ void HIRBuilder::emitLoadMethodStatic(
 
   const InvokeTarget& target = preloader_.invokeMethodTarget(descr);
 
+  if (!is_classmethod && target.monomorphic_type != nullptr) {
+    // Nothing overrides the method, so skip the vtable and load the function
+    // directly.  Deopt back to this instruction if that stops being true.
+    auto patchpoint = tc.emit<DeoptPatchpoint>(
+        irfunc_->allocateCodePatcher<MethodOverrideDeoptPatcher>(
+            target.monomorphic_type,
+            target.monomorphic_name,
+            target.override_epoch));
+    env_->addReference(target.monomorphic_type.getObj());
+    env_->addReference(target.monomorphic_name.getObj());
+    patchpoint->setFrameState(tc.frame);
+    patchpoint->setDescr("MethodOverrideDeoptPatcher");
+
+    Register* self = tc.frame.stack.pop();
+    Register* func_obj = allocateTemp();
+    tc.emit<LoadConst>(func_obj, Type::fromObject(target.callable));
+    // A null entry tells emitInvokeMethod to call the function directly.
+    static_method_stack_.push(nullptr);
+    tc.frame.stack.push(func_obj);
+    tc.frame.stack.push(self);
+    return;
+  }
+
   Register* self = tc.frame.stack.pop();
   auto type = allocateTemp();
   if (!is_classmethod) {
@@ -2579,6 +2729,17 @@ void HIRBuilder::emitInvokeMethod(
   if (target.is_statically_typed) {
     Register* out = allocateTemp();
     auto entry = static_method_stack_.pop();
+    if (entry == nullptr) {
+      // Devirtualized by emitLoadMethodStatic, arg_regs[0] is the function.
+      auto invoke = tc.emit<InvokeStaticFunction>(
+          nargs, out, target.func(), target.return_type);
+      for (size_t i = 0; i < arg_regs.size(); i++) {
+        invoke->setOperand(i, arg_regs[i]);
+      }
+      invoke->setFrameState(tc.frame);
+      tc.frame.stack.push(out);
+      return;
+    }
     auto invoke =
         tc.emit<CallInd>(nargs + 1, out, "vtable invoke", target.return_type);
     invoke->setOperand(0, entry);
@@ -3259,8 +3420,26 @@ static inline Type element_type_from_seq_type(int seq_type) {
     case SEQ_CHECKED_LIST:
     case SEQ_TUPLE:
       return TObject;
+    case SEQ_ARRAY_INT8:
+      return TCInt8;
+    case SEQ_ARRAY_INT16:
+      return TCInt16;
+    case SEQ_ARRAY_INT32:
+      return TCInt32;
     case SEQ_ARRAY_INT64:
       return TCInt64;
+    case SEQ_ARRAY_UINT8:
+      return TCUInt8;
+    case SEQ_ARRAY_UINT16:
+      return TCUInt16;
+    case SEQ_ARRAY_UINT32:
+      return TCUInt32;
+    case SEQ_ARRAY_UINT64:
+      return TCUInt64;
+    case SEQ_ARRAY_DOUBLE:
+      return TCDouble;
+    case SEQ_ARRAY_BOOL:
+      return TCBool;
     default:
       JIT_THROW("Invalid sequence type: ({})", seq_type);
   }
@@ -3478,7 +3657,7 @@ void HIRBuilder::emitSequenceGet(
       oparg == SEQ_CHECKED_LIST) {
     int offset = offsetof(PyListObject, ob_item);
     tc.emit<LoadField>(ob_item, sequence, "ob_item", offset, TCPtr);
-  } else if (oparg == SEQ_ARRAY_INT64) {
+  } else if (SEQ_IS_ARRAY(oparg)) {
     Register* offset_reg = allocateTemp();
     tc.emit<LoadConst>(
         offset_reg,
@@ -3512,7 +3691,7 @@ void HIRBuilder::emitSequenceSet(
   }
   tc.emit<CheckSequenceBounds>(adjusted_idx, sequence, idx, tc.frame);
   auto ob_item = allocateTemp();
-  if (oparg == SEQ_ARRAY_INT64) {
+  if (SEQ_IS_ARRAY(oparg)) {
     Register* offset_reg = allocateTemp();
     tc.emit<LoadConst>(
         offset_reg,
@@ -4099,6 +4278,10 @@ void HIRBuilder::emitUnpackSequence(
   // Determine whether the slow path (iterator protocol) is needed.
   // When the type is statically known to be tuple or list (and list is
   // not disabled for free-threading), we can skip the slow path entirely.
+  //
+  // In free-threaded builds a list's items have to be copied out with its lock
+  // held, so lists always go to the slow path, where rt::unpackSequence() has
+  // a fast path for them.
   bool needs_slow_path =
       !seq->isA(TTupleExact) && (kFreeThreadedBuild || !seq->isA(TListExact));
 
@@ -4136,7 +4319,6 @@ void HIRBuilder::emitUnpackSequence(
   if (seq->isA(TTupleExact)) {
     tc.emit<Branch>(tuple_fast_path);
   } else if (seq->isA(TListExact)) {
-    // TODO(T255264577). Enable this again. See P2169677587.
     if constexpr (kFreeThreadedBuild) {
       tc.emit<Branch>(slow_path);
     } else {
@@ -4147,7 +4329,6 @@ void HIRBuilder::emitUnpackSequence(
         seq, TTupleExact, tuple_fast_path, list_check_path);
 
     tc.block = list_check_path;
-    // TODO(T255264577). Enable this again. See P2169677587.
     if constexpr (kFreeThreadedBuild) {
       tc.emit<Branch>(slow_path);
     } else {
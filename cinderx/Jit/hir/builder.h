@@ -500,6 +500,15 @@ class HIRBuilder {
       const InvokeTarget& target,
       TranslationContext& tc,
       long nargs);
+  bool isCheckedPrimDictCall(const InvokeTarget& target);
+  Register* unboxedCheckedPrimDictArg(
+      TranslationContext& tc,
+      Register* reg,
+      int type_code);
+  bool tryEmitCheckedPrimDictCall(
+      const InvokeTarget& target,
+      TranslationContext& tc,
+      long nargs);
   struct BlockMap {
     std::unordered_map<BCOffset, BasicBlock*> blocks;
     std::unordered_map<BasicBlock*, BytecodeInstructionBlock> bc_blocks;
@@ -543,6 +552,9 @@ class HIRBuilder {
   BlockMap block_map_;
   const Preloader& preloader_;
 
+  // The function being built (or inlined into), set in buildHIRImpl.
+  Function* irfunc_{nullptr};
+
   // The function's register Environment, set in buildHIRImpl.
   Environment* env_{nullptr};
 
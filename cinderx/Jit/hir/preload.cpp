@@ -8,6 +8,7 @@
 #include "cinderx/Common/util.h"
 #include "cinderx/Interpreter/cinder_opcode.h"
 #include "cinderx/Jit/bytecode.h"
+#include "cinderx/Jit/config.h"
 #include "cinderx/StaticPython/classloader.h"
 #include "cinderx/StaticPython/strictmoduleobject.h"
 #include "cinderx/StaticPython/vtable_builder.h"
@@ -93,6 +94,66 @@ void fill_primitive_arg_types_builtin(BorrowedRef<> callable, ArgTypeMap& map) {
   }
 }
 
+// Check if any subclass of type, direct or indirect, defines name in its own
+// dict.  Subclasses that aren't statically defined count as overriding
+// everything, since their instances can shadow methods with instance
+// attributes.  Failures are conservatively reported as an override.
+bool subclass_overrides(BorrowedRef<PyTypeObject> type, BorrowedRef<> name) {
+  auto subclasses = Ref<>::steal(
+      PyObject_CallMethod(type.getObj(), "__subclasses__", nullptr));
+  if (subclasses == nullptr || !PyList_Check(subclasses)) {
+    PyErr_Clear();
+    return true;
+  }
+  for (Py_ssize_t i = 0; i < PyList_GET_SIZE(subclasses.get()); i++) {
+    BorrowedRef<PyTypeObject> subclass{PyList_GET_ITEM(subclasses.get(), i)};
+    BorrowedRef<> dict{_PyType_GetDict(subclass)};
+    if (!PyType_HasFeature(subclass, Ci_Py_TPFLAGS_IS_STATICALLY_DEFINED) ||
+        dict == nullptr || PyDict_GetItem(dict, name) != nullptr ||
+        subclass_overrides(subclass, name)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+// Record on target that a LOAD_METHOD_STATIC can call its method directly, if
+// the method is a statically typed function defined on container and nothing
+// in the class hierarchy below container overrides it.
+void resolve_monomorphic_method(
+    InvokeTarget& target,
+    BorrowedRef<> descr,
+    BorrowedRef<> container) {
+  if (!getConfig().devirtualize_static_methods ||
+      !target.is_statically_typed || !target.isFunction() ||
+      container == nullptr || !PyType_Check(container) ||
+      !PyTuple_Check(descr) || PyTuple_GET_SIZE(descr.get()) == 0) {
+    return;
+  }
+  BorrowedRef<> name =
+      PyTuple_GET_ITEM(descr.get(), PyTuple_GET_SIZE(descr.get()) - 1);
+  if (!PyUnicode_CheckExact(name)) {
+    return;
+  }
+  BorrowedRef<PyTypeObject> type{container};
+  BorrowedRef<> dict{_PyType_GetDict(type)};
+  // Class and static methods, properties, and patched thunks are stored in the
+  // dict as something other than the resolved callable.
+  if (dict == nullptr || PyDict_GetItem(dict, name) != target.callable) {
+    return;
+  }
+
+  // Notifications delivered from here on are caught by comparing epochs when
+  // the patcher is linked.
+  uint64_t epoch = MethodOverrideDeoptPatcher::currentEpoch();
+  if (subclass_overrides(type, name)) {
+    return;
+  }
+  target.monomorphic_type = Ref<PyTypeObject>::create(type);
+  target.monomorphic_name = Ref<PyUnicodeObject>::create(name);
+  target.override_epoch = epoch;
+}
+
 #ifndef WIN32
 std::unique_ptr<NativeTarget> resolve_native_target(
     BorrowedRef<> native_descr,
@@ -216,6 +277,11 @@ Preloader::invokeFunctionTargets() const {
   return func_targets_;
 }
 
+const DescrMap<std::unique_ptr<InvokeTarget>>&
+Preloader::invokeMethodTargets() const {
+  return meth_targets_;
+}
+
 const GlobalNamesMap& Preloader::globalNames() const {
   return global_names_;
 }
@@ -664,6 +730,9 @@ std::unique_ptr<InvokeTarget> Preloader::resolveTargetDescr(
         "Method lookup failed for descr {} in function {}",
         repr(descr),
         fullname());
+    if (!is_thunk) {
+      resolve_monomorphic_method(*target, descr, container);
+    }
   } else { // the rest of this only used by INVOKE_FUNCTION currently
     if (!target->container_is_immutable) {
       target->indirect_ptr = _PyClassLoader_ResolveIndirectPtr(descr);
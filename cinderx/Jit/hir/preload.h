@@ -11,6 +11,7 @@
 #include "cinderx/Jit/hir/type.h"
 #include "cinderx/StaticPython/typed-args-info.h"
 
+#include <cstdint>
 #include <memory>
 #include <string>
 #include <unordered_map>
@@ -69,6 +70,14 @@ struct InvokeTarget {
   bool builtin_returns_void{false};
   // is a METH_TYPED builtin that returns integer error code
   bool builtin_returns_error_code{false};
+  // Declaring type and name of a statically typed method that no subclass
+  // overrides (LOAD_METHOD_STATIC only), nullptr otherwise.  Calls to it can be
+  // made directly behind a MethodOverrideDeoptPatcher.
+  Ref<PyTypeObject> monomorphic_type;
+  Ref<PyUnicodeObject> monomorphic_name;
+  // MethodOverrideDeoptPatcher::currentEpoch() when the class hierarchy of
+  // monomorphic_type was checked.
+  uint64_t override_epoch{0};
 };
 
 // The target of an INVOKE_NATIVE
@@ -114,6 +123,9 @@ class Preloader {
   // All functions (not methods) invoked by the code object.
   const DescrMap<std::unique_ptr<InvokeTarget>>& invokeFunctionTargets() const;
 
+  // All methods invoked by the code object.
+  const DescrMap<std::unique_ptr<InvokeTarget>>& invokeMethodTargets() const;
+
   // All global names used by the code object.
   const GlobalNamesMap& globalNames() const;
 
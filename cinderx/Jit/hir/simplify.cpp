@@ -10,7 +10,9 @@
 #include "cinderx/Common/property.h"
 #include "cinderx/Common/py-portability.h"
 #include "cinderx/Common/type.h"
+#include "cinderx/Immortalize/immortalize.h"
 #include "cinderx/Jit/context.h"
+#include "cinderx/Jit/deopt.h"
 #include "cinderx/Jit/hir/analysis.h"
 #include "cinderx/Jit/hir/clean_cfg.h"
 #include "cinderx/Jit/hir/copy_propagation.h"
@@ -814,6 +816,13 @@ Register* simplifyLoadTypeMethodCached(Env& env, const LoadMethod* load_meth) {
   Register* receiver = load_meth->getOperand(0);
   const int cache_id = env.func.env.allocateLoadTypeMethodCache();
   env.emit<UseType>(receiver, TType);
+  if constexpr (kFreeThreadedBuild) {
+    // The cache's fields can't be read with plain loads while other threads
+    // are filling it, so go straight to the helper, which checks the cache
+    // under its seqlock.
+    return env.emit<FillTypeMethodCache>(
+        receiver, load_meth->nameIdx(), cache_id, *load_meth->frameState());
+  }
   Register* guard = env.emit<LoadTypeMethodCacheEntryType>(cache_id);
   Register* type_matches =
       env.emit<PrimitiveCompare>(PrimitiveCompareOp::kEqual, guard, receiver);
@@ -842,6 +851,10 @@ Register* simplifyLoadMethod(Env& env, const LoadMethod* load_meth) {
   }
   BorrowedRef<PyTypeObject> type{ty.runtimePyType()};
   if (type == &PyModule_Type || type == &Ci_StrictModule_Type) {
+    if constexpr (kFreeThreadedBuild) {
+      // See T250369692.
+      return nullptr;
+    }
     return simplifyLoadModuleMethodCached(env, load_meth);
   }
   return env.emit<LoadMethodCached>(
@@ -992,9 +1005,10 @@ Register* simplifySubscript(Env& env, const BinaryOp* instr) {
   // In free-threaded builds we can't use the borrowed LoadArrayItem path for
   // lists because another thread may overwrite the slot at any time.  With an
   // exact list, we can still skip PyObject_GetItem's generic dispatch by
-  // emitting ListSubscr, which returns an owned reference via
-  // PyList_GetItemRef.  Exact tuples are immutable once published, so their
-  // items stay alive as long as the tuple does and keep the direct path.
+  // emitting ListSubscr, which reads the item optimistically, as
+  // BINARY_OP_SUBSCR_LIST_INT does, and returns an owned reference.  Exact
+  // tuples are immutable once published, so their items stay alive as long as
+  // the tuple does and keep the direct path.
   if (kFreeThreadedBuild && lhs->isA(TListExact)) {
     return env.emit<ListSubscr>(lhs, rhs, *instr->frameState());
   }
@@ -1524,9 +1538,12 @@ Register* simplifyPrimitiveBoxBool(Env& env, const PrimitiveBoxBool* instr) {
 Register* simplifyUnbox(Env& env, const Instr* instr) {
   Register* input_value = instr->getOperand(0);
   Type output_type = instr->output()->type();
-  if (input_value->instr()->isPrimitiveBox()) {
+  // Look through RefineTypes, which Static Python emits between boxing the
+  // result of a call and unboxing it again.
+  Register* boxed_value = modelReg(input_value);
+  if (boxed_value->instr()->isPrimitiveBox()) {
     // Simplify unbox(box(x)) -> x
-    const auto box = static_cast<PrimitiveBox*>(input_value->instr());
+    const auto box = static_cast<PrimitiveBox*>(boxed_value->instr());
     if (box->type() == output_type) {
       // We can't optimize away the potential overflow in unboxing.
       return box->getOperand(0);
@@ -1871,6 +1888,94 @@ Register* simplifyLoadAttrInstanceReceiver(
   return nullptr;
 }
 
+// Whether a module or class attribute currently holding `value` should be
+// pinned so that refcounting it can be skipped.  The pin deopts on every call
+// once the attribute is rebound, so only values frozen by immortalize_heap()
+// qualify.  None, bools, ints, floats, and strings are left out even then:
+// they are immortal without a freeze and they're what flags and counters get
+// rebound to.
+bool isPinnableImmortalValue(BorrowedRef<> value) {
+  if (!heap_immortalized() || value == Py_None || PyBool_Check(value) ||
+      PyLong_CheckExact(value) || PyFloat_CheckExact(value) ||
+      PyUnicode_CheckExact(value)) {
+    return false;
+  }
+  return !Type::fromObject(value).couldBe(TMortalObject);
+}
+
+// Pin the attribute that `load_attr` reads to its current `value`, with a
+// GuardIs on `cached`, the result of the runtime cache lookup.  Returns nullptr
+// without pinning if a pin of this load has failed before: the attribute has
+// been rebound since, and pinning it again would deopt on every call.
+Register* emitAttrPin(
+    Env& env,
+    const LoadAttr* load_attr,
+    BorrowedRef<> value,
+    Register* cached) {
+  const FrameState* load_frame = load_attr->frameState();
+  if (getContext()->hasFailedPin(load_frame->code, load_frame->instrOffset())) {
+    return nullptr;
+  }
+
+  // Unlike LoadGlobalCached, LoadModuleAttrCached and FillTypeAttrCache are
+  // not replayable (their slow paths can run arbitrary code), so they reset the
+  // guard-binding pass's notion of the dominating FrameState. Emit a Snapshot
+  // with the load's FrameState so the following GuardIs deopts back to
+  // re-executing this load. The load's FrameState was captured after the
+  // receiver was popped off the operand stack, so push it back on:
+  // re-executing LOAD_ATTR reads the receiver from the top of the interpreter's
+  // stack.
+  FrameState frame{*load_frame};
+  frame.stack.push(load_attr->getOperand(0));
+  env.emit<Snapshot>(frame);
+  auto guard =
+      env.emitInstr<GuardIs>(env.func.env.addReference(value), cached);
+  guard->setDescr(std::string{kPinnedAttrGuardDescr});
+  return guard->output();
+}
+
+// Resolve an attribute of the statically-known type `type` at compile time.
+// Only attributes that are plain values are resolved: the metatype must use the
+// stock attribute lookup and not define the name itself, and the value found
+// on the type must not be a descriptor.  Returns nullptr if the attribute
+// can't be safely resolved.
+BorrowedRef<> loadTypeAttrSafe(
+    BorrowedRef<PyTypeObject> type,
+    BorrowedRef<PyUnicodeObject> name) {
+  BorrowedRef<PyTypeObject> metatype{Py_TYPE(type)};
+  if (metatype->tp_getattro != PyType_Type.tp_getattro ||
+      !PyUnicode_CheckExact(name) || !ensureVersionTag(type) ||
+      typeLookupSafe(metatype, name) != nullptr) {
+    return nullptr;
+  }
+  BorrowedRef<> value = typeLookupSafe(type, name);
+  if (value == nullptr || Py_TYPE(value)->tp_descr_get != nullptr) {
+    return nullptr;
+  }
+  return value;
+}
+
+// Given the result of a type attribute cache lookup of `load_attr`'s attribute
+// on a statically-known type, pin it with a GuardIs if the attribute currently
+// holds a value frozen by immortalize_heap().  That lets refcount insertion
+// drop the refcounting of the result.  The GuardIs deopts if the attribute is
+// later rebound.
+// Returns the pinned register, or nullptr if nothing was pinned.
+Register*
+pinTypeAttr(Env& env, const LoadAttr* load_attr, Register* cached) {
+  Type receiver_type = modelReg(load_attr->getOperand(0))->type();
+  if (!receiver_type.hasObjectSpec() ||
+      !PyType_Check(receiver_type.objectSpec())) {
+    return nullptr;
+  }
+  BorrowedRef<PyTypeObject> type{receiver_type.objectSpec()};
+  BorrowedRef<> value = loadTypeAttrSafe(type, load_attr->name());
+  if (value == nullptr || !isPinnableImmortalValue(value)) {
+    return nullptr;
+  }
+  return emitAttrPin(env, load_attr, value, cached);
+}
+
 Register* simplifyLoadAttrTypeReceiver(Env& env, const LoadAttr* load_attr) {
   Register* receiver = load_attr->getOperand(0);
   if (!receiver->isA(TType)) {
@@ -1879,10 +1984,19 @@ Register* simplifyLoadAttrTypeReceiver(Env& env, const LoadAttr* load_attr) {
 
   const int cache_id = env.func.env.allocateLoadTypeAttrCache();
   env.emit<UseType>(receiver, TType);
+  if constexpr (kFreeThreadedBuild) {
+    // As in simplifyLoadTypeMethodCached(), only the helper may read the cache.
+    Register* cached = env.emit<FillTypeAttrCache>(
+        receiver, load_attr->nameIdx(), cache_id, *load_attr->frameState());
+    if (Register* reg = pinTypeAttr(env, load_attr, cached)) {
+      return reg;
+    }
+    return cached;
+  }
   Register* guard = env.emit<LoadTypeAttrCacheEntryType>(cache_id);
   Register* type_matches =
       env.emit<PrimitiveCompare>(PrimitiveCompareOp::kEqual, guard, receiver);
-  return env.emitCond(
+  Register* cached = env.emitCond(
       [&](BasicBlock* fast_path, BasicBlock* slow_path) {
         env.emit<CondBranch>(type_matches, fast_path, slow_path);
       },
@@ -1894,6 +2008,10 @@ Register* simplifyLoadAttrTypeReceiver(Env& env, const LoadAttr* load_attr) {
         return env.emit<FillTypeAttrCache>(
             receiver, name_idx, cache_id, *load_attr->frameState());
       });
+  if (Register* reg = pinTypeAttr(env, load_attr, cached)) {
+    return reg;
+  }
+  return cached;
 }
 
 // Resolve a module attribute at compile time, mirroring the safety checks in
@@ -1977,15 +2095,17 @@ BorrowedRef<> staticModuleForReceiver(Register* reg) {
 
 // Given a LoadModuleAttrCached (cached) that reads `load_attr`'s attribute from
 // the statically-known module `mod`, resolve the attribute at compile time and,
-// if it is itself a module or a type, pin its identity with a GuardIs. Returns
-// the pinned register, or nullptr if nothing was pinned (leaving `cached`
-// as-is).
+// if it is itself a module, a type, or a frozen value, pin its identity with a
+// GuardIs. Returns the pinned register, or nullptr if nothing was pinned
+// (leaving `cached` as-is).
 //
 // Pinning modules lets a chain like `pkg.submod.attr` recognize each level as a
-// module; pinning types exposes the concrete type to type-based optimizations.
-// Other values (functions, constants, ...) are left to the runtime cache. The
-// GuardIs deopts if the attribute is later rebound to a different object, and
-// the runtime LoadModuleAttrCached is retained for correctness.
+// module; pinning types exposes the concrete type to type-based optimizations;
+// pinning values frozen by immortalize_heap() lets refcount insertion drop
+// their refcounting.
+// Other values are left to the runtime cache. The GuardIs deopts if the
+// attribute is later rebound to a different object, and the runtime
+// LoadModuleAttrCached is retained for correctness.
 Register* pinModuleAttr(
     Env& env,
     BorrowedRef<> mod,
@@ -2000,21 +2120,10 @@ Register* pinModuleAttr(
   BorrowedRef<> value = loadModuleAttrSafe(mod, name);
   if (value == nullptr ||
       !(PyModule_Check(value) || Ci_StrictModule_Check(value) ||
-        PyType_Check(value))) {
+        PyType_Check(value) || isPinnableImmortalValue(value))) {
     return nullptr;
   }
-
-  // Unlike LoadGlobalCached, LoadModuleAttrCached is not replayable (its slow
-  // path can run arbitrary code), so it resets the guard-binding pass's notion
-  // of the dominating FrameState. Emit a Snapshot with the load's FrameState so
-  // the following GuardIs deopts back to re-executing this load. The load's
-  // FrameState was captured after the receiver was popped off the operand
-  // stack, so push it back on: re-executing LOAD_ATTR reads the receiver from
-  // the top of the interpreter's stack.
-  FrameState frame{*load_attr->frameState()};
-  frame.stack.push(load_attr->getOperand(0));
-  env.emit<Snapshot>(frame);
-  return env.emit<GuardIs>(env.func.env.addReference(value), cached);
+  return emitAttrPin(env, load_attr, value, cached);
 }
 
 Register* simplifyLoadAttr(Env& env, const LoadAttr* load_attr) {
@@ -2031,6 +2140,10 @@ Register* simplifyLoadAttr(Env& env, const LoadAttr* load_attr) {
     BorrowedRef<PyTypeObject> type{ty.runtimePyType()};
 
     if (type == &PyModule_Type || type == &Ci_StrictModule_Type) {
+      if constexpr (kFreeThreadedBuild) {
+        // See T250369692.
+        return nullptr;
+      }
       Register* cached = env.emit<LoadModuleAttrCached>(
           load_attr->getOperand(0),
           load_attr->nameIdx(),
@@ -2502,7 +2615,8 @@ Register* simplifyStoreSubscr(Env& env, const StoreSubscr* instr) {
     return nullptr;
   }
 
-  // TODO(T255264263). Enable this for FT builds. See P2169673256.
+  // In free-threaded builds the store has to be done with the list's lock held,
+  // so it's left to the code generator, which calls rt::listStoreSubscript().
   if (!kFreeThreadedBuild && instr->getOperand(0)->isA(TListExact) &&
       instr->getOperand(1)->isA(TLongExact)) {
     Register* container = instr->getOperand(0);
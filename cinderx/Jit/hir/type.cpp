@@ -380,10 +380,15 @@ Type Type::fromTypeImpl(PyTypeObject* type, bool exact) {
     return exact ? it->second & TBuiltinExact : it->second;
   }
 
-  // Heap types that we're aware of, not statically known
-  if (PyType_IsSubtype(type, PyStaticArray_Type)) {
+  // Heap types that we're aware of, not statically known.  The int64 array
+  // is plain TArray, arrays of other element types are TArray specialized
+  // with their type.
+  if (type == PyStaticArray_Type) {
     return TArray;
   }
+  if (_Ci_StaticArray_ElementType(type) >= 0) {
+    return Type{TArray.bits_, kLifetimeTop, type, true};
+  }
 
   JIT_CHECK(
       type->tp_mro != nullptr && type->tp_flags & Py_TPFLAGS_READY,
@@ -0,0 +1,160 @@
+// Copyright (c) Meta Platforms, Inc. and affiliates.
+
+#include "cinderx/Jit/hot_manifest.h"
+
+#include "cinderx/Common/code.h"
+
+#include <fmt/format.h>
+
+#include <charconv>
+#include <fstream>
+#include <stdexcept>
+
+namespace cinderx::jit {
+
+namespace {
+
+// Split off the part of `str` up to the first `sep`, leaving the rest in
+// `str`.
+std::string_view nextField(std::string_view& str, char sep) {
+  size_t pos = str.find(sep);
+  std::string_view field = str.substr(0, pos);
+  str = pos == std::string_view::npos ? std::string_view{}
+                                      : str.substr(pos + 1);
+  return field;
+}
+
+template <typename T>
+bool parseNumber(std::string_view str, T& value, int base = 10) {
+  auto end = str.data() + str.size();
+  auto [ptr, ec] = std::from_chars(str.data(), end, value, base);
+  return ec == std::errc{} && ptr == end;
+}
+
+// Names are separated by spaces, commas, and equals signs in the manifest.
+bool isWritableName(std::string_view name) {
+  return !name.empty() && name.find_first_of(" \t,=") == std::string_view::npos;
+}
+
+std::string_view unicodeView(BorrowedRef<> str) {
+  if (str == nullptr || !PyUnicode_Check(str)) {
+    return {};
+  }
+  Py_ssize_t size;
+  const char* data = PyUnicode_AsUTF8AndSize(str, &size);
+  if (data == nullptr) {
+    PyErr_Clear();
+    return {};
+  }
+  return {data, static_cast<size_t>(size)};
+}
+
+} // namespace
+
+void HotManifest::parseFile(const char* filename) {
+  std::ifstream fstream(filename);
+  if (!fstream) {
+    throw std::runtime_error{
+        fmt::format("Unable to open hot manifest file {}", filename)};
+  }
+
+  int lineno = 1;
+  for (std::string line; getline(fstream, line);) {
+    if (!parseLine(line)) {
+      throw std::runtime_error{fmt::format(
+          "Error while parsing line {} in hot manifest file {}",
+          lineno,
+          filename)};
+    }
+    lineno++;
+  }
+}
+
+bool HotManifest::parseLine(std::string_view line) {
+  if (line.empty() || line.at(0) == '#') {
+    return true;
+  }
+
+  HotManifestEntry entry;
+  std::string_view name = nextField(line, ' ');
+  size_t cln_pos = name.find(':');
+  if (cln_pos == std::string_view::npos || cln_pos == 0 ||
+      cln_pos == name.size() - 1) {
+    return false;
+  }
+  entry.module = name.substr(0, cln_pos);
+  entry.qualname = name.substr(cln_pos + 1);
+  if (!parseNumber(nextField(line, ' '), entry.code_hash, 16) ||
+      !parseNumber(nextField(line, ' '), entry.calls)) {
+    return false;
+  }
+
+  std::string_view types = nextField(line, ' ');
+  if (!line.empty()) {
+    return false;
+  }
+  while (!types.empty()) {
+    std::string_view type = nextField(types, ',');
+    std::string_view type_name = nextField(type, '=');
+    uint64_t count;
+    if (type_name.empty() || !parseNumber(type, count)) {
+      return false;
+    }
+    entry.types.emplace_back(type_name, count);
+  }
+
+  entries_.insert_or_assign(std::string{name}, std::move(entry));
+  return true;
+}
+
+const HotManifestEntry* HotManifest::lookupFunc(
+    BorrowedRef<PyFunctionObject> func) const {
+  return lookupCode(func->func_module, func->func_code);
+}
+
+const HotManifestEntry* HotManifest::lookupCode(
+    BorrowedRef<> module_name,
+    BorrowedRef<PyCodeObject> code) const {
+  if (entries_.empty()) {
+    return nullptr;
+  }
+  std::string_view module = unicodeView(module_name);
+  std::string_view qualname = unicodeView(code->co_qualname);
+  if (module.empty() || qualname.empty()) {
+    return nullptr;
+  }
+
+  auto it = entries_.find(fmt::format("{}:{}", module, qualname));
+  if (it == entries_.end() || it->second.code_hash != hashBytecode(code)) {
+    return nullptr;
+  }
+  return &it->second;
+}
+
+size_t HotManifest::size() const {
+  return entries_.size();
+}
+
+std::string HotManifest::formatEntry(const HotManifestEntry& entry) {
+  if (!isWritableName(entry.module) || !isWritableName(entry.qualname) ||
+      entry.module.find(':') != std::string::npos) {
+    return {};
+  }
+  std::string line = fmt::format(
+      "{}:{} {:x} {}",
+      entry.module,
+      entry.qualname,
+      entry.code_hash,
+      entry.calls);
+  char sep = ' ';
+  for (auto& [type_name, count] : entry.types) {
+    if (!isWritableName(type_name)) {
+      continue;
+    }
+    line += fmt::format("{}{}={}", sep, type_name, count);
+    sep = ',';
+  }
+  return line;
+}
+
+} // namespace cinderx::jit
@@ -0,0 +1,74 @@
+// Copyright (c) Meta Platforms, Inc. and affiliates.
+
+#pragma once
+
+#include "cinderx/python.h"
+
+#include "cinderx/Common/containers.h"
+#include "cinderx/Common/ref.h"
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace cinderx::jit {
+
+// What a manifest records about one function.
+struct HotManifestEntry {
+  std::string module;
+  std::string qualname;
+  // hashBytecode() of the function's code object.
+  uint32_t code_hash{0};
+  // Calls to the function, interpreted and compiled.
+  uint64_t calls{0};
+  // Types the function's compiled code observed at its deopt points, by
+  // fully-qualified name, with how often each was seen.  "<other>" counts the
+  // types that didn't fit in the profile.
+  std::vector<std::pair<std::string, uint64_t>> types;
+};
+
+// A hot-function manifest is a file recording which functions a running
+// process had compiled, so that a later run of the same program can compile
+// them up front rather than waiting for them to get hot again.
+//
+// The file consists of one function per line, hottest first, in the following
+// format
+//
+//   <module>:<qualname> <code hash> <calls> [<type>=<count>,...]
+//
+// where the code hash is in hex.  A function only matches its entry if its
+// bytecode still hashes the same, so entries for code that has since changed
+// are ignored.  Lines that begin with `#` are also ignored.
+class HotManifest {
+ public:
+  // Parse a manifest from a file.
+  //
+  // Raise an exception on error.
+  void parseFile(const char* filename);
+
+  // Parse a single line of a manifest.
+  //
+  // Return true on success or false on error.
+  bool parseLine(std::string_view line);
+
+  // Find the entry for a function or code object, or nullptr if there isn't
+  // one or the code has changed since it was recorded.
+  const HotManifestEntry* lookupFunc(BorrowedRef<PyFunctionObject> func) const;
+  const HotManifestEntry* lookupCode(
+      BorrowedRef<> module_name,
+      BorrowedRef<PyCodeObject> code) const;
+
+  size_t size() const;
+
+  // Format an entry as a line of a manifest, without the trailing newline.
+  // Return an empty string if its names can't be written out unambiguously.
+  static std::string formatEntry(const HotManifestEntry& entry);
+
+ private:
+  // Entries keyed by "<module>:<qualname>".
+  UnorderedMap<std::string, HotManifestEntry> entries_;
+};
+
+} // namespace cinderx::jit
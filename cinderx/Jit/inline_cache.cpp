@@ -22,6 +22,7 @@
 #include <algorithm>
 #include <memory>
 #include <stdexcept>
+#include <vector>
 
 namespace cinderx::jit {
 
@@ -31,7 +32,9 @@ template <class T>
 struct TypeWatcher {
   UnorderedMap<BorrowedRef<PyTypeObject>, UnorderedSet<T*>> caches;
 
-  void watch(BorrowedRef<PyTypeObject> type, T* cache) {
+  // Get notified when `type` is modified.  Separate from track() as it has to
+  // be done before taking the update lock; see ICUpdateGuard.
+  static void watch(BorrowedRef<PyTypeObject> type) {
     if (PyType_HasFeature(type, Py_TPFLAGS_IMMUTABLETYPE)) {
       // We don't watch immutable types - they can't be modified.
       return;
@@ -40,6 +43,13 @@ struct TypeWatcher {
         cinderx::getModuleState()->watcher_state.watchType(type) == 0,
         "Failed to watch type {} for attribute cache",
         type->tp_name);
+  }
+
+  // Notify `cache` when `type`, which must already be watched, is modified.
+  void track(BorrowedRef<PyTypeObject> type, T* cache) {
+    if (PyType_HasFeature(type, Py_TPFLAGS_IMMUTABLETYPE)) {
+      return;
+    }
     caches[type].emplace(cache);
   }
 
@@ -79,6 +89,68 @@ TypeWatcher<AttributeCache> ac_descr_watcher;
 TypeWatcher<LoadTypeAttrCache> ltac_watcher;
 TypeWatcher<LoadMethodCache> lm_watcher;
 TypeWatcher<LoadTypeMethodCache> ltm_watcher;
+
+#ifdef Py_GIL_DISABLED
+PyMutex s_update_mutex;
+// References dropped by caches while s_update_mutex is held.
+std::vector<PyObject*> s_retired_refs;
+#endif
+
+// Serializes updates to inline caches, and to the TypeWatcher maps above, in
+// free-threaded builds.  Readers don't take it; they check the CacheSeqLock of
+// the cache they read instead.
+//
+// This is a PyMutex rather than a std::mutex so that a thread blocked on it
+// detaches, releasing any critical sections it holds: type watchers, and so
+// notifyICsTypeChanged(), are called with the type lock held.  For the same
+// reason nothing that can block on a Python lock, or run arbitrary code, may be
+// called while it is held.
+//
+// A no-op in GIL builds, where the GIL serializes updates.
+class ICUpdateGuard {
+ public:
+  ICUpdateGuard() {
+#ifdef Py_GIL_DISABLED
+    PyMutex_Lock(&s_update_mutex);
+#endif
+  }
+
+  ~ICUpdateGuard() {
+#ifdef Py_GIL_DISABLED
+    std::vector<PyObject*> retired;
+    retired.swap(s_retired_refs);
+    PyMutex_Unlock(&s_update_mutex);
+    for (PyObject* obj : retired) {
+      // Other threads may have read the object out of a cache entry just
+      // before it was cleared.  They're done with it once every thread has
+      // passed through a quiescent state.
+      _PyObject_XDecRefDelayed(obj);
+    }
+#endif
+  }
+
+  DISALLOW_COPY_AND_ASSIGN(ICUpdateGuard);
+};
+
+// In GIL builds, cache entries borrow the objects they cache: the type watchers
+// clear an entry before its type can drop them.  In free-threaded builds
+// another thread may be reading the entry at that point, so entries own a
+// reference, which is released with retireCachedRef() while holding an
+// ICUpdateGuard.
+void retainCachedRef(BorrowedRef<> obj) {
+  if constexpr (kFreeThreadedBuild) {
+    Py_XINCREF(obj);
+  }
+}
+
+void retireCachedRef([[maybe_unused]] BorrowedRef<> obj) {
+#ifdef Py_GIL_DISABLED
+  if (obj != nullptr) {
+    s_retired_refs.push_back(obj);
+  }
+#endif
+}
+
 constexpr uintptr_t kKindMask = 0x07;
 
 // Low-bit tag on a LoadMethodCache entry's cached value. When clear, the value
@@ -384,6 +456,23 @@ bool SplitMutator::canInsertToSplitDict(
 PyObject* SplitMutator::getAttrInline(PyObject* obj, PyObject* name) {
   JIT_DCHECK(val_offset != -1, "Should have value offset");
   PyDictValues* values = _PyObject_InlineValues(obj);
+#ifdef Py_GIL_DISABLED
+  // Other threads may be storing to the object, or moving its values into a
+  // dict, so read the value the way LOAD_ATTR_INSTANCE_VALUE does.  The cache
+  // entry isn't downgraded as below, as other threads may be reading it.
+  if (!_Py_atomic_load_uint8(&values->valid)) {
+    return PyObject_GetAttr(obj, name);
+  }
+  PyObject** addr = &values->values[val_offset];
+  auto result = static_cast<PyObject*>(_Py_atomic_load_ptr_acquire(addr));
+  if (result == nullptr) {
+    return getAttrFallback(obj, name);
+  }
+  if (!_Py_TryIncrefCompare(addr, result)) {
+    return PyObject_GetAttr(obj, name);
+  }
+  return result;
+#else
   if (!values->valid) {
     // Downgrade to the slightly slower path in future
     AttributeMutator::changeKindFromSplitInline(
@@ -395,6 +484,7 @@ PyObject* SplitMutator::getAttrInline(PyObject* obj, PyObject* name) {
     return getAttrFallback(obj, name);
   }
   return Py_NewRef(result);
+#endif
 }
 
 PyObject* SplitMutator::getAttrSlowPath(
@@ -449,6 +539,24 @@ int SplitMutator::setAttrInline(
     PyObject* value) {
   JIT_DCHECK(val_offset != -1, "Should have value offset");
   PyDictValues* values = _PyObject_InlineValues(obj);
+#ifdef Py_GIL_DISABLED
+  // As in STORE_ATTR_INSTANCE_VALUE, the object's lock serializes this with
+  // other stores and with the values being moved into a dict.
+  Ref<> old_value;
+  {
+    CriticalSectionGuard guard{obj};
+    if (values->valid && _PyObject_GetManagedDict(obj) == nullptr) {
+      PyObject** addr = &values->values[val_offset];
+      old_value = Ref<>::steal(*addr);
+      _Py_atomic_store_ptr_release(addr, Py_NewRef(value));
+      if (old_value == nullptr) {
+        _PyDictValues_AddToInsertionOrder(values, val_offset);
+      }
+      return 0;
+    }
+  }
+  return PyObject_SetAttr(obj, name, value);
+#else
   PyDictObject* dict = _PyObject_GetManagedDict(obj);
   if (!values->valid || dict) {
     // Downgrade to the slightly slower path in future
@@ -462,6 +570,7 @@ int SplitMutator::setAttrInline(
     _PyDictValues_AddToInsertionOrder(values, val_offset);
   }
   return 0;
+#endif
 }
 
 int SplitMutator::setAttr(PyObject* obj, PyObject* name, PyObject* value) {
@@ -730,6 +839,10 @@ int DescrOrClassVarMutator::setAttr(
     auto descr_guard = Ref<>::create(descr);
     return setter(descr, obj, value);
   }
+  if constexpr (kFreeThreadedBuild) {
+    // Leave locking the instance dict to the generic path.
+    return PyObject_GenericSetAttr(obj, name, value);
+  }
   PyObject** dictptr = _PyObject_GetDictPtr(obj);
   if (dictptr == nullptr) {
     PyErr_Format(
@@ -758,20 +871,30 @@ PyObject* DescrOrClassVarMutator::getAttr(PyObject* obj, PyObject* name) {
     return getter(descr, obj, type);
   }
 
-  Ref<> dict;
-  PyObject** dictptr = _PyObject_GetDictPtr(obj);
-  if (dictptr != nullptr) {
-    dict.reset(*dictptr);
-  }
+  if constexpr (kFreeThreadedBuild) {
+    // The instance dict can't be read without locking it.  Skip it when the
+    // keys version shows the attribute can't be there, and otherwise leave it
+    // to the generic path.
+    if (Py_TYPE(obj)->tp_dictoffset != 0 &&
+        (keys_version == 0 || !isValidKeysVersion(keys_version, obj))) {
+      return PyObject_GetAttr(obj, name);
+    }
+  } else {
+    Ref<> dict;
+    PyObject** dictptr = _PyObject_GetDictPtr(obj);
+    if (dictptr != nullptr) {
+      dict.reset(*dictptr);
+    }
 
-  // Check instance dict.
-  if (dict != nullptr) {
-    if (keys_version == 0 ||
-        reinterpret_cast<PyDictObject*>(dict.get())->ma_keys->dk_version !=
-            keys_version) {
-      auto res = Ref<>::create(PyDict_GetItem(dict, name));
-      if (res != nullptr) {
-        return res.release();
+    // Check instance dict.
+    if (dict != nullptr) {
+      if (keys_version == 0 ||
+          reinterpret_cast<PyDictObject*>(dict.get())->ma_keys->dk_version !=
+              keys_version) {
+        auto res = Ref<>::create(PyDict_GetItem(dict, name));
+        if (res != nullptr) {
+          return res.release();
+        }
       }
     }
   }
@@ -803,6 +926,10 @@ bool AttributeMutator::isEmpty() const {
   return type_ == 0;
 }
 
+CachedTypeVersion& AttributeMutator::typeVersion() {
+  return type_version_;
+}
+
 void AttributeMutator::setCombined(PyTypeObject* type) {
   setType(type, Kind::kCombined);
   combined_.dict_offset = type->tp_dictoffset;
@@ -861,6 +988,47 @@ BorrowedRef<PyTypeObject> AttributeMutator::watchedDescrType() const {
   return nullptr;
 }
 
+BorrowedRef<> AttributeMutator::cachedObject() const {
+  if (isEmpty()) {
+    return nullptr;
+  }
+  switch (getKind()) {
+    case Kind::kCombined:
+      return combined_.getattr_method;
+    case Kind::kDict:
+      return dict_.getattr_method;
+    case Kind::kDataDescr:
+      return data_descr_.descr;
+    case Kind::kMemberDescr:
+      return member_descr_.getattr_method;
+    case Kind::kDescrOrClassVar:
+      return descr_or_cvar_.descr;
+    case Kind::kGetAttr:
+      return getattr_.getattr_method;
+    default:
+      return nullptr;
+  }
+}
+
+bool AttributeMutator::isThreadSafe() const {
+  switch (getKind()) {
+    case Kind::kSplitInline:
+    case Kind::kMemberDescr:
+    case Kind::kDescrOrClassVar:
+      return true;
+    case Kind::kDataDescr:
+      // A change to a mutable descriptor type doesn't change the version tag
+      // of the type the descriptor is on, so readers can't tell that an entry
+      // that was stale when it was published is stale.
+      return PyType_HasFeature(
+          data_descr_.descr_type, Py_TPFLAGS_IMMUTABLETYPE);
+    default:
+      // The others read instance dicts without locking them, or downgrade
+      // their own entry.
+      return false;
+  }
+}
+
 inline int
 AttributeMutator::setAttr(PyObject* obj, PyObject* name, PyObject* value) {
   JIT_CHECK(
@@ -961,6 +1129,7 @@ AttributeCache::AttributeCache() {
 }
 
 AttributeCache::~AttributeCache() {
+  ICUpdateGuard guard;
   for (auto& entry : entries()) {
     if (entry.type() != nullptr) {
       ac_watcher.unwatch(entry.type(), this);
@@ -968,35 +1137,17 @@ AttributeCache::~AttributeCache() {
       if (descr_tp != nullptr) {
         ac_descr_watcher.unwatch(descr_tp, this);
       }
+      retireCachedRef(entry.cachedObject());
       entry.reset();
     }
   }
 }
 
 void AttributeCache::typeChanged(PyTypeObject* tp) {
+  CacheSeqLock::WriteScope write{seq_};
   for (auto& entry : entries()) {
     if (entry.type() == tp) {
-      BorrowedRef<PyTypeObject> descr_tp = entry.watchedDescrType();
-      // Reset the entry, this also resets the kind so after the call
-      // watchedDescrType returns nullptr.
-      entry.reset();
-      if (descr_tp != nullptr) {
-        // For entry.type() the cache is 1 to 1 between types and the cache.
-        // For descriptors the same descriptor can be shared multiple times
-        // per a type. So check if we have any descriptors remaining and only
-        // unwatch when they're all clear.
-        bool found = false;
-        for (auto& other : entries()) {
-          if (other.watchedDescrType() == descr_tp) {
-            found = true;
-            break;
-          }
-        }
-        if (!found) {
-          // there are no other entries watching this descriptor.
-          ac_descr_watcher.unwatch(descr_tp, this);
-        }
-      }
+      clearEntry(entry);
     }
   }
 }
@@ -1006,12 +1157,14 @@ void AttributeCache::descrTypeChanged(PyTypeObject* tp) {
   // once as it applies to all entries so we use a flag to track if we've
   // already unwatched it for multiple entries (it wouldn't hurt to try
   // and unwatch multiple times but it's a couple of hash lookups)
+  CacheSeqLock::WriteScope write{seq_};
   bool found = false;
   for (auto& entry : entries()) {
     if (entry.watchedDescrType() == tp) {
       // If we were watching the descriptor the whole cache entry is
       // invalidated and we no longer need to watch the type.
       ac_watcher.unwatch(entry.type(), this);
+      retireCachedRef(entry.cachedObject());
       entry.reset();
       if (!found) {
         // unwatch the descriptor watcher once for the whole cache
@@ -1022,16 +1175,102 @@ void AttributeCache::descrTypeChanged(PyTypeObject* tp) {
   }
 }
 
+void AttributeCache::clearEntry(AttributeMutator& entry) {
+  BorrowedRef<PyTypeObject> descr_tp = entry.watchedDescrType();
+  retireCachedRef(entry.cachedObject());
+  // Reset the entry, this also resets the kind so after the call
+  // watchedDescrType returns nullptr.
+  entry.reset();
+  if (descr_tp != nullptr) {
+    // For entry.type() the cache is 1 to 1 between types and the cache.
+    // For descriptors the same descriptor can be shared multiple times
+    // per a type. So check if we have any descriptors remaining and only
+    // unwatch when they're all clear.
+    bool found = false;
+    for (auto& other : entries()) {
+      if (other.watchedDescrType() == descr_tp) {
+        found = true;
+        break;
+      }
+    }
+    if (!found) {
+      // there are no other entries watching this descriptor.
+      ac_descr_watcher.unwatch(descr_tp, this);
+    }
+  }
+}
+
 std::span<AttributeMutator> AttributeCache::entries() {
   return {entries_, getConfig().attr_cache_size};
 }
 
-AttributeMutator* AttributeCache::findEmptyEntry() {
-  auto it = std::ranges::find_if(
-      entries(), [](const AttributeMutator& e) { return e.isEmpty(); });
+AttributeMutator* AttributeCache::findEntryToFill(
+    BorrowedRef<PyTypeObject> type) {
+  auto it = std::ranges::find_if(entries(), [&](const AttributeMutator& e) {
+    return e.isEmpty() || (kFreeThreadedBuild && e.type() == type);
+  });
   return it == entries().end() ? nullptr : &*it;
 }
 
+bool AttributeCache::snapshotEntry(
+    BorrowedRef<PyTypeObject> type,
+    AttributeMutator& result,
+    Ref<>& cached_obj) {
+  uint32_t seq = seq_.readBegin();
+  bool found = false;
+  for (auto& entry : entries()) {
+    if (entry.type() == type) {
+      result = entry;
+      found = true;
+      break;
+    }
+  }
+  if (!found || !seq_.readValidate(seq) ||
+      !result.typeVersion().matches(type)) {
+    return false;
+  }
+  // The entry still owned a reference to the object when it was copied, and
+  // any release of that reference is deferred until this thread is quiescent,
+  // so it's safe to take a new one.
+  cached_obj = Ref<>::create(result.cachedObject());
+  return true;
+}
+
+void AttributeCache::commit(AttributeMutator& mut) {
+  if (kFreeThreadedBuild && !mut.isThreadSafe()) {
+    return;
+  }
+  BorrowedRef<PyTypeObject> type = mut.type();
+  BorrowedRef<PyTypeObject> descr_tp = mut.watchedDescrType();
+  // If someone modifies descr_type (e.g., deletes __set__), it may no longer
+  // be a data descriptor. Watch it via the descriptor watcher so the cache is
+  // invalidated.
+  ac_watcher.watch(type);
+  if (descr_tp != nullptr) {
+    ac_descr_watcher.watch(descr_tp);
+  }
+
+  ICUpdateGuard guard;
+  AttributeMutator* entry = findEntryToFill(type);
+  if (entry == nullptr ||
+      (!entry->isEmpty() && entry->typeVersion().matches(type))) {
+    // No room, or another thread got here first.
+    return;
+  }
+  {
+    CacheSeqLock::WriteScope write{seq_};
+    if (!entry->isEmpty()) {
+      clearEntry(*entry);
+    }
+    *entry = mut;
+  }
+  retainCachedRef(entry->cachedObject());
+  ac_watcher.track(type, this);
+  if (descr_tp != nullptr) {
+    ac_descr_watcher.track(descr_tp, this);
+  }
+}
+
 bool canCacheType(PyTypeObject* type) {
   if (PyType_HasFeature(type, Py_TPFLAGS_MANAGED_DICT)) {
     // We can cache values for types which have managed dictionaries on 3.12 or
@@ -1075,12 +1314,11 @@ bool canCacheAttribute(
 }
 
 void AttributeCache::fill(BorrowedRef<> obj, BorrowedRef<> name, bool is_set) {
-  AttributeMutator* mut = findEmptyEntry();
-  if (mut == nullptr) {
+  BorrowedRef<PyTypeObject> type{Py_TYPE(obj)};
+  if (findEntryToFill(type) == nullptr) {
     return;
   }
 
-  BorrowedRef<PyTypeObject> type{Py_TYPE(obj)};
   if (!Ci_Type_HasValidVersionTag(type)) {
     // The type must have a valid version tag in order for us to be able to
     // invalidate the cache when the type is modified. See the comment at
@@ -1102,6 +1340,8 @@ void AttributeCache::fill(BorrowedRef<> obj, BorrowedRef<> name, bool is_set) {
   // Only walk the MRO once we know the type is cacheable. For uncacheable
   // types this lookup would be wasted, and these types never populate the
   // cache so they reach this slow path on every access.
+  AttributeMutator mut;
+  mut.typeVersion().set(CachedTypeVersion::current(type));
   BorrowedRef<> descr = _PyType_Lookup(type, name);
 
   if (descr != nullptr) {
@@ -1110,13 +1350,9 @@ void AttributeCache::fill(BorrowedRef<> obj, BorrowedRef<> name, bool is_set) {
         descr_type->tp_descr_set != nullptr) {
       // Data descriptor
       if (descr_type == &PyMemberDescr_Type) {
-        mut->setMemberDescr(type, descr);
+        mut.setMemberDescr(type, descr);
       } else {
-        // If someone modifies descr_type (e.g., deletes __set__), it may no
-        // longer be a data descriptor. Watch it via the descriptor watcher
-        // so the cache is invalidated.
-        ac_descr_watcher.watch(descr_type, this);
-        mut->setDataDescr(type, descr);
+        mut.setDataDescr(type, descr);
       }
     } else {
       // Non-data descriptor or class var.
@@ -1125,9 +1361,9 @@ void AttributeCache::fill(BorrowedRef<> obj, BorrowedRef<> name, bool is_set) {
       // handling the transition if __set__ is added or removed.
       uint32_t keys_version = 0;
       canCacheAttribute(type, name, keys_version);
-      mut->setDescrOrClassvar(type, descr, keys_version);
+      mut.setDescrOrClassvar(type, descr, keys_version);
     }
-    ac_watcher.watch(type, this);
+    commit(mut);
     return;
   }
 
@@ -1161,8 +1397,8 @@ void AttributeCache::fill(BorrowedRef<> obj, BorrowedRef<> name, bool is_set) {
             // lack of the attribute.
             keys_version = 0;
           }
-          mut->setGetattr(type, getattr_method, keys_version);
-          ac_watcher.watch(type, this);
+          mut.setGetattr(type, getattr_method, keys_version);
+          commit(mut);
           return;
         }
       }
@@ -1170,20 +1406,20 @@ void AttributeCache::fill(BorrowedRef<> obj, BorrowedRef<> name, bool is_set) {
       if (keys->dk_nentries == SHARED_KEYS_MAX_SIZE) {
         // The shared dict is full, fallback to dict access via managed
         // dict APIs.
-        mut->setDict(type);
-        ac_watcher.watch(type, this);
+        mut.setDict(type);
+        commit(mut);
       }
 
       return;
     }
 
     // set_split handles __getattr__ fallback too
-    mut->setSplit(type, index, keys, inline_values);
+    mut.setSplit(type, index, keys, inline_values);
   } else {
     // combined handles __getattr__ fallback too
-    mut->setCombined(type);
+    mut.setCombined(type);
   }
-  ac_watcher.watch(type, this);
+  commit(mut);
 }
 
 int StoreAttrCache::invoke(
@@ -1196,6 +1432,14 @@ int StoreAttrCache::invoke(
 
 int StoreAttrCache::doInvoke(PyObject* obj, PyObject* name, PyObject* value) {
   BorrowedRef<PyTypeObject> tp = Py_TYPE(obj);
+  if constexpr (kFreeThreadedBuild) {
+    AttributeMutator entry;
+    Ref<> cached_obj;
+    if (snapshotEntry(tp, entry, cached_obj)) {
+      return entry.setAttr(obj, name, value);
+    }
+    return invokeSlowPath(obj, name, value);
+  }
   for (auto& entry : entries()) {
     if (entry.type() == tp) {
       return entry.setAttr(obj, name, value);
@@ -1228,6 +1472,14 @@ LoadAttrCache::invoke(LoadAttrCache* cache, PyObject* obj, PyObject* name) {
 
 PyObject* LoadAttrCache::doInvoke(PyObject* obj, PyObject* name) {
   PyTypeObject* tp = Py_TYPE(obj);
+  if constexpr (kFreeThreadedBuild) {
+    AttributeMutator entry;
+    Ref<> cached_obj;
+    if (snapshotEntry(tp, entry, cached_obj)) {
+      return entry.getAttr(obj, name);
+    }
+    return invokeSlowPath(obj, name);
+  }
   for (auto& entry : entries()) {
     if (entry.type() == tp) {
       return entry.getAttr(obj, name);
@@ -1255,14 +1507,22 @@ LoadTypeAttrCache::LoadTypeAttrCache() {
 }
 
 LoadTypeAttrCache::~LoadTypeAttrCache() {
+  ICUpdateGuard guard;
   ltac_watcher.unwatch(type_, this);
+  retireCachedRef(value_);
 }
 
 PyObject* LoadTypeAttrCache::invoke(
     LoadTypeAttrCache* cache,
     PyObject* obj,
     PyObject* name) {
-  // The fast path is handled by direct memory access via valueAddr().
+  // In GIL builds the fast path is handled by direct memory access via
+  // valueAddr().
+  if constexpr (kFreeThreadedBuild) {
+    if (PyObject* value = cache->lookupCached(obj)) {
+      return value;
+    }
+  }
   return cache->invokeSlowPath(obj, name);
 }
 
@@ -1274,6 +1534,18 @@ PyObject** LoadTypeAttrCache::valueAddr() {
   return &value_;
 }
 
+PyObject* LoadTypeAttrCache::lookupCached(BorrowedRef<> obj) {
+  uint32_t seq = seq_.readBegin();
+  PyTypeObject* type = type_;
+  PyObject* value = value_;
+  CachedTypeVersion type_version = type_version_;
+  if (!seq_.readValidate(seq) || reinterpret_cast<PyObject*>(type) != obj ||
+      !type_version.matches(type)) {
+    return nullptr;
+  }
+  return Py_NewRef(value);
+}
+
 // NB: This function needs to be kept in sync with PyType_Type.tp_getattro.
 PyObject* LoadTypeAttrCache::invokeSlowPath(
     BorrowedRef<> obj,
@@ -1288,6 +1560,7 @@ PyObject* LoadTypeAttrCache::invokeSlowPath(
     return nullptr;
   }
 
+  uint32_t type_version = CachedTypeVersion::current(type);
   descrgetfunc meta_get = nullptr;
   auto meta_attribute = Ref<>::create(_PyType_Lookup(metatype, name));
   if (meta_attribute != nullptr) {
@@ -1324,7 +1597,7 @@ PyObject* LoadTypeAttrCache::invokeSlowPath(
       return local_get(attribute, nullptr, type);
     }
 
-    fill(type, attribute);
+    fill(type, type_version, attribute);
     return attribute.release();
   }
 
@@ -1352,6 +1625,7 @@ void LoadTypeAttrCache::typeChanged(
 
 void LoadTypeAttrCache::fill(
     BorrowedRef<PyTypeObject> type,
+    uint32_t type_version,
     BorrowedRef<> value) {
   if (!Ci_Type_HasValidVersionTag(type)) {
     // The type must have a valid version tag in order for us to be able to
@@ -1360,13 +1634,23 @@ void LoadTypeAttrCache::fill(
     return;
   }
 
+  ltac_watcher.watch(type);
+  ICUpdateGuard guard;
   ltac_watcher.unwatch(type_, this);
-  type_ = type;
-  value_ = value;
-  ltac_watcher.watch(type_, this);
+  {
+    CacheSeqLock::WriteScope write{seq_};
+    retireCachedRef(value_);
+    type_ = type;
+    value_ = value;
+    type_version_.set(type_version);
+  }
+  retainCachedRef(value_);
+  ltac_watcher.track(type_, this);
 }
 
 void LoadTypeAttrCache::reset() {
+  CacheSeqLock::WriteScope write{seq_};
+  retireCachedRef(value_);
   // We need to return a PyTypeObject* even in the empty case so that subsequent
   // refcounting operations work correctly.
   type_ = &s_empty_type_attr_cache;
@@ -1384,11 +1668,11 @@ std::string_view cacheMissReason(CacheMissReason reason) {
 }
 
 LoadMethodCache::~LoadMethodCache() {
+  ICUpdateGuard guard;
   for (auto& entry : entries_) {
     if (entry.type != nullptr) {
       lm_watcher.unwatch(entry.type, this);
-      entry.type.reset();
-      entry.value = 0;
+      clearEntry(entry);
     }
   }
 }
@@ -1455,62 +1739,90 @@ LoadMethodResult LoadMethodCache::lookup(
     BorrowedRef<> name) {
   BorrowedRef<PyTypeObject> tp = Py_TYPE(obj);
 
+  if constexpr (kFreeThreadedBuild) {
+    uint32_t seq = seq_.readBegin();
+    auto it = std::ranges::find_if(
+        entries_, [&](const Entry& e) { return e.type == tp; });
+    if (it != entries_.end()) {
+      Entry entry = *it;
+      // lookupHit() takes a reference to the cached value before it can run
+      // any code, so it outlives the entry being cleared.
+      if (seq_.readValidate(seq) && entry.type_version.matches(tp) &&
+          isValidKeysVersion(entry.keys_version, obj)) {
+        return lookupHit(entry, obj, name);
+      }
+    }
+    return lookupSlowPath(obj, name);
+  }
+
   for (auto& entry : entries_) {
     if (entry.type == tp) {
       if (!isValidKeysVersion(entry.keys_version, obj)) {
         continue;
       }
-
-      uintptr_t value = entry.value;
-      if (!loadMethodValueIsUnbound(value)) {
-        // Bound method (common case): the low bit is clear, so the value is an
-        // untagged PyObject* which is a method-like object.
-        return {Py_NewRef(reinterpret_cast<PyObject*>(value)), Py_NewRef(obj)};
-      } else if (entry.is_class_method) {
-        // Class method: the (tagged) value is the underlying callable. Bind it
-        // to the receiver's type rather than the receiver itself.
-        return {
-            Py_NewRef(loadMethodValuePtr(value)),
-            Py_NewRef(reinterpret_cast<PyObject*>(tp.get()))};
-      } else if (value != kLoadMethodGetAttrSentinel) {
-        // A tagged pointer (value > the tag bit): a staticmethod or class
-        // variable. Untag it and return it as a plain attribute without binding
-        // the receiver as self.
-        return {Py_None, Py_NewRef(loadMethodValuePtr(value))};
-      }
-
-      // getattr/getattribute sentinel (value == kLoadMethodGetAttrSentinel).
-      // Two kinds of types cache the sentinel (see lookupSlowPath); the cache
-      // is invalidated if the type changes:
-      //
-      //  * A type whose __getattr__ hook wraps the generic getattr we
-      //    replicate: the attribute is genuinely absent, so we skip straight
-      //    to __getattr__ via getAttrFallback().
-      //
-      //  * A type with a lookup we can't replicate (custom __getattribute__,
-      //    or a metaclass instance using type_getattro): we don't know the
-      //    result, so dispatch through the type's own lookup.
-      PyObject* result = entry.has_getattr_hook ? getAttrFallback(obj, name)
-                                                : PyObject_GetAttr(obj, name);
-      if (result == nullptr) {
-        return {nullptr, nullptr};
-      }
-      return {Py_None, result};
+      return lookupHit(entry, obj, name);
     }
   }
 
   return lookupSlowPath(obj, name);
 }
 
+LoadMethodResult LoadMethodCache::lookupHit(
+    const Entry& entry,
+    BorrowedRef<> obj,
+    BorrowedRef<> name) {
+  uintptr_t value = entry.value;
+  if (!loadMethodValueIsUnbound(value)) {
+    // Bound method (common case): the low bit is clear, so the value is an
+    // untagged PyObject* which is a method-like object.
+    return {Py_NewRef(reinterpret_cast<PyObject*>(value)), Py_NewRef(obj)};
+  } else if (entry.is_class_method) {
+    // Class method: the (tagged) value is the underlying callable. Bind it
+    // to the receiver's type rather than the receiver itself.
+    return {
+        Py_NewRef(loadMethodValuePtr(value)),
+        Py_NewRef(reinterpret_cast<PyObject*>(Py_TYPE(obj)))};
+  } else if (value != kLoadMethodGetAttrSentinel) {
+    // A tagged pointer (value > the tag bit): a staticmethod or class
+    // variable. Untag it and return it as a plain attribute without binding
+    // the receiver as self.
+    return {Py_None, Py_NewRef(loadMethodValuePtr(value))};
+  }
+
+  // getattr/getattribute sentinel (value == kLoadMethodGetAttrSentinel).
+  // Two kinds of types cache the sentinel (see lookupSlowPath); the cache
+  // is invalidated if the type changes:
+  //
+  //  * A type whose __getattr__ hook wraps the generic getattr we
+  //    replicate: the attribute is genuinely absent, so we skip straight
+  //    to __getattr__ via getAttrFallback().
+  //
+  //  * A type with a lookup we can't replicate (custom __getattribute__,
+  //    or a metaclass instance using type_getattro): we don't know the
+  //    result, so dispatch through the type's own lookup.
+  PyObject* result = entry.has_getattr_hook ? getAttrFallback(obj, name)
+                                            : PyObject_GetAttr(obj, name);
+  if (result == nullptr) {
+    return {nullptr, nullptr};
+  }
+  return {Py_None, result};
+}
+
 void LoadMethodCache::typeChanged(PyTypeObject* type) {
+  CacheSeqLock::WriteScope write{seq_};
   for (auto& entry : entries_) {
     if (entry.type == type) {
-      entry.type.reset();
-      entry.value = 0;
+      clearEntry(entry);
     }
   }
 }
 
+void LoadMethodCache::clearEntry(Entry& entry) {
+  retireCachedRef(loadMethodValuePtr(entry.value));
+  entry.type.reset();
+  entry.value = 0;
+}
+
 void LoadMethodCache::initCacheStats(
     const char* filename,
     const char* method_name) {
@@ -1532,6 +1844,7 @@ LoadMethodResult LoadMethodCache::lookupSlowPath(
     BorrowedRef<> obj,
     BorrowedRef<> name) {
   PyTypeObject* tp = Py_TYPE(obj);
+  uint32_t type_version = CachedTypeVersion::current(tp);
   PyObject* descr;
   descrgetfunc f = nullptr;
   PyObject **dictptr, *dict;
@@ -1553,7 +1866,7 @@ LoadMethodResult LoadMethodCache::lookupSlowPath(
     // type_getattro). Cache the getattr sentinel so future lookups hit the
     // cache and dispatch straight through the type's own lookup (see lookup()),
     // then service this miss now.
-    fill(tp, nullptr, name, /* has_getattr_hook */ false);
+    fill(tp, type_version, nullptr, name, /* has_getattr_hook */ false);
     PyObject* res = PyObject_GetAttr(obj, name);
     if (res != nullptr) {
       maybeCollectCacheStats(
@@ -1623,7 +1936,7 @@ LoadMethodResult LoadMethodCache::lookupSlowPath(
   }
 
   if (is_method) {
-    fill(tp, descr, name, /* has_getattr_hook */ false);
+    fill(tp, type_version, descr, name, /* has_getattr_hook */ false);
     Py_INCREF(obj);
     return {descr, obj};
   }
@@ -1636,6 +1949,7 @@ LoadMethodResult LoadMethodCache::lookupSlowPath(
     BorrowedRef<> callable = Ci_PyStaticMethod_GetFunc(descr);
     fill(
         tp,
+        type_version,
         callable,
         name,
         /*has_getattr_hook=*/false,
@@ -1653,6 +1967,7 @@ LoadMethodResult LoadMethodCache::lookupSlowPath(
     if (callable != nullptr) {
       fill(
           tp,
+          type_version,
           callable,
           name,
           /*has_getattr_hook=*/false,
@@ -1685,7 +2000,12 @@ LoadMethodResult LoadMethodCache::lookupSlowPath(
     // not shadowed by an instance attribute. Cache it and return it as a plain
     // attribute (not bound to the receiver).
     fill(
-        tp, descr, name, /*has_getattr_hook=*/false, /*is_bound_method=*/false);
+        tp,
+        type_version,
+        descr,
+        name,
+        /*has_getattr_hook=*/false,
+        /*is_bound_method=*/false);
     return {Py_None, descr};
   }
 
@@ -1694,7 +2014,7 @@ LoadMethodResult LoadMethodCache::lookupSlowPath(
   // lookups hit the cache and dispatch to __getattr__ directly (see lookup()),
   // then service this miss through __getattr__ now.
   if (has_getattr_hook) {
-    fill(tp, nullptr, name, /* has_getattr_hook */ true);
+    fill(tp, type_version, nullptr, name, /* has_getattr_hook */ true);
     PyObject* result = getAttrFallback(obj, name);
     if (result == nullptr) {
       return {nullptr, nullptr};
@@ -1708,6 +2028,7 @@ LoadMethodResult LoadMethodCache::lookupSlowPath(
 
 void LoadMethodCache::fill(
     BorrowedRef<PyTypeObject> type,
+    uint32_t type_version,
     BorrowedRef<> value,
     BorrowedRef<> name,
     bool has_getattr_hook,
@@ -1725,28 +2046,45 @@ void LoadMethodCache::fill(
   // type" (see tagLoadMethodValue). This happens for types with a __getattr__
   // hook or an unreplicable lookup (see lookupSlowPath); lookup() turns such a
   // hit into a __getattr__ / __getattribute__ dispatch.
-  for (auto& entry : entries_) {
-    if (entry.type == nullptr) {
-      uint32_t keys_version = 0;
-      if (!canCacheAttribute(type, name, keys_version)) {
-        break;
-      }
+  uint32_t keys_version = 0;
+  if (!canCacheAttribute(type, name, keys_version)) {
+    return;
+  }
 
-      lm_watcher.watch(type, this);
-      entry.type = type;
-      entry.value = tagLoadMethodValue(value, is_bound_method);
-      entry.keys_version = keys_version;
-      entry.has_getattr_hook = has_getattr_hook;
-      entry.is_class_method = is_class_method;
-      return;
+  lm_watcher.watch(type);
+  ICUpdateGuard guard;
+  // In free-threaded builds there may be a stale entry for the type, which
+  // lookup() missed on; see CachedTypeVersion.
+  auto it = std::ranges::find_if(entries_, [&](const Entry& e) {
+    return e.type == nullptr || (kFreeThreadedBuild && e.type == type);
+  });
+  if (it == entries_.end() ||
+      (it->type != nullptr && it->type_version.matches(type))) {
+    return;
+  }
+  Entry& entry = *it;
+  {
+    CacheSeqLock::WriteScope write{seq_};
+    if (entry.type != nullptr) {
+      clearEntry(entry);
     }
+    entry.type = type;
+    entry.value = tagLoadMethodValue(value, is_bound_method);
+    entry.keys_version = keys_version;
+    entry.has_getattr_hook = has_getattr_hook;
+    entry.is_class_method = is_class_method;
+    entry.type_version.set(type_version);
   }
+  retainCachedRef(value);
+  lm_watcher.track(type, this);
 }
 
 LoadTypeMethodCache::~LoadTypeMethodCache() {
+  ICUpdateGuard guard;
   if (type_ != nullptr) {
     ltm_watcher.unwatch(type_, this);
   }
+  retireCachedRef(value_);
 }
 
 LoadMethodResult LoadTypeMethodCache::lookupHelper(
@@ -1768,10 +2106,35 @@ LoadMethodResult LoadTypeMethodCache::getValueHelper(
   return {Py_None, result};
 }
 
+bool LoadTypeMethodCache::lookupCached(
+    BorrowedRef<PyTypeObject> obj,
+    LoadMethodResult& result) {
+  uint32_t seq = seq_.readBegin();
+  PyTypeObject* type = type_;
+  PyObject* value = value_;
+  bool is_unbound_meth = is_unbound_meth_;
+  CachedTypeVersion type_version = type_version_;
+  if (!seq_.readValidate(seq) || type != obj || !type_version.matches(type)) {
+    return false;
+  }
+  if (is_unbound_meth) {
+    result = {Py_NewRef(value), Py_NewRef(obj)};
+  } else {
+    result = {Py_None, Py_NewRef(value)};
+  }
+  return true;
+}
+
 // This needs to be kept in sync with PyType_Type.tp_getattro.
 LoadMethodResult LoadTypeMethodCache::lookup(
     BorrowedRef<PyTypeObject> obj,
     BorrowedRef<> name) {
+  if constexpr (kFreeThreadedBuild) {
+    LoadMethodResult result;
+    if (lookupCached(obj, result)) {
+      return result;
+    }
+  }
   PyTypeObject* metatype = Py_TYPE(obj);
   if (metatype->tp_getattro != PyType_Type.tp_getattro) {
     maybeCollectCacheStats(
@@ -1807,6 +2170,7 @@ LoadMethodResult LoadTypeMethodCache::lookup(
 
   /* No data descriptor found on metatype. Look in tp_dict of this
    * type and its bases */
+  uint32_t type_version = CachedTypeVersion::current(obj);
   PyObject* attribute = _PyType_Lookup(obj, name);
   if (attribute != nullptr) {
     Py_XDECREF(meta_attribute);
@@ -1820,7 +2184,7 @@ LoadMethodResult LoadTypeMethodCache::lookup(
         // Get the underlying callable from classmethod and return the
         // callable alongside the class object, allowing the runtime to call
         // the method as an unbound method.
-        fill(obj, cm_callable, true);
+        fill(obj, type_version, cm_callable, true);
         return {cm_callable, obj};
       } else if (Py_TYPE(cm_callable)->tp_descr_get != nullptr) {
         // cm_callable has custom tp_descr_get that can run arbitrary
@@ -1841,12 +2205,12 @@ LoadMethodResult LoadTypeMethodCache::lookup(
     if (attribute_type == &PyStaticMethod_Type) {
       BorrowedRef<> cm_callable = Ci_PyStaticMethod_GetFunc(attribute);
       Py_INCREF(cm_callable);
-      fill(obj, cm_callable, false);
+      fill(obj, type_version, cm_callable, false);
       return {Py_None, cm_callable};
     }
     if (PyFunction_Check(attribute)) {
       Py_INCREF(attribute);
-      fill(obj, attribute, false);
+      fill(obj, type_version, attribute, false);
       return {Py_None, attribute};
     }
     Py_INCREF(attribute);
@@ -1897,6 +2261,8 @@ BorrowedRef<> LoadTypeMethodCache::value() {
 }
 
 void LoadTypeMethodCache::typeChanged(BorrowedRef<PyTypeObject> /* type */) {
+  CacheSeqLock::WriteScope write{seq_};
+  retireCachedRef(value_);
   type_ = nullptr;
   value_.reset();
 }
@@ -1919,6 +2285,7 @@ const CacheStats* LoadTypeMethodCache::cacheStats() {
 
 void LoadTypeMethodCache::fill(
     BorrowedRef<PyTypeObject> type,
+    uint32_t type_version,
     BorrowedRef<> value,
     bool is_unbound_meth) {
   if (!Ci_Type_HasValidVersionTag(type)) {
@@ -1928,11 +2295,19 @@ void LoadTypeMethodCache::fill(
     return;
   }
 
+  ltm_watcher.watch(type);
+  ICUpdateGuard guard;
   ltm_watcher.unwatch(type_, this);
-  type_ = type;
-  value_ = value;
-  is_unbound_meth_ = is_unbound_meth;
-  ltm_watcher.watch(type_, this);
+  {
+    CacheSeqLock::WriteScope write{seq_};
+    retireCachedRef(value_);
+    type_ = type;
+    value_ = value;
+    is_unbound_meth_ = is_unbound_meth;
+    type_version_.set(type_version);
+  }
+  retainCachedRef(value_);
+  ltm_watcher.track(type_, this);
 }
 
 PyObject* LoadModuleAttrCache::lookupHelper(
@@ -2538,6 +2913,7 @@ BinaryOpCache::BinarySpecialization BinaryOpCache::specializedTypes() const {
 }
 
 void notifyICsTypeChanged(BorrowedRef<PyTypeObject> type) {
+  ICUpdateGuard guard;
   ac_watcher.typeChanged(type);
   ac_descr_watcher.typeChanged(
       type, [](AttributeCache* cache, BorrowedRef<PyTypeObject> tp) {
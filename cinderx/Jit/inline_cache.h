@@ -12,6 +12,7 @@
 #include "cinderx/StaticPython/typed-args-info.h"
 
 #include <array>
+#include <atomic>
 #include <memory>
 #include <span>
 #include <unordered_map>
@@ -25,6 +26,113 @@ enum class BinaryOpKind;
 
 namespace cinderx::jit {
 
+// Lets readers of an inline cache take a consistent copy of an entry that spans
+// more than one word without locking, in free-threaded builds.
+//
+// Writers, which are serialized with each other by a lock in inline_cache.cpp,
+// make the sequence number odd while they modify a cache's entries.  Readers
+// copy the entry they want and then check that the sequence number was even and
+// didn't change while they were doing so, treating the lookup as a miss if it
+// did.
+//
+// In GIL builds nothing runs concurrently with a reader, and this compiles away
+// to nothing.
+class CacheSeqLock {
+ public:
+  // Marks the cache as being modified for the lifetime of the scope.
+  class WriteScope {
+   public:
+    explicit WriteScope(CacheSeqLock& lock) : lock_{lock} {
+      lock_.bump(std::memory_order_relaxed);
+      std::atomic_thread_fence(std::memory_order_release);
+    }
+
+    ~WriteScope() {
+      lock_.bump(std::memory_order_release);
+    }
+
+    DISALLOW_COPY_AND_ASSIGN(WriteScope);
+
+   private:
+    CacheSeqLock& lock_;
+  };
+
+  uint32_t readBegin() const {
+#ifdef Py_GIL_DISABLED
+    return seq_.load(std::memory_order_acquire);
+#else
+    return 0;
+#endif
+  }
+
+  // Returns true if nothing was written to the cache since readBegin()
+  // returned `seq`.
+  bool readValidate([[maybe_unused]] uint32_t seq) const {
+#ifdef Py_GIL_DISABLED
+    std::atomic_thread_fence(std::memory_order_acquire);
+    return (seq & 1) == 0 && seq_.load(std::memory_order_relaxed) == seq;
+#else
+    return true;
+#endif
+  }
+
+ private:
+  void bump([[maybe_unused]] std::memory_order order) {
+#ifdef Py_GIL_DISABLED
+    seq_.store(seq_.load(std::memory_order_relaxed) + 1, order);
+#endif
+  }
+
+#ifdef Py_GIL_DISABLED
+  std::atomic<uint32_t> seq_{0};
+#endif
+};
+
+// The version tag a type had when an inline cache entry for it was filled.
+//
+// In GIL builds, the type watchers clear an entry before anything can observe
+// the type it was filled for being modified.  In free-threaded builds a type
+// can be modified by one thread between another thread looking an attribute up
+// on it and publishing the result in a cache, so readers also check that the
+// type's version tag hasn't changed since the lookup.  Version tags are never
+// reused, so this catches entries that were stale when they were published.
+//
+// Stores nothing, and always matches, in GIL builds.
+class CachedTypeVersion {
+ public:
+  // Read the current version tag of `type`.  To fill an entry, this has to be
+  // done before looking up the value to cache.
+  static uint32_t current([[maybe_unused]] BorrowedRef<PyTypeObject> type) {
+#if defined(Py_GIL_DISABLED) && defined(__cpp_lib_atomic_ref)
+    return std::atomic_ref<unsigned int>(type->tp_version_tag)
+        .load(std::memory_order_acquire);
+#elif defined(Py_GIL_DISABLED)
+    return __atomic_load_n(&type->tp_version_tag, __ATOMIC_ACQUIRE);
+#else
+    return 0;
+#endif
+  }
+
+  void set([[maybe_unused]] uint32_t version) {
+#ifdef Py_GIL_DISABLED
+    version_ = version;
+#endif
+  }
+
+  bool matches([[maybe_unused]] BorrowedRef<PyTypeObject> type) const {
+#ifdef Py_GIL_DISABLED
+    return version_ != 0 && version_ == current(type);
+#else
+    return true;
+#endif
+  }
+
+ private:
+#ifdef Py_GIL_DISABLED
+  uint32_t version_{0};
+#endif
+};
+
 // Mutator for an instance attribute that is stored in a split dictionary
 struct SplitMutator {
   PyObject* getAttr(PyObject* obj, PyObject* name);
@@ -128,6 +236,7 @@ class AttributeMutator {
   PyTypeObject* type() const;
   void reset();
   bool isEmpty() const;
+  CachedTypeVersion& typeVersion();
   void setCombined(PyTypeObject* type);
   void setDict(PyTypeObject* type);
   void setDataDescr(PyTypeObject* type, PyObject* descr);
@@ -147,6 +256,15 @@ class AttributeMutator {
       uint32_t keys_version);
   BorrowedRef<PyTypeObject> watchedDescrType() const;
 
+  // The object the mutator refers to other than its type, if any.  Borrowed in
+  // GIL builds; in free-threaded builds, the entry in the cache owns a
+  // reference to it.
+  BorrowedRef<> cachedObject() const;
+
+  // Whether the mutator can be used while other threads are accessing the same
+  // objects.  In free-threaded builds, caches are only filled with these.
+  bool isThreadSafe() const;
+
   PyObject* getAttr(PyObject* obj, PyObject* name);
   int setAttr(PyObject* obj, PyObject* name, PyObject* value);
 
@@ -174,6 +292,7 @@ class AttributeMutator {
     DescrOrClassVarMutator descr_or_cvar_;
     GetAttrMutator getattr_;
   };
+  [[no_unique_address]] CachedTypeVersion type_version_;
 };
 
 class AttributeCache {
@@ -187,10 +306,29 @@ class AttributeCache {
  protected:
   std::span<AttributeMutator> entries();
 
-  AttributeMutator* findEmptyEntry();
+  // Find the entry to fill for `type`: an empty one, or in free-threaded
+  // builds a stale one for the same type.
+  AttributeMutator* findEntryToFill(BorrowedRef<PyTypeObject> type);
 
   void fill(BorrowedRef<> obj, BorrowedRef<> name, bool is_set);
 
+  // Copy the entry for `type` into `result`, if there's one that's still valid.
+  // `cached_obj` is set to a strong reference to the entry's cached object, so
+  // that the copy stays usable if another thread clears the entry.  Only used
+  // in free-threaded builds; GIL builds use the entries in place.
+  bool snapshotEntry(
+      BorrowedRef<PyTypeObject> type,
+      AttributeMutator& result,
+      Ref<>& cached_obj);
+
+ private:
+  // Publish a mutator built by fill().
+  void commit(AttributeMutator& mut);
+  // Clear an entry, and stop watching its descriptor type if no other entry
+  // needs it.
+  void clearEntry(AttributeMutator& entry);
+
+  [[no_unique_address]] CacheSeqLock seq_;
   AttributeMutator entries_[0];
 };
 
@@ -265,15 +403,26 @@ class LoadTypeAttrCache {
   void typeChanged(BorrowedRef<PyTypeObject> type);
 
  private:
+  // Return a new reference to the cached value if the cache holds one for
+  // `obj`, or nullptr.  Used in free-threaded builds, where codegen doesn't
+  // read the cache directly: the type and value can't be read consistently by
+  // two separate loads while another thread may be refilling the cache.
+  PyObject* lookupCached(BorrowedRef<> obj);
+
   PyObject* invokeSlowPath(BorrowedRef<> obj, BorrowedRef<> name);
 
-  void fill(BorrowedRef<PyTypeObject> type, BorrowedRef<> value);
+  void fill(
+      BorrowedRef<PyTypeObject> type,
+      uint32_t type_version,
+      BorrowedRef<> value);
   void reset();
 
   // Cached type and value, stored as raw pointers so codegen can access them by
   // address.
   PyTypeObject* type_;
-  PyObject* value_;
+  PyObject* value_{nullptr};
+  [[no_unique_address]] CachedTypeVersion type_version_;
+  [[no_unique_address]] CacheSeqLock seq_;
 };
 
 #define FOREACH_CACHE_MISS_REASON(V) \
@@ -304,10 +453,11 @@ class LoadMethodCache {
  public:
   struct Entry {
     BorrowedRef<PyTypeObject> type;
-    // Borrowed cached attribute, tagged in the low bit. When the low bit is
-    // clear the value is an untagged PyObject* for a bound method (the common,
-    // hot case) -- a single bit test selects it and it is bound to the
-    // receiver. When the low bit is set the value is not a bound method:
+    // Cached attribute, tagged in the low bit.  Borrowed in GIL builds and
+    // owned in free-threaded builds. When the low bit is clear the value is
+    // an untagged PyObject* for a bound method (the common, hot case) -- a
+    // single bit test selects it and it is bound to the receiver. When the
+    // low bit is set the value is not a bound method:
     //   * value == 1 (just the tag bit): the attribute is absent from the type
     //     and must be resolved via __getattr__ / __getattribute__ dispatch.
     //   * value > 1: a tagged PyObject* for a staticmethod descriptor or class
@@ -329,9 +479,13 @@ class LoadMethodCache {
     // than to the receiver itself. Only meaningful for unbound entries.
     bool is_class_method{false};
 
+    [[no_unique_address]] CachedTypeVersion type_version;
+
     bool isValidKeysVersion(BorrowedRef<> obj);
   };
-  static_assert(sizeof(Entry) == 24, "Entry must be small");
+  static_assert(
+      sizeof(Entry) == (kFreeThreadedBuild ? 32 : 24),
+      "Entry must be small");
 
   ~LoadMethodCache();
 
@@ -345,17 +499,26 @@ class LoadMethodCache {
   const CacheStats* cacheStats();
 
  private:
+  // Resolve a lookup that hit `entry`.
+  LoadMethodResult lookupHit(
+      const Entry& entry,
+      BorrowedRef<> obj,
+      BorrowedRef<> name);
   LoadMethodResult lookupSlowPath(BorrowedRef<> obj, BorrowedRef<> name);
   void fill(
       BorrowedRef<PyTypeObject> type,
+      uint32_t type_version,
       BorrowedRef<> value,
       BorrowedRef<> name,
       bool has_getattr_hook,
       bool is_bound_method = true,
       bool is_class_method = false);
+  // Release the cached value of an entry and mark it empty.
+  void clearEntry(Entry& entry);
 
   std::array<Entry, 4> entries_;
   std::unique_ptr<CacheStats> cache_stats_;
+  [[no_unique_address]] CacheSeqLock seq_;
 };
 
 // A cache for LoadMethodCached instructions where we expect the receiver to be
@@ -369,7 +532,8 @@ class LoadMethodCache {
 // from the cache and compared against the receiver. If they are equal, the
 // `getValueHelper()` is called which returns the cached value. If they are not
 // equal, `lookupHelper()` is called, which performs the full lookup and
-// potentially fills the cache.
+// potentially fills the cache.  In free-threaded builds only `lookupHelper()`
+// is used, and it checks the cache first; see LoadTypeAttrCache.
 class LoadTypeMethodCache {
  public:
   ~LoadTypeMethodCache();
@@ -396,15 +560,25 @@ class LoadTypeMethodCache {
   const CacheStats* cacheStats();
 
  private:
-  void
-  fill(BorrowedRef<PyTypeObject> type, BorrowedRef<> value, bool is_bound_meth);
+  // Set `result` to the cached method if the cache holds one for `obj`.  Used
+  // in free-threaded builds, where codegen doesn't read the cache directly.
+  bool lookupCached(BorrowedRef<PyTypeObject> obj, LoadMethodResult& result);
+
+  void fill(
+      BorrowedRef<PyTypeObject> type,
+      uint32_t type_version,
+      BorrowedRef<> value,
+      bool is_bound_meth);
 
   // Borrowed, but uses a raw pointer as typeAddr() will return the address of
   // this field for codegen purposes.
-  PyTypeObject* type_;
+  PyTypeObject* type_{nullptr};
+  // Borrowed in GIL builds and owned in free-threaded builds.
   BorrowedRef<> value_;
   std::unique_ptr<CacheStats> cache_stats_;
   bool is_unbound_meth_;
+  [[no_unique_address]] CachedTypeVersion type_version_;
+  [[no_unique_address]] CacheSeqLock seq_;
 };
 
 // A cache for an individual LoadModuleAttrCached instruction.
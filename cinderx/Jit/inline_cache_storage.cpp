@@ -62,11 +62,20 @@ InlineCacheSite::InlineCacheSite(
   cache.store_attr = cache_ptr;
 }
 
+PerCompilationInlineCacheStorage::PerCompilationInlineCacheStorage(
+    std::shared_ptr<HugePageArena> arena)
+    : inline_cache_arena_{std::move(arena)} {}
+
 const std::vector<InlineCacheSite>&
 PerCompilationInlineCacheStorage::inlineCacheSites() const {
   return inline_cache_sites_;
 }
 
+size_t PerCompilationInlineCacheStorage::allocatedBytes() const {
+  return inline_cache_arena_.allocatedBytes() +
+      inline_cache_sites_.capacity() * sizeof(InlineCacheSite);
+}
+
 LoadAttrCache* PerCompilationInlineCacheStorage::allocateLoadAttrCache(
     BCOffset bytecode_offset) {
   auto cache =
@@ -7,6 +7,7 @@
 #include "cinderx/Jit/bytecode_offsets.h"
 #include "cinderx/Jit/inline_cache.h"
 
+#include <memory>
 #include <vector>
 
 namespace cinderx::jit {
@@ -50,8 +51,18 @@ struct InlineCacheSite {
 
 class PerCompilationInlineCacheStorage final {
  public:
+  PerCompilationInlineCacheStorage() = default;
+
+  // Allocate the caches out of `arena`, alongside those of other compilations,
+  // rather than on pages of their own.
+  explicit PerCompilationInlineCacheStorage(
+      std::shared_ptr<HugePageArena> arena);
+
   const std::vector<InlineCacheSite>& inlineCacheSites() const;
 
+  // Bytes used by the caches and the list of sites.
+  size_t allocatedBytes() const;
+
   LoadAttrCache* allocateLoadAttrCache(BCOffset bytecode_offset);
   LoadMethodCache* allocateLoadMethodCache(BCOffset bytecode_offset);
   LoadModuleAttrCache* allocateLoadModuleAttrCache(BCOffset bytecode_offset);
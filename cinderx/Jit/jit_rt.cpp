@@ -38,6 +38,9 @@
 
 #ifdef Py_GIL_DISABLED
 #include "internal/pycore_gc.h"
+#include "internal/pycore_list.h"
+#include "internal/pycore_lock.h"
+#include "internal/pycore_long.h"
 #include "internal/pycore_qsbr.h"
 #endif
 
@@ -1796,6 +1799,24 @@ int unpackSequence(
     int count) {
   JIT_DCHECK(iterable != nullptr, "The iterable cannot be null.");
 
+#ifdef Py_GIL_DISABLED
+  // Exact lists are unpacked here rather than inline in free-threaded builds,
+  // as their items have to be copied out under the list's lock.  Like
+  // UNPACK_SEQUENCE_LIST, don't wait for it: on contention, or a size
+  // mismatch, fall through to the iterator protocol.
+  if (PyList_CheckExact(iterable) && PyMutex_LockFast(&iterable->ob_mutex)) {
+    if (PyList_GET_SIZE(iterable) == count) {
+      PyObject** src = _PyList_ITEMS(iterable);
+      for (int i = 0; i < count; i++) {
+        items[i] = Py_NewRef(src[i]);
+      }
+      PyMutex_Unlock(&iterable->ob_mutex);
+      return 0;
+    }
+    PyMutex_Unlock(&iterable->ob_mutex);
+  }
+#endif
+
   Ref<> it = Ref<>::steal(PyObject_GetIter(iterable));
   if (it == nullptr) {
     if (_PyErr_ExceptionMatches(tstate, PyExc_TypeError) &&
@@ -2177,18 +2198,59 @@ PyObject* listSubscript(
     [[maybe_unused]] PyObject* list,
     [[maybe_unused]] PyObject* index) {
 #ifdef Py_GIL_DISABLED
-  Py_ssize_t i = PyNumber_AsSsize_t(index, PyExc_IndexError);
-  if (i == -1 && PyErr_Occurred()) {
-    return nullptr;
+  auto long_index = reinterpret_cast<PyLongObject*>(index);
+  Py_ssize_t i;
+  if (_PyLong_IsCompact(long_index)) {
+    i = _PyLong_CompactValue(long_index);
+  } else {
+    i = PyNumber_AsSsize_t(index, PyExc_IndexError);
+    if (i == -1 && PyErr_Occurred()) {
+      return nullptr;
+    }
   }
   if (i < 0) {
     // Resolve negative indices against the current size.
     i += PyList_GET_SIZE(list);
   }
-  return PyList_GetItemRef(list, i);
+  // As in BINARY_OP_SUBSCR_LIST_INT, this reads the item without locking the
+  // list, validating the read with _Py_TryXGetRef(), and only takes the lock
+  // if that fails.
+  PyObject* item = _PyList_GetItemRef(reinterpret_cast<PyListObject*>(list), i);
+  if (item == nullptr) {
+    PyErr_SetString(PyExc_IndexError, "list index out of range");
+  }
+  return item;
 #else
   JIT_ABORT("listSubscript is only used in free-threaded builds");
 #endif
 }
 
+int listStoreSubscript(
+    [[maybe_unused]] PyObject* list,
+    [[maybe_unused]] PyObject* index,
+    [[maybe_unused]] PyObject* value) {
+#ifdef Py_GIL_DISABLED
+  // Mirrors STORE_SUBSCR_LIST_INT: stores to an in-bounds item are done with
+  // the list's lock held, but if another thread holds it, go through the
+  // generic path rather than waiting here.
+  auto long_index = reinterpret_cast<PyLongObject*>(index);
+  if (_PyLong_IsNonNegativeCompact(long_index) &&
+      PyMutex_LockFast(&list->ob_mutex)) {
+    Py_ssize_t i = _PyLong_CompactValue(long_index);
+    if (i < PyList_GET_SIZE(list)) {
+      PyObject** item = &_PyList_ITEMS(list)[i];
+      PyObject* old_value = *item;
+      _Py_atomic_store_ptr_release(item, Py_NewRef(value));
+      PyMutex_Unlock(&list->ob_mutex);
+      Py_DECREF(old_value);
+      return 0;
+    }
+    PyMutex_Unlock(&list->ob_mutex);
+  }
+  return PyList_Type.tp_as_mapping->mp_ass_subscript(list, index, value);
+#else
+  JIT_ABORT("listStoreSubscript is only used in free-threaded builds");
+#endif
+}
+
 } // namespace cinderx::jit::rt
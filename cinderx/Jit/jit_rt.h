@@ -403,7 +403,7 @@ PyObject* unpackExToTuple(
 
 /* Unpack a sequence of exactly 'count' items via the iterator protocol.
  * Used as the slow path for UNPACK_SEQUENCE when the sequence is not a
- * list or tuple.
+ * list or tuple, and for lists in free-threaded builds.
  *
  * On success, fills items[0..count-1] with new references and returns 0.
  * On error, sets a Python exception and returns -1. Any partially-filled
@@ -556,11 +556,17 @@ extern PyObject iterDoneSentinel;
 PyObject* invokeIterNext(PyObject* iterator);
 
 /*
- * FT-safe exact-list subscript used by ListSubscr. Uses PyList_GetItemRef so
- * the result is an owned reference.
+ * FT-safe exact-list subscript used by ListSubscr. Reads the item without
+ * taking the list's lock when it can, and returns an owned reference.
  */
 PyObject* listSubscript(PyObject* list, PyObject* index);
 
+/*
+ * FT-safe exact-list item store, used for StoreSubscr on an exact list and an
+ * exact int.  Returns 0 on success and -1 with an exception set on failure.
+ */
+int listStoreSubscript(PyObject* list, PyObject* index, PyObject* value);
+
 } // namespace cinderx::jit::rt
 
 #if PY_VERSION_HEX >= 0x030D0000
@@ -9,12 +9,62 @@
 #include <fmt/core.h>
 #include <fmt/format.h>
 
+#include <algorithm>
+#include <iterator>
 #include <memory>
+#include <new>
 #include <sstream>
 #include <vector>
 
 namespace cinderx::jit {
 
+namespace {
+
+// Small, stable thread identifiers for traces, assigned in the order that
+// threads first record an event.
+std::atomic<uint64_t> s_next_trace_thread{1};
+thread_local uint64_t t_trace_thread{0};
+
+uint64_t traceThreadId() {
+  if (t_trace_thread == 0) {
+    t_trace_thread = s_next_trace_thread.fetch_add(1);
+  }
+  return t_trace_thread;
+}
+
+// Name of the function being compiled on this thread, set by the innermost
+// enclosing CompileTraceScope that names one.
+thread_local const std::string* t_trace_function{nullptr};
+
+void appendJsonString(std::string& out, std::string_view str) {
+  out += '"';
+  for (char c : str) {
+    switch (c) {
+      case '"':
+        out += "\\\"";
+        break;
+      case '\\':
+        out += "\\\\";
+        break;
+      case '\n':
+        out += "\\n";
+        break;
+      default:
+        if (static_cast<unsigned char>(c) < 0x20) {
+          fmt::format_to(
+              std::back_inserter(out),
+              "\\u{:04x}",
+              static_cast<unsigned char>(c));
+        } else {
+          out += c;
+        }
+    }
+  }
+  out += '"';
+}
+
+} // namespace
+
 void parseAndSetFuncList(const std::string& flag_value) {
   auto& func_list = getMutableConfig().capture_compilation_times_for;
   func_list.clear();
@@ -208,4 +258,163 @@ void CompilationPhaseTimer::end() {
   current_phase_stack_.pop_back();
 }
 
+void CompileTrace::start(size_t capacity) {
+  JIT_CHECK(capacity > 0, "Compile trace needs room for at least one event");
+  std::lock_guard<std::mutex> lock{mutex_};
+  events_.clear();
+  events_.reserve(capacity);
+  capacity_ = capacity;
+  next_ = 0;
+  dropped_ = 0;
+  enabled_.store(true, std::memory_order_relaxed);
+}
+
+void CompileTrace::stop() {
+  enabled_.store(false, std::memory_order_relaxed);
+}
+
+void CompileTrace::record(
+    std::string_view name,
+    std::string_view function,
+    time_point start,
+    time_point end) {
+  if (!isEnabled()) {
+    return;
+  }
+  Event event{
+      std::string{name}, std::string{function}, start, end, traceThreadId()};
+  std::lock_guard<std::mutex> lock{mutex_};
+  if (capacity_ == 0) {
+    return;
+  }
+  if (events_.size() < capacity_) {
+    events_.emplace_back(std::move(event));
+    return;
+  }
+  events_[next_] = std::move(event);
+  next_ = (next_ + 1) % capacity_;
+  dropped_++;
+}
+
+void CompileTrace::setThreadName(std::string_view name) {
+  uint64_t thread = traceThreadId();
+  std::lock_guard<std::mutex> lock{mutex_};
+  thread_names_[thread] = name;
+}
+
+std::string CompileTrace::toJson() const {
+  std::lock_guard<std::mutex> lock{mutex_};
+
+  time_point origin = time_point::max();
+  for (const Event& event : events_) {
+    origin = std::min(origin, event.start);
+  }
+  auto micros = [](std::chrono::nanoseconds ns) {
+    return std::chrono::duration<double, std::micro>{ns}.count();
+  };
+
+  std::string result = "{\"traceEvents\":[";
+  bool first = true;
+  auto separate = [&] {
+    if (!first) {
+      result += ",";
+    }
+    first = false;
+    result += "\n";
+  };
+
+  for (auto& [thread, name] : thread_names_) {
+    separate();
+    fmt::format_to(
+        std::back_inserter(result),
+        "{{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":{},"
+        "\"args\":{{\"name\":",
+        thread);
+    appendJsonString(result, name);
+    result += "}}";
+  }
+
+  for (size_t i = 0; i < events_.size(); i++) {
+    const Event& event = events_[(next_ + i) % events_.size()];
+    separate();
+    result += "{\"name\":";
+    appendJsonString(result, event.name);
+    fmt::format_to(
+        std::back_inserter(result),
+        ",\"cat\":\"jit\",\"ph\":\"X\",\"ts\":{:.3f},\"dur\":{:.3f},"
+        "\"pid\":1,\"tid\":{}",
+        micros(event.start - origin),
+        micros(event.end - event.start),
+        event.thread);
+    if (!event.function.empty()) {
+      result += ",\"args\":{\"function\":";
+      appendJsonString(result, event.function);
+      result += "}";
+    }
+    result += "}";
+  }
+
+  fmt::format_to(
+      std::back_inserter(result),
+      "\n],\"displayTimeUnit\":\"ms\","
+      "\"otherData\":{{\"dropped_events\":{}}}}}\n",
+      dropped_);
+  return result;
+}
+
+void CompileTrace::clear() {
+  std::lock_guard<std::mutex> lock{mutex_};
+  events_.clear();
+  next_ = 0;
+  dropped_ = 0;
+}
+
+size_t CompileTrace::numDropped() const {
+  std::lock_guard<std::mutex> lock{mutex_};
+  return dropped_;
+}
+
+void CompileTrace::atForkChild() {
+  new (&mutex_) std::mutex();
+}
+
+CompileTrace& compileTrace() {
+  static CompileTrace trace;
+  return trace;
+}
+
+CompileTraceScope::CompileTraceScope(std::string_view name)
+    : enabled_{compileTrace().isEnabled()} {
+  if (enabled_) {
+    name_ = name;
+    start_ = Clock::now();
+  }
+}
+
+CompileTraceScope::CompileTraceScope(
+    std::string_view name,
+    std::string_view function)
+    : CompileTraceScope{name} {
+  if (enabled_) {
+    function_ = function;
+    outer_function_ = t_trace_function;
+    owns_function_ = true;
+    t_trace_function = &function_;
+  }
+}
+
+CompileTraceScope::~CompileTraceScope() {
+  if (!enabled_) {
+    return;
+  }
+  if (owns_function_) {
+    t_trace_function = outer_function_;
+    compileTrace().record(name_, function_, start_, Clock::now());
+  } else {
+    std::string_view function =
+        t_trace_function != nullptr ? *t_trace_function : "";
+    compileTrace().record(name_, function, start_, Clock::now());
+  }
+}
+
 } // namespace cinderx::jit
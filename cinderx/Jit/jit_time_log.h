@@ -4,8 +4,13 @@
 
 #include "cinderx/Common/util.h"
 
+#include <atomic>
 #include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <map>
 #include <memory>
+#include <mutex>
 #include <string>
 #include <string_view>
 #include <vector>
@@ -15,13 +20,16 @@ namespace cinderx::jit {
 using Clock = std::chrono::steady_clock;
 using time_point = Clock::time_point;
 
-#define COMPILE_TIMER(com_phase_timer, phase_name, block) \
-  if (nullptr != com_phase_timer) {                       \
-    com_phase_timer->start(phase_name);                   \
-    block;                                                \
-    com_phase_timer->end();                               \
-  } else {                                                \
-    block;                                                \
+#define COMPILE_TIMER(com_phase_timer, phase_name, block)              \
+  {                                                                    \
+    ::cinderx::jit::CompileTraceScope compile_trace_scope{phase_name}; \
+    if (nullptr != com_phase_timer) {                                  \
+      com_phase_timer->start(phase_name);                              \
+      block;                                                           \
+      com_phase_timer->end();                                          \
+    } else {                                                           \
+      block;                                                           \
+    }                                                                  \
   }
 
 // flag_value is expected to be the value associate with a the flag jit-time
@@ -107,4 +115,107 @@ class CompilationPhaseTimer {
   void dumpPhaseTimingsAndTidy();
 };
 
+// Records timed events from every stage of the compile pipeline, on every
+// thread that compiles: waiting in the background compile queue, preloading,
+// lowering into HIR, each HIR pass, LIR lowering and passes, register
+// allocation, code generation, and installing the compiled code.  Unlike
+// CompilationPhaseTimer this covers every function, which is what's needed to
+// see the parallelism of batch compiles and where workers stall.
+//
+// Events are kept in a fixed-size ring buffer, so a long-running process only
+// keeps the most recent ones.  They're rendered in the Chrome trace event
+// format, which can be loaded into Perfetto or chrome://tracing.
+class CompileTrace {
+ public:
+  CompileTrace() = default;
+
+  // Start recording, keeping at most the `capacity` most recent events.  Drops
+  // any events that were already recorded.
+  void start(size_t capacity);
+
+  // Stop recording.  Events that were already recorded are kept.
+  void stop();
+
+  bool isEnabled() const {
+    return enabled_.load(std::memory_order_relaxed);
+  }
+
+  // Record an event named `name` that ran from `start` to `end` on the calling
+  // thread.  `function` is the name of the function being compiled, and may be
+  // empty for events that aren't about a single function.  Does nothing when
+  // not recording.
+  void record(
+      std::string_view name,
+      std::string_view function,
+      time_point start,
+      time_point end);
+
+  // Name the calling thread in rendered traces.  Names are kept even while not
+  // recording, so that long-lived workers can name themselves when they start.
+  void setThreadName(std::string_view name);
+
+  // Render the recorded events, oldest first, as a Chrome trace JSON object.
+  // Timestamps are relative to the start of the oldest event.
+  std::string toJson() const;
+
+  // Drop all recorded events.
+  void clear();
+
+  // Number of events that were overwritten because the ring buffer was full.
+  size_t numDropped() const;
+
+  // Reset the lock in the child of a fork, which may have been held by a
+  // compile worker that doesn't exist in the child.
+  void atForkChild();
+
+ private:
+  DISALLOW_COPY_AND_ASSIGN(CompileTrace);
+
+  struct Event {
+    std::string name;
+    std::string function;
+    time_point start;
+    time_point end;
+    uint64_t thread;
+  };
+
+  std::atomic<bool> enabled_{false};
+
+  // Guards every field below.
+  mutable std::mutex mutex_;
+  // Ring buffer of events.  Once it reaches `capacity_` entries, `next_` is
+  // the index of the oldest event, which is the next one to be overwritten.
+  std::vector<Event> events_;
+  size_t capacity_{0};
+  size_t next_{0};
+  size_t dropped_{0};
+  std::map<uint64_t, std::string> thread_names_;
+};
+
+// Number of events kept by the compile trace unless asked for otherwise.
+constexpr size_t kDefaultCompileTraceCapacity = 65536;
+
+// The process-wide compile trace.
+CompileTrace& compileTrace();
+
+// Records an event covering the lifetime of the scope to compileTrace(), if
+// it's recording.  A scope that names a function also attributes the events of
+// scopes nested inside of it on the same thread to that function.
+class CompileTraceScope {
+ public:
+  explicit CompileTraceScope(std::string_view name);
+  CompileTraceScope(std::string_view name, std::string_view function);
+  ~CompileTraceScope();
+
+ private:
+  DISALLOW_COPY_AND_ASSIGN(CompileTraceScope);
+
+  bool enabled_;
+  std::string name_;
+  std::string function_;
+  const std::string* outer_function_{nullptr};
+  bool owns_function_{false};
+  time_point start_;
+};
+
 } // namespace cinderx::jit
@@ -36,6 +36,7 @@ extern "C" {
 #include "cinderx/Jit/config.h"
 #include "cinderx/Jit/context.h"
 #include "cinderx/Jit/deopt.h"
+#include "cinderx/Jit/direct_call_patcher.h"
 #include "cinderx/Jit/frame_header.h"
 #include "cinderx/Jit/generators_rt.h"
 #include "cinderx/Jit/hir/analysis.h"
@@ -1313,19 +1314,23 @@ void LIRGenerator::generateExitBlocks() {
     auto ret_data_type = hirTypeToDataType(func_->return_type);
     exit_phi_ = bbb.appendInstr(OutVReg{ret_data_type}, Opcode::kPhi);
 
-    // Unlink frame before epilogue. Non-generators always unlink.
-    bool has_freevars = func_->code != nullptr && func_->code->co_nfreevars > 0;
-    PyObject* executable;
-    std::optional<destructor> exec_dtor;
+    // Unlink frame before epilogue.  Non-generators always unlink, unless
+    // they never linked a frame in the first place.
+    if (!env_->frameless) {
+      bool has_freevars =
+          func_->code != nullptr && func_->code->co_nfreevars > 0;
+      PyObject* executable;
+      std::optional<destructor> exec_dtor;
 #if PY_VERSION_HEX >= 0x030E0000 && defined(ENABLE_LIGHTWEIGHT_FRAMES)
-    executable = env_->reifier;
-    exec_dtor = PyUnstable_JITExecutable_Type.tp_dealloc;
+      executable = env_->reifier;
+      exec_dtor = PyUnstable_JITExecutable_Type.tp_dealloc;
 #else
-    executable = reinterpret_cast<PyObject*>(func_->code.get());
-    exec_dtor = PyCode_Type.tp_dealloc;
+      executable = reinterpret_cast<PyObject*>(func_->code.get());
+      exec_dtor = PyCode_Type.tp_dealloc;
 #endif
-    emitUnlinkFrame(
-        bbb, has_freevars, is_gen_, env_->asm_func, executable, exec_dtor);
+      emitUnlinkFrame(
+          bbb, has_freevars, is_gen_, env_->asm_func, executable, exec_dtor);
+    }
 
     // EpilogueEnd goes on the builder's current block which may differ
     // from exit_block_ when inline code created additional blocks.
@@ -1422,6 +1427,9 @@ void LIRGenerator::analyzeCopies() {
 
 std::unique_ptr<jit::lir::Function> LIRGenerator::translateFunction() {
   analyzeCopies();
+  if (getConfig().execution_counters && getConfig().loop_counters) {
+    counted_loop_headers_ = hir::findLoopHeaders(*func_);
+  }
 
   auto function = std::make_unique<jit::lir::Function>(func_);
   lir_func_ = function.get();
@@ -1768,6 +1776,68 @@ bool LIRGenerator::translateSpecializedCall(
   return false;
 }
 
+bool LIRGenerator::translateDirectCall(
+    BasicBlockBuilder& bbb,
+    const hir::VectorCall& hir_instr) {
+  if constexpr (kBuildArch != Arch::kX86_64) {
+    return false;
+  }
+  if (hir_instr.flags() & CallFlags::KwArgs) {
+    return false;
+  }
+  hir::Register* callable = hir_instr.func();
+  if (!callable->type().hasValueSpec(TFunc)) {
+    return false;
+  }
+
+  // The callee doesn't have to be compiled yet.  Until it is, the call site
+  // goes through its vectorcall pointer, same as a regular call.
+  BorrowedRef<PyFunctionObject> callee{callable->type().objectSpec()};
+  env_->addReference(callee.getObj());
+  auto patcher = const_cast<hir::Function*>(func_)
+                     ->allocateCodePatcher<DirectCallPatcher>(callee);
+
+  Instruction* instr = bbb.appendInstr(
+      hir_instr.output(),
+      Opcode::kDirectVectorCall,
+      Imm{reinterpret_cast<uint64_t>(patcher)},
+      Imm{0},
+      VReg{bbb.getDefInstr(callable)});
+  for (size_t i = 0; i < hir_instr.numArgs(); i++) {
+    instr->addOperands(VReg{bbb.getDefInstr(hir_instr.arg(i))});
+  }
+  instr->addOperands(Imm{0});
+  return true;
+}
+
+Instruction* LIRGenerator::translateDirectStaticCall(
+    BasicBlockBuilder& bbb,
+    const hir::InvokeStaticFunction& hir_instr) {
+  if constexpr (kBuildArch != Arch::kX86_64) {
+    return nullptr;
+  }
+  PyFunctionObject* callee = hir_instr.func();
+
+  // Until the call site is patched, it jumps through the callee's function
+  // entry cache, which holds either its static entry or the deferred compile
+  // trampoline.  Both take the arguments as laid out for the static entry.
+  // The cache is filled in once the code has been generated.
+  void** indir = env_->ctx->findFunctionEntryCache(callee);
+  if (!isJitCompiled(callee)) {
+    env_->function_indirections.emplace(callee, indir);
+  }
+  env_->static_call_fallbacks.emplace(callee, indir);
+
+  env_->addReference(reinterpret_cast<PyObject*>(callee));
+  auto patcher =
+      const_cast<hir::Function*>(func_)->allocateCodePatcher<DirectCallPatcher>(
+          callee, DirectCallPatcher::Entry::kStatic);
+  return bbb.appendInstr(
+      hir_instr.output(),
+      Opcode::kDirectStaticCall,
+      Imm{reinterpret_cast<uint64_t>(patcher)});
+}
+
 void LIRGenerator::emitExceptionCheck(
     const jit::hir::DeoptBase& i,
     jit::lir::BasicBlockBuilder& bbb) {
@@ -2187,6 +2257,17 @@ void LIRGenerator::makeDecref(
       xdecref);
 }
 
+void LIRGenerator::emitCounterIncrement(
+    BasicBlockBuilder& bbb,
+    uint64_t* counter) {
+  Instruction* addr = bbb.appendInstr(
+      OutVReg{}, Opcode::kMove, Imm{reinterpret_cast<uint64_t>(counter)});
+  Instruction* count = bbb.appendInstr(
+      OutVReg{DataType::k64bit}, Opcode::kMove, Ind{addr, 0});
+  bbb.appendInstr(Opcode::kInc, count);
+  bbb.appendInstr(OutInd{addr, 0}, Opcode::kMove, count);
+}
+
 LIRGenerator::TranslatedBlock LIRGenerator::translateOneBasicBlock(
     const hir::BasicBlock* hir_bb,
     const jit::hir::FrameState* initial_caller_fs,
@@ -2201,10 +2282,28 @@ LIRGenerator::TranslatedBlock LIRGenerator::translateOneBasicBlock(
   BorrowedRef<PyCodeObject> inlined_code = initial_inlined_code;
 #endif
 
+  uint64_t* counter = nullptr;
+  if (getConfig().execution_counters) {
+    ExecutionCounters& counters = env_->code_rt->executionCounters();
+    if (hir_bb == getHIRFunction()->cfg.entry_block) {
+      counter = &counters.calls;
+    } else if (counted_loop_headers_.contains(hir_bb)) {
+      counter = &counters.loop_iterations;
+    }
+  }
+
   for (auto& i : *hir_bb) {
     auto opcode = i.opcode();
     bbb.setCurrentInstr(&i);
 
+    // Count the block once its phis and arguments have been defined, since
+    // those have to stay at the start of the block.
+    if (counter != nullptr && opcode != hir::Opcode::kPhi &&
+        opcode != hir::Opcode::kLoadArg) {
+      emitCounterIncrement(bbb, counter);
+      counter = nullptr;
+    }
+
 #if defined(Py_GIL_DISABLED)
     if (opcode == hir::Opcode::kBeginInlinedFunction) {
       auto bif = static_cast<const BeginInlinedFunction*>(&i);
@@ -3900,7 +3999,8 @@ LIRGenerator::TranslatedBlock LIRGenerator::translateOneBasicBlock(
       }
       case hir::Opcode::kVectorCall: {
         auto& hir_instr = static_cast<const VectorCall&>(i);
-        if (translateSpecializedCall(bbb, hir_instr)) {
+        if (translateSpecializedCall(bbb, hir_instr) ||
+            translateDirectCall(bbb, hir_instr)) {
           break;
         }
         size_t flags = 0;
@@ -4089,20 +4189,22 @@ LIRGenerator::TranslatedBlock LIRGenerator::translateOneBasicBlock(
         PyFunctionObject* func = instr->func();
 
         std::stringstream ss;
-        Instruction* lir;
-        if (isJitCompiled(func)) {
-          lir = bbb.appendInstr(
-              instr->output(),
-              Opcode::kCall,
-              Imm{reinterpret_cast<uint64_t>(
-                  JITRT_GET_STATIC_ENTRY(func->vectorcall))});
-        } else {
-          void** indir = env_->ctx->findFunctionEntryCache(func);
-          env_->function_indirections.emplace(func, indir);
-          Instruction* move = bbb.appendInstr(
-              OutVReg{Operand::k64bit}, Opcode::kMove, MemImm{indir});
+        Instruction* lir = translateDirectStaticCall(bbb, *instr);
+        if (lir == nullptr) {
+          if (isJitCompiled(func)) {
+            lir = bbb.appendInstr(
+                instr->output(),
+                Opcode::kCall,
+                Imm{reinterpret_cast<uint64_t>(
+                    JITRT_GET_STATIC_ENTRY(func->vectorcall))});
+          } else {
+            void** indir = env_->ctx->findFunctionEntryCache(func);
+            env_->function_indirections.emplace(func, indir);
+            Instruction* move = bbb.appendInstr(
+                OutVReg{Operand::k64bit}, Opcode::kMove, MemImm{indir});
 
-          lir = bbb.appendInstr(instr->output(), Opcode::kCall, move);
+            lir = bbb.appendInstr(instr->output(), Opcode::kCall, move);
+          }
         }
 
         for (size_t argIdx = 0; argIdx < nargs; argIdx++) {
@@ -4446,12 +4548,24 @@ LIRGenerator::TranslatedBlock LIRGenerator::translateOneBasicBlock(
       }
       case hir::Opcode::kStoreSubscr: {
         auto instr = static_cast<const StoreSubscr*>(&i);
-        Instruction* result = bbb.appendCallInstruction(
-            OutVReg{Operand::k32bit},
-            PyObject_SetItem,
-            instr->getOperand(0),
-            instr->getOperand(1),
-            instr->getOperand(2));
+        Instruction* result;
+        if (kFreeThreadedBuild && instr->getOperand(0)->isA(TListExact) &&
+            instr->getOperand(1)->isA(TLongExact)) {
+          // Simplify only inlines list stores in GIL builds.
+          result = bbb.appendCallInstruction(
+              OutVReg{Operand::k32bit},
+              rt::listStoreSubscript,
+              instr->getOperand(0),
+              instr->getOperand(1),
+              instr->getOperand(2));
+        } else {
+          result = bbb.appendCallInstruction(
+              OutVReg{Operand::k32bit},
+              PyObject_SetItem,
+              instr->getOperand(0),
+              instr->getOperand(1),
+              instr->getOperand(2));
+        }
         appendGuard(bbb, InstrGuardKind::kNotNegative, *instr, result);
         break;
       }
@@ -5545,6 +5659,21 @@ void LIRGenerator::emitLoadFrame(BasicBlockBuilder& bbb) {
         Opcode::kLea,
         Ind{codegen::arch::reg_frame_pointer_loc, deopt_idx_offset});
 #endif
+  } else if (env_->frameless) {
+    // Leave the frame unlinked.  All it needs is the function, so that the
+    // deopt path can fill in the rest of the frame and link it.
+    bbb.annotateNext("Frameless: load thread state");
+    env_->asm_tstate = bbb.appendInstr(OutVReg{}, Opcode::kLoadThreadState);
+
+    int fh_size = jit::frameHeaderSize(func_->code);
+    bbb.annotateNext("Frameless: stash function in frame");
+    bbb.appendInstr(
+        Opcode::kMove,
+        OutStk{PhyLocation(
+            static_cast<int32_t>(
+                -fh_size + jit::kFrameHeaderOverhead +
+                offsetof(_PyInterpreterFrame, f_funcobj)))},
+        env_->asm_func);
   } else {
 #if defined(Py_GIL_DISABLED) && defined(ENABLE_LIGHTWEIGHT_FRAMES)
     // Compute the address of the deopt_idx field once
@@ -116,6 +116,10 @@ class LIRGenerator {
 
   std::vector<BasicBlock*> basic_blocks_;
 
+  // HIR blocks that count an iteration of a loop when they're entered.  See
+  // Config::loop_counters.
+  std::unordered_set<const hir::BasicBlock*> counted_loop_headers_;
+
   // Borrowed pointers so type caches can be looked up by cache id. Ownership
   // is provided by the selected inline cache storage implementation.
   std::vector<LoadTypeAttrCache*> load_type_attr_caches_;
@@ -189,6 +193,8 @@ class LIRGenerator {
   }
 
   void analyzeCopies();
+  // Increment one of the CodeRuntime's ExecutionCounters.
+  void emitCounterIncrement(BasicBlockBuilder& bbb, uint64_t* counter);
   BasicBlock* generateEntryBlock();
   void generateExitBlocks();
 
@@ -307,6 +313,20 @@ class LIRGenerator {
       BasicBlockBuilder& bbb,
       const hir::VectorCall& instr);
 
+  // Call a Python function known at compile time through a DirectCallPatcher,
+  // so the call goes straight into its compiled code whenever it has some.
+  bool translateDirectCall(
+      BasicBlockBuilder& bbb,
+      const hir::VectorCall& instr);
+
+  // Call a Static Python function through a DirectCallPatcher targeting its
+  // static entry, passing arguments in registers.  Returns the call
+  // instruction, to which the caller appends the arguments, or nullptr if
+  // direct calls aren't supported.
+  Instruction* translateDirectStaticCall(
+      BasicBlockBuilder& bbb,
+      const hir::InvokeStaticFunction& instr);
+
   TranslatedBlock translateOneBasicBlock(
       const hir::BasicBlock* bb,
       const hir::FrameState* initial_caller_fs = nullptr,
@@ -11,6 +11,7 @@
 #include <algorithm>
 #include <array>
 #include <iterator>
+#include <optional>
 #include <span>
 #include <utility>
 
@@ -374,6 +375,10 @@ int LinearScanAllocator::getFrameSize() const {
   return -max_stack_slot_;
 }
 
+SpillCounts LinearScanAllocator::getSpillCounts() const {
+  return spill_counts_;
+}
+
 const LinearScanAllocator::IntervalMap& LinearScanAllocator::intervalMap()
     const {
   return intervals_;
@@ -554,7 +559,9 @@ void LinearScanAllocator::calculateLiveIntervals() {
 
       if (instr_opcode == Opcode::kCall ||
           instr_opcode == Opcode::kVarArgCall ||
-          instr_opcode == Opcode::kVectorCallTstate) {
+          instr_opcode == Opcode::kVectorCallTstate ||
+          instr_opcode == Opcode::kDirectVectorCall ||
+          instr_opcode == Opcode::kDirectStaticCall) {
         reserveRegistersForCall(*instr, instr_loc);
       }
       // kLoadThreadState needs caller-save reservation when the TLS offset is
@@ -666,6 +673,129 @@ void LinearScanAllocator::calculateLiveIntervals() {
       interval.sortAndMergeRanges();
     }
   }
+
+  calculateLoopDepths();
+  collectRematerializations();
+}
+
+void LinearScanAllocator::calculateLoopDepths() {
+  const auto& blocks = func_->basicBlocks();
+  UnorderedMap<const BasicBlock*, size_t> block_index;
+  for (size_t i = 0; i < blocks.size(); ++i) {
+    block_index.emplace(blocks[i], i);
+  }
+
+  // Blocks are sorted in RPO, so an edge to a block that doesn't come later is
+  // a back edge.  Like the loop handling in calculateLiveIntervals(), a loop is
+  // taken to be every block from its header up to the last block with a back
+  // edge to it.
+  std::vector<size_t> loop_end(blocks.size(), 0);
+  for (size_t i = 0; i < blocks.size(); ++i) {
+    for (const BasicBlock* succ : blocks[i]->successors()) {
+      size_t header = map_get(block_index, succ);
+      if (header <= i) {
+        loop_end[header] = std::max(loop_end[header], i + 1);
+      }
+    }
+  }
+
+  auto block_start = [&](size_t i) {
+    return map_get(regalloc_blocks_, blocks[i]).start;
+  };
+  auto block_end = [&](size_t i) {
+    return i + 1 < blocks.size()
+        ? block_start(i + 1)
+        : block_start(i) + blocks[i]->getNumInstrs() * 2 + 1;
+  };
+
+  std::vector<int> depth_change(blocks.size() + 1, 0);
+  for (size_t header = 0; header < blocks.size(); ++header) {
+    size_t end = loop_end[header];
+    if (end == 0) {
+      continue;
+    }
+    depth_change[header]++;
+    depth_change[end]--;
+    loop_ranges_.emplace_back(block_start(header), block_end(end - 1));
+  }
+
+  int depth = 0;
+  for (size_t i = 0; i < blocks.size(); ++i) {
+    depth += depth_change[i];
+    block_loop_depths_.emplace_back(block_start(i), depth);
+  }
+}
+
+void LinearScanAllocator::collectRematerializations() {
+  for (const BasicBlock* bb : func_->basicBlocks()) {
+    for (const auto& instr : bb->instructions()) {
+      const Operand* output = instr->output();
+      if (!output->isVreg() || output->isFp() || instr->getNumInputs() != 1) {
+        continue;
+      }
+
+      // Immediates include known-immortal objects, which LoadConst lowers to
+      // plain pointer constants.  Frame addresses are fixed once the prologue
+      // has run.
+      const Operand* input = instr->getInput(0);
+      Rematerialization remat{
+          .opcode = instr->opcode(),
+          .input_type = input->dataType(),
+          .output_type = output->dataType()};
+      if (instr->opcode() == Opcode::kMove && input->isImm() &&
+          !input->isFp()) {
+        remat.constant = input->getConstant();
+      } else if (instr->opcode() == Opcode::kLea && input->isStack()) {
+        remat.slot = input->getStackSlot();
+      } else {
+        continue;
+      }
+      remats_.emplace(output, remat);
+    }
+  }
+}
+
+int LinearScanAllocator::loopDepthAt(LIRLocation loc) const {
+  auto iter = std::upper_bound(
+      block_loop_depths_.begin(),
+      block_loop_depths_.end(),
+      loc,
+      [](LIRLocation loc, const auto& entry) { return loc < entry.first; });
+  if (iter == block_loop_depths_.begin()) {
+    return 0;
+  }
+  return std::prev(iter)->second;
+}
+
+bool LinearScanAllocator::isRematerializable(const Operand* operand) const {
+  return remats_.contains(operand);
+}
+
+LinearScanAllocator::SpillCost LinearScanAllocator::spillCost(
+    const Operand* operand,
+    LIRLocation next_use) const {
+  int kind = 0;
+  if (next_use != MAX_LOCATION) {
+    kind = isRematerializable(operand) ? 1 : 2 + loopDepthAt(next_use);
+  }
+  return {kind, -next_use};
+}
+
+LIRLocation LinearScanAllocator::spillSplitLocation(
+    const LiveInterval* interval,
+    LIRLocation start,
+    LIRLocation use) const {
+  // Loops are sorted by header, so the first match is the outermost loop.
+  for (const LiveRange& loop : loop_ranges_) {
+    if (loop.start > use) {
+      break;
+    }
+    if (loop.start > start && loop.isInRange(use) &&
+        interval->covers(loop.start)) {
+      return loop.start;
+    }
+  }
+  return use;
 }
 
 void LinearScanAllocator::reserveRegistersForCall(
@@ -938,17 +1068,54 @@ void LinearScanAllocator::allocateBlockedReg(
 
   markDisallowedRegisters(nextUsePos);
 
+  // Pick the register whose occupant is cheapest to evict.  A register that's
+  // needed again at current_start, or that's reserved, can't be taken.
   auto start = std::next(nextUsePos.begin(), is_fp ? VECD_REG_BASE : 0);
   auto end = std::prev(nextUsePos.end(), is_fp ? 0 : VECD_REG_BASE);
 
-  auto reg_iter = std::max_element(start, end);
-  PhyLocation reg(
-      std::distance(nextUsePos.begin(), reg_iter),
-      current->operand()->sizeInBits());
-  auto& reg_use = *reg_iter;
+  std::optional<PhyLocation> reg;
+  SpillCost reg_cost;
+  for (auto iter = start; iter != end; ++iter) {
+    if (*iter <= current_start) {
+      continue;
+    }
+    PhyLocation candidate(
+        std::distance(nextUsePos.begin(), iter),
+        current->operand()->sizeInBits());
+    auto act_iter = reg_active_interval.find(candidate);
+    if (act_iter == reg_active_interval.end() || act_iter->second->isFixed()) {
+      continue;
+    }
+
+    // Inactive intervals that intersect current will be split too, so the
+    // register costs whatever its most expensive occupant does.
+    SpillCost cost = spillCost(act_iter->second->operand(), *iter);
+    auto inact_iter = reg_inactive_intervals.find(candidate);
+    if (inact_iter != reg_inactive_intervals.end()) {
+      for (LiveInterval* interval : inact_iter->second) {
+        if (interval->intersectWith(*current) != INVALID_LOCATION) {
+          cost = std::max(
+              cost,
+              spillCost(
+                  interval->operand(),
+                  getUseAtOrAfter(interval->operand(), current_start)));
+        }
+      }
+    }
 
+    if (!reg.has_value() || cost < reg_cost) {
+      reg = candidate;
+      reg_cost = cost;
+    }
+  }
+
+  // Spill current if it's no more expensive than the cheapest register, unless
+  // it needs a register right away.
   auto first_current_use = getUseAtOrAfter(current->operand(), current_start);
-  if (first_current_use >= reg_use) {
+  bool spill_current = !reg.has_value() ||
+      (first_current_use > current_start &&
+       !(reg_cost < spillCost(current->operand(), first_current_use)));
+  if (spill_current) {
     auto stack_slot = getStackSlot(current->operand());
     TRACE(
         "Allocating blocked location {} to interval {}", stack_slot, *current);
@@ -957,13 +1124,16 @@ void LinearScanAllocator::allocateBlockedReg(
     // First_current_use can be MAX_LOCATION when the operand is in a loop and
     // there are no more uses after current_start.
     if (first_current_use < current->endLocation()) {
-      splitAndSave(current, first_current_use, unhandled);
+      splitAndSave(
+          current,
+          spillSplitLocation(current, current_start, first_current_use),
+          unhandled);
     }
   } else {
-    TRACE("Allocating blocked location {} to interval {}", reg, *current);
-    current->allocateTo(reg);
+    TRACE("Allocating blocked location {} to interval {}", *reg, *current);
+    current->allocateTo(*reg);
 
-    auto act_iter = reg_active_interval.find(reg);
+    auto act_iter = reg_active_interval.find(*reg);
     JIT_CHECK(
         act_iter != reg_active_interval.end(),
         "Must have one active interval allocated to reg. Otherwise, this "
@@ -977,7 +1147,7 @@ void LinearScanAllocator::allocateBlockedReg(
       splitAndSave(act_interval, current_start, unhandled);
     }
 
-    auto inact_iter = reg_inactive_intervals.find(reg);
+    auto inact_iter = reg_inactive_intervals.find(*reg);
     if (inact_iter != reg_inactive_intervals.end()) {
       for (auto& inact_interval : inact_iter->second) {
         // do not split fixed intervals here. if current and the fixed interval
@@ -1157,16 +1327,16 @@ void LinearScanAllocator::rewriteLIR() {
       auto instr = instr_iter->get();
       TRACE("{} - {} - {}", instr_loc, process_input ? "in" : "out", *instr);
 
-      CopyGraphWithOperand copies;
+      PendingMoves moves;
       // check for new allocated intervals and update register mappings
       while (allocated_iter != allocated_.end() &&
              (*allocated_iter)->startLocation() <= instr_loc) {
         auto& interval = *allocated_iter;
-        rewriteLIRUpdateMapping(mapping, interval.get(), &copies);
+        rewriteLIRUpdateMapping(mapping, interval.get(), &moves);
         ++allocated_iter;
       }
 
-      rewriteLIREmitCopies(bb, instr_iter, copies);
+      rewriteLIREmitCopies(bb, instr_iter, moves);
 
       if (process_input) {
         // phi node inputs have to be handled by its predecessor
@@ -1239,6 +1409,8 @@ void LinearScanAllocator::rewriteInstrOutput(
   if (instr->opcode() == Opcode::kCall ||
       instr->opcode() == Opcode::kVarArgCall ||
       instr->opcode() == Opcode::kVectorCallTstate ||
+      instr->opcode() == Opcode::kDirectVectorCall ||
+      instr->opcode() == Opcode::kDirectStaticCall ||
       instr->opcode() == Opcode::kLoadThreadState) {
     output->setNone();
   } else {
@@ -1336,7 +1508,7 @@ void LinearScanAllocator::rewriteInstrOneIndirectOperand(
 void LinearScanAllocator::rewriteLIRUpdateMapping(
     UnorderedMap<const lir::Operand*, const LiveInterval*>& mapping,
     LiveInterval* interval,
-    CopyGraphWithOperand* copies) {
+    PendingMoves* moves) {
   auto operand = interval->operand();
   auto [mapping_iter, inserted] = mapping.emplace(operand, interval);
   if (inserted) {
@@ -1344,13 +1516,13 @@ void LinearScanAllocator::rewriteLIRUpdateMapping(
     return;
   }
 
-  if (copies != nullptr) {
+  if (moves != nullptr) {
     auto from = mapping_iter->second->allocatedLoc();
     auto to = interval->allocatedLoc();
     if (from != to) {
       auto data_type = operand->dataType();
       TRACE("Adding copy {} -> {} with data type {}", from, to, data_type);
-      copies->addEdge(from.loc, to.loc, data_type);
+      addMove(*moves, operand, from, to, data_type);
     }
   }
 
@@ -1358,6 +1530,27 @@ void LinearScanAllocator::rewriteLIRUpdateMapping(
   mapping_iter->second = interval;
 }
 
+void LinearScanAllocator::addMove(
+    PendingMoves& moves,
+    const Operand* operand,
+    PhyLocation from,
+    PhyLocation to,
+    DataType data_type) {
+  if (operand != nullptr && from.isMemory() && to.isRegister()) {
+    auto iter = remats_.find(operand);
+    if (iter != remats_.end()) {
+      TRACE("Rematerializing {} into {}", *operand, to);
+      moves.remats.emplace_back(to, &iter->second);
+      return;
+    }
+  }
+  moves.copies.addEdge(from.loc, to.loc, data_type);
+}
+
+bool LinearScanAllocator::PendingMoves::isEmpty() const {
+  return copies.isEmpty() && remats.empty();
+}
+
 void LinearScanAllocator::resolveEdges() {
   // collect intervals that are live at beginning of a basic block
   UnorderedMap<BasicBlock*, std::vector<LiveInterval*>> bb_interval_map;
@@ -1490,12 +1683,12 @@ void LinearScanAllocator::resolveEdges() {
   }
 }
 
-std::unique_ptr<LinearScanAllocator::CopyGraphWithOperand>
+std::unique_ptr<LinearScanAllocator::PendingMoves>
 LinearScanAllocator::resolveEdgesGenCopies(
     const BasicBlock* basicblock,
     const BasicBlock* successor,
     std::vector<LiveInterval*>& intervals) {
-  auto copies = std::make_unique<CopyGraphWithOperand>();
+  auto copies = std::make_unique<PendingMoves>();
   auto& end_mapping = bb_vreg_end_mapping_[basicblock];
   auto& succ_regalloc_block = map_get(regalloc_blocks_, successor);
 
@@ -1571,7 +1764,12 @@ LinearScanAllocator::resolveEdgesGenCopies(
           data_type,
           basicblock->id(),
           successor->id());
-      copies->addEdge(from.loc, to.loc, data_type);
+      addMove(
+          *copies,
+          phi != nullptr ? nullptr : interval->operand(),
+          from,
+          to,
+          data_type);
     }
   }
 
@@ -1581,8 +1779,8 @@ LinearScanAllocator::resolveEdgesGenCopies(
 void LinearScanAllocator::rewriteLIREmitCopies(
     BasicBlock* block,
     instr_iter_t instr_iter,
-    CopyGraphWithOperand& copies) {
-  for (auto op : copies.process()) {
+    PendingMoves& moves) {
+  for (auto op : moves.copies.process()) {
     PhyLocation from = op.from;
     PhyLocation to = op.to;
     [[maybe_unused]] auto orig_opnd_size = op.type;
@@ -1600,6 +1798,11 @@ void LinearScanAllocator::rewriteLIREmitCopies(
           instr->output()->setPhyRegOrStackSlot(to);
           instr->output()->setDataType(DataType::k64bit);
         } else if (to.isRegister() || from.isRegister()) {
+          if (to.isMemory()) {
+            spill_counts_.spills++;
+          } else if (from.isMemory()) {
+            spill_counts_.reloads++;
+          }
           auto instr = block->allocateInstrBefore(instr_iter, Opcode::kMove);
 #if defined(CINDER_AARCH64)
           // ARM64: always use 64-bit moves for edge-resolution copies
@@ -1622,6 +1825,8 @@ void LinearScanAllocator::rewriteLIREmitCopies(
           instr->output()->setPhyRegOrStackSlot(to);
           instr->output()->setDataType(copy_dt);
         } else {
+          spill_counts_.reloads++;
+          spill_counts_.spills++;
 #if defined(CINDER_AARCH64)
           // ARM64: avoid push+pop for stack-to-stack copies. Use scratch x13
           // (excluded from register allocation via DISALLOWED_REGISTERS) to
@@ -1673,6 +1878,18 @@ void LinearScanAllocator::rewriteLIREmitCopies(
       }
     }
   }
+
+  for (auto [to, remat] : moves.remats) {
+    auto instr = block->allocateInstrBefore(instr_iter, remat->opcode);
+    if (remat->opcode == Opcode::kMove) {
+      instr->allocateImmediateInput(remat->constant, remat->input_type);
+    } else {
+      instr->allocateStackInput(remat->slot)->setDataType(remat->input_type);
+    }
+    instr->output()->setPhyRegister(to);
+    instr->output()->setDataType(remat->output_type);
+  }
+  spill_counts_.rematerializations += moves.remats.size();
 }
 
 // In the future, we should move basic block ordering to a separate pass.
@@ -1681,8 +1898,8 @@ void LinearScanAllocator::resolveEdgesInsertBasicBlocks(
     BasicBlock* next_basic_block,
     BasicBlock* true_bb,
     BasicBlock* false_bb,
-    std::unique_ptr<CopyGraphWithOperand> true_copies,
-    std::unique_ptr<CopyGraphWithOperand> false_copies) {
+    std::unique_ptr<PendingMoves> true_copies,
+    std::unique_ptr<PendingMoves> false_copies) {
   // convert {true_need_copy, false_need_copy, next_true, next_false}
   // => {bb1_is_true_bb, gen_new_bb1, gen_new_bb2}
   static constexpr std::array<std::tuple<bool, bool, bool>, 16> truth_table{{
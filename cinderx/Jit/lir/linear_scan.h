@@ -10,6 +10,8 @@
 
 #include <memory>
 #include <ostream>
+#include <utility>
+#include <vector>
 
 namespace cinderx::jit::lir {
 
@@ -155,6 +157,7 @@ class LinearScanAllocator : public RegisterAllocator {
 
   codegen::PhyRegisterSet getChangedRegs() const override;
   int getFrameSize() const override;
+  SpillCounts getSpillCounts() const override;
 
   // Get the mapping of virtual registers to liveness intervals.  Meant for
   // tests.
@@ -177,11 +180,62 @@ class LinearScanAllocator : public RegisterAllocator {
 
   using CopyGraphWithOperand = codegen::CopyGraphWithType<const DataType>;
 
+  // How to recompute a value with a single instruction that reads no allocated
+  // location, instead of reloading it from its stack slot.
+  struct Rematerialization {
+    // kMove of an immediate, or kLea of a stack slot.
+    Opcode opcode;
+    uint64_t constant{0};
+    PhyLocation slot;
+    DataType input_type;
+    DataType output_type;
+  };
+
+  // The moves to insert at one program point.  Copies between allocated
+  // locations are sequenced by a CopyGraph.  Rematerializations don't read any
+  // allocated location, so they are emitted after all of the copies.
+  struct PendingMoves {
+    CopyGraphWithOperand copies;
+    std::vector<std::pair<PhyLocation, const Rematerialization*>> remats;
+
+    bool isEmpty() const;
+  };
+
+  // Relative cost of evicting a value from its register until its next use.
+  // Compared lexicographically: first by the kind of the next use (none at all,
+  // a rematerialization, or a reload weighted by loop depth), then preferring
+  // the furthest-away use.
+  using SpillCost = std::pair<int, LIRLocation>;
+
   // Get the interval for an operand.
   LiveInterval& getInterval(const Operand* operand);
 
   void calculateLiveIntervals();
 
+  // Find the loops in the (sorted) function and the loop depth of each block.
+  // Called at the end of calculateLiveIntervals().
+  void calculateLoopDepths();
+
+  // Record the values that can be rematerialized rather than reloaded.  Called
+  // at the end of calculateLiveIntervals().
+  void collectRematerializations();
+
+  // Number of loops enclosing a location.
+  int loopDepthAt(LIRLocation loc) const;
+
+  bool isRematerializable(const Operand* operand) const;
+
+  SpillCost spillCost(const Operand* operand, LIRLocation next_use) const;
+
+  // Where to split an interval that has been spilled at `start` and next needs
+  // a register at `use`.  If the use is inside a loop that begins after the
+  // spill, split at the loop header instead so the reload happens once on
+  // entry to the loop rather than on every iteration.
+  LIRLocation spillSplitLocation(
+      const LiveInterval* interval,
+      LIRLocation start,
+      LIRLocation use) const;
+
   // Reserve registers for a function call, spilling all allocatable registers
   // when free-threaded stack scanning needs every live value in spill data.
   void reserveRegistersForCall(const Instruction& instr, LIRLocation instr_loc);
@@ -207,7 +261,7 @@ class LinearScanAllocator : public RegisterAllocator {
       UnhandledQueue& unhandled);
 
   // Make room for `current` by spilling either `current` or an
-  // already-allocated interval, whichever has the further-away next use.
+  // already-allocated interval, whichever is cheaper by spillCost().
   void allocateBlockedReg(
       LiveInterval* current,
       UnorderedSet<LiveInterval*>& active,
@@ -250,23 +304,32 @@ class LinearScanAllocator : public RegisterAllocator {
       const UnorderedSet<const Operand*>* last_use_vregs);
 
   // Update the virtual register to physical register mapping.  If the mapping
-  // is changed for a virtual register and `copies` is not nullptr, insert a
-  // copy to `copies` for CopyGraph to generate a MOV instruction.
+  // is changed for a virtual register and `moves` is not nullptr, add a move
+  // to `moves` to generate a MOV instruction.
   void rewriteLIRUpdateMapping(
       UnorderedMap<const Operand*, const LiveInterval*>& mapping,
       LiveInterval* interval,
-      CopyGraphWithOperand* copies);
-
-  // Emit copies before `instr_iter`.
+      PendingMoves* moves);
+
+  // Add a move of `operand` (nullptr if unknown) from one location to another,
+  // rematerializing it instead of reloading it from memory if possible.
+  void addMove(
+      PendingMoves& moves,
+      const Operand* operand,
+      PhyLocation from,
+      PhyLocation to,
+      DataType data_type);
+
+  // Emit moves before `instr_iter`.
   void rewriteLIREmitCopies(
       BasicBlock* block,
       instr_iter_t instr_iter,
-      CopyGraphWithOperand& copies);
+      PendingMoves& moves);
 
   // Resolve allocations across block boundaries by emitting extra copies.
   void resolveEdges();
 
-  std::unique_ptr<CopyGraphWithOperand> resolveEdgesGenCopies(
+  std::unique_ptr<PendingMoves> resolveEdgesGenCopies(
       const BasicBlock* basicblock,
       const BasicBlock* successor,
       std::vector<LiveInterval*>& intervals);
@@ -287,8 +350,8 @@ class LinearScanAllocator : public RegisterAllocator {
       BasicBlock* next_basic_block,
       BasicBlock* true_bb,
       BasicBlock* false_bb,
-      std::unique_ptr<CopyGraphWithOperand> true_copies,
-      std::unique_ptr<CopyGraphWithOperand> false_copies);
+      std::unique_ptr<PendingMoves> true_copies,
+      std::unique_ptr<PendingMoves> false_copies);
 
   Function* func_;
 
@@ -344,12 +407,28 @@ class LinearScanAllocator : public RegisterAllocator {
   // Map of operands to stack slots upon spilling.
   UnorderedMap<const Operand*, PhyLocation> operand_to_slot_;
 
+  // The loop depth of each basic block, as (block start, depth) pairs sorted by
+  // block start.
+  std::vector<std::pair<LIRLocation, int>> block_loop_depths_;
+
+  // The location ranges covered by loops, sorted by start (the header).
+  std::vector<LiveRange> loop_ranges_;
+
+  // Values that can be recomputed instead of reloaded, keyed by their defining
+  // operand.
+  UnorderedMap<const Operand*, Rematerialization> remats_;
+
+  SpillCounts spill_counts_;
+
   FRIEND_TEST(LinearScanAllocatorTest, RegAllocationNoSpill);
   FRIEND_TEST(LinearScanAllocatorTest, RegAllocation);
   FRIEND_TEST(
       LinearScanAllocatorTest,
       ArbitraryExecutionCallReservesAllRegistersInFreeThreadedBuild);
   FRIEND_TEST(LinearScanAllocatorTest, DeoptExitReservesVectorRegisters);
+  FRIEND_TEST(LinearScanAllocatorTest, LoopDepths);
+  FRIEND_TEST(LinearScanAllocatorTest, SpillCostWeighsLoopDepth);
+  FRIEND_TEST(LinearScanAllocatorTest, SpillSplitHoistsReloadOutOfLoop);
 };
 
 std::ostream& operator<<(std::ostream& out, const LiveRange& rhs);
@@ -0,0 +1,349 @@
+// Copyright (c) Meta Platforms, Inc. and affiliates.
+
+#include "cinderx/Jit/lir/load_elim.h"
+
+#include "cinderx/Common/containers.h"
+#include "cinderx/Common/util.h"
+#include "cinderx/Jit/codegen/arch.h"
+#include "cinderx/Jit/lir/block.h"
+#include "cinderx/Jit/lir/instruction.h"
+#include "cinderx/Jit/lir/operand.h"
+
+#include <algorithm>
+#include <optional>
+#include <variant>
+#include <vector>
+
+namespace cinderx::jit::lir {
+
+namespace {
+
+// Cap on the number of locations tracked at once, to keep the pass linear in
+// the size of the function.
+constexpr size_t kMaxAvailable = 32;
+
+// A register used to form an address: the instruction defining a virtual
+// register, the number of a physical register, or nothing.
+using AddressReg = std::variant<std::monostate, const Instruction*, int>;
+
+// A memory location read or written by an operand.  Absolute addresses have
+// no base and keep the address in the offset.
+struct Location {
+  AddressReg base;
+  AddressReg index;
+  uint8_t multiplier{0};
+  int64_t offset{0};
+  size_t size{0};
+  DataType data_type{DataType::kObject};
+
+  bool operator==(const Location& other) const = default;
+
+  // Two locations can only be proven distinct if they're addressed off of the
+  // same registers and their bytes don't overlap.  Anything else might be the
+  // same memory under a different name.
+  bool mayAlias(const Location& other) const {
+    if (base != other.base || index != other.index ||
+        multiplier != other.multiplier) {
+      return true;
+    }
+    return offset < other.offset + static_cast<int64_t>(other.size) &&
+        other.offset < offset + static_cast<int64_t>(size);
+  }
+
+  bool usesReg(const AddressReg& reg) const {
+    return base == reg || index == reg;
+  }
+};
+
+// Whether an instruction with this opcode can only write to memory through its
+// output operand or, for Inc and Dec, its input operand.  Everything else is
+// assumed to write anywhere.
+bool writesOnlyOwnOperands(Opcode opcode) {
+  switch (opcode) {
+    case Opcode::kAdd:
+    case Opcode::kAnd:
+    case Opcode::kBind:
+    case Opcode::kBranch:
+    case Opcode::kBranchCC:
+    case Opcode::kCallSiteLiveValues:
+    case Opcode::kCmp:
+    case Opcode::kCompare:
+    case Opcode::kCondBranch:
+    case Opcode::kDec:
+    case Opcode::kDiv:
+    case Opcode::kDivUn:
+    case Opcode::kFadd:
+    case Opcode::kFdiv:
+    case Opcode::kFmul:
+    case Opcode::kFsub:
+    case Opcode::kGuard:
+    case Opcode::kInc:
+    case Opcode::kInt64ToDouble:
+    case Opcode::kIntToBool:
+    case Opcode::kInvert:
+    case Opcode::kLShift:
+    case Opcode::kLea:
+    case Opcode::kMovConstPool:
+    case Opcode::kMove:
+    case Opcode::kMul:
+    case Opcode::kMulAdd:
+    case Opcode::kNegate:
+    case Opcode::kNop:
+    case Opcode::kOr:
+    case Opcode::kPhi:
+    case Opcode::kRShift:
+    case Opcode::kRShiftUn:
+    case Opcode::kSelect:
+    case Opcode::kSext:
+    case Opcode::kSub:
+    case Opcode::kTest:
+    case Opcode::kTest32:
+    case Opcode::kXor:
+    case Opcode::kZext:
+      return true;
+    default:
+      return false;
+  }
+}
+
+bool isMemory(const Operand* operand) {
+  return !operand->isLinked() &&
+      (operand->isStack() || operand->isMem() || operand->isInd());
+}
+
+class LoadEliminator {
+ public:
+  explicit LoadEliminator(Function* func) : func_{func} {}
+
+  void run() {
+    findMutatedValues();
+
+    // The register allocator sorts the blocks anyway.  Doing it now means
+    // that, loops aside, a block's predecessors are all visited before it.
+    func_->sortBasicBlocks();
+    for (BasicBlock* block : func_->basicBlocks()) {
+      State state = entryState(block);
+      for (auto& instr : block->instructions()) {
+        processInstr(instr.get(), state);
+      }
+      exit_states_.emplace(block, std::move(state));
+    }
+
+    if (replacements_.empty()) {
+      return;
+    }
+    relinkUses();
+    for (auto& [load, value] : replacements_) {
+      BasicBlock* block = load->basicBlock();
+      block->removeInstr(block->iterator_to(load));
+    }
+  }
+
+ private:
+  // A location along with the instruction whose output holds its contents.
+  struct Available {
+    Location location;
+    Instruction* value;
+  };
+  using State = std::vector<Available>;
+
+  // Inc and Dec update their input in place, so a value that is ever
+  // incremented or decremented is not the same value everywhere it's used, and
+  // must not stand in for, or be replaced by, a load.
+  void findMutatedValues() {
+    for (BasicBlock* block : func_->basicBlocks()) {
+      for (auto& instr : block->instructions()) {
+        if (!instr->isInc() && !instr->isDec()) {
+          continue;
+        }
+        Operand* input = instr->getInput(0);
+        if (input->isLinked()) {
+          mutated_.insert(input->getLinkedInstr());
+        }
+      }
+    }
+  }
+
+  // What is known on entry to a block is what is known on exit from all of its
+  // predecessors.  A predecessor that hasn't been visited yet is a back edge
+  // (or the generator resume entry), about which nothing is known.
+  State entryState(const BasicBlock* block) const {
+    const auto& preds = block->predecessors();
+    if (preds.empty()) {
+      return {};
+    }
+    auto first = exit_states_.find(preds[0]);
+    if (first == exit_states_.end()) {
+      return {};
+    }
+    State state = first->second;
+    for (size_t i = 1; i < preds.size() && !state.empty(); ++i) {
+      auto it = exit_states_.find(preds[i]);
+      if (it == exit_states_.end()) {
+        return {};
+      }
+      const State& other = it->second;
+      std::erase_if(state, [&](const Available& avail) {
+        return std::none_of(
+            other.begin(), other.end(), [&](const Available& other_avail) {
+              return other_avail.location == avail.location &&
+                  other_avail.value == avail.value;
+            });
+      });
+    }
+    return state;
+  }
+
+  void processInstr(Instruction* instr, State& state) {
+    if (!writesOnlyOwnOperands(instr->opcode())) {
+      state.clear();
+      return;
+    }
+
+    Operand* output = instr->output();
+    if (instr->isMove() && output->isVreg() && isMemory(instr->getInput(0))) {
+      processLoad(instr, state);
+      return;
+    }
+
+    if ((instr->isInc() || instr->isDec()) && isMemory(instr->getInput(0))) {
+      kill(state, location(instr->getInput(0)));
+    }
+
+    if (output->isReg()) {
+      AddressReg reg{output->getPhyRegister().loc};
+      std::erase_if(state, [&](const Available& avail) {
+        return avail.location.usesReg(reg);
+      });
+    } else if (isMemory(output)) {
+      Location loc = location(output);
+      kill(state, loc);
+      if (instr->isMove()) {
+        forwardStore(instr, loc, state);
+      }
+    }
+  }
+
+  void processLoad(Instruction* load, State& state) {
+    Location loc = location(load->getInput(0));
+    if (mutated_.contains(load)) {
+      return;
+    }
+    DataType data_type = load->output()->dataType();
+    for (const Available& avail : state) {
+      if (avail.location == loc &&
+          avail.value->output()->dataType() == data_type) {
+        replacements_.emplace(load, avail.value);
+        return;
+      }
+    }
+    add(state, loc, load);
+  }
+
+  // After a store of a virtual register, a load of the same location can use
+  // that register instead.
+  void forwardStore(Instruction* store, const Location& loc, State& state) {
+    Operand* input = store->getInput(0);
+    if (!input->isLinked()) {
+      return;
+    }
+    Instruction* value = resolve(input->getLinkedInstr());
+    if (mutated_.contains(value) || !value->output()->isVreg() ||
+        value->output()->dataType() != store->output()->dataType()) {
+      return;
+    }
+    add(state, loc, value);
+  }
+
+  void kill(State& state, const Location& loc) {
+    std::erase_if(state, [&](const Available& avail) {
+      return avail.location.mayAlias(loc);
+    });
+  }
+
+  void add(State& state, const Location& loc, Instruction* value) {
+    if (state.size() == kMaxAvailable) {
+      state.erase(state.begin());
+    }
+    state.push_back(Available{loc, value});
+  }
+
+  Location location(const Operand* operand) const {
+    Location loc;
+    loc.size = operand->sizeInBits() / 8;
+    loc.data_type = operand->dataType();
+    if (operand->isStack()) {
+      loc.base = codegen::arch::reg_frame_pointer_loc.loc;
+      loc.offset = operand->getStackSlot().loc;
+    } else if (operand->isMem()) {
+      loc.offset = reinterpret_cast<intptr_t>(operand->getMemoryAddress());
+    } else {
+      JIT_DCHECK(operand->isInd(), "Expected a memory operand");
+      MemoryIndirect* ind = operand->getMemoryIndirect();
+      loc.base = addressReg(ind->getBaseRegOperand());
+      loc.index = addressReg(ind->getIndexRegOperand());
+      loc.multiplier = ind->getMultiplier();
+      loc.offset = ind->getOffset();
+    }
+    return loc;
+  }
+
+  AddressReg addressReg(Operand* operand) const {
+    if (operand == nullptr) {
+      return {};
+    }
+    if (operand->isLinked()) {
+      return resolve(operand->getLinkedInstr());
+    }
+    return operand->getPhyRegister().loc;
+  }
+
+  Instruction* resolve(Instruction* instr) const {
+    auto it = replacements_.find(instr);
+    return it != replacements_.end() ? it->second : instr;
+  }
+
+  void relinkUses() {
+    auto relink = [&](Operand* operand) {
+      if (operand != nullptr && operand->isLinked()) {
+        Instruction* def = operand->getLinkedInstr();
+        Instruction* value = resolve(def);
+        if (value != def) {
+          operand->setLinkedInstr(value);
+        }
+      }
+    };
+    auto relink_operand = [&](Operand* operand) {
+      if (operand->isInd()) {
+        MemoryIndirect* ind = operand->getMemoryIndirect();
+        relink(ind->getBaseRegOperand());
+        relink(ind->getIndexRegOperand());
+      } else {
+        relink(operand);
+      }
+    };
+    for (BasicBlock* block : func_->basicBlocks()) {
+      for (auto& instr : block->instructions()) {
+        instr->foreachInputOperand(relink_operand);
+        if (instr->output() != nullptr) {
+          relink_operand(instr->output());
+        }
+      }
+    }
+  }
+
+  Function* func_;
+  UnorderedSet<const Instruction*> mutated_;
+  // Each redundant load maps to the instruction holding its value.  Values
+  // are resolved when they're recorded, so there are no chains.
+  UnorderedMap<Instruction*, Instruction*> replacements_;
+  UnorderedMap<const BasicBlock*, State> exit_states_;
+};
+
+} // namespace
+
+void eliminateRedundantLoads(Function* func) {
+  LoadEliminator{func}.run();
+}
+
+} // namespace cinderx::jit::lir
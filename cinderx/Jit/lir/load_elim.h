@@ -0,0 +1,19 @@
+// Copyright (c) Meta Platforms, Inc. and affiliates.
+
+#pragma once
+
+#include "cinderx/Jit/lir/function.h"
+
+namespace cinderx::jit::lir {
+
+// Remove loads from memory whose value is already held in a virtual register.
+//
+// A load is redundant if the same location was loaded from or stored to
+// earlier in its block, or on every path into its block, and nothing in
+// between could have written to it.  Uses of the redundant load are redirected
+// to the earlier value and the load is deleted.  Instructions that can write to
+// arbitrary memory (calls, yields, pushes, relaxed atomics) forget everything
+// known so far.
+void eliminateRedundantLoads(Function* func);
+
+} // namespace cinderx::jit::lir
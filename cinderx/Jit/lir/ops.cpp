@@ -308,6 +308,7 @@ bool inputMustBeRegister(Opcode opcode, size_t idx) {
     case Opcode::kCmpBranchNonZero:
     case Opcode::kCmpBranchZero:
     case Opcode::kCondBranch:
+    case Opcode::kDirectVectorCall:
     case Opcode::kDiv:
     case Opcode::kDivUn:
     case Opcode::kInt64ToDouble:
@@ -371,6 +372,8 @@ bool inputsLiveAcross(Opcode opcode) {
 OperandSizeType operandSizeType(Opcode opcode) {
   switch (opcode) {
     case Opcode::kCall:
+    case Opcode::kDirectStaticCall:
+    case Opcode::kDirectVectorCall:
     case Opcode::kExchange:
     case Opcode::kFadd:
     case Opcode::kFdiv:
@@ -32,6 +32,10 @@ namespace cinderx::jit::lir {
   X(CondBranch)                                                 \
   X(Dec)                                                        \
   X(DeoptPatchpoint)                                            \
+  /* Call a known static entry at a patchable call site */      \
+  X(DirectStaticCall)                                           \
+  /* Vectorcall a known function at a patchable call site */    \
+  X(DirectVectorCall)                                           \
   X(Div)                                                        \
   X(DivUn)                                                      \
   X(EpilogueEnd)                                                \
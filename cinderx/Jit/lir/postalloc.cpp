@@ -479,7 +479,7 @@ int prepareArgsArray(
   return rsp_sub;
 }
 
-// Common implementation for kVectorCallTstate rewrites.
+// Common implementation for kVectorCallTstate and kDirectVectorCall rewrites.
 // reg_offset: index into ARGUMENT_REGS where callable goes (0 or 1).
 // callable_input: index of the callable operand in instr's inputs.
 // first_arg: index of the first variadic arg in instr's inputs.
@@ -613,6 +613,13 @@ int rewriteVectorCallTstateFunctions(instr_iter_t instr_iter, int base_offset) {
   return rewriteVectorCallCommon(instr_iter, base_offset, 1, 3, 4);
 }
 
+// Rewrite a kDirectVectorCall instruction.
+// Fixed inputs: #0 patcher, #1 flags, #2 callable.
+// Calling convention: (callable, args, nargsf, kwnames)
+int rewriteDirectVectorCall(instr_iter_t instr_iter, int base_offset) {
+  return rewriteVectorCallCommon(instr_iter, base_offset, 0, 2, 3);
+}
+
 int rewriteVarArgCall(instr_iter_t instr_iter, int base_offset) {
   auto instr = instr_iter->get();
   instr->setOpcode(Opcode::kCall);
@@ -643,7 +650,9 @@ RewriteResult rewriteCallInstrs(instr_iter_t instr_iter, Environ* env) {
     env->max_arg_buffer_size =
         std::max<int>(env->max_arg_buffer_size, base_offset + rsp_sub);
     return kChanged;
-  } else if (!instr->isCall() && !instr->isVectorCallTstate()) {
+  } else if (
+      !instr->isCall() && !instr->isVectorCallTstate() &&
+      !instr->isDirectVectorCall() && !instr->isDirectStaticCall()) {
     return kUnchanged;
   }
 
@@ -657,12 +666,20 @@ RewriteResult rewriteCallInstrs(instr_iter_t instr_iter, Environ* env) {
 
   if (instr->isVectorCallTstate()) {
     rsp_sub = rewriteVectorCallTstateFunctions(instr_iter, base_offset);
+  } else if (instr->isDirectVectorCall()) {
+    rsp_sub = rewriteDirectVectorCall(instr_iter, base_offset);
   } else {
+    // DirectStaticCall has the same layout as Call, with the patcher in place
+    // of the call target, and passes arguments the same way.
     rsp_sub = rewriteRegularFunction(instr_iter, base_offset);
   }
 
   instr->setNumInputs(1); // leave function self operand only
-  instr->setOpcode(Opcode::kCall);
+  // A DirectVectorCall or DirectStaticCall keeps its opcode so that codegen
+  // emits a patchable call site for the patcher left in its first input.
+  if (!instr->isDirectVectorCall() && !instr->isDirectStaticCall()) {
+    instr->setOpcode(Opcode::kCall);
+  }
 
   auto next_iter = std::next(instr_iter);
 
@@ -1244,6 +1261,8 @@ RewriteResult rewriteMemoryInputsToReg(instr_iter_t instr_iter) {
     case Opcode::kCmpBranchZero:
     case Opcode::kCondBranch:
     case Opcode::kDeoptPatchpoint:
+    case Opcode::kDirectStaticCall:
+    case Opcode::kDirectVectorCall:
     case Opcode::kEpilogueEnd:
     case Opcode::kGuard:
     case Opcode::kInt64ToDouble:
@@ -923,6 +923,7 @@ bool shouldPreserveTaggedCallArgs(const Instruction& instr) {
       // recognize and skip them; every other call should still see untagged
       // object pointers.
       bool is_call = instr->isCall() || instr->isVectorCallTstate() ||
+          instr->isDirectVectorCall() || instr->isDirectStaticCall() ||
           instr->isVarArgCall();
       bool strip_call_args = is_call && !shouldPreserveTaggedCallArgs(*instr);
       bool is_compare = instr->isCompare() &&
@@ -935,8 +936,15 @@ bool shouldPreserveTaggedCallArgs(const Instruction& instr) {
       size_t start = 0;
       if (strip_call_args) {
         // VectorCallTstate has fixed inputs for helper, flags, and tstate
-        // before the callable and Python object arguments.
-        start = instr->isVectorCallTstate() ? 3 : 1;
+        // before the callable and Python object arguments, DirectVectorCall
+        // the same minus tstate.
+        if (instr->isVectorCallTstate()) {
+          start = 3;
+        } else if (instr->isDirectVectorCall()) {
+          start = 2;
+        } else {
+          start = 1;
+        }
       }
       size_t end = instr->getNumInputs();
       for (size_t i = start; i < end; ++i) {
@@ -6,4 +6,8 @@ namespace cinderx::jit::lir {
 
 RegisterAllocator::~RegisterAllocator() = default;
 
+SpillCounts RegisterAllocator::getSpillCounts() const {
+  return {};
+}
+
 } // namespace cinderx::jit::lir
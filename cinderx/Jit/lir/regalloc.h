@@ -4,10 +4,22 @@
 
 #include "cinderx/Jit/codegen/arch.h"
 
+#include <cstddef>
+
 namespace cinderx::jit::lir {
 
 class Operand;
 
+// Moves inserted by a register allocator to get values in and out of registers.
+struct SpillCounts {
+  // Register-to-memory moves.
+  size_t spills{0};
+  // Memory-to-register moves.
+  size_t reloads{0};
+  // Values recomputed in a register instead of being reloaded.
+  size_t rematerializations{0};
+};
+
 // Abstract interface for a register allocator.
 //
 // A register allocator consumes an LIR function that is using virtual
@@ -25,6 +37,9 @@ class RegisterAllocator {
 
   // The number of bytes that should be allocated below the base pointer.
   virtual int getFrameSize() const = 0;
+
+  // Counts of the spill code inserted by the allocator.
+  virtual SpillCounts getSpillCounts() const;
 };
 
 } // namespace cinderx::jit::lir
@@ -167,7 +167,9 @@ void SpillAllocator::rewriteInstr(BasicBlock* block, instr_iter_t iter) {
     rewriteBind(block, iter);
     return;
   }
-  if (instr->isCall() || instr->isVarArgCall() || instr->isVectorCallTstate()) {
+  if (instr->isCall() || instr->isVarArgCall() ||
+      instr->isVectorCallTstate() || instr->isDirectVectorCall() ||
+      instr->isDirectStaticCall()) {
     rewriteCall(instr);
     return;
   }
@@ -362,7 +364,8 @@ void SpillAllocator::handleFramePointerSwitch(
     --back;
     Instruction* prev = back->get();
     if (!prev->isCall() && !prev->isVarArgCall() &&
-        !prev->isVectorCallTstate()) {
+        !prev->isVectorCallTstate() && !prev->isDirectVectorCall() &&
+        !prev->isDirectStaticCall()) {
       continue;
     }
     Operand* out = prev->output();
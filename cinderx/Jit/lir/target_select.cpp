@@ -13,10 +13,58 @@
 #include <iterator>
 #include <memory>
 #include <unordered_map>
+#include <variant>
+#include <vector>
 
 namespace cinderx::jit::lir {
 namespace {
 
+#if defined(CINDER_X86_64) || defined(CINDER_AARCH64)
+using UseCounts = std::unordered_map<const Instruction*, size_t>;
+
+void countOperandUse(UseCounts& use_counts, const Operand* operand) {
+  if (operand->isLinked()) {
+    use_counts[operand->getLinkedInstr()]++;
+    return;
+  }
+
+  if (!operand->isInd()) {
+    return;
+  }
+
+  MemoryIndirect* indirect = operand->getMemoryIndirect();
+  Operand* base = indirect->getBaseRegOperand();
+  if (base->isLinked()) {
+    use_counts[base->getLinkedInstr()]++;
+  }
+
+  Operand* index = indirect->getIndexRegOperand();
+  if (index != nullptr && index->isLinked()) {
+    use_counts[index->getLinkedInstr()]++;
+  }
+}
+
+/* Count the number of uses of each instruction in the function. This
+ * information should really be stored in the IR so that we have either use
+ * counts or use-def chains, but for now in order to get this functional we're
+ * going to count the uses here.
+ */
+UseCounts countUses(Function* func) {
+  UseCounts use_counts;
+  for (BasicBlock* block : func->basicBlocks()) {
+    for (std::unique_ptr<Instruction>& instr : block->instructions()) {
+      instr->foreachInputOperand([&use_counts](const Operand* operand) {
+        countOperandUse(use_counts, operand);
+      });
+      if (instr->output() != nullptr) {
+        countOperandUse(use_counts, instr->output());
+      }
+    }
+  }
+  return use_counts;
+}
+#endif
+
 #if defined(CINDER_X86_64)
 /* x86-64 can materialize an imm64 in a register, but cannot encode an imm64
  * directly as the source of a store to memory. Convert from:
@@ -59,7 +107,92 @@ void selectX64MoveToMemoryLargeConstant(
   instr->setInput(0, std::make_unique<Operand>(move, Operand::kLinked));
 }
 
+/* Convert from:
+ *
+ *     addr = Lea [base + index * scale + disp1]
+ *     mov [addr + disp2], ...
+ *
+ * to:
+ *
+ *     mov [base + index * scale + disp1 + disp2], ...
+ *
+ * x86-64 memory operands can encode any base + index * scale + disp, so the
+ * separate address computation is only needed while the Lea has other uses.
+ * Returns true if the operand was changed, in which case the folded address
+ * may itself be foldable.
+ */
+bool foldX64LeaIntoIndirect(Operand* operand, UseCounts& use_counts) {
+  MemoryIndirect* ind = operand->getMemoryIndirect();
+  Operand* base = ind->getBaseRegOperand();
+  if (base == nullptr || !base->isLinked()) {
+    return false;
+  }
+
+  Instruction* lea = base->getLinkedInstr();
+  if (!lea->isLea() || !lea->getInput(0)->isInd()) {
+    return false;
+  }
+
+  /* Only fold addresses formed from virtual registers.  Those have the same
+   * value wherever they're live, whereas a physical register (e.g. the frame
+   * pointer in a generator) may have been reassigned since the Lea. */
+  MemoryIndirect* lea_ind = lea->getInput(0)->getMemoryIndirect();
+  Operand* lea_base = lea_ind->getBaseRegOperand();
+  Operand* lea_index = lea_ind->getIndexRegOperand();
+  if (lea_base == nullptr || !lea_base->isLinked() ||
+      (lea_index != nullptr && !lea_index->isLinked())) {
+    return false;
+  }
+
+  Operand* index = ind->getIndexRegOperand();
+  if (index != nullptr && lea_index != nullptr) {
+    return false;
+  }
+
+  int64_t offset = int64_t{ind->getOffset()} + lea_ind->getOffset();
+  if (!fitsSignedInt<32>(offset)) {
+    return false;
+  }
+
+  Instruction* new_base = lea_base->getLinkedInstr();
+  std::variant<Instruction*, PhyLocation> new_index{nullptr};
+  uint8_t multiplier = 0;
+  if (lea_index != nullptr) {
+    new_index = lea_index->getLinkedInstr();
+    multiplier = lea_ind->getMultiplier();
+    use_counts[lea_index->getLinkedInstr()]++;
+  } else if (index != nullptr) {
+    if (index->isLinked()) {
+      new_index = index->getLinkedInstr();
+    } else {
+      new_index = index->getPhyRegister();
+    }
+    multiplier = ind->getMultiplier();
+  }
+  use_counts[new_base]++;
+  use_counts[lea]--;
+
+  ind->setMemoryIndirect(
+      new_base, new_index, multiplier, static_cast<int32_t>(offset));
+  return true;
+}
+
+void foldX64LeaAddresses(Instruction* instr, UseCounts& use_counts) {
+  auto fold = [&](Operand* operand) {
+    if (operand == nullptr || !operand->isInd()) {
+      return;
+    }
+    while (foldX64LeaIntoIndirect(operand, use_counts)) {
+    }
+  };
+  instr->foreachInputOperand(fold);
+  fold(instr->output());
+}
+
 void selectX64Opcodes(Function* func) {
+  UseCounts use_counts = countUses(func);
+  std::vector<Instruction*> leas;
+
   for (BasicBlock* block : func->basicBlocks()) {
     BasicBlock::InstrList& instrs = block->instructions();
     for (instr_iter_t iter = instrs.begin(); iter != instrs.end();) {
@@ -67,56 +200,28 @@ void selectX64Opcodes(Function* func) {
       switch (cur_iter->get()->opcode()) {
         case Opcode::kMove:
         case Opcode::kMoveRelaxed:
+          foldX64LeaAddresses(cur_iter->get(), use_counts);
           selectX64MoveToMemoryLargeConstant(block, cur_iter);
           break;
+        case Opcode::kLea:
+          foldX64LeaAddresses(cur_iter->get(), use_counts);
+          leas.push_back(cur_iter->get());
+          break;
         default:
           break;
       }
     }
   }
-}
-#elif defined(CINDER_AARCH64)
-using UseCounts = std::unordered_map<const Instruction*, size_t>;
-
-void countOperandUse(UseCounts& use_counts, const Operand* operand) {
-  if (operand->isLinked()) {
-    use_counts[operand->getLinkedInstr()]++;
-    return;
-  }
-
-  if (!operand->isInd()) {
-    return;
-  }
-
-  MemoryIndirect* indirect = operand->getMemoryIndirect();
-  Operand* base = indirect->getBaseRegOperand();
-  if (base->isLinked()) {
-    use_counts[base->getLinkedInstr()]++;
-  }
 
-  Operand* index = indirect->getIndexRegOperand();
-  if (index != nullptr && index->isLinked()) {
-    use_counts[index->getLinkedInstr()]++;
-  }
-}
-
-/* Count the number of uses of each instruction in the function. This
- * information should really be stored in the IR so that we have either use
- * counts or use-def chains, but for now in order to get this functional we're
- * going to count the uses here.
- */
-UseCounts countUses(Function* func) {
-  UseCounts use_counts;
-  for (BasicBlock* block : func->basicBlocks()) {
-    for (std::unique_ptr<Instruction>& instr : block->instructions()) {
-      instr->foreachInputOperand([&use_counts](const Operand* operand) {
-        countOperandUse(use_counts, operand);
-      });
+  /* Remove the Leas whose every use has been folded away. */
+  for (Instruction* lea : leas) {
+    if (lea->output()->isVreg() && use_counts[lea] == 0) {
+      BasicBlock* block = lea->basicBlock();
+      block->removeInstr(block->iterator_to(lea));
     }
   }
-  return use_counts;
 }
-
+#elif defined(CINDER_AARCH64)
 /* Check that intervening instructions between two iterator points do not modify
  * flags in any way. This allows the two endpoints to reliably set/get flags. */
 bool flagsPreservedBetween(instr_iter_t begin, instr_iter_t end) {
@@ -50,6 +50,7 @@
 #endif
 #include <fmt/std.h>
 
+#include <algorithm>
 #include <atomic>
 #include <charconv>
 #include <chrono>
@@ -293,6 +294,61 @@ void setRegAlloc(const std::string& reg_alloc) {
   }
 }
 
+// Parse the generator pool size classes from a comma-separated list of
+// SIZE:CAPACITY[:THREAD_CAPACITY] entries.  On an invalid value this sets a
+// Python exception, which initialize() turns into an initialization failure.
+void setGenPoolClasses(const std::string& value) {
+  constexpr size_t kMaxClasses = 16;
+  constexpr size_t kMaxSize = 1024 * 1024;
+  std::vector<GenPoolSizeClass> classes;
+  bool valid = true;
+  size_t start = 0;
+  while (valid && start <= value.size()) {
+    size_t end = value.find(',', start);
+    if (end == std::string::npos) {
+      end = value.size();
+    }
+    std::array<size_t, 3> fields{};
+    size_t num_fields = 0;
+    const char* p = value.data() + start;
+    const char* p_end = value.data() + end;
+    while (valid && num_fields < fields.size()) {
+      auto [ptr, ec] = std::from_chars(p, p_end, fields[num_fields]);
+      valid = ec == std::errc();
+      num_fields++;
+      p = ptr;
+      if (p == p_end || *p != ':') {
+        break;
+      }
+      p++;
+    }
+    valid = valid && p == p_end && num_fields >= 2;
+    GenPoolSizeClass cls{
+        fields[0],
+        fields[1],
+        num_fields == 3 ? fields[2] : std::max<size_t>(fields[1] / 8, 1)};
+    // Entries hold objects, so keep them aligned as the allocator would.
+    valid = valid && cls.size % 16 == 0 && cls.size > 0 &&
+        cls.size <= kMaxSize && cls.capacity > 0 && cls.thread_capacity > 0 &&
+        (classes.empty() || classes.back().size < cls.size) &&
+        classes.size() < kMaxClasses;
+    classes.push_back(cls);
+    start = end + 1;
+  }
+  if (!valid) {
+    PyErr_Format(
+        PyExc_ValueError,
+        "Invalid value for -X cinderx-jit-gen-pool-classes: '%s'. Expected up "
+        "to %zu comma-separated SIZE:CAPACITY[:THREAD_CAPACITY] entries with "
+        "sizes in increasing order, multiples of 16 and at most %zu bytes.",
+        value.c_str(),
+        kMaxClasses,
+        kMaxSize);
+    return;
+  }
+  getMutableConfig().gen_pool_classes = std::move(classes);
+}
+
 size_t parse_sized_argument(const std::string& val) {
   std::string parsed;
   // " 1024 k" should parse OK - so remove the space.
@@ -558,6 +614,15 @@ FlagProcessor initFlagProcessor() {
           "Load list of functions to compile from <filename>")
       .withFlagParamName("filename");
 
+  flag_processor
+      .addOption(
+          "cinderx-jit-hot-manifest",
+          "CINDERX_JIT_HOT_MANIFEST",
+          getMutableConfig().hot_manifest_file,
+          "Compile the functions recorded in hot-function manifest <filename>, "
+          "see cinderjit.write_hot_manifest()")
+      .withFlagParamName("filename");
+
   flag_processor.addOption(
       "cinderx-jit-list-fail-on-parse-error",
       "CINDERX_JIT_LIST_FAIL_ON_PARSE_ERROR",
@@ -675,6 +740,11 @@ FlagProcessor initFlagProcessor() {
       "CINDERX_JIT_LIR_INLINER",
       getMutableConfig().lir_opts.inliner,
       "Enable the LIR inliner");
+  flag_processor.addOption(
+      "cinderx-jit-lir-redundant-load-elim",
+      "CINDERX_JIT_LIR_REDUNDANT_LOAD_ELIM",
+      getMutableConfig().lir_opts.redundant_load_elim,
+      "Enable the LIR redundant load elimination pass");
 
   flag_processor
       .addOption(
@@ -764,6 +834,51 @@ FlagProcessor initFlagProcessor() {
       "Add RefineType instructions to coerce Static Python types to be "
       "valid");
 
+  flag_processor.addOption(
+      "cinderx-jit-devirtualize-static-methods",
+      "CINDERX_JIT_DEVIRTUALIZE_STATIC_METHODS",
+      getMutableConfig().devirtualize_static_methods,
+      "Directly call Static Python methods that have no overrides in their "
+      "class hierarchy");
+
+  flag_processor.addOption(
+      "cinderx-jit-frameless-leaf-functions",
+      "CINDERX_JIT_FRAMELESS_LEAF_FUNCTIONS",
+      getMutableConfig().frameless_leaf_functions,
+      "Skip linking an interpreter frame in leaf functions unless they deopt "
+      "or raise");
+  flag_processor
+      .addOption(
+          "cinderx-jit-gen-pool-classes",
+          "CINDERX_JIT_GEN_POOL_CLASSES",
+          [](const std::string& value) { setGenPoolClasses(value); },
+          "Size classes of the pools JIT generators are allocated from, as "
+          "comma-separated SIZE:CAPACITY[:THREAD_CAPACITY] entries, see "
+          "cinderx.jit.suggest_generator_pool_classes()")
+      .withFlagParamName("classes");
+  flag_processor.addOption(
+      "cinderx-jit-execution-counters",
+      "CINDERX_JIT_EXECUTION_COUNTERS",
+      getMutableConfig().execution_counters,
+      "Count calls to compiled functions, see "
+      "cinderjit.get_and_clear_execution_counts()");
+  flag_processor.addOption(
+      "cinderx-jit-loop-counters",
+      "CINDERX_JIT_LOOP_COUNTERS",
+      getMutableConfig().loop_counters,
+      "With cinderx-jit-execution-counters, also count loop iterations");
+  flag_processor
+      .addOption(
+          "cinderx-jit-compile-trace",
+          "CINDERX_JIT_COMPILE_TRACE",
+          [](const std::string& filename) {
+            getMutableConfig().compile_trace_file = filename;
+            compileTrace().start(kDefaultCompileTraceCapacity);
+          },
+          "Trace every stage of compilation on every thread, and write the "
+          "trace to <filename> in Chrome trace format at shutdown")
+      .withFlagParamName("filename");
+
 #ifndef WIN32
   flag_processor.addOption(
       "cinderx-jit-perfmap",
@@ -966,6 +1081,8 @@ hir::Preloader* preload(BorrowedRef<> unit) {
   if (hir::Preloader* existing = hir::preloaderManager().find(code)) {
     return existing;
   }
+  CompileTraceScope trace{
+      "Preload", compileTrace().isEnabled() ? unitFullname(unit) : ""};
 
   // Make a new preloader. Note that this will run Python code so a lot of
   // assumptions are broken after this.
@@ -1070,6 +1187,7 @@ void compile_worker_thread(
   JIT_DLOG("Started compile worker in thread {}", std::this_thread::get_id());
 
   PyThreadState* tstate = acquireCompileWorkerThreadState(interp);
+  compileTrace().setThreadName("Batch compile worker");
 
   // Publish the context and isolated preload manager via TLS so that
   // compileRunning()/preloaderManager() work on this worker.
@@ -1177,7 +1295,10 @@ bool multithread_compile_units_preloaded(
 
   auto retry_list = compilation->endCompile();
 
-  jitCtx()->finalizeMultiThreadedCompile();
+  {
+    CompileTraceScope trace{"Finalize batch compile"};
+    jitCtx()->finalizeMultiThreadedCompile();
+  }
 
   JIT_DLOG(
       "multithread_compile_units_preloaded retrying {} units serially",
@@ -1187,8 +1308,10 @@ bool multithread_compile_units_preloaded(
 }
 
 // Compile all functions registered via a JIT list that haven't been executed
-// yet.
-bool compile_all(size_t workers = 0) {
+// yet.  If `units` is given, compile just those, in order, instead.
+bool compile_all(
+    size_t workers = 0,
+    const std::vector<BorrowedRef<>>* units = nullptr) {
   FreeThreadedJITEntrypointGuard guard;
   JIT_CHECK(jitCtx(), "JIT not initialized");
 
@@ -1234,9 +1357,17 @@ bool compile_all(size_t workers = 0) {
   auto isolated = std::make_shared<hir::IsolatedPreloaders>();
 
   // First we have to preload everything we are going to compile.
-  while (jit_reg_units.size() > 0) {
-    auto preload_units = std::move(jit_reg_units);
-    jit_reg_units.clear();
+  while (units != nullptr || jit_reg_units.size() > 0) {
+    std::vector<BorrowedRef<>> preload_units;
+    if (units != nullptr) {
+      preload_units = *units;
+      for (BorrowedRef<> unit : preload_units) {
+        jit_reg_units.erase(unit);
+      }
+    } else {
+      preload_units.assign(jit_reg_units.begin(), jit_reg_units.end());
+      jit_reg_units.clear();
+    }
 
     // Take a strong reference to every unit in this batch before preloading (or
     // a GC) can run, so the cyclic GC can't clear or collect a queued unit out
@@ -1263,6 +1394,12 @@ bool compile_all(size_t workers = 0) {
       }
       compilation_units.push_back(Ref<>::create(unit));
     }
+
+    // Anything registered while preloading the given units is left for a
+    // later compile.
+    if (units != nullptr) {
+      break;
+    }
   }
   mod_state->unit_deleted_during_preload = nullptr;
 
@@ -1277,6 +1414,8 @@ bool compile_all(size_t workers = 0) {
       deleted_units.size());
 
   if (workers > 1) {
+    // Workers take units from the back of the list.
+    std::reverse(compilation_units.begin(), compilation_units.end());
     return multithread_compile_units_preloaded(
         std::move(compilation_units), workers, isolated);
   } else {
@@ -1326,6 +1465,13 @@ JitEligibility getCompilationEligibility(BorrowedRef<PyFunctionObject> func) {
     return JitEligibility::Ineligible;
   }
 
+  // Functions that were hot in an earlier run are wanted regardless of the
+  // JIT list.
+  if (auto manifest = jitCtx()->hot_manifest_.get();
+      manifest != nullptr && manifest->lookupFunc(func) != nullptr) {
+    return JitEligibility::JitListEligible;
+  }
+
   // Note: This is not the same as fetching the function's code object and
   // checking its module and qualname, as functions can be renamed after they
   // are created.  Code objects cannot.
@@ -1358,6 +1504,11 @@ JitEligibility getCompilationEligibility(
     return JitEligibility::Ineligible;
   }
 
+  if (auto manifest = jitCtx()->hot_manifest_.get(); manifest != nullptr &&
+      manifest->lookupCode(module_name, code) != nullptr) {
+    return JitEligibility::JitListEligible;
+  }
+
   if (auto jit_list = cinderx::getModuleState()->jit_list.get()) {
     if (jit_list->lookupCode(code) == 1 ||
         jit_list->lookupName(module_name, code->co_qualname) == 1) {
@@ -1503,6 +1654,50 @@ void uncompile(BorrowedRef<PyFunctionObject> func) {
   jitCtx()->forgetCode(func);
 }
 
+// Erase a function that's still alive from the JIT's metadata.  Unlike when
+// it's destroyed, callers compiled against it keep their direct call sites and
+// its function entry cache, which go through the interpreter until it's
+// compiled again and then call the new code.
+void forgetFunction(BorrowedRef<PyFunctionObject> func) {
+  CompilerContext<Compiler>* ctx = jitCtx();
+  ctx->forgetFunc(func);
+  if (ctx->hasFunctionEntryCache(func)) {
+    *ctx->findFunctionEntryCache(func) =
+        ctx->compiler().failedDeferredCompileTrampoline();
+  }
+}
+
+// Throw away a function's compiled code and compile it again, so the code
+// allocator gets to place it afresh.
+Result recompileFunction(BorrowedRef<PyFunctionObject> func) {
+  setVectorcall(func, getInterpretedVectorcall(func));
+  forgetFunction(func);
+  uncompile(func);
+  return compileFunction(func);
+}
+
+// Entry point of a function whose compiled code pinned an attribute that has
+// since been rebound.  The pin's load is now recorded as failed, so compiling
+// the function again leaves it to the runtime cache.
+PyObject* recompileVectorcall(
+    PyObject* func_obj,
+    PyObject* const* stack,
+    size_t nargsf,
+    PyObject* kwnames) {
+  BorrowedRef<PyFunctionObject> func{func_obj};
+  Result result;
+  try {
+    result = recompileFunction(func);
+  } catch (const std::exception& exn) {
+    JIT_DLOG("{}", exn.what());
+    result = Result::UNKNOWN_ERROR;
+  }
+  if (result == Result::PYTHON_EXCEPTION) {
+    return nullptr;
+  }
+  return func->vectorcall(func_obj, stack, nargsf, kwnames);
+}
+
 /*
  * De-optimize a function by setting it to run through the interpreter if it
  * had been previously JIT-compiled.
@@ -1887,6 +2082,230 @@ precompile_all(PyObject* /* self */, PyObject* args, PyObject* kwargs) {
   Py_RETURN_TRUE;
 }
 
+// Record every compiled function called at least min_calls times in a
+// hot-function manifest, hottest first, along with the types its compiled code
+// saw at deopt points.
+PyObject*
+write_hot_manifest(PyObject* /* self */, PyObject* args, PyObject* kwargs) {
+  const char* path = nullptr;
+  Py_ssize_t min_calls = 1;
+  const char* keywords[] = {"path", "min_calls", nullptr};
+  if (!PyArg_ParseTupleAndKeywords(
+          args,
+          kwargs,
+          "s|n:write_hot_manifest",
+          const_cast<char**>(keywords),
+          &path,
+          &min_calls)) {
+    return nullptr;
+  }
+  if (min_calls < 0) {
+    PyErr_SetString(PyExc_ValueError, "min_calls must be non-negative");
+    return nullptr;
+  }
+
+  FreeThreadedJITEntrypointGuard guard;
+  CompilerContext<Compiler>* ctx = jitCtx();
+  if (ctx == nullptr) {
+    return PyLong_FromLong(0);
+  }
+
+  std::vector<HotManifestEntry> entries;
+  for (auto& [func, compiled] : ctx->compiledFuncs()) {
+    BorrowedRef<PyCodeObject> code{func->func_code};
+    CodeRuntime* runtime = compiled->runtime();
+    uint64_t calls = codeCallCount(code) + runtime->executionCounters().calls;
+    if (calls < static_cast<uint64_t>(min_calls) ||
+        func->func_module == nullptr || !PyUnicode_Check(func->func_module)) {
+      continue;
+    }
+
+    HotManifestEntry& entry = entries.emplace_back();
+    entry.module = unicodeAsString(func->func_module);
+    entry.qualname = unicodeAsString(code->co_qualname);
+    entry.code_hash = hashBytecode(code);
+    entry.calls = calls;
+
+    UnorderedMap<std::string, uint64_t> type_counts;
+    for (size_t idx = 0; idx < runtime->numDeoptMetadatas(); ++idx) {
+      ctx->ifDeoptStat(runtime, idx, [&](const DeoptStat& stat) {
+        for (size_t i = 0;
+             i < stat.types.size && stat.types.types[i] != nullptr;
+             ++i) {
+          type_counts[typeFullname(stat.types.types[i])] +=
+              stat.types.counts[i];
+        }
+        if (stat.types.other > 0) {
+          type_counts["<other>"] += stat.types.other;
+        }
+      });
+    }
+    entry.types.assign(type_counts.begin(), type_counts.end());
+    std::sort(
+        entry.types.begin(),
+        entry.types.end(),
+        [](const auto& a, const auto& b) {
+          return std::tie(b.second, a.first) < std::tie(a.second, b.first);
+        });
+  }
+  std::sort(entries.begin(), entries.end(), [](const auto& a, const auto& b) {
+    return std::tie(b.calls, a.module, a.qualname) <
+        std::tie(a.calls, b.module, b.qualname);
+  });
+
+  std::ofstream out{path};
+  if (!out) {
+    return PyErr_SetFromErrnoWithFilename(PyExc_OSError, path);
+  }
+  out << "# CinderX hot-function manifest\n";
+  // Closures share their code object, and only need to be recorded once.
+  UnorderedSet<std::string> seen;
+  size_t written = 0;
+  for (const HotManifestEntry& entry : entries) {
+    std::string line = HotManifest::formatEntry(entry);
+    if (line.empty() ||
+        !seen.insert(fmt::format("{}:{}", entry.module, entry.qualname))
+             .second) {
+      continue;
+    }
+    out << line << '\n';
+    written++;
+  }
+  out.close();
+  if (!out) {
+    return PyErr_SetFromErrnoWithFilename(PyExc_OSError, path);
+  }
+  return PyLong_FromSize_t(written);
+}
+
+// Schedule every existing function in the hot-function manifest for
+// compilation.  Run when a manifest is loaded.
+int rescheduleHotManifest() {
+  if (Ci_InitFrameEvalFunc() < 0) {
+    return -1;
+  }
+
+  walkFunctionObjects([](BorrowedRef<PyFunctionObject> func) {
+    if (jitCtx()->hot_manifest_->lookupFunc(func) != nullptr) {
+      scheduleJitCompile(func);
+    }
+  });
+
+  return 0;
+}
+
+PyObject* load_hot_manifest(PyObject* /* self */, PyObject* arg) {
+  if (!PyUnicode_Check(arg)) {
+    PyErr_Format(
+        PyExc_TypeError,
+        "load_hot_manifest expected a file path string, received '%s' object",
+        Py_TYPE(arg)->tp_name);
+    return nullptr;
+  }
+
+  const char* path = PyUnicode_AsUTF8(arg);
+  if (path == nullptr) {
+    return nullptr;
+  }
+
+  FreeThreadedJITEntrypointGuard guard;
+  if (jitCtx() == nullptr) {
+    return PyLong_FromLong(0);
+  }
+
+  auto manifest = std::make_unique<HotManifest>();
+  try {
+    manifest->parseFile(path);
+  } catch (const std::exception& exn) {
+    PyErr_SetString(PyExc_RuntimeError, exn.what());
+    return nullptr;
+  }
+
+  size_t size = manifest->size();
+  jitCtx()->hot_manifest_ = std::move(manifest);
+  if (rescheduleHotManifest() < 0) {
+    return nullptr;
+  }
+
+  return PyLong_FromSize_t(size);
+}
+
+// Compile the functions created so far that are in the hot-function manifest,
+// hottest first.  Meant to be called as the program starts up, possibly more
+// than once as modules are imported.  In background-compile mode they're
+// queued for the background worker instead, so that importing can carry on
+// while they compile.
+PyObject*
+precompile_hot(PyObject* /* self */, PyObject* args, PyObject* kwargs) {
+  Py_ssize_t workers = 0;
+  const char* keywords[] = {"workers", nullptr};
+  if (!PyArg_ParseTupleAndKeywords(
+          args,
+          kwargs,
+          "|n:precompile_hot",
+          const_cast<char**>(keywords),
+          &workers)) {
+    return nullptr;
+  }
+  if (workers < 0 || workers > 1000) {
+    PyErr_Format(
+        PyExc_ValueError,
+        "Cannot call precompile_hot with %ld workers",
+        workers);
+    return nullptr;
+  }
+
+  FreeThreadedJITEntrypointGuard guard;
+  if (!isJitUsable() || jitCtx()->hot_manifest_ == nullptr) {
+    return PyLong_FromLong(0);
+  }
+
+  HotManifest* manifest = jitCtx()->hot_manifest_.get();
+  std::vector<std::pair<uint64_t, Ref<PyFunctionObject>>> ranked;
+  for (BorrowedRef<> unit :
+       cinderx::getModuleState()->registered_compilation_units) {
+    if (!PyFunction_Check(unit)) {
+      continue;
+    }
+    BorrowedRef<PyFunctionObject> func{unit};
+    if (isJitCompiled(func)) {
+      continue;
+    }
+    if (const HotManifestEntry* entry = manifest->lookupFunc(func)) {
+      ranked.emplace_back(entry->calls, Ref<PyFunctionObject>::create(func));
+    }
+  }
+  std::stable_sort(
+      ranked.begin(), ranked.end(), [](const auto& a, const auto& b) {
+        return a.first > b.first;
+      });
+
+  if (getConfig().background_compile) {
+    try {
+      for (auto& [calls, func] : ranked) {
+        scheduleBackgroundCompile(func);
+      }
+    } catch (CAPIError&) {
+      return nullptr;
+    }
+    return PyLong_FromSize_t(ranked.size());
+  }
+
+  std::vector<BorrowedRef<>> units;
+  for (auto& [calls, func] : ranked) {
+    units.emplace_back(func);
+  }
+  if (!compile_all(workers, &units)) {
+    return nullptr;
+  }
+
+  size_t compiled = 0;
+  for (auto& [calls, func] : ranked) {
+    compiled += isJitCompiled(func);
+  }
+  return PyLong_FromSize_t(compiled);
+}
+
 PyObject* force_compile(PyObject* /* self */, PyObject* arg) {
   BorrowedRef<PyFunctionObject> func = get_func_arg("force_compile", arg);
   if (func == nullptr) {
@@ -1991,11 +2410,8 @@ PyObject* force_uncompile(PyObject* /* self */, PyObject* arg) {
   // can properly be called again.
   setVectorcall(func, getInterpretedVectorcall(func));
 
-  // "Destroy" the function from the perspective of the JIT, effectively erasing
-  // all traces of it from the metadata.
-  funcDestroyed(func);
-
   if (jitCtx() != nullptr) {
+    forgetFunction(func);
     uncompile(func);
   }
 
@@ -2581,13 +2997,13 @@ Ref<> make_deopt_stats() {
     const BorrowedRef<CompiledFunction> compiled_func = pair.second;
     const CodeRuntime* code_runtime = compiled_func->runtime();
 
-    auto const& deopt_metadatas = code_runtime->deoptMetadatas();
-    for (size_t deopt_idx = 0; deopt_idx < deopt_metadatas.size();
+    for (size_t deopt_idx = 0; deopt_idx < code_runtime->numDeoptMetadatas();
          ++deopt_idx) {
-      const DeoptMetadata& meta = deopt_metadatas[deopt_idx];
-
+      // Only look up the metadata for deopts that happened, as it may have to
+      // be decoded.
       ctx->ifDeoptStat(code_runtime, deopt_idx, [&](const auto& stat) {
-        collect_deopt_stat(stat, meta, stats);
+        collect_deopt_stat(
+            stat, code_runtime->getDeoptMetadata(deopt_idx), stats);
       });
     }
   }
@@ -2618,6 +3034,149 @@ PyObject* clear_runtime_stats(PyObject* /* self */, PyObject*) {
   Py_RETURN_NONE;
 }
 
+PyObject* enable_execution_counters(
+    PyObject* /* self */,
+    PyObject* args,
+    PyObject* kwargs) {
+  int loops = 0;
+  const char* keywords[] = {"loops", nullptr};
+  if (!PyArg_ParseTupleAndKeywords(
+          args,
+          kwargs,
+          "|p:enable_execution_counters",
+          const_cast<char**>(keywords),
+          &loops)) {
+    return nullptr;
+  }
+  getMutableConfig().execution_counters = true;
+  getMutableConfig().loop_counters = loops;
+  Py_RETURN_NONE;
+}
+
+PyObject* disable_execution_counters(PyObject* /* self */, PyObject*) {
+  getMutableConfig().execution_counters = false;
+  getMutableConfig().loop_counters = false;
+  Py_RETURN_NONE;
+}
+
+// Snapshot the execution counters of all compiled code, keyed by code object,
+// and reset them.  Code objects compiled more than once (for different globals
+// or builtins) have their counts summed.  Code that never ran is left out.
+PyObject* get_and_clear_execution_counts(PyObject* /* self */, PyObject*) {
+  auto result = Ref<>::steal(PyDict_New());
+  if (result == nullptr || jitCtx() == nullptr) {
+    return result.release();
+  }
+
+  UnorderedMap<PyCodeObject*, ExecutionCounters> totals;
+  for (auto& [key, compiled] : jitCtx()->compiledCodes()) {
+    CodeRuntime* code_rt = compiled->runtime();
+    ExecutionCounters& counters = code_rt->executionCounters();
+    if (counters.calls == 0 && counters.loop_iterations == 0) {
+      continue;
+    }
+    ExecutionCounters& total = totals[code_rt->code()];
+    total.calls += counters.calls;
+    total.loop_iterations += counters.loop_iterations;
+    counters = ExecutionCounters{};
+  }
+
+  for (auto& [code, total] : totals) {
+    auto counts = Ref<>::steal(PyDict_New());
+    if (counts == nullptr) {
+      return nullptr;
+    }
+    auto set_count = [&](const char* name, uint64_t value) {
+      auto py_value = Ref<>::steal(PyLong_FromUnsignedLongLong(value));
+      return py_value != nullptr &&
+          PyDict_SetItemString(counts, name, py_value) == 0;
+    };
+    if (!set_count("calls", total.calls) ||
+        !set_count("loop_iterations", total.loop_iterations) ||
+        PyDict_SetItem(result, reinterpret_cast<PyObject*>(code), counts) <
+            0) {
+      return nullptr;
+    }
+  }
+  return result.release();
+}
+
+PyObject* start_sampling_profiler(
+    PyObject* /* self */,
+    PyObject* args,
+    PyObject* kwargs) {
+  int hz = 100;
+  const char* keywords[] = {"hz", nullptr};
+  if (!PyArg_ParseTupleAndKeywords(
+          args,
+          kwargs,
+          "|i:start_sampling_profiler",
+          const_cast<char**>(keywords),
+          &hz)) {
+    return nullptr;
+  }
+  if (hz <= 0 || hz > 10000) {
+    PyErr_SetString(PyExc_ValueError, "hz must be between 1 and 10000");
+    return nullptr;
+  }
+  if (jitCtx() == nullptr) {
+    PyErr_SetString(PyExc_RuntimeError, "The JIT is not initialized");
+    return nullptr;
+  }
+  return PyBool_FromLong(jitCtx()->samplingProfiler().start(hz));
+}
+
+PyObject* stop_sampling_profiler(PyObject* /* self */, PyObject*) {
+  if (jitCtx() != nullptr) {
+    jitCtx()->samplingProfiler().stop();
+  }
+  Py_RETURN_NONE;
+}
+
+PyObject* get_and_clear_sampling_profile(PyObject* /* self */, PyObject*) {
+  if (jitCtx() == nullptr) {
+    return PyUnicode_FromString("");
+  }
+  SamplingProfiler& profiler = jitCtx()->samplingProfiler();
+  std::string folded = profiler.foldedStacks();
+  profiler.clear();
+  return PyUnicode_FromStringAndSize(folded.data(), folded.size());
+}
+
+PyObject* start_compile_trace(
+    PyObject* /* self */,
+    PyObject* args,
+    PyObject* kwargs) {
+  Py_ssize_t capacity = kDefaultCompileTraceCapacity;
+  const char* keywords[] = {"capacity", nullptr};
+  if (!PyArg_ParseTupleAndKeywords(
+          args,
+          kwargs,
+          "|n:start_compile_trace",
+          const_cast<char**>(keywords),
+          &capacity)) {
+    return nullptr;
+  }
+  if (capacity <= 0) {
+    PyErr_Format(
+        PyExc_ValueError, "Capacity must be positive, got %zd", capacity);
+    return nullptr;
+  }
+  compileTrace().start(capacity);
+  Py_RETURN_NONE;
+}
+
+PyObject* stop_compile_trace(PyObject* /* self */, PyObject*) {
+  compileTrace().stop();
+  Py_RETURN_NONE;
+}
+
+PyObject* get_and_clear_compile_trace(PyObject* /* self */, PyObject*) {
+  std::string json = compileTrace().toJson();
+  compileTrace().clear();
+  return PyUnicode_FromStringAndSize(json.data(), json.size());
+}
+
 PyObject* get_compiled_size(PyObject* /* self */, PyObject* func) {
   if (jitCtx() == nullptr) {
     return PyLong_FromLong(0);
@@ -2645,24 +3204,115 @@ PyObject* get_compiled_spill_stack_size(PyObject* /* self */, PyObject* func) {
   return PyLong_FromLong(size);
 }
 
-PyObject* get_and_clear_inline_cache_stats(PyObject* /* self */, PyObject*) {
+PyObject* get_compiled_spill_counts(PyObject* /* self */, PyObject* func) {
+  if (jitCtx() == nullptr) {
+    Py_RETURN_NONE;
+  }
+  CompiledFunction* compiled_func = jitCtx()->lookupFunc(func);
+  if (compiled_func == nullptr) {
+    Py_RETURN_NONE;
+  }
+  lir::SpillCounts counts = compiled_func->spillCounts();
+
   auto stats = Ref<>::steal(PyDict_New());
   if (stats == nullptr) {
     return nullptr;
   }
+  auto set_stat = [&](const char* name, size_t value) {
+    auto py_value = Ref<>::steal(PyLong_FromSize_t(value));
+    return py_value != nullptr &&
+        PyDict_SetItemString(stats, name, py_value) == 0;
+  };
+  if (!set_stat("spills", counts.spills) ||
+      !set_stat("reloads", counts.reloads) ||
+      !set_stat("rematerializations", counts.rematerializations)) {
+    return nullptr;
+  }
+  return stats.release();
+}
 
-  auto make_inline_cache_stats = [](PyObject* stats, CacheStats& cache_stats) {
-    auto result = Ref<>::steal(check(PyDict_New()));
-    auto filename = Ref<>::steal(
-        check(PyUnicode_InternFromString(cache_stats.filename.c_str())));
-    check(PyDict_SetItemString(result, "filename", filename));
-    auto method = Ref<>::steal(
-        check(PyUnicode_InternFromString(cache_stats.method_name.c_str())));
-    check(PyDict_SetItemString(result, "method", method));
-    auto cache_misses_dict = Ref<>::steal(check(PyDict_New()));
-    check(PyDict_SetItemString(result, "cache_misses", cache_misses_dict));
-    for (auto& [key, miss] : cache_stats.misses) {
-      auto py_key = Ref<>::steal(check(PyUnicode_FromString(key.c_str())));
+PyObject* get_compiled_direct_calls(PyObject* /* self */, PyObject* func) {
+  if (jitCtx() == nullptr) {
+    Py_RETURN_NONE;
+  }
+  CompiledFunction* compiled_func = jitCtx()->lookupFunc(func);
+  if (compiled_func == nullptr) {
+    Py_RETURN_NONE;
+  }
+  DirectCallCounts counts = compiled_func->directCallCounts();
+
+  auto stats = Ref<>::steal(PyDict_New());
+  if (stats == nullptr) {
+    return nullptr;
+  }
+  auto set_stat = [&](const char* name, size_t value) {
+    auto py_value = Ref<>::steal(PyLong_FromSize_t(value));
+    return py_value != nullptr &&
+        PyDict_SetItemString(stats, name, py_value) == 0;
+  };
+  if (!set_stat("sites", counts.sites) ||
+      !set_stat("patched", counts.patched)) {
+    return nullptr;
+  }
+  return stats.release();
+}
+
+PyObject* is_compiled_frameless(PyObject* /* self */, PyObject* func) {
+  if (jitCtx() == nullptr) {
+    Py_RETURN_FALSE;
+  }
+  CompiledFunction* compiled_func = jitCtx()->lookupFunc(func);
+  CodeRuntime* code_rt =
+      compiled_func != nullptr ? compiled_func->runtime() : nullptr;
+  return PyBool_FromLong(code_rt != nullptr && code_rt->isFrameless());
+}
+
+PyObject* get_compiled_memory_stats(PyObject* /* self */, PyObject* func) {
+  if (jitCtx() == nullptr) {
+    Py_RETURN_NONE;
+  }
+  CompiledFunction* compiled_func = jitCtx()->lookupFunc(func);
+  if (compiled_func == nullptr) {
+    Py_RETURN_NONE;
+  }
+  CompiledFunctionMemoryStats mem = compiled_func->memoryStats();
+
+  auto stats = Ref<>::steal(PyDict_New());
+  if (stats == nullptr) {
+    return nullptr;
+  }
+  auto set_stat = [&](const char* name, size_t value) {
+    auto py_value = Ref<>::steal(PyLong_FromSize_t(value));
+    return py_value != nullptr &&
+        PyDict_SetItemString(stats, name, py_value) == 0;
+  };
+  if (!set_stat("code", mem.code) ||
+      !set_stat("deopt_metadata", mem.deopt_metadata) ||
+      !set_stat("inline_caches", mem.inline_caches) ||
+      !set_stat("debug_info", mem.debug_info)) {
+    return nullptr;
+  }
+  return stats.release();
+}
+
+PyObject* get_and_clear_inline_cache_stats(PyObject* /* self */, PyObject*) {
+  auto stats = Ref<>::steal(PyDict_New());
+  if (stats == nullptr) {
+    return nullptr;
+  }
+
+  auto make_inline_cache_stats = [](PyObject* stats, CacheStats& cache_stats) {
+    auto result = Ref<>::steal(check(PyDict_New()));
+    auto filename = Ref<>::steal(
+        check(PyUnicode_InternFromString(cache_stats.filename.c_str())));
+    check(PyDict_SetItemString(result, "filename", filename));
+    auto method = Ref<>::steal(
+        check(PyUnicode_InternFromString(cache_stats.method_name.c_str())));
+    check(PyDict_SetItemString(result, "method", method));
+    auto cache_misses_dict = Ref<>::steal(check(PyDict_New()));
+    check(PyDict_SetItemString(result, "cache_misses", cache_misses_dict));
+    for (auto& [key, miss] : cache_stats.misses) {
+      auto py_key = Ref<>::steal(check(PyUnicode_FromString(key.c_str())));
       auto miss_dict = Ref<>::steal(check(PyDict_New()));
       auto count = Ref<>::steal(check(PyLong_FromLong(miss.count)));
       check(PyDict_SetItemString(miss_dict, "count", count));
@@ -2718,6 +3368,115 @@ PyObject* jit_unsuppress(PyObject* /* self */, PyObject* arg) {
   return arg;
 }
 
+PyObject* get_generator_pool_stats(PyObject*, PyObject*) {
+  auto& free_list = cinderx::getModuleState()->jit_gen_free_list;
+  if (free_list == nullptr) {
+    Py_RETURN_NONE;
+  }
+  GenPoolStats pool_stats = free_list->stats();
+
+  auto stats = Ref<>::steal(PyDict_New());
+  if (stats == nullptr) {
+    return nullptr;
+  }
+  auto set_stat = [&](const char* name, size_t value) {
+    auto py_value = Ref<>::steal(PyLong_FromSize_t(value));
+    return py_value != nullptr &&
+        PyDict_SetItemString(stats, name, py_value) == 0;
+  };
+  if (!set_stat("hits", pool_stats.hits) ||
+      !set_stat("misses", pool_stats.misses) ||
+      !set_stat("remote_frees", pool_stats.remote_frees) ||
+      !set_stat("bytes_held", pool_stats.bytes_held)) {
+    return nullptr;
+  }
+
+  auto classes = Ref<>::steal(PyList_New(0));
+  if (classes == nullptr ||
+      PyDict_SetItemString(stats, "classes", classes) < 0) {
+    return nullptr;
+  }
+  for (const GenPoolClassStats& cls_stats : pool_stats.classes) {
+    auto cls = Ref<>::steal(PyDict_New());
+    if (cls == nullptr || PyList_Append(classes, cls) < 0) {
+      return nullptr;
+    }
+    auto set_class_stat = [&](const char* name, size_t value) {
+      auto py_value = Ref<>::steal(PyLong_FromSize_t(value));
+      return py_value != nullptr &&
+          PyDict_SetItemString(cls, name, py_value) == 0;
+    };
+    if (!set_class_stat("size", cls_stats.size) ||
+        !set_class_stat("capacity", cls_stats.capacity) ||
+        !set_class_stat("hits", cls_stats.hits) ||
+        !set_class_stat("misses", cls_stats.misses) ||
+        !set_class_stat("in_use", cls_stats.in_use) ||
+        !set_class_stat("free", cls_stats.free)) {
+      return nullptr;
+    }
+  }
+  return stats.release();
+}
+
+// Convert a histogram of generator sizes to a dict mapping the upper bound of
+// each non-empty bucket to its count.
+Ref<> genSizeHistogramToDict(const GenSizeHistogram& histogram) {
+  auto result = Ref<>::steal(PyDict_New());
+  if (result == nullptr) {
+    return nullptr;
+  }
+  for (size_t i = 0; i < histogram.size(); ++i) {
+    if (histogram[i] == 0) {
+      continue;
+    }
+    auto bound =
+        Ref<>::steal(PyLong_FromSize_t((i + 1) * kGenSizeHistogramBucketSize));
+    auto count = Ref<>::steal(PyLong_FromSize_t(histogram[i]));
+    if (bound == nullptr || count == nullptr ||
+        PyDict_SetItem(result, bound, count) < 0) {
+      return nullptr;
+    }
+  }
+  return result;
+}
+
+PyObject* get_generator_size_histogram(PyObject*, PyObject*) {
+  auto& free_list = cinderx::getModuleState()->jit_gen_free_list;
+  if (free_list == nullptr || jitCtx() == nullptr) {
+    Py_RETURN_NONE;
+  }
+
+  // The size of each compiled generator function's generators follows from its
+  // spill words, sized as in JITRT_MakeGenObject().
+  GenSizeHistogram compiled{};
+  for (auto& [func, compiled_func] : jitCtx()->compiledFuncs()) {
+    BorrowedRef<PyCodeObject> code{func->func_code};
+    if (!(code->co_flags & kCoFlagsAnyGenerator)) {
+      continue;
+    }
+    uint64_t spill_words = compiled_func->runtime()->spillWords();
+    size_t size = free_list->entrySize(
+        code, spill_words * sizeof(uint64_t) + sizeof(GenDataFooter));
+    compiled[genSizeHistogramBucket(size)]++;
+  }
+
+  auto result = Ref<>::steal(PyDict_New());
+  if (result == nullptr) {
+    return nullptr;
+  }
+  Ref<> allocations = genSizeHistogramToDict(free_list->stats().size_histogram);
+  if (allocations == nullptr ||
+      PyDict_SetItemString(result, "allocations", allocations) < 0) {
+    return nullptr;
+  }
+  Ref<> compiled_dict = genSizeHistogramToDict(compiled);
+  if (compiled_dict == nullptr ||
+      PyDict_SetItemString(result, "compiled", compiled_dict) < 0) {
+    return nullptr;
+  }
+  return result.release();
+}
+
 PyObject* get_allocator_stats(PyObject*, PyObject*) {
   auto base_allocator = cinderx::getModuleState()->code_allocator.get();
   if (base_allocator == nullptr) {
@@ -2746,23 +3505,331 @@ PyObject* get_allocator_stats(PyObject*, PyObject*) {
     return stats.release();
   }
 
-  auto lost_bytes = Ref<>::steal(PyLong_FromSize_t(allocator->lostBytes()));
-  if (lost_bytes == nullptr ||
-      PyDict_SetItemString(stats, "lost_bytes", lost_bytes) < 0) {
+  CodeAllocatorCinder::Stats alloc_stats = allocator->stats();
+  // Share of free space outside of the largest free extent, as a percentage.
+  size_t fragmentation = alloc_stats.free_bytes == 0
+      ? 0
+      : 100 * (alloc_stats.free_bytes - alloc_stats.largest_free_extent) /
+          alloc_stats.free_bytes;
+  std::pair<const char*, size_t> items[] = {
+      {"fragmented_allocs", allocator->fragmentedAllocs()},
+      {"huge_allocs", allocator->hugeAllocs()},
+      {"chunks", alloc_stats.chunks},
+      {"reserved_bytes", alloc_stats.reserved_bytes},
+      {"free_bytes", alloc_stats.free_bytes},
+      {"free_extents", alloc_stats.free_extents},
+      {"largest_free_extent", alloc_stats.largest_free_extent},
+      {"fragmentation", fragmentation},
+      {"released_bytes", alloc_stats.released_bytes},
+  };
+  for (auto [name, value] : items) {
+    auto value_obj = Ref<>::steal(PyLong_FromSize_t(value));
+    if (value_obj == nullptr ||
+        PyDict_SetItemString(stats, name, value_obj) < 0) {
+      return nullptr;
+    }
+  }
+  return stats.release();
+}
+
+// Recompile the functions whose code sits in sparsely used chunks of the code
+// allocator.  Their new code is packed into the chunks still in use, and the
+// space they leave behind becomes one large free extent once the old code is
+// released.
+//
+// Machine code can't be moved byte for byte, as absolute addresses into it are
+// held all over the runtime, so recompiling is what moves it.  That also
+// rewrites the entry points, vectorcall slots, and deopt patchers pointing
+// into the old code.
+PyObject* compact_code(PyObject* /* self */, PyObject* args, PyObject* kwargs) {
+  double max_occupancy = 0.5;
+  const char* keywords[] = {"max_occupancy", nullptr};
+  if (!PyArg_ParseTupleAndKeywords(
+          args,
+          kwargs,
+          "|d:compact_code",
+          const_cast<char**>(keywords),
+          &max_occupancy)) {
     return nullptr;
   }
-  auto fragmented_allocs =
-      Ref<>::steal(PyLong_FromSize_t(allocator->fragmentedAllocs()));
-  if (fragmented_allocs == nullptr ||
-      PyDict_SetItemString(stats, "fragmented_allocs", fragmented_allocs) < 0) {
+  if (max_occupancy < 0.0 || max_occupancy > 1.0) {
+    PyErr_SetString(
+        PyExc_ValueError, "max_occupancy must be between 0.0 and 1.0");
     return nullptr;
   }
-  auto huge_allocs = Ref<>::steal(PyLong_FromSize_t(allocator->hugeAllocs()));
-  if (huge_allocs == nullptr ||
-      PyDict_SetItemString(stats, "huge_allocs", huge_allocs) < 0) {
+
+  FreeThreadedJITEntrypointGuard guard;
+  auto allocator = dynamic_cast<CodeAllocatorCinder*>(
+      cinderx::getModuleState()->code_allocator.get());
+  if (allocator == nullptr || jitCtx() == nullptr || !isJitUsable() ||
+      allocator->beginCompaction(max_occupancy) == 0) {
+    return PyLong_FromLong(0);
+  }
+
+  // Immortal compiled functions never release their code, moving them would
+  // only leak it.
+  std::vector<Ref<PyFunctionObject>> to_move;
+  for (auto& [func, compiled] : jitCtx()->compiledFuncs()) {
+    if (!compiled->isContiguous() &&
+        allocator->isEvacuating(compiled->codeBuffer().data())) {
+      to_move.emplace_back(Ref<PyFunctionObject>::create(func));
+    }
+  }
+
+  size_t moved = 0;
+  for (BorrowedRef<PyFunctionObject> func : to_move) {
+    Result result = recompileFunction(func);
+    if (result == Result::PYTHON_EXCEPTION) {
+      allocator->endCompaction();
+      return nullptr;
+    }
+    moved += result == Result::OK;
+  }
+  allocator->endCompaction();
+
+  return PyLong_FromSize_t(moved);
+}
+
+// Recompile the hottest compiled functions, hottest first, into fresh huge
+// pages so that their code is laid out back to back.  Without an explicit
+// ordering, functions are ranked by how many times they were called in the
+// interpreter before being compiled, which is the warm-up profile, plus how
+// many times their compiled code was called if execution counters are on.
+//
+// This is meant to run once, after warm-up and before forking worker
+// processes, which then share the relinked pages.  The code of immortal
+// compiled functions (always the case in prefork builds) is never released,
+// so relinking them leaves their old code behind as a one-time cost.
+PyObject*
+relink_hot_code(PyObject* /* self */, PyObject* args, PyObject* kwargs) {
+  PyObject* funcs = Py_None;
+  Py_ssize_t limit = -1;
+  const char* keywords[] = {"funcs", "limit", nullptr};
+  if (!PyArg_ParseTupleAndKeywords(
+          args,
+          kwargs,
+          "|On:relink_hot_code",
+          const_cast<char**>(keywords),
+          &funcs,
+          &limit)) {
     return nullptr;
   }
-  return stats.release();
+
+  FreeThreadedJITEntrypointGuard guard;
+  auto allocator = dynamic_cast<CodeAllocatorCinder*>(
+      cinderx::getModuleState()->code_allocator.get());
+  if (allocator == nullptr || jitCtx() == nullptr || !isJitUsable()) {
+    return PyLong_FromLong(0);
+  }
+
+  std::vector<Ref<PyFunctionObject>> order;
+  if (funcs == Py_None) {
+    std::vector<std::pair<size_t, Ref<PyFunctionObject>>> ranked;
+    for (auto& [func, compiled] : jitCtx()->compiledFuncs()) {
+      BorrowedRef<PyCodeObject> code{func->func_code};
+      size_t calls =
+          codeCallCount(code) + compiled->runtime()->executionCounters().calls;
+      ranked.emplace_back(calls, Ref<PyFunctionObject>::create(func));
+    }
+    std::stable_sort(
+        ranked.begin(), ranked.end(), [](const auto& a, const auto& b) {
+          return a.first > b.first;
+        });
+    for (auto& [calls, func] : ranked) {
+      order.emplace_back(std::move(func));
+    }
+  } else {
+    auto seq = Ref<>::steal(
+        PySequence_Fast(funcs, "funcs must be a sequence of functions"));
+    if (seq == nullptr) {
+      return nullptr;
+    }
+    UnorderedSet<PyObject*> seen;
+    for (Py_ssize_t i = 0; i < PySequence_Fast_GET_SIZE(seq.get()); ++i) {
+      PyObject* item = PySequence_Fast_GET_ITEM(seq.get(), i);
+      if (!PyFunction_Check(item)) {
+        PyErr_Format(
+            PyExc_TypeError,
+            "relink_hot_code expected a function, got %.200s",
+            Py_TYPE(item)->tp_name);
+        return nullptr;
+      }
+      // Functions that aren't compiled have no code to move.
+      BorrowedRef<PyFunctionObject> func{item};
+      if (jitCtx()->lookupFunc(func) != nullptr && seen.insert(item).second) {
+        order.emplace_back(Ref<PyFunctionObject>::create(func));
+      }
+    }
+  }
+  if (limit >= 0 && order.size() > static_cast<size_t>(limit)) {
+    order.resize(limit);
+  }
+
+  size_t relinked = 0;
+  allocator->beginRelink();
+  for (BorrowedRef<PyFunctionObject> func : order) {
+    Result result = recompileFunction(func);
+    if (result == Result::PYTHON_EXCEPTION) {
+      allocator->endRelink();
+      return nullptr;
+    }
+    relinked += result == Result::OK;
+  }
+  allocator->endRelink();
+
+  return PyLong_FromSize_t(relinked);
+}
+
+// Get the JIT ready for fork()ing worker processes that should share as much
+// of it as possible.  Every function called at least min_calls times is
+// compiled, or recompiled if it already was, hottest first into fresh huge
+// pages, the same as relink_hot_code().  While that happens the mutable state
+// the new code writes to (execution counters, and inline caches outside of
+// prefork builds) is placed in a compact region of its own.  Then the deopt
+// metadata and debug info of every compiled function, which are only read from
+// here on, are moved together into another region.
+//
+// With read_only, the code and metadata pages are also mapped read-only, so a
+// stray write can't unshare them.  With pause, the JIT is paused afterwards so
+// that workers don't compile anything else.
+//
+// Return a report of the bytes and pages in each region, and how many of the
+// pages children can expect to keep sharing with the parent, or None if the
+// JIT isn't in use.
+PyObject*
+prefork_freeze(PyObject* /* self */, PyObject* args, PyObject* kwargs) {
+  Py_ssize_t min_calls = 1;
+  int read_only = 0;
+  int pause = 1;
+  const char* keywords[] = {"min_calls", "read_only", "pause", nullptr};
+  if (!PyArg_ParseTupleAndKeywords(
+          args,
+          kwargs,
+          "|npp:prefork_freeze",
+          const_cast<char**>(keywords),
+          &min_calls,
+          &read_only,
+          &pause)) {
+    return nullptr;
+  }
+  if (min_calls < 0) {
+    PyErr_SetString(PyExc_ValueError, "min_calls must be non-negative");
+    return nullptr;
+  }
+
+  FreeThreadedJITEntrypointGuard guard;
+  ModuleState* mod_state = cinderx::getModuleState();
+  auto allocator =
+      dynamic_cast<CodeAllocatorCinder*>(mod_state->code_allocator.get());
+  if (allocator == nullptr || jitCtx() == nullptr || !isJitUsable()) {
+    Py_RETURN_NONE;
+  }
+  if (mod_state->prefork_metadata_arena == nullptr) {
+    mod_state->prefork_metadata_arena = std::make_shared<HugePageArena>();
+    mod_state->prefork_state_arena = std::make_shared<HugePageArena>();
+  }
+
+  struct Candidate {
+    size_t calls;
+    Ref<PyFunctionObject> func;
+    bool compiled;
+  };
+  std::vector<Candidate> ranked;
+  for (auto& [func, compiled] : jitCtx()->compiledFuncs()) {
+    BorrowedRef<PyCodeObject> code{func->func_code};
+    size_t calls =
+        codeCallCount(code) + compiled->runtime()->executionCounters().calls;
+    ranked.push_back({calls, Ref<PyFunctionObject>::create(func), true});
+  }
+  for (BorrowedRef<> unit : mod_state->registered_compilation_units) {
+    if (!PyFunction_Check(unit)) {
+      continue;
+    }
+    BorrowedRef<PyFunctionObject> func{unit};
+    size_t calls = codeCallCount(BorrowedRef<PyCodeObject>{func->func_code});
+    if (calls >= static_cast<size_t>(min_calls)) {
+      ranked.push_back({calls, Ref<PyFunctionObject>::create(func), false});
+    }
+  }
+  std::stable_sort(
+      ranked.begin(), ranked.end(), [](const auto& a, const auto& b) {
+        return a.calls > b.calls;
+      });
+
+  size_t compiled = 0;
+  size_t relinked = 0;
+  mod_state->prefork_freezing.store(true, std::memory_order_release);
+  allocator->beginRelink();
+  for (Candidate& candidate : ranked) {
+    Result result = candidate.compiled ? recompileFunction(candidate.func)
+                                       : compileFunction(candidate.func);
+    if (result == Result::PYTHON_EXCEPTION) {
+      allocator->endRelink();
+      mod_state->prefork_freezing.store(false, std::memory_order_release);
+      return nullptr;
+    }
+    if (result == Result::OK) {
+      (candidate.compiled ? relinked : compiled)++;
+    }
+  }
+  allocator->endRelink();
+  mod_state->prefork_freezing.store(false, std::memory_order_release);
+
+  // Other threads may be reading the metadata, e.g. to deopt.
+#ifdef Py_GIL_DISABLED
+  PyInterpreterState* interp = PyInterpreterState_Get();
+  _PyEval_StopTheWorld(interp);
+#endif
+  for (auto& [func, compiled_func] : jitCtx()->compiledFuncs()) {
+    compiled_func->runtime()->moveMetadataTo(mod_state->prefork_metadata_arena);
+  }
+#ifdef Py_GIL_DISABLED
+  _PyEval_StartTheWorld(interp);
+#endif
+
+  if (read_only) {
+    mod_state->prefork_metadata_arena->protect();
+    allocator->writeProtect();
+  }
+  if (pause) {
+    disable_jit_impl(false);
+  }
+
+  auto pages = [](size_t bytes) {
+    return roundUp(bytes, kPageSize) / kPageSize;
+  };
+  size_t code_bytes = allocator->usedBytes();
+  size_t code_pages = allocator->codePages();
+  size_t metadata_bytes = mod_state->prefork_metadata_arena->allocatedBytes();
+  size_t state_bytes = mod_state->prefork_state_arena->allocatedBytes();
+  std::pair<const char*, size_t> items[] = {
+      {"compiled", compiled},
+      {"relinked", relinked},
+      {"code_bytes", code_bytes},
+      {"code_pages", code_pages},
+      {"metadata_bytes", metadata_bytes},
+      {"metadata_pages", pages(metadata_bytes)},
+      {"state_bytes", state_bytes},
+      {"state_pages", pages(state_bytes)},
+      {"shared_pages", code_pages + pages(metadata_bytes)},
+      {"private_pages", pages(state_bytes)},
+  };
+  auto report = Ref<>::steal(PyDict_New());
+  if (report == nullptr) {
+    return nullptr;
+  }
+  for (auto [name, value] : items) {
+    auto value_obj = Ref<>::steal(PyLong_FromSize_t(value));
+    if (value_obj == nullptr ||
+        PyDict_SetItemString(report, name, value_obj) < 0) {
+      return nullptr;
+    }
+  }
+  if (PyDict_SetItemString(
+          report, "read_only", read_only ? Py_True : Py_False) < 0) {
+    return nullptr;
+  }
+  return report.release();
 }
 
 PyObject* is_hir_inliner_enabled(PyObject* /* self */, PyObject*) {
@@ -2772,6 +3839,15 @@ PyObject* is_hir_inliner_enabled(PyObject* /* self */, PyObject*) {
   Py_RETURN_FALSE;
 }
 
+PyObject* is_frameless_leaf_functions_enabled(PyObject* /* self */, PyObject*) {
+#if defined(ENABLE_LIGHTWEIGHT_FRAMES) && !defined(Py_GIL_DISABLED)
+  return PyBool_FromLong(getConfig().frameless_leaf_functions);
+#else
+  // Mirrors canRunFrameless(), these builds always link the frame.
+  Py_RETURN_FALSE;
+#endif
+}
+
 PyObject* is_inline_cache_stats_collection_enabled(
     PyObject* /* self */,
     PyObject* /* arg */) {
@@ -3169,6 +4245,30 @@ PyMethodDef jit_methods[] = {
      append_jit_list,
      METH_O,
      PyDoc_STR("Parse a JIT-list line and append it.")},
+    {"write_hot_manifest",
+     reinterpret_cast<PyCFunction>(write_hot_manifest),
+     METH_VARARGS | METH_KEYWORDS,
+     PyDoc_STR(
+         "Write a hot-function manifest to path, recording every compiled "
+         "function called at least min_calls times with its code hash, call "
+         "count, and the types seen at its deopt points, hottest first. "
+         "Return the number of functions written.")},
+    {"load_hot_manifest",
+     load_hot_manifest,
+     METH_O,
+     PyDoc_STR(
+         "Load a hot-function manifest written by write_hot_manifest(). "
+         "Functions in it whose code is unchanged are registered for "
+         "compilation as they're created. Return the number of entries.")},
+    {"precompile_hot",
+     reinterpret_cast<PyCFunction>(precompile_hot),
+     METH_VARARGS | METH_KEYWORDS,
+     PyDoc_STR(
+         "Compile the functions created so far that are in the loaded "
+         "hot-function manifest, hottest first, using workers threads "
+         "(batch_compile_workers if 0). With background compilation enabled "
+         "they are queued for the background worker instead. Return the "
+         "number of functions compiled or queued.")},
     {"read_jit_list",
      read_jit_list,
      METH_O,
@@ -3205,6 +4305,60 @@ PyMethodDef jit_methods[] = {
      PyDoc_STR(
          "Clears runtime stats about JIT-compiled code without returning "
          "a value.")},
+    {"enable_execution_counters",
+     reinterpret_cast<PyCFunction>(enable_execution_counters),
+     METH_VARARGS | METH_KEYWORDS,
+     PyDoc_STR(
+         "Have functions compiled from now on count how many times they're "
+         "called, and with loops=True how many loop iterations they run.")},
+    {"disable_execution_counters",
+     disable_execution_counters,
+     METH_NOARGS,
+     PyDoc_STR("Stop adding execution counters to newly compiled functions.")},
+    {"get_and_clear_execution_counts",
+     get_and_clear_execution_counts,
+     METH_NOARGS,
+     PyDoc_STR(
+         "Return a dict mapping code objects to the 'calls' and "
+         "'loop_iterations' counted by their compiled code, and reset the "
+         "counts.")},
+    {"start_sampling_profiler",
+     reinterpret_cast<PyCFunction>(start_sampling_profiler),
+     METH_VARARGS | METH_KEYWORDS,
+     PyDoc_STR(
+         "Start sampling the Python call stack of each thread `hz` times per "
+         "second of CPU time it uses, including frames for functions inlined "
+         "by the JIT. Returns False if the profiler was already running or "
+         "can't run on this platform.")},
+    {"stop_sampling_profiler",
+     stop_sampling_profiler,
+     METH_NOARGS,
+     PyDoc_STR(
+         "Stop the sampling profiler, keeping the samples taken so far.")},
+    {"get_and_clear_sampling_profile",
+     get_and_clear_sampling_profile,
+     METH_NOARGS,
+     PyDoc_STR(
+         "Return the samples taken by the sampling profiler as folded stacks, "
+         "one 'outer;...;inner count' line per distinct call stack, and clear "
+         "them.")},
+    {"start_compile_trace",
+     reinterpret_cast<PyCFunction>(start_compile_trace),
+     METH_VARARGS | METH_KEYWORDS,
+     PyDoc_STR(
+         "Start tracing every stage of compilation on every thread, keeping "
+         "the `capacity` most recent events.  Drops any earlier trace.")},
+    {"stop_compile_trace",
+     stop_compile_trace,
+     METH_NOARGS,
+     PyDoc_STR(
+         "Stop tracing compilation, keeping the events recorded so far.")},
+    {"get_and_clear_compile_trace",
+     get_and_clear_compile_trace,
+     METH_NOARGS,
+     PyDoc_STR(
+         "Return the compile trace as a string of Chrome trace format JSON, "
+         "which can be loaded into Perfetto, and clear it.")},
     {"get_and_clear_inline_cache_stats",
      get_and_clear_inline_cache_stats,
      METH_NOARGS,
@@ -3232,6 +4386,34 @@ PyMethodDef jit_methods[] = {
      PyDoc_STR(
          "Return stack size in bytes used for register spills for a "
          "JIT-compiled function.")},
+    {"get_compiled_spill_counts",
+     get_compiled_spill_counts,
+     METH_O,
+     PyDoc_STR(
+         "Return a dictionary with the number of spills, reloads, and "
+         "rematerializations the register allocator inserted into a "
+         "JIT-compiled function, or None if it isn't compiled.")},
+    {"get_compiled_direct_calls",
+     get_compiled_direct_calls,
+     METH_O,
+     PyDoc_STR(
+         "Return a dictionary with the number of call sites in a JIT-compiled "
+         "function that call a known function directly, and how many of them "
+         "currently call their callee's compiled code, or None if it isn't "
+         "compiled.")},
+    {"get_compiled_memory_stats",
+     get_compiled_memory_stats,
+     METH_O,
+     PyDoc_STR(
+         "Return a dictionary breaking down the memory in bytes used for a "
+         "JIT-compiled function into its code, deopt metadata, inline caches "
+         "and debug info, or None if the function isn't compiled.")},
+    {"is_compiled_frameless",
+     is_compiled_frameless,
+     METH_O,
+     PyDoc_STR(
+         "Return True if a JIT-compiled function runs without linking its "
+         "interpreter frame, and False otherwise.")},
     {"jit_suppress",
      jit_suppress,
      METH_O,
@@ -3254,11 +4436,63 @@ PyMethodDef jit_methods[] = {
      get_allocator_stats,
      METH_NOARGS,
      PyDoc_STR("Return stats from the code allocator as a dictionary.")},
+    {"get_generator_pool_stats",
+     get_generator_pool_stats,
+     METH_NOARGS,
+     PyDoc_STR(
+         "Return a dictionary with the number of JIT generator allocations "
+         "served from the generator pools ('hits') and from the general "
+         "allocator ('misses'), the number of pooled generators freed on "
+         "another thread ('remote_frees'), the bytes the pools hold that "
+         "aren't in use ('bytes_held'), and the same broken down by size "
+         "class along with each class's capacity and occupancy ('classes').  "
+         "None if the JIT isn't initialized.")},
+    {"get_generator_size_histogram",
+     get_generator_size_histogram,
+     METH_NOARGS,
+     PyDoc_STR(
+         "Return a dictionary with histograms of the sizes of the JIT "
+         "generators allocated so far ('allocations') and of the generators "
+         "of each compiled generator function ('compiled').  Each maps the "
+         "upper bound in bytes of a bucket to its count.  None if the JIT "
+         "isn't initialized.")},
+    {"compact_code",
+     reinterpret_cast<PyCFunction>(compact_code),
+     METH_VARARGS | METH_KEYWORDS,
+     PyDoc_STR(
+         "Recompile functions whose code is in code allocator chunks that are "
+         "at most max_occupancy full, packing their code into denser chunks. "
+         "Return the number of functions recompiled.")},
+    {"relink_hot_code",
+     reinterpret_cast<PyCFunction>(relink_hot_code),
+     METH_VARARGS | METH_KEYWORDS,
+     PyDoc_STR(
+         "Recompile compiled functions into fresh huge pages, hottest first, "
+         "so hot code is contiguous. funcs gives the order, otherwise "
+         "functions are ranked by call count. At most limit functions are "
+         "moved. Return the number of functions recompiled.")},
+    {"prefork_freeze",
+     reinterpret_cast<PyCFunction>(prefork_freeze),
+     METH_VARARGS | METH_KEYWORDS,
+     PyDoc_STR(
+         "Prepare the JIT for forking worker processes: compile every function "
+         "called at least min_calls times and relink all compiled code hottest "
+         "first, keeping the state compiled code writes to in a compact region "
+         "and its deopt metadata and debug info in another. read_only maps the "
+         "code and metadata read-only, pause pauses the JIT afterwards. Return "
+         "a dict with the bytes and pages in each region and the expected "
+         "shared and private pages, or None if the JIT isn't in use.")},
     {"is_hir_inliner_enabled",
      is_hir_inliner_enabled,
      METH_NOARGS,
      PyDoc_STR(
          "Return True if the HIR inliner is enabled and False otherwise.")},
+    {"is_frameless_leaf_functions_enabled",
+     is_frameless_leaf_functions_enabled,
+     METH_NOARGS,
+     PyDoc_STR(
+         "Return True if leaf functions can be compiled to run without "
+         "linking their interpreter frame, and False otherwise.")},
     {"enable_hir_inliner",
      enable_hir_inliner,
      METH_NOARGS,
@@ -3650,6 +4884,7 @@ void jitAtForkChild() {
   SlabArenaForkRegistry::get().atForkChild();
   codeAllocatorAtForkChild();
   jitCompilationAtForkChild();
+  compileTrace().atForkChild();
 
   auto* ctx = getContext();
   if (ctx == nullptr) {
@@ -3670,6 +4905,7 @@ void jitAtForkChild() {
   // effects.  Whatever it owned is leaked, but it is a private copy of the
   // parent's heap that this handler cannot safely release.
   new (&ctx->backgroundCompileRegistry()) BackgroundCompileRegistry();
+  ctx->samplingProfiler().atForkChild();
 }
 
 // Register the fork handlers exactly once for the process.  pthread_atfork
@@ -3689,6 +4925,22 @@ void ensureForkHandlersRegistered() {}
 
 #endif
 
+// Write the compile trace to the file named by cinderx-jit-compile-trace, if
+// there is one.  All compile workers must have finished.
+void writeCompileTraceFile() {
+  const std::string& filename = getConfig().compile_trace_file;
+  if (filename.empty()) {
+    return;
+  }
+  compileTrace().stop();
+  std::ofstream file{filename};
+  if (!file) {
+    JIT_LOG("Failed to open {} to write the compile trace", filename);
+    return;
+  }
+  file << compileTrace().toJson();
+}
+
 // Compile a single task.  Called only from the background worker thread w/o
 // the GIL held.
 void processBackgroundCompile(
@@ -3701,6 +4953,10 @@ void processBackgroundCompile(
 
   std::optional<CompiledFunctionData> compiled_func;
   hir::Preloader* preloader = hir::preloaderManager().find(code);
+  if (preloader != nullptr) {
+    compileTrace().record(
+        "Queue wait", preloader->fullname(), task->enqueued, Clock::now());
+  }
   if (preloader != nullptr && !isOverMaxCodeSize()) {
     {
       // Hand the task's reference to the function down into the compile so
@@ -3739,6 +4995,7 @@ void backgroundCompileWorkerLoop(
       "cinderx_compile");
 #endif
   PyThreadState* tstate = acquireCompileWorkerThreadState(interp);
+  compileTrace().setThreadName("Background compile worker");
 
   ThreadedCompileContext bgContext;
   BackgroundCompileRegistry& reg = jit_ctx->backgroundCompileRegistry();
@@ -3765,7 +5022,10 @@ void backgroundCompileWorkerLoop(
       processBackgroundCompile(jit_ctx, task);
     }
 
-    jitCtx()->finalizeMultiThreadedCompile();
+    {
+      CompileTraceScope trace{"Finalize background compile"};
+      jitCtx()->finalizeMultiThreadedCompile();
+    }
     finishBackgroundCompile(task->code);
   }
 
@@ -3965,6 +5225,17 @@ int initialize() {
     jit_list->parseFile(getConfig().jit_list.filename.c_str());
   }
 
+  std::unique_ptr<HotManifest> hot_manifest;
+  if (!getConfig().hot_manifest_file.empty()) {
+    hot_manifest = std::make_unique<HotManifest>();
+    try {
+      hot_manifest->parseFile(getConfig().hot_manifest_file.c_str());
+    } catch (const std::exception& exn) {
+      PyErr_SetString(PyExc_RuntimeError, exn.what());
+      return -1;
+    }
+  }
+
   jit::init_jit_genobject_type();
 
   // Initialize the CompiledFunction type.
@@ -4012,6 +5283,7 @@ int initialize() {
   getMutableConfig().state = State::kRunning;
 
   mod_state->jit_list = std::move(jit_list);
+  jitCtx()->hot_manifest_ = std::move(hot_manifest);
 
   // JIT is now fully initialized.  If it was configured to run automatically on
   // startup, start scheduling functions for compilation now.
@@ -4025,6 +5297,9 @@ int initialize() {
       return -1;
     }
   }
+  if (jitCtx()->hot_manifest_ != nullptr && rescheduleHotManifest() < 0) {
+    return -1;
+  }
 
   return 0;
 }
@@ -4090,6 +5365,11 @@ void finalize() {
   // depend on.
   cancelBackgroundCompiles();
 
+  // The sampling profiler reads compiled code's debug info.
+  jitCtx()->samplingProfiler().stop();
+
+  writeCompileTraceFile();
+
   FreeThreadedJITEntrypointGuard guard;
 
   // Deopt all JIT generators, since JIT generators reference code and other
@@ -4344,6 +5624,18 @@ std::vector<BorrowedRef<PyFunctionObject>> preloadFuncAndDeps(
       }
     }
 
+    // Likewise for methods that are called directly because nothing overrides
+    // them.
+    for (const auto& [descr, target] : preloader->invokeMethodTargets()) {
+      if (target->monomorphic_type == nullptr) {
+        continue;
+      }
+      BorrowedRef<PyFunctionObject> target_func = target->func();
+      if (shouldPreload(target_func)) {
+        worklist.push_back(target_func);
+      }
+    }
+
     // Preload any used functions in case the JIT might want to inline them.
     for (const auto& [idx, name] : preloader->globalNames()) {
       BorrowedRef<> obj = preloader->global(idx);
@@ -4369,6 +5661,11 @@ std::vector<BorrowedRef<PyFunctionObject>> preloadFuncAndDeps(
 
 void codeDestroyed(BorrowedRef<PyCodeObject> code) {
   FreeThreadedJITEntrypointGuard guard;
+  // Samples refer to code objects without owning them.
+  if (auto* ctx = jitCtx()) {
+    ctx->samplingProfiler().flush();
+    ctx->forgetFailedPins(code);
+  }
   if (isJitUsable()) {
     auto mod_state = cinderx::getModuleState();
     if (!mod_state) {
@@ -4412,6 +5709,18 @@ void funcModified(BorrowedRef<PyFunctionObject> func) {
   unregisterFunctionCodes(func);
 }
 
+void pinnedAttrRebound(BorrowedRef<PyFunctionObject> func) {
+  FreeThreadedJITEntrypointGuard guard;
+  CompilerContext<Compiler>* ctx = jitCtx();
+  if (ctx == nullptr || !ctx->didCompile(func)) {
+    return;
+  }
+  // The deopting code is still on the stack, so only detach it from the
+  // function here.  The recompile on the next call throws it away.
+  forgetFunction(func);
+  setVectorcall(func, recompileVectorcall);
+}
+
 void typeDestroyed(BorrowedRef<PyTypeObject> type) {
   if (CompilerContext<Compiler>* ctx = jitCtx()) {
     ctx->notifyTypeModified(type, nullptr);
@@ -4432,6 +5741,20 @@ void typeNameModified(BorrowedRef<PyTypeObject> type) {
   }
 }
 
+void staticMethodOverridden(
+    BorrowedRef<PyTypeObject> type,
+    BorrowedRef<> name) {
+  if (CompilerContext<Compiler>* ctx = jitCtx()) {
+    ctx->notifyMethodOverride(type, name);
+  }
+}
+
+void staticSubclassAdded(BorrowedRef<PyTypeObject> type) {
+  if (CompilerContext<Compiler>* ctx = jitCtx()) {
+    ctx->notifySubclassAdded(type);
+  }
+}
+
 std::pair<Result, Ref<PyFunctionObject>> compilePreloaderImpl(
     jit::CompilerContext<Compiler>* jit_ctx,
     const hir::Preloader& preloader,
@@ -4517,6 +5840,7 @@ std::pair<Result, Ref<PyFunctionObject>> compilePreloaderImpl(
     JIT_DLOG("{}", exn.what());
   }
 
+  CompileTraceScope install_trace{"Install code", preloader.fullname()};
   JITCompilationLock lock;
   jit_ctx->removeActiveCompile(key);
   if (!compiled_func.has_value()) {
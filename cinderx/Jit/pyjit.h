@@ -94,6 +94,21 @@ void typeDestroyed(BorrowedRef<PyTypeObject> type);
 void typeModified(BorrowedRef<PyTypeObject> type);
 void typeNameModified(BorrowedRef<PyTypeObject> type);
 
+/*
+ * Inform the JIT that func deopted because an attribute it pinned at compile
+ * time has been rebound.  Its next call compiles it again without the pin.
+ */
+void pinnedAttrRebound(BorrowedRef<PyFunctionObject> func);
+
+/*
+ * Inform the JIT that a Static Python method may have been overridden, either
+ * by assigning to name on type or by creating type as a new subclass.
+ */
+void staticMethodOverridden(
+    BorrowedRef<PyTypeObject> type,
+    BorrowedRef<> name);
+void staticSubclassAdded(BorrowedRef<PyTypeObject> type);
+
 // Exposed for unit tests
 //
 // Takes ownership of `func`, which the caller must have referenced while it
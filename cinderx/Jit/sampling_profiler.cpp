@@ -0,0 +1,671 @@
+// Copyright (c) Meta Platforms, Inc. and affiliates.
+
+#include "cinderx/Jit/sampling_profiler.h"
+
+#include "internal/pycore_pystate.h"
+#include "internal/pycore_runtime.h"
+
+#include "cinderx/Common/code.h"
+#include "cinderx/Common/log.h"
+#include "cinderx/Common/util.h"
+#include "cinderx/Jit/code_runtime.h"
+#include "cinderx/Jit/compiled_function.h"
+#include "cinderx/Jit/context.h"
+#include "cinderx/Jit/debug_info.h"
+
+#include <fmt/format.h>
+
+#ifdef __linux__
+#include <pthread.h>
+#include <signal.h>
+#include <time.h>
+#endif
+
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <iterator>
+#include <new>
+#include <system_error>
+#include <unordered_set>
+
+// Older glibc headers only expose the thread id of a SIGEV_THREAD_ID event
+// through the union member.
+#if defined(__linux__) && !defined(sigev_notify_thread_id)
+#define sigev_notify_thread_id _sigev_un._tid
+#endif
+
+namespace cinderx::jit {
+
+namespace {
+
+// How often the background thread looks for threads that have started or
+// exited.
+constexpr std::chrono::milliseconds kWatchInterval{100};
+
+// How many samples are left pending before the background thread takes the
+// GIL to resolve them.
+constexpr size_t kMaxPendingSamples = 1024;
+
+// Number of samples a thread's ring buffer can hold before they're copied out.
+constexpr size_t kRingSize = 32;
+
+// Most threads that can be sampled at once.
+constexpr size_t kMaxThreads = 1024;
+
+struct Sample {
+  size_t depth;
+  std::array<RawFrame, SamplingProfiler::kMaxDepth> frames;
+};
+
+// The compiled functions that run without linking their interpreter frame,
+// indexed by the address of their code, so that the native frames recorded
+// for them can be attributed.  Built on first use, as it looks at every
+// compiled function, and only valid while the GIL is held.
+class FramelessUnits {
+ public:
+  // Append the location being executed by the frameless unit in the first of
+  // `candidates` that belongs to one to `stack`.  Returns false if none does.
+  bool appendLocs(
+      const RawFrame* candidates,
+      size_t count,
+      std::vector<CodeObjLoc>& stack) {
+    for (size_t i = 0; i < count; i++) {
+      CompiledFunction* func = find(candidates[i].ip);
+      if (func == nullptr) {
+        continue;
+      }
+      CodeRuntime* code_rt = func->runtime();
+      std::optional<UnitCallStack> locs =
+          code_rt->debugInfo()->getUnitCallStack(candidates[i].ip);
+      if (locs.has_value()) {
+        stack.insert(stack.end(), locs->begin(), locs->end());
+      } else {
+        // Only calls and instructions that can deopt have debug info, so time
+        // spent anywhere else goes to the start of the function.
+        stack.emplace_back(code_rt->code(), BCIndex{0});
+      }
+      return true;
+    }
+    return false;
+  }
+
+ private:
+  struct Range {
+    uintptr_t begin;
+    uintptr_t end;
+    CompiledFunction* func;
+  };
+
+  CompiledFunction* find(uintptr_t ip) {
+    if (!built_) {
+      build();
+    }
+    auto it = std::upper_bound(
+        ranges_.begin(), ranges_.end(), ip, [](uintptr_t key, const Range& r) {
+          return key < r.begin;
+        });
+    if (it == ranges_.begin()) {
+      return nullptr;
+    }
+    --it;
+    return ip < it->end ? it->func : nullptr;
+  }
+
+  void build() {
+    built_ = true;
+    Context* ctx = getContext();
+    if (ctx == nullptr) {
+      return;
+    }
+    for (auto& [key, func] : ctx->compiledCodes()) {
+      CodeRuntime* code_rt = func->runtime();
+      if (code_rt == nullptr || !code_rt->isFrameless()) {
+        continue;
+      }
+      std::span<const std::byte> code = func->codeBuffer();
+      auto begin = reinterpret_cast<uintptr_t>(code.data());
+      ranges_.push_back({begin, begin + code.size(), func});
+    }
+    std::sort(ranges_.begin(), ranges_.end(), [](auto& a, auto& b) {
+      return a.begin < b.begin;
+    });
+  }
+
+  bool built_{false};
+  std::vector<Range> ranges_;
+};
+
+} // namespace
+
+// Per-thread state shared with the signal handler.
+//
+// Buffers are never freed, because a signal from a timer can still be pending
+// after the timer has been deleted.  Once a thread exits its buffer is reused
+// for another one.
+struct SampleBuffer {
+  // Position in `s_buffers`, which the thread's timer sends with the signal.
+  size_t index{0};
+  // Whether the buffer belongs to a thread.  Guarded by `s_buffers_mutex`.
+  bool in_use{false};
+
+  PyThreadState* tstate{nullptr};
+  unsigned long native_thread_id{0};
+#ifdef __linux__
+  pthread_t thread{};
+  StackBounds bounds{};
+  timer_t timer{};
+#endif
+
+  // Whether the handler may record samples into this buffer.
+  std::atomic<bool> armed{false};
+  // Number of handlers currently looking at the buffer, which must drop to
+  // zero before it's reused.
+  std::atomic<int> users{0};
+
+  // Single-producer, single-consumer ring: the handler advances `head` once a
+  // sample is written, the background thread advances `tail` once it has
+  // been copied out.
+  std::atomic<size_t> head{0};
+  std::atomic<size_t> tail{0};
+  std::atomic<size_t> dropped{0};
+  std::array<Sample, kRingSize> ring;
+};
+
+namespace {
+
+// Every buffer ever allocated, found by the handler through the index its
+// timer sends, so that a stray signal can't make it follow a bad pointer.
+std::array<std::atomic<SampleBuffer*>, kMaxThreads> s_buffers{};
+// Guards allocating buffers and handing them out.
+std::mutex s_buffers_mutex;
+
+SampleBuffer* acquireBuffer() {
+  std::lock_guard<std::mutex> lock{s_buffers_mutex};
+  for (size_t i = 0; i < kMaxThreads; i++) {
+    SampleBuffer* buf = s_buffers[i].load(std::memory_order_relaxed);
+    if (buf == nullptr) {
+      buf = new SampleBuffer();
+      buf->index = i;
+      s_buffers[i].store(buf, std::memory_order_release);
+    } else if (buf->in_use) {
+      continue;
+    }
+    buf->in_use = true;
+    return buf;
+  }
+  return nullptr;
+}
+
+void releaseBuffer(SampleBuffer* buf) {
+  std::lock_guard<std::mutex> lock{s_buffers_mutex};
+  buf->tstate = nullptr;
+  buf->head.store(0, std::memory_order_relaxed);
+  buf->tail.store(0, std::memory_order_relaxed);
+  buf->dropped.store(0, std::memory_order_relaxed);
+  buf->in_use = false;
+}
+
+#ifdef __linux__
+
+// Runs on the sampled thread, so everything it does must be async-signal-safe.
+void handleSignal(int, siginfo_t* info, void* ucontext) {
+  if (info == nullptr || info->si_code != SI_TIMER) {
+    return;
+  }
+  // Negative values wrap around and are rejected along with everything else
+  // out of range.
+  auto index = static_cast<size_t>(info->si_value.sival_int);
+  if (index >= kMaxThreads) {
+    return;
+  }
+  SampleBuffer* buf = s_buffers[index].load(std::memory_order_acquire);
+  if (buf == nullptr) {
+    return;
+  }
+
+  // Reading frame records that aren't on the stack is a syscall.
+  int saved_errno = errno;
+  buf->users.fetch_add(1);
+
+  // The timer can outlive the thread it was made for, and its last signal
+  // can arrive after the buffer has been handed to another thread, so check
+  // that the buffer is this thread's.  Only a thread that's attached to its
+  // thread state is running Python code.
+  if (buf->armed.load() && ::pthread_equal(buf->thread, ::pthread_self()) &&
+      _PyThreadState_GET() == buf->tstate) {
+    size_t head = buf->head.load(std::memory_order_relaxed);
+    if (head - buf->tail.load(std::memory_order_acquire) >= kRingSize) {
+      buf->dropped.fetch_add(1, std::memory_order_relaxed);
+    } else {
+      Sample& sample = buf->ring[head % kRingSize];
+      sample.depth = captureCallStack(
+          buf->tstate,
+          ucontext,
+          buf->bounds,
+          sample.frames.data(),
+          sample.frames.size());
+      if (sample.depth > 0) {
+        buf->head.store(head + 1, std::memory_order_release);
+      }
+    }
+  }
+
+  buf->users.fetch_sub(1, std::memory_order_release);
+  errno = saved_errno;
+}
+
+#endif
+
+// Find a real-time signal that nothing else is using and install the handler
+// on it, once per process.  Returns -1 if there is none.
+int claimSignal() {
+  static std::mutex claim_mutex;
+  static int claimed = -1;
+  std::lock_guard<std::mutex> lock{claim_mutex};
+  if (claimed >= 0) {
+    return claimed;
+  }
+
+  // Timers that signal a particular thread are Linux-only, so there's no point
+  // in claiming a signal anywhere else.
+#ifdef __linux__
+  sigset_t blocked;
+  sigemptyset(&blocked);
+  ::pthread_sigmask(SIG_BLOCK, nullptr, &blocked);
+
+  // Scanned from the top, as StackWalk does, since the bottom of the range is
+  // where signals that are hardcoded elsewhere land.  A signal taken here is
+  // never given back, so StackWalk and this never pick the same one.
+  for (int signum = SIGRTMAX; signum >= SIGRTMIN; signum--) {
+    if (sigismember(&blocked, signum) == 1) {
+      continue;
+    }
+    struct sigaction current = {};
+    if (::sigaction(signum, nullptr, &current) != 0 ||
+        (current.sa_flags & SA_SIGINFO) != 0 ||
+        current.sa_handler != SIG_DFL) {
+      continue;
+    }
+    struct sigaction action = {};
+    action.sa_sigaction = &handleSignal;
+    action.sa_flags = SA_SIGINFO | SA_RESTART;
+    sigemptyset(&action.sa_mask);
+    if (::sigaction(signum, &action, nullptr) == 0) {
+      claimed = signum;
+      return claimed;
+    }
+  }
+#endif
+
+  return -1;
+}
+
+} // namespace
+
+SamplingProfiler::~SamplingProfiler() {
+  JIT_CHECK(
+      !thread_.joinable(), "Sampling profiler destroyed while still running");
+}
+
+bool SamplingProfiler::start(int hz) {
+  JIT_CHECK(hz > 0, "Invalid sampling rate {}", hz);
+  std::lock_guard<std::mutex> lock{mutex_};
+  if (thread_.joinable()) {
+    return false;
+  }
+  signum_ = claimSignal();
+  if (signum_ < 0) {
+    JIT_LOG("No signal is free for the sampling profiler");
+    return false;
+  }
+  // Settle whether frame records off the stack can be read before any handler
+  // needs to know.
+  StackWalk::canReadFramesSafely();
+
+  hz_ = hz;
+  stop_requested_ = false;
+  active_.store(true, std::memory_order_release);
+
+  // Start with the threads that already exist, including this one, so that
+  // sampling doesn't wait for the background thread to look for them.
+  PyInterpreterState* interp = PyInterpreterState_Get();
+  {
+    std::lock_guard<std::mutex> samples_lock{samples_mutex_};
+    watchThreads(interp, nullptr);
+  }
+
+  // Copy the ring buffers out when they're half full, but not more often than
+  // every millisecond.
+  std::chrono::nanoseconds copy_interval = std::chrono::seconds{1};
+  copy_interval = copy_interval * (kRingSize / 2) / hz;
+  copy_interval = std::clamp<std::chrono::nanoseconds>(
+      copy_interval, std::chrono::milliseconds{1}, kWatchInterval);
+  try {
+    thread_ =
+        std::thread{&SamplingProfiler::run, this, interp, copy_interval};
+  } catch (const std::system_error& exn) {
+    JIT_LOG("Failed to start sampling profiler thread: {}", exn.what());
+    std::lock_guard<std::mutex> samples_lock{samples_mutex_};
+    for (SampleBuffer* buf : watched_) {
+      unwatch(buf);
+    }
+    watched_.clear();
+    resolve();
+    active_.store(false, std::memory_order_release);
+    return false;
+  }
+  return true;
+}
+
+void SamplingProfiler::stop() {
+  std::thread to_join;
+  {
+    std::lock_guard<std::mutex> lock{mutex_};
+    stop_requested_ = true;
+    stop_cv_.notify_all();
+    to_join = std::move(thread_);
+  }
+  if (!to_join.joinable()) {
+    return;
+  }
+  // The background thread needs the GIL to resolve the last samples and to
+  // delete its thread state.
+  Py_BEGIN_ALLOW_THREADS
+  to_join.join();
+  Py_END_ALLOW_THREADS
+}
+
+bool SamplingProfiler::isRunning() const {
+  std::lock_guard<std::mutex> lock{mutex_};
+  return thread_.joinable();
+}
+
+std::string SamplingProfiler::foldedStacks() {
+  flush();
+  std::lock_guard<std::mutex> lock{samples_mutex_};
+  std::string result;
+  for (auto& [stack, count] : stacks_) {
+    fmt::format_to(std::back_inserter(result), "{} {}\n", stack, count);
+  }
+  return result;
+}
+
+size_t SamplingProfiler::numSamples() const {
+  std::lock_guard<std::mutex> lock{samples_mutex_};
+  return num_samples_;
+}
+
+size_t SamplingProfiler::numDroppedSamples() const {
+  std::lock_guard<std::mutex> lock{samples_mutex_};
+  return num_dropped_;
+}
+
+void SamplingProfiler::clear() {
+  std::lock_guard<std::mutex> lock{samples_mutex_};
+  collect();
+  pending_frames_.clear();
+  pending_depths_.clear();
+  stacks_.clear();
+  num_samples_ = 0;
+  num_dropped_ = 0;
+}
+
+void SamplingProfiler::flush() {
+  if (!active_.load(std::memory_order_acquire)) {
+    return;
+  }
+  std::lock_guard<std::mutex> lock{samples_mutex_};
+  collect();
+  resolve();
+}
+
+void SamplingProfiler::atForkChild() {
+  // Neither the background thread nor any of the timers exist in the child,
+  // but the thread's handle still looks joinable and the mutexes and sample
+  // buffers may have been in use at the time of the fork.  Reuse the storage
+  // without running the destructors, as jitAtForkChild() does for the
+  // background compile registry.  The buffers of the threads that were being
+  // sampled are leaked.
+  for (SampleBuffer* buf : watched_) {
+    buf->armed.store(false, std::memory_order_relaxed);
+  }
+  new (&mutex_) std::mutex();
+  new (&stop_cv_) std::condition_variable();
+  new (&thread_) std::thread();
+  new (&samples_mutex_) std::mutex();
+  new (&s_buffers_mutex) std::mutex();
+  new (&watched_) std::vector<SampleBuffer*>();
+  new (&pending_frames_) std::vector<RawFrame>();
+  new (&pending_depths_) std::vector<size_t>();
+  stop_requested_ = false;
+  active_.store(false, std::memory_order_relaxed);
+}
+
+void SamplingProfiler::run(
+    PyInterpreterState* interp,
+    std::chrono::nanoseconds copy_interval) {
+  // The thread state is created on the background thread, as the background
+  // compile worker does, so that thread-local runtime state is bound to it.
+  // It's only attached while resolving samples.
+  PyThreadState* tstate = PyThreadState_New(interp);
+  if (tstate == nullptr) {
+    JIT_LOG("Failed to allocate sampling profiler thread state");
+  }
+
+  auto next = std::chrono::steady_clock::now();
+  auto next_watch = next + kWatchInterval;
+  while (true) {
+    next += copy_interval;
+    {
+      std::unique_lock<std::mutex> lock{mutex_};
+      if (stop_cv_.wait_until(lock, next, [this] { return stop_requested_; })) {
+        break;
+      }
+    }
+
+    bool resolve_now;
+    {
+      std::lock_guard<std::mutex> lock{samples_mutex_};
+      auto now = std::chrono::steady_clock::now();
+      if (now >= next_watch) {
+        watchThreads(interp, tstate);
+        next_watch = now + kWatchInterval;
+      }
+      collect();
+      resolve_now = pending_depths_.size() >= kMaxPendingSamples;
+    }
+    if (resolve_now && tstate != nullptr) {
+      PyEval_AcquireThread(tstate);
+      {
+        std::lock_guard<std::mutex> lock{samples_mutex_};
+        resolve();
+      }
+      PyEval_ReleaseThread(tstate);
+    }
+
+    // Don't try to catch up on copies that were missed; the ring buffers
+    // have already absorbed them.
+    auto now = std::chrono::steady_clock::now();
+    if (next < now) {
+      next = now;
+    }
+  }
+
+  {
+    std::lock_guard<std::mutex> lock{samples_mutex_};
+    for (SampleBuffer* buf : watched_) {
+      unwatch(buf);
+    }
+    watched_.clear();
+  }
+
+  if (tstate == nullptr) {
+    return;
+  }
+  PyEval_AcquireThread(tstate);
+  {
+    std::lock_guard<std::mutex> lock{samples_mutex_};
+    resolve();
+    active_.store(false, std::memory_order_release);
+  }
+  PyThreadState_Clear(tstate);
+  PyThreadState_DeleteCurrent();
+}
+
+void SamplingProfiler::watchThreads(
+    PyInterpreterState* interp,
+    PyThreadState* self) {
+  // Thread states are only unlinked, and their threads only exit, with the
+  // head lock held.
+  HEAD_LOCK(&_PyRuntime);
+
+  std::unordered_set<PyThreadState*> live;
+  for (PyThreadState* ts = PyInterpreterState_ThreadHead(interp); ts != nullptr;
+       ts = PyThreadState_Next(ts)) {
+    live.insert(ts);
+  }
+
+  // A thread state that has been freed and reallocated for another thread is
+  // told apart by its thread id.
+  std::unordered_set<PyThreadState*> watched;
+  auto end = std::remove_if(
+      watched_.begin(), watched_.end(), [&](SampleBuffer* buf) {
+        if (live.contains(buf->tstate) &&
+            buf->tstate->native_thread_id == buf->native_thread_id) {
+          watched.insert(buf->tstate);
+          return false;
+        }
+        unwatch(buf);
+        return true;
+      });
+  watched_.erase(end, watched_.end());
+
+  for (PyThreadState* ts : live) {
+    // Thread states that haven't been bound to a thread yet have no thread to
+    // sample.
+    if (ts == self || ts->thread_id == 0 || ts->native_thread_id == 0 ||
+        watched.contains(ts)) {
+      continue;
+    }
+    watchThread(ts);
+  }
+
+  HEAD_UNLOCK(&_PyRuntime);
+}
+
+bool SamplingProfiler::watchThread(PyThreadState* tstate) {
+#ifdef __linux__
+  SampleBuffer* buf = acquireBuffer();
+  if (buf == nullptr) {
+    return false;
+  }
+  buf->tstate = tstate;
+  buf->thread = StackWalk::nativeThreadId(tstate);
+  buf->native_thread_id = tstate->native_thread_id;
+  buf->bounds = StackWalk::stackBoundsOf(buf->thread);
+
+  clockid_t clock;
+  if (::pthread_getcpuclockid(buf->thread, &clock) != 0) {
+    releaseBuffer(buf);
+    return false;
+  }
+  struct sigevent event = {};
+  event.sigev_notify = SIGEV_THREAD_ID;
+  event.sigev_signo = signum_;
+  event.sigev_value.sival_int = static_cast<int>(buf->index);
+  event.sigev_notify_thread_id = static_cast<pid_t>(buf->native_thread_id);
+  if (::timer_create(clock, &event, &buf->timer) != 0) {
+    releaseBuffer(buf);
+    return false;
+  }
+
+  buf->armed.store(true);
+  auto interval = std::chrono::nanoseconds{std::chrono::seconds{1}} / hz_;
+  struct itimerspec spec = {};
+  spec.it_interval.tv_sec = interval.count() / 1000000000;
+  spec.it_interval.tv_nsec = interval.count() % 1000000000;
+  spec.it_value = spec.it_interval;
+  if (::timer_settime(buf->timer, 0, &spec, nullptr) != 0) {
+    buf->armed.store(false);
+    ::timer_delete(buf->timer);
+    releaseBuffer(buf);
+    return false;
+  }
+  watched_.push_back(buf);
+  return true;
+#else
+  return false;
+#endif
+}
+
+void SamplingProfiler::unwatch(SampleBuffer* buf) {
+#ifdef __linux__
+  ::timer_delete(buf->timer);
+#endif
+  buf->armed.store(false);
+  // A handler that saw the buffer armed may still be writing to it.
+  while (buf->users.load() != 0) {
+    std::this_thread::yield();
+  }
+  collect(*buf);
+  releaseBuffer(buf);
+}
+
+void SamplingProfiler::collect() {
+  for (SampleBuffer* buf : watched_) {
+    collect(*buf);
+  }
+}
+
+void SamplingProfiler::collect(SampleBuffer& buf) {
+  size_t tail = buf.tail.load(std::memory_order_relaxed);
+  size_t head = buf.head.load(std::memory_order_acquire);
+  for (; tail != head; tail++) {
+    const Sample& sample = buf.ring[tail % kRingSize];
+    pending_frames_.insert(
+        pending_frames_.end(),
+        sample.frames.begin(),
+        sample.frames.begin() + sample.depth);
+    pending_depths_.push_back(sample.depth);
+  }
+  buf.tail.store(tail, std::memory_order_release);
+  num_dropped_ += buf.dropped.exchange(0, std::memory_order_relaxed);
+}
+
+void SamplingProfiler::resolve() {
+  std::string folded;
+  FramelessUnits frameless;
+  const RawFrame* frames = pending_frames_.data();
+  for (size_t depth : pending_depths_) {
+    std::vector<CodeObjLoc> stack = resolveCallStack(frames, depth);
+    // A leaf function running without its frame is innermost.
+    size_t num_candidates = numFramelessCandidates(frames, depth);
+    if (num_candidates > 0) {
+      frameless.appendLocs(frames, num_candidates, stack);
+    }
+    frames += depth;
+    // Native frames can be recorded when no Python code is running.
+    if (stack.empty()) {
+      continue;
+    }
+    folded.clear();
+    for (const CodeObjLoc& loc : stack) {
+      if (!folded.empty()) {
+        folded += ';';
+      }
+      fmt::format_to(
+          std::back_inserter(folded),
+          "{} ({}:{})",
+          codeQualname(loc.code),
+          unicodeAsString(loc.code->co_filename),
+          loc.lineNo());
+    }
+    stacks_[folded]++;
+    num_samples_++;
+  }
+  pending_frames_.clear();
+  pending_depths_.clear();
+}
+
+} // namespace cinderx::jit
@@ -0,0 +1,160 @@
+// Copyright (c) Meta Platforms, Inc. and affiliates.
+
+#pragma once
+
+#include "cinderx/python.h"
+
+#include "cinderx/Jit/frame.h"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace cinderx::jit {
+
+// The ring buffer a sampled thread's signal handler records into.  Defined in
+// sampling_profiler.cpp, since it's only touched there.
+struct SampleBuffer;
+
+// An in-process sampling profiler that attributes time to Python functions and
+// lines, including code running in JIT-compiled functions and in functions
+// that were inlined into them.
+//
+// Every thread with a Python thread state gets a POSIX timer on its own CPU
+// clock, which delivers a signal to that thread each time it has run for the
+// sampling interval.  The signal handler runs on the sampled thread, wherever
+// it was interrupted, and records its Python call stack into a ring buffer
+// owned by that thread, without taking the GIL or any lock.  Frames of JIT
+// units are recorded with the address the unit is executing, found by walking
+// the native frame pointers from the interrupted context, and are mapped to
+// lines through the unit's debug info later on.  A leaf function compiled to
+// run without linking its interpreter frame is found from the innermost native
+// frames instead, by looking their addresses up among the code of such
+// functions.  Samples are therefore not
+// biased towards the points where compiled code checks the eval breaker, and
+// threads that aren't running cost nothing.
+//
+// A background thread copies the ring buffers out every few milliseconds, and
+// picks up threads that have started or exited since it last looked.  Neither
+// needs the GIL.  Samples refer to code objects without owning them, so they
+// are resolved to lines (which does need the GIL) before any code object is
+// freed, when enough of them have built up, and when the profile is read.
+// Memory use is then proportional to the number of distinct call stacks rather
+// than to the length of the profile.
+//
+// Only a thread that is attached to the interpreter when its signal arrives is
+// sampled, so time spent outside Python with the GIL released is not counted.
+// Call stacks deeper than kMaxDepth frames lose their outermost frames.
+class SamplingProfiler {
+ public:
+  SamplingProfiler() = default;
+  ~SamplingProfiler();
+
+  SamplingProfiler(const SamplingProfiler&) = delete;
+  SamplingProfiler& operator=(const SamplingProfiler&) = delete;
+
+  // Start sampling each thread `hz` times per second of CPU time it uses.
+  // Returns false if the profiler is already running or sampling isn't
+  // possible, e.g. because no signal is free.  Must be called with the GIL
+  // held.
+  bool start(int hz);
+
+  // Stop sampling and wait for the background thread to exit.  Samples that
+  // have already been taken are kept.  Must be called with the GIL held, which
+  // is released while waiting.
+  void stop();
+
+  bool isRunning() const;
+
+  // Render the samples taken so far in the "folded stacks" format understood
+  // by flamegraph.pl, speedscope, and friends: one line per distinct call
+  // stack, with frames separated by semicolons from the outermost inwards,
+  // followed by the number of samples with that stack.  Each frame is
+  // rendered as "qualname (filename:lineno)".
+  //
+  // Must be called with the GIL held.
+  std::string foldedStacks();
+
+  // Number of samples resolved so far, summed over all threads.
+  size_t numSamples() const;
+
+  // Number of samples lost because a thread's ring buffer was full.
+  size_t numDroppedSamples() const;
+
+  // Drop all the samples taken so far.  Must be called with the GIL held.
+  void clear();
+
+  // Resolve every sample taken so far.  Called before a code object is freed,
+  // since samples refer to code objects without owning them.  Cheap when the
+  // profiler isn't running.  Must be called with the GIL held.
+  void flush();
+
+  // Forget the background thread and the timers in the child of a fork, which
+  // only inherits the forking thread and none of the timers.
+  void atForkChild();
+
+  // Maximum number of frames recorded for a sample.
+  static constexpr size_t kMaxDepth = 64;
+
+ private:
+  // Body of the background thread.
+  void run(PyInterpreterState* interp, std::chrono::nanoseconds copy_interval);
+
+  // Start sampling threads of `interp` that aren't being sampled yet, and
+  // stop sampling those whose thread state is gone.  `self` is the background
+  // thread's thread state, if it has one, which is never sampled.
+  void watchThreads(PyInterpreterState* interp, PyThreadState* self);
+
+  // Start sampling the thread running `tstate`.  Returns false if that isn't
+  // possible.
+  bool watchThread(PyThreadState* tstate);
+
+  // Stop sampling `buf` and release it, after copying out the samples it
+  // holds.
+  void unwatch(SampleBuffer* buf);
+
+  // Copy the samples out of every ring buffer into the pending samples.
+  void collect();
+  void collect(SampleBuffer& buf);
+
+  // Resolve the pending samples into `stacks_`.  Needs the GIL.
+  void resolve();
+
+  // Guards the fields used to start and stop the background thread.
+  mutable std::mutex mutex_;
+  // Notified when a stop is requested; the background thread waits on it
+  // between copies.
+  std::condition_variable stop_cv_;
+  bool stop_requested_{false};
+  std::thread thread_;
+  int hz_{0};
+  int signum_{-1};
+  // Whether there may be samples to flush.  Lets flush() return without
+  // taking a lock when the profiler isn't in use.
+  std::atomic<bool> active_{false};
+
+  // Guards the fields below, which are shared between the background thread
+  // and whoever is reading the profile.  Never held while waiting for the
+  // GIL.
+  mutable std::mutex samples_mutex_;
+  // Buffers of the threads being sampled.
+  std::vector<SampleBuffer*> watched_;
+  // Frames of the samples copied out of the ring buffers but not yet
+  // resolved, one sample after another, and the number of frames in each.
+  std::vector<RawFrame> pending_frames_;
+  std::vector<size_t> pending_depths_;
+  // Number of samples taken for each distinct call stack, keyed by the
+  // rendered stack so that nothing has to keep the code objects alive.
+  // Ordered, so that rendered profiles are deterministic.
+  std::map<std::string, size_t> stacks_;
+  size_t num_samples_{0};
+  size_t num_dropped_{0};
+};
+
+} // namespace cinderx::jit
@@ -637,6 +637,10 @@ StackWalk::~StackWalk() {
   ::sem_destroy(&handler_exited_);
 }
 
+StackBounds StackWalk::stackBoundsOf(ThreadId thread) {
+  return threadStackBounds(thread);
+}
+
 StackBounds StackWalk::stackBoundsFor(ThreadId thread) {
   if (bounds_cache_valid_ && ::pthread_equal(bounds_cache_thread_, thread)) {
     return bounds_cache_;
@@ -843,7 +847,8 @@ StackWalk::Publish StackWalk::publishBatch(size_t count) {
   return stop_requested_ ? Publish::Finished : Publish::Taken;
 }
 
-void StackWalk::captureFrames(const void* ucontext) {
+StackWalk::InterruptedContext StackWalk::interruptedContext(
+    const void* ucontext) {
   auto uc = static_cast<const ucontext_t*>(ucontext);
 
 #if defined(__APPLE__) && defined(__aarch64__)
@@ -851,23 +856,28 @@ void StackWalk::captureFrames(const void* ucontext) {
   // its constructor always throws. The context extraction still has to build
   // as part of the JIT library.
   const auto& state = uc->uc_mcontext->__ss;
-  auto frame = reinterpret_cast<const StackFrame*>(
-      __darwin_arm_thread_state64_get_fp(state));
-  auto pc =
-      reinterpret_cast<const void*>(__darwin_arm_thread_state64_get_pc(state));
-  auto sp = static_cast<uintptr_t>(__darwin_arm_thread_state64_get_sp(state));
+  return {
+      reinterpret_cast<const StackFrame*>(
+          __darwin_arm_thread_state64_get_fp(state)),
+      reinterpret_cast<const void*>(__darwin_arm_thread_state64_get_pc(state)),
+      static_cast<uintptr_t>(__darwin_arm_thread_state64_get_sp(state))};
 #elif defined(__linux__) && defined(__x86_64__)
-  auto frame =
-      reinterpret_cast<const StackFrame*>(uc->uc_mcontext.gregs[REG_RBP]);
-  auto pc = reinterpret_cast<const void*>(uc->uc_mcontext.gregs[REG_RIP]);
-  auto sp = static_cast<uintptr_t>(uc->uc_mcontext.gregs[REG_RSP]);
+  return {
+      reinterpret_cast<const StackFrame*>(uc->uc_mcontext.gregs[REG_RBP]),
+      reinterpret_cast<const void*>(uc->uc_mcontext.gregs[REG_RIP]),
+      static_cast<uintptr_t>(uc->uc_mcontext.gregs[REG_RSP])};
 #elif defined(__linux__) && defined(__aarch64__)
-  auto frame = reinterpret_cast<const StackFrame*>(uc->uc_mcontext.regs[29]);
-  auto pc = reinterpret_cast<const void*>(uc->uc_mcontext.pc);
-  auto sp = static_cast<uintptr_t>(uc->uc_mcontext.sp);
+  return {
+      reinterpret_cast<const StackFrame*>(uc->uc_mcontext.regs[29]),
+      reinterpret_cast<const void*>(uc->uc_mcontext.pc),
+      static_cast<uintptr_t>(uc->uc_mcontext.sp)};
 #else
 #error "StackWalk supports x86-64 and AArch64 only"
 #endif
+}
+
+void StackWalk::captureFrames(const void* ucontext) {
+  auto [frame, pc, sp] = interruptedContext(ucontext);
 
   // Where this thread's stack really is, as opposed to where the frame-pointer
   // register claims the frames are. Vouching for the bounds with the stack
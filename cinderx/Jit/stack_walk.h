@@ -395,6 +395,25 @@ class StackWalk {
   // ask: a sampled thread is handed bounds its sampler measured for it.
   static StackBounds currentStackBounds();
 
+  // The stack of `thread`, or nothing if it cannot be determined. For handing
+  // to a signal handler that will walk `thread` from the inside, which cannot
+  // measure its own stack without allocating.
+  //
+  // `thread` must stay alive for the duration, as for walk().
+  static StackBounds stackBoundsOf(ThreadId thread);
+
+  // The registers a walk of an interrupted thread starts from, as found in the
+  // context handed to its signal handler.
+  struct InterruptedContext {
+    const StackFrame* frame;
+    const void* pc;
+    uintptr_t sp;
+  };
+
+  // Pulls the frame pointer, PC and stack pointer out of `ucontext`. Only
+  // reads memory, so it is usable from any signal handler.
+  static InterruptedContext interruptedContext(const void* ucontext);
+
   // Whether frame records can be read without risking a fault. False means a
   // sandbox has taken the mechanism away, and every walk will come back empty
   // rather than crash. Probes if nothing has yet, so it answers the same
@@ -5,8 +5,16 @@
 #include "cinderx/Common/type.h"
 #include "cinderx/Common/util.h"
 
+#include <atomic>
+
 namespace cinderx::jit {
 
+namespace {
+
+std::atomic<uint64_t> s_method_override_epoch{0};
+
+} // namespace
+
 template <typename Body>
 bool shouldPatchForAttr(
     BorrowedRef<PyTypeObject> old_ty,
@@ -108,4 +116,38 @@ void SplitDictDeoptPatcher::onPatch() {
   attr_name_ = nullptr;
 }
 
+MethodOverrideDeoptPatcher::MethodOverrideDeoptPatcher(
+    BorrowedRef<PyTypeObject> type,
+    BorrowedRef<PyUnicodeObject> name,
+    uint64_t epoch)
+    : type_{type}, name_{name}, epoch_{epoch} {}
+
+BorrowedRef<PyTypeObject> MethodOverrideDeoptPatcher::type() const {
+  return type_;
+}
+
+BorrowedRef<PyUnicodeObject> MethodOverrideDeoptPatcher::name() const {
+  return name_;
+}
+
+uint64_t MethodOverrideDeoptPatcher::epoch() const {
+  return epoch_;
+}
+
+uint64_t MethodOverrideDeoptPatcher::currentEpoch() {
+  return s_method_override_epoch.load(std::memory_order_acquire);
+}
+
+void MethodOverrideDeoptPatcher::bumpEpoch() {
+  s_method_override_epoch.fetch_add(1, std::memory_order_acq_rel);
+}
+
+void MethodOverrideDeoptPatcher::onUnpatch() {
+  JIT_ABORT(
+      "MethodOverrideDeoptPatcher for {}.{} being unpatched but that's not "
+      "supported!",
+      type_->tp_name,
+      PyUnicode_AsUTF8(name_));
+}
+
 } // namespace cinderx::jit
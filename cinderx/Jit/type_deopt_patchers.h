@@ -5,6 +5,8 @@
 #include "cinderx/Jit/code_patcher.h"
 #include "cinderx/Jit/threaded_compile.h"
 
+#include <cstdint>
+
 namespace cinderx::jit {
 
 // Patch a DeoptPatchpoint when the given PyTypeObject changes at all. This
@@ -68,4 +70,42 @@ class SplitDictDeoptPatcher : public TypeDeoptPatcher {
   PyDictKeysObject* keys_;
 };
 
+// Patch a DeoptPatchpoint when a Static Python method is overridden, either by
+// assigning to the attribute on its declaring type (or on a subclass of it) or
+// by defining a new subclass which overrides it.  Used to guard direct calls to
+// methods that had no overrides in the class hierarchy at compile time.
+//
+// Unlike TypeDeoptPatcher this is not tied to type watchers; notifications
+// come from the Static Python class loader, which already tracks every change
+// to the dict and subclasses of a type with a vtable.
+class MethodOverrideDeoptPatcher : public JumpPatcher {
+ public:
+  MethodOverrideDeoptPatcher(
+      BorrowedRef<PyTypeObject> type,
+      BorrowedRef<PyUnicodeObject> name,
+      uint64_t epoch);
+
+  // The declaring type and method name being watched.
+  BorrowedRef<PyTypeObject> type() const;
+  BorrowedRef<PyUnicodeObject> name() const;
+
+  // The value of currentEpoch() when the class hierarchy was checked for
+  // overrides.
+  uint64_t epoch() const;
+
+  // Counter that is bumped on every override notification.  A compilation
+  // that observes a different value at link time than when it checked the
+  // class hierarchy may have missed a notification, and must patch.
+  static uint64_t currentEpoch();
+  static void bumpEpoch();
+
+ private:
+  void onUnpatch() override;
+
+  // Strong references held by the CodeRuntime.
+  BorrowedRef<PyTypeObject> type_;
+  BorrowedRef<PyUnicodeObject> name_;
+  uint64_t epoch_;
+};
+
 } // namespace cinderx::jit
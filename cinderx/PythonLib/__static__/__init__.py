@@ -43,6 +43,7 @@ from .type_code import (  # noqa: F401
 )
 
 chkdict = dict[TypeVar("K"), TypeVar("V")]
+chkprimdict = dict[TypeVar("K"), TypeVar("V")]
 chklist = list[TypeVar("V")]
 
 FAST_LEN_ARRAY = 0
@@ -93,7 +94,16 @@ PRIM_OP_RSHIFT_UN_INT = 0
 PRIM_OP_SUB_DBL = 0
 PRIM_OP_SUB_INT = 0
 PRIM_OP_XOR_INT = 0
+SEQ_ARRAY_BOOL = 0
+SEQ_ARRAY_DOUBLE = 0
+SEQ_ARRAY_INT16 = 0
+SEQ_ARRAY_INT32 = 0
 SEQ_ARRAY_INT64 = 0
+SEQ_ARRAY_INT8 = 0
+SEQ_ARRAY_UINT16 = 0
+SEQ_ARRAY_UINT32 = 0
+SEQ_ARRAY_UINT64 = 0
+SEQ_ARRAY_UINT8 = 0
 SEQ_CHECKED_LIST = 0
 SEQ_LIST = 0
 SEQ_LIST_INEXACT = 0
@@ -109,6 +119,7 @@ try:  # noqa: C901
         __build_cinder_class__,
         chkdict,
         chklist,
+        chkprimdict,
         FAST_LEN_ARRAY,
         FAST_LEN_DICT,
         FAST_LEN_INEXACT,
@@ -164,7 +175,16 @@ try:  # noqa: C901
         PRIM_OP_XOR_INT,
         rand,
         RAND_MAX,
+        SEQ_ARRAY_BOOL,
+        SEQ_ARRAY_DOUBLE,
+        SEQ_ARRAY_INT16,
+        SEQ_ARRAY_INT32,
         SEQ_ARRAY_INT64,
+        SEQ_ARRAY_INT8,
+        SEQ_ARRAY_UINT16,
+        SEQ_ARRAY_UINT32,
+        SEQ_ARRAY_UINT64,
+        SEQ_ARRAY_UINT8,
         SEQ_CHECKED_LIST,
         SEQ_LIST,
         SEQ_LIST_INEXACT,
@@ -231,6 +251,42 @@ except ImportError:
         def __class_getitem__(cls, key) -> type[staticarray]:
             return staticarray
 
+        def copy(self) -> staticarray:
+            res = staticarray(0)
+            res._data = list(self._data)
+            return res
+
+        def fill(self, val) -> None:
+            self._data = [val] * len(self._data)
+
+        def sum(self):
+            return sum(self._data)
+
+        def min(self):
+            return min(self._data)
+
+        def max(self):
+            return max(self._data)
+
+        def _binop(self, other, op) -> None:
+            if isinstance(other, staticarray):
+                if len(other) != len(self):
+                    raise ValueError(
+                        f"staticarray sizes differ ({len(self)} and {len(other)})"
+                    )
+                self._data = [op(a, b) for a, b in zip(self._data, other._data)]
+            else:
+                self._data = [op(a, other) for a in self._data]
+
+        def add(self, other) -> None:
+            self._binop(other, lambda a, b: a + b)
+
+        def sub(self, other) -> None:
+            self._binop(other, lambda a, b: a - b)
+
+        def mul(self, other) -> None:
+            self._binop(other, lambda a, b: a * b)
+
     class StaticTypeError(TypeError):
         pass
 
@@ -557,6 +613,7 @@ def prod_assert(value: bool, message: str | None = None):
 
 CheckedDict = chkdict
 CheckedList = chklist
+CheckedPrimDict = chkprimdict
 
 
 async def _return_none():
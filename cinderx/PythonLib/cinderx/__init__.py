@@ -114,6 +114,7 @@ except ImportError as e:
         final,
         Generator,
         Generic,
+        Iterable,
         List,
         NoReturn,
         Optional,
@@ -470,8 +471,13 @@ except ImportError as e:
     def has_parallel_gc() -> bool:
         return False
 
-    def immortalize_heap() -> None:
-        pass
+    def immortalize_heap(
+        num_threads: int = 1,
+        exclude_types: tuple[type, ...] | None = None,
+        exclude_modules: Iterable[str] | None = None,
+        predicate: Callable[[object], bool] | None = None,
+    ) -> dict[str, int]:
+        return {"objects": 0, "bytes": 0}
 
     def install_frame_evaluator() -> None:
         pass
@@ -390,6 +390,7 @@ class Compiler:
                 "Array": self.type_env.array,
                 "CheckedDict": self.type_env.checked_dict.exact_type(),
                 "CheckedList": self.type_env.checked_list.exact_type(),
+                "CheckedPrimDict": self.type_env.checked_prim_dict.exact_type(),
                 "Enum": self.type_env.enum,
                 "IntEnum": self.type_env.int_enum,
                 "StringEnum": self.type_env.string_enum,
@@ -9,6 +9,7 @@ from __future__ import annotations
 from __static__ import (  # noqa: F401
     chkdict,
     chklist,
+    chkprimdict,
     FAST_LEN_ARRAY,
     FAST_LEN_DICT,
     FAST_LEN_INEXACT,
@@ -58,7 +59,16 @@ from __static__ import (  # noqa: F401
     PRIM_OP_SUB_INT,
     PRIM_OP_XOR_INT,
     rand,
+    SEQ_ARRAY_BOOL,
+    SEQ_ARRAY_DOUBLE,
+    SEQ_ARRAY_INT16,
+    SEQ_ARRAY_INT32,
     SEQ_ARRAY_INT64,
+    SEQ_ARRAY_INT8,
+    SEQ_ARRAY_UINT16,
+    SEQ_ARRAY_UINT32,
+    SEQ_ARRAY_UINT64,
+    SEQ_ARRAY_UINT8,
     SEQ_CHECKED_LIST,
     SEQ_LIST,
     SEQ_LIST_INEXACT,
@@ -311,6 +321,17 @@ class TypeEnvironment:
             pytype=chkdict,
             is_exact=True,
         )
+        self.checked_prim_dict = CheckedPrimDict(
+            GenericTypeName(
+                "__static__",
+                "chkprimdict",
+                (GenericParameter("K", 0, self), GenericParameter("V", 1, self)),
+            ),
+            self,
+            [self.object],
+            pytype=chkprimdict,
+            is_exact=True,
+        )
         self.checked_list = CheckedList(
             checked_list_type_name,
             self,
@@ -347,10 +368,11 @@ class TypeEnvironment:
             is_exact=True,
         )
 
-        # We have found no strong reason (yet) to support arrays of other types of
-        # primitives
         self.allowed_array_types: list[Class] = [
-            self.int64,
+            *self.signed_cint_types,
+            *self.unsigned_cint_types,
+            self.double,
+            self.cbool,
         ]
 
         self.static_method = StaticMethodDecorator(
@@ -8763,15 +8785,42 @@ class OptionalInstance(UnionInstance):
     klass: OptionalType
 
 
+ARRAY_SEQ_TYPES: dict[int, int] = {
+    TYPED_INT8: SEQ_ARRAY_INT8,
+    TYPED_INT16: SEQ_ARRAY_INT16,
+    TYPED_INT32: SEQ_ARRAY_INT32,
+    TYPED_INT64: SEQ_ARRAY_INT64,
+    TYPED_UINT8: SEQ_ARRAY_UINT8,
+    TYPED_UINT16: SEQ_ARRAY_UINT16,
+    TYPED_UINT32: SEQ_ARRAY_UINT32,
+    TYPED_UINT64: SEQ_ARRAY_UINT64,
+    TYPED_DOUBLE: SEQ_ARRAY_DOUBLE,
+    TYPED_BOOL: SEQ_ARRAY_BOOL,
+}
+
+# Methods that every staticarray type implements in C.
+ARRAY_BULK_METHODS: tuple[str, ...] = (
+    "add",
+    "copy",
+    "fill",
+    "max",
+    "min",
+    "mul",
+    "sub",
+    "sum",
+)
+
+
 class ArrayInstance(Object["ArrayClass"]):
     def _seq_type(self) -> int:
-        idx = self.klass.index
-        if not isinstance(idx, CIntType):
+        seq_type = ARRAY_SEQ_TYPES.get(self._element_type_code())
+        if seq_type is None:
             # should never happen
-            raise SyntaxError(f"Invalid Array type: {idx}")
-        if idx.size != 3 or not idx.signed:
-            raise SyntaxError("Only int64 Arrays are currently supported")
-        return SEQ_ARRAY_INT64
+            raise SyntaxError(f"Invalid Array type: {self.klass.index}")
+        return seq_type
+
+    def _element_type_code(self) -> int:
+        return self.klass.index.instance.as_oparg()
 
     def get_iter_type(self, node: ast.expr, visitor: TypeBinder) -> Value:
         return self.klass.index.instance
@@ -8817,7 +8866,7 @@ class ArrayInstance(Object["ArrayClass"]):
             if code_gen.get_type(node.slice).klass != self.klass.type_env.slice:
                 # Falling back to BINARY_SUBSCR here, so we need to unbox the output
                 code_gen.emit("REFINE_TYPE", self.klass.index.boxed.type_descr)
-                code_gen.emit("PRIMITIVE_UNBOX", TYPED_INT64)
+                code_gen.emit("PRIMITIVE_UNBOX", self._element_type_code())
 
     def emit_store_subscr(
         self, node: ast.Subscript, code_gen: StaticCodeGenBase
@@ -8830,7 +8879,7 @@ class ArrayInstance(Object["ArrayClass"]):
                 # Falling back to STORE_SUBSCR here, so need to box the value first
                 code_gen.emit_rotate_stack(3)
                 code_gen.emit_rotate_stack(3)
-                code_gen.emit("PRIMITIVE_BOX", TYPED_INT64)
+                code_gen.emit("PRIMITIVE_BOX", self._element_type_code())
                 code_gen.emit_rotate_stack(3)
             super().emit_store_subscr(node, code_gen)
 
@@ -8919,6 +8968,10 @@ class ArrayClass(GenericClass):
             ],
             ResolvedTypeRef(self),
         )
+        # Arrays are exact, so these are invoked directly on the method
+        # descriptor of the array type instead of being looked up by name.
+        for name in ARRAY_BULK_METHODS:
+            self.members[name] = BuiltinMethodDescriptor(name, self)
 
     @property
     def index(self) -> CType:
@@ -9067,6 +9120,192 @@ class CheckedDictInstance(Object[CheckedDict]):
         code_gen.emit("POP_JUMP_IF_NONZERO" if is_if_true else "POP_JUMP_IF_ZERO", next)
 
 
+# Primitive types which chkprimdict can store unboxed.
+UNBOXED_DICT_TYPES: set[int] = {
+    TYPED_INT8,
+    TYPED_INT16,
+    TYPED_INT32,
+    TYPED_INT64,
+    TYPED_UINT8,
+    TYPED_UINT16,
+    TYPED_UINT32,
+    TYPED_UINT64,
+    TYPED_DOUBLE,
+    TYPED_BOOL,
+}
+
+
+def _is_unboxed_dict_arg(klass: Class) -> bool:
+    return (
+        isinstance(klass, (CIntType, CDoubleType))
+        and klass.instance.as_oparg() in UNBOXED_DICT_TYPES
+    )
+
+
+class CheckedPrimDict(GenericClass):
+    """CheckedPrimDict[K, V], a dict of primitive keys and values which the
+    runtime's chkprimdict type stores unboxed."""
+
+    def __init__(
+        self,
+        type_name: GenericTypeName,
+        type_env: TypeEnvironment,
+        bases: list[Class] | None = None,
+        instance: Object[Class] | None = None,
+        klass: Class | None = None,
+        members: dict[str, Value] | None = None,
+        type_def: GenericClass | None = None,
+        is_exact: bool = False,
+        pytype: type[object] | None = None,
+        is_final: bool = True,
+    ) -> None:
+        if instance is None:
+            instance = CheckedPrimDictInstance(self)
+        super().__init__(
+            type_name,
+            type_env,
+            bases,
+            instance,
+            klass,
+            members,
+            type_def,
+            is_exact,
+            pytype,
+            is_final,
+        )
+        self.members["__init__"] = self.init_func = BuiltinFunction(
+            "__init__",
+            "builtins",
+            self,
+            self.type_env,
+            [
+                Parameter(
+                    "cls",
+                    0,
+                    ResolvedTypeRef(self.type_env.type),
+                    False,
+                    None,
+                    ParamStyle.POSONLY,
+                ),
+                Parameter(
+                    "x",
+                    1,
+                    ResolvedTypeRef(self.type_env.object),
+                    True,
+                    (),
+                    ParamStyle.POSONLY,
+                ),
+            ],
+            ResolvedTypeRef(self),
+        )
+
+    def resolve_subscr(
+        self,
+        node: ast.Subscript,
+        type: Value,
+        visitor: GenericVisitor[object],
+    ) -> Value | None:
+        res = super().resolve_subscr(node, type, visitor)
+        if isinstance(res, CheckedPrimDict) and not all(
+            _is_unboxed_dict_arg(arg) for arg in res.gen_name.args
+        ):
+            visitor.syntax_error(
+                "CheckedPrimDict keys and values must be primitive, "
+                f"got {', '.join(arg.instance.name for arg in res.gen_name.args)}",
+                node,
+            )
+            return visitor.type_env.DYNAMIC
+        return res
+
+
+class CheckedPrimDictInstance(Object[CheckedPrimDict]):
+    @property
+    def key_type(self) -> CInstance[Class]:
+        key_type = self.klass.gen_name.args[0].instance
+        assert isinstance(key_type, CInstance)
+        return key_type
+
+    @property
+    def value_type(self) -> CInstance[Class]:
+        value_type = self.klass.gen_name.args[1].instance
+        assert isinstance(value_type, CInstance)
+        return value_type
+
+    def accepts_key(self, key_type: Value) -> bool:
+        return (
+            isinstance(key_type, CInstance)
+            and key_type.klass.type_descr == self.key_type.klass.type_descr
+        )
+
+    def bind_subscr(
+        self,
+        node: ast.Subscript,
+        type: Value,
+        visitor: TypeBinder,
+        type_ctx: Class | None = None,
+    ) -> None:
+        visitor.visitExpectedType(node.slice, self.key_type, blame=node)
+        visitor.set_type(node, self.value_type)
+
+    def get_iter_type(self, node: ast.expr, visitor: TypeBinder) -> Value:
+        return self.key_type.klass.boxed.instance
+
+    def emit_load_subscr(
+        self, node: ast.Subscript, code_gen: StaticCodeGenBase
+    ) -> None:
+        # The JIT turns the boxing around __getitem__ into a lookup of the
+        # unboxed key which returns the unboxed value.
+        code_gen.emit("PRIMITIVE_BOX", self.key_type.as_oparg())
+        code_gen.emit_invoke_function((self.klass.type_descr, "__getitem__"), 2)
+        code_gen.emit("REFINE_TYPE", self.value_type.klass.boxed.type_descr)
+        code_gen.emit("PRIMITIVE_UNBOX", self.value_type.as_oparg())
+
+    def emit_store_subscr(
+        self, node: ast.Subscript, code_gen: StaticCodeGenBase
+    ) -> None:
+        # We have, from TOS: index, dict, value-to-store
+        # We want, from TOS: value-to-store, index, dict
+        code_gen.emit("PRIMITIVE_BOX", self.key_type.as_oparg())
+        code_gen.emit_rotate_stack(3)
+        code_gen.emit_rotate_stack(3)
+        code_gen.emit("PRIMITIVE_BOX", self.value_type.as_oparg())
+        code_gen.emit_invoke_function((self.klass.type_descr, "__setitem__"), 3)
+        code_gen.emit("POP_TOP")
+
+    def emit_compare(self, op: cmpop, code_gen: StaticCodeGenBase) -> None:
+        # Only reached for `key in d` with a primitive key, see
+        # CIntInstance.bind_compare and CDoubleInstance.bind_compare.
+        assert isinstance(op, (ast.In, ast.NotIn))
+        code_gen.emit_rotate_stack(2)
+        code_gen.emit("PRIMITIVE_BOX", self.key_type.as_oparg())
+        code_gen.emit_invoke_function((self.klass.type_descr, "__contains__"), 2)
+        if isinstance(op, ast.NotIn):
+            code_gen.emit("UNARY_NOT")
+
+    def get_fast_len_type(self) -> int:
+        # chkprimdict is exact and keeps its length where dict does.
+        return FAST_LEN_DICT
+
+    def emit_len(
+        self, node: ast.Call, code_gen: StaticCodeGenBase, boxed: bool
+    ) -> None:
+        if len(node.args) != 1:
+            raise code_gen.syntax_error(
+                "Can only pass a single argument when checking dict length", node
+            )
+        code_gen.visit(node.args[0])
+        code_gen.emit("FAST_LEN", self.get_fast_len_type())
+        if boxed:
+            code_gen.emit("PRIMITIVE_BOX", TYPED_INT64)
+
+    def emit_jumpif(
+        self, test: AST, next: Block, is_if_true: bool, code_gen: StaticCodeGenBase
+    ) -> None:
+        code_gen.visit(test)
+        code_gen.emit("FAST_LEN", self.get_fast_len_type())
+        code_gen.emit("POP_JUMP_IF_NONZERO" if is_if_true else "POP_JUMP_IF_ZERO", next)
+
+
 class CheckedList(GenericClass):
     def __init__(
         self,
@@ -9450,6 +9689,11 @@ class CIntInstance(CInstance["CIntType"]):
         type_ctx: Class | None,
     ) -> bool:
         if isinstance(op, (ast.In, ast.NotIn)):
+            rtype = visitor.get_type(right)
+            if isinstance(rtype, CheckedPrimDictInstance) and rtype.accepts_key(self):
+                visitor.set_type(op, rtype)
+                visitor.set_type(node, self.klass.type_env.bool.instance)
+                return True
             # Just set the op type to dynamic and the return type to bool for
             # now; when we have better support for generic containers we can
             # check for a sequence of the right type.
@@ -9831,6 +10075,11 @@ class CDoubleInstance(CInstance["CDoubleType"]):
         type_ctx: Class | None,
     ) -> bool:
         rtype = visitor.get_type(right)
+        if isinstance(op, (ast.In, ast.NotIn)):
+            if isinstance(rtype, CheckedPrimDictInstance) and rtype.accepts_key(self):
+                visitor.set_type(op, rtype)
+                visitor.set_type(node, self.klass.type_env.bool.instance)
+                return True
         if rtype != self:
             if rtype == self.klass.type_env.float.exact_type().instance:
                 visitor.visitExpectedType(right, self, "can't compare {} to {}")
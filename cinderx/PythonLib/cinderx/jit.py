@@ -3,7 +3,15 @@
 # pyre-strict
 
 from contextlib import contextmanager
-from typing import Any, AsyncGenerator, Callable, Coroutine, Generator, TypeVar
+from typing import (
+    Any,
+    AsyncGenerator,
+    Callable,
+    Coroutine,
+    Generator,
+    Sequence,
+    TypeVar,
+)
 from warnings import catch_warnings, simplefilter, warn
 
 
@@ -21,48 +29,70 @@ try:
         auto,
         background_compile,
         clear_runtime_stats,
+        compact_code,
         compile_after_n_calls,
         count_interpreted_calls,
         disable,
         disable_emit_type_annotation_guards,
+        disable_execution_counters,
         disable_hir_inliner,
         disable_specialized_opcodes,
         disassemble,
         enable,
         enable_emit_type_annotation_guards,
+        enable_execution_counters,
         enable_hir_inliner,
         enable_specialized_opcodes,
         force_compile,
         force_uncompile,
         get_allocator_stats,
+        get_and_clear_compile_trace,
+        get_and_clear_execution_counts,
         get_and_clear_inline_cache_stats,
         get_and_clear_runtime_stats,
+        get_and_clear_sampling_profile,
         get_background_compile,
         get_compilation_time,
         get_compile_after_n_calls,
+        get_compiled_direct_calls,
         get_compiled_functions,
+        get_compiled_memory_stats,
         get_compiled_size,
+        get_compiled_spill_counts,
         get_compiled_spill_stack_size,
         get_compiled_stack_size,
         get_function_compilation_time,
         get_function_hir_opcode_counts,
+        get_generator_pool_stats,
+        get_generator_size_histogram,
         get_inlined_functions_stats,
         get_jit_list,
         get_num_inlined_functions,
+        is_compiled_frameless,
         is_enabled,
+        is_frameless_leaf_functions_enabled,
         is_hir_inliner_enabled,
         is_inline_cache_stats_collection_enabled,
         is_jit_compiled,
         jit_suppress,
         jit_unsuppress,
         lazy_compile,
+        load_hot_manifest,
         mlock_profiler_dependencies,
         multithreaded_compile_test,
         page_in_profiler_dependencies,
         precompile_all,
+        precompile_hot,
+        prefork_freeze,
         read_jit_list,
+        relink_hot_code,
         set_max_code_size,
+        start_compile_trace,
+        start_sampling_profiler,
+        stop_compile_trace,
+        stop_sampling_profiler,
         wait_for_background_compiles,
+        write_hot_manifest,
     )
 
 except ImportError:
@@ -92,6 +122,9 @@ except ImportError:
     def background_compile(enabled: bool) -> None:
         return None
 
+    def compact_code(max_occupancy: float = 0.5) -> int:
+        return 0
+
     def compile_after_n_calls(calls: int) -> None:
         return None
 
@@ -104,6 +137,9 @@ except ImportError:
     def disable_emit_type_annotation_guards() -> None:
         return None
 
+    def disable_execution_counters() -> None:
+        return None
+
     def disable_hir_inliner() -> None:
         return None
 
@@ -123,6 +159,9 @@ except ImportError:
     def enable_emit_type_annotation_guards() -> None:
         return None
 
+    def enable_execution_counters(loops: bool = False) -> None:
+        return None
+
     def enable_hir_inliner() -> None:
         return None
 
@@ -138,12 +177,21 @@ except ImportError:
     def get_allocator_stats() -> dict[str, int]:
         return {}
 
+    def get_and_clear_compile_trace() -> str:
+        return ""
+
+    def get_and_clear_execution_counts() -> dict[object, dict[str, int]]:
+        return {}
+
     def get_and_clear_inline_cache_stats() -> dict[str, object]:
         return {}
 
     def get_and_clear_runtime_stats() -> dict[str, object]:
         return {}
 
+    def get_and_clear_sampling_profile() -> str:
+        return ""
+
     def get_compilation_time() -> int:
         return 0
 
@@ -153,12 +201,21 @@ except ImportError:
     def get_background_compile() -> bool:
         return False
 
+    def get_compiled_direct_calls(func: FuncAny) -> dict[str, int] | None:
+        return None
+
     def get_compiled_functions() -> list[FuncAny]:
         return []
 
+    def get_compiled_memory_stats(func: FuncAny) -> dict[str, int] | None:
+        return None
+
     def get_compiled_size(func: FuncAny) -> int:
         return 0
 
+    def get_compiled_spill_counts(func: FuncAny) -> dict[str, int] | None:
+        return None
+
     def get_compiled_spill_stack_size(func: FuncAny) -> int:
         return 0
 
@@ -171,6 +228,12 @@ except ImportError:
     def get_function_hir_opcode_counts(func: FuncAny) -> dict[str, int] | None:
         return {}
 
+    def get_generator_pool_stats() -> dict[str, object] | None:
+        return None
+
+    def get_generator_size_histogram() -> dict[str, dict[int, int]] | None:
+        return None
+
     def get_inlined_functions_stats(func: FuncAny) -> dict[str, object]:
         return {}
 
@@ -180,9 +243,15 @@ except ImportError:
     def get_num_inlined_functions(func: FuncAny) -> int:
         return 0
 
+    def is_compiled_frameless(func: FuncAny) -> bool:
+        return False
+
     def is_enabled() -> bool:
         return False
 
+    def is_frameless_leaf_functions_enabled() -> bool:
+        return False
+
     def is_hir_inliner_enabled() -> bool:
         return False
 
@@ -201,6 +270,9 @@ except ImportError:
     def lazy_compile(func: FuncAny) -> bool:
         return False
 
+    def load_hot_manifest(path: str) -> int:
+        return 0
+
     def mlock_profiler_dependencies() -> None:
         return None
 
@@ -213,15 +285,43 @@ except ImportError:
     def precompile_all(workers: int = 0) -> bool:
         return False
 
+    def precompile_hot(workers: int = 0) -> int:
+        return 0
+
+    def prefork_freeze(
+        min_calls: int = 1, read_only: bool = False, pause: bool = True
+    ) -> dict[str, int | bool] | None:
+        return None
+
     def read_jit_list(path: str) -> None:
         return None
 
+    def relink_hot_code(
+        funcs: Sequence[FuncAny] | None = None, limit: int = -1
+    ) -> int:
+        return 0
+
     def set_max_code_size(max_code_size: int) -> None:
         return None
 
+    def start_compile_trace(capacity: int = 65536) -> None:
+        return None
+
+    def start_sampling_profiler(hz: int = 100) -> bool:
+        return False
+
+    def stop_compile_trace() -> None:
+        return None
+
+    def stop_sampling_profiler() -> None:
+        return None
+
     def wait_for_background_compiles() -> None:
         return None
 
+    def write_hot_manifest(path: str, min_calls: int = 1) -> int:
+        return 0
+
 
 @contextmanager
 def pause(deopt_all: bool = False) -> Generator[None, None, None]:
@@ -247,3 +347,47 @@ def pause(deopt_all: bool = False) -> Generator[None, None, None]:
             with catch_warnings():
                 simplefilter("ignore")
                 enable()
+
+
+# Total number of entries across the default generator pool size classes.
+DEFAULT_GENERATOR_POOL_CAPACITY = 4448
+
+
+def suggest_generator_pool_classes(
+    max_classes: int = 5, total_capacity: int = DEFAULT_GENERATOR_POOL_CAPACITY
+) -> str | None:
+    """
+    Suggest generator pool size classes for this workload.
+
+    Picks up to `max_classes` entry sizes that split the JIT generators
+    allocated so far into roughly equal shares, falling back to the sizes of
+    the compiled generator functions if none have been allocated yet, and
+    divides `total_capacity` entries between them in proportion to their
+    share.  Returns a value for `-X cinderx-jit-gen-pool-classes`, or None if
+    there is nothing to go on.
+    """
+
+    histogram = get_generator_size_histogram()
+    if histogram is None:
+        return None
+    counts = histogram["allocations"] or histogram["compiled"]
+    if not counts or max_classes <= 0:
+        return None
+
+    total = sum(counts.values())
+    classes: dict[int, int] = {}
+    cumulative = 0
+    boundary = 1
+    for size in sorted(counts):
+        cumulative += counts[size]
+        # Close a class once it holds its share of the allocations, and always
+        # after the largest size.
+        if cumulative * max_classes >= total * boundary or cumulative == total:
+            classes[size] = cumulative - sum(classes.values())
+            while cumulative * max_classes >= total * boundary:
+                boundary += 1
+
+    return ",".join(
+        f"{size}:{max(1, total_capacity * count // total)}"
+        for size, count in classes.items()
+    )
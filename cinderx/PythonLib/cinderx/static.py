@@ -8,6 +8,7 @@ from _static import (
     _property_missing_fset,
     chkdict,
     chklist,
+    chkprimdict,
     FAST_LEN_ARRAY,
     FAST_LEN_DICT,
     FAST_LEN_INEXACT,
@@ -66,7 +67,16 @@ from _static import (
     rand,
     RAND_MAX,
     resolve_primitive_descr,
+    SEQ_ARRAY_BOOL,
+    SEQ_ARRAY_DOUBLE,
+    SEQ_ARRAY_INT16,
+    SEQ_ARRAY_INT32,
     SEQ_ARRAY_INT64,
+    SEQ_ARRAY_INT8,
+    SEQ_ARRAY_UINT16,
+    SEQ_ARRAY_UINT32,
+    SEQ_ARRAY_UINT64,
+    SEQ_ARRAY_UINT8,
     SEQ_CHECKED_LIST,
     SEQ_LIST,
     SEQ_LIST_INEXACT,
@@ -109,6 +119,7 @@ __all__ = [
     "_property_missing_fset",
     "chkdict",
     "chklist",
+    "chkprimdict",
     "FAST_LEN_ARRAY",
     "FAST_LEN_DICT",
     "FAST_LEN_INEXACT",
@@ -167,7 +178,16 @@ __all__ = [
     "rand",
     "RAND_MAX",
     "resolve_primitive_descr",
+    "SEQ_ARRAY_BOOL",
+    "SEQ_ARRAY_DOUBLE",
+    "SEQ_ARRAY_INT16",
+    "SEQ_ARRAY_INT32",
     "SEQ_ARRAY_INT64",
+    "SEQ_ARRAY_INT8",
+    "SEQ_ARRAY_UINT16",
+    "SEQ_ARRAY_UINT32",
+    "SEQ_ARRAY_UINT64",
+    "SEQ_ARRAY_UINT8",
     "SEQ_CHECKED_LIST",
     "SEQ_LIST",
     "SEQ_LIST_INEXACT",
@@ -4,9 +4,11 @@ import asyncio
 import copy
 import faulthandler
 import gc
+import os
 import sys
 import tempfile
 import textwrap
+import types
 import unittest
 import warnings
 import weakref
@@ -94,7 +96,6 @@ class InlineCacheStatsTests(unittest.TestCase):
         not cinderx.jit.is_inline_cache_stats_collection_enabled(),
         "meaningless without inline cache stats collection enabled",
     )
-    @skip_if_ft("T250369692: Inline caches disabled with free-threading")
     def test_load_method_cache_stats(self) -> None:
         # Clear inline cache stats of any collected data from importing
         # builtin modules
@@ -2246,6 +2247,144 @@ class ForceUncompileTests(unittest.TestCase):
         self.assertFalse(is_jit_compiled(f))
 
 
+@passUnless(cinderx.jit.is_enabled(), "Testing the cinderjit module itself")
+class DirectCallTests(unittest.TestCase):
+    @staticmethod
+    def _make_funcs() -> tuple[Callable[..., int], Callable[..., int]]:
+        ns: dict[str, object] = {}
+        code = """
+            def callee(a, b):
+                return a * 10 + b
+
+            def caller(a, b):
+                return callee(a, b) + callee(b, a)
+        """
+        exec(textwrap.dedent(code), ns, ns)
+        # pyre-ignore[7]: exec-defined functions.
+        return ns["caller"], ns["callee"]
+
+    def test_callee_uncompiled_and_recompiled(self) -> None:
+        caller, callee = self._make_funcs()
+        self.assertTrue(force_compile(callee))
+        self.assertTrue(force_compile(caller))
+        self.assertEqual(caller(1, 2), 33)
+
+        self.assertTrue(force_uncompile(callee))
+        self.assertEqual(caller(1, 2), 33)
+
+        self.assertTrue(force_compile(callee))
+        self.assertEqual(caller(1, 2), 33)
+
+    def test_callee_compiled_after_caller(self) -> None:
+        caller, callee = self._make_funcs()
+        self.assertTrue(force_compile(caller))
+        self.assertEqual(caller(3, 4), 77)
+        self.assertFalse(is_jit_compiled(callee))
+
+        self.assertTrue(force_compile(callee))
+        self.assertEqual(caller(3, 4), 77)
+
+    def test_callee_code_replaced(self) -> None:
+        caller, callee = self._make_funcs()
+        self.assertTrue(force_compile(callee))
+        self.assertTrue(force_compile(caller))
+        self.assertEqual(caller(5, 2), 77)
+
+        callee.__code__ = (lambda a, b: a - b).__code__
+        self.assertEqual(caller(5, 2), 0)
+
+    def _assert_direct(self, caller: Callable[..., int]) -> None:
+        calls = cinderx.jit.get_compiled_direct_calls(caller)
+        self.assertIsNotNone(calls)
+        if calls["sites"] == 0:
+            self.skipTest("Direct calls aren't supported on this platform")
+        self.assertEqual(calls["patched"], calls["sites"])
+
+    def test_callee_uncompiled_and_recompiled_goes_direct(self) -> None:
+        caller, callee = self._make_funcs()
+        self.assertTrue(force_compile(callee))
+        self.assertTrue(force_compile(caller))
+        self._assert_direct(caller)
+
+        self.assertTrue(force_uncompile(callee))
+        self.assertEqual(cinderx.jit.get_compiled_direct_calls(caller)["patched"], 0)
+        self.assertEqual(caller(1, 2), 33)
+
+        self.assertTrue(force_compile(callee))
+        self._assert_direct(caller)
+        self.assertEqual(caller(1, 2), 33)
+
+    def test_callee_relinked_goes_direct(self) -> None:
+        if "free_bytes" not in cinderx.jit.get_allocator_stats():
+            self.skipTest("Code allocator can't relink")
+        caller, callee = self._make_funcs()
+        self.assertTrue(force_compile(callee))
+        self.assertTrue(force_compile(caller))
+        self._assert_direct(caller)
+
+        self.assertEqual(cinderx.jit.relink_hot_code([callee]), 1)
+        self.assertTrue(is_jit_compiled(callee))
+        self._assert_direct(caller)
+        self.assertEqual(caller(1, 2), 33)
+
+
+@passUnless(cinderx.jit.is_enabled(), "Testing the cinderjit module itself")
+class FramelessLeafTests(unittest.TestCase):
+    @staticmethod
+    def _make_leaf() -> Callable[[], object]:
+        ns: dict[str, object] = {"value": 42}
+        code = """
+            def leaf():
+                return value
+        """
+        exec(textwrap.dedent(code), ns, ns)
+        # pyre-ignore[7]: exec-defined function.
+        return ns["leaf"]
+
+    def test_leaf_is_frameless(self) -> None:
+        leaf = self._make_leaf()
+
+        def caller() -> object:
+            return leaf()
+
+        self.assertTrue(force_compile(leaf))
+        self.assertTrue(force_compile(caller))
+        self.assertEqual(
+            cinderx.jit.is_compiled_frameless(leaf),
+            cinderx.jit.is_frameless_leaf_functions_enabled(),
+        )
+        self.assertFalse(cinderx.jit.is_compiled_frameless(caller))
+        self.assertEqual(caller(), 42)
+
+    def test_global_changed(self) -> None:
+        leaf = self._make_leaf()
+        self.assertTrue(force_compile(leaf))
+        self.assertEqual(leaf(), 42)
+
+        leaf.__globals__["value"] = "changed"
+        self.assertEqual(leaf(), "changed")
+
+    def test_frame_linked_on_raise(self) -> None:
+        leaf = self._make_leaf()
+        self.assertTrue(force_compile(leaf))
+        self.assertEqual(leaf(), 42)
+
+        del leaf.__globals__["value"]
+        with self.assertRaises(NameError) as ctx:
+            leaf()
+        tb = ctx.exception.__traceback__
+        self.assertIsNotNone(tb)
+        while tb.tb_next is not None:
+            tb = tb.tb_next
+        self.assertIs(tb.tb_frame.f_code, leaf.__code__)
+        self.assertIs(
+            tb.tb_frame.f_back.f_code, self.test_frame_linked_on_raise.__code__
+        )
+
+        leaf.__globals__["value"] = 1
+        self.assertEqual(leaf(), 1)
+
+
 @passUnless(cinderx.jit.is_enabled(), "Testing the cinderjit module itself")
 class LazyCompileTests(unittest.TestCase):
     def test_basic(self) -> None:
@@ -2482,6 +2621,482 @@ class CompileTimeTests(unittest.TestCase):
         self.assertGreater(cinderx.jit.get_function_compilation_time(_compile), 0)
 
 
+@passUnless(cinderx.jit.is_enabled(), "Testing the cinderjit module itself")
+class MemoryStatsTests(unittest.TestCase):
+    def test_compiled_memory_stats(self) -> None:
+        def f(a, b):
+            x = a + b
+            y = a * b
+            return [x, y, x - y]
+
+        self.assertIsNone(cinderx.jit.get_compiled_memory_stats(f))
+        force_compile(f)
+        self.assertEqual(f(3, 4), [7, 12, -5])
+
+        stats = cinderx.jit.get_compiled_memory_stats(f)
+        self.assertIsNotNone(stats)
+        self.assertEqual(
+            set(stats), {"code", "deopt_metadata", "inline_caches", "debug_info"}
+        )
+        self.assertEqual(stats["code"], cinderx.jit.get_compiled_size(f))
+        self.assertGreater(stats["deopt_metadata"], 0)
+        self.assertGreater(stats["debug_info"], 0)
+
+
+@passUnless(cinderx.jit.is_enabled(), "Testing the cinderjit module itself")
+class GeneratorPoolStatsTests(unittest.TestCase):
+    def test_generator_pool_stats(self) -> None:
+        def gen(n):
+            for i in range(n):
+                yield i
+
+        force_compile(gen)
+        before = cinderx.jit.get_generator_pool_stats()
+        self.assertIsNotNone(before)
+        self.assertEqual(
+            set(before),
+            {"hits", "misses", "remote_frees", "bytes_held", "classes"},
+        )
+        sizes = [cls["size"] for cls in before["classes"]]
+        self.assertEqual(sizes, sorted(sizes))
+
+        for _ in range(100):
+            self.assertEqual(sum(gen(3)), 3)
+
+        after = cinderx.jit.get_generator_pool_stats()
+        # Each generator is freed before the next one is created, so at most
+        # the first allocation misses.
+        self.assertGreaterEqual(after["hits"] - before["hits"], 99)
+        self.assertEqual(after["remote_frees"], before["remote_frees"])
+        self.assertGreater(after["bytes_held"], 0)
+        self.assertEqual(
+            sum(cls["hits"] for cls in after["classes"])
+            - sum(cls["hits"] for cls in before["classes"]),
+            after["hits"] - before["hits"],
+        )
+
+    def test_generator_size_histogram(self) -> None:
+        def gen(n):
+            for i in range(n):
+                yield i
+
+        force_compile(gen)
+        before = cinderx.jit.get_generator_size_histogram()
+        self.assertIsNotNone(before)
+        self.assertEqual(set(before), {"allocations", "compiled"})
+        self.assertGreaterEqual(sum(before["compiled"].values()), 1)
+
+        for _ in range(10):
+            self.assertEqual(sum(gen(3)), 3)
+
+        after = cinderx.jit.get_generator_size_histogram()
+        self.assertEqual(
+            sum(after["allocations"].values()) - sum(before["allocations"].values()),
+            10,
+        )
+        for bound in after["allocations"]:
+            self.assertEqual(bound % 64, 0)
+
+        suggestion = cinderx.jit.suggest_generator_pool_classes()
+        self.assertIsNotNone(suggestion)
+        for entry in suggestion.split(","):
+            size, capacity = entry.split(":")
+            self.assertEqual(int(size) % 16, 0)
+            self.assertGreater(int(capacity), 0)
+
+
+@passUnless(cinderx.jit.is_enabled(), "Testing the cinderjit module itself")
+class SpillCountsTests(unittest.TestCase):
+    def test_compiled_spill_counts(self) -> None:
+        def f(n):
+            # More values live across the calls than there are callee-saved
+            # registers.
+            a, b, c, d, e, g, h, i = (
+                n + 1, n + 2, n + 3, n + 4, n + 5, n + 6, n + 7, n + 8
+            )
+            total = 0
+            for _ in range(n):
+                total += len(str(a)) + len(str(b)) + len(str(c))
+            return total + a + b + c + d + e + g + h + i
+
+        self.assertIsNone(cinderx.jit.get_compiled_spill_counts(f))
+        force_compile(f)
+        self.assertEqual(f(3), 3 * 3 + 4 + 5 + 6 + 7 + 8 + 9 + 10 + 11)
+
+        counts = cinderx.jit.get_compiled_spill_counts(f)
+        self.assertIsNotNone(counts)
+        self.assertEqual(set(counts), {"spills", "reloads", "rematerializations"})
+        for count in counts.values():
+            self.assertGreaterEqual(count, 0)
+
+
+@passUnless(cinderx.jit.is_enabled(), "Testing the cinderjit module itself")
+class SamplingProfilerTests(unittest.TestCase):
+    def tearDown(self) -> None:
+        cinderx.jit.stop_sampling_profiler()
+        cinderx.jit.get_and_clear_sampling_profile()
+
+    def test_samples_compiled_code(self) -> None:
+        import threading
+        import time
+
+        def spin(deadline):
+            n = 0
+            while time.monotonic() < deadline:
+                n += 1
+            return n
+
+        force_compile(spin)
+        self.assertTrue(is_jit_compiled(spin))
+
+        self.assertTrue(cinderx.jit.start_sampling_profiler(hz=1000))
+        self.assertFalse(cinderx.jit.start_sampling_profiler())
+        worker = threading.Thread(target=spin, args=(time.monotonic() + 0.5,))
+        worker.start()
+        worker.join()
+        cinderx.jit.stop_sampling_profiler()
+
+        profile = cinderx.jit.get_and_clear_sampling_profile()
+        lines = profile.splitlines()
+        self.assertGreater(len(lines), 0)
+        for line in lines:
+            _, count = line.rsplit(" ", 1)
+            self.assertGreater(int(count), 0)
+        self.assertTrue(any("spin (" in line for line in lines), profile)
+        self.assertEqual(cinderx.jit.get_and_clear_sampling_profile(), "")
+
+    def test_samples_calling_thread(self) -> None:
+        import time
+
+        def spin(deadline):
+            n = 0
+            while time.monotonic() < deadline:
+                n += 1
+            return n
+
+        force_compile(spin)
+        self.assertTrue(is_jit_compiled(spin))
+
+        # The thread that starts the profiler is sampled while it runs Python
+        # code, without having to give up the GIL for it.
+        self.assertTrue(cinderx.jit.start_sampling_profiler(hz=1000))
+        spin(time.monotonic() + 0.3)
+        cinderx.jit.stop_sampling_profiler()
+
+        profile = cinderx.jit.get_and_clear_sampling_profile()
+        self.assertTrue(any("spin (" in line for line in profile.splitlines()))
+
+    def test_bad_rate(self) -> None:
+        with self.assertRaises(ValueError):
+            cinderx.jit.start_sampling_profiler(hz=0)
+
+
+@skip_test_if_oss("Static Python")
+@passUnless(cinderx.jit.is_enabled(), "Testing the cinderjit module itself")
+class SamplingProfilerFramelessTests(StaticTestBase):
+    def tearDown(self) -> None:
+        cinderx.jit.stop_sampling_profiler()
+        cinderx.jit.get_and_clear_sampling_profile()
+
+    def test_samples_frameless_leaf(self) -> None:
+        import time
+
+        if not cinderx.jit.is_frameless_leaf_functions_enabled():
+            self.skipTest("Frameless leaf functions are disabled")
+        # Straight-line primitive math, so that the leaf has no loop checking
+        # the eval breaker and nothing else that could run arbitrary code.
+        body = "\n".join("    a = (a ^ (a >> 3)) + 7" for _ in range(200))
+        codestr = f"""
+from __static__ import box, int64
+import time
+
+def leaf(x: int) -> int:
+    a: int64 = int64(x)
+{body}
+    return box(a)
+
+def spin(deadline: float) -> int:
+    n = 0
+    while time.monotonic() < deadline:
+        n += leaf(n & 1023)
+    return n
+"""
+        with self.in_module(codestr) as mod:
+            self.assertTrue(force_compile(mod.leaf))
+            self.assertTrue(force_compile(mod.spin))
+            self.assertTrue(cinderx.jit.is_compiled_frameless(mod.leaf))
+            self.assertFalse(cinderx.jit.is_compiled_frameless(mod.spin))
+
+            self.assertTrue(cinderx.jit.start_sampling_profiler(hz=1000))
+            mod.spin(time.monotonic() + 0.5)
+            cinderx.jit.stop_sampling_profiler()
+
+        profile = cinderx.jit.get_and_clear_sampling_profile()
+        # The leaf is reported inside of its caller, even though its frame is
+        # never linked.
+        frames = [
+            line.rsplit(" ", 1)[0].split(";") for line in profile.splitlines()
+        ]
+        self.assertTrue(
+            any(
+                len(stack) >= 2
+                and stack[-2].startswith("spin (")
+                and stack[-1].startswith("leaf (")
+                for stack in frames
+            ),
+            profile,
+        )
+
+
+@passUnless(cinderx.jit.is_enabled(), "Testing the cinderjit module itself")
+class CompileTraceTests(unittest.TestCase):
+    def tearDown(self) -> None:
+        cinderx.jit.stop_compile_trace()
+        cinderx.jit.get_and_clear_compile_trace()
+
+    def test_traces_compile_pipeline(self) -> None:
+        import json
+
+        def traced(x):
+            return x + 1
+
+        cinderx.jit.start_compile_trace()
+        force_compile(traced)
+        cinderx.jit.stop_compile_trace()
+        self.assertTrue(is_jit_compiled(traced))
+
+        trace = json.loads(cinderx.jit.get_and_clear_compile_trace())
+        events = [
+            event
+            for event in trace["traceEvents"]
+            if event["ph"] == "X"
+            and event.get("args", {}).get("function", "").endswith("traced")
+        ]
+        names = {event["name"] for event in events}
+        for name in (
+            "Compile",
+            "Lowering into HIR",
+            "SSAify",
+            "Lowering into LIR",
+            "Register Allocation",
+            "Code Generation",
+            "Install code",
+        ):
+            self.assertIn(name, names)
+        for event in events:
+            self.assertGreaterEqual(event["dur"], 0)
+        self.assertEqual(trace["otherData"]["dropped_events"], 0)
+
+        trace = json.loads(cinderx.jit.get_and_clear_compile_trace())
+        self.assertEqual(
+            [event for event in trace["traceEvents"] if event["ph"] == "X"], []
+        )
+
+    def test_bad_capacity(self) -> None:
+        with self.assertRaises(ValueError):
+            cinderx.jit.start_compile_trace(capacity=0)
+
+
+@passUnless(cinderx.jit.is_enabled(), "Testing the cinderjit module itself")
+class ExecutionCounterTests(unittest.TestCase):
+    def tearDown(self) -> None:
+        cinderx.jit.disable_execution_counters()
+        cinderx.jit.get_and_clear_execution_counts()
+
+    def test_counts_calls_and_loop_iterations(self) -> None:
+        def loop(n):
+            total = 0
+            for i in range(n):
+                total += i
+            return total
+
+        cinderx.jit.enable_execution_counters(loops=True)
+        force_compile(loop)
+        self.assertTrue(is_jit_compiled(loop))
+        for _ in range(7):
+            loop(10)
+
+        counts = cinderx.jit.get_and_clear_execution_counts()
+        self.assertIn(loop.__code__, counts)
+        self.assertEqual(counts[loop.__code__]["calls"], 7)
+        self.assertGreaterEqual(counts[loop.__code__]["loop_iterations"], 70)
+        self.assertNotIn(loop.__code__, cinderx.jit.get_and_clear_execution_counts())
+
+    def test_disabled_by_default(self) -> None:
+        def f():
+            return 1
+
+        force_compile(f)
+        f()
+        self.assertNotIn(f.__code__, cinderx.jit.get_and_clear_execution_counts())
+
+
+@passUnless(cinderx.jit.is_enabled(), "Testing the cinderjit module itself")
+class CodeAllocatorTests(unittest.TestCase):
+    @skip_if_prefork()
+    def test_released_code_is_reported_free(self) -> None:
+        stats = cinderx.jit.get_allocator_stats()
+        if "free_bytes" not in stats:
+            self.skipTest("Code allocator doesn't track free space")
+
+        def f(a, b):
+            return a * b + a
+
+        force_compile(f)
+        self.assertEqual(f(3, 4), 15)
+        released = cinderx.jit.get_allocator_stats()["released_bytes"]
+
+        force_uncompile(f)
+        del f
+        gc.collect()
+
+        stats = cinderx.jit.get_allocator_stats()
+        self.assertGreater(stats["released_bytes"], released)
+        self.assertLessEqual(stats["largest_free_extent"], stats["free_bytes"])
+        self.assertLessEqual(stats["free_bytes"], stats["reserved_bytes"])
+        self.assertGreaterEqual(stats["fragmentation"], 0)
+        self.assertLessEqual(stats["fragmentation"], 100)
+
+    def test_compact_code(self) -> None:
+        def f(a, b):
+            return a - b
+
+        force_compile(f)
+        # Everything counts as sparse, but the chunk currently receiving new
+        # code is never evacuated, so this may or may not move f.
+        self.assertGreaterEqual(cinderx.jit.compact_code(1.0), 0)
+        self.assertEqual(f(10, 4), 6)
+        self.assertEqual(cinderx.jit.compact_code(0.0), 0)
+
+    def test_compact_code_bad_occupancy(self) -> None:
+        with self.assertRaises(ValueError):
+            cinderx.jit.compact_code(1.5)
+
+    def test_relink_hot_code(self) -> None:
+        def hot(a, b):
+            return a + b
+
+        def warm(a, b):
+            return a * b
+
+        def interpreted(a):
+            return a
+
+        force_compile(hot)
+        force_compile(warm)
+        expected = 2 if "free_bytes" in cinderx.jit.get_allocator_stats() else 0
+        self.assertEqual(
+            cinderx.jit.relink_hot_code([hot, warm, interpreted, hot]), expected
+        )
+        self.assertTrue(is_jit_compiled(hot))
+        self.assertTrue(is_jit_compiled(warm))
+        self.assertFalse(is_jit_compiled(interpreted))
+        self.assertEqual(hot(3, 4), 7)
+        self.assertEqual(warm(3, 4), 12)
+
+        self.assertEqual(cinderx.jit.relink_hot_code([hot, warm], limit=0), 0)
+
+    def test_relink_hot_code_by_call_count(self) -> None:
+        def f(a):
+            return a + 1
+
+        force_compile(f)
+        self.assertGreaterEqual(cinderx.jit.relink_hot_code(limit=1), 0)
+        self.assertEqual(f(1), 2)
+
+    def test_relink_hot_code_bad_funcs(self) -> None:
+        if "free_bytes" not in cinderx.jit.get_allocator_stats():
+            self.skipTest("Code allocator can't relink")
+        with self.assertRaises(TypeError):
+            cinderx.jit.relink_hot_code([1])
+        with self.assertRaises(TypeError):
+            cinderx.jit.relink_hot_code(5)
+
+    @run_in_subprocess
+    def test_prefork_freeze(self) -> None:
+        class C:
+            def get(self) -> int:
+                return 1
+
+        def call(c: C) -> int:
+            return c.get()
+
+        def add(a, b):
+            return a + b
+
+        force_compile(call)
+        force_compile(add)
+        for _ in range(10):
+            self.assertEqual(call(C()), 1)
+
+        report = cinderx.jit.prefork_freeze(read_only=True)
+        if "free_bytes" not in cinderx.jit.get_allocator_stats():
+            self.assertIsNone(report)
+            return
+        self.assertIsNotNone(report)
+        self.assertTrue(report["read_only"])
+        self.assertGreaterEqual(report["relinked"], 2)
+        self.assertGreater(report["code_pages"], 0)
+        self.assertGreater(report["metadata_bytes"], 0)
+        self.assertEqual(
+            report["shared_pages"], report["code_pages"] + report["metadata_pages"]
+        )
+        self.assertEqual(report["private_pages"], report["state_pages"])
+        self.assertFalse(cinderx.jit.is_enabled())
+
+        self.assertTrue(is_jit_compiled(call))
+        self.assertTrue(is_jit_compiled(add))
+        self.assertEqual(add(3, 4), 7)
+        # Invalidating what the compiled code assumed about C patches it, even
+        # though it's now write-protected.
+        C.get = lambda self: 2
+        self.assertEqual(call(C()), 2)
+
+    def test_prefork_freeze_bad_min_calls(self) -> None:
+        with self.assertRaises(ValueError):
+            cinderx.jit.prefork_freeze(min_calls=-1)
+
+    @run_in_subprocess
+    def test_hot_manifest(self) -> None:
+        def hot(a, b):
+            return a + b
+
+        force_compile(hot)
+        for _ in range(10):
+            hot(1, 2)
+
+        with tempfile.TemporaryDirectory() as tmpdir:
+            path = os.path.join(tmpdir, "manifest")
+            self.assertGreaterEqual(cinderx.jit.write_hot_manifest(path), 1)
+            with open(path) as f:
+                lines = f.read().splitlines()
+            self.assertTrue(lines[0].startswith("#"))
+            qualname = f"{__name__}:{hot.__qualname__}"
+            (line,) = [line for line in lines if line.split()[0] == qualname]
+            _, code_hash, calls, *_ = line.split()
+            int(code_hash, 16)
+            self.assertGreaterEqual(int(calls), 10)
+
+            self.assertEqual(cinderx.jit.write_hot_manifest(path, 1 << 40), 0)
+            cinderx.jit.write_hot_manifest(path)
+            self.assertGreaterEqual(cinderx.jit.load_hot_manifest(path), 1)
+
+        # A new function for the same code is compiled from the manifest.
+        hot2 = types.FunctionType(hot.__code__, hot.__globals__)
+        self.assertFalse(is_jit_compiled(hot2))
+        self.assertGreaterEqual(cinderx.jit.precompile_hot(), 1)
+        self.assertTrue(is_jit_compiled(hot2))
+        self.assertEqual(hot2(3, 4), 7)
+
+    def test_hot_manifest_bad_args(self) -> None:
+        with self.assertRaises(ValueError):
+            cinderx.jit.write_hot_manifest("manifest", min_calls=-1)
+        with self.assertRaises(ValueError):
+            cinderx.jit.precompile_hot(workers=-1)
+        with self.assertRaises(TypeError):
+            cinderx.jit.load_hot_manifest(1)
+
+
 class SimplifyCompileTimeTests(unittest.TestCase):
     @staticmethod
     def _make_chain(kind: str, n: int) -> Callable[..., int]:
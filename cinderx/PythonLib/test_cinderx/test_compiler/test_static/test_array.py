@@ -10,7 +10,14 @@ from cinderx.compiler.static.types import (
     SEQ_ARRAY_INT64,
     TypedSyntaxError,
 )
-from cinderx.static import SEQ_SUBSCR_UNCHECKED, TYPED_INT64
+from cinderx.static import (
+    SEQ_ARRAY_BOOL,
+    SEQ_ARRAY_DOUBLE,
+    SEQ_ARRAY_INT8,
+    SEQ_ARRAY_UINT16,
+    SEQ_SUBSCR_UNCHECKED,
+    TYPED_INT64,
+)
 from cinderx.test_support import is_sanitizer_build, passIf
 
 from .common import StaticTestBase
@@ -127,6 +134,23 @@ class ArrayTests(StaticTestBase):
             y = mod.y
             self.assertEqual(y(), 5)
 
+    def test_array_len_element_types(self):
+        codestr = """
+            from __static__ import int8, uint16, double, cbool, Array
+
+            def y():
+                return (
+                    len(Array[int8](1))
+                    + len(Array[uint16](2))
+                    + len(Array[double](3))
+                    + len(Array[cbool](4))
+                )
+        """
+        y = self.find_code(self.compile(codestr, modname="foo"), name="y")
+        self.assertInBytecode(y, "FAST_LEN", FAST_LEN_ARRAY)
+        with self.in_module(codestr) as mod:
+            self.assertEqual(mod.y(), 10)
+
     def test_array_isinstance(self):
         x = Array[int64](0)
         self.assertTrue(isinstance(x, Array[int64]))
@@ -224,6 +248,96 @@ class ArrayTests(StaticTestBase):
             actual = m()
             self.assertEqual(actual, 111)
 
+    def test_array_element_types(self):
+        for typ, seq_type, value in [
+            ("int8", SEQ_ARRAY_INT8, -100),
+            ("uint16", SEQ_ARRAY_UINT16, 60000),
+            ("double", SEQ_ARRAY_DOUBLE, 2.5),
+            ("cbool", SEQ_ARRAY_BOOL, True),
+        ]:
+            with self.subTest(typ=typ):
+                codestr = f"""
+                    from __static__ import Array, {typ}, box
+
+                    def m(x: {typ}):
+                        a = Array[{typ}](2)
+                        a[1] = x
+                        return box(a[1]), box(a[0])
+                """
+                c = self.compile(codestr, modname="foo.py")
+                m = self.find_code(c, "m")
+                self.assertInBytecode(m, "SEQUENCE_GET", seq_type)
+                self.assertInBytecode(m, "SEQUENCE_SET", seq_type)
+                with self.in_module(codestr) as mod:
+                    res, zero = mod.m(value)
+                    self.assertEqual(res, value)
+                    self.assertFalse(zero)
+
+    def test_array_double_forloop(self):
+        codestr = """
+            from __static__ import Array, double
+
+            def f() -> double:
+                a: Array[double] = Array[double](3)
+                a.fill(1.5)
+                a[2] = 0.25
+
+                sum: double = 0.0
+                for el in a:
+                    sum += el
+                return sum
+        """
+        with self.in_module(codestr) as mod:
+            self.assertInBytecode(
+                mod.f, "SEQUENCE_GET", SEQ_ARRAY_DOUBLE | SEQ_SUBSCR_UNCHECKED
+            )
+            self.assertEqual(mod.f(), 3.25)
+
+    def test_array_bulk_methods_invoked_directly(self):
+        codestr = """
+            from __static__ import Array, double, int64
+
+            def f(a: Array[double], b: Array[double]):
+                a.fill(1.5)
+                a.add(b)
+                a.mul(2.0)
+                return a.sum(), a.min(), a.max()
+
+            def g(a: Array[int64]):
+                a.fill(3)
+                a.sub(1)
+                return a.sum()
+        """
+        with self.in_module(codestr) as mod:
+            for func, names in [
+                (mod.f, {"fill", "add", "mul", "sum", "min", "max"}),
+                (mod.g, {"fill", "sub", "sum"}),
+            ]:
+                invoked = {
+                    instr.argval[0][1]
+                    for instr in self.get_instructions(func)
+                    if instr.opname == "INVOKE_FUNCTION"
+                }
+                self.assertEqual(invoked, names)
+
+            a = Array[double](2)
+            b = Array[double](2)
+            b[0] = 0.5
+            self.assertEqual(mod.f(a, b), (7.0, 3.0, 4.0))
+            self.assertEqual(mod.g(Array[int64](3)), 6)
+
+    def test_array_element_type_mismatch(self):
+        codestr = """
+            from __static__ import Array, int8, int64
+
+            def f(a: Array[int8]) -> None:
+                pass
+
+            def g() -> None:
+                f(Array[int64](1))
+        """
+        self.type_error(codestr, r"Array\[int64\]", at="Array[int64](1)")
+
     def test_array_get_nonprimitive_idx(self):
         codestr = """
             from __static__ import Array, int64, box
@@ -2,7 +2,7 @@
 
 # pyre-strict
 
-from __static__ import chkdict
+from __static__ import chkdict, chkprimdict, int64
 
 import cinderx.jit
 from cinderx.compiler.static.types import FAST_LEN_DICT, TypedSyntaxError
@@ -681,3 +681,113 @@ class CheckedDictTests(StaticTestBase):
             for _ in range(50):
                 self.assertEqual(mod.f(), "hello")
             self.assertEqual(mod.f(), "hello")
+
+    def test_checked_prim_dict_subscr(self) -> None:
+        codestr = """
+        from __static__ import CheckedPrimDict, box, int64
+
+        def testfunc(n: int) -> int:
+            d = CheckedPrimDict[int64, int64]()
+            i: int64 = 0
+            while i < int64(n):
+                d[i] = i * i
+                i += 1
+            total: int64 = 0
+            i = 0
+            while i < int64(n):
+                total += d[i]
+                i += 1
+            return box(total)
+        """
+        with self.in_module(codestr) as mod:
+            f = mod.testfunc
+            descr = (
+                "__static__",
+                "chkprimdict",
+                (("__static__", "int64", "#"), ("__static__", "int64", "#")),
+                "!",
+            )
+            self.assertInBytecode(
+                f, "INVOKE_FUNCTION", ((descr, "__getitem__"), 2)
+            )
+            self.assertInBytecode(
+                f, "INVOKE_FUNCTION", ((descr, "__setitem__"), 3)
+            )
+            self.assertEqual(f(10), sum(i * i for i in range(10)))
+
+    def test_checked_prim_dict_contains(self) -> None:
+        codestr = """
+        from __static__ import CheckedPrimDict, double
+
+        def testfunc(x: double) -> bool:
+            d = CheckedPrimDict[double, double]({1.5: 2.0, -0.0: 1.0})
+            return x in d
+
+        def testfunc_not(x: double) -> bool:
+            d = CheckedPrimDict[double, double]({1.5: 2.0})
+            return x not in d
+        """
+        with self.in_module(codestr) as mod:
+            self.assertTrue(mod.testfunc(1.5))
+            self.assertTrue(mod.testfunc(0.0))
+            self.assertFalse(mod.testfunc(2.5))
+            self.assertFalse(mod.testfunc_not(1.5))
+            self.assertTrue(mod.testfunc_not(2.5))
+
+    def test_checked_prim_dict_missing_key(self) -> None:
+        codestr = """
+        from __static__ import CheckedPrimDict, int32, int8
+
+        def testfunc(x: int32) -> int8:
+            d = CheckedPrimDict[int32, int8]({1: 2})
+            return d[x]
+        """
+        with self.in_module(codestr) as mod:
+            self.assertEqual(mod.testfunc(1), 2)
+            with self.assertRaises(KeyError):
+                mod.testfunc(3)
+
+    def test_checked_prim_dict_runtime(self) -> None:
+        d = chkprimdict[int64, int64]({1: 2, 3: 4})
+        self.assertIs(type(d), chkprimdict[int64, int64])
+        self.assertEqual(d, {1: 2, 3: 4})
+        self.assertEqual(len(d), 2)
+        self.assertEqual(d.get(5, 6), 6)
+        self.assertEqual(d.pop(1), 2)
+        self.assertEqual(list(d), [3])
+        with self.assertRaisesRegex(TypeError, "bad key 'str'"):
+            d["a"] = 1
+        with self.assertRaisesRegex(OverflowError, "value out of range"):
+            d[1] = 2**64
+        for i in range(100):
+            d[i] = -i
+        self.assertEqual(
+            d.items(), [(3, -3)] + [(i, -i) for i in range(100) if i != 3]
+        )
+
+    def test_checked_prim_dict_runtime_bad_args(self) -> None:
+        with self.assertRaisesRegex(TypeError, "chkprimdict keys and values"):
+            chkprimdict[str, int64]
+
+    def test_checked_prim_dict_bad_args(self) -> None:
+        codestr = """
+        from __static__ import CheckedPrimDict, int64
+
+        def testfunc() -> None:
+            d = CheckedPrimDict[str, int64]()
+        """
+        self.type_error(
+            codestr, r"CheckedPrimDict keys and values must be primitive"
+        )
+
+    def test_checked_dict_of_primitives_is_chkdict(self) -> None:
+        # chkprimdict is only used when asked for by name, CheckedDict keeps
+        # meaning the dict subclass.
+        codestr = """
+        from __static__ import CheckedDict, int64
+
+        def testfunc(d: CheckedDict[int64, int64]) -> None:
+            reveal_type(d)
+        """
+        self.type_error(codestr, r"reveal_type\(d\): '.*chkdict\[int64, int64\]")
+        self.assertTrue(issubclass(chkdict[int64, int64], dict))
@@ -10,7 +10,7 @@ import cinderx.jit
 from cinderx import cached_property
 from cinderx.test_support import passIf
 
-from .common import StaticTestBase
+from .common import disable_hir_inliner, StaticTestBase
 
 
 class InvokeTests(StaticTestBase):
@@ -789,6 +789,138 @@ class InvokeTests(StaticTestBase):
             d = D()
             self.assertEqual(43, mod.x(d, mutate))
 
+    def test_invoke_devirtualized_subclass_override(self) -> None:
+        codestr = """
+            class C:
+                def f(self) -> int:
+                    return 1
+
+            def x(c: C) -> int:
+                return c.f()
+        """
+
+        with self.in_module(codestr) as mod:
+            c = mod.C()
+            self.assertEqual(mod.x(c), 1)
+            self.assert_jitted(mod.x)
+
+            # Compiled while nothing overrode C.f.
+            class D(mod.C):
+                def f(self) -> int:
+                    return 2
+
+            self.assertEqual(mod.x(D()), 2)
+            self.assertEqual(mod.x(c), 1)
+
+    def test_invoke_devirtualized_patched(self) -> None:
+        codestr = """
+            class C:
+                def f(self) -> int:
+                    return 1
+
+            def x(c: C) -> int:
+                return c.f()
+        """
+
+        with self.in_module(codestr) as mod:
+            c = mod.C()
+            self.assertEqual(mod.x(c), 1)
+            self.assert_jitted(mod.x)
+
+            mod.C.f = lambda self: 3
+            self.assertEqual(mod.x(c), 3)
+
+    def test_invoke_devirtualized_patched_on_unused_subclass(self) -> None:
+        codestr = """
+            class C:
+                def f(self) -> int:
+                    return 1
+
+            class D(C):
+                pass
+
+            def x(c: C) -> int:
+                return c.f()
+        """
+
+        with self.in_module(codestr) as mod:
+            c = mod.C()
+            self.assertEqual(mod.x(c), 1)
+            self.assert_jitted(mod.x)
+
+            # D hasn't been used yet, so its vtable may not have been built
+            # when the override lands.
+            mod.D.f = lambda self: 3
+            self.assertEqual(mod.x(mod.D()), 3)
+            self.assertEqual(mod.x(c), 1)
+
+    def test_invoke_devirtualized_overriding_method_redefined(self) -> None:
+        codestr = """
+            class C:
+                def f(self) -> int:
+                    return 1
+
+            class D(C):
+                def f(self) -> int:
+                    return 2
+
+            def x(d: D) -> int:
+                return d.f()
+        """
+
+        with self.in_module(codestr) as mod:
+            d = mod.D()
+            self.assertEqual(mod.x(d), 2)
+            self.assert_jitted(mod.x)
+
+            # Compiled to call D.f directly, since nothing overrides it.
+            mod.D.f = lambda self: 3
+            self.assertEqual(mod.x(d), 3)
+
+            del mod.D.f
+            self.assertEqual(mod.x(d), 1)
+
+    @passIf(not cinderx.jit.is_enabled(), "Test uses the JIT")
+    @disable_hir_inliner
+    def test_invoke_function_follows_recompiled_callee(self) -> None:
+        codestr = """
+            from __static__ import box, int64
+
+            def callee(a: int64, b: int64) -> int64:
+                return a * 10 + b
+
+            def caller(a: int64, b: int64) -> int:
+                return box(callee(a, b) + callee(b, a))
+        """
+
+        with self.in_module(codestr) as mod:
+            callee, caller = mod.callee, mod.caller
+            self.assertTrue(cinderx.jit.force_compile(callee))
+            self.assertTrue(cinderx.jit.force_compile(caller))
+            self.assertEqual(caller(1, 2), 33)
+
+            def assert_patched(expected: bool) -> None:
+                calls = cinderx.jit.get_compiled_direct_calls(caller)
+                self.assertIsNotNone(calls)
+                # Platforms without direct static calls keep calling through
+                # the entry cache, which the results below still exercise.
+                if calls["sites"] != 0:
+                    patched = calls["sites"] if expected else 0
+                    self.assertEqual(calls["patched"], patched)
+
+            assert_patched(True)
+
+            # Uncompiling the callee sends the caller back through the entry
+            # cache, which must no longer point at the freed static entry.
+            self.assertTrue(cinderx.jit.force_uncompile(callee))
+            assert_patched(False)
+            self.assertEqual(caller(1, 2), 33)
+            self.assertEqual(caller(3, 4), 77)
+
+            self.assertTrue(cinderx.jit.force_compile(callee))
+            assert_patched(True)
+            self.assertEqual(caller(1, 2), 33)
+
     def test_async_coroutine_call_with_cls(self) -> None:
         codestr = """
             from __static__ import int64, box
@@ -662,6 +662,33 @@ class PrimitivesTests(StaticTestBase):
                 f = self.run_code(codestr)["f"]
                 self.assertEqual(f(), res, f"{type} {x} {y} {res}")
 
+    def test_int_ops_compact_boundary(self):
+        # Small ints are read straight out of compact longs, larger ones go
+        # through the generic conversion; mixing them must give the same
+        # results.
+        tests = [
+            ("int64", "+", (1 << 30) - 1, 1, 1 << 30),
+            ("int64", "-", -(1 << 30), 1 << 30, -(1 << 31)),
+            ("int64", "*", 1 << 30, 1 << 30, 1 << 60),
+            ("int64", "//", -(1 << 40), 1 << 10, -(1 << 30)),
+            ("int64", "<", (1 << 30) - 1, 1 << 30, True),
+            ("int64", ">", -(1 << 30), -(1 << 30) - 1, True),
+            ("uint64", ">", 1 << 63, 1, True),
+            ("uint64", ">>", 1 << 63, 33, 1 << 30),
+        ]
+        for type, op, x, y, res in tests:
+            codestr = f"""
+            from __static__ import {type}, box
+            def testfunc():
+                x: {type} = {x}
+                y: {type} = {y}
+                return box(x {op} y)
+            """
+            with self.subTest(type=type, op=op, x=x, y=y):
+                f = self.run_code(codestr)["testfunc"]
+                for _ in range(100):
+                    self.assertEqual(f(), res)
+
     def test_int_unary(self):
         tests = [
             ("int8", "-", 1, -1),
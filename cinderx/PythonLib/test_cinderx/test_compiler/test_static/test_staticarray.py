@@ -2,6 +2,8 @@
 
 # pyre-strict
 
+from __static__ import cbool, double, int32, int64, int8, uint8
+
 from cinderx import static
 
 from .common import StaticTestBase
@@ -101,3 +103,95 @@ class StaticArrayTests(StaticTestBase):
         b[0] = 888
         d = b * 4
         self.assertEqual(list(d), [888] * 4)
+
+    def test_element_types(self) -> None:
+        self.assertIs(static.staticarray[int64], static.staticarray)
+        a = static.staticarray[int8](3)
+        self.assertIsNot(type(a), static.staticarray)
+        self.assertEqual(repr(a), "staticarray[int8][3]([0, 0, 0])")
+
+        a[0] = -128
+        a[2] = 127
+        self.assertEqual(list(a), [-128, 0, 127])
+        with self.assertRaises(OverflowError):
+            a[1] = 128
+
+        u = static.staticarray[uint8](1)
+        with self.assertRaises(OverflowError):
+            u[0] = -1
+
+        d = static.staticarray[double](2)
+        d[0] = 1.5
+        d[1] = 2
+        self.assertEqual(list(d), [1.5, 2.0])
+
+        b = static.staticarray[cbool](2)
+        b[1] = True
+        self.assertEqual(list(b), [False, True])
+        with self.assertRaises(TypeError):
+            # pyre-ignore[6]: Intentional type error, checking runtime behavior.
+            b[0] = 1
+
+    def test_delete_element(self) -> None:
+        for elem in (int64, int8, uint8, double, cbool):
+            a = static.staticarray[elem](2)
+            with self.assertRaisesRegex(TypeError, "cannot delete array elements"):
+                del a[0]
+            self.assertEqual(len(a), 2)
+
+    def test_element_type_concat(self) -> None:
+        a = static.staticarray[int32](2)
+        a[1] = 7
+        c = a + a
+        self.assertIs(type(c), type(a))
+        self.assertEqual(list(c), [0, 7, 0, 7])
+        with self.assertRaises(TypeError):
+            a + static.staticarray(2)
+
+    def test_reductions(self) -> None:
+        a = static.staticarray[int32](4)
+        a.fill(3)
+        a[2] = -5
+        self.assertEqual(a.sum(), 4)
+        self.assertEqual(a.min(), -5)
+        self.assertEqual(a.max(), 3)
+
+        d = static.staticarray[double](3)
+        d.fill(0.5)
+        self.assertEqual(d.sum(), 1.5)
+
+        with self.assertRaises(ValueError):
+            static.staticarray[double](0).min()
+
+    def test_elementwise_ops(self) -> None:
+        a = static.staticarray[int32](3)
+        b = static.staticarray[int32](3)
+        for i in range(3):
+            a[i] = i
+            b[i] = 10
+        a.add(b)
+        self.assertEqual(list(a), [10, 11, 12])
+        a.sub(1)
+        self.assertEqual(list(a), [9, 10, 11])
+        a.mul(2)
+        self.assertEqual(list(a), [18, 20, 22])
+
+        with self.assertRaisesRegex(ValueError, "sizes differ"):
+            a.add(static.staticarray[int32](2))
+
+        # Integer arithmetic wraps around like the primitive operations.
+        c = static.staticarray[int8](1)
+        c[0] = 127
+        c.add(1)
+        self.assertEqual(c[0], -128)
+
+        with self.assertRaises(TypeError):
+            static.staticarray[cbool](1).add(True)
+
+    def test_copy(self) -> None:
+        a = static.staticarray[double](2)
+        a[0] = 1.25
+        b = a.copy()
+        a[0] = 0.0
+        self.assertIs(type(b), type(a))
+        self.assertEqual(list(b), [1.25, 0.0])
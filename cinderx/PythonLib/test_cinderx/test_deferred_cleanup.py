@@ -19,9 +19,8 @@ from cinderx.test_support import (
 
 # Each subprocess must use the allocator that actually unmaps freed code
 # (CodeAllocator) rather than the huge-pages allocator (CodeAllocatorCinder)
-# whose releaseCode() is a no-op.  Without this, freeing deferred code would
-# never reclaim memory and a use-after-free would not crash, defeating the
-# point of these tests.
+# which keeps freed code mapped until it's reused.  Without this, a
+# use-after-free would not crash, defeating the point of these tests.
 _HUGE_PAGES_OFF: dict[str, str] = {
     **subprocess_env(),
     "CINDERX_JIT_HUGE_PAGES": "0",
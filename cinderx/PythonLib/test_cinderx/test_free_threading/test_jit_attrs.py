@@ -0,0 +1,166 @@
+# Copyright (c) Meta Platforms, Inc. and affiliates.
+
+# pyre-strict
+
+"""Free-threaded JIT regression tests for attribute inline caches."""
+
+import threading
+import unittest
+from collections.abc import Callable
+from concurrent.futures import ThreadPoolExecutor
+
+import cinderx.jit
+from cinderx.test_support import run_in_subprocess
+
+
+class JITAttrCacheTest(unittest.TestCase):
+    """Exercises attribute caches filled and invalidated by concurrent threads."""
+
+    def assert_has_opcodes(self, func: Callable[..., object], *opcodes: str) -> None:
+        self.assertTrue(cinderx.jit.force_compile(func))
+        opcode_counts = cinderx.jit.get_function_hir_opcode_counts(func)
+        if opcode_counts is None:
+            self.fail(f"No HIR opcode counts for compiled {func.__name__}")
+        for opcode in opcodes:
+            self.assertIn(opcode, opcode_counts)
+
+    def run_workers(
+        self,
+        reader: Callable[[], bool],
+        writer: Callable[[str], None],
+        reader_count: int,
+        writer_count: int,
+    ) -> None:
+        with ThreadPoolExecutor(max_workers=reader_count + writer_count) as executor:
+            reader_futures = [executor.submit(reader) for _ in range(reader_count)]
+            writer_futures = [
+                executor.submit(writer, str(worker)) for worker in range(writer_count)
+            ]
+
+            self.assertEqual(
+                [future.result() for future in reader_futures],
+                [True] * reader_count,
+            )
+            for future in writer_futures:
+                future.result()
+
+    @run_in_subprocess
+    def test_concurrent_load_store_attr(self) -> None:
+        """Instance attribute caches stay correct while their type changes."""
+
+        class C:
+            def __init__(self) -> None:
+                self.x = "w"
+
+        objs = [C() for _ in range(4)]
+        worker_count = 10
+        reader_count = worker_count // 2
+        writer_count = worker_count - reader_count
+        iterations = 10_000
+        start = threading.Barrier(worker_count)
+
+        def load_x(o: C) -> str:
+            return o.x
+
+        def store_x(o: C, value: str) -> None:
+            o.x = value
+
+        self.assert_has_opcodes(load_x, "LoadAttrCached")
+        self.assert_has_opcodes(store_x, "StoreAttrCached")
+
+        @cinderx.jit.jit_suppress
+        def reader() -> bool:
+            start.wait()
+            for i in range(iterations):
+                if not load_x(objs[i % len(objs)]).startswith("w"):
+                    return False
+            return True
+
+        @cinderx.jit.jit_suppress
+        def writer(prefix: str) -> None:
+            start.wait()
+            for i in range(iterations):
+                store_x(objs[i % len(objs)], f"w{prefix}_{i}")
+                if i % 100 == 0:
+                    # Modifying the type invalidates the entries for it.
+                    C.unrelated = i
+
+        self.run_workers(reader, writer, reader_count, writer_count)
+        for o in objs:
+            self.assertTrue(o.x.startswith("w"))
+
+    @run_in_subprocess
+    def test_concurrent_load_method(self) -> None:
+        """Cached methods must stay alive while other threads replace them."""
+
+        class C:
+            def method(self) -> str:
+                return "w"
+
+        obj = C()
+        worker_count = 10
+        reader_count = worker_count // 2
+        writer_count = worker_count - reader_count
+        iterations = 10_000
+        start = threading.Barrier(worker_count)
+
+        def call_method(o: C) -> str:
+            return o.method()
+
+        self.assert_has_opcodes(call_method, "LoadMethodCached")
+
+        @cinderx.jit.jit_suppress
+        def reader() -> bool:
+            start.wait()
+            for _ in range(iterations):
+                if not call_method(obj).startswith("w"):
+                    return False
+            return True
+
+        @cinderx.jit.jit_suppress
+        def writer(prefix: str) -> None:
+            start.wait()
+            for i in range(iterations // 10):
+                # A fresh function each time, so that the only reference to the
+                # old one is the one held by the cache.
+                result = f"w{prefix}_{i}"
+                C.method = lambda self, result=result: result
+
+        self.run_workers(reader, writer, reader_count, writer_count)
+        self.assertTrue(obj.method().startswith("w"))
+
+    @run_in_subprocess
+    def test_concurrent_load_type_attr(self) -> None:
+        """Type attribute caches stay correct while the attribute is replaced."""
+
+        class C:
+            value = "w"
+
+        worker_count = 10
+        reader_count = worker_count // 2
+        writer_count = worker_count - reader_count
+        iterations = 10_000
+        start = threading.Barrier(worker_count)
+
+        def load_value(tp: type[C]) -> str:
+            return tp.value
+
+        self.assertTrue(cinderx.jit.force_compile(load_value))
+
+        @cinderx.jit.jit_suppress
+        def reader() -> bool:
+            start.wait()
+            for _ in range(iterations):
+                if not load_value(C).startswith("w"):
+                    return False
+            return True
+
+        @cinderx.jit.jit_suppress
+        def writer(prefix: str) -> None:
+            start.wait()
+            for i in range(iterations // 10):
+                C.value = f"w{prefix}_{i}"
+
+        self.run_workers(reader, writer, reader_count, writer_count)
+        self.assertTrue(C.value.startswith("w"))
+
@@ -0,0 +1,86 @@
+# Copyright (c) Meta Platforms, Inc. and affiliates.
+
+# pyre-strict
+
+"""Free-threaded JIT regression tests for the per-thread generator pools."""
+
+import threading
+import unittest
+from collections.abc import Generator
+from concurrent.futures import ThreadPoolExecutor
+
+import cinderx.jit
+from cinderx.test_support import FREE_THREADING_BUILD, passUnless, run_in_subprocess
+
+
+def gen(n: int) -> Generator[int, None, None]:
+    for i in range(n):
+        yield i
+
+
+class JITGeneratorPoolTest(unittest.TestCase):
+    """Exercises generators allocated and freed on different threads."""
+
+    @run_in_subprocess
+    def test_concurrent_create_and_free(self) -> None:
+        """Threads churning through generators get them from their own pools."""
+        self.assertTrue(cinderx.jit.force_compile(gen))
+        worker_count = 8
+        iterations = 10_000
+        start = threading.Barrier(worker_count)
+
+        @cinderx.jit.jit_suppress
+        def worker() -> bool:
+            start.wait()
+            for i in range(iterations):
+                if sum(gen(i % 5)) != sum(range(i % 5)):
+                    return False
+            return True
+
+        with ThreadPoolExecutor(max_workers=worker_count) as executor:
+            futures = [executor.submit(worker) for _ in range(worker_count)]
+            self.assertEqual(
+                [future.result() for future in futures], [True] * worker_count
+            )
+
+    @passUnless(FREE_THREADING_BUILD, "requires free-threaded build")
+    @run_in_subprocess
+    def test_free_on_other_thread(self) -> None:
+        """Generators freed by another thread are handed back to their pool."""
+        self.assertTrue(cinderx.jit.force_compile(gen))
+        batch_size = 100
+        batches = 100
+        before = cinderx.jit.get_generator_pool_stats()
+        assert before is not None
+
+        handoff = threading.Barrier(2)
+
+        @cinderx.jit.jit_suppress
+        def consume(gens: list[Generator[int, None, None]]) -> bool:
+            mine = list(gens)
+            # With biased reference counting an object is deallocated by the
+            # thread that created it, unless that thread drops its references
+            # while another thread still has some.
+            handoff.wait()
+            handoff.wait()
+            result = all(sum(g) == 3 for g in mine)
+            mine.clear()
+            return result
+
+        with ThreadPoolExecutor(max_workers=1) as executor:
+            for _ in range(batches):
+                gens = [gen(3) for _ in range(batch_size)]
+                future = executor.submit(consume, gens)
+                handoff.wait()
+                gens.clear()
+                handoff.wait()
+                self.assertTrue(future.result())
+
+        after = cinderx.jit.get_generator_pool_stats()
+        assert after is not None
+        self.assertGreaterEqual(
+            after["remote_frees"] - before["remote_frees"], batch_size * batches
+        )
+        # The generators handed back by the consumer are reused by later
+        # batches.
+        self.assertGreater(after["hits"] - before["hits"], batch_size)
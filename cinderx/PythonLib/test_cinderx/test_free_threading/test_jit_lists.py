@@ -2,7 +2,7 @@
 
 # pyre-strict
 
-"""Free-threaded JIT regression tests for list subscripts."""
+"""Free-threaded JIT regression tests for list subscripts and unpacking."""
 
 import dis
 import threading
@@ -33,6 +33,7 @@ class JITListTest(unittest.TestCase):
     def exercise_concurrent_access(
         self,
         read_item: Callable[[list[str]], str],
+        store_item: Callable[[list[str], str], None] | None = None,
     ) -> None:
         worker_count = 10
         reader_count = worker_count // 2
@@ -53,7 +54,11 @@ class JITListTest(unittest.TestCase):
         def writer(prefix: str) -> None:
             start.wait()
             for i in range(iterations):
-                values[0] = f"w{prefix}_{i}"
+                value = f"w{prefix}_{i}"
+                if store_item is None:
+                    values[0] = value
+                else:
+                    store_item(values, value)
 
         with ThreadPoolExecutor(max_workers=worker_count) as executor:
             reader_futures = [executor.submit(reader) for _ in range(reader_count)]
@@ -109,3 +114,78 @@ class JITListTest(unittest.TestCase):
         self.assertNotIn("LoadArrayItem", opcode_counts)
 
         self.exercise_concurrent_access(read_item)
+
+    @passUnless(FREE_THREADING_BUILD, "requires free-threaded build")
+    @run_in_subprocess
+    def test_concurrent_store_subscript(self) -> None:
+        """Item stores to exact lists must not lose or leak values."""
+        cinderx.jit.enable_specialized_opcodes()
+
+        def store_item(values: list[str], value: str) -> None:
+            values[0] = value
+
+        cinderx.jit.jit_suppress(store_item)
+        for _ in range(100):
+            store_item(["w"], "w")
+        cinderx.jit.jit_unsuppress(store_item)
+
+        self.assertTrue(cinderx.jit.force_compile(store_item))
+        opcode_counts = cinderx.jit.get_function_hir_opcode_counts(store_item)
+        if opcode_counts is None:
+            self.fail("No HIR opcode counts for compiled store_item")
+        self.assertIn("StoreSubscr", opcode_counts)
+        self.assertNotIn("StoreArrayItem", opcode_counts)
+
+        def read_item(values: list[str]) -> str:
+            return values[0]
+
+        cinderx.jit.jit_suppress(read_item)
+        self.exercise_concurrent_access(read_item, store_item)
+
+    @passUnless(FREE_THREADING_BUILD, "requires free-threaded build")
+    @run_in_subprocess
+    def test_concurrent_unpack(self) -> None:
+        """Unpacking an exact list sees whole items while they're replaced."""
+        cinderx.jit.enable_specialized_opcodes()
+
+        def unpack(values: list[str]) -> str:
+            first, second = values
+            return first + second
+
+        self.assertTrue(cinderx.jit.force_compile(unpack))
+        worker_count = 10
+        reader_count = worker_count // 2
+        writer_count = worker_count - reader_count
+        iterations = 10_000
+        start = threading.Barrier(worker_count)
+        values = ["w", "w"]
+
+        @cinderx.jit.jit_suppress
+        def reader() -> bool:
+            start.wait()
+            for _ in range(iterations):
+                if unpack(values).count("w") != 2:
+                    return False
+            return True
+
+        @cinderx.jit.jit_suppress
+        def writer(prefix: str) -> None:
+            start.wait()
+            for i in range(iterations):
+                values[i % 2] = f"w{prefix}_{i}"
+
+        with ThreadPoolExecutor(max_workers=worker_count) as executor:
+            reader_futures = [executor.submit(reader) for _ in range(reader_count)]
+            writer_futures = [
+                executor.submit(writer, str(worker)) for worker in range(writer_count)
+            ]
+
+            self.assertEqual(
+                [future.result() for future in reader_futures],
+                [True] * reader_count,
+            )
+            for future in writer_futures:
+                future.result()
+
+        with self.assertRaisesRegex(ValueError, "too many values to unpack"):
+            unpack(["w", "w", "w"])
@@ -274,3 +274,95 @@ class ImmortalizeTests(unittest.TestCase):
         self.assertTrue(cinderx.is_immortal(holder))
         self.assertTrue(cinderx.is_immortal(target.__code__))
         self.assertTrue(cinderx.is_immortal(qualname))
+
+    @run_in_subprocess
+    def test_immortalize_heap_stats(self) -> None:
+        holder = [object() for _ in range(100)]
+
+        stats = cinderx.immortalize_heap()
+
+        self.assertTrue(cinderx.is_immortal(holder))
+        self.assertGreaterEqual(stats["objects"], len(holder) + 1)
+        self.assertGreater(stats["bytes"], 0)
+
+    @run_in_subprocess
+    def test_immortalize_heap_parallel(self) -> None:
+        mapping = {i: [object()] for i in range(1000)}
+        holder = [mapping]
+
+        stats = cinderx.immortalize_heap(num_threads=4)
+
+        self.assertTrue(cinderx.is_immortal(holder))
+        self.assertTrue(cinderx.is_immortal(mapping))
+        for value in mapping.values():
+            self.assertTrue(cinderx.is_immortal(value))
+            self.assertTrue(cinderx.is_immortal(value[0]))
+        self.assertGreaterEqual(stats["objects"], 2 * len(mapping))
+
+    @run_in_subprocess
+    def test_immortalize_heap_exclude_types(self) -> None:
+        class Cache(dict):
+            pass
+
+        cache = Cache(key=[1, 2, 3])
+        kept = [cache]
+
+        cinderx.immortalize_heap(exclude_types=(Cache,))
+
+        self.assertTrue(cinderx.is_immortal(kept))
+        self.assertFalse(cinderx.is_immortal(cache))
+
+    @run_in_subprocess
+    def test_immortalize_heap_exclude_keeps_contents_mortal(self) -> None:
+        class Cache(dict):
+            pass
+
+        # Only the cache refers to its entries, apart from `shared`.
+        shared = [object()]
+        cache = Cache(nested={"entry": [[object()]]}, shared=shared)
+        kept = [cache, shared]
+
+        cinderx.immortalize_heap(exclude_types=(Cache,))
+
+        self.assertTrue(cinderx.is_immortal(kept))
+        self.assertFalse(cinderx.is_immortal(cache))
+        # Only reachable through the excluded cache.
+        nested = cache["nested"]
+        entry = nested["entry"][0]
+        self.assertFalse(cinderx.is_immortal(nested))
+        self.assertFalse(cinderx.is_immortal(nested["entry"]))
+        self.assertFalse(cinderx.is_immortal(entry))
+        self.assertFalse(cinderx.is_immortal(entry[0]))
+        # Also reachable from an object that isn't excluded.
+        self.assertTrue(cinderx.is_immortal(shared))
+        self.assertTrue(cinderx.is_immortal(shared[0]))
+
+    @run_in_subprocess
+    def test_immortalize_heap_exclude_modules(self) -> None:
+        class Local:
+            pass
+
+        instance = Local()
+        kept = [instance]
+
+        cinderx.immortalize_heap(exclude_modules=[Local.__module__])
+
+        self.assertTrue(cinderx.is_immortal(kept))
+        self.assertFalse(cinderx.is_immortal(Local))
+        self.assertFalse(cinderx.is_immortal(instance))
+
+    @run_in_subprocess
+    def test_immortalize_heap_predicate(self) -> None:
+        mortal = []
+        immortal = []
+
+        cinderx.immortalize_heap(predicate=lambda obj: obj is not mortal)
+
+        self.assertFalse(cinderx.is_immortal(mortal))
+        self.assertTrue(cinderx.is_immortal(immortal))
+
+    def test_immortalize_heap_invalid_args(self) -> None:
+        with self.assertRaises(ValueError):
+            cinderx.immortalize_heap(num_threads=-1)
+        with self.assertRaises(TypeError):
+            cinderx.immortalize_heap(predicate=1)
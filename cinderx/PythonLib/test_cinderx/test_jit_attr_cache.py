@@ -930,12 +930,12 @@ LEAF_SOURCE = """
 @skip_if_prefork("the compiled function shows up as a leak due to immortalization")
 class ModuleAttrPinTests(unittest.TestCase):
     """The JIT resolves a module attribute at compile time and pins it with a
-    GuardIs when the value is a module or a type.  Rebinding such an attribute
-    has to deopt and re-execute the LOAD_ATTR in the interpreter, which only
-    works if the deopt's FrameState still holds the module receiver on the
-    operand stack.  Before T284563326 was fixed the receiver was missing, so
-    the interpreter read the stack slot underneath it: a segfault with nothing
-    below, a wrong receiver otherwise.
+    GuardIs when the value is a module, a type, or frozen by immortalize_heap.
+    Rebinding such an attribute has to deopt and re-execute the LOAD_ATTR in
+    the interpreter, which only works if the deopt's FrameState still holds the
+    module receiver on the operand stack.  Before T284563326 was fixed the
+    receiver was missing, so the interpreter read the stack slot underneath it:
+    a segfault with nothing below, a wrong receiver otherwise.
     """
 
     def _import(self, tmp, name, source):
@@ -1125,6 +1125,117 @@ class ModuleAttrPinTests(unittest.TestCase):
             with self.assertRaises(AttributeError):
                 user.load()
 
+    def test_rebind_immortal_valued_attr(self):
+        """None, bools, and small ints are immortal, but they're what flags
+        and counters get rebound to.  They are left to the runtime cache, so
+        rebinding them doesn't deopt."""
+        with cinder_support.temp_sys_path() as tmp:
+            leaf = self._import(tmp, "pin_leaf", "attr = None\n")
+            user = self._import(
+                tmp,
+                "pin_user",
+                """
+                import pin_leaf
+
+                def load():
+                    return pin_leaf.attr
+                """,
+            )
+            cinderx.jit.force_compile(user.load)
+            self.assertTrue(cinderx.jit.is_jit_compiled(user.load))
+            counts = cinderx.jit.get_function_hir_opcode_counts(user.load)
+            # Only the module global is pinned.
+            self.assertEqual(counts.get("GuardIs", 0), 1)
+            self.assertIsNone(user.load())
+
+            cinderx.jit.get_and_clear_runtime_stats()
+            for i in range(100):
+                leaf.attr = i
+                self.assertEqual(user.load(), i)
+                leaf.attr = bool(i % 2)
+                self.assertIs(user.load(), bool(i % 2))
+            self.assertEqual(self._guard_deopts("load"), 0)
+
+    def test_rebind_immortal_valued_type_attr(self):
+        """The same goes for immortal class attributes of a pinned type."""
+        with cinder_support.temp_sys_path() as tmp:
+            leaf = self._import(
+                tmp,
+                "pin_leaf",
+                """
+                class Klass:
+                    n = 0
+                """,
+            )
+            user = self._import(
+                tmp,
+                "pin_user",
+                """
+                import pin_leaf
+
+                def load():
+                    return pin_leaf.Klass.n
+                """,
+            )
+            cinderx.jit.force_compile(user.load)
+            # The module global and Klass are pinned, Klass.n isn't.
+            self._assert_attr_pinned(user.load)
+            counts = cinderx.jit.get_function_hir_opcode_counts(user.load)
+            self.assertEqual(counts.get("GuardIs", 0), 2)
+            self.assertEqual(user.load(), 0)
+
+            cinderx.jit.get_and_clear_runtime_stats()
+            for i in range(100):
+                leaf.Klass.n += 1
+                self.assertEqual(user.load(), i + 1)
+            self.assertEqual(self._guard_deopts("load"), 0)
+
+    @skip_if_ft("T251571267: Free threading doesn't support heap immortalization")
+    @cinder_support.run_in_subprocess
+    def test_rebind_frozen_attr(self):
+        """A value frozen by immortalize_heap is pinned.  Rebinding the
+        attribute deopts once, and then the function is compiled again without
+        the pin rather than deopting on every call."""
+        with cinder_support.temp_sys_path() as tmp:
+            leaf = self._import(
+                tmp,
+                "pin_leaf",
+                """
+                class Config:
+                    pass
+
+                attr = Config()
+                """,
+            )
+            user = self._import(
+                tmp,
+                "pin_user",
+                """
+                import pin_leaf
+
+                def load():
+                    return pin_leaf.attr
+                """,
+            )
+            cinderx.immortalize_heap()
+            cinderx.jit.force_compile(user.load)
+            self._assert_attr_pinned(user.load)
+            self.assertIs(user.load(), leaf.attr)
+
+            cinderx.jit.get_and_clear_runtime_stats()
+            value = leaf.Config()
+            leaf.attr = value
+            self.assertIs(user.load(), value)
+            self.assertEqual(self._guard_deopts("load"), 1)
+
+            for _ in range(100):
+                self.assertIs(user.load(), value)
+            self.assertEqual(self._guard_deopts("load"), 0)
+            # Only the module global is still pinned.
+            self.assertTrue(cinderx.jit.is_jit_compiled(user.load))
+            counts = cinderx.jit.get_function_hir_opcode_counts(user.load)
+            self.assertEqual(counts.get("GuardIs", 0), 1)
+
 
 @cinder_support.failUnlessJITCompiled
 @failUnlessHasOpcodes("LOAD_ATTR")
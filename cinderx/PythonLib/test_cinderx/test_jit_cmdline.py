@@ -532,6 +532,43 @@ class CmdLineTest(unittest.TestCase):
                 check,
             )
 
+    # Generator pool options.
+
+    def test_gen_pool_classes(self) -> None:
+        source = textwrap.dedent(
+            f"""\
+            import cinderx.jit as jit
+
+            stats = jit.get_generator_pool_stats()
+            print("CLASSES", [c["size"] for c in stats["classes"]])
+            print({_OK!r})
+            """
+        )
+        args = ["-X", "jit-all", "-c", source]
+
+        def check(proc: subprocess.CompletedProcess[str]) -> None:
+            self._assert_ok(proc)
+            self.assertIn("CLASSES [128, 1024]", proc.stdout)
+
+        self._check_both_forms(
+            "cinderx-jit-gen-pool-classes=128:64,1024:8:2",
+            "CINDERX_JIT_GEN_POOL_CLASSES=128:64,1024:8:2",
+            args,
+            check,
+        )
+
+        def check_invalid(proc: subprocess.CompletedProcess[str]) -> None:
+            self.assertNotEqual(proc.returncode, 0)
+            self.assertIn("cinderx-jit-gen-pool-classes", proc.stderr)
+
+        # Sizes have to be in increasing order.
+        self._check_both_forms(
+            "cinderx-jit-gen-pool-classes=1024:8,128:64",
+            "CINDERX_JIT_GEN_POOL_CLASSES=1024:8,128:64",
+            args,
+            check_invalid,
+        )
+
     # Help.
 
     def test_help(self) -> None:
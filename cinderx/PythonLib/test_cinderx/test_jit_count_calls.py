@@ -2,12 +2,18 @@
 
 # pyre-strict
 
+import threading
 import unittest
 
 import cinderx
 import cinderx.jit
 from cinderx.jit import count_interpreted_calls
-from cinderx.test_support import no_background_compile, passIf, passUnless
+from cinderx.test_support import (
+    FREE_THREADING_BUILD,
+    no_background_compile,
+    passIf,
+    passUnless,
+)
 
 
 # Defined here because pyre is limited to typing constants in decorators.
@@ -72,3 +78,35 @@ class CountCallsTest(unittest.TestCase):
                 # immediately.
                 self.assertEqual(count_interpreted_calls(func), 0)
                 func()
+
+    @passUnless(INIT, "Call counts need the CinderX interpreter")
+    @passUnless(FREE_THREADING_BUILD, "requires free-threaded build")
+    def test_concurrent_calls(self) -> None:
+        @cinderx.jit.jit_suppress
+        def func() -> int:
+            return 15
+
+        @cinderx.jit.jit_suppress
+        def call_func(n: int) -> None:
+            for _ in range(n):
+                func()
+
+        # The first calls are counted exactly.
+        call_func(1000)
+        self.assertEqual(count_interpreted_calls(func), 1000)
+
+        # Past that, hot functions are sampled, so the count is approximate.
+        worker_count = 8
+        calls_per_worker = 50_000
+        threads = [
+            threading.Thread(target=call_func, args=(calls_per_worker,))
+            for _ in range(worker_count)
+        ]
+        for thread in threads:
+            thread.start()
+        for thread in threads:
+            thread.join()
+        expected = 1000 + worker_count * calls_per_worker
+        self.assertAlmostEqual(
+            count_interpreted_calls(func), expected, delta=expected // 10
+        )
@@ -7,6 +7,7 @@
 #include <cstddef>
 #include <cstdint>
 #include <limits>
+#include <memory>
 #include <vector>
 
 using namespace cinderx;
@@ -115,4 +116,28 @@ TEST(BumpArenaTest, DestroyRunsNonTrivialDestructorsInReverseOrder) {
   EXPECT_EQ(destroyed, expected);
 }
 
+TEST(BumpArenaTest, BackedArenasShareHugePageArena) {
+  auto backing = std::make_shared<HugePageArena>();
+  std::vector<int> destroyed;
+  {
+    BumpArena a{backing};
+    BumpArena b{backing};
+    int* x = a.allocate<int>(1);
+    int* y = b.allocate<int>(2);
+    b.allocate<DestructionRecord>(3, &destroyed);
+
+    EXPECT_EQ(*x, 1);
+    EXPECT_EQ(*y, 2);
+    EXPECT_EQ(a.allocatedBytes(), sizeof(int));
+    EXPECT_EQ(
+        backing->allocatedBytes(),
+        2 * sizeof(int) + sizeof(DestructionRecord));
+  }
+
+  // Destructors still run with the arena, but the memory stays with backing.
+  const std::vector<int> expected{3};
+  EXPECT_EQ(destroyed, expected);
+  EXPECT_EQ(backing->reservedBytes(), HugePageArena::kHugePageSize);
+}
+
 } // namespace
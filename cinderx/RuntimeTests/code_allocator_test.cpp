@@ -11,6 +11,7 @@
 #include <cstdint>
 #include <cstring>
 #include <memory>
+#include <vector>
 
 using namespace cinderx::jit;
 using namespace cinderx::jit::codegen;
@@ -40,6 +41,20 @@ const uint8_t* addressAtOffset(const void* base, uintptr_t offset) {
       reinterpret_cast<uintptr_t>(base) + offset);
 }
 
+// Add `size` bytes of hot code, with no cold section.
+AllocateResult addHotCode(ICodeAllocator* allocator, size_t size) {
+  asmjit::CodeHolder code;
+  code.init(allocator->asmJitEnvironment());
+
+  arch::Builder as(&code);
+  std::vector<uint8_t> text(size, 0x90);
+  as.section(code.textSection());
+  as.embed(text.data(), text.size());
+  as.finalize();
+
+  return allocator->addCode(&code);
+}
+
 TEST_F(CodeAllocatorTest, AddSplitCodeCopiesHotAndColdSections) {
   asmjit::CodeHolder code;
   code.init(code_allocator_->asmJitEnvironment());
@@ -89,4 +104,116 @@ TEST_F(CodeAllocatorTest, AddSplitCodeCopiesHotAndColdSections) {
       0);
 }
 
+TEST_F(CodeAllocatorTest, ReleasedCodeIsReused) {
+  AllocateResult first = addHotCode(code_allocator_.get(), 64);
+  ASSERT_EQ(first.error, asmjit::kErrorOk);
+  EXPECT_EQ(code_allocator_->usedBytes(), 64);
+
+  ASSERT_EQ(code_allocator_->releaseCode(first.addr), asmjit::kErrorOk);
+  EXPECT_EQ(code_allocator_->usedBytes(), 0);
+  EXPECT_TRUE(code_allocator_->contains(first.addr));
+
+  AllocateResult second = addHotCode(code_allocator_.get(), 64);
+  ASSERT_EQ(second.error, asmjit::kErrorOk);
+  EXPECT_EQ(second.addr, first.addr);
+}
+
+TEST_F(CodeAllocatorTest, ReleaseRejectsUnknownAddress) {
+  AllocateResult result = addHotCode(code_allocator_.get(), 64);
+  ASSERT_EQ(result.error, asmjit::kErrorOk);
+
+  void* middle = static_cast<uint8_t*>(result.addr) + 16;
+  EXPECT_EQ(
+      code_allocator_->releaseCode(middle), asmjit::kErrorInvalidArgument);
+  ASSERT_EQ(code_allocator_->releaseCode(result.addr), asmjit::kErrorOk);
+  EXPECT_EQ(
+      code_allocator_->releaseCode(result.addr),
+      asmjit::kErrorInvalidArgument);
+}
+
+TEST_F(CodeAllocatorTest, AdjacentFreeExtentsAreMerged) {
+  auto allocator = dynamic_cast<CodeAllocatorCinder*>(code_allocator_.get());
+  ASSERT_NE(allocator, nullptr);
+
+  AllocateResult a = addHotCode(allocator, 64);
+  AllocateResult b = addHotCode(allocator, 64);
+  AllocateResult c = addHotCode(allocator, 64);
+  ASSERT_EQ(a.error, asmjit::kErrorOk);
+  ASSERT_EQ(b.error, asmjit::kErrorOk);
+  ASSERT_EQ(c.error, asmjit::kErrorOk);
+  ASSERT_EQ(b.addr, addressAtOffset(a.addr, 64));
+  ASSERT_EQ(c.addr, addressAtOffset(a.addr, 128));
+  EXPECT_EQ(allocator->stats().free_extents, 1);
+
+  ASSERT_EQ(allocator->releaseCode(b.addr), asmjit::kErrorOk);
+  EXPECT_EQ(allocator->stats().free_extents, 2);
+
+  ASSERT_EQ(allocator->releaseCode(a.addr), asmjit::kErrorOk);
+  EXPECT_EQ(allocator->stats().free_extents, 2);
+
+  ASSERT_EQ(allocator->releaseCode(c.addr), asmjit::kErrorOk);
+  CodeAllocatorCinder::Stats stats = allocator->stats();
+  EXPECT_EQ(stats.free_extents, 1);
+  EXPECT_EQ(stats.free_bytes, stats.reserved_bytes);
+  EXPECT_EQ(stats.largest_free_extent, stats.reserved_bytes);
+  EXPECT_EQ(stats.released_bytes, 192);
+
+  // The merged space is big enough for all three again.
+  AllocateResult d = addHotCode(allocator, 192);
+  ASSERT_EQ(d.error, asmjit::kErrorOk);
+  EXPECT_EQ(d.addr, a.addr);
+}
+
+TEST_F(CodeAllocatorTest, EvacuatingChunksReceiveNoNewCode) {
+  auto allocator = dynamic_cast<CodeAllocatorCinder*>(code_allocator_.get());
+  ASSERT_NE(allocator, nullptr);
+
+  AllocateResult sparse = addHotCode(allocator, 64);
+  ASSERT_EQ(sparse.error, asmjit::kErrorOk);
+
+  // The chunk currently receiving code is never evacuated.
+  EXPECT_EQ(allocator->beginCompaction(1.0), 0);
+  allocator->endCompaction();
+
+  // Too big for what's left of the first chunk, so this maps a second one.
+  constexpr size_t kBigSize = 3 * 1024 * 1024;
+  AllocateResult big = addHotCode(allocator, kBigSize);
+  ASSERT_EQ(big.error, asmjit::kErrorOk);
+  ASSERT_EQ(allocator->stats().chunks, 2);
+
+  EXPECT_EQ(allocator->beginCompaction(0.5), 1);
+  EXPECT_TRUE(allocator->isEvacuating(sparse.addr));
+  EXPECT_FALSE(allocator->isEvacuating(big.addr));
+  EXPECT_EQ(allocator->stats().evacuating_chunks, 1);
+
+  AllocateResult moved = addHotCode(allocator, 64);
+  ASSERT_EQ(moved.error, asmjit::kErrorOk);
+  EXPECT_FALSE(allocator->isEvacuating(moved.addr));
+
+  allocator->endCompaction();
+  EXPECT_FALSE(allocator->isEvacuating(sparse.addr));
+  EXPECT_EQ(allocator->stats().evacuating_chunks, 0);
+}
+
+TEST_F(CodeAllocatorTest, RelinkPlacesCodeBackToBackInFreshChunk) {
+  auto allocator = dynamic_cast<CodeAllocatorCinder*>(code_allocator_.get());
+  ASSERT_NE(allocator, nullptr);
+
+  AllocateResult before = addHotCode(allocator, 64);
+  ASSERT_EQ(before.error, asmjit::kErrorOk);
+  ASSERT_EQ(allocator->stats().chunks, 1);
+
+  allocator->beginRelink();
+  AllocateResult hottest = addHotCode(allocator, 128);
+  AllocateResult next = addHotCode(allocator, 64);
+  allocator->endRelink();
+  ASSERT_EQ(hottest.error, asmjit::kErrorOk);
+  ASSERT_EQ(next.error, asmjit::kErrorOk);
+
+  // The first chunk had plenty of room, but relinked code goes in a new one.
+  EXPECT_EQ(allocator->stats().chunks, 2);
+  EXPECT_NE(hottest.addr, addressAtOffset(before.addr, 64));
+  EXPECT_EQ(next.addr, addressAtOffset(hottest.addr, 128));
+}
+
 } // namespace
@@ -5,6 +5,7 @@
 #include "cinderx/Jit/codegen/gen_asm.h"
 #include "cinderx/Jit/compiler.h"
 #include "cinderx/Jit/context.h"
+#include "cinderx/Jit/direct_call_patcher.h"
 #include "cinderx/Jit/frame.h"
 #include "cinderx/Jit/hir/hir.h"
 #include "cinderx/Jit/hir/printer.h"
@@ -187,3 +188,37 @@ def func():
 
   jit_ctx->clearGuardFailureCallback();
 }
+
+#if defined(CINDER_X86_64)
+TEST_F(CodePatcherTest, DirectCallRetarget) {
+  // A call instruction followed by the fallback it targets, 16 bytes later.
+  alignas(8) std::array<uint8_t, 32> memory{};
+  memory[0] = 0xe8;
+  int32_t fallback_disp = 11;
+  std::memcpy(memory.data() + 1, &fallback_disp, sizeof(fallback_disp));
+  uint8_t* fallback = memory.data() + 16;
+  uint8_t* entry = memory.data() + 24;
+
+  DirectCallPatcher patcher{nullptr};
+  patcher.linkCall(reinterpret_cast<uintptr_t>(memory.data()));
+  EXPECT_TRUE(patcher.isLinked());
+  EXPECT_FALSE(patcher.isPatched());
+  EXPECT_EQ(patcher.callTarget(), fallback);
+
+  EXPECT_TRUE(patcher.retarget(entry));
+  EXPECT_TRUE(patcher.isPatched());
+  EXPECT_EQ(patcher.callTarget(), entry);
+
+  EXPECT_TRUE(patcher.retarget(fallback + 4));
+  EXPECT_EQ(patcher.callTarget(), fallback + 4);
+
+  EXPECT_FALSE(patcher.retarget(nullptr));
+  EXPECT_FALSE(patcher.isPatched());
+  EXPECT_EQ(patcher.callTarget(), fallback);
+
+  // Anything out of range of a rel32 call is left on the fallback.
+  EXPECT_FALSE(patcher.retarget(memory.data() + (int64_t{1} << 32)));
+  EXPECT_FALSE(patcher.isPatched());
+  EXPECT_EQ(patcher.callTarget(), fallback);
+}
+#endif
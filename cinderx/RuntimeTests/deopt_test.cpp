@@ -19,6 +19,7 @@
 #include "cinderx/Jit/compiler.h"
 #include "cinderx/Jit/context.h"
 #include "cinderx/Jit/deopt.h"
+#include "cinderx/Jit/deopt_encoding.h"
 // NOLINTNEXTLINE(facebook-unused-include-check)
 #include "internal/pycore_frame.h"
 
@@ -446,6 +447,8 @@ class DeoptStressTest : public RuntimeTest {
       NativeGenerator gen(irfunc.get(), factory);
       auto jitfunc = reinterpret_cast<vectorcallfunc>(gen.getVectorcallEntry());
       ASSERT_NE(jitfunc, nullptr);
+      // Deopt through the compact encoding, like compiled functions do.
+      gen.codeRuntime()->compactDeoptMetadata();
       ngen_ctx->setGuardFailureCallback(delete_one_deopt);
       auto res =
           jitfunc(reinterpret_cast<PyObject*>(pyfunc), args, nargs, nullptr);
@@ -899,3 +902,124 @@ TEST_F(DeoptTest, ValueKind) {
   EXPECT_EQ(deoptValueKind(TLong), ValueKind::kObject);
   EXPECT_EQ(deoptValueKind(TNullptr), ValueKind::kObject);
 }
+
+namespace {
+
+DeoptMetadata makeEncodingTestMetadata(PyCodeObject* code, int nonce) {
+  DeoptMetadata dm;
+  dm.live_values = {
+      LiveValue{
+          PhyLocation{ARGUMENT_REGS[0].loc},
+          RefKind::kOwned,
+          ValueKind::kObject,
+          LiveValue::Source::kUnknown},
+      LiveValue{
+          PhyLocation{-16, 32},
+          RefKind::kUncounted,
+          ValueKind::kDouble,
+          LiveValue::Source::kUnknown},
+      LiveValue{
+          PhyLocation{ARGUMENT_REGS[1].loc},
+          RefKind::kBorrowed,
+          ValueKind::kObject,
+          LiveValue::Source::kLoadMethod}};
+  dm.reason = DeoptReason::kUnhandledUnboundLocal;
+  dm.descr = "encoding test";
+  dm.eh_name = code->co_name;
+  dm.guilty_value = 1;
+  dm.nonce = nonce;
+
+  DeoptFrameMetadata caller;
+  caller.code = code;
+  caller.localsplus = {0, -1};
+  caller.cause_instr_idx = BCIndex{3};
+  DeoptFrameMetadata callee;
+  callee.code = code;
+  callee.localsplus = {-1, 1, 0};
+  callee.stack = {2, 0};
+  callee.block_stack.push(ExecutionBlock{SETUP_FINALLY, BCOffset{40}, 1});
+  callee.cause_instr_idx = BCIndex{nonce};
+  dm.frame_meta = {std::move(caller), std::move(callee)};
+  return dm;
+}
+
+} // namespace
+
+TEST_F(DeoptTest, CompactEncodingRoundTrip) {
+  Ref<PyFunctionObject> func(compileAndGet("def test(): pass", "test"));
+  ASSERT_NE(func, nullptr);
+  auto code = reinterpret_cast<PyCodeObject*>(func->func_code);
+
+  std::vector<DeoptMetadata> metas;
+  metas.push_back(makeEncodingTestMetadata(code, 7));
+  metas.emplace_back();
+  DeoptMetadataTable table{metas};
+  ASSERT_EQ(table.size(), 2);
+
+  DeoptMetadata decoded = table.decode(0);
+  EXPECT_EQ(decoded.reason, DeoptReason::kUnhandledUnboundLocal);
+  EXPECT_STREQ(decoded.descr, "encoding test");
+  EXPECT_EQ(decoded.eh_name, code->co_name);
+  EXPECT_EQ(decoded.guilty_value, 1);
+  EXPECT_EQ(decoded.nonce, 7);
+  ASSERT_EQ(decoded.live_values.size(), 3);
+  for (size_t i = 0; i < decoded.live_values.size(); ++i) {
+    const LiveValue& expected = metas[0].live_values[i];
+    const LiveValue& actual = decoded.live_values[i];
+    EXPECT_EQ(actual.location, expected.location);
+    EXPECT_EQ(actual.location.bitSize, expected.location.bitSize);
+    EXPECT_EQ(actual.ref_kind, expected.ref_kind);
+    EXPECT_EQ(actual.value_kind, expected.value_kind);
+    EXPECT_EQ(actual.source, expected.source);
+  }
+  ASSERT_EQ(decoded.frame_meta.size(), 2);
+  for (size_t i = 0; i < decoded.frame_meta.size(); ++i) {
+    const DeoptFrameMetadata& expected = metas[0].frame_meta[i];
+    const DeoptFrameMetadata& actual = decoded.frame_meta[i];
+    EXPECT_EQ(actual.code, code);
+    EXPECT_EQ(actual.cause_instr_idx, expected.cause_instr_idx);
+    EXPECT_TRUE(std::ranges::equal(actual.localsplus, expected.localsplus));
+    EXPECT_TRUE(std::ranges::equal(actual.stack, expected.stack));
+    EXPECT_EQ(actual.block_stack, expected.block_stack);
+  }
+
+  DeoptMetadata empty = table.decode(1);
+  EXPECT_EQ(empty.reason, DeoptReason::kUnhandledException);
+  EXPECT_EQ(empty.descr, nullptr);
+  EXPECT_EQ(empty.eh_name, nullptr);
+  EXPECT_EQ(empty.guilty_value, -1);
+  EXPECT_EQ(empty.nonce, -1);
+  EXPECT_EQ(empty.live_values.size(), 0);
+  EXPECT_EQ(empty.frame_meta.size(), 0);
+}
+
+TEST_F(DeoptTest, CompactEncodingSharesFrameShapes) {
+  Ref<PyFunctionObject> func(compileAndGet("def test(): pass", "test"));
+  ASSERT_NE(func, nullptr);
+  auto code = reinterpret_cast<PyCodeObject*>(func->func_code);
+
+  // Deopt points that only differ by their nonce and cause instruction share
+  // their live values and frame shapes, so each one after the first only adds
+  // a short record.
+  std::vector<DeoptMetadata> one{makeEncodingTestMetadata(code, 0)};
+  std::vector<DeoptMetadata> many;
+  for (int i = 0; i < 100; ++i) {
+    many.push_back(makeEncodingTestMetadata(code, i));
+  }
+  DeoptMetadataTable one_table{one};
+  DeoptMetadataTable many_table{many};
+  size_t per_record = (many_table.encodedBytes() - one_table.encodedBytes()) /
+      (many.size() - 1);
+  EXPECT_LT(per_record, 32);
+  EXPECT_LT(
+      many_table.encodedBytes(),
+      deoptMetadataBytes(many[0]) * many.size() / 4);
+
+  // Decoded entries are cached, so references stay valid and identical.
+  EXPECT_EQ(many_table.decodedBytes(), 0);
+  const DeoptMetadata& first = many_table.get(42);
+  EXPECT_EQ(&first, &many_table.get(42));
+  EXPECT_EQ(first.nonce, 42);
+  EXPECT_EQ(first.innermostFrame().cause_instr_idx, BCIndex{42});
+  EXPECT_EQ(many_table.decodedBytes(), deoptMetadataBytes(first));
+}
@@ -526,3 +526,64 @@ fun type_hints {
 
   EXPECT_EQ(seen.dominatingTypeHint(v1, bb4), nullptr);
 }
+
+class FindLoopHeadersTest : public RuntimeTest {};
+
+TEST_F(FindLoopHeadersTest, FindsNestedLoops) {
+  const char* src = R"(
+fun loops {
+   bb 0 {
+     v0 = LoadArg<0>
+     Branch<1>
+   }
+
+   bb 1 {
+     CondBranch<2, 4> v0
+   }
+
+   bb 2 {
+     CondBranch<2, 3> v0
+   }
+
+   bb 3 {
+     Branch<1>
+   }
+
+   bb 4 {
+     Return v0
+   }
+ }
+)";
+  std::unique_ptr<Function> func = HIRParser().parseHIR(src);
+
+  auto headers = findLoopHeaders(*func);
+  EXPECT_EQ(headers.size(), 2);
+  EXPECT_TRUE(headers.contains(func->cfg.getBlockById(1)));
+  EXPECT_TRUE(headers.contains(func->cfg.getBlockById(2)));
+}
+
+TEST_F(FindLoopHeadersTest, NoLoopsInDiamond) {
+  const char* src = R"(
+fun diamond {
+   bb 0 {
+     v0 = LoadArg<0>
+     CondBranch<1, 2> v0
+   }
+
+   bb 1 {
+     Branch<3>
+   }
+
+   bb 2 {
+     Branch<3>
+   }
+
+   bb 3 {
+     Return v0
+   }
+ }
+)";
+  std::unique_ptr<Function> func = HIRParser().parseHIR(src);
+
+  EXPECT_TRUE(findLoopHeaders(*func).empty());
+}
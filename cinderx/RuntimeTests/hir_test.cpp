@@ -17,6 +17,8 @@
 #include "cinderx/Jit/hir/refcount_insertion.h"
 #include "cinderx/Jit/hir/ssa.h"
 #include "cinderx/RuntimeTests/fixtures.h"
+#include "cinderx/StaticPython/static_array.h"
+#include "cinderx/StaticPython/type_code.h"
 
 extern "C" {
 
@@ -1932,3 +1934,113 @@ def test():
   EXPECT_EQ(found_at_quiescent_state, kFreeThreadedBuild)
       << "AtQuiescentState presence should match the build mode";
 }
+
+TEST_F(HIRBuildTest, StaticMethodCallWithoutOverridesIsDirect) {
+  const char* src = R"(
+class C:
+    def f(self) -> int:
+        return 1
+
+def test(c: C) -> int:
+    return c.f()
+)";
+  Ref<PyFunctionObject> funcobj(compileStaticAndGet(src, "test"));
+  ASSERT_NE(funcobj, nullptr);
+
+  std::unique_ptr<Function> irfunc(buildHIR(funcobj));
+  ASSERT_NE(irfunc, nullptr);
+
+  const InvokeStaticFunction* invoke = nullptr;
+  bool found_patchpoint = false;
+  bool found_vtable_call = false;
+  for (auto& block : irfunc->cfg.blocks) {
+    for (auto& instr : block) {
+      if (instr.isInvokeStaticFunction()) {
+        invoke = static_cast<const InvokeStaticFunction*>(&instr);
+      } else if (instr.isDeoptPatchpoint()) {
+        auto& patchpoint = static_cast<const DeoptPatchpoint&>(instr);
+        found_patchpoint |= patchpoint.descr() == "MethodOverrideDeoptPatcher";
+      } else if (instr.isCallInd()) {
+        found_vtable_call = true;
+      }
+    }
+  }
+
+  ASSERT_NE(invoke, nullptr) << "C.f should be called directly";
+  EXPECT_EQ(
+      PyUnicode_AsUTF8(invoke->func()->func_qualname), std::string_view{"C.f"});
+  EXPECT_TRUE(found_patchpoint)
+      << "The direct call should be guarded against overrides of C.f";
+  EXPECT_FALSE(found_vtable_call);
+}
+
+TEST_F(HIRBuildTest, StaticMethodCallWithOverrideUsesVtable) {
+  const char* src = R"(
+class C:
+    def f(self) -> int:
+        return 1
+
+class D(C):
+    def f(self) -> int:
+        return 2
+
+def test(c: C) -> int:
+    return c.f()
+)";
+  Ref<PyFunctionObject> funcobj(compileStaticAndGet(src, "test"));
+  ASSERT_NE(funcobj, nullptr);
+
+  std::unique_ptr<Function> irfunc(buildHIR(funcobj));
+  ASSERT_NE(irfunc, nullptr);
+
+  bool found_invoke = false;
+  bool found_vtable_call = false;
+  for (auto& block : irfunc->cfg.blocks) {
+    for (auto& instr : block) {
+      found_invoke |= instr.isInvokeStaticFunction();
+      found_vtable_call |= instr.isCallInd();
+    }
+  }
+
+  EXPECT_FALSE(found_invoke) << "D overrides C.f";
+  EXPECT_TRUE(found_vtable_call);
+}
+
+TEST_F(HIRBuildTest, StaticArrayBulkMethodCallIsDirect) {
+  const char* src = R"(
+from __static__ import Array, double
+
+def test(a: Array[double]):
+    return a.sum()
+)";
+  Ref<PyFunctionObject> funcobj(compileStaticAndGet(src, "test"));
+  ASSERT_NE(funcobj, nullptr);
+
+  std::unique_ptr<Function> irfunc(buildHIR(funcobj));
+  ASSERT_NE(irfunc, nullptr);
+
+  PyTypeObject* array_type = _Ci_StaticArray_TypeForElement(TYPED_DOUBLE);
+  ASSERT_NE(array_type, nullptr);
+  BorrowedRef<> sum = PyDict_GetItemString(
+      reinterpret_cast<PyObject*>(_PyType_GetDict(array_type)), "sum");
+  ASSERT_NE(sum, nullptr);
+  ASSERT_EQ(Py_TYPE(sum), &PyMethodDescr_Type);
+  void* sum_impl = reinterpret_cast<void*>(
+      reinterpret_cast<PyMethodDescrObject*>(sum.get())->d_method->ml_meth);
+
+  bool found_direct_call = false;
+  bool found_dynamic_call = false;
+  for (auto& block : irfunc->cfg.blocks) {
+    for (auto& instr : block) {
+      if (instr.isCallStatic()) {
+        found_direct_call |=
+            static_cast<const CallStatic&>(instr).addr() == sum_impl;
+      }
+      found_dynamic_call |= instr.isVectorCall() || instr.isCallMethod() ||
+          instr.isLoadMethod();
+    }
+  }
+
+  EXPECT_TRUE(found_direct_call) << "a.sum() should call the C loop directly";
+  EXPECT_FALSE(found_dynamic_call);
+}
@@ -0,0 +1,84 @@
+// Copyright (c) Meta Platforms, Inc. and affiliates.
+#include <gtest/gtest.h>
+
+#include "cinderx/Common/code.h"
+#include "cinderx/Jit/hot_manifest.h"
+#include "cinderx/RuntimeTests/fixtures.h"
+
+#include <fmt/format.h>
+
+using HotManifestTest = RuntimeTest;
+
+using cinderx::jit::HotManifest;
+using cinderx::jit::HotManifestEntry;
+
+TEST_F(HotManifestTest, ParseLine) {
+  HotManifest manifest;
+
+  // Valid
+  EXPECT_TRUE(manifest.parseLine(""));
+  EXPECT_TRUE(manifest.parseLine("# foo"));
+  EXPECT_TRUE(manifest.parseLine("foo:bar 1f 100"));
+  EXPECT_TRUE(manifest.parseLine("foo:Baz.qux deadbeef 7 builtins:int=5"));
+  EXPECT_TRUE(
+      manifest.parseLine("foo:f.<locals>.g 0 3 builtins:int=2,<other>=1"));
+  EXPECT_EQ(manifest.size(), 3);
+
+  // Invalid
+  EXPECT_FALSE(manifest.parseLine("foo"));
+  EXPECT_FALSE(manifest.parseLine("foo: 1f 100"));
+  EXPECT_FALSE(manifest.parseLine(":bar 1f 100"));
+  EXPECT_FALSE(manifest.parseLine("foo:bar 1f"));
+  EXPECT_FALSE(manifest.parseLine("foo:bar xyz 100"));
+  EXPECT_FALSE(manifest.parseLine("foo:bar 1f -100"));
+  EXPECT_FALSE(manifest.parseLine("foo:bar 1f 100 builtins:int"));
+  EXPECT_FALSE(manifest.parseLine("foo:bar 1f 100 builtins:int=5 extra"));
+  EXPECT_EQ(manifest.size(), 3);
+}
+
+TEST_F(HotManifestTest, FormatEntry) {
+  HotManifestEntry entry;
+  entry.module = "foo";
+  entry.qualname = "Bar.baz";
+  entry.code_hash = 0xdeadbeef;
+  entry.calls = 42;
+  EXPECT_EQ(HotManifest::formatEntry(entry), "foo:Bar.baz deadbeef 42");
+
+  entry.types = {{"builtins:int", 40}, {"<other>", 2}};
+  std::string line = HotManifest::formatEntry(entry);
+  EXPECT_EQ(line, "foo:Bar.baz deadbeef 42 builtins:int=40,<other>=2");
+
+  HotManifest manifest;
+  ASSERT_TRUE(manifest.parseLine(line));
+  EXPECT_EQ(manifest.size(), 1);
+
+  // Names that would be split up when parsing aren't written.
+  entry.qualname = "Bar baz";
+  EXPECT_EQ(HotManifest::formatEntry(entry), "");
+  entry.qualname = "Bar.baz";
+  entry.module = "foo:bar";
+  EXPECT_EQ(HotManifest::formatEntry(entry), "");
+}
+
+TEST_F(HotManifestTest, LookupFunc) {
+  auto obj = compileAndGet("def f(): pass", "f");
+  BorrowedRef<PyFunctionObject> func =
+      reinterpret_cast<PyFunctionObject*>(obj.get());
+  ASSERT_NE(func, nullptr);
+  uint32_t hash = cinderx::hashBytecode(func->func_code);
+
+  HotManifest manifest;
+  EXPECT_EQ(manifest.lookupFunc(func), nullptr);
+
+  ASSERT_TRUE(manifest.parseLine(
+      fmt::format("{}:f {:x} 10", JIT_TEST_MOD_NAME, hash + 1)));
+  EXPECT_EQ(manifest.lookupFunc(func), nullptr);
+
+  ASSERT_TRUE(
+      manifest.parseLine(fmt::format("{}:f {:x} 10", JIT_TEST_MOD_NAME, hash)));
+  const HotManifestEntry* entry = manifest.lookupFunc(func);
+  ASSERT_NE(entry, nullptr);
+  EXPECT_EQ(entry->calls, 10);
+  EXPECT_EQ(entry->module, JIT_TEST_MOD_NAME);
+  EXPECT_EQ(entry->qualname, "f");
+}
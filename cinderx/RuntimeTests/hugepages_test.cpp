@@ -4,6 +4,7 @@
 #include "cinderx/Common/hugepages.h"
 
 #include <cstring>
+#include <span>
 
 using namespace cinderx;
 
@@ -40,3 +41,26 @@ TEST(HugePageArenaTest, CollapseAfterFork) {
   p[0] = 0x11;
   EXPECT_EQ(p[0], 0x11);
 }
+
+// Copies land in the arena, and protecting it moves later allocations to a
+// fresh chunk while the protected memory stays readable.
+TEST(HugePageArenaTest, CopyAndProtect) {
+  HugePageArena arena;
+  EXPECT_EQ(arena.allocatedBytes(), 0u);
+
+  const int values[] = {1, 2, 3, 4};
+  std::span<const int> copy = arena.copy(std::span<const int>{values});
+  ASSERT_EQ(copy.size(), 4u);
+  EXPECT_NE(copy.data(), values);
+  EXPECT_EQ(copy[3], 4);
+  EXPECT_EQ(arena.allocatedBytes(), sizeof(values));
+  EXPECT_EQ(arena.reservedBytes(), HugePageArena::kHugePageSize);
+
+  arena.protect();
+  EXPECT_EQ(copy[0], 1);
+
+  auto* p = static_cast<char*>(arena.allocate(64, 16));
+  p[0] = 0x22;
+  EXPECT_EQ(p[0], 0x22);
+  EXPECT_EQ(arena.reservedBytes(), 2 * HugePageArena::kHugePageSize);
+}
@@ -75,3 +75,60 @@ Phase                Time/µs       Leaf/%     Sub Phase/%     Unattributed Time
 
 )") != std::string::npos);
 }
+
+TEST_F(JITTimeLogTest, CompileTraceRendersEvents) {
+  CompileTrace trace;
+  auto t0 = std::chrono::steady_clock::now();
+  trace.record("Ignored", "", t0, t0);
+  trace.start(8);
+  trace.setThreadName("Test \"thread\"");
+  trace.record("Compile", "mod:f", t0, t0 + std::chrono::microseconds(30));
+  trace.record(
+      "SSAify",
+      "mod:f",
+      t0 + std::chrono::microseconds(10),
+      t0 + std::chrono::microseconds(15));
+  trace.stop();
+  trace.record("Ignored", "", t0, t0);
+
+  std::string json = trace.toJson();
+  EXPECT_EQ(json.find("Ignored"), std::string::npos) << json;
+  EXPECT_NE(
+      json.find(R"("args":{"name":"Test \"thread\""})"), std::string::npos)
+      << json;
+  EXPECT_NE(
+      json.find(
+          R"({"name":"Compile","cat":"jit","ph":"X","ts":0.000,"dur":30.000,)"),
+      std::string::npos)
+      << json;
+  EXPECT_NE(
+      json.find(
+          R"({"name":"SSAify","cat":"jit","ph":"X","ts":10.000,"dur":5.000,)"),
+      std::string::npos)
+      << json;
+  EXPECT_NE(json.find(R"("args":{"function":"mod:f"})"), std::string::npos)
+      << json;
+  EXPECT_NE(json.find(R"("dropped_events":0)"), std::string::npos) << json;
+
+  trace.clear();
+  EXPECT_EQ(trace.toJson().find("SSAify"), std::string::npos);
+}
+
+TEST_F(JITTimeLogTest, CompileTraceKeepsMostRecentEvents) {
+  CompileTrace trace;
+  trace.start(2);
+  auto t0 = std::chrono::steady_clock::now();
+  trace.record("first", "", t0, t0);
+  trace.record("second", "", t0, t0);
+  trace.record("third", "", t0, t0);
+  EXPECT_EQ(trace.numDropped(), size_t{1});
+
+  std::string json = trace.toJson();
+  EXPECT_EQ(json.find("first"), std::string::npos) << json;
+  size_t second = json.find("second");
+  size_t third = json.find("third");
+  ASSERT_NE(second, std::string::npos) << json;
+  ASSERT_NE(third, std::string::npos) << json;
+  EXPECT_LT(second, third);
+  EXPECT_NE(json.find(R"("dropped_events":1)"), std::string::npos) << json;
+}
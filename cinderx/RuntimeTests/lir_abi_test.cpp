@@ -8,6 +8,7 @@
 #include "cinderx/Jit/codegen/environ.h"
 #include "cinderx/Jit/context.h"
 #include "cinderx/Jit/deopt.h"
+#include "cinderx/Jit/direct_call_patcher.h"
 #include "cinderx/Jit/lir/block.h"
 #include "cinderx/Jit/lir/function.h"
 #include "cinderx/Jit/lir/instruction.h"
@@ -55,6 +56,9 @@ class LIRABITest : public RuntimeTest {
     Function function;
     BasicBlock bb(&function);
 
+    // Entry cache for the callee of a kDirectStaticCall.
+    void* entry_cache = nullptr;
+
     // Allocate the instruction and any additional resources that it may need.
     auto insn = bb.allocateInstr(opcode, origin, args...);
     switch (opcode) {
@@ -82,6 +86,12 @@ class LIRABITest : public RuntimeTest {
         environ.block_label_map.emplace(deopt_bb, as.newLabel());
         break;
       }
+      case Opcode::kDirectStaticCall: {
+        auto patcher = reinterpret_cast<DirectCallPatcher*>(
+            insn->getInput(0)->getConstant());
+        environ.static_call_fallbacks.emplace(patcher->callee(), &entry_cache);
+        break;
+      }
       default:
         break;
     }
@@ -421,6 +431,44 @@ TEST_F(LIRABITest, TestkDeoptPatchpoint) {
   translateInstr(Opcode::kDeoptPatchpoint, MemImm{&patcher}, Imm{0});
 }
 
+// kDirectVectorCall R i
+#if defined(CINDER_X86_64)
+TEST_F(LIRABITest, TestkDirectVectorCall_OutPhyReg_Imm) {
+  jit::DirectCallPatcher patcher{nullptr};
+  translateInstr(
+      Opcode::kDirectVectorCall,
+      makeOutPhyReg(),
+      Imm{reinterpret_cast<uintptr_t>(&patcher)});
+}
+#endif
+
+// kDirectStaticCall R i
+#if defined(CINDER_X86_64)
+TEST_F(LIRABITest, TestkDirectStaticCall_OutPhyReg_Imm) {
+  jit::DirectCallPatcher patcher{nullptr, DirectCallPatcher::Entry::kStatic};
+  translateInstr(
+      Opcode::kDirectStaticCall,
+      makeOutPhyReg(),
+      Imm{reinterpret_cast<uintptr_t>(&patcher)});
+}
+
+// Primitive doubles come back in xmm0.
+TEST_F(LIRABITest, TestkDirectStaticCall_OutPhyRegFP_Imm) {
+  jit::DirectCallPatcher patcher{nullptr, DirectCallPatcher::Entry::kStatic};
+  translateInstr(
+      Opcode::kDirectStaticCall,
+      makeOutPhyRegFP(),
+      Imm{reinterpret_cast<uintptr_t>(&patcher)});
+}
+
+// kDirectStaticCall i
+TEST_F(LIRABITest, TestkDirectStaticCall_Imm) {
+  jit::DirectCallPatcher patcher{nullptr, DirectCallPatcher::Entry::kStatic};
+  translateInstr(
+      Opcode::kDirectStaticCall, Imm{reinterpret_cast<uintptr_t>(&patcher)});
+}
+#endif
+
 // kNegate r
 TEST_F(LIRABITest, TestkNegate_PhyReg) {
   translateInstr(Opcode::kNegate, makePhyReg());
@@ -0,0 +1,195 @@
+// Copyright (c) Meta Platforms, Inc. and affiliates.
+
+#include <gtest/gtest.h>
+
+#include "cinderx/Jit/lir/load_elim.h"
+#include "cinderx/Jit/lir/parser.h"
+#include "cinderx/RuntimeTests/fixtures.h"
+#include "cinderx/RuntimeTests/lir_query.h"
+
+#include <memory>
+
+namespace cinderx::jit::lir {
+
+class LIRLoadEliminationTest : public RuntimeTest {};
+
+static std::unique_ptr<Function> runLoadElim(const char* lir_input_str) {
+  std::unique_ptr<Function> func = Parser().parse(lir_input_str);
+  eliminateRedundantLoads(func.get());
+  return func;
+}
+
+TEST_F(LIRLoadEliminationTest, RemovesRepeatedLoad) {
+  auto func = runLoadElim(R"(Function:
+BB %0
+  %1:Object = Move 4096
+  %2:Object = Move [%1:Object + 0x8]:Object
+  %3:Object = Move [%1:Object + 0x8]:Object
+  %4:Object = Add %2:Object, %3:Object
+  Return %4:Object
+)");
+
+  EXPECT_NO_LIR(Query(*func).outVreg(3));
+  EXPECT_LIR(Query(*func).opcode(Opcode::kAdd).inVreg(0, 2).inVreg(1, 2));
+}
+
+TEST_F(LIRLoadEliminationTest, KeepsLoadAcrossAliasingStore) {
+  auto func = runLoadElim(R"(Function:
+BB %0
+  %1:Object = Move 4096
+  %2:Object = Move 8192
+  %3:Object = Move [%1:Object + 0x8]:Object
+  %4:Object = Move [%1:Object + 0x8]:Object
+  [%2:Object + 0x18]:Object = Move %3:Object
+  %5:Object = Move [%1:Object + 0x8]:Object
+  %6:Object = Add %4:Object, %5:Object
+  Return %6:Object
+)");
+
+  // %4 repeats %3's load and goes away.  The store through %2 could write
+  // the location %1 + 0x8, so %5 has to load it again.
+  EXPECT_NO_LIR(Query(*func).outVreg(4));
+  EXPECT_LIR(Query(*func).outVreg(5));
+  EXPECT_LIR(Query(*func).opcode(Opcode::kAdd).inVreg(0, 3).inVreg(1, 5));
+}
+
+TEST_F(LIRLoadEliminationTest, ForwardsStoreToLoad) {
+  auto func = runLoadElim(R"(Function:
+BB %0
+  %1:Object = Move 4096
+  %2:64bit = Move 7
+  [%1:Object + 0x10]:64bit = Move %2:64bit
+  %3:64bit = Move [%1:Object + 0x10]:64bit
+  Return %3:64bit
+)");
+
+  EXPECT_NO_LIR(Query(*func).outVreg(3));
+  EXPECT_LIR(Query(*func).opcode(Opcode::kReturn).inVreg(0, 2));
+}
+
+TEST_F(LIRLoadEliminationTest, KeepsLoadOfDifferentSize) {
+  auto func = runLoadElim(R"(Function:
+BB %0
+  %1:Object = Move 4096
+  %2:Object = Move [%1:Object + 0x8]:Object
+  %3:32bit = Move [%1:Object + 0x8]:32bit
+  Return %3:32bit
+)");
+
+  EXPECT_LIR(Query(*func).outVreg(3));
+}
+
+TEST_F(LIRLoadEliminationTest, DisjointStoreKeepsLoadAvailable) {
+  auto func = runLoadElim(R"(Function:
+BB %0
+  %1:Object = Move 4096
+  %2:Object = Move [%1:Object + 0x8]:Object
+  [%1:Object + 0x10]:Object = Move %2:Object
+  %3:Object = Move [%1:Object + 0x8]:Object
+  Return %3:Object
+)");
+
+  EXPECT_NO_LIR(Query(*func).outVreg(3));
+  EXPECT_LIR(Query(*func).opcode(Opcode::kReturn).inVreg(0, 2));
+}
+
+TEST_F(LIRLoadEliminationTest, StoreThroughOtherBaseKillsLoad) {
+  auto func = runLoadElim(R"(Function:
+BB %0
+  %1:Object = Move 4096
+  %2:Object = Move 8192
+  %3:Object = Move [%1:Object + 0x8]:Object
+  [%2:Object + 0x8]:Object = Move %1:Object
+  %4:Object = Move [%1:Object + 0x8]:Object
+  %5:Object = Add %3:Object, %4:Object
+  Return %5:Object
+)");
+
+  EXPECT_LIR(Query(*func).outVreg(4));
+}
+
+TEST_F(LIRLoadEliminationTest, CallKillsLoad) {
+  auto func = runLoadElim(R"(Function:
+BB %0
+  %1:Object = Move 4096
+  %2:Object = Move [%1:Object + 0x8]:Object
+  %3:Object = Call 8192, %2:Object
+  %4:Object = Move [%1:Object + 0x8]:Object
+  %5:Object = Add %3:Object, %4:Object
+  Return %5:Object
+)");
+
+  EXPECT_LIR(Query(*func).outVreg(4));
+}
+
+TEST_F(LIRLoadEliminationTest, KeepsLoadThatIsIncremented) {
+  auto func = runLoadElim(R"(Function:
+BB %0
+  %1:Object = Move 4096
+  %2:32bit = Move [%1:Object]:32bit
+  %3:32bit = Move [%1:Object]:32bit
+  Inc %3:32bit
+  %4:32bit = Add %2:32bit, %3:32bit
+  Return %4:32bit
+)");
+
+  EXPECT_LIR(Query(*func).outVreg(3));
+  EXPECT_LIR(Query(*func).opcode(Opcode::kAdd).inVreg(0, 2).inVreg(1, 3));
+}
+
+TEST_F(LIRLoadEliminationTest, RemovesLoadDominatedByLoad) {
+  auto func = runLoadElim(R"(Function:
+BB %0 - succs: %3 %5
+  %1:Object = Move 4096
+  %2:Object = Move [%1:Object + 0x8]:Object
+  CondBranch %2:Object, BB%3, BB%5
+
+BB %3 - preds: %0
+  %4:Object = Move [%1:Object + 0x8]:Object
+  Return %4:Object
+
+BB %5 - preds: %0
+  Return %1:Object
+)");
+
+  EXPECT_NO_LIR(Query(*func).outVreg(4));
+  EXPECT_LIR(Query(*func).opcode(Opcode::kReturn).inVreg(0, 2));
+}
+
+TEST_F(LIRLoadEliminationTest, KeepsLoadAfterStoreOnOnePath) {
+  auto func = runLoadElim(R"(Function:
+BB %0 - succs: %3 %4
+  %1:Object = Move 4096
+  %2:Object = Move [%1:Object + 0x8]:Object
+  CondBranch %2:Object, BB%3, BB%4
+
+BB %3 - preds: %0 - succs: %4
+  [%1:Object + 0x8]:Object = Move %1:Object
+
+BB %4 - preds: %0 %3
+  %5:Object = Move [%1:Object + 0x8]:Object
+  Return %5:Object
+)");
+
+  EXPECT_LIR(Query(*func).outVreg(5));
+}
+
+TEST_F(LIRLoadEliminationTest, KeepsLoadInLoopHeader) {
+  auto func = runLoadElim(R"(Function:
+BB %0 - succs: %3
+  %1:Object = Move 4096
+  %2:Object = Move [%1:Object + 0x8]:Object
+
+BB %3 - preds: %0 %3 - succs: %3 %5
+  %4:Object = Move [%1:Object + 0x8]:Object
+  [%1:Object + 0x8]:Object = Move %2:Object
+  CondBranch %4:Object, BB%3, BB%5
+
+BB %5 - preds: %3
+  Return %2:Object
+)");
+
+  EXPECT_LIR(Query(*func).outVreg(4));
+}
+
+} // namespace cinderx::jit::lir
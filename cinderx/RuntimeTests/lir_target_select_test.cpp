@@ -106,6 +106,83 @@ BB %0
                     .outInd(1, 0x8)
                     .inImm(0, 4294967296ULL));
 }
+
+TEST_F(LIRTargetSelectTest, FoldsLeaIntoMemoryOperand) {
+  const char* lir_input_str = R"(Function:
+BB %0
+  %1:Object = Move 4096
+  %2:64bit = Move 3
+  %3:Object = Lea [%1:Object + %2:64bit * 8 + 0x10]
+  %4:Object = Move [%3:Object + 0x8]:Object
+  [%3:Object + 0x20]:Object = Move %4:Object
+  Return %4
+)";
+
+  auto lir_func = runTargetSelectFunc(lir_input_str);
+
+  auto folded_input = [](const Instruction* instr) {
+    const Operand* input = instr->getInput(0);
+    if (!input->isInd()) {
+      return false;
+    }
+    const MemoryIndirect* ind = input->getMemoryIndirect();
+    const Operand* base = ind->getBaseRegOperand();
+    const Operand* index = ind->getIndexRegOperand();
+    return base->isLinked() && base->getLinkedInstr()->id() == 1 &&
+        index != nullptr && index->isLinked() &&
+        index->getLinkedInstr()->id() == 2 && ind->getMultiplier() == 3 &&
+        ind->getOffset() == 0x18;
+  };
+  EXPECT_LIR(Query(*lir_func).opcode(Opcode::kMove).outVreg(4).with(
+      folded_input));
+  EXPECT_LIR(Query(*lir_func)
+                 .opcode(Opcode::kMove)
+                 .outIndBaseVreg(1)
+                 .outIndIndexVreg(2)
+                 .outIndOffset(0x30));
+  EXPECT_NO_LIR(Query(*lir_func).opcode(Opcode::kLea));
+}
+
+TEST_F(LIRTargetSelectTest, KeepsLeaWithOtherUses) {
+  const char* lir_input_str = R"(Function:
+BB %0
+  %1:Object = Move 4096
+  %2:Object = Lea [%1:Object + 0x10]
+  %3:Object = Move [%2:Object + 0x8]:Object
+  %4:Object = Add %2:Object, %3:Object
+  Return %4
+)";
+
+  auto lir_func = runTargetSelectFunc(lir_input_str);
+
+  EXPECT_LIR(Query(*lir_func).opcode(Opcode::kMove).outVreg(3).with(
+      [](const Instruction* instr) {
+        const MemoryIndirect* ind = instr->getInput(0)->getMemoryIndirect();
+        return ind->getBaseRegOperand()->getLinkedInstr()->id() == 1 &&
+            ind->getOffset() == 0x18;
+      }));
+  EXPECT_LIR(Query(*lir_func).opcode(Opcode::kLea).outVreg(2));
+}
+
+TEST_F(LIRTargetSelectTest, DoesNotFoldTwoIndexRegisters) {
+  const char* lir_input_str = R"(Function:
+BB %0
+  %1:Object = Move 4096
+  %2:64bit = Move 3
+  %3:Object = Lea [%1:Object + %2:64bit * 8]
+  %4:Object = Move [%3:Object + %2:64bit * 8]:Object
+  Return %4
+)";
+
+  auto lir_func = runTargetSelectFunc(lir_input_str);
+
+  EXPECT_LIR(Query(*lir_func).opcode(Opcode::kLea).outVreg(3));
+  EXPECT_LIR(Query(*lir_func).opcode(Opcode::kMove).outVreg(4).with(
+      [](const Instruction* instr) {
+        const MemoryIndirect* ind = instr->getInput(0)->getMemoryIndirect();
+        return ind->getBaseRegOperand()->getLinkedInstr()->id() == 3;
+      }));
+}
 #endif
 
 #if defined(CINDER_AARCH64)
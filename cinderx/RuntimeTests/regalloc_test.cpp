@@ -351,6 +351,202 @@ TEST_F(LinearScanAllocatorTest, DeoptExitReservesVectorRegisters) {
   EXPECT_EQ(fixedRegisterIntervals(allocator), codegen::ALL_VECD_REGISTERS);
 }
 
+namespace {
+
+// Two nested loops: BB%2..BB%11 is the outer loop, BB%5..BB%8 the inner one.
+const char* kNestedLoopSource = R"(Function:
+BB %0 - succs: %2
+      %1 = Move 0(0x0)
+           Branch BB%2
+
+BB %2 - succs: %5
+      %3 = Add %1, 1(0x1)
+           Branch BB%5
+
+BB %5 - succs: %8
+      %6 = Add %1, 2(0x2)
+           Branch BB%8
+
+BB %8 - succs: %5 %11
+      %9 = Add %3, 3(0x3)
+           CondBranch %9, BB%5, BB%11
+
+BB %11 - succs: %2 %14
+     %12 = Add %1, 4(0x4)
+           CondBranch %12, BB%2, BB%14
+
+BB %14 - succs: %16
+           Return %3
+
+BB %16
+
+)";
+
+} // namespace
+
+TEST_F(LinearScanAllocatorTest, LoopDepths) {
+  Parser parser;
+  auto lir_func = parser.parse(kNestedLoopSource);
+  lir_func->sortBasicBlocks();
+
+  LinearScanAllocator allocator(lir_func.get());
+  allocator.calculateLiveIntervals();
+
+  UnorderedMap<int, LIRLocation> block_starts;
+  for (const BasicBlock* bb : lir_func->basicBlocks()) {
+    block_starts.emplace(bb->id(), allocator.regalloc_blocks_.at(bb).start);
+  }
+
+  UnorderedMap<int, int> expected_depths{
+      {0, 0}, {2, 1}, {5, 2}, {8, 2}, {11, 1}, {14, 0}, {16, 0}};
+  for (auto [id, depth] : expected_depths) {
+    EXPECT_EQ(allocator.loopDepthAt(block_starts.at(id)), depth)
+        << "BB%" << id;
+    EXPECT_EQ(allocator.loopDepthAt(block_starts.at(id) + 1), depth)
+        << "BB%" << id;
+  }
+
+  ASSERT_EQ(allocator.loop_ranges_.size(), 2);
+  EXPECT_EQ(allocator.loop_ranges_[0].start, block_starts.at(2));
+  EXPECT_EQ(allocator.loop_ranges_[0].end, block_starts.at(14));
+  EXPECT_EQ(allocator.loop_ranges_[1].start, block_starts.at(5));
+  EXPECT_EQ(allocator.loop_ranges_[1].end, block_starts.at(11));
+}
+
+TEST_F(LinearScanAllocatorTest, SpillCostWeighsLoopDepth) {
+  Parser parser;
+  auto lir_func = parser.parse(kNestedLoopSource);
+  lir_func->sortBasicBlocks();
+  auto& instrs = parser.getOutputInstrMap();
+
+  LinearScanAllocator allocator(lir_func.get());
+  allocator.calculateLiveIntervals();
+
+  auto block_start = [&](int id) {
+    for (const BasicBlock* bb : lir_func->basicBlocks()) {
+      if (bb->id() == id) {
+        return allocator.regalloc_blocks_.at(bb).start;
+      }
+    }
+    return INVALID_LOCATION;
+  };
+
+  // %1 is a constant and can be rematerialized, %3 has to be reloaded.
+  const Operand* constant = instrs.at(1)->output();
+  const Operand* value = instrs.at(3)->output();
+  ASSERT_TRUE(allocator.isRematerializable(constant));
+  ASSERT_FALSE(allocator.isRematerializable(value));
+
+  // A use in the inner loop outweighs a closer one in the outer loop.
+  EXPECT_LT(
+      allocator.spillCost(value, block_start(2) + 1),
+      allocator.spillCost(value, block_start(8) + 1));
+
+  // At the same depth, the closer use is the more expensive one.
+  EXPECT_LT(
+      allocator.spillCost(value, block_start(11) + 1),
+      allocator.spillCost(value, block_start(2) + 1));
+
+  // Rematerializing is cheaper than any reload, and having no further use is
+  // cheapest of all.
+  EXPECT_LT(
+      allocator.spillCost(constant, block_start(8) + 1),
+      allocator.spillCost(value, block_start(14) + 1));
+  EXPECT_LT(
+      allocator.spillCost(value, MAX_LOCATION),
+      allocator.spillCost(constant, block_start(14) + 1));
+}
+
+TEST_F(LinearScanAllocatorTest, SpillSplitHoistsReloadOutOfLoop) {
+  Parser parser;
+  auto lir_func = parser.parse(kNestedLoopSource);
+  lir_func->sortBasicBlocks();
+  auto& instrs = parser.getOutputInstrMap();
+
+  LinearScanAllocator allocator(lir_func.get());
+  allocator.calculateLiveIntervals();
+
+  UnorderedMap<int, LIRLocation> block_starts;
+  for (const BasicBlock* bb : lir_func->basicBlocks()) {
+    block_starts.emplace(bb->id(), allocator.regalloc_blocks_.at(bb).start);
+  }
+
+  // %1 is live throughout both loops.
+  const LiveInterval& interval =
+      allocator.intervalMap().at(instrs.at(1)->output());
+  LIRLocation inner_use = block_starts.at(8) + 1;
+
+  // Spilled before the loops: reload on entry to the outer loop.
+  EXPECT_EQ(
+      allocator.spillSplitLocation(
+          &interval, interval.startLocation(), inner_use),
+      block_starts.at(2));
+
+  // Spilled inside the outer loop: reload on entry to the inner loop.
+  EXPECT_EQ(
+      allocator.spillSplitLocation(
+          &interval, block_starts.at(2) + 1, inner_use),
+      block_starts.at(5));
+
+  // Spilled inside the inner loop, or used outside of any loop: reload right
+  // before the use.
+  EXPECT_EQ(
+      allocator.spillSplitLocation(
+          &interval, block_starts.at(5) + 1, inner_use),
+      inner_use);
+  EXPECT_EQ(
+      allocator.spillSplitLocation(
+          &interval, interval.startLocation(), block_starts.at(14) + 1),
+      block_starts.at(14) + 1);
+}
+
+TEST_F(LinearScanAllocatorTest, RematerializesConstants) {
+  // More constants are live across the call than there are callee-saved
+  // registers, so some of them have to be spilled.  They should all be
+  // recomputed rather than reloaded.
+  auto lirfunc = std::make_unique<Function>();
+  auto bb = lirfunc->allocateBasicBlock();
+
+  constexpr int kNumConstants = 16;
+  std::vector<Instruction*> constants;
+  for (int i = 0; i < kNumConstants; i++) {
+    constants.push_back(bb->allocateInstr(
+        Opcode::kMove, nullptr, lir::OutVReg(), Imm(1000 + i)));
+  }
+
+  bb->allocateInstr(Opcode::kCall, nullptr, lir::OutVReg());
+
+  Instruction* sum = nullptr;
+  for (Instruction* constant : constants) {
+    auto value = bb->allocateInstr(
+        Opcode::kSub, nullptr, lir::OutVReg(), lir::VReg(constant), Imm(1));
+    sum = sum == nullptr ? value
+                         : bb->allocateInstr(
+                               Opcode::kAdd,
+                               nullptr,
+                               lir::OutVReg(),
+                               lir::VReg(sum),
+                               lir::VReg(value));
+  }
+
+  bb->allocateInstr(
+      Opcode::kMove,
+      nullptr,
+      lir::OutPhyReg{codegen::arch::reg_general_return_loc},
+      lir::VReg(sum));
+  bb->allocateInstr(Opcode::kReturn, nullptr);
+
+  auto epilogue = lirfunc->allocateBasicBlock();
+  bb->addSuccessor(epilogue);
+
+  LinearScanAllocator allocator{lirfunc.get()};
+  allocator.run();
+
+  SpillCounts counts = allocator.getSpillCounts();
+  EXPECT_GT(counts.rematerializations, 0);
+  EXPECT_EQ(counts.reloads, 0);
+}
+
 TEST_F(LinearScanAllocatorTest, InoutRegTest) {
   // OptimizeMoveSequence should not set reg operands that are also output
   auto lirfunc = std::make_unique<Function>();
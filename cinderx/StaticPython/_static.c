@@ -23,6 +23,7 @@
 #include "cinderx/Common/string.h"
 #include "cinderx/StaticPython/checked_dict.h"
 #include "cinderx/StaticPython/checked_list.h"
+#include "cinderx/StaticPython/checked_prim_dict.h"
 #include "cinderx/StaticPython/classloader.h"
 #include "cinderx/StaticPython/descrs.h"
 #include "cinderx/StaticPython/static_array.h"
@@ -71,6 +72,7 @@ PyDoc_STRVAR(
 
 typedef struct {
   PyTypeObject* chk_dict;
+  PyTypeObject* chk_prim_dict;
   PyTypeObject* chk_list;
   PyTypeObject* static_array;
 } StaticModuleState;
@@ -101,11 +103,19 @@ static int _static_exec(PyObject* m) {
     return -1;
   }
 
-  if ((PyStaticArray_Type =
-           (PyTypeObject*)PyType_FromSpec(&PyStaticArray_Spec)) == NULL ||
+  if (Ci_CheckedPrimDict_InitTypes() < 0 ||
+      PyModule_AddObjectRef(
+          m, "chkprimdict", (PyObject*)Ci_CheckedPrimDict_Type) < 0) {
+    Py_CLEAR(Ci_CheckedDict_Type);
+    Py_CLEAR(Ci_CheckedList_Type);
+    return -1;
+  }
+
+  if (_Ci_StaticArray_InitTypes() < 0 ||
       PyModule_AddObjectRef(m, "staticarray", (PyObject*)PyStaticArray_Type)) {
     Py_CLEAR(Ci_CheckedDict_Type);
     Py_CLEAR(Ci_CheckedList_Type);
+    Py_CLEAR(Ci_CheckedPrimDict_Type);
     return -1;
   }
 
@@ -148,6 +158,7 @@ static int _static_exec(PyObject* m) {
   }
 
   mod_state->chk_dict = Ci_CheckedDict_Type;
+  mod_state->chk_prim_dict = Ci_CheckedPrimDict_Type;
   mod_state->chk_list = Ci_CheckedList_Type;
   mod_state->static_array = PyStaticArray_Type;
 
@@ -187,7 +198,16 @@ static int _static_exec(PyObject* m) {
   SET_TYPE_CODE(SEQ_LIST)
   SET_TYPE_CODE(SEQ_TUPLE)
   SET_TYPE_CODE(SEQ_LIST_INEXACT)
+  SET_TYPE_CODE(SEQ_ARRAY_INT8)
+  SET_TYPE_CODE(SEQ_ARRAY_INT16)
+  SET_TYPE_CODE(SEQ_ARRAY_INT32)
   SET_TYPE_CODE(SEQ_ARRAY_INT64)
+  SET_TYPE_CODE(SEQ_ARRAY_UINT8)
+  SET_TYPE_CODE(SEQ_ARRAY_UINT16)
+  SET_TYPE_CODE(SEQ_ARRAY_UINT32)
+  SET_TYPE_CODE(SEQ_ARRAY_UINT64)
+  SET_TYPE_CODE(SEQ_ARRAY_DOUBLE)
+  SET_TYPE_CODE(SEQ_ARRAY_BOOL)
   SET_TYPE_CODE(SEQ_SUBSCR_UNCHECKED)
 
   SET_TYPE_CODE(SEQ_REPEAT_INEXACT_SEQ)
@@ -1871,6 +1891,7 @@ static int static_traverse(PyObject* mod, visitproc visit, void* arg) {
   StaticModuleState* modstate = (StaticModuleState*)PyModule_GetState(mod);
 
   Py_VISIT(modstate->chk_dict);
+  Py_VISIT(modstate->chk_prim_dict);
   Py_VISIT(modstate->chk_list);
   Py_VISIT(modstate->static_array);
 
@@ -1882,6 +1903,7 @@ static int static_clear(PyObject* mod) {
   assert(
       modstate->chk_dict == NULL || modstate->chk_dict == Ci_CheckedDict_Type);
   Py_CLEAR(modstate->chk_dict);
+  Py_CLEAR(modstate->chk_prim_dict);
   Py_CLEAR(modstate->chk_list);
   Py_CLEAR(modstate->static_array);
   return 0;
@@ -1903,6 +1925,8 @@ static void static_free(PyObject* mod) {
 
   Py_CLEAR(Ci_CheckedListIter_Type);
   Py_CLEAR(Ci_CheckedListRevIter_Type);
+
+  Py_CLEAR(Ci_CheckedPrimDictIter_Type);
 }
 
 static PyModuleDef_Slot _static_slots[] = {{Py_mod_exec, _static_exec}, {}};
@@ -0,0 +1,1177 @@
+/* Copyright (c) Meta Platforms, Inc. and affiliates. */
+
+#include "cinderx/StaticPython/checked_prim_dict.h"
+
+#include "cinderx/Common/py-portability.h"
+#include "cinderx/Common/string.h"
+#include "cinderx/StaticPython/type_code.h"
+#include "cinderx/StaticPython/typed_method_def.h"
+
+#if PY_VERSION_HEX >= 0x030D0000
+#include "internal/pycore_modsupport.h"
+#endif
+
+#include <math.h>
+#include <string.h>
+
+/**
+ *   Dictionaries with primitive keys and values.
+ *
+ *   The layout follows the compact dict: a table of indices, 1, 2, 4 or 8
+ *   bytes wide depending on its size, into a dense array of entries kept in
+ *   insertion order.  The indices are probed linearly, which is fine because
+ *   the hash mixes every bit of the key.  An entry holds the key and value in
+ *   their 64-bit storage form: integers sign or zero extended, cbool as 0 or
+ *   1, and doubles as their bits.  Deleted entries are flagged rather than
+ *   cleared so that iteration keeps the insertion order, and they're dropped
+ *   when the table is next resized.
+ */
+
+#define CHKPRIMDICT_MINSIZE 8
+
+/* The maximum number of entries in a table of n indices. */
+#define USABLE_FRACTION(n) (((n) << 1) / 3)
+
+#define IX_EMPTY (-1)
+#define IX_DUMMY (-2)
+
+typedef struct {
+  uint64_t key;
+  uint64_t value;
+} ChkPrimDictEntry;
+
+typedef struct {
+  /* Number of slots in the index table, a power of 2. */
+  Py_ssize_t pt_size;
+  /* Number of entries used so far, including deleted ones. */
+  Py_ssize_t pt_nentries;
+  /* Number of entries which can still be added before resizing. */
+  Py_ssize_t pt_usable;
+  /* pt_size indices, followed by USABLE_FRACTION(pt_size) entries and then a
+   * deleted flag for each entry. */
+  char pt_indices[];
+} ChkPrimDictTable;
+
+typedef struct {
+  PyObject_HEAD
+  /* Number of items in the dictionary.  This has to be at the same offset as
+   * in PyDictObject so that FAST_LEN_DICT works on both. */
+  Py_ssize_t ma_used;
+  /* NULL until the first item is inserted. */
+  ChkPrimDictTable* ma_table;
+  /* TYPED_* codes of the keys and values. */
+  int ma_key_type;
+  int ma_value_type;
+} CiChkPrimDictObject;
+
+static_assert(
+    offsetof(CiChkPrimDictObject, ma_used) == offsetof(PyDictObject, ma_used),
+    "chkprimdict length must be where FAST_LEN_DICT reads it");
+
+PyTypeObject* Ci_CheckedPrimDict_Type;
+PyTypeObject* Ci_CheckedPrimDictIter_Type;
+
+static inline Py_ssize_t table_ixsize(Py_ssize_t size) {
+  if (size <= 0x80) {
+    return 1;
+  } else if (size <= 0x8000) {
+    return 2;
+  } else if (size <= 0x80000000LL) {
+    return 4;
+  }
+  return 8;
+}
+
+static inline ChkPrimDictEntry* table_entries(ChkPrimDictTable* table) {
+  return (ChkPrimDictEntry*)(table->pt_indices +
+                             table->pt_size * table_ixsize(table->pt_size));
+}
+
+static inline uint8_t* table_deleted(ChkPrimDictTable* table) {
+  return (uint8_t*)(table_entries(table) + USABLE_FRACTION(table->pt_size));
+}
+
+static inline size_t table_bytes(Py_ssize_t size) {
+  return sizeof(ChkPrimDictTable) + size * table_ixsize(size) +
+      USABLE_FRACTION(size) * (sizeof(ChkPrimDictEntry) + 1);
+}
+
+static inline Py_ssize_t table_get_index(ChkPrimDictTable* table, size_t i) {
+  Py_ssize_t size = table->pt_size;
+  if (size <= 0x80) {
+    return ((int8_t*)table->pt_indices)[i];
+  } else if (size <= 0x8000) {
+    return ((int16_t*)table->pt_indices)[i];
+  } else if (size <= 0x80000000LL) {
+    return ((int32_t*)table->pt_indices)[i];
+  }
+  return ((int64_t*)table->pt_indices)[i];
+}
+
+static inline void
+table_set_index(ChkPrimDictTable* table, size_t i, Py_ssize_t ix) {
+  Py_ssize_t size = table->pt_size;
+  if (size <= 0x80) {
+    ((int8_t*)table->pt_indices)[i] = (int8_t)ix;
+  } else if (size <= 0x8000) {
+    ((int16_t*)table->pt_indices)[i] = (int16_t)ix;
+  } else if (size <= 0x80000000LL) {
+    ((int32_t*)table->pt_indices)[i] = (int32_t)ix;
+  } else {
+    ((int64_t*)table->pt_indices)[i] = ix;
+  }
+}
+
+/* Finalizer from MurmurHash3, so that keys differing only in their high bits
+ * still spread over the low bits used to pick a slot. */
+static inline size_t chkprimdict_hash(uint64_t key) {
+  key ^= key >> 33;
+  key *= 0xff51afd7ed558ccdULL;
+  key ^= key >> 33;
+  key *= 0xc4ceb9fe1a85ec53ULL;
+  key ^= key >> 33;
+  return (size_t)key;
+}
+
+static ChkPrimDictTable* table_new(Py_ssize_t size) {
+  assert(size >= CHKPRIMDICT_MINSIZE && (size & (size - 1)) == 0);
+  ChkPrimDictTable* table = PyMem_Malloc(table_bytes(size));
+  if (table == NULL) {
+    PyErr_NoMemory();
+    return NULL;
+  }
+  table->pt_size = size;
+  table->pt_nentries = 0;
+  table->pt_usable = USABLE_FRACTION(size);
+  memset(table->pt_indices, 0xff, size * table_ixsize(size));
+  return table;
+}
+
+/* Returns the index of the entry holding key, or -1.  If slot isn't NULL it's
+ * set to the index table slot which refers to the entry. */
+static Py_ssize_t
+table_lookup(ChkPrimDictTable* table, uint64_t key, size_t* slot) {
+  if (table == NULL) {
+    return -1;
+  }
+  ChkPrimDictEntry* entries = table_entries(table);
+  size_t mask = (size_t)table->pt_size - 1;
+  size_t i = chkprimdict_hash(key) & mask;
+  for (;;) {
+    Py_ssize_t ix = table_get_index(table, i);
+    if (ix == IX_EMPTY) {
+      return -1;
+    } else if (ix >= 0 && entries[ix].key == key) {
+      if (slot != NULL) {
+        *slot = i;
+      }
+      return ix;
+    }
+    i = (i + 1) & mask;
+  }
+}
+
+/* Points a free slot of the index table at entry ix, which holds key.  The
+ * key mustn't already be in the table. */
+static void table_insert_index(
+    ChkPrimDictTable* table,
+    uint64_t key,
+    Py_ssize_t ix) {
+  size_t mask = (size_t)table->pt_size - 1;
+  size_t i = chkprimdict_hash(key) & mask;
+  while (table_get_index(table, i) >= 0) {
+    i = (i + 1) & mask;
+  }
+  table_set_index(table, i, ix);
+}
+
+/* Moves the items into a new table with room for at least minused of them,
+ * dropping any deleted entries. */
+static int chkprimdict_resize(CiChkPrimDictObject* mp, Py_ssize_t minused) {
+  Py_ssize_t size = CHKPRIMDICT_MINSIZE;
+  while (USABLE_FRACTION(size) < minused) {
+    if (size > PY_SSIZE_T_MAX / (Py_ssize_t)(2 * sizeof(ChkPrimDictEntry))) {
+      PyErr_NoMemory();
+      return -1;
+    }
+    size <<= 1;
+  }
+
+  ChkPrimDictTable* table = table_new(size);
+  if (table == NULL) {
+    return -1;
+  }
+  ChkPrimDictTable* old_table = mp->ma_table;
+  if (old_table != NULL) {
+    ChkPrimDictEntry* old_entries = table_entries(old_table);
+    uint8_t* old_deleted = table_deleted(old_table);
+    ChkPrimDictEntry* entries = table_entries(table);
+    Py_ssize_t n = 0;
+    for (Py_ssize_t i = 0; i < old_table->pt_nentries; i++) {
+      if (!old_deleted[i]) {
+        entries[n] = old_entries[i];
+        table_insert_index(table, entries[n].key, n);
+        n++;
+      }
+    }
+    assert(n == mp->ma_used);
+    memset(table_deleted(table), 0, n);
+    table->pt_nentries = n;
+    table->pt_usable -= n;
+    PyMem_Free(old_table);
+  }
+  mp->ma_table = table;
+  return 0;
+}
+
+static int
+chkprimdict_insert(CiChkPrimDictObject* mp, uint64_t key, uint64_t value) {
+  ChkPrimDictTable* table = mp->ma_table;
+  Py_ssize_t ix = table_lookup(table, key, NULL);
+  if (ix >= 0) {
+    table_entries(table)[ix].value = value;
+    return 0;
+  }
+
+  if (table == NULL || table->pt_usable <= 0) {
+    if (chkprimdict_resize(mp, mp->ma_used * 3) < 0) {
+      return -1;
+    }
+    table = mp->ma_table;
+  }
+  ix = table->pt_nentries++;
+  table_insert_index(table, key, ix);
+  ChkPrimDictEntry* entry = &table_entries(table)[ix];
+  entry->key = key;
+  entry->value = value;
+  table_deleted(table)[ix] = 0;
+  table->pt_usable--;
+  mp->ma_used++;
+  return 0;
+}
+
+static void chkprimdict_delete_at(
+    CiChkPrimDictObject* mp,
+    size_t slot,
+    Py_ssize_t ix) {
+  table_set_index(mp->ma_table, slot, IX_DUMMY);
+  table_deleted(mp->ma_table)[ix] = 1;
+  mp->ma_used--;
+}
+
+static void chkprimdict_clear_table(CiChkPrimDictObject* mp) {
+  PyMem_Free(mp->ma_table);
+  mp->ma_table = NULL;
+  mp->ma_used = 0;
+}
+
+/* Storage conversions */
+
+static inline uint64_t double_bits(double value) {
+  uint64_t bits;
+  memcpy(&bits, &value, sizeof(bits));
+  return bits;
+}
+
+static inline double bits_double(uint64_t bits) {
+  double value;
+  memcpy(&value, &bits, sizeof(value));
+  return value;
+}
+
+/* Keys are compared by their bits, so -0.0 is stored as 0.0 to keep them the
+ * same key.  Unlike dict, where every NaN object is a distinct key, all NaNs
+ * are also folded into a single key. */
+static inline uint64_t double_key_bits(double key) {
+  if (key == 0.0) {
+    key = 0.0;
+  } else if (isnan(key)) {
+    key = Py_NAN;
+  }
+  return double_bits(key);
+}
+
+static PyObject* chkprimdict_box(uint64_t bits, int type_code) {
+  if (type_code == TYPED_DOUBLE) {
+    return PyFloat_FromDouble(bits_double(bits));
+  } else if (type_code == TYPED_BOOL) {
+    return PyBool_FromLong(bits != 0);
+  } else if (type_code & TYPED_INT_SIGNED) {
+    return PyLong_FromLongLong((int64_t)bits);
+  }
+  return PyLong_FromUnsignedLongLong(bits);
+}
+
+/* Converts obj to the storage form of a key or value with the given TYPED_*
+ * code, raising TypeError or OverflowError if it can't be stored. */
+static int chkprimdict_unbox(
+    CiChkPrimDictObject* mp,
+    PyObject* obj,
+    int type_code,
+    int is_key,
+    uint64_t* res) {
+  if (type_code == TYPED_DOUBLE) {
+    if (!PyFloat_Check(obj) && !PyLong_Check(obj)) {
+      goto bad_type;
+    }
+    double value = PyFloat_AsDouble(obj);
+    if (value == -1.0 && PyErr_Occurred()) {
+      return -1;
+    }
+    *res = is_key ? double_key_bits(value) : double_bits(value);
+    return 0;
+  } else if (type_code == TYPED_BOOL) {
+    if (!PyBool_Check(obj)) {
+      goto bad_type;
+    }
+    *res = obj == Py_True;
+    return 0;
+  }
+
+  if (!PyLong_Check(obj)) {
+    goto bad_type;
+  }
+  size_t value;
+  if (!_PyClassLoader_OverflowCheck(obj, type_code, &value)) {
+    PyErr_Format(
+        PyExc_OverflowError,
+        "%s out of range for %s",
+        is_key ? "key" : "value",
+        Py_TYPE(mp)->tp_name);
+    return -1;
+  }
+  *res = value;
+  return 0;
+
+bad_type:
+  PyErr_Format(
+      PyExc_TypeError,
+      "bad %s '%s' for %s",
+      is_key ? "key" : "value",
+      Py_TYPE(obj)->tp_name,
+      Py_TYPE(mp)->tp_name);
+  return -1;
+}
+
+/* Converts a key being looked up.  Returns 0 if the key can't be stored, in
+ * which case it can't be in the dictionary either. */
+static int
+chkprimdict_lookup_key(CiChkPrimDictObject* mp, PyObject* key, uint64_t* res) {
+  if (chkprimdict_unbox(mp, key, mp->ma_key_type, 1, res) == 0) {
+    return 1;
+  }
+  if (PyErr_ExceptionMatches(PyExc_TypeError) ||
+      PyErr_ExceptionMatches(PyExc_OverflowError)) {
+    PyErr_Clear();
+    return 0;
+  }
+  return -1;
+}
+
+static void chkprimdict_key_error(CiChkPrimDictObject* mp, uint64_t key) {
+  PyObject* boxed = chkprimdict_box(key, mp->ma_key_type);
+  if (boxed != NULL) {
+    PyErr_SetObject(PyExc_KeyError, boxed);
+    Py_DECREF(boxed);
+  }
+}
+
+/* Type parameters */
+
+static int chkprimdict_can_store(int type_code) {
+  return (type_code >= TYPED_UINT8 && type_code <= TYPED_INT64) ||
+      type_code == TYPED_DOUBLE || type_code == TYPED_BOOL;
+}
+
+static int chkprimdict_param_type(PyTypeObject* type, int index) {
+  if (!(type->tp_flags & Ci_Py_TPFLAGS_GENERIC_TYPE_INST)) {
+    return -1;
+  }
+  _PyGenericTypeParam* param = &((_PyGenericTypeInst*)type)->gti_inst[index];
+  if (param->gtp_optional) {
+    return -1;
+  }
+  int type_code = _PyClassLoader_GetTypeCode(param->gtp_type);
+  return chkprimdict_can_store(type_code) ? type_code : -1;
+}
+
+static int chkprimdict_can_store_args(PyObject* args) {
+  if (!PyTuple_Check(args) || PyTuple_GET_SIZE(args) != 2) {
+    return 0;
+  }
+  for (Py_ssize_t i = 0; i < 2; i++) {
+    PyObject* arg = PyTuple_GET_ITEM(args, i);
+    if (!PyType_Check(arg) ||
+        !chkprimdict_can_store(
+            _PyClassLoader_GetTypeCode((PyTypeObject*)arg))) {
+      return 0;
+    }
+  }
+  return 1;
+}
+
+int Ci_CheckedPrimDict_KeyType(PyTypeObject* type) {
+  return chkprimdict_param_type(type, 0);
+}
+
+int Ci_CheckedPrimDict_ValueType(PyTypeObject* type) {
+  return chkprimdict_param_type(type, 1);
+}
+
+int Ci_CheckedPrimDict_TypeCheck(PyTypeObject* type) {
+  return _PyClassLoader_GetGenericTypeDefFromType(type) ==
+      (_PyGenericTypeDef*)Ci_CheckedPrimDict_Type;
+}
+
+int Ci_CheckedPrimDict_Check(PyObject* x) {
+  return Ci_CheckedPrimDict_TypeCheck(Py_TYPE(x));
+}
+
+/* Mapping protocol */
+
+static Py_ssize_t chkprimdict_length(CiChkPrimDictObject* mp) {
+  return mp->ma_used;
+}
+
+static PyObject* chkprimdict_subscript(CiChkPrimDictObject* mp, PyObject* key) {
+  uint64_t bits;
+  int res = chkprimdict_lookup_key(mp, key, &bits);
+  if (res < 0) {
+    return NULL;
+  }
+  Py_ssize_t ix = res ? table_lookup(mp->ma_table, bits, NULL) : -1;
+  if (ix < 0) {
+    PyErr_SetObject(PyExc_KeyError, key);
+    return NULL;
+  }
+  return chkprimdict_box(
+      table_entries(mp->ma_table)[ix].value, mp->ma_value_type);
+}
+
+static int chkprimdict_ass_subscript(
+    CiChkPrimDictObject* mp,
+    PyObject* key,
+    PyObject* value) {
+  uint64_t key_bits;
+  if (value != NULL) {
+    uint64_t value_bits;
+    if (chkprimdict_unbox(mp, key, mp->ma_key_type, 1, &key_bits) < 0 ||
+        chkprimdict_unbox(mp, value, mp->ma_value_type, 0, &value_bits) < 0) {
+      return -1;
+    }
+    return chkprimdict_insert(mp, key_bits, value_bits);
+  }
+
+  int res = chkprimdict_lookup_key(mp, key, &key_bits);
+  if (res < 0) {
+    return -1;
+  }
+  size_t slot;
+  Py_ssize_t ix = res ? table_lookup(mp->ma_table, key_bits, &slot) : -1;
+  if (ix < 0) {
+    PyErr_SetObject(PyExc_KeyError, key);
+    return -1;
+  }
+  chkprimdict_delete_at(mp, slot, ix);
+  return 0;
+}
+
+static int chkprimdict_contains(CiChkPrimDictObject* mp, PyObject* key) {
+  uint64_t bits;
+  int res = chkprimdict_lookup_key(mp, key, &bits);
+  if (res <= 0) {
+    return res;
+  }
+  return table_lookup(mp->ma_table, bits, NULL) >= 0;
+}
+
+static PyMappingMethods chkprimdict_as_mapping = {
+    (lenfunc)chkprimdict_length, /*mp_length*/
+    (binaryfunc)chkprimdict_subscript, /*mp_subscript*/
+    (objobjargproc)chkprimdict_ass_subscript, /*mp_ass_subscript*/
+};
+
+static PySequenceMethods chkprimdict_as_sequence = {
+    0, /* sq_length */
+    0, /* sq_concat */
+    0, /* sq_repeat */
+    0, /* sq_item */
+    0, /* sq_slice */
+    0, /* sq_ass_item */
+    0, /* sq_ass_slice */
+    (objobjproc)chkprimdict_contains, /* sq_contains */
+    0, /* sq_inplace_concat */
+    0, /* sq_inplace_repeat */
+};
+
+/* Entry points for the JIT */
+
+PyObject* Ci_CheckedPrimDict_GetItem(PyObject* self, PyObject* key) {
+  return chkprimdict_subscript((CiChkPrimDictObject*)self, key);
+}
+
+PyObject* Ci_CheckedPrimDict_SetItem(
+    PyObject* self,
+    PyObject* const* args,
+    Py_ssize_t nargs) {
+  if (!_PyArg_CheckPositional("__setitem__", nargs, 2, 2) ||
+      chkprimdict_ass_subscript(
+          (CiChkPrimDictObject*)self, args[0], args[1]) < 0) {
+    return NULL;
+  }
+  Py_RETURN_NONE;
+}
+
+PyObject* Ci_CheckedPrimDict_Contains(PyObject* self, PyObject* key) {
+  int res = chkprimdict_contains((CiChkPrimDictObject*)self, key);
+  if (res < 0) {
+    return NULL;
+  }
+  return PyBool_FromLong(res);
+}
+
+Py_ssize_t Ci_CheckedPrimDict_LookupInt(PyObject* self, int64_t key) {
+  CiChkPrimDictObject* mp = (CiChkPrimDictObject*)self;
+  Py_ssize_t ix = table_lookup(mp->ma_table, (uint64_t)key, NULL);
+  if (ix < 0) {
+    chkprimdict_key_error(mp, (uint64_t)key);
+  }
+  return ix;
+}
+
+Py_ssize_t Ci_CheckedPrimDict_LookupDouble(PyObject* self, double key) {
+  CiChkPrimDictObject* mp = (CiChkPrimDictObject*)self;
+  uint64_t bits = double_key_bits(key);
+  Py_ssize_t ix = table_lookup(mp->ma_table, bits, NULL);
+  if (ix < 0) {
+    chkprimdict_key_error(mp, bits);
+  }
+  return ix;
+}
+
+int64_t Ci_CheckedPrimDict_IntValueAt(PyObject* self, Py_ssize_t index) {
+  CiChkPrimDictObject* mp = (CiChkPrimDictObject*)self;
+  return (int64_t)table_entries(mp->ma_table)[index].value;
+}
+
+double Ci_CheckedPrimDict_DoubleValueAt(PyObject* self, Py_ssize_t index) {
+  CiChkPrimDictObject* mp = (CiChkPrimDictObject*)self;
+  return bits_double(table_entries(mp->ma_table)[index].value);
+}
+
+int Ci_CheckedPrimDict_ContainsInt(PyObject* self, int64_t key) {
+  CiChkPrimDictObject* mp = (CiChkPrimDictObject*)self;
+  return table_lookup(mp->ma_table, (uint64_t)key, NULL) >= 0;
+}
+
+int Ci_CheckedPrimDict_ContainsDouble(PyObject* self, double key) {
+  CiChkPrimDictObject* mp = (CiChkPrimDictObject*)self;
+  return table_lookup(mp->ma_table, double_key_bits(key), NULL) >= 0;
+}
+
+int Ci_CheckedPrimDict_SetIntInt(PyObject* self, int64_t key, int64_t value) {
+  return chkprimdict_insert(
+      (CiChkPrimDictObject*)self, (uint64_t)key, (uint64_t)value);
+}
+
+int Ci_CheckedPrimDict_SetIntDouble(PyObject* self, int64_t key, double value) {
+  return chkprimdict_insert(
+      (CiChkPrimDictObject*)self, (uint64_t)key, double_bits(value));
+}
+
+int Ci_CheckedPrimDict_SetDoubleInt(PyObject* self, double key, int64_t value) {
+  return chkprimdict_insert(
+      (CiChkPrimDictObject*)self, double_key_bits(key), (uint64_t)value);
+}
+
+int Ci_CheckedPrimDict_SetDoubleDouble(
+    PyObject* self,
+    double key,
+    double value) {
+  return chkprimdict_insert(
+      (CiChkPrimDictObject*)self, double_key_bits(key), double_bits(value));
+}
+
+/* Object lifetime */
+
+static PyObject* chkprimdict_alloc(PyTypeObject* type, Py_ssize_t nitems) {
+  int key_type = chkprimdict_param_type(type, 0);
+  int value_type = chkprimdict_param_type(type, 1);
+  if (key_type < 0 || value_type < 0) {
+    PyErr_Format(
+        PyExc_TypeError,
+        "%s needs primitive key and value types",
+        type->tp_name);
+    return NULL;
+  }
+  CiChkPrimDictObject* mp = PyObject_New(CiChkPrimDictObject, type);
+  if (mp == NULL) {
+    return NULL;
+  }
+  mp->ma_used = 0;
+  mp->ma_table = NULL;
+  mp->ma_key_type = key_type;
+  mp->ma_value_type = value_type;
+  return (PyObject*)mp;
+}
+
+static void chkprimdict_dealloc(CiChkPrimDictObject* mp) {
+  /* The type is decref'd by the generic instance's dealloc. */
+  PyMem_Free(mp->ma_table);
+  Py_TYPE(mp)->tp_free((PyObject*)mp);
+}
+
+static int chkprimdict_merge(CiChkPrimDictObject* mp, PyObject* other) {
+  if (PyDict_Check(other)) {
+    PyObject *key, *value;
+    Py_ssize_t pos = 0;
+    while (PyDict_Next(other, &pos, &key, &value)) {
+      Py_INCREF(key);
+      Py_INCREF(value);
+      int res = chkprimdict_ass_subscript(mp, key, value);
+      Py_DECREF(key);
+      Py_DECREF(value);
+      if (res < 0) {
+        return -1;
+      }
+    }
+    return 0;
+  } else if (Py_TYPE(other) == Py_TYPE(mp)) {
+    CiChkPrimDictObject* src = (CiChkPrimDictObject*)other;
+    ChkPrimDictTable* table = src->ma_table;
+    for (Py_ssize_t i = 0; table != NULL && i < table->pt_nentries; i++) {
+      if (!table_deleted(table)[i]) {
+        ChkPrimDictEntry* entry = &table_entries(table)[i];
+        if (chkprimdict_insert(mp, entry->key, entry->value) < 0) {
+          return -1;
+        }
+      }
+    }
+    return 0;
+  }
+
+  DEFINE_STATIC_STRING(keys);
+  PyObject* func;
+  PyObject* iter;
+  PyObject* keys = NULL;
+  if (PyObject_GetOptionalAttr(other, s_keys, &func) < 0) {
+    return -1;
+  } else if (func != NULL) {
+    Py_DECREF(func);
+    keys = PyMapping_Keys(other);
+    if (keys == NULL) {
+      return -1;
+    }
+    iter = PyObject_GetIter(keys);
+  } else {
+    iter = PyObject_GetIter(other);
+  }
+  if (iter == NULL) {
+    Py_XDECREF(keys);
+    return -1;
+  }
+
+  PyObject* item;
+  int res = 0;
+  while (res == 0 && (item = PyIter_Next(iter)) != NULL) {
+    if (keys != NULL) {
+      PyObject* value = PyObject_GetItem(other, item);
+      res = value == NULL ? -1 : chkprimdict_ass_subscript(mp, item, value);
+      Py_XDECREF(value);
+    } else {
+      PyObject* pair = PySequence_Fast(item, "cannot convert sequence");
+      if (pair == NULL) {
+        res = -1;
+      } else if (PySequence_Fast_GET_SIZE(pair) != 2) {
+        PyErr_Format(
+            PyExc_ValueError,
+            "update sequence element has length %zd; 2 is required",
+            PySequence_Fast_GET_SIZE(pair));
+        res = -1;
+      } else {
+        res = chkprimdict_ass_subscript(
+            mp,
+            PySequence_Fast_GET_ITEM(pair, 0),
+            PySequence_Fast_GET_ITEM(pair, 1));
+      }
+      Py_XDECREF(pair);
+    }
+    Py_DECREF(item);
+  }
+  Py_DECREF(iter);
+  Py_XDECREF(keys);
+  if (res == 0 && PyErr_Occurred()) {
+    res = -1;
+  }
+  return res;
+}
+
+static int chkprimdict_init(PyObject* self, PyObject* args, PyObject* kwds) {
+  PyObject* other = NULL;
+  if (kwds != NULL && PyDict_GET_SIZE(kwds) != 0) {
+    PyErr_Format(
+        PyExc_TypeError,
+        "%s() takes no keyword arguments",
+        Py_TYPE(self)->tp_name);
+    return -1;
+  }
+  if (!PyArg_UnpackTuple(args, Py_TYPE(self)->tp_name, 0, 1, &other)) {
+    return -1;
+  }
+  if (other == NULL) {
+    return 0;
+  }
+  return chkprimdict_merge((CiChkPrimDictObject*)self, other);
+}
+
+/* Methods */
+
+static PyObject*
+chkprimdict_get(PyObject* self, PyObject* const* args, Py_ssize_t nargs) {
+  if (!_PyArg_CheckPositional("get", nargs, 1, 2)) {
+    return NULL;
+  }
+  CiChkPrimDictObject* mp = (CiChkPrimDictObject*)self;
+  uint64_t bits;
+  int res = chkprimdict_lookup_key(mp, args[0], &bits);
+  if (res < 0) {
+    return NULL;
+  }
+  Py_ssize_t ix = res ? table_lookup(mp->ma_table, bits, NULL) : -1;
+  if (ix < 0) {
+    return Py_NewRef(nargs > 1 ? args[1] : Py_None);
+  }
+  return chkprimdict_box(
+      table_entries(mp->ma_table)[ix].value, mp->ma_value_type);
+}
+
+static PyObject*
+chkprimdict_pop(PyObject* self, PyObject* const* args, Py_ssize_t nargs) {
+  if (!_PyArg_CheckPositional("pop", nargs, 1, 2)) {
+    return NULL;
+  }
+  CiChkPrimDictObject* mp = (CiChkPrimDictObject*)self;
+  uint64_t bits;
+  int res = chkprimdict_lookup_key(mp, args[0], &bits);
+  if (res < 0) {
+    return NULL;
+  }
+  size_t slot;
+  Py_ssize_t ix = res ? table_lookup(mp->ma_table, bits, &slot) : -1;
+  if (ix < 0) {
+    if (nargs > 1) {
+      return Py_NewRef(args[1]);
+    }
+    PyErr_SetObject(PyExc_KeyError, args[0]);
+    return NULL;
+  }
+  PyObject* value = chkprimdict_box(
+      table_entries(mp->ma_table)[ix].value, mp->ma_value_type);
+  if (value != NULL) {
+    chkprimdict_delete_at(mp, slot, ix);
+  }
+  return value;
+}
+
+static PyObject* chkprimdict_clear(
+    PyObject* self,
+    PyObject* Py_UNUSED(ignored)) {
+  chkprimdict_clear_table((CiChkPrimDictObject*)self);
+  Py_RETURN_NONE;
+}
+
+static PyObject* chkprimdict_copy(
+    PyObject* self,
+    PyObject* Py_UNUSED(ignored)) {
+  CiChkPrimDictObject* mp = (CiChkPrimDictObject*)self;
+  CiChkPrimDictObject* copy =
+      (CiChkPrimDictObject*)Py_TYPE(mp)->tp_alloc(Py_TYPE(mp), 0);
+  if (copy == NULL) {
+    return NULL;
+  }
+  if (mp->ma_table != NULL) {
+    size_t size = table_bytes(mp->ma_table->pt_size);
+    copy->ma_table = PyMem_Malloc(size);
+    if (copy->ma_table == NULL) {
+      Py_DECREF(copy);
+      return PyErr_NoMemory();
+    }
+    memcpy(copy->ma_table, mp->ma_table, size);
+    copy->ma_used = mp->ma_used;
+  }
+  return (PyObject*)copy;
+}
+
+static PyObject* chkprimdict_update(PyObject* self, PyObject* other) {
+  if (chkprimdict_merge((CiChkPrimDictObject*)self, other) < 0) {
+    return NULL;
+  }
+  Py_RETURN_NONE;
+}
+
+enum { ITER_KEYS, ITER_VALUES, ITER_ITEMS };
+
+static PyObject* chkprimdict_box_entry(
+    CiChkPrimDictObject* mp,
+    ChkPrimDictEntry* entry,
+    int kind) {
+  if (kind == ITER_KEYS) {
+    return chkprimdict_box(entry->key, mp->ma_key_type);
+  } else if (kind == ITER_VALUES) {
+    return chkprimdict_box(entry->value, mp->ma_value_type);
+  }
+  PyObject* key = chkprimdict_box(entry->key, mp->ma_key_type);
+  if (key == NULL) {
+    return NULL;
+  }
+  PyObject* value = chkprimdict_box(entry->value, mp->ma_value_type);
+  if (value == NULL) {
+    Py_DECREF(key);
+    return NULL;
+  }
+  PyObject* item = PyTuple_Pack(2, key, value);
+  Py_DECREF(key);
+  Py_DECREF(value);
+  return item;
+}
+
+/* keys(), values() and items() return lists rather than views. */
+static PyObject* chkprimdict_to_list(CiChkPrimDictObject* mp, int kind) {
+  PyObject* list = PyList_New(mp->ma_used);
+  if (list == NULL) {
+    return NULL;
+  }
+  ChkPrimDictTable* table = mp->ma_table;
+  Py_ssize_t n = 0;
+  for (Py_ssize_t i = 0; table != NULL && i < table->pt_nentries; i++) {
+    if (table_deleted(table)[i]) {
+      continue;
+    }
+    PyObject* item = chkprimdict_box_entry(mp, &table_entries(table)[i], kind);
+    if (item == NULL) {
+      Py_DECREF(list);
+      return NULL;
+    }
+    PyList_SET_ITEM(list, n++, item);
+  }
+  assert(n == mp->ma_used);
+  return list;
+}
+
+static PyObject* chkprimdict_keys(
+    PyObject* self,
+    PyObject* Py_UNUSED(ignored)) {
+  return chkprimdict_to_list((CiChkPrimDictObject*)self, ITER_KEYS);
+}
+
+static PyObject* chkprimdict_values(
+    PyObject* self,
+    PyObject* Py_UNUSED(ignored)) {
+  return chkprimdict_to_list((CiChkPrimDictObject*)self, ITER_VALUES);
+}
+
+static PyObject* chkprimdict_items(
+    PyObject* self,
+    PyObject* Py_UNUSED(ignored)) {
+  return chkprimdict_to_list((CiChkPrimDictObject*)self, ITER_ITEMS);
+}
+
+static PyObject* chkprimdict_sizeof(
+    PyObject* self,
+    PyObject* Py_UNUSED(ignored)) {
+  CiChkPrimDictObject* mp = (CiChkPrimDictObject*)self;
+  Py_ssize_t res = _PyObject_SIZE(Py_TYPE(mp));
+  if (mp->ma_table != NULL) {
+    res += table_bytes(mp->ma_table->pt_size);
+  }
+  return PyLong_FromSsize_t(res);
+}
+
+static PyObject* chkprimdict_cls_getitem(
+    _PyGenericTypeDef* type,
+    PyObject* args) {
+  if (!chkprimdict_can_store_args(args)) {
+    PyErr_SetString(
+        PyExc_TypeError,
+        "chkprimdict keys and values must be int8 through uint64, double or "
+        "cbool");
+    return NULL;
+  }
+  return _PyClassLoader_GtdGetItem(type, args);
+}
+
+static PyObject* chkprimdict_to_dict(CiChkPrimDictObject* mp) {
+  PyObject* dict = PyDict_New();
+  if (dict == NULL) {
+    return NULL;
+  }
+  ChkPrimDictTable* table = mp->ma_table;
+  for (Py_ssize_t i = 0; table != NULL && i < table->pt_nentries; i++) {
+    if (table_deleted(table)[i]) {
+      continue;
+    }
+    ChkPrimDictEntry* entry = &table_entries(table)[i];
+    PyObject* key = chkprimdict_box(entry->key, mp->ma_key_type);
+    PyObject* value = key == NULL
+        ? NULL
+        : chkprimdict_box(entry->value, mp->ma_value_type);
+    if (value == NULL || PyDict_SetItem(dict, key, value) < 0) {
+      Py_XDECREF(key);
+      Py_XDECREF(value);
+      Py_DECREF(dict);
+      return NULL;
+    }
+    Py_DECREF(key);
+    Py_DECREF(value);
+  }
+  return dict;
+}
+
+static PyObject* chkprimdict_repr(CiChkPrimDictObject* mp) {
+  PyObject* dict = chkprimdict_to_dict(mp);
+  if (dict == NULL) {
+    return NULL;
+  }
+  PyObject* res = PyObject_Repr(dict);
+  Py_DECREF(dict);
+  return res;
+}
+
+static PyObject* chkprimdict_richcompare(PyObject* v, PyObject* w, int op) {
+  if ((op != Py_EQ && op != Py_NE) ||
+      !(PyDict_Check(w) || Ci_CheckedPrimDict_Check(w))) {
+    Py_RETURN_NOTIMPLEMENTED;
+  }
+  PyObject* self_dict = chkprimdict_to_dict((CiChkPrimDictObject*)v);
+  if (self_dict == NULL) {
+    return NULL;
+  }
+  PyObject* other_dict = Ci_CheckedPrimDict_Check(w)
+      ? chkprimdict_to_dict((CiChkPrimDictObject*)w)
+      : Py_NewRef(w);
+  if (other_dict == NULL) {
+    Py_DECREF(self_dict);
+    return NULL;
+  }
+  PyObject* res = PyObject_RichCompare(self_dict, other_dict, op);
+  Py_DECREF(self_dict);
+  Py_DECREF(other_dict);
+  return res;
+}
+
+/* Iterators */
+
+typedef struct {
+  PyObject_HEAD
+  CiChkPrimDictObject* di_dict; /* Set to NULL when iterator is exhausted */
+  Py_ssize_t di_used;
+  Py_ssize_t di_pos;
+} chkprimdictiterobject;
+
+static PyObject* chkprimdict_iter(CiChkPrimDictObject* mp) {
+  chkprimdictiterobject* di =
+      PyObject_New(chkprimdictiterobject, Ci_CheckedPrimDictIter_Type);
+  if (di == NULL) {
+    return NULL;
+  }
+  di->di_dict = (CiChkPrimDictObject*)Py_NewRef(mp);
+  di->di_used = mp->ma_used;
+  di->di_pos = 0;
+  return (PyObject*)di;
+}
+
+static void chkprimdictiter_dealloc(chkprimdictiterobject* di) {
+  PyTypeObject* type = Py_TYPE(di);
+  Py_XDECREF(di->di_dict);
+  PyObject_Free(di);
+  Py_DECREF(type);
+}
+
+static PyObject* chkprimdictiter_iternext(chkprimdictiterobject* di) {
+  CiChkPrimDictObject* mp = di->di_dict;
+  if (mp == NULL) {
+    return NULL;
+  }
+  if (di->di_used != mp->ma_used) {
+    PyErr_SetString(
+        PyExc_RuntimeError, "dictionary changed size during iteration");
+    di->di_used = -1; /* Make this state sticky */
+    return NULL;
+  }
+  ChkPrimDictTable* table = mp->ma_table;
+  while (table != NULL && di->di_pos < table->pt_nentries) {
+    Py_ssize_t i = di->di_pos++;
+    if (!table_deleted(table)[i]) {
+      return chkprimdict_box(table_entries(table)[i].key, mp->ma_key_type);
+    }
+  }
+  di->di_dict = NULL;
+  Py_DECREF(mp);
+  return NULL;
+}
+
+static PyObject* chkprimdictiter_len(
+    chkprimdictiterobject* di,
+    PyObject* Py_UNUSED(ignored)) {
+  Py_ssize_t len = 0;
+  CiChkPrimDictObject* mp = di->di_dict;
+  if (mp != NULL && di->di_used == mp->ma_used && mp->ma_table != NULL) {
+    uint8_t* deleted = table_deleted(mp->ma_table);
+    for (Py_ssize_t i = di->di_pos; i < mp->ma_table->pt_nentries; i++) {
+      len += !deleted[i];
+    }
+  }
+  return PyLong_FromSsize_t(len);
+}
+
+static PyMethodDef chkprimdictiter_methods[] = {
+    {"__length_hint__",
+     (PyCFunction)chkprimdictiter_len,
+     METH_NOARGS,
+     PyDoc_STR("Private method returning an estimate of len(list(it)).")},
+    {NULL, NULL} /* sentinel */
+};
+
+static PyType_Slot chkprimdictiter_slots[] = {
+    {Py_tp_dealloc, (void*)chkprimdictiter_dealloc},
+    {Py_tp_iter, (void*)PyObject_SelfIter},
+    {Py_tp_iternext, (void*)chkprimdictiter_iternext},
+    {Py_tp_methods, (void*)chkprimdictiter_methods},
+    {0, NULL},
+};
+
+static PyType_Spec chkprimdictiter_spec = {
+    .name = "_static.chkprimdict_keyiterator",
+    .basicsize = sizeof(chkprimdictiterobject),
+    .flags = Py_TPFLAGS_DEFAULT | Py_TPFLAGS_DISALLOW_INSTANTIATION |
+        Py_TPFLAGS_IMMUTABLETYPE,
+    .slots = chkprimdictiter_slots,
+};
+
+static PyMethodDef chkprimdict_methods[] = {
+    {"__getitem__",
+     (PyCFunction)Ci_CheckedPrimDict_GetItem,
+     METH_O | METH_COEXIST,
+     PyDoc_STR("x.__getitem__(y) <==> x[y]")},
+    {"__setitem__",
+     (PyCFunction)(void (*)(void))Ci_CheckedPrimDict_SetItem,
+     METH_FASTCALL | METH_COEXIST,
+     PyDoc_STR("Set self[key] to value.")},
+    {"__contains__",
+     (PyCFunction)Ci_CheckedPrimDict_Contains,
+     METH_O | METH_COEXIST,
+     PyDoc_STR("True if the dictionary has the specified key, else False.")},
+    {"__sizeof__",
+     (PyCFunction)chkprimdict_sizeof,
+     METH_NOARGS,
+     PyDoc_STR("D.__sizeof__() -> size of D in memory, in bytes")},
+    {"get",
+     (PyCFunction)(void (*)(void))chkprimdict_get,
+     METH_FASTCALL,
+     PyDoc_STR("Return the value for key if key is in the dictionary, "
+               "else default.")},
+    {"pop",
+     (PyCFunction)(void (*)(void))chkprimdict_pop,
+     METH_FASTCALL,
+     PyDoc_STR("D.pop(k[,d]) -> v, remove specified key and return the "
+               "corresponding value.")},
+    {"keys",
+     (PyCFunction)chkprimdict_keys,
+     METH_NOARGS,
+     PyDoc_STR("D.keys() -> a list of D's keys")},
+    {"values",
+     (PyCFunction)chkprimdict_values,
+     METH_NOARGS,
+     PyDoc_STR("D.values() -> a list of D's values")},
+    {"items",
+     (PyCFunction)chkprimdict_items,
+     METH_NOARGS,
+     PyDoc_STR("D.items() -> a list of D's (key, value) pairs")},
+    {"update",
+     (PyCFunction)chkprimdict_update,
+     METH_O,
+     PyDoc_STR("D.update(E) -> None.  Update D from dict or iterable E.")},
+    {"clear",
+     (PyCFunction)chkprimdict_clear,
+     METH_NOARGS,
+     PyDoc_STR("D.clear() -> None.  Remove all items from D.")},
+    {"copy",
+     (PyCFunction)chkprimdict_copy,
+     METH_NOARGS,
+     PyDoc_STR("D.copy() -> a shallow copy of D")},
+    {"__class_getitem__",
+     (PyCFunction)chkprimdict_cls_getitem,
+     METH_VARARGS | METH_CLASS,
+     NULL},
+    {NULL, NULL} /* sentinel */
+};
+
+PyDoc_STRVAR(
+    chkprimdict_doc,
+    "chkprimdict[K, V]() -> new empty dictionary with primitive keys and\n"
+    "values\n"
+    "chkprimdict[K, V](mapping) -> new dictionary initialized from a\n"
+    "mapping object's (key, value) pairs\n"
+    "chkprimdict[K, V](iterable) -> new dictionary initialized from an\n"
+    "iterable of (key, value) pairs");
+
+_PyGenericTypeDef Ci_CheckedPrimDict_GenericType = {
+    .gtd_type =
+        {.ht_type =
+             {
+                 PyVarObject_HEAD_INIT(NULL, 0) "__static__.chkprimdict[K, V]",
+                 sizeof(CiChkPrimDictObject),
+                 0,
+                 (destructor)chkprimdict_dealloc, /* tp_dealloc */
+                 0, /* tp_vectorcall_offset */
+                 0, /* tp_getattr */
+                 0, /* tp_setattr */
+                 0, /* tp_as_async */
+                 (reprfunc)chkprimdict_repr, /* tp_repr */
+                 0, /* tp_as_number */
+                 &chkprimdict_as_sequence, /* tp_as_sequence */
+                 &chkprimdict_as_mapping, /* tp_as_mapping */
+                 PyObject_HashNotImplemented, /* tp_hash */
+                 0, /* tp_call */
+                 0, /* tp_str */
+                 PyObject_GenericGetAttr, /* tp_getattro */
+                 0, /* tp_setattro */
+                 0, /* tp_as_buffer */
+                 Py_TPFLAGS_DEFAULT |
+                     Ci_Py_TPFLAGS_GENERIC_TYPE_DEF, /* tp_flags */
+                 chkprimdict_doc, /* tp_doc */
+                 0, /* tp_traverse */
+                 0, /* tp_clear */
+                 chkprimdict_richcompare, /* tp_richcompare */
+                 0, /* tp_weaklistoffset */
+                 (getiterfunc)chkprimdict_iter, /* tp_iter */
+                 0, /* tp_iternext */
+                 chkprimdict_methods, /* tp_methods */
+                 0, /* tp_members */
+                 0, /* tp_getset */
+                 0, /* tp_base */
+                 0, /* tp_dict */
+                 0, /* tp_descr_get */
+                 0, /* tp_descr_set */
+                 0, /* tp_dictoffset */
+                 chkprimdict_init, /* tp_init */
+                 chkprimdict_alloc, /* tp_alloc */
+                 NULL, /* tp_new */
+                 PyObject_Free, /* tp_free */
+             }},
+    .gtd_size = 2};
+
+int Ci_CheckedPrimDict_InitTypes(void) {
+  Ci_CheckedPrimDict_GenericType.gtd_type.ht_type.ob_base.ob_base.ob_type =
+      &PyType_Type;
+  if ((Ci_CheckedPrimDict_Type = _PyClassLoader_MakeGenericHeapType(
+           &Ci_CheckedPrimDict_GenericType)) == NULL) {
+    return -1;
+  }
+  if ((Ci_CheckedPrimDictIter_Type =
+           (PyTypeObject*)PyType_FromSpec(&chkprimdictiter_spec)) == NULL) {
+    Py_CLEAR(Ci_CheckedPrimDict_Type);
+    return -1;
+  }
+  return 0;
+}
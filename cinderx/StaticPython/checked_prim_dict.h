@@ -0,0 +1,70 @@
+/* Copyright (c) Meta Platforms, Inc. and affiliates. */
+#pragma once
+
+#include "cinderx/python.h"
+
+#include "cinderx/StaticPython/generic_type.h"
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * chkprimdict[K, V], spelled CheckedPrimDict[K, V] in Static Python, is a dict
+ * whose keys and values are primitive types (int8 through uint64, double or
+ * cbool).  Keys and values are stored unboxed in an open addressing table.
+ * Unlike chkdict it isn't a dict subclass.
+ */
+extern PyTypeObject* Ci_CheckedPrimDict_Type;
+extern _PyGenericTypeDef Ci_CheckedPrimDict_GenericType;
+extern PyTypeObject* Ci_CheckedPrimDictIter_Type;
+
+/* Creates Ci_CheckedPrimDict_Type and its iterator type. */
+int Ci_CheckedPrimDict_InitTypes(void);
+
+int Ci_CheckedPrimDict_Check(PyObject* x);
+int Ci_CheckedPrimDict_TypeCheck(PyTypeObject* type);
+
+/* Returns the TYPED_* code of the keys or values of a chkprimdict type. */
+int Ci_CheckedPrimDict_KeyType(PyTypeObject* type);
+int Ci_CheckedPrimDict_ValueType(PyTypeObject* type);
+
+/* The C functions behind __getitem__, __setitem__ and __contains__, which the
+ * JIT recognizes to call the unboxed entry points below instead. */
+PyObject* Ci_CheckedPrimDict_GetItem(PyObject* self, PyObject* key);
+PyObject* Ci_CheckedPrimDict_SetItem(
+    PyObject* self,
+    PyObject* const* args,
+    Py_ssize_t nargs);
+PyObject* Ci_CheckedPrimDict_Contains(PyObject* self, PyObject* key);
+
+/*
+ * Unboxed entry points used by JIT compiled code.  Integer and cbool keys and
+ * values are passed widened to 64 bits, double ones as a double.
+ *
+ * The lookups return the index of the entry holding the key, or -1 with
+ * KeyError set when it's missing.  The index is only valid until the
+ * dictionary is next modified.
+ */
+Py_ssize_t Ci_CheckedPrimDict_LookupInt(PyObject* self, int64_t key);
+Py_ssize_t Ci_CheckedPrimDict_LookupDouble(PyObject* self, double key);
+int64_t Ci_CheckedPrimDict_IntValueAt(PyObject* self, Py_ssize_t index);
+double Ci_CheckedPrimDict_DoubleValueAt(PyObject* self, Py_ssize_t index);
+
+int Ci_CheckedPrimDict_ContainsInt(PyObject* self, int64_t key);
+int Ci_CheckedPrimDict_ContainsDouble(PyObject* self, double key);
+
+/* Return 0 on success, or -1 with an exception set. */
+int Ci_CheckedPrimDict_SetIntInt(PyObject* self, int64_t key, int64_t value);
+int Ci_CheckedPrimDict_SetIntDouble(PyObject* self, int64_t key, double value);
+int Ci_CheckedPrimDict_SetDoubleInt(PyObject* self, double key, int64_t value);
+int Ci_CheckedPrimDict_SetDoubleDouble(
+    PyObject* self,
+    double key,
+    double value);
+
+#ifdef __cplusplus
+}
+#endif
@@ -126,8 +126,24 @@ int _PyClassLoader_IsFinalMethodOverridden(
 #define SEQ_REPEAT_PRIMITIVE_NUM (1 << 7)
 
 // For arrays, the constant contains the element type in the higher
-// nibble
+// nibble.  Only the integer type codes fit alongside TYPED_ARRAY, so arrays of
+// other primitives also set SEQ_ARRAY_NONINT and use the whole nibble (which
+// has the TYPED_ARRAY bit set anyway).
+#define SEQ_ARRAY_INT8 ((TYPED_INT8 << 4) | TYPED_ARRAY)
+#define SEQ_ARRAY_INT16 ((TYPED_INT16 << 4) | TYPED_ARRAY)
+#define SEQ_ARRAY_INT32 ((TYPED_INT32 << 4) | TYPED_ARRAY)
 #define SEQ_ARRAY_INT64 ((TYPED_INT64 << 4) | TYPED_ARRAY)
+#define SEQ_ARRAY_UINT8 ((TYPED_UINT8 << 4) | TYPED_ARRAY)
+#define SEQ_ARRAY_UINT16 ((TYPED_UINT16 << 4) | TYPED_ARRAY)
+#define SEQ_ARRAY_UINT32 ((TYPED_UINT32 << 4) | TYPED_ARRAY)
+#define SEQ_ARRAY_UINT64 ((TYPED_UINT64 << 4) | TYPED_ARRAY)
+#define SEQ_ARRAY_NONINT (1 << 9)
+#define SEQ_ARRAY_DOUBLE ((TYPED_DOUBLE << 4) | SEQ_ARRAY_NONINT)
+#define SEQ_ARRAY_BOOL ((TYPED_BOOL << 4) | SEQ_ARRAY_NONINT)
+#define SEQ_IS_ARRAY(seq_type) ((seq_type) & TYPED_ARRAY)
+#define SEQ_ARRAY_ELEMENT_TYPE(seq_type)                     \
+  (((seq_type) & SEQ_ARRAY_NONINT) ? ((seq_type) >> 4) & 0xF \
+                                   : ((seq_type) >> 4) & 0x7)
 #define SEQ_REPEAT_FLAGS                                                   \
   (SEQ_REPEAT_INEXACT_SEQ | SEQ_REPEAT_INEXACT_NUM | SEQ_REPEAT_REVERSED | \
    SEQ_REPEAT_PRIMITIVE_NUM)
@@ -2,48 +2,157 @@
 
 #include "cinderx/StaticPython/static_array.h"
 
+#include "cinderx/StaticPython/type_code.h"
+
 #if PY_VERSION_HEX >= 0x030D0000
 #include "internal/pycore_modsupport.h"
 #endif
 
 /**
  *   Lightweight implementation of Static Arrays.
+ *
+ *   Every element type gets its own type object.  The item accessors and the
+ *   bulk operations are stamped out per element type by
+ *   STATICARRAY_DEFINE_ELEMENT_TYPE, the bulk operations being plain loops
+ *   over ob_item which the C compiler vectorizes.
+ */
+
+/* X(name, type code, C element type, C type used for arithmetic, category,
+ *   type name)
+ *
+ * Integer arithmetic is done in an unsigned type at least as wide as int so
+ * that it wraps around like the primitive Static Python operations do.
  */
+#define STATICARRAY_ELEMENT_TYPES(X)                                           \
+  X(int8, TYPED_INT8, int8_t, unsigned int, SIGNED, "staticarray[int8]")       \
+  X(int16, TYPED_INT16, int16_t, unsigned int, SIGNED, "staticarray[int16]")   \
+  X(int32, TYPED_INT32, int32_t, uint32_t, SIGNED, "staticarray[int32]")       \
+  X(int64, TYPED_INT64, int64_t, uint64_t, SIGNED, "staticarray")              \
+  X(uint8, TYPED_UINT8, uint8_t, unsigned int, UNSIGNED, "staticarray[uint8]") \
+  X(uint16,                                                                    \
+    TYPED_UINT16,                                                              \
+    uint16_t,                                                                  \
+    unsigned int,                                                              \
+    UNSIGNED,                                                                  \
+    "staticarray[uint16]")                                                     \
+  X(uint32, TYPED_UINT32, uint32_t, uint32_t, UNSIGNED, "staticarray[uint32]") \
+  X(uint64, TYPED_UINT64, uint64_t, uint64_t, UNSIGNED, "staticarray[uint64]") \
+  X(single, TYPED_SINGLE, float, float, FLOAT, "staticarray[single]")          \
+  X(double, TYPED_DOUBLE, double, double, FLOAT, "staticarray[double]")        \
+  X(cbool, TYPED_BOOL, uint8_t, unsigned int, BOOL, "staticarray[cbool]")
+
+#define STATICARRAY_ITEMS(op, ctype) \
+  ((ctype*)((PyStaticArrayObject*)(op))->ob_item)
+
+/* Boxing and unboxing for each category of element type.  Values are unboxed
+ * into the widest C type of their category and then range checked against
+ * the element type. */
+
+#define STATICARRAY_WIDE_SIGNED long long
+#define STATICARRAY_WIDE_UNSIGNED unsigned long long
+#define STATICARRAY_WIDE_FLOAT double
+#define STATICARRAY_WIDE_BOOL int
+
+#define STATICARRAY_UNBOX_SIGNED staticarray_unbox_signed
+#define STATICARRAY_UNBOX_UNSIGNED staticarray_unbox_unsigned
+#define STATICARRAY_UNBOX_FLOAT staticarray_unbox_float
+#define STATICARRAY_UNBOX_BOOL staticarray_unbox_bool
+
+#define STATICARRAY_FITS_SIGNED(ctype, v) ((long long)(ctype)(v) == (v))
+#define STATICARRAY_FITS_UNSIGNED(ctype, v) \
+  ((unsigned long long)(ctype)(v) == (v))
+#define STATICARRAY_FITS_FLOAT(ctype, v) 1
+#define STATICARRAY_FITS_BOOL(ctype, v) 1
+
+#define STATICARRAY_BOX_SIGNED(v) PyLong_FromLongLong((long long)(v))
+#define STATICARRAY_BOX_UNSIGNED(v) \
+  PyLong_FromUnsignedLongLong((unsigned long long)(v))
+#define STATICARRAY_BOX_FLOAT(v) PyFloat_FromDouble((double)(v))
+#define STATICARRAY_BOX_BOOL(v) PyBool_FromLong(v)
+
+/* sum() accumulates integers in 64 bits, wrapping around on overflow like
+ * int64 arithmetic, and floating point values as a double. */
+
+#define STATICARRAY_ACC_SIGNED unsigned long long
+#define STATICARRAY_ACC_UNSIGNED unsigned long long
+#define STATICARRAY_ACC_FLOAT double
+#define STATICARRAY_ACC_BOOL unsigned long long
+
+#define STATICARRAY_BOX_SUM_SIGNED(v) PyLong_FromLongLong((long long)(v))
+#define STATICARRAY_BOX_SUM_UNSIGNED(v) PyLong_FromUnsignedLongLong(v)
+#define STATICARRAY_BOX_SUM_FLOAT(v) PyFloat_FromDouble(v)
+#define STATICARRAY_BOX_SUM_BOOL(v) PyLong_FromUnsignedLongLong(v)
+
+static int staticarray_unbox_signed(PyObject* value, long long* out) {
+  PyObject* index = PyNumber_Index(value);
+  if (index == NULL) {
+    return -1;
+  }
+  *out = PyLong_AsLongLong(index);
+  Py_DECREF(index);
+  return *out == -1 && PyErr_Occurred() ? -1 : 0;
+}
 
-#define ArrayItemType int64_t
+static int staticarray_unbox_unsigned(
+    PyObject* value,
+    unsigned long long* out) {
+  PyObject* index = PyNumber_Index(value);
+  if (index == NULL) {
+    return -1;
+  }
+  *out = PyLong_AsUnsignedLongLong(index);
+  Py_DECREF(index);
+  return *out == (unsigned long long)-1 && PyErr_Occurred() ? -1 : 0;
+}
+
+static int staticarray_unbox_float(PyObject* value, double* out) {
+  *out = PyFloat_AsDouble(value);
+  return *out == -1.0 && PyErr_Occurred() ? -1 : 0;
+}
 
-PyType_Spec PyStaticArray_Spec;
+static int staticarray_unbox_bool(PyObject* value, int* out) {
+  if (!PyBool_Check(value)) {
+    PyErr_Format(
+        PyExc_TypeError,
+        "expected bool, got %.200s",
+        Py_TYPE(value)->tp_name);
+    return -1;
+  }
+  *out = value == Py_True;
+  return 0;
+}
 
-static void staticarray_dealloc(PyStaticArrayObject* op) {
+void _Ci_StaticArray_Dealloc(PyObject* op) {
   PyObject_GC_UnTrack(op);
   PyTypeObject* type = Py_TYPE(op);
-  type->tp_free((PyObject*)op);
+  type->tp_free(op);
   Py_DECREF(type);
 }
 
-static PyStaticArrayObject* staticarray_alloc(Py_ssize_t size) {
+static PyStaticArrayObject* staticarray_alloc(
+    PyTypeObject* type,
+    Py_ssize_t size) {
   PyStaticArrayObject* op =
-      PyObject_GC_NewVar(PyStaticArrayObject, PyStaticArray_Type, size);
+      PyObject_GC_NewVar(PyStaticArrayObject, type, size);
   return op;
 }
 
 static inline void staticarray_zeroinitialize(
     PyStaticArrayObject* sa,
     Py_ssize_t size) {
-  memset(sa->ob_item, 0, size * PyStaticArray_Spec.itemsize);
+  memset(sa->ob_item, 0, size * Py_TYPE(sa)->tp_itemsize);
 }
 
 static PyObject* staticarray_to_list(PyObject* sa) {
-  PyStaticArrayObject* array = (PyStaticArrayObject*)sa;
   PyObject* list = PyList_New(Py_SIZE(sa));
 
   if (list == NULL) {
     return NULL;
   }
 
+  ssizeargfunc getitem = Py_TYPE(sa)->tp_as_sequence->sq_item;
   for (Py_ssize_t i = 0; i < Py_SIZE(sa); i++) {
-    ArrayItemType val = array->ob_item[i];
-    PyObject* boxed_val = PyLong_FromLong(val);
+    PyObject* boxed_val = getitem(sa, i);
     if (boxed_val == NULL) {
       Py_DECREF(list);
       return NULL;
@@ -58,8 +167,8 @@ static PyObject* staticarray_repr(PyObject* sa) {
   if (list == NULL) {
     return NULL;
   }
-  PyObject* res =
-      PyUnicode_FromFormat("staticarray[%d](%R)", Py_SIZE(sa), list);
+  PyObject* res = PyUnicode_FromFormat(
+      "%s[%zd](%R)", Py_TYPE(sa)->tp_name, Py_SIZE(sa), list);
   Py_DECREF(list);
   return res;
 }
@@ -77,11 +186,14 @@ static PyObject* staticarray_concat(
     PyObject* other) {
   Py_ssize_t size;
   PyStaticArrayObject* np;
-  if (!PyStaticArray_CheckExact(other)) {
+  PyTypeObject* type = Py_TYPE(first);
+  if (!Py_IS_TYPE(other, type)) {
     PyErr_Format(
         PyExc_TypeError,
-        "can only append staticarray (not \"%.200s\") to staticarray",
-        Py_TYPE(other)->tp_name);
+        "can only append %s (not \"%.200s\") to %s",
+        type->tp_name,
+        Py_TYPE(other)->tp_name,
+        type->tp_name);
     return NULL;
   }
   PyStaticArrayObject* second = (PyStaticArrayObject*)other;
@@ -89,17 +201,18 @@ static PyObject* staticarray_concat(
     return PyErr_NoMemory();
   }
   size = Py_SIZE(first) + Py_SIZE(second);
-  np = staticarray_alloc(size);
+  np = staticarray_alloc(type, size);
   if (np == NULL) {
     return NULL;
   }
-  Py_ssize_t itemsize = PyStaticArray_Spec.itemsize;
+  Py_ssize_t itemsize = type->tp_itemsize;
+  char* items = (char*)np->ob_item;
   if (Py_SIZE(first) > 0) {
-    memcpy(np->ob_item, first->ob_item, Py_SIZE(first) * itemsize);
+    memcpy(items, first->ob_item, Py_SIZE(first) * itemsize);
   }
   if (Py_SIZE(second) > 0) {
     memcpy(
-        np->ob_item + Py_SIZE(first),
+        items + Py_SIZE(first) * itemsize,
         second->ob_item,
         Py_SIZE(second) * itemsize);
   }
@@ -109,14 +222,15 @@ static PyObject* staticarray_concat(
 static PyObject* staticarray_repeat(PyStaticArrayObject* array, Py_ssize_t n) {
   Py_ssize_t size;
   PyStaticArrayObject* np;
+  PyTypeObject* type = Py_TYPE(array);
   if (n < 0) {
-    return (PyObject*)staticarray_alloc(0);
+    return (PyObject*)staticarray_alloc(type, 0);
   }
   if ((Py_SIZE(array) != 0) && (n > PY_SSIZE_T_MAX / Py_SIZE(array))) {
     return PyErr_NoMemory();
   }
   size = Py_SIZE(array) * n;
-  np = (PyStaticArrayObject*)staticarray_alloc(size);
+  np = staticarray_alloc(type, size);
   if (np == NULL) {
     return NULL;
   }
@@ -124,52 +238,44 @@ static PyObject* staticarray_repeat(PyStaticArrayObject* array, Py_ssize_t n) {
     return (PyObject*)np;
   }
 
-  Py_ssize_t oldsize = Py_SIZE(array);
+  Py_ssize_t itemsize = type->tp_itemsize;
+  Py_ssize_t oldsize = Py_SIZE(array) * itemsize;
   Py_ssize_t newsize = oldsize * n;
-  Py_ssize_t itemsize = PyStaticArray_Spec.itemsize;
+  char* items = (char*)np->ob_item;
 
   Py_ssize_t done = oldsize;
-  memcpy(np->ob_item, array->ob_item, oldsize * itemsize);
+  memcpy(items, array->ob_item, oldsize);
   while (done < newsize) {
     Py_ssize_t ncopy = (done <= newsize - done) ? done : newsize - done;
-    memcpy(np->ob_item + done, np->ob_item, ncopy * itemsize);
+    memcpy(items + done, items, ncopy);
     done += ncopy;
   }
 
   return (PyObject*)np;
 }
 
-static PyObject* staticarray_getitem(
-    PyStaticArrayObject* array,
-    Py_ssize_t index) {
-  index = index < 0 ? index + Py_SIZE(array) : index;
-  if (index < 0 || index >= Py_SIZE(array)) {
-    PyErr_SetString(PyExc_IndexError, "array index out of range");
+static PyObject* staticarray_copy(PyObject* self, PyObject* Py_UNUSED(args)) {
+  PyTypeObject* type = Py_TYPE(self);
+  PyStaticArrayObject* np = staticarray_alloc(type, Py_SIZE(self));
+  if (np == NULL) {
     return NULL;
   }
-  assert(PyStaticArray_Spec.itemsize == sizeof(long));
-  return PyLong_FromLong(array->ob_item[index]);
-}
-
-static int staticarray_setitem(
-    PyStaticArrayObject* array,
-    Py_ssize_t index,
-    PyObject* value) {
-  index = index < 0 ? index + Py_SIZE(array) : index;
-  if (index < 0 || index >= Py_SIZE(array)) {
-    PyErr_SetString(PyExc_IndexError, "array index out of range");
-    return -1;
-  }
-  assert(PyStaticArray_Spec.itemsize == sizeof(long));
-  ArrayItemType val = PyLong_AsLong(value);
-  if (val == -1 && PyErr_Occurred()) {
-    return -1;
-  }
-  array->ob_item[index] = val;
-  return 0;
+  memcpy(
+      np->ob_item,
+      ((PyStaticArrayObject*)self)->ob_item,
+      Py_SIZE(self) * type->tp_itemsize);
+  return (PyObject*)np;
 }
 
 PyObject* staticarray___class_getitem__(PyObject* origin, PyObject* args) {
+  if (PyType_Check(args)) {
+    PyTypeObject* type = _Ci_StaticArray_TypeForElement(
+        _PyClassLoader_GetTypeCode((PyTypeObject*)args));
+    if (type != NULL) {
+      Py_INCREF(type);
+      return (PyObject*)type;
+    }
+  }
   Py_INCREF(origin);
   return origin;
 }
@@ -197,46 +303,302 @@ PyObject* staticarray_new(PyTypeObject* type, PyObject* args, PyObject* kwds) {
   return (PyObject*)new;
 }
 
-static PyMethodDef staticarray_methods[] = {
-    {"__class_getitem__",
-     (PyCFunction)staticarray___class_getitem__,
-     METH_O | METH_CLASS,
-     PyDoc_STR("")},
-    {NULL, NULL} /* sentinel */
-};
-
-PyType_Slot staticarray_slots[] = {
-    {Py_tp_dealloc, staticarray_dealloc},
-    {Py_tp_free, PyObject_GC_Del},
-    {Py_tp_repr, staticarray_repr},
-    {Py_tp_methods, staticarray_methods},
-    {Py_tp_new, staticarray_new},
-    {Py_sq_length, staticarray_length},
-    {Py_sq_concat, staticarray_concat},
-    {Py_sq_repeat, staticarray_repeat},
-    {Py_sq_item, staticarray_getitem},
-    {Py_sq_ass_item, staticarray_setitem},
-    {Py_tp_traverse, staticarray_traverse},
-    {}};
-
-PyType_Spec PyStaticArray_Spec = {
-    .name = "__static__.staticarray",
-    .basicsize = sizeof(PyStaticArrayObject),
-    .itemsize = sizeof(ArrayItemType),
-    .flags = Py_TPFLAGS_DEFAULT | Py_TPFLAGS_HAVE_GC,
-    .slots = staticarray_slots,
-};
+/* Methods and slots shared by all of the array types. */
+#define STATICARRAY_COMMON_METHODS             \
+  {"__class_getitem__",                        \
+   (PyCFunction)staticarray___class_getitem__, \
+   METH_O | METH_CLASS,                        \
+   PyDoc_STR("")},                             \
+      {"copy",                                 \
+       (PyCFunction)staticarray_copy,          \
+       METH_NOARGS,                            \
+       PyDoc_STR("Return a copy of the array.")}
+
+#define STATICARRAY_COMMON_SLOTS            \
+  {Py_tp_dealloc, _Ci_StaticArray_Dealloc}, \
+      {Py_tp_free, PyObject_GC_Del},        \
+      {Py_tp_repr, staticarray_repr},       \
+      {Py_tp_new, staticarray_new},         \
+      {Py_sq_length, staticarray_length},   \
+      {Py_sq_concat, staticarray_concat},   \
+      {Py_sq_repeat, staticarray_repeat},   \
+      {Py_tp_traverse, staticarray_traverse}
+
+#define STATICARRAY_ADD 0
+#define STATICARRAY_SUB 1
+#define STATICARRAY_MUL 2
+
+/* Applies op elementwise to items[0:n] and rhs, where rhs may refer to i to
+ * pick the matching element of another array. */
+#define STATICARRAY_BINOP_LOOP(op, ctype, arith_t, items, n, rhs) \
+  switch (op) {                                                   \
+    case STATICARRAY_ADD:                                         \
+      for (Py_ssize_t i = 0; i < (n); i++) {                      \
+        items[i] = (ctype)((arith_t)items[i] + (arith_t)(rhs));   \
+      }                                                           \
+      break;                                                      \
+    case STATICARRAY_SUB:                                         \
+      for (Py_ssize_t i = 0; i < (n); i++) {                      \
+        items[i] = (ctype)((arith_t)items[i] - (arith_t)(rhs));   \
+      }                                                           \
+      break;                                                      \
+    case STATICARRAY_MUL:                                         \
+      for (Py_ssize_t i = 0; i < (n); i++) {                      \
+        items[i] = (ctype)((arith_t)items[i] * (arith_t)(rhs));   \
+      }                                                           \
+      break;                                                      \
+  }
+
+#define STATICARRAY_DEFINE_ELEMENT_TYPE(                                    \
+    elem, code, ctype, arith_t, category, type_name)                        \
+  static int staticarray_##elem##_unbox(PyObject* value, ctype* out) {      \
+    STATICARRAY_WIDE_##category wide;                                       \
+    if (STATICARRAY_UNBOX_##category(value, &wide) < 0) {                   \
+      return -1;                                                            \
+    }                                                                       \
+    if (!STATICARRAY_FITS_##category(ctype, wide)) {                        \
+      PyErr_SetString(                                                      \
+          PyExc_OverflowError, "value out of range for " #elem " element"); \
+      return -1;                                                            \
+    }                                                                       \
+    *out = (ctype)wide;                                                     \
+    return 0;                                                               \
+  }                                                                         \
+                                                                            \
+  static PyObject* staticarray_##elem##_getitem(                            \
+      PyStaticArrayObject* array, Py_ssize_t index) {                       \
+    index = index < 0 ? index + Py_SIZE(array) : index;                     \
+    if (index < 0 || index >= Py_SIZE(array)) {                             \
+      PyErr_SetString(PyExc_IndexError, "array index out of range");        \
+      return NULL;                                                          \
+    }                                                                       \
+    ctype* items = STATICARRAY_ITEMS(array, ctype);                         \
+    return STATICARRAY_BOX_##category(items[index]);                        \
+  }                                                                         \
+                                                                            \
+  static int staticarray_##elem##_setitem(                                  \
+      PyStaticArrayObject* array, Py_ssize_t index, PyObject* value) {      \
+    if (value == NULL) {                                                    \
+      PyErr_SetString(PyExc_TypeError, "cannot delete array elements");     \
+      return -1;                                                            \
+    }                                                                       \
+    index = index < 0 ? index + Py_SIZE(array) : index;                     \
+    if (index < 0 || index >= Py_SIZE(array)) {                             \
+      PyErr_SetString(PyExc_IndexError, "array index out of range");        \
+      return -1;                                                            \
+    }                                                                       \
+    return staticarray_##elem##_unbox(                                      \
+        value, &STATICARRAY_ITEMS(array, ctype)[index]);                    \
+  }                                                                         \
+                                                                            \
+  static PyObject* staticarray_##elem##_fill(                               \
+      PyObject* self, PyObject* value) {                                    \
+    ctype val;                                                              \
+    if (staticarray_##elem##_unbox(value, &val) < 0) {                      \
+      return NULL;                                                          \
+    }                                                                       \
+    ctype* items = STATICARRAY_ITEMS(self, ctype);                          \
+    Py_ssize_t n = Py_SIZE(self);                                           \
+    for (Py_ssize_t i = 0; i < n; i++) {                                    \
+      items[i] = val;                                                       \
+    }                                                                       \
+    Py_RETURN_NONE;                                                         \
+  }                                                                         \
+                                                                            \
+  static PyObject* staticarray_##elem##_sum(                                \
+      PyObject* self, PyObject* Py_UNUSED(args)) {                          \
+    const ctype* items = STATICARRAY_ITEMS(self, ctype);                    \
+    Py_ssize_t n = Py_SIZE(self);                                           \
+    STATICARRAY_ACC_##category acc = 0;                                     \
+    for (Py_ssize_t i = 0; i < n; i++) {                                    \
+      acc += items[i];                                                      \
+    }                                                                       \
+    return STATICARRAY_BOX_SUM_##category(acc);                             \
+  }                                                                         \
+                                                                            \
+  static PyObject* staticarray_##elem##_min(                                \
+      PyObject* self, PyObject* Py_UNUSED(args)) {                          \
+    const ctype* items = STATICARRAY_ITEMS(self, ctype);                    \
+    Py_ssize_t n = Py_SIZE(self);                                           \
+    if (n == 0) {                                                           \
+      PyErr_SetString(PyExc_ValueError, "min() of empty staticarray");      \
+      return NULL;                                                          \
+    }                                                                       \
+    ctype res = items[0];                                                   \
+    for (Py_ssize_t i = 1; i < n; i++) {                                    \
+      res = items[i] < res ? items[i] : res;                                \
+    }                                                                       \
+    return STATICARRAY_BOX_##category(res);                                 \
+  }                                                                         \
+                                                                            \
+  static PyObject* staticarray_##elem##_max(                                \
+      PyObject* self, PyObject* Py_UNUSED(args)) {                          \
+    const ctype* items = STATICARRAY_ITEMS(self, ctype);                    \
+    Py_ssize_t n = Py_SIZE(self);                                           \
+    if (n == 0) {                                                           \
+      PyErr_SetString(PyExc_ValueError, "max() of empty staticarray");      \
+      return NULL;                                                          \
+    }                                                                       \
+    ctype res = items[0];                                                   \
+    for (Py_ssize_t i = 1; i < n; i++) {                                    \
+      res = items[i] > res ? items[i] : res;                                \
+    }                                                                       \
+    return STATICARRAY_BOX_##category(res);                                 \
+  }                                                                         \
+                                                                            \
+  static PyObject* staticarray_##elem##_binop(                              \
+      PyObject* self, PyObject* other, int op) {                            \
+    if ((code) == TYPED_BOOL) {                                             \
+      PyErr_Format(                                                         \
+          PyExc_TypeError,                                                  \
+          "arithmetic is not supported on %s",                              \
+          Py_TYPE(self)->tp_name);                                          \
+      return NULL;                                                          \
+    }                                                                       \
+    ctype* items = STATICARRAY_ITEMS(self, ctype);                          \
+    Py_ssize_t n = Py_SIZE(self);                                           \
+    if (Py_IS_TYPE(other, Py_TYPE(self))) {                                 \
+      if (Py_SIZE(other) != n) {                                            \
+        PyErr_Format(                                                       \
+            PyExc_ValueError,                                               \
+            "staticarray sizes differ (%zd and %zd)",                       \
+            n,                                                              \
+            Py_SIZE(other));                                                \
+        return NULL;                                                        \
+      }                                                                     \
+      const ctype* other_items = STATICARRAY_ITEMS(other, ctype);           \
+      STATICARRAY_BINOP_LOOP(op, ctype, arith_t, items, n, other_items[i]); \
+    } else {                                                                \
+      ctype val;                                                            \
+      if (staticarray_##elem##_unbox(other, &val) < 0) {                    \
+        return NULL;                                                        \
+      }                                                                     \
+      STATICARRAY_BINOP_LOOP(op, ctype, arith_t, items, n, val);            \
+    }                                                                       \
+    Py_RETURN_NONE;                                                         \
+  }                                                                         \
+                                                                            \
+  static PyObject* staticarray_##elem##_add(                                \
+      PyObject* self, PyObject* other) {                                    \
+    return staticarray_##elem##_binop(self, other, STATICARRAY_ADD);        \
+  }                                                                         \
+                                                                            \
+  static PyObject* staticarray_##elem##_sub(                                \
+      PyObject* self, PyObject* other) {                                    \
+    return staticarray_##elem##_binop(self, other, STATICARRAY_SUB);        \
+  }                                                                         \
+                                                                            \
+  static PyObject* staticarray_##elem##_mul(                                \
+      PyObject* self, PyObject* other) {                                    \
+    return staticarray_##elem##_binop(self, other, STATICARRAY_MUL);        \
+  }                                                                         \
+                                                                            \
+  static PyMethodDef staticarray_##elem##_methods[] = {                     \
+      STATICARRAY_COMMON_METHODS,                                           \
+      {"fill",                                                              \
+       (PyCFunction)staticarray_##elem##_fill,                              \
+       METH_O,                                                              \
+       PyDoc_STR("Set every element to the given value.")},                 \
+      {"sum",                                                               \
+       (PyCFunction)staticarray_##elem##_sum,                               \
+       METH_NOARGS,                                                         \
+       PyDoc_STR("Return the sum of the elements.")},                       \
+      {"min",                                                               \
+       (PyCFunction)staticarray_##elem##_min,                               \
+       METH_NOARGS,                                                         \
+       PyDoc_STR("Return the smallest element.")},                          \
+      {"max",                                                               \
+       (PyCFunction)staticarray_##elem##_max,                               \
+       METH_NOARGS,                                                         \
+       PyDoc_STR("Return the largest element.")},                           \
+      {"add",                                                               \
+       (PyCFunction)staticarray_##elem##_add,                               \
+       METH_O,                                                              \
+       PyDoc_STR("Add an array of the same size or a scalar in place.")},   \
+      {"sub",                                                               \
+       (PyCFunction)staticarray_##elem##_sub,                               \
+       METH_O,                                                              \
+       PyDoc_STR("Subtract an array of the same size or a scalar in "       \
+                 "place.")},                                                \
+      {"mul",                                                               \
+       (PyCFunction)staticarray_##elem##_mul,                               \
+       METH_O,                                                              \
+       PyDoc_STR("Multiply by an array of the same size or a scalar in "    \
+                 "place.")},                                                \
+      {NULL, NULL} /* sentinel */                                           \
+  };                                                                        \
+                                                                            \
+  static PyType_Slot staticarray_##elem##_slots[] = {                       \
+      STATICARRAY_COMMON_SLOTS,                                             \
+      {Py_tp_methods, staticarray_##elem##_methods},                        \
+      {Py_sq_item, staticarray_##elem##_getitem},                           \
+      {Py_sq_ass_item, staticarray_##elem##_setitem},                       \
+      {}};                                                                  \
+                                                                            \
+  static PyType_Spec staticarray_##elem##_spec = {                          \
+      .name = "__static__." type_name,                                      \
+      .basicsize = sizeof(PyStaticArrayObject),                             \
+      .itemsize = sizeof(ctype),                                            \
+      .flags = Py_TPFLAGS_DEFAULT | Py_TPFLAGS_HAVE_GC |                    \
+          Py_TPFLAGS_IMMUTABLETYPE,                                         \
+      .slots = staticarray_##elem##_slots,                                  \
+  };
+
+STATICARRAY_ELEMENT_TYPES(STATICARRAY_DEFINE_ELEMENT_TYPE)
+
+typedef struct {
+  int type_code;
+  PyType_Spec* spec;
+} StaticArrayElementType;
+
+#define STATICARRAY_ELEMENT_TYPE_ENTRY(name, code, ...) \
+  {code, &staticarray_##name##_spec},
+
+static const StaticArrayElementType staticarray_element_types[] = {
+    STATICARRAY_ELEMENT_TYPES(STATICARRAY_ELEMENT_TYPE_ENTRY)};
+
+/* The array type for each TYPED_* code, or NULL for codes which can't be
+ * array elements. */
+static PyTypeObject* staticarray_types[TYPED_BOOL + 1];
 
 PyTypeObject* PyStaticArray_Type;
 
+int _Ci_StaticArray_InitTypes(void) {
+  for (size_t i = 0; i < Py_ARRAY_LENGTH(staticarray_element_types); i++) {
+    const StaticArrayElementType* elem = &staticarray_element_types[i];
+    PyTypeObject* type = (PyTypeObject*)PyType_FromSpec(elem->spec);
+    if (type == NULL) {
+      return -1;
+    }
+    Py_XSETREF(staticarray_types[elem->type_code], type);
+  }
+  PyStaticArray_Type = staticarray_types[TYPED_INT64];
+  Py_INCREF(PyStaticArray_Type);
+  return 0;
+}
+
+int _Ci_StaticArray_ElementType(PyTypeObject* type) {
+  for (size_t i = 0; i < Py_ARRAY_LENGTH(staticarray_types); i++) {
+    if (staticarray_types[i] == type) {
+      return (int)i;
+    }
+  }
+  return -1;
+}
+
+PyTypeObject* _Ci_StaticArray_TypeForElement(int type_code) {
+  if (type_code < 0 || type_code > TYPED_BOOL) {
+    return NULL;
+  }
+  return staticarray_types[type_code];
+}
+
 /** StaticArray internal C-API **/
 
 int _Ci_StaticArray_Set(PyObject* array, Py_ssize_t index, PyObject* value) {
-  PyStaticArrayObject* sa = (PyStaticArrayObject*)array;
-  return staticarray_setitem(sa, index, value);
+  return Py_TYPE(array)->tp_as_sequence->sq_ass_item(array, index, value);
 }
 
 PyObject* _Ci_StaticArray_Get(PyObject* array, Py_ssize_t index) {
-  PyStaticArrayObject* sa = (PyStaticArrayObject*)array;
-  return staticarray_getitem(sa, index);
+  return Py_TYPE(array)->tp_as_sequence->sq_item(array, index);
 }
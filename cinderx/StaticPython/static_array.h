@@ -8,9 +8,17 @@
 extern "C" {
 #endif
 
-extern PyType_Spec PyStaticArray_Spec;
+/*
+ * staticarray is the int64 array type.  Arrays of the other primitive
+ * element types are separate types, returned by staticarray[T], which share
+ * the PyStaticArrayObject layout with ob_item holding elements of type T.
+ */
 extern PyTypeObject* PyStaticArray_Type;
 #define PyStaticArray_CheckExact(op) Py_IS_TYPE(op, PyStaticArray_Type)
+/* The staticarray types, and only they, share a deallocator, so this is a
+ * single compare however many element types there are. */
+#define PyStaticArray_Check(op) \
+  (Py_TYPE(op)->tp_dealloc == _Ci_StaticArray_Dealloc)
 
 typedef struct {
   PyObject_VAR_HEAD
@@ -18,6 +26,19 @@ typedef struct {
       int64_t ob_item[1];
 } PyStaticArrayObject;
 
+void _Ci_StaticArray_Dealloc(PyObject* op);
+
+/* Creates PyStaticArray_Type and the types for the other element types. */
+int _Ci_StaticArray_InitTypes(void);
+
+/* Returns the TYPED_* code of the elements held by a staticarray type, or -1
+ * if type isn't one of the staticarray types. */
+int _Ci_StaticArray_ElementType(PyTypeObject* type);
+
+/* Returns the staticarray type holding elements with the given TYPED_* code,
+ * or NULL if there's no such type. */
+PyTypeObject* _Ci_StaticArray_TypeForElement(int type_code);
+
 int _Ci_StaticArray_Set(PyObject* array, Py_ssize_t index, PyObject* value);
 PyObject* _Ci_StaticArray_Get(PyObject* array, Py_ssize_t index);
 
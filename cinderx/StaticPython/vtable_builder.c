@@ -1006,6 +1006,14 @@ int _PyClassLoader_UpdateSlot(
         type->tp_name);
   }
 
+  /* Invalidate any JIT-compiled code which calls the method directly.  This
+     also needs to happen before we look into the vtable: code can be
+     devirtualized against a base class's method before type's own vtable has
+     been built. */
+  if (PyUnicode_Check(name)) {
+    Ci_NotifyStaticMethodOverride(type, name);
+  }
+
   _PyType_VTable* vtable = (_PyType_VTable*)type->tp_cache;
   if (vtable == NULL) {
     return 0;
@@ -1396,6 +1404,9 @@ int _PyClassLoader_AddSubclass(PyTypeObject* base, PyTypeObject* type) {
   if (track_subclasses(type) < 0 || track_dict(type) < 0) {
     return -1;
   }
+
+  // The new subclass may override methods that the JIT is calling directly.
+  Ci_NotifyStaticSubclassAdded(type);
   return 0;
 }
 
@@ -7318,6 +7318,17 @@ _PyMem_FreeDelayed(void *ptr, size_t size)
         free_delayed((uintptr_t)ptr, size);
     }
 }
+void
+_PyObject_XDecRefDelayed(PyObject *ptr)
+{
+    assert(!((uintptr_t)ptr & 0x01));
+    if (ptr != NULL) {
+        // We use 0 as the size since we don't have an easy way to know the
+        // actual size.  If we are freeing many objects, the write sequence
+        // will be advanced less often than it would be otherwise.
+        free_delayed(((uintptr_t)ptr)|0x01, 0);
+    }
+}
 static struct _mem_work_chunk *
 work_queue_first(struct llist_node *head)
 {
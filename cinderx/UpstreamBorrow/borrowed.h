@@ -20,6 +20,7 @@
 #define _PyList_GetItemRefNoLock _CiList_GetItemRefNoLock
 #define _Py_ExplicitMergeRefcount _Ci_ExplicitMergeRefcount
 #define _PyMem_FreeDelayed _CiMem_FreeDelayed
+#define _PyObject_XDecRefDelayed _CiObject_XDecRefDelayed
 #define _PyMem_ProcessDelayed _CiMem_ProcessDelayed
 #define _PyCode_Quicken _CiCode_Quicken
 #define _Py_qsbr_advance _Ci_qsbr_advance
@@ -168,6 +169,7 @@ extern "C" {
 #ifdef Py_GIL_DISABLED
 _Py_CODEUNIT* _PyCode_GetTLBC(PyCodeObject* co);
 void _PyMem_FreeDelayed(void* ptr, size_t size);
+void _PyObject_XDecRefDelayed(PyObject* obj);
 void _PyMem_ProcessDelayed(PyThreadState* tstate);
 #endif
 
@@ -51,6 +51,8 @@
 #include <dlfcn.h>
 #endif
 
+#include <algorithm>
+#include <thread>
 #include <utility>
 
 using namespace cinderx;
@@ -278,12 +280,70 @@ PyObject* cinder_get_threshold(PyObject* mod, PyObject*) {
 
 PyDoc_STRVAR(
     cinder_immortalize_heap_doc,
-    "immortalize_heap($module, /)\n"
-    "--\n"
-    "\n"
-    "Immortalize all instances accessible through the GC roots.");
-PyObject* cinder_immortalize_heap(PyObject* mod, PyObject* /* args */) {
-  return immortalize_heap(mod);
+    "immortalize_heap(num_threads=1, exclude_types=None, exclude_modules=None, "
+    "predicate=None)\n\
+\n\
+Immortalize all instances accessible through the GC roots.\n\
+\n\
+Use `num_threads` threads to walk the heap in parallel. When this value is 0\n\
+the number of threads is half the number of processors.\n\
+\n\
+GC-tracked objects that are instances of `exclude_types`, that are defined by\n\
+a module in or nested under `exclude_modules`, or for which `predicate(obj)`\n\
+returns a false value are left mortal, along with the GC-tracked objects that\n\
+can only be reached through them.\n\
+\n\
+Return a dict with the number of objects immortalized under \"objects\" and an\n\
+estimate of their size under \"bytes\".");
+PyObject*
+cinder_immortalize_heap(PyObject* /* mod */, PyObject* args, PyObject* kwargs) {
+  static char* argnames[] = {
+      const_cast<char*>("num_threads"),
+      const_cast<char*>("exclude_types"),
+      const_cast<char*>("exclude_modules"),
+      const_cast<char*>("predicate"),
+      nullptr};
+
+  int num_threads = 1;
+  PyObject* exclude_types = Py_None;
+  PyObject* exclude_modules = Py_None;
+  PyObject* predicate = Py_None;
+
+  if (!PyArg_ParseTupleAndKeywords(
+          args,
+          kwargs,
+          "|iOOO",
+          argnames,
+          &num_threads,
+          &exclude_types,
+          &exclude_modules,
+          &predicate)) {
+    return nullptr;
+  }
+
+  if (num_threads < 0) {
+    PyErr_SetString(PyExc_ValueError, "invalid num_threads");
+    return nullptr;
+  }
+  if (predicate != Py_None && !PyCallable_Check(predicate)) {
+    PyErr_SetString(PyExc_TypeError, "predicate must be callable");
+    return nullptr;
+  }
+
+  ImmortalizeHeapOptions options;
+  options.num_threads = num_threads != 0
+      ? num_threads
+      : std::max<size_t>(std::thread::hardware_concurrency() / 2, 1);
+  if (exclude_types != Py_None) {
+    options.exclude_types = exclude_types;
+  }
+  if (exclude_modules != Py_None) {
+    options.exclude_modules = exclude_modules;
+  }
+  if (predicate != Py_None) {
+    options.predicate = predicate;
+  }
+  return immortalize_heap(options);
 }
 
 PyDoc_STRVAR(
@@ -949,8 +1009,8 @@ PyMethodDef _cinderx_methods[] = {
          "Return whether compile perf-trampoline entries before fork is "
          "enabled or not.")},
     {"immortalize_heap",
-     cinder_immortalize_heap,
-     METH_NOARGS,
+     (PyCFunction)cinder_immortalize_heap,
+     METH_VARARGS | METH_KEYWORDS,
      cinder_immortalize_heap_doc},
     {"is_immortal", cinder_is_immortal, METH_O, cinder_is_immortal_doc},
     {"is_prefork_build",
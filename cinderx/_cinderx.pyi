@@ -1,7 +1,7 @@
 # Copyright (c) Meta Platforms, Inc. and affiliates.
 # pyre-unsafe
 
-from collections.abc import Awaitable, Callable, Generator
+from collections.abc import Awaitable, Callable, Generator, Iterable
 from types import ModuleType
 from typing import Any, Mapping, NoReturn, TypeVar
 
@@ -100,7 +100,12 @@ def get_adaptive_delay() -> int: ...
 def get_parallel_gc_settings() -> dict[str, int] | None: ...
 def get_threshold() -> tuple[int, int, int]: ...
 def has_parallel_gc() -> bool: ...
-def immortalize_heap() -> None: ...
+def immortalize_heap(
+    num_threads: int = 1,
+    exclude_types: tuple[type, ...] | None = None,
+    exclude_modules: Iterable[str] | None = None,
+    predicate: Callable[[object], bool] | None = None,
+) -> dict[str, int]: ...
 def install_frame_evaluator() -> None: ...
 def is_immortal(o: object) -> bool: ...
 def is_prefork_build() -> bool: ...
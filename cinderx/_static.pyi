@@ -37,7 +37,16 @@ TYPED_ARRAY: int
 SEQ_LIST: int
 SEQ_TUPLE: int
 SEQ_LIST_INEXACT: int
+SEQ_ARRAY_INT8: int
+SEQ_ARRAY_INT16: int
+SEQ_ARRAY_INT32: int
 SEQ_ARRAY_INT64: int
+SEQ_ARRAY_UINT8: int
+SEQ_ARRAY_UINT16: int
+SEQ_ARRAY_UINT32: int
+SEQ_ARRAY_UINT64: int
+SEQ_ARRAY_DOUBLE: int
+SEQ_ARRAY_BOOL: int
 SEQ_SUBSCR_UNCHECKED: int
 
 SEQ_REPEAT_INEXACT_SEQ: int
@@ -108,6 +117,7 @@ V = TypeVar("V")
 
 chklist = list[T]
 chkdict = dict[K, V]
+chkprimdict = dict[K, V]
 
 class staticarray(Iterable[int]):
     @classmethod
@@ -122,6 +132,14 @@ class staticarray(Iterable[int]):
     def __setitem__(self, index: int, value: int) -> None: ...
     def __len__(self) -> int: ...
     def __repr__(self) -> str: ...
+    def copy(self) -> staticarray: ...
+    def fill(self, value: int) -> None: ...
+    def sum(self) -> int: ...
+    def min(self) -> int: ...
+    def max(self) -> int: ...
+    def add(self, other: staticarray | int) -> None: ...
+    def sub(self, other: staticarray | int) -> None: ...
+    def mul(self, other: staticarray | int) -> None: ...
 
     # This is a lie, staticarray doesn't have an __iter__ method.  This is here so that
     # calling `list(static_array)` will work.  `list()` is typed as taking an
@@ -0,0 +1,105 @@
+# Copyright (c) Meta Platforms, Inc. and affiliates.
+
+# pyre-strict
+
+"""
+Interpreted call counter scaling benchmark.
+
+The CinderX interpreter counts the calls to every code object, which is what
+``compile_after_n_calls`` and the adaptive-specialization delay key off.  In
+free-threaded builds that counter is shared by every thread calling the
+function, so it can turn a hot function into a point of contention.
+
+Each thread calls a trivial, never-compiled function in a tight loop, either:
+
+  - shared:  the same function in every thread, so the threads update the
+             same call counter, or
+  - private: a copy of the function with its own code object in each thread,
+             so nothing is shared.
+
+The private numbers are the ideal scaling for the machine; the closer the
+shared numbers get to them, the less the call counter costs.
+"""
+
+from __future__ import annotations
+
+import sys
+import threading
+import time
+import types
+from typing import Callable
+
+import cinderx.jit
+
+
+@cinderx.jit.jit_suppress
+def callee(x: int) -> int:
+    return x
+
+
+def copy_function(func: Callable[[int], int]) -> Callable[[int], int]:
+    # A new code object gets its own call counter.
+    code = func.__code__.replace()
+    return types.FunctionType(code, func.__globals__, func.__name__)
+
+
+@cinderx.jit.jit_suppress
+def call_loop(func: Callable[[int], int], n: int) -> None:
+    for i in range(n):
+        func(i)
+
+
+def run_threads(funcs: list[Callable[[int], int]], n: int) -> float:
+    start = threading.Barrier(len(funcs) + 1)
+
+    def worker(func: Callable[[int], int]) -> None:
+        start.wait()
+        call_loop(func, n)
+
+    threads = [threading.Thread(target=worker, args=(func,)) for func in funcs]
+    for thread in threads:
+        thread.start()
+    start.wait()
+    t0 = time.perf_counter()
+    for thread in threads:
+        thread.join()
+    return time.perf_counter() - t0
+
+
+def best_of(trials: int, run: Callable[[], float]) -> float:
+    return min(run() for _ in range(trials))
+
+
+class CallCounters:
+    def run(self, iterations: int) -> bool:
+        n = 200_000
+        for _ in range(iterations):
+            run_threads([callee] * 4, n)
+        return True
+
+
+if __name__ == "__main__":
+    n = 1_000_000
+    if len(sys.argv) > 1:
+        n = int(sys.argv[1])
+    max_threads = 16
+    if len(sys.argv) > 2:
+        max_threads = int(sys.argv[2])
+
+    # Get the counters past the range that is always counted exactly.
+    call_loop(callee, 10_000)
+
+    print(f"{'Threads':>7} {'Shared (Mcalls/s)':>18} {'Private (Mcalls/s)':>19}")
+    print("-" * 46)
+    threads = 1
+    while threads <= max_threads:
+        private = [copy_function(callee) for _ in range(threads)]
+        for func in private:
+            call_loop(func, 10_000)
+        shared_time = best_of(3, lambda: run_threads([callee] * threads, n))
+        private_time = best_of(3, lambda: run_threads(private, n))
+        total = threads * n / 1e6
+        print(
+            f"{threads:>7} {total / shared_time:>18.2f} {total / private_time:>19.2f}"
+        )
+        threads *= 2
@@ -0,0 +1,79 @@
+# Copyright (c) Meta Platforms, Inc. and affiliates.
+
+"""
+Typed staticarray benchmark.
+
+Compares element-at-a-time Static Python loops over Array[double] and
+Array[int32] with the staticarray bulk methods (sum, fill, add, mul), and
+with the same work done on array.array and list for reference.
+"""
+
+import array
+import sys
+import time
+
+import cinderx.jit
+from cinderx.compiler.strict import loader as static_python_loader
+
+static_python_loader.install()
+
+from static_array_lib import (  # noqa: E402
+    axpy_bulk,
+    axpy_loop,
+    fill_int32s_bulk,
+    fill_int32s_loop,
+    make_doubles,
+    make_int32s,
+    sum_doubles_bulk,
+    sum_doubles_loop,
+    sum_int32s_bulk,
+    sum_int32s_loop,
+)
+
+
+def run_one(func, trials: int = 5) -> float:
+    func()
+    best = float("inf")
+    for _ in range(trials):
+        t0 = time.perf_counter()
+        func()
+        elapsed = time.perf_counter() - t0
+        if elapsed < best:
+            best = elapsed
+    return best
+
+
+def workloads(n: int):
+    doubles = make_doubles(n)
+    other = make_doubles(n)
+    tmp = make_doubles(n)
+    int32s = make_int32s(n)
+    py_doubles = array.array("d", list(doubles))
+    py_list = list(doubles)
+
+    return [
+        ("sum double (loop)", lambda: sum_doubles_loop(doubles)),
+        ("sum double (bulk)", lambda: sum_doubles_bulk(doubles)),
+        ("sum double (array)", lambda: sum(py_doubles)),
+        ("sum double (list)", lambda: sum(py_list)),
+        ("sum int32 (loop)", lambda: sum_int32s_loop(int32s)),
+        ("sum int32 (bulk)", lambda: sum_int32s_bulk(int32s)),
+        ("axpy double (loop)", lambda: axpy_loop(doubles, other)),
+        ("axpy double (bulk)", lambda: axpy_bulk(doubles, other, tmp)),
+        ("fill int32 (loop)", lambda: fill_int32s_loop(int32s)),
+        ("fill int32 (bulk)", lambda: fill_int32s_bulk(int32s)),
+    ]
+
+
+if __name__ == "__main__":
+    cinderx.jit.auto()
+
+    n = 1_000_000
+    if len(sys.argv) > 1:
+        n = int(sys.argv[1])
+
+    print(f"{'Benchmark':<22} {'Time (ms)':>10}")
+    print("-" * 34)
+    for name, func in workloads(n):
+        elapsed = run_one(func)
+        print(f"{name:<22} {elapsed * 1000:>10.2f}")
@@ -0,0 +1,81 @@
+# Copyright (c) Meta Platforms, Inc. and affiliates.
+
+"""
+Static Python half of the typed staticarray benchmark.
+
+Each workload runs once with an element-at-a-time loop compiled by Static
+Python and once with the equivalent bulk staticarray method, whose C loop is
+vectorized by the C compiler.
+"""
+
+import __static__
+from __static__ import Array, box, double, int32, int64
+
+
+def make_doubles(n: int) -> Array[double]:
+    a: Array[double] = Array[double](n)
+    i: int64 = 0
+    size: int64 = int64(n)
+    while i < size:
+        a[i] = double(float(box(i)))
+        i += 1
+    return a
+
+
+def make_int32s(n: int) -> Array[int32]:
+    a: Array[int32] = Array[int32](n)
+    i: int64 = 0
+    size: int64 = int64(n)
+    while i < size:
+        a[i] = int32(box(i) & 0xFFFF)
+        i += 1
+    return a
+
+
+def sum_doubles_loop(a: Array[double]) -> float:
+    total: double = 0.0
+    for x in a:
+        total += x
+    return box(total)
+
+
+def sum_doubles_bulk(a: Array[double]) -> float:
+    return a.sum()
+
+
+def sum_int32s_loop(a: Array[int32]) -> int:
+    total: int64 = 0
+    for x in a:
+        total += int64(x)
+    return box(total)
+
+
+def sum_int32s_bulk(a: Array[int32]) -> int:
+    return a.sum()
+
+
+def axpy_loop(a: Array[double], b: Array[double]) -> None:
+    i: int64 = 0
+    size: int64 = int64(len(a))
+    while i < size:
+        a[i] = a[i] + b[i] * 2.0
+        i += 1
+
+
+def axpy_bulk(a: Array[double], b: Array[double], tmp: Array[double]) -> None:
+    tmp.fill(0.0)
+    tmp.add(b)
+    tmp.mul(2.0)
+    a.add(tmp)
+
+
+def fill_int32s_loop(a: Array[int32]) -> None:
+    i: int64 = 0
+    size: int64 = int64(len(a))
+    while i < size:
+        a[i] = 7
+        i += 1
+
+
+def fill_int32s_bulk(a: Array[int32]) -> None:
+    a.fill(7)
@@ -0,0 +1,56 @@
+# Copyright (c) Meta Platforms, Inc. and affiliates.
+
+"""
+Interpreter-only Static Python benchmark.
+
+Runs the *_static kernels with the JIT disabled, so that the time is spent in
+the interpreter's handlers for the Static Python opcodes: INVOKE_FUNCTION,
+LOAD_FIELD/STORE_FIELD, CAST, the primitive ops, and so on.
+"""
+
+import sys
+import time
+
+import cinderx.jit
+from cinderx.compiler.strict import loader as static_python_loader
+
+static_python_loader.install()
+
+from deltablue_static_lib import delta_blue  # noqa: E402
+from fannkuch_static_lib import fannkuch  # noqa: E402
+from nbody_static_lib import bench_nbody, DEFAULT_REFERENCE  # noqa: E402
+from richards_static_lib import Richards  # noqa: E402
+
+
+def run_one(func, trials: int) -> float:
+    func()
+    best = float("inf")
+    for _ in range(trials):
+        t0 = time.perf_counter()
+        func()
+        elapsed = time.perf_counter() - t0
+        if elapsed < best:
+            best = elapsed
+    return best
+
+
+WORKLOADS = [
+    ("deltablue_static", lambda: delta_blue(2000)),
+    ("fannkuch_static", lambda: fannkuch(8)),
+    ("nbody_static", lambda: bench_nbody(1, DEFAULT_REFERENCE, 5000)),
+    ("richards_static", lambda: Richards().run(5)),
+]
+
+
+if __name__ == "__main__":
+    cinderx.jit.disable()
+
+    trials = 3
+    if len(sys.argv) > 1:
+        trials = int(sys.argv[1])
+
+    print(f"{'Benchmark':<20} {'Time (ms)':>10}")
+    print("-" * 32)
+    for name, func in WORKLOADS:
+        elapsed = run_one(func, trials)
+        print(f"{name:<20} {elapsed * 1000:>10.2f}")
@@ -2,7 +2,8 @@
 
 # pyre-strict
 
-from collections.abc import AsyncGenerator, Callable, Coroutine, Generator
+from collections.abc import AsyncGenerator, Callable, Coroutine, Generator, Sequence
+from types import CodeType
 from typing import TypeVar
 
 FuncAny = Callable[..., object]
@@ -23,46 +24,72 @@ def append_jit_list(entry: str) -> None: ...
 def auto() -> None: ...
 def background_compile(enabled: bool) -> None: ...
 def clear_runtime_stats() -> None: ...
+def compact_code(max_occupancy: float = 0.5) -> int: ...
 def compile_after_n_calls(calls: int) -> None: ...
 def count_interpreted_calls(func: FuncAny) -> int: ...
 def disable(deopt_all: bool = False) -> None: ...
 def disable(deopt_all: bool = False) -> None: ...
 def disable_emit_type_annotation_guards() -> None: ...
+def disable_execution_counters() -> None: ...
 def disable_hir_inliner() -> None: ...
 def disassemble(func: FuncAny) -> None: ...
 def disable_specialized_opcodes() -> None: ...
 def enable() -> None: ...
 def enable_emit_type_annotation_guards() -> None: ...
+def enable_execution_counters(loops: bool = False) -> None: ...
 def enable_hir_inliner() -> None: ...
 def enable_specialized_opcodes() -> None: ...
 def force_compile(func: FuncAny) -> bool: ...
 def force_uncompile(func: FuncAny) -> bool: ...
 def get_allocator_stats() -> dict[str, int]: ...
+def get_and_clear_compile_trace() -> str: ...
+def get_and_clear_execution_counts() -> dict[CodeType, dict[str, int]]: ...
 def get_and_clear_inline_cache_stats() -> dict[str, object]: ...
 def get_and_clear_runtime_stats() -> dict[str, object]: ...
+def get_and_clear_sampling_profile() -> str: ...
 def get_background_compile() -> bool: ...
 def get_compilation_time() -> int: ...
 def get_compile_after_n_calls() -> int | None: ...
+def get_compiled_direct_calls(func: FuncAny) -> dict[str, int] | None: ...
 def get_compiled_functions() -> list[FuncAny]: ...
+def get_compiled_memory_stats(func: FuncAny) -> dict[str, int] | None: ...
 def get_compiled_size(func: FuncAny) -> int: ...
+def get_compiled_spill_counts(func: FuncAny) -> dict[str, int] | None: ...
 def get_compiled_spill_stack_size(func: FuncAny) -> int: ...
 def get_compiled_stack_size(func: FuncAny) -> int: ...
 def get_function_compilation_time(func: FuncAny) -> int: ...
 def get_function_hir_opcode_counts(func: FuncAny) -> dict[str, int] | None: ...
+def get_generator_pool_stats() -> dict[str, object] | None: ...
+def get_generator_size_histogram() -> dict[str, dict[int, int]] | None: ...
 def get_inlined_functions_stats(func: FuncAny) -> dict[str, object]: ...
 def get_jit_list() -> tuple[dict[str, set[str]], dict[str, dict[str, set[int]]]]: ...
 def get_num_inlined_functions(func: FuncAny) -> int: ...
+def is_compiled_frameless(func: FuncAny) -> bool: ...
 def is_enabled() -> bool: ...
+def is_frameless_leaf_functions_enabled() -> bool: ...
 def is_hir_inliner_enabled() -> bool: ...
 def is_inline_cache_stats_collection_enabled() -> bool: ...
 def is_jit_compiled(func: FuncAny) -> bool: ...
 def jit_suppress(func: FuncAny) -> FuncAny: ...
 def jit_unsuppress(func: FuncAny) -> FuncAny: ...
 def lazy_compile(func: FuncAny) -> bool: ...
+def load_hot_manifest(path: str) -> int: ...
 def mlock_profiler_dependencies() -> None: ...
 def multithreaded_compile_test() -> None: ...
 def page_in_profiler_dependencies() -> list[str]: ...
 def precompile_all(workers: int = 0) -> bool: ...
+def precompile_hot(workers: int = 0) -> int: ...
+def prefork_freeze(
+    min_calls: int = 1, read_only: bool = False, pause: bool = True
+) -> dict[str, int | bool] | None: ...
 def read_jit_list(path: str) -> None: ...
+def relink_hot_code(
+    funcs: Sequence[FuncAny] | None = None, limit: int = -1
+) -> int: ...
 def set_max_code_size(max_code_size: int) -> None: ...
+def start_compile_trace(capacity: int = 65536) -> None: ...
+def start_sampling_profiler(hz: int = 100) -> bool: ...
+def stop_compile_trace() -> None: ...
+def stop_sampling_profiler() -> None: ...
 def wait_for_background_compiles() -> None: ...
+def write_hot_manifest(path: str, min_calls: int = 1) -> int: ...
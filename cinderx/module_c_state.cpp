@@ -5,6 +5,7 @@
 #include "cinderx/Common/extra-py-flags.h"
 #include "cinderx/Common/log.h"
 #include "cinderx/Jit/config.h"
+#include "cinderx/Jit/pyjit.h"
 #include "cinderx/module_state.h"
 
 #include <atomic>
@@ -225,6 +226,14 @@ int Ci_Watchers_UnwatchType(PyTypeObject* type) {
   return cinderx::getModuleState()->watcher_state.unwatchType(type);
 }
 
+void Ci_NotifyStaticMethodOverride(PyTypeObject* type, PyObject* name) {
+  cinderx::jit::staticMethodOverridden(type, name);
+}
+
+void Ci_NotifyStaticSubclassAdded(PyTypeObject* type) {
+  cinderx::jit::staticSubclassAdded(type);
+}
+
 PyObject**
 Ci_GetGlobalCache(PyObject* builtins, PyObject* globals, PyObject* key) {
   JIT_CHECK(
@@ -250,7 +259,7 @@ PyObject** Ci_GetDictCache(PyObject* dict, PyObject* key) {
 
 void Ci_free_jit_list_gen(PyGenObject* obj) {
   cinderx::getModuleState()->jit_gen_free_list->free(
-      reinterpret_cast<PyObject*>(obj));
+      reinterpret_cast<PyObject*>(obj), false);
 }
 
 bool Ci_GetDelayAdaptiveCode(void) {
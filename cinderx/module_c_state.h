@@ -104,6 +104,11 @@ int Ci_Watchers_UnwatchDict(PyObject* dict);
 int Ci_Watchers_WatchType(PyTypeObject* type);
 int Ci_Watchers_UnwatchType(PyTypeObject* type);
 
+// Static Python class hierarchy changes that can invalidate devirtualized
+// method calls in JIT-compiled code.
+void Ci_NotifyStaticMethodOverride(PyTypeObject* type, PyObject* name);
+void Ci_NotifyStaticSubclassAdded(PyTypeObject* type);
+
 // GlobalCacheManager.
 
 PyObject**
@@ -78,24 +78,55 @@ void ModuleState::afterForkChild() {
   }
 }
 
+std::shared_ptr<HugePageArena> ModuleState::preforkStateArena() const {
+  if (!prefork_freezing.load(std::memory_order_acquire)) {
+    return nullptr;
+  }
+  return prefork_state_arena;
+}
+
 void ModuleState::atForkPrepare() {
+  if (jit_gen_free_list != nullptr) {
+    jit_gen_free_list->atForkPrepare();
+  }
   mutex_.lock();
   if (std::shared_ptr<HugePageArena> arena = huge_page_arena_.lock()) {
     arena->atForkPrepare();
   }
+  for (const auto& arena : {prefork_metadata_arena, prefork_state_arena}) {
+    if (arena != nullptr) {
+      arena->atForkPrepare();
+    }
+  }
 }
 
 void ModuleState::atForkParent() {
+  for (const auto& arena : {prefork_state_arena, prefork_metadata_arena}) {
+    if (arena != nullptr) {
+      arena->atForkParent();
+    }
+  }
   if (std::shared_ptr<HugePageArena> arena = huge_page_arena_.lock()) {
     arena->atForkParent();
   }
   mutex_.unlock();
+  if (jit_gen_free_list != nullptr) {
+    jit_gen_free_list->atForkParent();
+  }
 }
 
 void ModuleState::atForkChild() {
+  for (const auto& arena : {prefork_state_arena, prefork_metadata_arena}) {
+    if (arena != nullptr) {
+      arena->atForkChild();
+    }
+  }
   if (std::shared_ptr<HugePageArena> arena = huge_page_arena_.lock()) {
     arena->atForkChild();
   }
+  if (jit_gen_free_list != nullptr) {
+    jit_gen_free_list->atForkChild();
+  }
   // Reuse the storage to get a fresh, unlocked mutex.  The inherited one is
   // still locked by atForkPrepare() and destroying a locked mutex is
   // undefined, so its lifetime is ended without running its destructor.
@@ -45,9 +45,14 @@ struct ModuleState {
 
   void afterForkChild();
 
+  // The arena per-site mutable state of newly compiled functions goes in, or
+  // nullptr if a prefork freeze isn't in progress.
+  std::shared_ptr<HugePageArena> preforkStateArena() const;
+
   // pthread_atfork() handlers for this state's own lock and the shared
   // HugePageArena behind it.  These are the innermost of the JIT's fork
-  // handlers, matching the order SlabArena::allocate() takes them in.
+  // handlers, matching the order SlabArena::allocate() takes them in.  They
+  // also cover the generator pools' lock, which is never held with the others.
   void atForkPrepare();
   void atForkParent();
   void atForkChild();
@@ -152,6 +157,14 @@ struct ModuleState {
   // by holding a reference to it.
   BorrowedRef<> cinderx_module;
 
+  // Memory laid out by jit.prefork_freeze() to be shared with forked
+  // children: read-mostly metadata of compiled functions, and a compact region
+  // for their per-site mutable state.  Only created by a freeze, and not
+  // re-backed with huge pages after a fork, since that would unshare them.
+  std::shared_ptr<HugePageArena> prefork_metadata_arena;
+  std::shared_ptr<HugePageArena> prefork_state_arena;
+  std::atomic<bool> prefork_freezing{false};
+
   // Counters for multithreaded compilation diagnostics.
   std::atomic<int> compile_workers_attempted{0};
   std::atomic<int> compile_workers_retries{0};